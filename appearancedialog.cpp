@@ -350,7 +350,7 @@ AppearanceDialog::AppearanceDialog( BpDocument *bp, const QString &captionKey,
     // TO DO: add controls for worksheetTitleFont{Color,Family,Size}.
     // TO DO: add controls for worksheetValueFont{Color,Family,Size}.
     r = 0;
-    p = addPage( "AppearanceDialog:Worksheet:Tab", 11, 2,
+    p = addPage( "AppearanceDialog:Worksheet:Tab", 12, 2,
         "TellerWildlifeRefuge3.png", Twr, "worksheetAppearance.html" );
 
         p->addCheck( "docRxActive",
@@ -375,6 +375,9 @@ AppearanceDialog::AppearanceDialog( BpDocument *bp, const QString &captionKey,
         p->addCheck( "worksheetShowOutputVars",
                      "AppearanceDialog:Worksheet:ShowOutputVars", "",
                       r, 0, r, 1 ); r++;
+        p->addCheck( "worksheetLivePreview",
+                     "AppearanceDialog:Worksheet:LivePreview", "",
+                      r, 0, r, 1 ); r++;
         p->addLabel( "!",
                       r, 0, r, 0 ); r++;
         p->addCheck( "worksheetNotesActive",
@@ -3,26 +3,27 @@
  *  \version BehavePlus3
  *  \author Copyright (C) 2002-2004 by Collin D. Bevins.  All rights reserved.
  *
- *  \brief Application-wide, shared message handler functions.  Includes
- *  methods for the HelpDialog and MessageDialog classes.
+ *  \brief Application-wide, shared message handler functions.
+ *
+ *  Nothing here depends on the application window, so the equation engine
+ *  may be linked without the GUI.  The HelpDialog and MessageDialog methods
+ *  and the message dialogs are in appmessagedialog.cpp, and reach the
+ *  functions here only through the appGuiDisplay() hook.
  */
 
 // Custom include files
-#include "appdialog.h"
 #include "appmessage.h"
-#include "apptranslator.h"
-#include "appwindow.h"
 #include "platform.h"
-#include "textview.h"
-
-// Qt include files
-#include <qapplication.h>
-#include <qmessagebox.h>
-#include <qtextedit.h>
 
 // Standard include files
 #include <stdio.h>
 
+//------------------------------------------------------------------------------
+/*! \var AppGuiDisplay
+ *  \brief Hook that displays messages when AppGuiEnabled, or 0.
+ */
+static AppGuiDisplayHook AppGuiDisplay = 0;
+
 //------------------------------------------------------------------------------
 /*! \var AppGuiEnabled
  *  \brief Determines whether messages are displayed in dialogs or at terminal.
@@ -58,99 +59,6 @@ static bool AppTranslatorEnabled = false;
  */
 static int BombLevel = 1;
 
-//------------------------------------------------------------------------------
-/*! \brief HelpDialog constructor.
- *
- *  \param parent       Pointer to parent widget.
- *  \param captionKey   Caption text translator key.
- *  \param dismissKey   Dismiss button text translator key.
- *  \param htmlFile     HTML help file base name.
- */
-
-HelpDialog::HelpDialog( QWidget *p_parent, const QString &captionKey,
-        const QString &dismissKey, const QString &htmlFile ) :
-    AppDialog(
-        p_parent,                                 // Parent widget
-        captionKey,                             // Caption
-        "",                                     // No picture file
-        "",                                     // No picture name
-        htmlFile,                               // HelpBrowser file
-        "helpBrowser",                          // Widget name
-        dismissKey,                             // Accept button text key
-        "" )                                    // No reject button
-{
-    // Hide the content pane
-    midFrame()->hide();
-    optionFrame()->hide();
-    // Start small enough to fit on an 800x600 monitor.
-    resize( 600, 400 );
-    return;
-}
-
-//------------------------------------------------------------------------------
-/*! \brief MessageDialog constructor.
- *
- *  \param p_parent       Pointer to the parent widget
- *  \param captionKey   Translator key for dialog caption.
- *  \param pictureFile  Base name of picture file to display in the left pane.
- *  \param pictureName  Picture title.
- *  \param message      Messagew text to diaplay.
- *  \param p_name         Widget internal name
- *  \param acceptKey    Translator key for text displayed on the #m_acceptBtn
- *                      (default is "AppDialog:Button:Ok").
- *                      The #m_acceptBtn is always displayed.
- *  \param rejectKey    Translator key for text displayed on the #m_rejectBtn.
- *                      (default is "").
- *                      If NULL or empty, #m_rejectBtn is not displayed.
- */
-
-MessageDialog::MessageDialog( QWidget *p_parent, const QString &captionKey,
-        const QString &pictureFile, const QString &pictureName,
-        const QString &message,     const char *p_name,
-        const QString &acceptKey,   const QString &rejectKey ) :
-    AppDialog( p_parent, captionKey, pictureFile, pictureName,
-        "" /* No HelpBrowser */,  p_name, acceptKey, rejectKey ),
-    m_textView(0)
-{
-    // Hide the content pane
-    m_page->m_contentFrame->hide();
-    // Add a text view to the main area
-    m_textView = new TextView( m_page, "m_textView" );
-    checkmem( __FILE__, __LINE__, m_textView, "TextView m_textView", 1 );
-    m_textView->setTextFormat( Qt::RichText );
-    m_textView->setText( message );
-    m_textView->setReadOnly( true );
-    // STart at a decent size
-    int l_width = widthHint() + 300;
-    int l_height = sizeHint().height();
-    resize( l_width, ( l_height < 300 )
-        ? 300
-        : l_height );
-    return;
-}
-
-//------------------------------------------------------------------------------
-/*! \brief MessageDialog destructor.
- */
-
-MessageDialog::~MessageDialog( void )
-{
-    delete m_textView;  m_textView = 0;
-    return;
-}
-
-//------------------------------------------------------------------------------
-/*! \brief Sets MessageDialog minimum width.
-*
-*   \param minWidth Minimum dialog width in pixels.
- */
-
-void MessageDialog::setMinWidth( int minWidth )
-{
-    m_textView->setMinimumWidth( minWidth );
-    return;
-}
-
 //------------------------------------------------------------------------------
 /*! \brief Converts the \a msg into HTML by
  *  -# converting "\\n" into "<BR>", and
@@ -190,6 +98,34 @@ bool appGuiEnabled( bool enabled )
     return( AppGuiEnabled = enabled );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Installs the hook that displays info(), warn(), error(), bomb(),
+ *  and yesno() messages while AppGuiEnabled.
+ *
+ *  The application window installs appMessageDialog().  Without a hook,
+ *  messages go to the terminal even if AppGuiEnabled.
+ *
+ *  \param hook Display function, or 0 to remove the hook.
+ */
+
+void appGuiDisplay( AppGuiDisplayHook hook )
+{
+    AppGuiDisplay = hook;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines if the AppTranslatorEnabled state is set.
+ *
+ *  \return TRUE if messages are treated as already translated text for the
+ *  custom message dialogs.
+ */
+
+bool appTranslatorIsEnabled( void )
+{
+    return( AppTranslatorEnabled );
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Sets the AppTranslatorEnabled state.
  *
@@ -221,22 +157,9 @@ void bomb( const QString &msg, int minWidth )
     log( QString( "\n*** FATAL: %1\n" ).arg( msg ) );
 
     // Display the message to the screen
-    if ( AppGuiEnabled )
+    if ( AppGuiEnabled && AppGuiDisplay )
     {
-        if ( AppTranslatorEnabled )
-        {
-            // Convert newlines to <BR>, etc.
-            QString html( msg );
-            applyHtml( html );
-            // Display dialog with html and translated controls
-            bombDialog( html, minWidth );
-        }
-        else
-        {
-            QMessageBox::critical( 0,
-                QString( appWindow()->m_program + " " + appWindow()->m_version ),
-                msg, "Quit" );
-        }
+        AppGuiDisplay( AppMessageFatal, QString::null, msg, minWidth );
     }
     // or to the terminal
     else
@@ -255,42 +178,6 @@ void bomb( const QString &msg, int minWidth )
     return;
 }
 
-//------------------------------------------------------------------------------
-/*! \brief Displays a fatal error dialog containing a picture,
- *  a scrollable rich text window with the message, and a single "Ok" button,
- *  then terminates the program with a core dump.
- *
- *  \param message  Fully translated error message to display.
- *  \param minWidth Minimum width of the dialog (pixels)
- */
-
-void bombDialog( const QString &message, int minWidth )
-{
-    // Build translated message with optional caption
-    QString caption("");
-    QString text("");
-    translate( caption, "AppMessage:Caption:Fatal" );
-    translate( text, "AppMessage:Text:Fatal" );
-    QString str = QString( "<H3>%1</H3><HR>%2<P><B>%3</B>" )
-        .arg( caption ).arg( message ).arg( text );
-
-    // Display the MessageDialog
-    qApp->beep();
-    MessageDialog dialog(
-        appWindow(),                    // Parent
-        "AppMessage:Caption:Fatal",     // Dialog caption
-        "BlueWolf2.png",                // Picture file
-        "Blue Wolf",                    // Picture name
-        str,                            // Message text
-        "fatalDialog",                  // Widget name
-        "AppMessage:Button:Abort" );    // Button text key
-    dialog.setMinWidth( minWidth
-        ? minWidth
-        : 400 );
-    dialog.exec();
-    return;
-}
-
 //------------------------------------------------------------------------------
 /*! \brief Sets the BombLevel, which determines the action taken by calls to
  *  bomb().
@@ -346,22 +233,9 @@ void error( const QString &msg, int minWidth )
     log( QString( "\n*** ERROR:\n    %1\n" ).arg( msg ) );
 
     // Display the message to the screen ...
-    if ( AppGuiEnabled )
+    if ( AppGuiEnabled && AppGuiDisplay )
     {
-        if ( AppTranslatorEnabled )
-        {
-            // Convert newlines to <BR>, etc.
-            QString html( msg );
-            applyHtml( html );
-            // Display without a caption.
-            errorDialog( 0, html, minWidth );
-        }
-        else
-        {
-            QMessageBox::critical( 0,
-                QString( appWindow()->m_program + " " + appWindow()->m_version ),
-                msg, "Bummer" );
-        }
+        AppGuiDisplay( AppMessageError, QString::null, msg, minWidth );
     }
     // or to the terminal.
     else
@@ -387,20 +261,9 @@ void error( const QString &caption, const QString &msg, int minWidth )
     log( QString( "\n*** ERROR: %1\n    %2\n" ).arg( caption ).arg( msg ) );
 
     // Display the message to the screen ...
-    if ( AppGuiEnabled )
+    if ( AppGuiEnabled && AppGuiDisplay )
     {
-        if ( AppTranslatorEnabled )
-        {
-            // Convert newlines to <BR>, etc.
-            QString html( msg );
-            applyHtml( html );
-            // Display with a caption.
-            errorDialog( caption, html, minWidth );
-        }
-        else
-        {
-            QMessageBox::critical( 0, caption, msg, "Ok" );
-        }
+        AppGuiDisplay( AppMessageError, caption, msg, minWidth );
     }
     // or to the terminal.
     else
@@ -411,60 +274,6 @@ void error( const QString &caption, const QString &msg, int minWidth )
     return;
 }
 
-//------------------------------------------------------------------------------
-/*! \brief Displays an error dialog containing a picture,
- *  a scrollable rich text window with the message, and a single "Ok" button.
- *
- *  \param caption  Fully translated caption text
- *  \param message  Fully translated message text
- *  \param minWidth Dialog minimum width in pixels
- */
-
-void errorDialog( const QString &caption, const QString &message, int minWidth )
-{
-    // Build translated message with optional caption
-    QString str("");
-    if ( ! caption.isNull() )
-    {
-        str = QString( "<H3>%1</H3><HR>" ).arg( caption );
-    }
-    str += message;
-
-    // Display the MessageDialog
-    qApp->beep();
-    MessageDialog dialog(
-        appWindow(),                // Parent
-        "AppMessage:Caption:Error", // Dialog caption
-        "BlueWolf1.png",            // Picture file
-        "Blue Wolf",                // Picture name
-        str,                        // Message
-        "errorDialog",              // Widget name
-        "AppMessage:Button:Ok" );   // Button text key
-    dialog.setMinWidth( minWidth
-        ? minWidth
-        : 400 );
-    dialog.exec();
-    return;
-}
-
-//------------------------------------------------------------------------------
-/*! \brief Help dialog convenience routine.
- *
- *  \param htmlFile Name of the HTML file to display.
- */
-
-void helpDialog( const QString &htmlFile )
-{
-    // Display the help dialog
-    HelpDialog dialog(
-        appWindow(),
-        "AppMessage:Caption:Help",      // Caption key
-        "AppMessage:Button:Dismiss",    // Dismiss button text key
-        htmlFile );
-    dialog.exec();
-    return;
-}
-
 //------------------------------------------------------------------------------
 /*! \brief Displays an informational message and returns.
  *  If AppGuiEnabled, the message is displayed in a dialog box.
@@ -480,21 +289,9 @@ void info( const QString &msg, int minWidth )
     log( QString( "\n*** FYI:\n    %1\n" ).arg( msg ) );
 
     // Display the message to the screen ...
-    if ( AppGuiEnabled )
+    if ( AppGuiEnabled && AppGuiDisplay )
     {
-        if ( AppTranslatorEnabled )
-        {
-            // Convert newlines into <BR>, etc.
-            QString html( msg );
-            applyHtml( html );
-            infoDialog( html, minWidth );
-        }
-        else
-        {
-            QMessageBox::information( 0,
-                QString( appWindow()->m_program + " " + appWindow()->m_version ),
-                msg, "Ok" );
-        }
+        AppGuiDisplay( AppMessageInfo, QString::null, msg, minWidth );
     }
     // or to the terminal
     else
@@ -504,33 +301,6 @@ void info( const QString &msg, int minWidth )
     return;
 }
 
-//------------------------------------------------------------------------------
-/*! \brief Displays an informational dialog containing a picture,
- *  a scrollable rich text window with the message,
- *  and a single "Ok" button.
- *
- *  \param message  Fully translated info message to display.
- *  \param minWidth Minimum width of the dialog (pixels)
- */
-
-void infoDialog( const QString &message, int minWidth )
-{
-    // Display the MessageDialog
-    MessageDialog dialog(
-        appWindow(),                // Parent
-        "AppMessage:Caption:Info",  // Dialog caption
-        "LandscapesOfTheMind.png",  // Picture file
-        "Landscapes of the Mind",   // Picture name
-        message,                    // Message
-        "infoDialog",               // Widget name
-        "AppMessage:Button:Ok" );   // Dialog button text key
-    dialog.setMinWidth( minWidth
-        ? minWidth
-        : 400 );
-    dialog.exec();
-    return;
-}
-
 //------------------------------------------------------------------------------
 /*! \brief Writes the message to the log file (if one is open).
  */
@@ -648,22 +418,9 @@ void warn( const QString &msg, int minWidth )
     log( QString( "\n*** WARNING:\n    %1\n" ).arg( msg ) );
 
     // Display the message to the screen ...
-    if ( AppGuiEnabled )
+    if ( AppGuiEnabled && AppGuiDisplay )
     {
-        if ( AppTranslatorEnabled )
-        {
-            // Convert newlines to <BR>, etc.
-            QString html( msg );
-            applyHtml( html );
-            // Display without a caption.
-            warnDialog( 0, html, minWidth );
-        }
-        else
-        {
-            QMessageBox::warning( 0,
-                QString( appWindow()->m_program + " " + appWindow()->m_version ),
-                msg, "Ok" );
-        }
+        AppGuiDisplay( AppMessageWarn, QString::null, msg, minWidth );
     }
     // or to the terminal.
     else
@@ -689,19 +446,9 @@ void warn( const QString &caption, const QString &msg, int minWidth )
     log( QString( "\n*** WARNING: %1\n    %2" ).arg( caption ).arg( msg ) );
 
     // Display the message to the screen ...
-    if ( AppGuiEnabled )
+    if ( AppGuiEnabled && AppGuiDisplay )
     {
-        if ( AppTranslatorEnabled )
-        {
-            // Convert newlines into <BR>, etc.
-            QString html( msg );
-            applyHtml( html );
-            warnDialog( caption, html, minWidth );
-        }
-        else
-        {
-            QMessageBox::warning( 0, caption, msg, "Ok" );
-        }
+        AppGuiDisplay( AppMessageWarn, caption, msg, minWidth );
     }
     // or to the terminal
     else
@@ -712,43 +459,6 @@ void warn( const QString &caption, const QString &msg, int minWidth )
     return;
 }
 
-//------------------------------------------------------------------------------
-/*! \brief Displays an warning dialog containing a picture,
- *  a scrollable rich text window with the message,
- *  and a single "Ok" button.
- *
- *  \param caption  Fully translated caption to display.
- *  \param msg      Fully translated message to display.
- *  \param minWidth Minimum width of the dialog (pixels)
- */
-
-void warnDialog( const QString &caption, const QString &message, int minWidth )
-{
-    // Build translated message with optional caption
-    QString str("");
-    if ( ! caption.isNull() )
-    {
-        str = QString( "<H3>%1</H3><HR>" ).arg( caption );
-    }
-    str += message;
-
-    // Display the MessageDialog
-    qApp->beep();
-    MessageDialog dialog(
-        appWindow(),                                // Parent
-        "AppMessage:Caption:Warn",                  // Dialog caption
-        "RestoringTheWolf.png",                     // Picture file
-        "Restoring the Wolf to Yellowstone Park",   // Picture name
-        str,                                        // Message
-        "warnDialog",                               // Widget name
-        "AppMessage:Button:Ok" );                   // Button text key
-    dialog.setMinWidth( minWidth
-        ? minWidth
-        : 400 );
-    dialog.exec();
-    return;
-}
-
 //------------------------------------------------------------------------------
 /*! \brief Displays a Yes-or-No type question to the user and gets the result.
  *  If AppGuiEnabled, the message is displayed in a dialog box.
@@ -765,21 +475,9 @@ void warnDialog( const QString &caption, const QString &message, int minWidth )
 int yesno( const QString &caption, const QString &prompt, int minWidth )
 {
     // Display the message to the screen ...
-    if ( AppGuiEnabled )
+    if ( AppGuiEnabled && AppGuiDisplay )
     {
-        if ( AppTranslatorEnabled )
-        {
-            // Convert newlines into <BR>, ect.
-            QString html( prompt );
-            applyHtml( html );
-            return( yesnoDialog( caption, html, minWidth ) );
-        }
-        else
-        {
-            int btn = QMessageBox::information( 0, caption, prompt,
-                "Yes", "No" );
-            return( btn == 0 );
-        }
+        return( AppGuiDisplay( AppMessageYesNo, caption, prompt, minWidth ) );
     }
 
     // or from the terminal.
@@ -796,44 +494,6 @@ int yesno( const QString &caption, const QString &prompt, int minWidth )
     return( 0 );
 }
 
-//------------------------------------------------------------------------------
-/*! \brief Requests a Yes-or-No answer from the user.
- *
- *  If AppGuiEnabled, displays a Yes-No dialog containing a picture,
- *  a scrollable rich text window with the prompt, and "Yes" and "No" buttons.
- *  Otherwise the prompt is printed to stdout and 'y' or 'n' is read from stdin.
- *
- *
- *  \param caption  Fully translated caption to display.
- *  \param message  Fully translated message to display.
- *  \param minWidth Minimum dialog width (pixels).
- *
- *  \retval 0 if the No button is pressed
- *  \retval 1 if the Yes button is pressed
- */
-
-int yesnoDialog( const QString &caption, const QString &message, int minWidth )
-{
-    // Build translated message with optional caption
-    QString str = QString( "<H3>%1</H3><HR>%2" ).arg( caption ).arg( message );
-
-    // Display the MessageDialog
-    qApp->beep();
-    MessageDialog dialog(
-        appWindow(),                // Parent
-        "AppMessage:Caption:YesNo", // Dialog caption
-        "CabinFever.png",           // Picture file
-        "Cabin Fever",              // Picture name
-        str,                        // Message
-        "yesnoDialog",              // Widget name
-        "AppMessage:Button:Yes",    // Accept button text key
-        "AppMessage:Button:No" );   // Reject button text key
-    dialog.setMinWidth( minWidth
-        ? minWidth
-        : 400 );
-    return( dialog.exec() );
-}
-
 //------------------------------------------------------------------------------
 //  End of appmessage.h
 //------------------------------------------------------------------------------
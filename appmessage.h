@@ -4,7 +4,8 @@
  *  \author Copyright (C) 2002-2004 by Collin D. Bevins.  All rights reserved.
  *
  *  \brief Application-wide, shared logging and message handler functions.
- *  Includes more advanced methods for the HelpDialog and MessageDialog classes.
+ *  Includes more advanced methods for the HelpDialog and MessageDialog classes,
+ *  which are defined in appmessagedialog.cpp.
  *
  *  These functions provide an application-wide mechanism for displaying
  *  error, fatal, help, informational, and warning messages to a log file,
@@ -29,7 +30,10 @@
  *
  *  If AppGuiEnabled is FALSE, messages are displayed to stderr or stdout.
  *
- *  The application controls this switch via appGuiEnabled( bool enabled ).
+ *  The application controls this switch via appGuiEnabled( bool enabled ),
+ *  and installs the dialog functions with appGuiDisplay( appMessageDialog ).
+ *  Only appmessagedialog.cpp refers to the application window, so programs
+ *  without one (such as those linking the bpengine library) omit it.
  *
  *  If AppTranslatorEnabled is TRUE, the custom AppDialog is used to display
  *  messages (which are presumed to have already been translated).
@@ -107,13 +111,38 @@ private:
     TextView *m_textView;   //!< Pointer to scrollable TextView.
 };
 
+//------------------------------------------------------------------------------
+/*! \enum AppMessageType
+ *  \brief Kinds of message passed to the appGuiDisplay() hook.
+ */
+
+enum AppMessageType
+{
+    AppMessageFatal=0,      //!< bomb()
+    AppMessageError=1,      //!< error()
+    AppMessageInfo=2,       //!< info()
+    AppMessageWarn=3,       //!< warn()
+    AppMessageYesNo=4       //!< yesno()
+};
+
+/*! \typedef AppGuiDisplayHook
+ *  \brief Displays an AppMessageType message with an optional (non-null)
+ *  caption, and returns the yesno() answer.
+ */
+typedef int (*AppGuiDisplayHook)( int type, const QString &caption,
+        const QString &message, int minWidth ) ;
+
 //------------------------------------------------------------------------------
 /*! \brief Convenience rotuines.
  */
 
+void appGuiDisplay( AppGuiDisplayHook hook ) ;
 bool appGuiEnabled( bool enabled ) ;
+int  appMessageDialog( int type, const QString &caption,
+        const QString &message, int minWidth ) ;
 
 bool appTranslatorEnabled( bool enabled ) ;
+bool appTranslatorIsEnabled( void ) ;
 
 void applyHtml( QString &msg ) ;
 
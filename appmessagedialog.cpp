@@ -0,0 +1,383 @@
+//------------------------------------------------------------------------------
+/*! \file appmessagedialog.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief HelpDialog and MessageDialog methods, and the message dialogs
+ *  that appGuiDisplay() hands info(), warn(), error(), bomb(), and yesno()
+ *  messages to while AppGuiEnabled.
+ */
+
+// Custom include files
+#include "appdialog.h"
+#include "appmessage.h"
+#include "apptranslator.h"
+#include "appwindow.h"
+#include "textview.h"
+
+// Qt include files
+#include <qapplication.h>
+#include <qmessagebox.h>
+#include <qtextedit.h>
+
+//------------------------------------------------------------------------------
+/*! \brief HelpDialog constructor.
+ *
+ *  \param parent       Pointer to parent widget.
+ *  \param captionKey   Caption text translator key.
+ *  \param dismissKey   Dismiss button text translator key.
+ *  \param htmlFile     HTML help file base name.
+ */
+
+HelpDialog::HelpDialog( QWidget *p_parent, const QString &captionKey,
+        const QString &dismissKey, const QString &htmlFile ) :
+    AppDialog(
+        p_parent,                                 // Parent widget
+        captionKey,                             // Caption
+        "",                                     // No picture file
+        "",                                     // No picture name
+        htmlFile,                               // HelpBrowser file
+        "helpBrowser",                          // Widget name
+        dismissKey,                             // Accept button text key
+        "" )                                    // No reject button
+{
+    // Hide the content pane
+    midFrame()->hide();
+    optionFrame()->hide();
+    // Start small enough to fit on an 800x600 monitor.
+    resize( 600, 400 );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief MessageDialog constructor.
+ *
+ *  \param p_parent       Pointer to the parent widget
+ *  \param captionKey   Translator key for dialog caption.
+ *  \param pictureFile  Base name of picture file to display in the left pane.
+ *  \param pictureName  Picture title.
+ *  \param message      Messagew text to diaplay.
+ *  \param p_name         Widget internal name
+ *  \param acceptKey    Translator key for text displayed on the #m_acceptBtn
+ *                      (default is "AppDialog:Button:Ok").
+ *                      The #m_acceptBtn is always displayed.
+ *  \param rejectKey    Translator key for text displayed on the #m_rejectBtn.
+ *                      (default is "").
+ *                      If NULL or empty, #m_rejectBtn is not displayed.
+ */
+
+MessageDialog::MessageDialog( QWidget *p_parent, const QString &captionKey,
+        const QString &pictureFile, const QString &pictureName,
+        const QString &message,     const char *p_name,
+        const QString &acceptKey,   const QString &rejectKey ) :
+    AppDialog( p_parent, captionKey, pictureFile, pictureName,
+        "" /* No HelpBrowser */,  p_name, acceptKey, rejectKey ),
+    m_textView(0)
+{
+    // Hide the content pane
+    m_page->m_contentFrame->hide();
+    // Add a text view to the main area
+    m_textView = new TextView( m_page, "m_textView" );
+    checkmem( __FILE__, __LINE__, m_textView, "TextView m_textView", 1 );
+    m_textView->setTextFormat( Qt::RichText );
+    m_textView->setText( message );
+    m_textView->setReadOnly( true );
+    // STart at a decent size
+    int l_width = widthHint() + 300;
+    int l_height = sizeHint().height();
+    resize( l_width, ( l_height < 300 )
+        ? 300
+        : l_height );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief MessageDialog destructor.
+ */
+
+MessageDialog::~MessageDialog( void )
+{
+    delete m_textView;  m_textView = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets MessageDialog minimum width.
+*
+*   \param minWidth Minimum dialog width in pixels.
+ */
+
+void MessageDialog::setMinWidth( int minWidth )
+{
+    m_textView->setMinimumWidth( minWidth );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Displays a message in the custom message dialogs, or in a
+ *  QMessageBox if the translator is not yet enabled.
+ *
+ *  Installed by AppWindow as the appGuiDisplay() hook.
+ *
+ *  \param type     AppMessageType of the message.
+ *  \param caption  Fully translated caption, or a null string for none.
+ *  \param message  Fully translated message text to display.
+ *  \param minWidth Minimum width of the dialog (pixels)
+ *
+ *  \return The yesno() answer (1 for yes), otherwise 0.
+ */
+
+int appMessageDialog( int type, const QString &caption,
+        const QString &message, int minWidth )
+{
+    if ( appTranslatorIsEnabled() )
+    {
+        // Convert newlines to <BR>, etc.
+        QString html( message );
+        applyHtml( html );
+        if ( type == AppMessageFatal )
+        {
+            bombDialog( html, minWidth );
+        }
+        else if ( type == AppMessageError )
+        {
+            errorDialog( caption, html, minWidth );
+        }
+        else if ( type == AppMessageInfo )
+        {
+            infoDialog( html, minWidth );
+        }
+        else if ( type == AppMessageWarn )
+        {
+            warnDialog( caption, html, minWidth );
+        }
+        else if ( type == AppMessageYesNo )
+        {
+            return( yesnoDialog( caption, html, minWidth ) );
+        }
+        return( 0 );
+    }
+    // Messages without a caption are titled with the program and version
+    QString title = ( caption.isNull() )
+        ? QString( appWindow()->m_program + " " + appWindow()->m_version )
+        : caption;
+    if ( type == AppMessageFatal )
+    {
+        QMessageBox::critical( 0, title, message, "Quit" );
+    }
+    else if ( type == AppMessageError )
+    {
+        QMessageBox::critical( 0, title, message,
+            ( caption.isNull() ) ? "Bummer" : "Ok" );
+    }
+    else if ( type == AppMessageInfo )
+    {
+        QMessageBox::information( 0, title, message, "Ok" );
+    }
+    else if ( type == AppMessageWarn )
+    {
+        QMessageBox::warning( 0, title, message, "Ok" );
+    }
+    else if ( type == AppMessageYesNo )
+    {
+        int btn = QMessageBox::information( 0, title, message,
+            "Yes", "No" );
+        return( btn == 0 );
+    }
+    return( 0 );
+}
+//------------------------------------------------------------------------------
+/*! \brief Displays a fatal error dialog containing a picture,
+ *  a scrollable rich text window with the message, and a single "Ok" button,
+ *  then terminates the program with a core dump.
+ *
+ *  \param message  Fully translated error message to display.
+ *  \param minWidth Minimum width of the dialog (pixels)
+ */
+
+void bombDialog( const QString &message, int minWidth )
+{
+    // Build translated message with optional caption
+    QString caption("");
+    QString text("");
+    translate( caption, "AppMessage:Caption:Fatal" );
+    translate( text, "AppMessage:Text:Fatal" );
+    QString str = QString( "<H3>%1</H3><HR>%2<P><B>%3</B>" )
+        .arg( caption ).arg( message ).arg( text );
+
+    // Display the MessageDialog
+    qApp->beep();
+    MessageDialog dialog(
+        appWindow(),                    // Parent
+        "AppMessage:Caption:Fatal",     // Dialog caption
+        "BlueWolf2.png",                // Picture file
+        "Blue Wolf",                    // Picture name
+        str,                            // Message text
+        "fatalDialog",                  // Widget name
+        "AppMessage:Button:Abort" );    // Button text key
+    dialog.setMinWidth( minWidth
+        ? minWidth
+        : 400 );
+    dialog.exec();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Displays an error dialog containing a picture,
+ *  a scrollable rich text window with the message, and a single "Ok" button.
+ *
+ *  \param caption  Fully translated caption text
+ *  \param message  Fully translated message text
+ *  \param minWidth Dialog minimum width in pixels
+ */
+
+void errorDialog( const QString &caption, const QString &message, int minWidth )
+{
+    // Build translated message with optional caption
+    QString str("");
+    if ( ! caption.isNull() )
+    {
+        str = QString( "<H3>%1</H3><HR>" ).arg( caption );
+    }
+    str += message;
+
+    // Display the MessageDialog
+    qApp->beep();
+    MessageDialog dialog(
+        appWindow(),                // Parent
+        "AppMessage:Caption:Error", // Dialog caption
+        "BlueWolf1.png",            // Picture file
+        "Blue Wolf",                // Picture name
+        str,                        // Message
+        "errorDialog",              // Widget name
+        "AppMessage:Button:Ok" );   // Button text key
+    dialog.setMinWidth( minWidth
+        ? minWidth
+        : 400 );
+    dialog.exec();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Help dialog convenience routine.
+ *
+ *  \param htmlFile Name of the HTML file to display.
+ */
+
+void helpDialog( const QString &htmlFile )
+{
+    // Display the help dialog
+    HelpDialog dialog(
+        appWindow(),
+        "AppMessage:Caption:Help",      // Caption key
+        "AppMessage:Button:Dismiss",    // Dismiss button text key
+        htmlFile );
+    dialog.exec();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Displays an informational dialog containing a picture,
+ *  a scrollable rich text window with the message,
+ *  and a single "Ok" button.
+ *
+ *  \param message  Fully translated info message to display.
+ *  \param minWidth Minimum width of the dialog (pixels)
+ */
+
+void infoDialog( const QString &message, int minWidth )
+{
+    // Display the MessageDialog
+    MessageDialog dialog(
+        appWindow(),                // Parent
+        "AppMessage:Caption:Info",  // Dialog caption
+        "LandscapesOfTheMind.png",  // Picture file
+        "Landscapes of the Mind",   // Picture name
+        message,                    // Message
+        "infoDialog",               // Widget name
+        "AppMessage:Button:Ok" );   // Dialog button text key
+    dialog.setMinWidth( minWidth
+        ? minWidth
+        : 400 );
+    dialog.exec();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Displays an warning dialog containing a picture,
+ *  a scrollable rich text window with the message,
+ *  and a single "Ok" button.
+ *
+ *  \param caption  Fully translated caption to display.
+ *  \param msg      Fully translated message to display.
+ *  \param minWidth Minimum width of the dialog (pixels)
+ */
+
+void warnDialog( const QString &caption, const QString &message, int minWidth )
+{
+    // Build translated message with optional caption
+    QString str("");
+    if ( ! caption.isNull() )
+    {
+        str = QString( "<H3>%1</H3><HR>" ).arg( caption );
+    }
+    str += message;
+
+    // Display the MessageDialog
+    qApp->beep();
+    MessageDialog dialog(
+        appWindow(),                                // Parent
+        "AppMessage:Caption:Warn",                  // Dialog caption
+        "RestoringTheWolf.png",                     // Picture file
+        "Restoring the Wolf to Yellowstone Park",   // Picture name
+        str,                                        // Message
+        "warnDialog",                               // Widget name
+        "AppMessage:Button:Ok" );                   // Button text key
+    dialog.setMinWidth( minWidth
+        ? minWidth
+        : 400 );
+    dialog.exec();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Requests a Yes-or-No answer from the user.
+ *
+ *  If AppGuiEnabled, displays a Yes-No dialog containing a picture,
+ *  a scrollable rich text window with the prompt, and "Yes" and "No" buttons.
+ *  Otherwise the prompt is printed to stdout and 'y' or 'n' is read from stdin.
+ *
+ *
+ *  \param caption  Fully translated caption to display.
+ *  \param message  Fully translated message to display.
+ *  \param minWidth Minimum dialog width (pixels).
+ *
+ *  \retval 0 if the No button is pressed
+ *  \retval 1 if the Yes button is pressed
+ */
+
+int yesnoDialog( const QString &caption, const QString &message, int minWidth )
+{
+    // Build translated message with optional caption
+    QString str = QString( "<H3>%1</H3><HR>%2" ).arg( caption ).arg( message );
+
+    // Display the MessageDialog
+    qApp->beep();
+    MessageDialog dialog(
+        appWindow(),                // Parent
+        "AppMessage:Caption:YesNo", // Dialog caption
+        "CabinFever.png",           // Picture file
+        "Cabin Fever",              // Picture name
+        str,                        // Message
+        "yesnoDialog",              // Widget name
+        "AppMessage:Button:Yes",    // Accept button text key
+        "AppMessage:Button:No" );   // Reject button text key
+    dialog.setMinWidth( minWidth
+        ? minWidth
+        : 400 );
+    return( dialog.exec() );
+}
+
+//------------------------------------------------------------------------------
+//  End of appmessagedialog.cpp
+//------------------------------------------------------------------------------
@@ -190,6 +190,7 @@ AppWindow::AppWindow( BehavePlusApp *bpApp, const QString &program,
 void AppWindow::slotAppInit( void )
 {
     // Let the message handler know that we are GUI
+    appGuiDisplay( appMessageDialog );
     appGuiEnabled( true );
 
     // Create the application-wide, shared FileSystem names
@@ -1031,6 +1032,41 @@ void AppWindow::initMenuCalculate( void )
     m_idFileCalculate = m_calculateMenu->insertItem( *m_fileRunIcon, text,
         this, SLOT( slotDocumentRun() ) );
 
+    // Calculate hourly weather series
+    translate( text, "Menu:Calculate:CalculateHourly" );
+    m_idFileCalculateHourly = m_calculateMenu->insertItem( text,
+        this, SLOT( slotDocumentRunHourly() ) );
+
+    // Calculate fire transect segments
+    translate( text, "Menu:Calculate:CalculateTransect" );
+    m_idFileCalculateTransect = m_calculateMenu->insertItem( text,
+        this, SLOT( slotDocumentRunTransect() ) );
+
+    // Calculate and save the table results for later comparison
+    translate( text, "Menu:Calculate:CalculateSave" );
+    m_idFileCalculateSave = m_calculateMenu->insertItem( text,
+        this, SLOT( slotDocumentRunSave() ) );
+
+    // Compare two saved table results
+    translate( text, "Menu:Calculate:CompareResults" );
+    m_idFileCompareResults = m_calculateMenu->insertItem( text,
+        this, SLOT( slotDocumentCompareResults() ) );
+
+    // Calibrate a fuel model to observed fire behavior
+    translate( text, "Menu:Calculate:CalibrateFuelModel" );
+    m_idFileCalibrateFuelModel = m_calculateMenu->insertItem( text,
+        this, SLOT( slotDocumentCalibrateFuelModel() ) );
+
+    // Set site terrain inputs from an elevation grid
+    translate( text, "Menu:Calculate:TerrainGrid" );
+    m_idFileTerrainGrid = m_calculateMenu->insertItem( text,
+        this, SLOT( slotDocumentTerrainGrid() ) );
+
+    // Write burn probability grids from the table's fire shapes
+    translate( text, "Menu:Calculate:BurnGrid" );
+    m_idFileBurnGrid = m_calculateMenu->insertItem( text,
+        this, SLOT( slotDocumentBurnGrid() ) );
+
     // Add Calculate menu to the menu bar
     translate( text, "Menu:Calculate" );
     m_idConfig = menuBar()->insertItem( text, m_calculateMenu );
@@ -2249,6 +2285,79 @@ void AppWindow::slotConfigureUnitsMetric( void )
     return;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Runs the current active Document and writes burn probability
+ *  grids from its table's fire shapes to a grid file selected by the user.
+ *
+ *  Called only by the \b Calculate->Burn probability grid menu selection.
+ *
+ *  BpDocument::runBurnGrid() is called to perform the operation.
+ */
+
+void AppWindow::slotDocumentBurnGrid( void )
+{
+    log( "Beg Section: AppWindow::slotDocumentBurnGrid() invoked ...\n" );
+    Document *doc = getActiveWindow( "BpDocument" );
+    if ( doc )
+    {
+        QString caption("");
+        translate( caption, "AppWindow:BurnGrid:Caption" );
+        QFileDialog fd( this, "burnGrid", true );
+        fd.setDir( appFileSystem()->workspacePath() );
+        fd.setMode( QFileDialog::AnyFile );
+        fd.setFilter( "ESRI ASCII grids (*.asc)" );
+        fd.setCaption( caption );
+        if ( fd.exec() == QDialog::Accepted
+          && ! fd.selectedFile().isEmpty() )
+        {
+            QString fileName = fd.selectedFile();
+            if ( fileName.right( 4 ) != ".asc" )
+            {
+                fileName.append( ".asc" );
+            }
+            log( QString( "Running document \"%1\" burn grid \"%2\" ...\n" )
+                .arg( doc->m_absPathName ).arg( fileName ) );
+            ((BpDocument *) doc)->runBurnGrid( fileName );
+        }
+    }
+    log( "End Section: AppWindow::slotDocumentBurnGrid() completed.\n" );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Calibrates a fuel model to a fire behavior observation file
+ *  selected by the user.
+ *
+ *  Called only by the \b Calculate->Calibrate menu selection.
+ *
+ *  BpDocument::calibrateFuelModel() is called to perform the operation.
+ */
+
+void AppWindow::slotDocumentCalibrateFuelModel( void )
+{
+    log( "Beg Section: AppWindow::slotDocumentCalibrateFuelModel() invoked ...\n" );
+    Document *doc = getActiveWindow( "BpDocument" );
+    if ( doc )
+    {
+        QString caption("");
+        translate( caption, "AppWindow:CalibrateFuelModel:Caption" );
+        QFileDialog fd( this, "calibrateFuelModel", true );
+        fd.setDir( appFileSystem()->workspacePath() );
+        fd.setMode( QFileDialog::ExistingFile );
+        fd.setFilter( "Fuel observations (*.txt *.obs)" );
+        fd.setCaption( caption );
+        if ( fd.exec() == QDialog::Accepted
+          && ! fd.selectedFile().isEmpty() )
+        {
+            log( QString( "Calibrating fuel model to observations \"%1\" ...\n" )
+                .arg( fd.selectedFile() ) );
+            ((BpDocument *) doc)->calibrateFuelModel( fd.selectedFile() );
+        }
+    }
+    log( "End Section: AppWindow::slotDocumentCalibrateFuelModel() completed.\n" );
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Captures the current Document page to an image file.
  *
@@ -2501,6 +2610,154 @@ void AppWindow::slotDocumentRun( void )
     return;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Runs the current active Document for every hour of a weather
+ *  series file selected by the user.
+ *
+ *  Called only by the \b Calculate->Hourly menu selection.
+ *
+ *  BpDocument::runHourly() is called to perform the operation.
+ */
+
+void AppWindow::slotDocumentRunHourly( void )
+{
+    log( "Beg Section: AppWindow::slotDocumentRunHourly() invoked ...\n" );
+    Document *doc = getActiveWindow( "BpDocument" );
+    if ( doc )
+    {
+        QString caption("");
+        translate( caption, "AppWindow:RunHourly:Caption" );
+        QFileDialog fd( this, "runHourly", true );
+        fd.setDir( appFileSystem()->workspacePath() );
+        fd.setMode( QFileDialog::ExistingFile );
+        fd.setFilter( "Weather series (*.txt *.wx)" );
+        fd.setCaption( caption );
+        if ( fd.exec() == QDialog::Accepted
+          && ! fd.selectedFile().isEmpty() )
+        {
+            log( QString( "Running document \"%1\" hourly weather \"%2\" ...\n" )
+                .arg( doc->m_absPathName ).arg( fd.selectedFile() ) );
+            ((BpDocument *) doc)->runHourly( fd.selectedFile() );
+        }
+    }
+    log( "End Section: AppWindow::slotDocumentRunHourly() completed.\n" );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Runs the current active Document for every segment of a fire
+ *  transect file selected by the user.
+ *
+ *  Called only by the \b Calculate->Transect menu selection.
+ *
+ *  BpDocument::runTransect() is called to perform the operation.
+ */
+
+void AppWindow::slotDocumentRunTransect( void )
+{
+    log( "Beg Section: AppWindow::slotDocumentRunTransect() invoked ...\n" );
+    Document *doc = getActiveWindow( "BpDocument" );
+    if ( doc )
+    {
+        QString caption("");
+        translate( caption, "AppWindow:RunTransect:Caption" );
+        QFileDialog fd( this, "runTransect", true );
+        fd.setDir( appFileSystem()->workspacePath() );
+        fd.setMode( QFileDialog::ExistingFile );
+        fd.setFilter( "Fire transects (*.txt *.trn)" );
+        fd.setCaption( caption );
+        if ( fd.exec() == QDialog::Accepted
+          && ! fd.selectedFile().isEmpty() )
+        {
+            log( QString( "Running document \"%1\" transect \"%2\" ...\n" )
+                .arg( doc->m_absPathName ).arg( fd.selectedFile() ) );
+            ((BpDocument *) doc)->runTransect( fd.selectedFile() );
+        }
+    }
+    log( "End Section: AppWindow::slotDocumentRunTransect() completed.\n" );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Runs the current active Document and saves its table results to
+ *  a result set file selected by the user.
+ *
+ *  Called only by the \b Calculate->Save results menu selection.
+ *
+ *  BpDocument::runSaveResults() is called to perform the operation.
+ */
+
+void AppWindow::slotDocumentRunSave( void )
+{
+    log( "Beg Section: AppWindow::slotDocumentRunSave() invoked ...\n" );
+    Document *doc = getActiveWindow( "BpDocument" );
+    if ( doc )
+    {
+        QString caption("");
+        translate( caption, "AppWindow:RunSave:Caption" );
+        QFileDialog fd( this, "runSave", true );
+        fd.setDir( appFileSystem()->workspacePath() );
+        fd.setMode( QFileDialog::AnyFile );
+        fd.setFilter( QString( "Result sets (*.%1)" )
+            .arg( appFileSystem()->resultSetExt() ) );
+        fd.setCaption( caption );
+        if ( fd.exec() == QDialog::Accepted
+          && ! fd.selectedFile().isEmpty() )
+        {
+            QString fileName = fd.selectedFile();
+            addExtension( fileName, appFileSystem()->resultSetExt() );
+            log( QString( "Running document \"%1\" result set \"%2\" ...\n" )
+                .arg( doc->m_absPathName ).arg( fileName ) );
+            ((BpDocument *) doc)->runSaveResults( fileName );
+        }
+    }
+    log( "End Section: AppWindow::slotDocumentRunSave() completed.\n" );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Compares two result set files selected by the user and displays
+ *  the comparison in the current active Document.
+ *
+ *  Called only by the \b Calculate->Compare results menu selection.
+ *
+ *  BpDocument::compareResults() is called to perform the operation.
+ */
+
+void AppWindow::slotDocumentCompareResults( void )
+{
+    log( "Beg Section: AppWindow::slotDocumentCompareResults() invoked ...\n" );
+    Document *doc = getActiveWindow( "BpDocument" );
+    if ( doc )
+    {
+        QString caption(""), fileA("");
+        translate( caption, "AppWindow:CompareResults:CaptionA" );
+        QFileDialog fd( this, "compareResults", true );
+        fd.setDir( appFileSystem()->workspacePath() );
+        fd.setMode( QFileDialog::ExistingFile );
+        fd.setFilter( QString( "Result sets (*.%1)" )
+            .arg( appFileSystem()->resultSetExt() ) );
+        fd.setCaption( caption );
+        if ( fd.exec() == QDialog::Accepted
+          && ! fd.selectedFile().isEmpty() )
+        {
+            fileA = fd.selectedFile();
+            translate( caption, "AppWindow:CompareResults:CaptionB" );
+            fd.setCaption( caption );
+            if ( fd.exec() == QDialog::Accepted
+              && ! fd.selectedFile().isEmpty() )
+            {
+                log( QString( "Comparing result sets \"%1\" and \"%2\" ...\n" )
+                    .arg( fileA ).arg( fd.selectedFile() ) );
+                ((BpDocument *) doc)->compareResults( fileA,
+                    fd.selectedFile() );
+            }
+        }
+    }
+    log( "End Section: AppWindow::slotDocumentCompareResults() completed.\n" );
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Saves the current active Document to its current file name
  *  Document::m_absPathName.
@@ -2609,6 +2866,40 @@ void AppWindow::slotDocumentSaveAsWorksheet( void )
     return;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Sets the active worksheet's site terrain inputs from an elevation
+ *  grid file selected by the user.
+ *
+ *  Called only by the \b Calculate->Terrain menu selection.
+ *
+ *  BpDocument::applyTerrainGrid() is called to perform the operation.
+ */
+
+void AppWindow::slotDocumentTerrainGrid( void )
+{
+    log( "Beg Section: AppWindow::slotDocumentTerrainGrid() invoked ...\n" );
+    Document *doc = getActiveWindow( "BpDocument" );
+    if ( doc )
+    {
+        QString caption("");
+        translate( caption, "AppWindow:TerrainGrid:Caption" );
+        QFileDialog fd( this, "terrainGrid", true );
+        fd.setDir( appFileSystem()->workspacePath() );
+        fd.setMode( QFileDialog::ExistingFile );
+        fd.setFilter( "Elevation grids (*.asc *.txt)" );
+        fd.setCaption( caption );
+        if ( fd.exec() == QDialog::Accepted
+          && ! fd.selectedFile().isEmpty() )
+        {
+            log( QString( "Applying terrain grid \"%1\" ...\n" )
+                .arg( fd.selectedFile() ) );
+            ((BpDocument *) doc)->applyTerrainGrid( fd.selectedFile() );
+        }
+    }
+    log( "End Section: AppWindow::slotDocumentTerrainGrid() completed.\n" );
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Creates a new data directory (workspace) and populates it with the
  *  required folders and files.
@@ -3358,6 +3649,13 @@ void AppWindow::slotStatusUpdate( void )
         //m_fileMenu->setItemEnabled( m_idFileSave, false );
         m_fileMenu->setItemEnabled( m_idFileSaveAs, false );
         m_fileMenu->setItemEnabled( m_idFileCalculate, false );
+        m_calculateMenu->setItemEnabled( m_idFileCalculateHourly, false );
+        m_calculateMenu->setItemEnabled( m_idFileCalculateTransect, false );
+        m_calculateMenu->setItemEnabled( m_idFileCalculateSave, false );
+        m_calculateMenu->setItemEnabled( m_idFileCompareResults, false );
+        m_calculateMenu->setItemEnabled( m_idFileCalibrateFuelModel, false );
+        m_calculateMenu->setItemEnabled( m_idFileTerrainGrid, false );
+        m_calculateMenu->setItemEnabled( m_idFileBurnGrid, false );
         m_fileMenu->setItemEnabled( m_idFilePrint, false );
         m_fileMenu->setItemEnabled( m_idFileExport, false );
         m_fileMenu->setItemEnabled( m_idFileExportFuelModels, false );
@@ -3391,6 +3689,13 @@ void AppWindow::slotStatusUpdate( void )
         //m_fileMenu->setItemEnabled( m_idFileSave, true );
         m_fileMenu->setItemEnabled( m_idFileSaveAs, true );
         m_fileMenu->setItemEnabled( m_idFileCalculate, true );
+        m_calculateMenu->setItemEnabled( m_idFileCalculateHourly, true );
+        m_calculateMenu->setItemEnabled( m_idFileCalculateTransect, true );
+        m_calculateMenu->setItemEnabled( m_idFileCalculateSave, true );
+        m_calculateMenu->setItemEnabled( m_idFileCompareResults, true );
+        m_calculateMenu->setItemEnabled( m_idFileCalibrateFuelModel, true );
+        m_calculateMenu->setItemEnabled( m_idFileTerrainGrid, true );
+        m_calculateMenu->setItemEnabled( m_idFileBurnGrid, true );
         m_fileMenu->setItemEnabled( m_idFilePrint, true );
         m_fileMenu->setItemEnabled( m_idFileExport, true );
         m_fileMenu->setItemEnabled( m_idFileExportFuelModels, true );
@@ -92,21 +92,28 @@ private slots:
     void slotConfigureUnitsCustom( void ) ;
     void slotConfigureUnitsEnglish( void ) ;
     void slotConfigureUnitsMetric( void ) ;
+    void slotDocumentBurnGrid( void ) ;
+    void slotDocumentCalibrateFuelModel( void ) ;
     void slotDocumentCapture( void ) ;
     void slotDocumentClear( void ) ;
     void slotDocumentClone( void ) ;
     void slotDocumentExportFuelModelsFarsite( void ) ;
+    void slotDocumentCompareResults( void ) ;
     void slotDocumentExportResults( void ) ;
     void slotDocumentNew( void ) ;
     void slotDocumentOpen( void ) ;
     void slotDocumentPrint( void ) ;
     void slotDocumentReset( void ) ;
     void slotDocumentRun( void ) ;
+    void slotDocumentRunHourly( void ) ;
+    void slotDocumentRunSave( void ) ;
+    void slotDocumentRunTransect( void ) ;
     void slotDocumentSave( void ) ;
     void slotDocumentSaveAsFuelModel( void ) ;
     void slotDocumentSaveAsMoistureScenario( void ) ;
     void slotDocumentSaveAsRun( void ) ;
     void slotDocumentSaveAsWorksheet( void ) ;
+    void slotDocumentTerrainGrid( void ) ;
     void slotDocumentWorkspace( bool clone=false ) ;
     void slotDocumentWorkspaceClone( void ) ;
     void slotDocumentWorkspaceNew( void ) ;
@@ -213,6 +220,13 @@ public:
     int          m_idFileSaveAsFuelModel;   //!< File->saveAs->Fuel model menu item id
     int          m_idFileSaveAsMoistureScenario;    //!< File->saveAs->Moisture scenario menu item id
     int          m_idFileCalculate;         //!< File->Calculate menu item id
+    int          m_idFileCalculateHourly;   //!< Calculate->Hourly menu item id
+    int          m_idFileCalculateTransect; //!< Calculate->Transect menu item id
+    int          m_idFileCalculateSave;     //!< Calculate->Save results menu item id
+    int          m_idFileCompareResults;    //!< Calculate->Compare results menu item id
+    int          m_idFileCalibrateFuelModel;//!< Calculate->Calibrate menu item id
+    int          m_idFileTerrainGrid;       //!< Calculate->Terrain grid menu item id
+    int          m_idFileBurnGrid;          //!< Calculate->Burn grid menu item id
     int          m_idFilePrint;             //!< File->Print menu item id
     int          m_idFileReset;             //!< File->Print menu item id
     int          m_idFileExport;            //!< File->Export menu item id
@@ -0,0 +1,447 @@
+//------------------------------------------------------------------------------
+/*! \file bpcomposecompare.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief BpDocument result set comparison composer.
+ *
+ *  Additional BehavePlusDocument method definitions are in:
+ *      - bpdocument.cpp
+ *      - bpcomposetablequery.cpp
+ */
+
+// Custom include files
+#include "appmessage.h"
+#include "apptranslator.h"
+#include "bpdocument.h"
+#include "composer.h"
+#include "docdevicesize.h"
+#include "docpagesize.h"
+#include "fixeddecimal.h"
+#include "property.h"
+#include "resultcompare.h"
+#include "resultset.h"
+#include "xeqcalc.h"
+#include "xeqtree.h"
+#include "xeqvar.h"
+#include "xeqvaritem.h"
+
+// Qt include files
+#include <qfontmetrics.h>
+#include <qpen.h>
+#include <qstringlist.h>
+
+/*! \var CompareColumns
+ *  \brief Number of columns in the comparison tables.
+ */
+static const int CompareColumns = 6;
+
+/*! \var CompareColumnWd
+ *  \brief Fraction of the page body width used by each column of the
+ *  per-output summary table (0) and the differences table (1).
+ */
+static const double CompareColumnWd[2][CompareColumns] =
+{
+    { 0.34, 0.12, 0.12, 0.14, 0.14, 0.14 },
+    { 0.14, 0.14, 0.30, 0.14, 0.14, 0.14 }
+};
+
+/*! \var CompareLeftColumns
+ *  \brief Number of left-justified (text) columns in the per-output
+ *  summary table (0) and the differences table (1).
+ */
+static const int CompareLeftColumns[2] = { 2, 3 };
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the number of decimals (up to 6) needed to display
+ *  a range variable value without trailing zeros.
+ *
+ *  \return Number of decimals.
+ */
+
+static int compareDecimals( double value )
+{
+    QString qStr("");
+    int decimals = 6;
+    fixedDecimal( qStr, value, decimals );
+    while ( decimals > 0 && qStr.endsWith( "0" ) )
+    {
+        qStr = qStr.left( qStr.length()-1 );
+        decimals--;
+    }
+    return( decimals );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Formats a result set value for display.
+ *
+ *  \param varPtr   Pointer to the EqVar with the value's name, or 0 if the
+ *                  name is not known to this release.
+ *  \param value    Value (display units, or item index for discrete
+ *                  variables).
+ *  \param decimals Number of decimals for continuous variables.
+ *  \param qStr     Reference to the string to hold the text.
+ */
+
+static void compareValueText( EqVar *varPtr, double value, int decimals,
+        QString &qStr )
+{
+    if ( value != value )
+    {
+        qStr = "NaN";
+    }
+    else if ( varPtr && varPtr->isDiscrete() )
+    {
+        qStr = varPtr->m_itemList->itemName( (int) value );
+    }
+    else
+    {
+        fixedDecimal( qStr, value, decimals );
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Composes the comparison of two result sets.
+ *
+ *  The first page lists the two files, the number of aligned cells, the
+ *  number of differences and of boundary values, and any outputs that were
+ *  not compared, followed by a summary line for each
+ *  compared output (its tolerance, differing cells, and maximum absolute
+ *  and relative deviations).  The differences table then lists up to
+ *  ResultCompareMaxDiffs differing values, in table order, with their range
+ *  variable values and both files' values.
+ *
+ *  Called only by BpDocument::compareResults().
+ *
+ *  \param cmp  Pointer to the completed ResultCompare.
+ *  \param a    Pointer to the first (reference) result set.
+ *  \param b    Pointer to the second result set.
+ */
+
+void BpDocument::composeCompare( ResultCompare *cmp, ResultSet *a,
+        ResultSet *b )
+{
+    // Build the report a line at a time; the first character of each line
+    // is its type: 'T' text, 'B' blank, 'h' and 'r' summary table header
+    // and row, 'H' and 'R' differences table header and row.
+    QStringList lines;
+    QString qStr(""), text(""), field[CompareColumns];
+    int i, v, vid;
+    translate( qStr, "BpDocument:Compare:FileA", a->m_fileName );
+    lines.append( "T" + qStr );
+    translate( qStr, "BpDocument:Compare:FileB", b->m_fileName );
+    lines.append( "T" + qStr );
+    translate( qStr, "BpDocument:Compare:Cells",
+        QString( "%1" ).arg( cmp->m_rows ),
+        QString( "%1" ).arg( cmp->m_cols ),
+        QString( "%1" ).arg( cmp->m_rows * cmp->m_cols ),
+        QString( "%1" ).arg( cmp->m_vars ) );
+    lines.append( "T" + qStr );
+    translate( qStr, "BpDocument:Compare:Diffs",
+        QString( "%1" ).arg( cmp->m_totalDiffs ) );
+    lines.append( "T" + qStr );
+    if ( cmp->m_boundary > 0 )
+    {
+        translate( qStr, "BpDocument:Compare:Boundary",
+            QString( "%1" ).arg( cmp->m_boundary ),
+            QString( "%1" ).arg( ResultCompareRelEpsilon ) );
+        lines.append( "T" + qStr );
+    }
+    if ( ! cmp->m_onlyA.isEmpty() )
+    {
+        translate( qStr, "BpDocument:Compare:OnlyA",
+            cmp->m_onlyA.join( ", " ) );
+        lines.append( "T" + qStr );
+    }
+    if ( ! cmp->m_onlyB.isEmpty() )
+    {
+        translate( qStr, "BpDocument:Compare:OnlyB",
+            cmp->m_onlyB.join( ", " ) );
+        lines.append( "T" + qStr );
+    }
+    if ( ! cmp->m_units.isEmpty() )
+    {
+        translate( qStr, "BpDocument:Compare:Units",
+            cmp->m_units.join( ", " ) );
+        lines.append( "T" + qStr );
+    }
+    lines.append( "B" );
+
+    // Per-output summary table.
+    EqVar **varPtr = new EqVar *[ cmp->m_vars + 1 ];
+    checkmem( __FILE__, __LINE__, varPtr, "EqVar *varPtr", cmp->m_vars + 1 );
+    for ( i = 0;
+          i < CompareColumns;
+          i++ )
+    {
+        translate( field[i], QString( "BpDocument:Compare:Summary:%1" )
+            .arg( i ) );
+    }
+    lines.append( "h" + field[0] + "\t" + field[1] + "\t" + field[2]
+        + "\t" + field[3] + "\t" + field[4] + "\t" + field[5] );
+    for ( v = 0;
+          v < cmp->m_vars;
+          v++ )
+    {
+        vid = cmp->m_varA[v];
+        varPtr[v] = m_eqTree->m_varDict->find( a->m_varName[vid] );
+        field[0] = ( varPtr[v] ) ? *(varPtr[v]->m_label) : a->m_varName[vid];
+        field[1] = ( a->m_varUnits[vid] == "-" ) ? QString( "" )
+                                            : a->m_varUnits[vid];
+        if ( a->m_varDiscrete[vid] )
+        {
+            field[2] = field[4] = field[5] = "";
+        }
+        else
+        {
+            field[2] = QString( "%1" ).arg( cmp->m_decimals[v] );
+            fixedDecimal( field[4], cmp->m_maxAbs[v],
+                a->m_varDecimals[vid] + 1 );
+            fixedDecimal( field[5], 100. * cmp->m_maxRel[v], 3 );
+        }
+        field[3] = QString( "%1" ).arg( cmp->m_diffCells[v] );
+        lines.append( "r" + field[0] + "\t" + field[1] + "\t" + field[2]
+            + "\t" + field[3] + "\t" + field[4] + "\t" + field[5] );
+    }
+    lines.append( "B" );
+
+    // Differences table.
+    if ( cmp->m_diffs > 0 )
+    {
+        translate( qStr, "BpDocument:Compare:DiffsShown",
+            QString( "%1" ).arg( cmp->m_diffs ),
+            QString( "%1" ).arg( cmp->m_totalDiffs ) );
+        lines.append( "T" + qStr );
+        field[0] = a->m_rowVar;
+        field[1] = ( a->m_colVar == "-" ) ? QString( "" ) : a->m_colVar;
+        for ( i = 0;
+              i < 2;
+              i++ )
+        {
+            EqVar *rangePtr = m_eqTree->m_varDict->find( field[i] );
+            if ( rangePtr )
+            {
+                field[i] = *(rangePtr->m_label);
+            }
+        }
+        for ( i = 2;
+              i < CompareColumns;
+              i++ )
+        {
+            translate( field[i], QString( "BpDocument:Compare:Diff:%1" )
+                .arg( i ) );
+        }
+        lines.append( "H" + field[0] + "\t" + field[1] + "\t" + field[2]
+            + "\t" + field[3] + "\t" + field[4] + "\t" + field[5] );
+        // Range variable value decimals.
+        EqVar *rowPtr = m_eqTree->m_varDict->find( a->m_rowVar );
+        EqVar *colPtr = m_eqTree->m_varDict->find( a->m_colVar );
+        int rowDecimals = 0;
+        int colDecimals = 0;
+        int decimals, row, col;
+        for ( i = 0;
+              i < cmp->m_diffs;
+              i++ )
+        {
+            row = cmp->m_rowA[ cmp->m_diffCell[i] / cmp->m_cols ];
+            col = cmp->m_colA[ cmp->m_diffCell[i] % cmp->m_cols ];
+            if ( ( decimals = compareDecimals( a->m_row[row] ) )
+                > rowDecimals )
+            {
+                rowDecimals = decimals;
+            }
+            if ( ( decimals = compareDecimals( a->m_col[col] ) )
+                > colDecimals )
+            {
+                colDecimals = decimals;
+            }
+        }
+        for ( i = 0;
+              i < cmp->m_diffs;
+              i++ )
+        {
+            row = cmp->m_rowA[ cmp->m_diffCell[i] / cmp->m_cols ];
+            col = cmp->m_colA[ cmp->m_diffCell[i] % cmp->m_cols ];
+            v = cmp->m_diffVar[i];
+            vid = cmp->m_varA[v];
+            compareValueText( rowPtr, a->m_row[row], rowDecimals, field[0] );
+            field[1] = "";
+            if ( a->m_colVar != "-" )
+            {
+                compareValueText( colPtr, a->m_col[col], colDecimals,
+                    field[1] );
+            }
+            field[2] = ( varPtr[v] ) ? *(varPtr[v]->m_label)
+                                     : a->m_varName[vid];
+            decimals = a->m_varDecimals[vid] + 1;
+            compareValueText( varPtr[v], cmp->m_diffA[i], decimals,
+                field[3] );
+            compareValueText( varPtr[v], cmp->m_diffB[i], decimals,
+                field[4] );
+            field[5] = "";
+            if ( ! a->m_varDiscrete[vid] )
+            {
+                compareValueText( 0, cmp->m_diffB[i] - cmp->m_diffA[i],
+                    decimals, field[5] );
+            }
+            lines.append( "R" + field[0] + "\t" + field[1] + "\t" + field[2]
+                + "\t" + field[3] + "\t" + field[4] + "\t" + field[5] );
+        }
+    }
+    delete[] varPtr;
+
+    // Display fonts.
+    QFont textFont( property()->string( "tableTextFontFamily" ),
+                    property()->integer( "tableTextFontSize" ) );
+    QPen textPen( property()->color( "tableTextFontColor" ) );
+    QFontMetrics textMetrics( textFont );
+
+    QFont titleFont( property()->string( "tableTitleFontFamily" ),
+                    property()->integer( "tableTitleFontSize" ) );
+    QPen titlePen( property()->color( "tableTitleFontColor" ) );
+    QFontMetrics titleMetrics( titleFont );
+
+    QFont valueFont( property()->string( "tableValueFontFamily" ),
+                    property()->integer( "tableValueFontSize" ) );
+    QPen valuePen( property()->color( "tableValueFontColor" ) );
+    QFontMetrics valueMetrics( valueFont );
+
+    bool doRowBg = property()->boolean( "tableRowBackgroundColorActive" );
+    QBrush rowBrush( property()->color( "tableRowBackgroundColor" ),
+        Qt::SolidPattern );
+
+    double yppi  = m_screenSize->m_yppi;
+    double padWd = m_pageSize->m_padWd;
+    double textHt, titleHt, valueHt, rowHt;
+    textHt  = ( textMetrics.lineSpacing()  + m_screenSize->m_padHt ) / yppi;
+    titleHt = ( titleMetrics.lineSpacing() + m_screenSize->m_padHt ) / yppi;
+    valueHt = ( valueMetrics.lineSpacing() + m_screenSize->m_padHt ) / yppi;
+    rowHt   = ( textHt > valueHt )
+              ? textHt
+              : valueHt;
+
+    // Draw the report, repeating the current table header on each new page.
+    QString title(""), header("");
+    translate( title, "BpDocument:Compare" );
+    double yPos = m_pageSize->m_bodyEnd;
+    double x0, wd;
+    bool doThisRowBg = false;
+    bool newPage = true;
+    int set, c;
+    QChar type;
+    QStringList::Iterator it;
+    for ( it = lines.begin();
+          it != lines.end();
+          ++it )
+    {
+        type = (*it)[0];
+        text = (*it).mid( 1 );
+        if ( type == 'h' || type == 'H' )
+        {
+            header = *it;
+            // Keep a header with at least one row.
+            if ( yPos + 4. * rowHt > m_pageSize->m_bodyEnd )
+            {
+                yPos = m_pageSize->m_bodyEnd;
+            }
+        }
+        // Start a new page when this one is full.
+        if ( yPos + rowHt > m_pageSize->m_bodyEnd )
+        {
+            startNewPage( title, newPage ? TocListOut : TocBlank );
+            yPos = m_pageSize->m_marginTop + titleHt;
+            m_composer->font( titleFont );
+            m_composer->pen( titlePen );
+            qStr = m_eqTree->m_eqCalc->docDescriptionStore().stripWhiteSpace();
+            m_composer->text(
+                m_pageSize->m_marginLeft,   yPos,
+                m_pageSize->m_bodyWd,       titleHt,
+                Qt::AlignVCenter|Qt::AlignHCenter,
+                qStr );
+            yPos += 2. * titleHt;
+            newPage = false;
+            if ( ( type == 'r' || type == 'R' ) && ! header.isEmpty() )
+            {
+                // Redraw the current table header above the continued rows.
+                while ( *it != header )
+                {
+                    --it;
+                }
+                --it;
+                continue;
+            }
+        }
+        if ( type == 'B' )
+        {
+            yPos += textHt;
+            continue;
+        }
+        if ( type == 'T' )
+        {
+            m_composer->font( textFont );
+            m_composer->pen( textPen );
+            m_composer->text(
+                m_pageSize->m_bodyLeft,     yPos,
+                m_pageSize->m_bodyWd,       textHt,
+                Qt::AlignVCenter|Qt::AlignLeft,
+                text );
+            yPos += textHt;
+            continue;
+        }
+        // Table header or row.
+        set = ( type == 'h' || type == 'r' ) ? 0 : 1;
+        bool isHeader = ( type == 'h' || type == 'H' );
+        if ( isHeader )
+        {
+            doThisRowBg = false;
+            m_composer->font( textFont );
+            m_composer->pen( textPen );
+        }
+        else
+        {
+            m_composer->font( valueFont );
+            m_composer->pen( valuePen );
+        }
+        if ( doRowBg && ( isHeader || doThisRowBg ) )
+        {
+            m_composer->fill( m_pageSize->m_bodyLeft - padWd, yPos,
+                m_pageSize->m_bodyWd + 2. * padWd, rowHt, rowBrush );
+        }
+        if ( ! isHeader )
+        {
+            doThisRowBg = ! doThisRowBg;
+        }
+        x0 = m_pageSize->m_bodyLeft;
+        for ( c = 0;
+              c < CompareColumns;
+              c++ )
+        {
+            wd = CompareColumnWd[set][c] * m_pageSize->m_bodyWd;
+            m_composer->text( x0, yPos, wd - padWd, rowHt,
+                Qt::AlignVCenter
+                | ( ( c < CompareLeftColumns[set] )
+                    ? Qt::AlignLeft
+                    : Qt::AlignRight ),
+                text.section( '\t', c, c ) );
+            x0 += wd;
+        }
+        yPos += rowHt;
+        // Underline the header only if we are not coloring rows.
+        if ( isHeader && ! doRowBg )
+        {
+            m_composer->line(
+                m_pageSize->m_bodyLeft,     yPos + 0.25 * textHt,
+                m_pageSize->m_bodyRight,    yPos + 0.25 * textHt );
+            yPos += 0.5 * textHt;
+        }
+    }
+    // Be polite and stop the composer.
+    m_composer->end();
+    return;
+}
+
+//------------------------------------------------------------------------------
+//  End of bpcomposecompare.cpp
+//------------------------------------------------------------------------------
+
@@ -18,13 +18,13 @@
  */
 
 // Custom include files
+#include "appmessage.h"
 #include "apptranslator.h"
 #include "appwindow.h"
 #include "bpdocument.h"
 #include "composer.h"
 #include "docdevicesize.h"
 #include "docpagesize.h"
-#include "parser.h"
 #include "property.h"
 #include "xeqcalc.h"
 #include "xeqtree.h"
@@ -157,7 +157,6 @@ void BpDocument::composeDocumentation( void )
     yPos += titleHt;
 
     // Draw each discrete input variable on its own line.
-    QString token;
     m_composer->font( textFont );
     m_composer->pen( textPen );
     for ( lid = 1;
@@ -189,14 +188,12 @@ void BpDocument::composeDocumentation( void )
             Qt::AlignVCenter|Qt::AlignLeft,         // left justified
             qStr );                                 // display label text
         // Discrete variable codes
-        Parser parser( " \t,\"", "", "" );
-        parser.parse( varPtr->m_store );
+        int codes = varPtr->parseStore();
         for ( int i = 0;
-              i < parser.tokens();
+              i < codes;
               i++ )
         {
-            token = parser.token( i );
-            iid = varPtr->m_itemList->itemIdWithName( token );
+            iid = (int) varPtr->m_storeValue[i];
             // Get the next line's y position.
             if ( ( yPos += valueHt ) > eop )
             {
@@ -229,6 +226,107 @@ void BpDocument::composeDocumentation( void )
     return;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Composes a page of notes on how the last table run's results were
+ *  calculated, if there is anything to note.
+ *
+ *  Notes each output a surrogate run interpolated, with the largest error
+ *  found where it was checked (see EqTree::runSurrogate()).  The
+ *  interpolated values are marked with a leading "~" in the results tables.
+ *
+ *  Must be called after the results tables are composed and before
+ *  EqTree::runClean().
+ */
+
+void BpDocument::composeRunNotes( void )
+{
+    // Collect the notes
+    QString *note = new QString[ tableVars() + 1 ];
+    checkmem( __FILE__, __LINE__, note, "QString note", tableVars() + 1 );
+    int notes = 0;
+    int cells = m_eqTree->m_tableRows * m_eqTree->m_tableCols;
+    EqVar *varPtr;
+    int vid;
+    for ( vid = 0;
+          m_eqTree->m_tableApproxCells > 0 && vid < tableVars();
+          vid++ )
+    {
+        if ( ! m_eqTree->m_tableApprox[vid] )
+        {
+            continue;
+        }
+        varPtr = tableVar( vid );
+        translate( note[notes++], "BpDocument:RunNotes:Surrogate",
+            *(varPtr->m_label),
+            QString( "%1" ).arg( m_eqTree->m_tableApproxCells ),
+            QString( "%1" ).arg( cells ),
+            QString( "%1" ).arg( m_eqTree->m_tableApproxError[vid], 0, 'g', 3 ),
+            varPtr->displayUnits() );
+    }
+    if ( ! notes )
+    {
+        delete[] note;
+        return;
+    }
+    // WIN98 requires that we actually create a font here and use it for
+    // font metrics rather than using the widget's font.
+    QFont textFont( property()->string( "tableTextFontFamily" ),
+                    property()->integer( "tableTextFontSize" ) );
+    QPen textPen( property()->color( "tableTextFontColor" ) );
+    QFontMetrics textMetrics( textFont );
+
+    QFont titleFont( property()->string( "tableTitleFontFamily" ),
+                    property()->integer( "tableTitleFontSize" ) );
+    QPen titlePen( property()->color( "tableTitleFontColor" ) );
+    QFontMetrics titleMetrics( titleFont );
+
+    // Store pixel resolution into local variables.
+    double yppi = m_screenSize->m_yppi;
+    double textHt, titleHt;
+    textHt  = ( textMetrics.lineSpacing()  + m_screenSize->m_padHt ) / yppi;
+    titleHt = ( titleMetrics.lineSpacing() + m_screenSize->m_padHt ) / yppi;
+
+    QString pageTitle("");
+    translate( pageTitle, "BpDocument:RunNotes:Title" );
+
+    // Open the composer and start with a new page.
+    startNewPage( pageTitle, TocListOut );
+    double yPos = m_pageSize->m_marginTop + titleHt;
+
+    // Print the page header.
+    m_composer->font( titleFont );                  // use tableTitleFont
+    m_composer->pen( titlePen );                    // use tableTitleFontColor
+    m_composer->text(
+        m_pageSize->m_marginLeft, yPos,             // start at UL corner
+        m_pageSize->m_bodyWd, titleHt,              // width and height
+        Qt::AlignVCenter|Qt::AlignCenter,           // center alignment
+        pageTitle );                                // display title
+    yPos += 2 * titleHt;
+
+    // Write each note as a wrapped paragraph.
+    m_composer->font( textFont );                   // use tableTextFont
+    m_composer->pen( textPen );                     // use tableTextFontColor
+    double noteHt;
+    for ( int i = 0;
+          i < notes;
+          i++ )
+    {
+        noteHt = textHt + textMetrics.boundingRect( 0, 0,
+            m_screenSize->m_bodyWd, 10000,
+            Qt::WordBreak, note[i] ).height() / yppi;
+        m_composer->text(
+            m_pageSize->m_marginLeft, yPos,         // start at UL corner
+            m_pageSize->m_bodyWd, noteHt,           // width and height
+            Qt::AlignTop|Qt::AlignLeft|Qt::WordBreak,
+            note[i] );                              // display note text
+        yPos += noteHt;
+    }
+    // Be polite and stop the composer.
+    m_composer->end();
+    delete[] note;
+    return;
+}
+
 //------------------------------------------------------------------------------
 //  End of bpcomposedoc.cpp
 //------------------------------------------------------------------------------
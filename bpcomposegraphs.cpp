@@ -820,18 +820,21 @@ void BpDocument::composeLineGraph( int yid, EqVar *xVar, EqVar *yVar,
     // Initialize graph and variables
     Graph      g;
     GraphLine *line[graphMaxLines];
-    double     l_x[graphMaxSteps];
-    double     l_y[graphMaxSteps];
     int        curves = ( tableCols() < graphMaxLines )
                   ? ( tableCols() )
                   : ( graphMaxLines );
     int        points = tableRows();
     int        vStep  = tableCols() * tableVars();
+    // Transect runs may have many more rows than graphMaxSteps.
+    double    *l_x = new double[points];
+    checkmem( __FILE__, __LINE__, l_x, "double l_x", points );
+    double    *l_y = new double[points];
+    checkmem( __FILE__, __LINE__, l_y, "double l_y", points );
 
     // Loop for each zVar family curve value in this graph (or at least once!).
     // Note that zVar count is in tableCols(), e.g. each column stores a curve,
     // and zVar values are in tableCol( col ).
-    int col, vid;
+    int col, vid, n;
     for ( col = 0;
           col < curves;
           col++ )
@@ -841,12 +844,18 @@ void BpDocument::composeLineGraph( int yid, EqVar *xVar, EqVar *yVar,
         // Set up the y[point] array for this curve.
         // Note number of points is in tableRows() and
         // point x values are in tableRow( point ).
+        // Points without a result are left out of the curve.
+        n = 0;
         for ( int point = 0;
               point < points;
               point++ )
         {
-            l_x[point] = tableRow( point );
-            l_y[point] = tableVal( vid );
+            if ( tableVal( vid ) != EqTreeNoResult )
+            {
+                l_x[n] = tableRow( point );
+                l_y[n] = tableVal( vid );
+                n++;
+            }
             vid += vStep;
         }
         // If we're out of colors, start over.
@@ -856,8 +865,10 @@ void BpDocument::composeLineGraph( int yid, EqVar *xVar, EqVar *yVar,
         }
         // Create a graph line (with its own copy of the data).
         pen.setColor( color[colorId++] );
-        line[col] = g.addGraphLine( points, l_x, l_y, pen );
+        line[col] = g.addGraphLine( n, l_x, l_y, pen );
     } // Next z-variable curve.
+    delete[] l_x;
+    delete[] l_y;
 
     //--------------------------------------------------------------------------
     // 3: Add curve labels if there is more than 1 curve.
@@ -913,7 +924,12 @@ void BpDocument::composeLineGraph( int yid, EqVar *xVar, EqVar *yVar,
 
 #ifdef GRAPH_LABEL_METHOD_1
             // Determine an x-axis index for the label position.
-            idx = ( j0 + col * j1 ) % points;
+            if ( line[col]->m_points < 1 )
+            {
+                colorId++;
+                continue;
+            }
+            idx = ( j0 + col * j1 ) % line[col]->m_points;
             xLabel = line[col]->m_x[idx];
             yLabel = line[col]->m_y[idx];
 #endif
@@ -1062,6 +1078,11 @@ void BpDocument::graphYMinMax( int yid, double &yMin, double &yMax )
         {
             val = tableVal( vid );
             vid += vStep;
+            // Points without a result are not graphed.
+            if ( val == EqTreeNoResult )
+            {
+                continue;
+            }
             // If this is the first point, initialize yMin and yMax.
             if ( firstOne )
             {
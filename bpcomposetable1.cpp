@@ -25,6 +25,7 @@
 #include "composer.h"
 #include "docdevicesize.h"
 #include "docpagesize.h"
+#include "fixeddecimal.h"
 #include "property.h"
 #include "xeqcalc.h"
 #include "xeqtree.h"
@@ -44,6 +45,9 @@
 
 void BpDocument::composeTable1( void )
 {
+    // Calculate any outputs the last run skipped (see EqTree::setRunOutputs()).
+    m_eqTree->runOutputs();
+
     // START THE STANDARD PREAMBLE USED BY ALL TABLE COMPOSITION FUNCTIONS.
     // WIN98 requires that we actually create a font here and use it for
     // font metrics rather than using the widget's font.
@@ -102,8 +106,8 @@ void BpDocument::composeTable1( void )
         // Value width.
         if ( varPtr->isContinuous() )
         {
-            qStr.sprintf( "%1.*f",
-                varPtr->m_displayDecimals, tableVal(vid) );
+            fixedDecimal( qStr, tableVal(vid),
+                varPtr->m_displayDecimals );
             len = valueMetrics.width( qStr );
             if ( len > resultWdPixels )
             {
@@ -203,7 +207,7 @@ void BpDocument::composeTable1( void )
         // Continuous variable value and units.
         if ( varPtr->isContinuous() )
         {
-            qStr.sprintf( "%1.*f", varPtr->m_displayDecimals, tableVal(vid) );
+            fixedDecimal( qStr, tableVal(vid), varPtr->m_displayDecimals );
             m_composer->font( valueFont );          // use tableValueFont
             m_composer->pen( valuePen );            // use tableValueFontColor
             m_composer->text(
@@ -327,7 +331,7 @@ void BpDocument::composeTable1Html( void )
         // Continuous variable value and units
         if ( varPtr->isContinuous() )
         {
-            fld2.sprintf( "%1.*f", varPtr->m_displayDecimals, tableVal(vid) );
+            fixedDecimal( fld2, tableVal(vid), varPtr->m_displayDecimals );
             fld3 = varPtr->displayUnits().latin1();
         }
         // Discrete variable value name and index
@@ -409,7 +413,7 @@ void BpDocument::composeTable1Spreadsheet( void )
         // Continuous variable value and units
         if ( varPtr->isContinuous() )
         {
-            fld2.sprintf( "%1.*f", varPtr->m_displayDecimals, tableVal(vid) );
+            fixedDecimal( fld2, tableVal(vid), varPtr->m_displayDecimals );
             fld3 = varPtr->displayUnits().latin1();
         }
         // Discrete variable value name and index
@@ -26,6 +26,7 @@
 #include "composer.h"
 #include "docdevicesize.h"
 #include "docpagesize.h"
+#include "fixeddecimal.h"
 #include "property.h"
 #include "xeqcalc.h"
 #include "xeqtree.h"
@@ -51,6 +52,9 @@
 
 void BpDocument::composeTable2( EqVar *rowVar )
 {
+    // Calculate any outputs the last run skipped (see EqTree::setRunOutputs()).
+    m_eqTree->runOutputs();
+
     // START THE STANDARD PREAMBLE USED BY ALL TABLE COMPOSITION FUNCTIONS.
     // WIN98 requires that we actually create a font here and use it for
     // font metrics rather than using the widget's font.
@@ -158,13 +162,13 @@ void BpDocument::composeTable2( EqVar *rowVar )
 			// CDB DECIMALS MOD
 			if ( false )
 			{
-				qStr.sprintf( " %1.*fWM", rowVar->m_displayDecimals, tableRow( row / tableCols() ) );
+				fixedDecimal( qStr, tableRow( row / tableCols() ), rowVar->m_displayDecimals, " ", "WM" );
 			}
 			else
 			{
 				// Start with 6 decimals for this row value
 				int decimals = 6;
-				qStr.sprintf( " %1.*f", decimals, tableRow( row / tableCols() ) );
+				fixedDecimal( qStr, tableRow( row / tableCols() ), decimals, " " );
 				// Remove all trailing zeros
 				while ( qStr.endsWith( "0" ) )
 				{
@@ -203,8 +207,15 @@ void BpDocument::composeTable2( EqVar *rowVar )
                 // Continuous variables use the current display units format.
                 else if ( varPtr->isContinuous() )
                 {
-                    qStr.sprintf( " %1.*fWM",
-                        varPtr->m_displayDecimals+1, tableVal( out ) );
+                    if ( tableVal( out ) == EqTreeNoResult )
+                    {
+                        qStr = "WM";
+                    }
+                    else
+                    {
+                        fixedDecimal( qStr, tableVal( out ),
+                            varPtr->m_displayDecimals+1, " ", "WM" );
+                    }
                 }
                 // Determine if the column width needs to be enlarged.
                 len = (double) valueMetrics.width( qStr ) / xppi;
@@ -484,11 +495,11 @@ void BpDocument::composeTable2( EqVar *rowVar )
 					// CDB DECIMALS MOD
 					if ( false )
 					{
-						qStr.sprintf( "%1.*f", rowVar->m_displayDecimals, tableRow( row / tableCols() ) );
+						fixedDecimal( qStr, tableRow( row / tableCols() ), rowVar->m_displayDecimals );
 					}
 					else
 					{
-						qStr.sprintf( "%1.*f", m_rowDecimals, tableRow( row / tableCols() ) );
+						fixedDecimal( qStr, tableRow( row / tableCols() ), m_rowDecimals );
 					}
                 }
                 m_composer->font( textFont );       // use tableTextFont
@@ -517,8 +528,22 @@ void BpDocument::composeTable2( EqVar *rowVar )
                     // Continuous vars use the current display units format.
                     else if ( varPtr->isContinuous() )
                     {
-                        qStr.sprintf( " %1.*f",
-                            varPtr->m_displayDecimals, tableVal( out ) );
+                        // Cells without a result (such as arrival times
+                        // beyond where a transect fire stops) are blank
+                        if ( tableVal( out ) == EqTreeNoResult )
+                        {
+                            qStr = "";
+                        }
+                        else
+                        {
+                            fixedDecimal( qStr, tableVal( out ),
+                                varPtr->m_displayDecimals, " " );
+                        }
+                        // Mark values interpolated by a surrogate run
+                        if ( tableApprox( row, vid ) )
+                        {
+                            qStr = "~" + qStr.stripWhiteSpace();
+                        }
                     }
                     // Display the output value.
                     if ( hatch && doBlank )
@@ -562,6 +587,98 @@ void BpDocument::composeTable2( EqVar *rowVar )
     return;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Composes the prescription window page for a 1-way output table,
+ *  listing each run of consecutive rows whose results are all within the
+ *  prescription.
+ *
+ *  Used by the hourly scenario run to display the hourly Rx window(s).
+ *
+ *  \param rowVar  Pointer to the table's (continuous) row EqVar.
+ */
+
+void BpDocument::composeTable2RxWindow( EqVar *rowVar )
+{
+    QFont textFont( property()->string( "tableTextFontFamily" ),
+                    property()->integer( "tableTextFontSize" ) );
+    QPen textPen( property()->color( "tableTextFontColor" ) );
+    QFontMetrics textMetrics( textFont );
+
+    QFont titleFont( property()->string( "tableTitleFontFamily" ),
+                    property()->integer( "tableTitleFontSize" ) );
+    QPen titlePen( property()->color( "tableTitleFontColor" ) );
+    QFontMetrics titleMetrics( titleFont );
+
+    double yppi = m_screenSize->m_yppi;
+    double textHt, titleHt;
+    textHt  = ( textMetrics.lineSpacing()  + m_screenSize->m_padHt ) / yppi;
+    titleHt = ( titleMetrics.lineSpacing() + m_screenSize->m_padHt ) / yppi;
+
+    QString title(""), qStr("");
+    translate( title, "BpDocument:Table:RxWindows" );
+    startNewPage( title, TocListOut );
+    double yPos = m_pageSize->m_marginTop + titleHt;
+
+    // Display the table title::description.
+    m_composer->font( titleFont );
+    m_composer->pen( titlePen );
+    qStr = m_eqTree->m_eqCalc->docDescriptionStore().stripWhiteSpace();
+    m_composer->text(
+        m_pageSize->m_marginLeft,   yPos,
+        m_pageSize->m_bodyWd,       titleHt,
+        Qt::AlignVCenter|Qt::AlignHCenter,
+        qStr );
+    yPos += 2. * titleHt;
+
+    // Display one line per prescription window.
+    m_composer->font( textFont );
+    m_composer->pen( textPen );
+    int windows = 0;
+    int row = 0;
+    while ( row < tableRows() )
+    {
+        if ( ! tableInRx( row ) )
+        {
+            row++;
+            continue;
+        }
+        int from = row;
+        while ( row < tableRows() && tableInRx( row ) )
+        {
+            row++;
+        }
+        translate( qStr, "BpDocument:Table:RxWindow",
+            *(rowVar->m_label),
+            QString( "%1" ).arg( tableRow( from ), 0, 'f', m_rowDecimals ),
+            QString( "%1" ).arg( tableRow( row-1 ), 0, 'f', m_rowDecimals ),
+            QString( "%1" ).arg( row - from ) );
+        if ( ( yPos += textHt ) > m_pageSize->m_bodyEnd )
+        {
+            startNewPage( title, TocBlank );
+            yPos = m_pageSize->m_marginTop + textHt;
+        }
+        m_composer->text(
+            m_pageSize->m_marginLeft,   yPos,
+            m_pageSize->m_bodyWd,       textHt,
+            Qt::AlignVCenter|Qt::AlignLeft,
+            qStr );
+        windows++;
+    }
+    if ( ! windows )
+    {
+        translate( qStr, "BpDocument:Table:RxWindow:None",
+            *(rowVar->m_label) );
+        m_composer->text(
+            m_pageSize->m_marginLeft,   yPos + textHt,
+            m_pageSize->m_bodyWd,       textHt,
+            Qt::AlignVCenter|Qt::AlignLeft,
+            qStr );
+    }
+    // Be polite and stop the composer.
+    m_composer->end();
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Determines the minimum width (pixels) required to accomodate the
  *  variable's header and display units text.
@@ -690,11 +807,11 @@ void BpDocument::composeTable2Html( EqVar *rowVar )
 			// CDB DECIMALS MOD
 			if ( false )
 			{
-				qStr.sprintf( "%1.*f", rowVar->m_displayDecimals, tableRow( row ) );
+				fixedDecimal( qStr, tableRow( row ), rowVar->m_displayDecimals );
 			}
 			else
 			{
-				qStr.sprintf( "%1.*f", m_rowDecimals, tableRow( row ) );
+				fixedDecimal( qStr, tableRow( row ), m_rowDecimals );
 			}
         }
         fprintf( fptr,
@@ -720,8 +837,15 @@ void BpDocument::composeTable2Html( EqVar *rowVar )
             // Continuous vars use the current display units format.
             else if ( varPtr->isContinuous() )
             {
-                qStr.sprintf( " %1.*f",
-                    varPtr->m_displayDecimals, tableVal( out ) );
+                if ( tableVal( out ) == EqTreeNoResult )
+                {
+                    qStr = "";
+                }
+                else
+                {
+                    fixedDecimal( qStr, tableVal( out ),
+                        varPtr->m_displayDecimals, " " );
+                }
             }
             // Display the output value.
             if ( doRx )
@@ -856,11 +980,11 @@ void BpDocument::composeTable2Spreadsheet( EqVar *rowVar )
 			// CDB DECIMALS MOD
 			if ( false )
 			{
-				qStr.sprintf( "%1.*f", rowVar->m_displayDecimals, tableRow( row ) );
+				fixedDecimal( qStr, tableRow( row ), rowVar->m_displayDecimals );
 			}
 			else
 			{
-				qStr.sprintf( "%1.*f", m_rowDecimals, tableRow( row ) );
+				fixedDecimal( qStr, tableRow( row ), m_rowDecimals );
 			}
         }
         fprintf( fptr, "%s", qStr.latin1() );
@@ -884,8 +1008,15 @@ void BpDocument::composeTable2Spreadsheet( EqVar *rowVar )
             // Continuous vars use the current display units format.
             else if ( varPtr->isContinuous() )
             {
-                qStr.sprintf( " %1.*f",
-                    varPtr->m_displayDecimals, tableVal( out ) );
+                if ( tableVal( out ) == EqTreeNoResult )
+                {
+                    qStr = "";
+                }
+                else
+                {
+                    fixedDecimal( qStr, tableVal( out ),
+                        varPtr->m_displayDecimals, " " );
+                }
                 fprintf( fptr, "\t%s", qStr.latin1() );
             }
         }
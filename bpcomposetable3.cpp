@@ -26,6 +26,7 @@
 #include "composer.h"
 #include "docdevicesize.h"
 #include "docpagesize.h"
+#include "fixeddecimal.h"
 #include "property.h"
 #include "xeqcalc.h"
 #include "xeqtree.h"
@@ -50,6 +51,9 @@
 
 void BpDocument::composeTable3( EqVar *rowVar, EqVar *colVar )
 {
+    // Calculate any outputs the last run skipped (see EqTree::setRunOutputs()).
+    m_eqTree->runOutputs();
+
     for ( int vid = 0;
           vid < tableVars();
           vid++ )
@@ -173,13 +177,13 @@ void BpDocument::composeTable3( int vid, EqVar *rowVar, EqVar *colVar )
 			// CDB DECIMALS MOD
 			if ( false )
 			{
-				qStr.sprintf( "%1.*fMMM", rowVar->m_displayDecimals, tableRow( row ) );
+				fixedDecimal( qStr, tableRow( row ), rowVar->m_displayDecimals, 0, "MMM" );
 			}
 			else
 			{
 				// Start with 6 decimals for this row value
 				int decimals = 6;
-				qStr.sprintf( "%1.*f", decimals, tableRow( row ) );
+				fixedDecimal( qStr, tableRow( row ), decimals );
 				// Remove all trailing zeros
 				while ( qStr.endsWith( "0" ) )
 				{
@@ -217,8 +221,8 @@ void BpDocument::composeTable3( int vid, EqVar *rowVar, EqVar *colVar )
             }
             else if ( outVar->isContinuous() )
             {
-                qStr.sprintf( "%1.*fWM",
-                    outVar->m_displayDecimals, tableVal( out ) );
+                fixedDecimal( qStr, tableVal( out ),
+                    outVar->m_displayDecimals, 0, "WM" );
             }
             len = (double) textMetrics.width( qStr ) / xppi;
             if ( len > colWd )
@@ -245,13 +249,13 @@ void BpDocument::composeTable3( int vid, EqVar *rowVar, EqVar *colVar )
 			// CDB DECIMALS MOD
 			if ( false )
 			{
-				colText[col].sprintf( " %1.*f",	colVar->m_displayDecimals, tableCol( col ) );
+				fixedDecimal( colText[col], tableCol( col ), colVar->m_displayDecimals, " " );
 			}
 			else
 			{
 				// Start with 6 decimals for this row value
 				int decimals = 6;
-				colText[col].sprintf( " %1.*f", decimals, tableCol( col ) );
+				fixedDecimal( colText[col], tableCol( col ), decimals, " " );
 				// Remove all trailing zeros
 				while ( colText[col].endsWith( "0" ) )
 				{
@@ -274,7 +278,7 @@ void BpDocument::composeTable3( int vid, EqVar *rowVar, EqVar *colVar )
 	{
 		if ( colVar->isContinuous() )
 		{
-			colText[col].sprintf( " %1.*f", m_colDecimals, tableCol( col ) );
+			fixedDecimal( colText[col], tableCol( col ), m_colDecimals, " " );
 		}
 	}
     // Add padding between each column.
@@ -578,11 +582,11 @@ void BpDocument::composeTable3( int vid, EqVar *rowVar, EqVar *colVar )
 					// CDB DECIMALS MOD
 					if ( false )
 					{
-						qStr.sprintf( "%1.*f", rowVar->m_displayDecimals, tableRow( row ) );
+						fixedDecimal( qStr, tableRow( row ), rowVar->m_displayDecimals );
 					}
 					else
 					{
-						qStr.sprintf( "%1.*f", m_rowDecimals, tableRow( row ) );
+						fixedDecimal( qStr, tableRow( row ), m_rowDecimals );
 					}
                 }
                 m_composer->font( textFont );       // use tableTextFont
@@ -616,8 +620,13 @@ void BpDocument::composeTable3( int vid, EqVar *rowVar, EqVar *colVar )
                     // Continuous variables use the current display units format.
                     else if ( outVar->isContinuous() )
                     {
-                        qStr.sprintf( " %1.*f",
-                            outVar->m_displayDecimals, tableVal( out ) );
+                        fixedDecimal( qStr, tableVal( out ),
+                            outVar->m_displayDecimals, " " );
+                        // Mark values interpolated by a surrogate run
+                        if ( tableApprox( cell, vid ) )
+                        {
+                            qStr = "~" + qStr.stripWhiteSpace();
+                        }
                     }
                     // Display the output value.
                     if ( hatch && doBlank )
@@ -808,11 +817,11 @@ void BpDocument::composeTable3Html( FILE *fptr, int vid,
 			// CDB DECIMALS MOD
 			if ( false )
 			{
-				text.sprintf( " %1.*f",	colVar->m_displayDecimals, tableCol( col ) );
+				fixedDecimal( text, tableCol( col ), colVar->m_displayDecimals, " " );
 			}
 			else
 			{
-				text.sprintf( " %1.*f", m_colDecimals, tableCol( col ) );
+				fixedDecimal( text, tableCol( col ), m_colDecimals, " " );
 			}
         }
         fprintf( fptr,
@@ -839,11 +848,11 @@ void BpDocument::composeTable3Html( FILE *fptr, int vid,
 			// CDB DECIMALS MOD
 			if ( false )
 			{
-				text.sprintf( "%1.*f", rowVar->m_displayDecimals, tableRow( row ) );
+				fixedDecimal( text, tableRow( row ), rowVar->m_displayDecimals );
 			}
 			else
 			{
-				text.sprintf( "%1.*f", m_rowDecimals, tableRow( row ) );
+				fixedDecimal( text, tableRow( row ), m_rowDecimals );
 			}
         }
         fprintf( fptr,
@@ -864,8 +873,8 @@ void BpDocument::composeTable3Html( FILE *fptr, int vid,
             }
             else if ( outVar->isContinuous() )
             {
-                text.sprintf( "%1.*f",
-                    outVar->m_displayDecimals, tableVal( out ) );
+                fixedDecimal( text, tableVal( out ),
+                    outVar->m_displayDecimals );
             }
             // Display the output value.
             if ( doRx )
@@ -1027,11 +1036,11 @@ void BpDocument::composeTable3Spreadsheet( FILE *fptr, int vid,
 			// CDB DECIMALS MOD
 			if ( false )
 			{
-				qStr.sprintf( " %1.*f",	colVar->m_displayDecimals, tableCol( col ) );
+				fixedDecimal( qStr, tableCol( col ), colVar->m_displayDecimals, " " );
 			}
 			else
 			{
-				qStr.sprintf( " %1.*f", m_colDecimals, tableCol( col ) );
+				fixedDecimal( qStr, tableCol( col ), m_colDecimals, " " );
 			}
         }
         fprintf( fptr, "\t%s", qStr.latin1() );
@@ -1053,11 +1062,11 @@ void BpDocument::composeTable3Spreadsheet( FILE *fptr, int vid,
 			// CDB DECIMALS MOD
 			if ( false )
 			{
-				qStr.sprintf( "%1.*f", rowVar->m_displayDecimals, tableRow( row ) );
+				fixedDecimal( qStr, tableRow( row ), rowVar->m_displayDecimals );
 			}
 			else
 			{
-				qStr.sprintf( "%1.*f", m_rowDecimals, tableRow( row ) );
+				fixedDecimal( qStr, tableRow( row ), m_rowDecimals );
 			}
         }
         fprintf( fptr, "%s", qStr.latin1() );
@@ -1071,8 +1080,8 @@ void BpDocument::composeTable3Spreadsheet( FILE *fptr, int vid,
             }
             else if ( outVar->isContinuous() )
             {
-                qStr.sprintf( "%1.*f",
-                    outVar->m_displayDecimals, tableVal( out ) );
+                fixedDecimal( qStr, tableVal( out ),
+                    outVar->m_displayDecimals );
             }
             fprintf( fptr, "\t%s", qStr.latin1() );
             out += tableVars();
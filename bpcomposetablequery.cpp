@@ -0,0 +1,468 @@
+//------------------------------------------------------------------------------
+/*! \file bpcomposetablequery.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief BpDocument query results table composer.
+ *
+ *  Additional BehavePlusDocument method definitions are in:
+ *      - bpdocument.cpp
+ *      - bpcomposetable2.cpp
+ *      - bpcomposetable3.cpp
+ */
+
+// Custom include files
+#include "appmessage.h"
+#include "apptranslator.h"
+#include "bpdocument.h"
+#include "composer.h"
+#include "docdevicesize.h"
+#include "docpagesize.h"
+#include "fixeddecimal.h"
+#include "property.h"
+#include "resultindex.h"
+#include "resultquery.h"
+#include "xeqcalc.h"
+#include "xeqtree.h"
+#include "xeqvar.h"
+#include "xeqvaritem.h"
+
+// Qt include files
+#include <qdatetime.h>
+#include <qfontmetrics.h>
+#include <qpen.h>
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the number of decimals (up to 6) needed to display
+ *  a range variable value without trailing zeros.
+ *
+ *  \return Number of decimals.
+ */
+
+static int queryDecimals( double value )
+{
+    QString qStr("");
+    int decimals = 6;
+    fixedDecimal( qStr, value, decimals );
+    while ( decimals > 0 && qStr.endsWith( "0" ) )
+    {
+        qStr = qStr.left( qStr.length()-1 );
+        decimals--;
+    }
+    return( decimals );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Formats a table value for display.
+ *
+ *  \param varPtr   Pointer to the table EqVar.
+ *  \param value    Table value (display units, or item index for discrete
+ *                  variables).
+ *  \param decimals Number of decimals for continuous variables.
+ *  \param qStr     Reference to the string to hold the text.
+ */
+
+static void queryValueText( EqVar *varPtr, double value, int decimals,
+        QString &qStr )
+{
+    if ( varPtr->isDiscrete() )
+    {
+        qStr = varPtr->m_itemList->itemName( (int) value );
+    }
+    else
+    {
+        fixedDecimal( qStr, value, decimals );
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Composes the query results table for the current run's table.
+ *
+ *  The query is read from the "tableQuery" property (see ResultQuery).
+ *  Each selected cell is listed on its own line, in query order, with its
+ *  rank, its range variable values, and its output values.  The query's
+ *  order and comparison variables are listed first; any remaining outputs
+ *  that do not fit across the page are left to the full tables.
+ *
+ *  Called only by BpDocument::run() after the tables are composed, while
+ *  the run results are still available.
+ */
+
+void BpDocument::composeTableQuery( void )
+{
+    // Calculate any outputs the last run skipped (see EqTree::setRunOutputs()).
+    m_eqTree->runOutputs();
+
+    // Parse and run the query.
+    QString errMsg("");
+    ResultQuery query;
+    if ( ! query.parse( property()->string( "tableQuery" ), m_eqTree,
+            errMsg ) )
+    {
+        warn( errMsg );
+        return;
+    }
+    QTime timer;
+    timer.start();
+    ResultIndex *index = m_eqTree->m_tableIndex;
+    query.run( index );
+    log( QString( "BpDocument::composeTableQuery() selected %1 of %2 cells "
+        "in %3 ms (%4 indexes sorted) for \"%5\".\n" )
+        .arg( query.m_matches ).arg( index->cells() )
+        .arg( timer.elapsed() ).arg( index->m_sorts ).arg( query.m_text ) );
+
+    // Display fonts.
+    QFont textFont( property()->string( "tableTextFontFamily" ),
+                    property()->integer( "tableTextFontSize" ) );
+    QPen textPen( property()->color( "tableTextFontColor" ) );
+    QFontMetrics textMetrics( textFont );
+
+    QFont titleFont( property()->string( "tableTitleFontFamily" ),
+                    property()->integer( "tableTitleFontSize" ) );
+    QPen titlePen( property()->color( "tableTitleFontColor" ) );
+    QFontMetrics titleMetrics( titleFont );
+
+    QFont valueFont( property()->string( "tableValueFontFamily" ),
+                    property()->integer( "tableValueFontSize" ) );
+    QPen valuePen( property()->color( "tableValueFontColor" ) );
+    QFontMetrics valueMetrics( valueFont );
+
+    bool doRowBg = property()->boolean( "tableRowBackgroundColorActive" );
+    QBrush rowBrush( property()->color( "tableRowBackgroundColor" ),
+        Qt::SolidPattern );
+    bool doRx = property()->boolean( "tableShading" );
+
+    double yppi  = m_screenSize->m_yppi;
+    double xppi  = m_screenSize->m_xppi;
+    double padWd = m_pageSize->m_padWd;
+    double textHt, titleHt, valueHt, rowHt;
+    textHt  = ( textMetrics.lineSpacing()  + m_screenSize->m_padHt ) / yppi;
+    titleHt = ( titleMetrics.lineSpacing() + m_screenSize->m_padHt ) / yppi;
+    valueHt = ( valueMetrics.lineSpacing() + m_screenSize->m_padHt ) / yppi;
+    rowHt   = ( textHt > valueHt )
+              ? textHt
+              : valueHt;
+
+    // Columns are the rank, the range variables, and the outputs
+    // with the query's own variables first.
+    int vars = tableVars();
+    EqVar *rowVar = m_eqTree->m_rangeVar[0];
+    EqVar *colVar = ( tableCols() > 1 ) ? m_eqTree->m_rangeVar[1] : 0;
+    int *colVid = new int[ vars + 1 ];
+    checkmem( __FILE__, __LINE__, colVid, "int colVid", vars + 1 );
+    bool *used = new bool[ vars + 1 ];
+    checkmem( __FILE__, __LINE__, used, "bool used", vars + 1 );
+    int cols = 0;
+    int vid, term;
+    for ( vid = 0;
+          vid < vars;
+          vid++ )
+    {
+        used[vid] = tableVar( vid )->isDiagram();
+    }
+    if ( query.m_orderVid >= 0 && ! used[query.m_orderVid] )
+    {
+        used[query.m_orderVid] = true;
+        colVid[cols++] = query.m_orderVid;
+    }
+    for ( term = 0;
+          term < query.m_terms;
+          term++ )
+    {
+        if ( ! used[ query.m_termVid[term] ] )
+        {
+            used[ query.m_termVid[term] ] = true;
+            colVid[cols++] = query.m_termVid[term];
+        }
+    }
+    for ( vid = 0;
+          vid < vars;
+          vid++ )
+    {
+        if ( ! used[vid] )
+        {
+            colVid[cols++] = vid;
+        }
+    }
+    delete[] used;
+
+    // Determine the rank and range column widths and decimals.
+    QString qStr(""), text("");
+    int i, cell, row, col;
+    double len;
+    translate( text, "BpDocument:Table:Query:Rank" );
+    double rankWd = (double) textMetrics.width( text + "WM" ) / xppi;
+    len = (double) textMetrics.width(
+        QString( "%1WM" ).arg( query.m_cells ) ) / xppi;
+    rankWd = ( len > rankWd ) ? len : rankWd;
+    double rowWd = (double) headerWidth( rowVar, textMetrics ) / xppi;
+    double colWd = ( colVar )
+                 ? (double) headerWidth( colVar, textMetrics ) / xppi
+                 : 0.;
+    int rowDecimals = 0;
+    int colDecimals = 0;
+    int decimals;
+    for ( i = 0;
+          i < query.m_cells;
+          i++ )
+    {
+        cell = query.m_cell[i];
+        if ( rowVar->isContinuous()
+          && ( decimals = queryDecimals( tableRow( cell / tableCols() ) ) )
+            > rowDecimals )
+        {
+            rowDecimals = decimals;
+        }
+        if ( colVar && colVar->isContinuous()
+          && ( decimals = queryDecimals( tableCol( cell % tableCols() ) ) )
+            > colDecimals )
+        {
+            colDecimals = decimals;
+        }
+    }
+    for ( i = 0;
+          i < query.m_cells;
+          i++ )
+    {
+        cell = query.m_cell[i];
+        queryValueText( rowVar, tableRow( cell / tableCols() ), rowDecimals,
+            qStr );
+        len = (double) textMetrics.width( qStr + "WM" ) / xppi;
+        rowWd = ( len > rowWd ) ? len : rowWd;
+        if ( colVar )
+        {
+            queryValueText( colVar, tableCol( cell % tableCols() ),
+                colDecimals, qStr );
+            len = (double) textMetrics.width( qStr + "WM" ) / xppi;
+            colWd = ( len > colWd ) ? len : colWd;
+        }
+    }
+
+    // Determine the output column widths, and how many fit on the page.
+    double *outWd = new double[ cols + 1 ];
+    checkmem( __FILE__, __LINE__, outWd, "double outWd", cols + 1 );
+    double *outXPos = new double[ cols + 1 ];
+    checkmem( __FILE__, __LINE__, outXPos, "double outXPos", cols + 1 );
+    double xPos = m_pageSize->m_bodyLeft + rankWd + 2. * padWd
+                + rowWd + 2. * padWd;
+    double colXPos = 0.;
+    if ( colVar )
+    {
+        colXPos = xPos;
+        xPos += colWd + 2. * padWd;
+    }
+    int c;
+    EqVar *varPtr;
+    for ( c = 0;
+          c < cols;
+          c++ )
+    {
+        vid = colVid[c];
+        varPtr = tableVar( vid );
+        outWd[c] = padWd
+            + ( (double) headerWidth( varPtr, textMetrics ) / xppi );
+        for ( i = 0;
+              i < query.m_cells;
+              i++ )
+        {
+            queryValueText( varPtr,
+                tableVal( (Q_LLONG) query.m_cell[i] * vars + vid ),
+                varPtr->m_displayDecimals, qStr );
+            len = (double) valueMetrics.width( qStr + "WM" ) / xppi;
+            outWd[c] = ( len > outWd[c] ) ? len : outWd[c];
+        }
+        if ( xPos + outWd[c] + 1. > m_pageSize->m_bodyRight && c > 0 )
+        {
+            break;
+        }
+        outXPos[c] = xPos;
+        xPos += outWd[c] + 2. * padWd;
+    }
+    cols = c;
+    // Center the table on the page.
+    double s = 0.5 * ( m_pageSize->m_bodyRight - xPos );
+    s = ( s > 0. ) ? s : 0.;
+    double bgLeft = m_pageSize->m_bodyLeft + s - padWd;
+    double bgWd = xPos - m_pageSize->m_bodyLeft;
+
+    // Determine the number of pages required.
+    int rowsPerPage = (int)
+        ( ( m_pageSize->m_bodyHt - 4. * titleHt - 6. * textHt ) / rowHt );
+    rowsPerPage = ( rowsPerPage > 0 ) ? rowsPerPage : 1;
+    int pages = 1 + ( ( query.m_cells > 0 ) ? ( query.m_cells - 1 ) : 0 )
+              / rowsPerPage;
+
+    // Start drawing the table.
+    QString title("");
+    double yPos, x0, h0, h1;
+    int line;
+    for ( int page = 1;
+          page <= pages;
+          page++ )
+    {
+        translate( text, "BpDocument:Table:Query" );
+        translate( title, "BpDocument:Table:PageOf", text,
+            QString( "%1" ).arg( page ), QString( "%1" ).arg( pages ) );
+        startNewPage( title, ( page == 1 ) ? TocTable : TocBlank );
+        yPos = m_pageSize->m_marginTop + titleHt;
+
+        // Display the table title::description.
+        m_composer->font( titleFont );
+        m_composer->pen( titlePen );
+        qStr = m_eqTree->m_eqCalc->docDescriptionStore().stripWhiteSpace();
+        m_composer->text(
+            m_pageSize->m_marginLeft,   yPos,
+            m_pageSize->m_bodyWd,       titleHt,
+            Qt::AlignVCenter|Qt::AlignHCenter,
+            qStr );
+        yPos += titleHt;
+
+        // Display the query and the number of cells selected.
+        m_composer->font( textFont );
+        m_composer->pen( textPen );
+        translate( qStr, "BpDocument:Table:Query:Text", query.m_text );
+        m_composer->text(
+            m_pageSize->m_marginLeft,   yPos,
+            m_pageSize->m_bodyWd,       textHt,
+            Qt::AlignVCenter|Qt::AlignHCenter,
+            qStr );
+        yPos += textHt;
+        translate( qStr, "BpDocument:Table:Query:Matches",
+            QString( "%1" ).arg( query.m_matches ),
+            QString( "%1" ).arg( index->cells() ),
+            QString( "%1" ).arg( query.m_cells ) );
+        m_composer->text(
+            m_pageSize->m_marginLeft,   yPos,
+            m_pageSize->m_bodyWd,       textHt,
+            Qt::AlignVCenter|Qt::AlignHCenter,
+            qStr );
+        yPos += titleHt;
+
+        // Display the column header background.
+        if ( doRowBg )
+        {
+            m_composer->fill( bgLeft, yPos, bgWd + 2. * padWd, 3 * textHt,
+                rowBrush );
+        }
+        // Display the rank and range variable column headers.
+        translate( text, "BpDocument:Table:Query:Rank" );
+        m_composer->text(
+            m_pageSize->m_bodyLeft + s,     yPos + textHt,
+            rankWd,                         textHt,
+            Qt::AlignVCenter|Qt::AlignLeft,
+            text );
+        x0 = m_pageSize->m_bodyLeft + rankWd + 2. * padWd + s;
+        for ( line = 0;
+              line < 3;
+              line++ )
+        {
+            text = ( line == 0 ) ? *(rowVar->m_hdr0)
+                 : ( line == 1 ) ? *(rowVar->m_hdr1)
+                 : rowVar->displayUnits();
+            m_composer->text( x0, yPos + line * textHt, rowWd, textHt,
+                Qt::AlignVCenter|Qt::AlignLeft, text );
+            if ( colVar )
+            {
+                text = ( line == 0 ) ? *(colVar->m_hdr0)
+                     : ( line == 1 ) ? *(colVar->m_hdr1)
+                     : colVar->displayUnits();
+                m_composer->text( colXPos + s, yPos + line * textHt,
+                    colWd, textHt, Qt::AlignVCenter|Qt::AlignLeft, text );
+            }
+            for ( c = 0;
+                  c < cols;
+                  c++ )
+            {
+                varPtr = tableVar( colVid[c] );
+                text = ( line == 0 ) ? *(varPtr->m_hdr0)
+                     : ( line == 1 ) ? *(varPtr->m_hdr1)
+                     : varPtr->displayUnits();
+                m_composer->text( outXPos[c] + s, yPos + line * textHt,
+                    outWd[c], textHt, Qt::AlignVCenter|Qt::AlignRight, text );
+            }
+        }
+        // Display the header underline only if we are not coloring rows.
+        int skipLines = 3;
+        if ( ! doRowBg )
+        {
+            m_composer->line(
+                m_pageSize->m_bodyLeft + s,         yPos + 3.5 * textHt,
+                m_pageSize->m_bodyLeft + bgWd + s,  yPos + 3.5 * textHt );
+            skipLines = 4;
+        }
+        yPos += skipLines * textHt;
+
+        // Loop for each selected cell on this page.
+        bool doThisRowBg = false;
+        int from = ( page - 1 ) * rowsPerPage;
+        int thru = page * rowsPerPage;
+        thru = ( thru < query.m_cells ) ? thru : query.m_cells;
+        for ( i = from;
+              i < thru;
+              i++ )
+        {
+            cell = query.m_cell[i];
+            row = cell / tableCols();
+            col = cell % tableCols();
+            if ( doRowBg && doThisRowBg )
+            {
+                m_composer->fill( bgLeft, yPos, bgWd + 2. * padWd, textHt,
+                    rowBrush );
+            }
+            doThisRowBg = ! doThisRowBg;
+
+            // Rank and range variable values.
+            m_composer->font( textFont );
+            m_composer->pen( textPen );
+            m_composer->text(
+                m_pageSize->m_bodyLeft + s, yPos, rankWd, textHt,
+                Qt::AlignVCenter|Qt::AlignLeft, QString( "%1" ).arg( i+1 ) );
+            queryValueText( rowVar, tableRow( row ), rowDecimals, qStr );
+            m_composer->text( x0, yPos, rowWd, textHt,
+                Qt::AlignVCenter|Qt::AlignLeft, qStr );
+            if ( colVar )
+            {
+                queryValueText( colVar, tableCol( col ), colDecimals, qStr );
+                m_composer->text( colXPos + s, yPos, colWd, textHt,
+                    Qt::AlignVCenter|Qt::AlignLeft, qStr );
+            }
+            // Output values.
+            m_composer->font( valueFont );
+            m_composer->pen( valuePen );
+            for ( c = 0;
+                  c < cols;
+                  c++ )
+            {
+                varPtr = tableVar( colVid[c] );
+                queryValueText( varPtr,
+                    tableVal( (Q_LLONG) cell * vars + colVid[c] ),
+                    varPtr->m_displayDecimals, qStr );
+                m_composer->text( outXPos[c] + s, yPos, outWd[c], textHt,
+                    Qt::AlignVCenter|Qt::AlignRight, qStr );
+                // RX hatching
+                if ( doRx && ! tableInRx( cell ) )
+                {
+                    h0 = outXPos[c] + s - padWd;
+                    h1 = outXPos[c] + s + padWd + outWd[c];
+                    m_composer->line( h0, yPos, h1, ( yPos + textHt ) );
+                    m_composer->line( h0, ( yPos + textHt ), h1, yPos );
+                }
+            }
+            yPos += rowHt;
+        }
+    }
+    // Be polite and stop the composer.
+    m_composer->end();
+
+    // Clean up and return.
+    delete[] colVid;
+    delete[] outWd;
+    delete[] outXPos;
+    return;
+}
+
+//------------------------------------------------------------------------------
+//  End of bpcomposetablequery.cpp
+//------------------------------------------------------------------------------
+
@@ -887,8 +887,55 @@ void BpDocument::composeWorksheet( void )
         }
     }
 
+    //-------------------------------------------------
+    // 8 - Display the live preview area (if requested).
+    //-------------------------------------------------
+
+    if ( property()->boolean( "worksheetLivePreview" ) )
+    {
+        // One line for each output variable plus one for the status line.
+        int lines = 1;
+        for ( int rid = 0;
+              rid < rootCount();
+              rid++ )
+        {
+            if ( ! root(rid)->isText() )
+            {
+                lines++;
+            }
+        }
+        m_previewHt = 1 + (int) ( (double) ( lines * lineHtPixels ) / scale );
+        m_previewWd = m_screenSize->m_bodyWd - m_screenSize->m_tabWd;
+        m_previewWd = 1 + (int) ( (double) m_previewWd / scale );
+        // Do we need a new page?
+        yPos += 2 * lineHt;
+        if ( ( yPos + lines * lineHt ) > eop )
+        {
+            m_composer->font( textFont );
+            yPos = newWorksheetPage( lineHt );
+        }
+        // Display the group heading
+        m_composer->pen( titlePen );            // use worksheetTitleFontColor
+        m_composer->font( titleFont );          // use worksheetTitleFont
+        translate( text, "BpDocument:Worksheet:LivePreview" );
+        m_composer->text(
+            m_pageSize->m_marginLeft, yPos,     // start at UL corner
+            m_pageSize->m_bodyWd,  entryHt,     // width and height
+            Qt::AlignVCenter|Qt::AlignLeft,     // left justify
+            text );                             // draw header text
+        yPos += lineHt;
+
+        // Store the preview area position; the preview is screen-only.
+        m_previewPage = m_pages;
+        m_previewX    = (int) ( (double) nameX * xppi / scale );
+        m_previewY    = (int) ( yppi * yPos / scale );
+        yPos += lines * lineHt;
+    }
+    // Leaf values must be re-synchronized before the next preview.
+    m_previewSynced = false;
+
     //-----------------------------------
-    // 8 - Display the notes edit window.
+    // 9 - Display the notes edit window.
     //-----------------------------------
 
     if ( property()->boolean( "worksheetNotesActive" ) )
@@ -950,9 +997,9 @@ void BpDocument::composeWorksheet( void )
         yPos += ( scale * (double) notesMetrics.lineSpacing() / yppi );
     }
 
-    //------------
-    // 8 - Cleanup
-    //------------
+    //-------------
+    // 10 - Cleanup
+    //-------------
 
     // Be polite and stop the composer.
     m_composer->end();
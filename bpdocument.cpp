@@ -28,11 +28,13 @@
 #include "appearancedialog.h"
 #include "appfilesystem.h"
 #include "appmessage.h"
+#include "appsiunits.h"
 #include "apptranslator.h"
 #include "appwindow.h"
 #include "attachdialog.h"
 #include "bpdocentry.h"
 #include "bpdocument.h"
+#include "burngrid.h"
 #include "composer.h"
 #include "conflictdialog.h"
 #include "docdevicesize.h"
@@ -46,8 +48,14 @@
 #include "modulesdialog.h"
 #include "moisscenario.h"
 #include "property.h"
+#include "requestdialog.h"
+#include "resultcompare.h"
+#include "resultset.h"
+#include "resultstore.h"
 #include "rundialog.h"
 #include "rxvar.h"
+#include "transect.h"
+#include "wthrseries.h"
 #include "xeqapp.h"
 #include "xeqcalc.h"
 #include "xeqtree.h"
@@ -58,11 +66,14 @@
 #include <qcheckbox.h>
 #include <qcursor.h>
 #include <qbuttongroup.h>
+#include <qdatetime.h>
 #include <qfileinfo.h>
+#include <qlabel.h>
 #include <qlineedit.h>
 #include <qmultilineedit.h>
 #include <qpopupmenu.h>
 #include <qpushbutton.h>
+#include <qtimer.h>
 
 //------------------------------------------------------------------------------
 /*! \brief BpDocument class constructor.
@@ -83,6 +94,7 @@ BpDocument::BpDocument( QWorkspace *workspace, int docId, EqApp *eqApp,
     m_focusEntry(0),
     m_worksheetEdited(false),
     m_doValidation(true),
+    m_rescaling(false),
     m_entry(0),
     m_entryPage(0),
     m_entryX(0),
@@ -116,7 +128,17 @@ BpDocument::BpDocument( QWorkspace *workspace, int docId, EqApp *eqApp,
     m_notesX(0),
     m_notesY(0),
     m_notesWd(0),
-    m_notesHt(0)
+    m_notesHt(0),
+    m_preview(0),
+    m_previewPage(0),
+    m_previewX(0),
+    m_previewY(0),
+    m_previewWd(0),
+    m_previewHt(0),
+    m_previewSynced(false),
+    m_resultSetFile(""),
+    m_burnGrid(0),
+    m_burnGridFile("")
 {
     // Popup context menu must be created here because it is declared a
     // pure virtual method in Document.
@@ -228,6 +250,14 @@ BpDocument::BpDocument( QWorkspace *workspace, int docId, EqApp *eqApp,
     Q_CHECK_PTR( m_notes );
     m_notes->setTextFormat( Qt::PlainText );
 
+    // Create the live preview widget.
+    m_preview = new QLabel( this, "m_preview" );
+    Q_CHECK_PTR( m_preview );
+    m_preview->setTextFormat( Qt::RichText );
+    m_preview->setAlignment( Qt::AlignTop|Qt::AlignLeft );
+    m_preview->setPaletteBackgroundColor( bgColor );
+    m_preview->hide();
+
     // Uncomment the next line to generate a blank.bpw from program defaults.
     //saveAsWorksheetFile( "blank.bpw" );
     return;
@@ -262,6 +292,8 @@ BpDocument::~BpDocument( void )
     delete m_btn[0];        m_btn[0] = 0;
     delete m_guideBtnGrp;   m_guideBtnGrp = 0;
     delete m_notes;         m_notes = 0;
+    delete m_preview;       m_preview = 0;
+    delete m_burnGrid;      m_burnGrid = 0;
     return;
 }
 
@@ -285,6 +317,48 @@ void BpDocument::clear( bool /* showRunDialog */ )
     return;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Compares two result set files (see ResultSet and ResultCompare)
+ *  and displays the comparison in place of any current results.
+ *
+ *  Called only by AppWindow::slotDocumentCompareResults().
+ *
+ *  \param fileA Name of the first (reference) result set file.
+ *  \param fileB Name of the second result set file.
+ */
+
+void BpDocument::compareResults( const QString &fileA, const QString &fileB )
+{
+    // Store the notes before comparing.
+    storeNotes();
+
+    // Open both result sets and compare them.
+    QString errMsg("");
+    ResultSet a, b;
+    ResultCompare cmp;
+    QTime timer;
+    timer.start();
+    if ( ! a.open( fileA, errMsg )
+      || ! b.open( fileB, errMsg )
+      || ! cmp.compare( &a, &b, errMsg ) )
+    {
+        error( errMsg );
+        return;
+    }
+    log( QString( "BpDocument::compareResults() compared %1 values of "
+        "%2 outputs in %3 ms and found %4 differences.\n" )
+        .arg( cmp.m_rows * cmp.m_cols * cmp.m_vars ).arg( cmp.m_vars )
+        .arg( timer.elapsed() ).arg( cmp.m_totalDiffs ) );
+
+    // Replace any current results with the comparison.
+    regenerateWorksheet();
+    composeCompare( &cmp, &a, &b );
+    // Show the first comparison page.
+    showPage( m_worksheetPages + 1 );
+    setFocus();
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Convenience function that reconfigures and redraws the worksheet.
  *
@@ -1047,6 +1121,104 @@ int  BpDocument::leafCount( void ) const
     return( m_eqTree->m_leafCount );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Updates the worksheet live preview area with the current results.
+ *
+ *  The live preview is available only when every unmasked input has a single
+ *  value.  Each committed entry field edit has already stored its value in
+ *  the leaf EqVar and propagated the dirty flags up the EqTree (see
+ *  validateWorksheetEntry()), so EqTree::calculateVariable() only
+ *  recalculates the outputs that depend upon the edited input.  No trace or
+ *  result files are written and no pages are composed; BpDocument::run() is
+ *  still needed for the printable results.
+ *
+ *  Called by validateWorksheetEntry() and showPage().
+ */
+
+void BpDocument::livePreview( void )
+{
+    if ( ! m_preview
+      || ! property()->boolean( "worksheetLivePreview" ) )
+    {
+        return;
+    }
+    QTime timer;
+    timer.start();
+    QString text("");
+    EqVar *varPtr;
+    int lid, tokens, position, length;
+
+    // After the worksheet is (re)composed, the leaf values may have been
+    // left at the last table row or column, so restore them all once.
+    if ( ! m_previewSynced )
+    {
+        for ( lid = 0;
+              lid < leafCount();
+              lid++ )
+        {
+            if ( ! leaf(lid)->isValidStore( &tokens, &position, &length ) )
+            {
+                translate( text, "BpDocument:LivePreview:Incomplete" );
+                m_preview->setText( text );
+                return;
+            }
+        }
+        m_eqTree->m_eqCalc->maskInputs();
+        m_previewSynced = true;
+    }
+    // Every unmasked input must have exactly one value.
+    for ( lid = 0;
+          lid < leafCount();
+          lid++ )
+    {
+        varPtr = leaf(lid);
+        if ( ! varPtr->m_isMasked
+          && ( varPtr->isDiscrete() || varPtr->isContinuous() )
+          && varPtr->m_tokens != 1 )
+        {
+            translate( text, "BpDocument:LivePreview:Incomplete" );
+            m_preview->setText( text );
+            return;
+        }
+    }
+    // Recalculate only the dirty outputs and display them.
+    QString html( "<table cellspacing=0 cellpadding=1>" );
+    QString value(""), units("");
+    int outputs = 0;
+    for ( int rid = 0;
+          rid < rootCount();
+          rid++ )
+    {
+        varPtr = root(rid);
+        if ( varPtr->isText() )
+        {
+            continue;
+        }
+        m_eqTree->calculateVariable( varPtr, 0 );
+        if ( varPtr->isContinuous() )
+        {
+            value = QString( "%1" ).arg( varPtr->m_displayValue, 0, 'f',
+                varPtr->m_displayDecimals );
+            units = varPtr->displayUnits();
+        }
+        else
+        {
+            value = varPtr->activeItemName();
+            units = "";
+        }
+        html += QString( "<tr><td>%1</td><td align=right><b>%2</b></td>"
+            "<td>&nbsp;%3</td></tr>" )
+            .arg( *(varPtr->m_label) ).arg( value ).arg( units );
+        outputs++;
+    }
+    html += "</table>";
+    translate( text, "BpDocument:LivePreview:Updated",
+        QString( "%1" ).arg( outputs ),
+        QString( "%1" ).arg( timer.elapsed() ) );
+    m_preview->setText( html + text );
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Loads the worksheetNotesText property into the notes widget.
  *
@@ -1378,11 +1550,20 @@ void BpDocument::rescale( int points )
     m_fixedFont.setPointSize( m_fontScaleSize );
     m_propFont.setPointSize( m_fontScaleSize );
 
-    // Rescale the backing QPixmap in the scrollView.
+    // Stretch the backing QPixmap in the scrollView for immediate feedback.
     m_scrollView->rescale();
 
-    // Re-display the current page in the new scale.
+    // Resize and move only the widgets on the current page, in one pass
+    // with a single viewport update at the end.
+    m_rescaling = true;
+    m_scrollView->viewport()->setUpdatesEnabled( false );
     showPage( m_page );
+    m_scrollView->viewport()->setUpdatesEnabled( true );
+    m_scrollView->viewport()->update();
+    m_rescaling = false;
+
+    // Repaint the page at the new scale once the user stops rescaling.
+    m_renderTimer->start( DocumentRenderDelay, true );
     m_doValidation = true;
     return;
 }
@@ -1478,6 +1659,7 @@ void BpDocument::resizeWorksheet( void )
             m_guidePixmap.height() );
         m_guideBtn.at(id)->hide();
     }
+    m_shownEntries.clear();
     // Start validation up
     m_doValidation = true;
     return;
@@ -1534,8 +1716,22 @@ void BpDocument::run( bool showRunDialog )
     storeNotes();
     // Run.
     int page = m_page;
-    QString resultFile = appFileSystem()->tempFilePath( 1 );
-    QString traceFile = appFileSystem()->tempFilePath( 2 );
+    // The trace and result files are only read by the diagrams; if they are
+    // not needed and would be deleted anyway, don't write them at all
+    // (which also lets the EqTree reuse results from the previous run).
+    bool logFiles = ! property()->boolean( "appDeleteRunLogFile" );
+    for ( int rid = 0;
+          rid < rootCount() && ! logFiles;
+          rid++ )
+    {
+        logFiles = root( rid )->isDiagram();
+    }
+    QString resultFile(""), traceFile("");
+    if ( logFiles )
+    {
+        resultFile = appFileSystem()->tempFilePath( 1 );
+        traceFile = appFileSystem()->tempFilePath( 2 );
+    }
     if ( runWorksheet( traceFile, resultFile, showRunDialog ) )
     {
         page = m_worksheetPages + 1;
@@ -1553,6 +1749,34 @@ void BpDocument::run( bool showRunDialog )
     return;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Tells the EqTree that the next (graph) run needs only the
+ *  continuous output variables.
+ *
+ *  Graphs plot only continuous outputs, so discrete and diagram outputs
+ *  (which may pull in long producer chains) are skipped by the graph runs.
+ */
+
+void BpDocument::runGraphOutputs( void )
+{
+    EqVar **vars = new EqVar *[ m_eqTree->m_rootCount + 1 ];
+    checkmem( __FILE__, __LINE__, vars, "EqVar *vars",
+        m_eqTree->m_rootCount + 1 );
+    int count = 0;
+    for ( int rid = 0;
+          rid < m_eqTree->m_rootCount;
+          rid++ )
+    {
+        if ( m_eqTree->m_root[rid]->isContinuous() )
+        {
+            vars[count++] = m_eqTree->m_root[rid];
+        }
+    }
+    m_eqTree->setRunOutputs( vars, count );
+    delete[] vars;
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Computes and displays results for the current worksheet.
  *
@@ -1591,8 +1815,11 @@ bool BpDocument::runWorksheet( const QString &traceFile,
         // Store the run time and reset the worksheet.
         setRunTime();
         regenerateWorksheet();
+        saveResultSet();
+        saveBurnGrid();
         // Compose the results table.
         composeTable1();
+        composeRunNotes();
         composeDiagrams();
         if ( property()->boolean( "worksheetShowUsedChoices" ) )
         {
@@ -1644,6 +1871,8 @@ bool BpDocument::runWorksheet( const QString &traceFile,
         // Store the run time and redisplay the worksheet.
         setRunTime();
         regenerateWorksheet();
+        saveResultSet();
+        saveBurnGrid();
         // Ok, the worksheet was redrawn
         drawWorksheet = false;
 
@@ -1657,6 +1886,13 @@ bool BpDocument::runWorksheet( const QString &traceFile,
         {
             composeTable3( m_eqTree->m_rangeVar[0], m_eqTree->m_rangeVar[1] );
         }
+        // The query table lists the cells selected by the user's query.
+        if ( property()->boolean( "tableQueryActive" ) )
+        {
+            composeTableQuery();
+        }
+        // Note how the tables were calculated.
+        composeRunNotes();
 
         // Summary and weighted tables are drawn next.
         // m_eqTree->m_eqCalc->weightedSpread( this, true, true );
@@ -1690,6 +1926,7 @@ bool BpDocument::runWorksheet( const QString &traceFile,
         if ( m_eqTree->m_rangeCase == 2 )
         {
             // Calculate the graph values.
+            runGraphOutputs();
             if ( m_eqTree->runTable( "", "", true ) )
             {
                 // Compose the worksheet if it hasn't already been composed.
@@ -1734,6 +1971,7 @@ bool BpDocument::runWorksheet( const QString &traceFile,
                 m_eqTree->rangeCase();
             }
             // Calculate the graph values.
+            runGraphOutputs();
             if ( m_eqTree->runTable( "", "", true ) )
             {
                 // Compose the worksheet if it hasn't already been composed.
@@ -1773,6 +2011,7 @@ bool BpDocument::runWorksheet( const QString &traceFile,
                 m_eqTree->rangeCase();
             }
             // Calculate the graph values.
+            runGraphOutputs();
             if ( m_eqTree->runTable( "", "", true ) )
             {
                 // Compose the worksheet if it hasn't already been composed.
@@ -1799,6 +2038,465 @@ bool BpDocument::runWorksheet( const QString &traceFile,
     return( true );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Runs BehavePlus once for every hour of a weather series using the
+ *  current (single-valued) worksheet inputs, and displays the hourly
+ *  results table, the hourly prescription window, and the hourly graphs.
+ *
+ *  Called only by AppWindow::slotDocumentRunHourly().
+ *
+ *  \param wxFile Name of the weather series file (see WthrSeries).
+ */
+
+void BpDocument::runHourly( const QString &wxFile )
+{
+    // Store the notes before running.
+    storeNotes();
+    int page = m_page;
+    QString resultFile = appFileSystem()->tempFilePath( 1 );
+    QString traceFile = appFileSystem()->tempFilePath( 2 );
+
+    // Read the weather series
+    QString errMsg("");
+    WthrSeries *wx = new WthrSeries();
+    checkmem( __FILE__, __LINE__, wx, "WthrSeries wx", 1 );
+    if ( ! wx->read( wxFile, errMsg ) )
+    {
+        error( errMsg );
+        delete wx;
+        return;
+    }
+    // Validate worksheet entries, store them in the EqTree, and run
+    if ( validateWorksheet()
+      && m_eqTree->runHourly( wx, traceFile, resultFile ) )
+    {
+        // Store the run time and reset the worksheet.
+        setRunTime();
+        regenerateWorksheet();
+        EqVar *hourVar = m_eqTree->m_rangeVar[0];
+        if ( property()->boolean( "tableActive" ) )
+        {
+            composeTable2( hourVar );
+            if ( property()->boolean( "tableShading" ) )
+            {
+                composeTable2RxWindow( hourVar );
+            }
+        }
+        if ( property()->boolean( "graphActive" )
+          && tableRows() > 1 )
+        {
+            composeGraphs( true, true );
+        }
+        if ( property()->boolean( "worksheetShowUsedChoices" ) )
+        {
+            composeDocumentation();
+        }
+        m_eqTree->runClean();
+        page = m_worksheetPages + 1;
+    }
+    delete wx;
+    // Show the first result page.
+    showPage( page );
+    setFocus();
+    // Remove the log files and return.
+    if ( property()->boolean( "appDeleteRunLogFile" ) )
+    {
+        m_eqTree->resultFileRemove();
+        m_eqTree->traceFileRemove();
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Runs BehavePlus for every segment of a fire transect using the
+ *  current (single-valued) worksheet inputs as modified by each segment,
+ *  and displays the segment results table (including the head fire arrival
+ *  time) and the transect graphs.
+ *
+ *  Called only by AppWindow::slotDocumentRunTransect().
+ *
+ *  \param transectFile Name of the transect file (see Transect).
+ */
+
+void BpDocument::runTransect( const QString &transectFile )
+{
+    // Store the notes before running.
+    storeNotes();
+    int page = m_page;
+
+    // Read the transect
+    QString errMsg("");
+    Transect *tr = new Transect();
+    checkmem( __FILE__, __LINE__, tr, "Transect tr", 1 );
+    if ( ! tr->read( transectFile, errMsg ) )
+    {
+        error( errMsg );
+        delete tr;
+        return;
+    }
+    // Validate worksheet entries, store them in the EqTree, and run
+    if ( validateWorksheet()
+      && m_eqTree->runTransect( tr ) )
+    {
+        // Store the run time and reset the worksheet.
+        setRunTime();
+        regenerateWorksheet();
+        EqVar *distVar = m_eqTree->m_rangeVar[0];
+        if ( property()->boolean( "tableActive" ) )
+        {
+            composeTable2( distVar );
+            if ( property()->boolean( "tableShading" ) )
+            {
+                composeTable2RxWindow( distVar );
+            }
+        }
+        if ( property()->boolean( "graphActive" )
+          && tableRows() > 1 )
+        {
+            composeGraphs( true, true );
+        }
+        if ( property()->boolean( "worksheetShowUsedChoices" ) )
+        {
+            composeDocumentation();
+        }
+        m_eqTree->runClean();
+        page = m_worksheetPages + 1;
+    }
+    delete tr;
+    // Show the first result page.
+    showPage( page );
+    setFocus();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Runs the current worksheet just as run() does, and also writes
+ *  burn probability and mean arrival time grids from the fire shapes of
+ *  every table cell.
+ *
+ *  The user enters the map coordinates of the ignition point, the grid
+ *  cell size, the number of grid columns and rows, and the map units
+ *  (m or ft) in a RequestDialog.  The grid is centered on the ignition
+ *  point and may have at most BurnGridMaxTotal cells.  The table run then
+ *  fills the grid in saveBurnGrid().
+ *
+ *  Called only by AppWindow::slotDocumentBurnGrid().
+ *
+ *  \param gridFile Name of the burn probability grid file to write.
+ */
+
+void BpDocument::runBurnGrid( const QString &gridFile )
+{
+    // Request the ignition point and grid layout.
+    QString text(""), prompt("");
+    translate( prompt, "BpDocument:BurnGrid:Prompt",
+        QString( "%1" ).arg( BurnGridMaxCells ),
+        QString( "%1" ).arg( BurnGridMaxTotal ) );
+    RequestDialog request( prompt, "0 0 10 500 500 m",
+        "vSurfaceFireShapeDiagram.html", this, "burnGridRequest" );
+    if ( request.exec() != QDialog::Accepted )
+    {
+        return;
+    }
+    QString reply("");
+    request.text( reply );
+    QStringList tokens = QStringList::split( " ", reply.simplifyWhiteSpace() );
+    bool xOk = false;
+    bool yOk = false;
+    bool sizeOk = false;
+    bool colsOk = false;
+    bool rowsOk = false;
+    double x = 0.;
+    double y = 0.;
+    double cellSize = 0.;
+    int cols = 0;
+    int rows = 0;
+    if ( tokens.count() == 6 )
+    {
+        x = tokens[0].toDouble( &xOk );
+        y = tokens[1].toDouble( &yOk );
+        cellSize = tokens[2].toDouble( &sizeOk );
+        cols = tokens[3].toInt( &colsOk );
+        rows = tokens[4].toInt( &rowsOk );
+    }
+    if ( ! xOk || ! yOk || ! sizeOk || ! colsOk || ! rowsOk
+      || cellSize <= 0.
+      || cols < 1 || cols > BurnGridMaxCells
+      || rows < 1 || rows > BurnGridMaxCells
+      || rows * cols > BurnGridMaxTotal
+      || ( tokens[5] != "m" && tokens[5] != "ft" ) )
+    {
+        translate( text, "BpDocument:BurnGrid:BadRequest", reply,
+            QString( "%1" ).arg( BurnGridMaxCells ),
+            QString( "%1" ).arg( BurnGridMaxTotal ) );
+        warn( text );
+        return;
+    }
+    // Set up the grid and run.
+    delete m_burnGrid;
+    m_burnGrid = new BurnGrid();
+    checkmem( __FILE__, __LINE__, m_burnGrid, "BurnGrid m_burnGrid", 1 );
+    m_burnGrid->init( x, y, cellSize, rows, cols );
+    m_burnGrid->m_units = tokens[5];
+    m_burnGridFile = gridFile;
+    run( true );
+    // If the run made no table, nothing was written.
+    if ( m_burnGrid )
+    {
+        translate( text, "BpDocument:BurnGrid:NoTable", m_burnGridFile );
+        warn( text );
+        delete m_burnGrid;
+        m_burnGrid = 0;
+        m_burnGridFile = "";
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Runs the current worksheet just as run() does, and also writes
+ *  the table results to a result set file for later comparison by
+ *  compareResults().
+ *
+ *  Called only by AppWindow::slotDocumentRunSave().
+ *
+ *  \param resultSetFile Name of the result set file to write.
+ */
+
+void BpDocument::runSaveResults( const QString &resultSetFile )
+{
+    m_resultSetFile = resultSetFile;
+    run( true );
+    // If the run made no table, nothing was written.
+    if ( ! m_resultSetFile.isEmpty() )
+    {
+        QString text("");
+        translate( text, "BpDocument:SaveResults:NoTable", m_resultSetFile );
+        warn( text );
+        m_resultSetFile = "";
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Fills the requested burn grid with the fire shape of every table
+ *  cell and writes the burn probability and mean arrival time grid files.
+ *
+ *  Each cell's shape comes from its forward spread distance (or backing
+ *  spread distance), fire length, maximum width, and direction of maximum
+ *  spread from north, all of which must be table outputs or no grid is
+ *  written.  The direction from north is only calculated when the Surface
+ *  Module is linked and directions are reckoned from north; otherwise the
+ *  worksheet has no aspect to orient the shapes by, so no grid is written
+ *  rather than pointing every fire toward grid north.  If
+ *  the elapsed time is an input, the mean arrival time grid is written next
+ *  to the probability grid with "_arrival" appended to its base name.
+ *
+ *  Called only by runWorksheet() right after the table run, while the
+ *  results are still available.
+ */
+
+void BpDocument::saveBurnGrid( void )
+{
+    if ( ! m_burnGrid )
+    {
+        return;
+    }
+    BurnGrid *grid = m_burnGrid;
+    m_burnGrid = 0;
+    QString gridFile = m_burnGridFile;
+    m_burnGridFile = "";
+
+    // Locate the fire shape outputs in the table.
+    EqCalc *eqCalc = m_eqTree->m_eqCalc;
+    const int Vars = 5;
+    EqVar *var[Vars] =
+    {
+        eqCalc->vSurfaceFireLengDist,
+        eqCalc->vSurfaceFireWidthDist,
+        eqCalc->vSurfaceFireDistAtHead,
+        eqCalc->vSurfaceFireDistAtBack,
+        eqCalc->vSurfaceFireMaxDirFromNorth
+    };
+    int    vid[Vars];
+    double factor[Vars];
+    int id, tid;
+    for ( id = 0;
+          id < Vars;
+          id++ )
+    {
+        vid[id] = -1;
+        factor[id] = 1.;
+        for ( tid = 0;
+              tid < m_eqTree->m_tableVars;
+              tid++ )
+        {
+            if ( m_eqTree->m_tableVar[tid] == var[id] )
+            {
+                vid[id] = tid;
+                // Table values are in display units
+                if ( id < 4 )
+                {
+                    appSiUnits()->convert( 1., var[id]->m_displayUnits.latin1(),
+                        grid->m_units.latin1(), &factor[id] );
+                }
+                break;
+            }
+        }
+    }
+    QString text("");
+    if ( vid[0] < 0 || vid[1] < 0 || ( vid[2] < 0 && vid[3] < 0 ) )
+    {
+        translate( text, "BpDocument:BurnGrid:NoOutputs",
+            *(var[0]->m_label), *(var[1]->m_label),
+            *(var[2]->m_label), *(var[3]->m_label) );
+        warn( text );
+        delete grid;
+        return;
+    }
+    bool dirNorth = property()->boolean( "surfaceModuleActive" )
+                 && property()->boolean( "surfaceConfDegreesWrtNorth" );
+    if ( ! dirNorth )
+    {
+        // Upslope relative directions can't be placed on a map.
+        translate( text, "BpDocument:BurnGrid:NotFromNorth",
+            *(var[4]->m_label) );
+        warn( text );
+        delete grid;
+        return;
+    }
+    if ( vid[4] < 0 )
+    {
+        // Shapes drawn toward grid north would silently misplace the burn.
+        translate( text, "BpDocument:BurnGrid:NoDirection",
+            *(var[4]->m_label) );
+        warn( text );
+        delete grid;
+        return;
+    }
+    // The elapsed time may be a single input or a table range variable.
+    EqVar *timeVar = eqCalc->vSurfaceFireElapsedTime;
+    double timeFactor = 1.;
+    if ( timeVar->m_isUserInput )
+    {
+        appSiUnits()->convert( 1., timeVar->m_displayUnits.latin1(),
+            timeVar->m_nativeUnits.latin1(), &timeFactor );
+    }
+    EqVar *rowVar = ( m_eqTree->m_rangeVars > 0 ) ? m_eqTree->m_rangeVar[0] : 0;
+    EqVar *colVar = ( m_eqTree->m_rangeVars > 1 ) ? m_eqTree->m_rangeVar[1] : 0;
+
+    // Add the fire shape of every table cell.
+    QApplication::setOverrideCursor( Qt::waitCursor );
+    QTime timer;
+    timer.start();
+    double leng, width, head, back, dir, elapsed;
+    int row, col;
+    for ( row = 0;
+          row < m_eqTree->m_tableRows;
+          row++ )
+    {
+        for ( col = 0;
+              col < m_eqTree->m_tableCols;
+              col++ )
+        {
+            leng  = factor[0] * m_eqTree->getResult( row, col, vid[0] );
+            width = factor[1] * m_eqTree->getResult( row, col, vid[1] );
+            if ( vid[2] >= 0 )
+            {
+                head = factor[2] * m_eqTree->getResult( row, col, vid[2] );
+                back = leng - head;
+            }
+            else
+            {
+                back = factor[3] * m_eqTree->getResult( row, col, vid[3] );
+                head = leng - back;
+            }
+            dir = m_eqTree->getResult( row, col, vid[4] );
+            elapsed = 0.;
+            if ( timeVar->m_isUserInput )
+            {
+                if ( timeVar == rowVar )
+                {
+                    elapsed = m_eqTree->m_tableRow[row];
+                }
+                else if ( timeVar == colVar )
+                {
+                    elapsed = m_eqTree->m_tableCol[col];
+                }
+                else
+                {
+                    elapsed = timeVar->m_displayValue;
+                }
+                elapsed *= timeFactor;
+            }
+            grid->addEllipse( head, ( back > 0. ) ? back : 0., width, dir,
+                elapsed );
+        }
+    }
+    grid->finish();
+    int ms = timer.elapsed();
+    QString timeFile("");
+    if ( grid->m_timed > 0 && grid->m_timed == grid->m_shapes )
+    {
+        timeFile = ( gridFile.right( 4 ) == ".asc" )
+                 ? gridFile.left( gridFile.length() - 4 )
+                 : gridFile;
+        timeFile += "_arrival.asc";
+    }
+    QString errMsg("");
+    bool ok = grid->write( gridFile, timeFile, errMsg );
+    QApplication::restoreOverrideCursor();
+    log( QString( "Burn grid \"%1\": %2 fire shapes on %3 rows x %4 cols "
+        "rasterized in %5 ms.\n" )
+        .arg( gridFile )
+        .arg( grid->m_shapes )
+        .arg( grid->m_rows )
+        .arg( grid->m_cols )
+        .arg( ms ) );
+    if ( ! ok )
+    {
+        error( errMsg );
+        delete grid;
+        return;
+    }
+    if ( timeFile.isEmpty() )
+    {
+        translate( text, "BpDocument:BurnGrid:Written",
+            QString( "%1" ).arg( grid->m_shapes ), gridFile );
+    }
+    else
+    {
+        translate( text, "BpDocument:BurnGrid:WrittenArrival",
+            QString( "%1" ).arg( grid->m_shapes ), gridFile, timeFile,
+            timeVar->m_nativeUnits );
+    }
+    info( text );
+    delete grid;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Writes the current run's table results to the requested result
+ *  set file, if any.
+ *
+ *  Called only by runWorksheet() right after the table run, while the
+ *  results are still available.
+ */
+
+void BpDocument::saveResultSet( void )
+{
+    if ( m_resultSetFile.isEmpty() )
+    {
+        return;
+    }
+    QString errMsg("");
+    if ( ! ResultSet::write( m_eqTree, m_resultSetFile, errMsg ) )
+    {
+        error( errMsg );
+    }
+    m_resultSetFile = "";
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Sets the document's focus to the correct entry field.
  */
@@ -1847,7 +2545,12 @@ void BpDocument::setPageTabs( void )
  *  overlaid on the scrollview.
  *
  *  Virtual method re-implemented to hide or show the entry fields and guide
- *  buttons before chaining to Document::showPage().
+ *  buttons before chaining to Document::showPage().  Only the widgets shown
+ *  by the previous call (m_shownEntries and m_shownRx) are hidden, so the
+ *  cost of a page flip depends on the page and not the whole worksheet.
+ *  When called by rescale() (m_rescaling is set) the current page's widgets
+ *  are only resized and moved, and the page itself is left for
+ *  Document::renderPage() to repaint.
  *
  *  Usually called by the ApplicationWindow navigation slots.
  *
@@ -1863,16 +2566,20 @@ void BpDocument::showPage( int pageNumber )
     QFont entryFont( property()->string( "worksheetEntryFontFamily" ) );
     entryFont.setPointSize( m_fontScaleSize );
 
-    // First hide all the widgets.
+    // First hide the widgets shown on the previous page.
     // NOTE m_entry.at(lid)->hide() triggers a call to BpDocEntry::valid(),
     // which calls validateWorksheetEntry() which updates the m_worksheetEdited
     // and will trim results pages before drawing the next page.
+    // When rescale() re-shows the same page, its widgets are simply
+    // resized and moved below rather than hidden and shown again.
     m_doValidation = false;
     int lid;
-    for ( lid = 0;
-          lid < (int) m_guideBtn.size();
-          lid++ )
+    QValueList<int>::Iterator it;
+    for ( it = m_shownEntries.begin();
+          it != m_shownEntries.end() && ! m_rescaling;
+          ++it )
     {
+        lid = *it;
         m_scrollView->moveChild( m_guideBtn.at(lid),
             -m_screenSize->m_pageWd, -m_screenSize->m_pageHt );
         m_scrollView->moveChild( m_entry.at(lid),
@@ -1882,13 +2589,16 @@ void BpDocument::showPage( int pageNumber )
         m_entry.at(lid)->hide();
 		m_entry.at(lid)->m_validate = true;
     }
-    // Hide all the RxVars
+    m_shownEntries.clear();
+    // Hide the RxVars shown on the previous page
     RxVar *rxVar = 0;
     int rxId = 0;
-    for ( rxVar = m_eqTree->m_rxVarList->first();
-          rxVar;
-          rxVar = m_eqTree->m_rxVarList->next(), rxId++ )
+    int item;
+    for ( it = m_shownRx.begin();
+          it != m_shownRx.end() && ! m_rescaling;
+          ++it )
     {
+        rxId = *it;
         m_scrollView->moveChild( m_rxCheckBox.at(rxId),
             -m_screenSize->m_pageWd, -m_screenSize->m_pageHt );
         m_scrollView->moveChild( m_rxMinEntry.at(rxId),
@@ -1898,15 +2608,20 @@ void BpDocument::showPage( int pageNumber )
         m_rxCheckBox.at(rxId)->hide();
         m_rxMinEntry.at(rxId)->hide();
         m_rxMaxEntry.at(rxId)->hide();
+        rxVar = m_eqTree->m_rxVarList->at( rxId );
+        if ( rxVar && ! rxVar->m_varPtr->isContinuous() )
+        {
+            int items  = rxVar->items();
+            int atItem = rxVar->m_firstItemBox;
+            for ( item=0; item<items; item++, atItem++ )
+            {
+                m_scrollView->moveChild( m_rxItemBox.at(atItem),
+                    -m_screenSize->m_pageWd, -m_screenSize->m_pageHt );
+                m_rxItemBox.at(atItem)->hide();
+            }
+        }
     }
-    int rxItems = m_eqTree->m_rxVarList->items();
-    int item;
-    for ( item=0; item<rxItems; item++ )
-    {
-        m_scrollView->moveChild( m_rxItemBox.at(item),
-            -m_screenSize->m_pageWd, -m_screenSize->m_pageHt );
-        m_rxItemBox.at(item)->hide();
-    }
+    m_shownRx.clear();
 
     // moved to end of the method 
 	//m_doValidation = true;
@@ -1926,6 +2641,11 @@ void BpDocument::showPage( int pageNumber )
           lid < (int) leafCount();
           lid++ )
     {
+        // Leaves are composed in order, so no later leaf is on this page.
+        if ( m_entryPage.at(lid) > pageNumber )
+        {
+            break;
+        }
         if ( m_entryPage.at(lid) == pageNumber )
         {
             // Resize the guide button and entry field to match the scale.
@@ -1952,6 +2672,7 @@ void BpDocument::showPage( int pageNumber )
             // Show the guide button and entry field.
             m_guideBtn.at(lid)->show();
             m_entry.at(lid)->show();
+            m_shownEntries.append( lid );
 
             // Set tab order
             if ( prevWidget )
@@ -2006,6 +2727,7 @@ void BpDocument::showPage( int pageNumber )
                     y3 = (int) ( scale * (double) m_rxEntryY.at(rxId) );
                     m_scrollView->moveChild( m_rxCheckBox.at(rxId), x1, y3 );
                     m_rxCheckBox.at(rxId)->show();
+                    m_shownRx.append( rxId );
                     setTabOrder( prevWidget, m_rxCheckBox.at(rxId) );
                     prevWidget = m_rxCheckBox.at(rxId);
                     // Move continuous minimum-maximum widgets into position
@@ -2081,11 +2803,44 @@ void BpDocument::showPage( int pageNumber )
         m_notes->hide();
     }
 
+    // Display the live preview widget if its on this page.
+    if ( pageNumber == m_previewPage
+      && property()->boolean( "worksheetLivePreview" ) )
+    {
+        QFont textFont( property()->string( "worksheetTextFontFamily" ) );
+        textFont.setPointSize( m_fontScaleSize );
+        m_preview->setFont( textFont );
+        m_preview->setFixedSize(
+            (int) ( scale * (double) m_previewWd ),
+            (int) ( scale * (double) m_previewHt ) );
+        // Rescaling doesn't change the preview's contents
+        if ( ! m_rescaling )
+        {
+            livePreview();
+        }
+        // Move into position and show it.
+        m_scrollView->moveChild( m_preview,
+            (int) ( scale * (double) m_previewX ),
+            (int) ( scale * (double) m_previewY ) );
+        m_preview->show();
+    }
+    // Otherwise hide the live preview widget.
+    else
+    {
+        m_scrollView->moveChild( m_preview,
+            -m_screenSize->m_pageWd, -m_screenSize->m_pageHt );
+        m_preview->hide();
+    }
+
     // Complete the tab order
     //setTabOrder( prevWidget, m_entry.at(0) );
 
     // Show the composed page in the scrollview and return.
-    Document::showPage( pageNumber );
+    // When rescaling, the page is repainted later by renderPage().
+    if ( ! m_rescaling )
+    {
+        Document::showPage( pageNumber );
+    }
     m_entry.at(m_focusEntry)->setFocus();
 	m_doValidation = true;
     return;
@@ -2281,25 +3036,37 @@ int BpDocument::tableRows( void ) const
 }
 
 //------------------------------------------------------------------------------
-/*! \brief Convenience routine to access EqTree::m_tableVal[] from BpDocuments.
+/*! \brief Convenience routine to access EqTree::m_tableApproxCell[] from
+ *  BpDocuments.
  *
- *  \return Output table value.
+ *  \return TRUE if output \a vid was interpolated at table \a cell.
+ */
+
+bool BpDocument::tableApprox( int cell, int vid ) const
+{
+    return( m_eqTree->tableApprox( cell, vid ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Convenience routine to access EqTree::m_tableInRx[] from BpDocuments.
+ *
+ *  \return Output table cell shading flag.
  */
 
 bool BpDocument::tableInRx( int cell ) const
 {
-    return( m_eqTree->m_tableInRx[ cell ] );
+    return( m_eqTree->tableInRx( cell ) );
 }
 
 //------------------------------------------------------------------------------
-/*! \brief Convenience routine to access EqTree::m_tableVal[] from BpDocuments.
+/*! \brief Convenience routine to access EqTree::m_tableVal from BpDocuments.
  *
  *  \return Output table value.
  */
 
-double BpDocument::tableVal( int vid ) const
+double BpDocument::tableVal( Q_LLONG vid ) const
 {
-    return( m_eqTree->m_tableVal[ vid ] );
+    return( m_eqTree->m_tableVal->get( vid ) );
 }
 
 //------------------------------------------------------------------------------
@@ -2526,6 +3293,9 @@ bool BpDocument::validateWorksheetEntry( int lid, const QString &text,
     // Gray out unneeded fuel moisture input variables.
     m_eqTree->m_eqCalc->maskInputs( leaf(lid) );
     grayInputs();
+
+    // Update the live preview results (if requested).
+    livePreview();
     return( true );
 }
 
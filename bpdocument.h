@@ -19,10 +19,12 @@
 #include <qmainwindow.h>
 #include <qmemarray.h>
 #include <qpixmap.h>
+#include <qvaluelist.h>
 
 class AppWindow;
 class Composer;
 class BpDocEntry;
+class BurnGrid;
 class EqApp;
 class EqTree;
 class Graph;
@@ -35,6 +37,8 @@ class QLineEdit;
 class QPushButton;
 class QTextEdit;
 class QWorkspace;
+class ResultCompare;
+class ResultSet;
 
 //------------------------------------------------------------------------------
 /*! \class BpDocument bpdocument.h
@@ -118,16 +122,23 @@ public:
     virtual ~BpDocument( void ) ;
 
 // Public methods that may be called by the AppWindow class.
+    virtual void applyTerrainGrid( const QString &gridFile ) ;
+    virtual void calibrateFuelModel( const QString &obsFile ) ;
     virtual bool capture( void ) ;
     virtual void clear( bool showRunDialog=true ) ;
+    virtual void compareResults( const QString &fileA, const QString &fileB ) ;
+    virtual void composeCompare( ResultCompare *cmp, ResultSet *a,
+                    ResultSet *b ) ;
     virtual void composeDocumentation( void ) ;
     virtual void composeGuideButtonPixmap( int wd, int ht ) ;
     virtual bool composeGraphs( bool lineGraphs, bool showDialogs ) ;
     virtual void composeLogo( double x0, double y0,
                     double wd, double ht, int penWd ) ;
+    virtual void composeRunNotes( void ) ;
     virtual void composeTable1( void ) ;
     virtual void composeTable2( EqVar *rowVar) ;
     virtual void composeTable3( EqVar *rowVar, EqVar *colVar ) ;
+    virtual void composeTableQuery( void ) ;
     virtual void configure( void ) ;
     virtual void configureAppearance( void ) ;
     virtual void configureFuelModels( void ) ;
@@ -140,6 +151,10 @@ public:
     virtual bool printPS( int fromPage, int thruPage ) ;
     virtual void reset( bool showRunDialog=true ) ;
     virtual void run( bool showRunDialog=true ) ;
+    virtual void runBurnGrid( const QString &gridFile ) ;
+    virtual void runHourly( const QString &wxFile ) ;
+    virtual void runSaveResults( const QString &resultSetFile ) ;
+    virtual void runTransect( const QString &transectFile ) ;
     virtual void setFocus( void ) ;
     virtual void save( const QString &fileName, const QString &fileType ) ;
     virtual void viewMenuAboutToShow( QPopupMenu *viewMenu ) ;
@@ -152,10 +167,11 @@ public:
     int    rootCount( void ) const ;
     double tableCol( int vid ) const ;
     int    tableCols( void ) const ;
+    bool   tableApprox( int cell, int vid ) const ;
     bool   tableInRx( int vid ) const ;
     double tableRow( int vid ) const ;
     int    tableRows( void ) const ;
-    double tableVal( int vid ) const ;
+    double tableVal( Q_LLONG vid ) const ;
     EqVar *tableVar( int vid ) const ;
     int    tableVars( void ) const;
 
@@ -219,6 +235,7 @@ private:
     void    composeTable1Html( void ) ;
     void    composeTable1Spreadsheet( void ) ;
     void    composeTable2Html( EqVar *rowVar ) ;
+    void    composeTable2RxWindow( EqVar *rowVar ) ;
     void    composeTable2Spreadsheet( EqVar *rowVar ) ;
     void    composeTable3Html( EqVar *rowVar, EqVar *colVar );
     void    composeTable3Html( FILE *fptr, int vid, EqVar *rowVar, EqVar *colVar ) ;
@@ -228,15 +245,19 @@ private:
     void    graphYMinMax( int yid, double &yMin, double &yMax ) ;
     void    grayInputs( void ) ;
     int     headerWidth( EqVar *varPtr, const QFontMetrics &fm ) ;
+    void    livePreview( void ) ;
     void    loadNotes( void ) ;
     double  newWorksheetPage( double lineHt, TocType=TocInput ) ;
+    void    runGraphOutputs( void ) ;
     void    runOptions( QString* runOpt, int& nOptions ) ;
     bool    runWorksheet( const QString &traceFile, const QString &resultFile,
                 bool showRunDialog=true ) ;
     void    saveAsFuelModelExportFile( const QString &fileType ) ;
     void    saveAsFuelModelFile( const QString &fileName ) ;
     void    saveAsMoistureScenarioFile( const QString &fileName ) ;
+    void    saveBurnGrid( void ) ;
     void    saveResults( const QString &fileName ) ;
+    void    saveResultSet( void ) ;
     void    saveAsRunFile( const QString &fileName, bool clone=false ) ;
     void    saveAsUnitsSetFile( const QString &fileName ) ;
     void    saveAsWorksheetFile( const QString &fileName ) ;
@@ -259,6 +280,8 @@ public:
     bool m_worksheetEdited;
     //! Determines if DpDocEntry::event() performs worksheet field validation
     bool m_doValidation;
+    //! Set while rescale() relays out the widgets on the current page
+    bool m_rescaling;
 
     /*! \name Input Entry Field Member Data
      *  \brief Entry field locations and sizes on the input worksheet.
@@ -344,6 +367,18 @@ public:
     QMemArray<int>          m_rxEntryWd;
     //@}
 
+    /*! \name Shown Widget Member Data
+     *  \brief Indices of the entry fields and rx variables whose widgets
+     *  were shown by the last showPage(), so that the next call need only
+     *  hide those rather than every widget on every worksheet page.
+     */
+    //@{
+    //! List of m_entry[] indices shown on the current page.
+    QValueList<int>         m_shownEntries;
+    //! List of m_rxCheckBox[] indices shown on the current page.
+    QValueList<int>         m_shownRx;
+    //@}
+
     /*! \name Worksheet Notes Section Member Data
      *  \brief Worksheet notes section location and size on the input worksheet.
      *  The notes section line is controlled by the \a worksheetNotesLines and
@@ -362,6 +397,34 @@ public:
     int             m_notesWd;
     //! Notes section screen pixel height.
     int             m_notesHt;
+    //@}
+
+    /*! \name Worksheet Live Preview Member Data
+     *  \brief Live preview area location and size on the input worksheet.
+     *  The live preview area is controlled by the \a worksheetLivePreview
+     *  property.
+     */
+    //@{
+    //! Pointer to the dynamically-allocated preview results label.
+    QLabel         *m_preview;
+    //! Preview area input worksheet page number.
+    int             m_previewPage;
+    //! Preview area X screen pixel location.
+    int             m_previewX;
+    //! Preview area Y screen pixel location.
+    int             m_previewY;
+    //! Preview area screen pixel width.
+    int             m_previewWd;
+    //! Preview area screen pixel height.
+    int             m_previewHt;
+    //! TRUE once every leaf has been stored since the worksheet was composed.
+    bool            m_previewSynced;
+    //! Result set file to be written by the next table run, or empty.
+    QString         m_resultSetFile;
+    //! Burn grid to be filled by the next table run, or 0.
+    BurnGrid       *m_burnGrid;
+    //! Burn probability grid file to be written by the next table run.
+    QString         m_burnGridFile;
     //@}
 	int m_colDecimals;
 	int m_rowDecimals;
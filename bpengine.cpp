@@ -0,0 +1,825 @@
+//------------------------------------------------------------------------------
+/*! \file bpengine.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief C interface for embedding the BehavePlus equation engine.
+ *
+ *  Qt 3 strings and pointer lists are implicitly shared and carry an
+ *  iteration cursor, so nothing an evaluator touches while calculating may
+ *  be shared with another evaluator.  bpEvaluatorCreate() therefore gives
+ *  each EqTree deep copies of the EqApp item lists, fuel model list, and
+ *  moisture scenario list, and of its property values.  Everything else
+ *  that reads the shared EqApp or the application-wide dictionaries is
+ *  serialized by BpEngineMutex.
+ */
+
+// Custom include files
+#include "appmessage.h"
+#include "apptranslator.h"
+#include "bpengine.h"
+#include "fuelmodel.h"
+#include "moisscenario.h"
+#include "property.h"
+#include "xeqapp.h"
+#include "xeqcalc.h"
+#include "xeqtree.h"
+#include "xeqvar.h"
+#include "xeqvaritem.h"
+
+// Qt include files
+#include <qdatetime.h>
+#include <qdeepcopy.h>
+#include <qdict.h>
+#include <qfileinfo.h>
+#include <qmutex.h>
+
+//------------------------------------------------------------------------------
+/*! \struct BpEngine bpengine.cpp
+ *
+ *  \brief The shared equation definitions behind a BpEngine handle.
+ */
+
+struct BpEngine
+{
+    EqApp  *m_eqApp;        //!< Shared equation definitions
+    int     m_refs;         //!< Number of unmatched bpEngineCreate() calls
+};
+
+//------------------------------------------------------------------------------
+/*! \struct BpEvaluator bpengine.cpp
+ *
+ *  \brief An EqTree and the private lists it evaluates against.
+ */
+
+struct BpEvaluator
+{
+    BpEngine              *m_engine;            //!< Parent engine
+    EqTree                *m_eqTree;            //!< Private EqTree
+    EqVarItemList        **m_itemList;          //!< Private item lists
+    int                    m_itemListCount;     //!< Size of m_itemList[]
+    QDict<EqVarItemList>  *m_itemListDict;      //!< Owns the private item lists
+    FuelModelList         *m_fuelModelList;     //!< Private fuel model list
+    MoisScenarioList      *m_moisScenarioList;  //!< Private moisture scenarios
+};
+
+/*! \var BpEngineMutex
+ *  \brief Serializes engine and evaluator creation and destruction,
+ *  configuration, and access to the shared EqApp.
+ */
+static QMutex BpEngineMutex;
+
+/*! \var BpEngineInstance
+ *  \brief The one engine in this process, or 0.
+ */
+static BpEngine *BpEngineInstance = 0;
+
+//------------------------------------------------------------------------------
+/*! \brief Makes an unshared copy of \a str.
+ */
+
+static QString bpDeep( const QString &str )
+{
+    return( QDeepCopy<QString>( str ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Checks that \a var is a valid EqVar index for the evaluator.
+ *
+ *  \return Pointer to the evaluator's EqVar, or 0.
+ */
+
+static EqVar *bpEvaluatorVar( BpEvaluator *eval, int var )
+{
+    if ( var < 0 || var >= eval->m_eqTree->m_varCount )
+    {
+        return( 0 );
+    }
+    return( eval->m_eqTree->m_var[var] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Calculates \a varPtr and returns its value in native units, or
+ *  its item data index if discrete.
+ *
+ *  \return BpEngineStatus code.
+ */
+
+static int bpEvaluatorGet( EqTree *eqTree, EqVar *varPtr, double *value )
+{
+    EqCalc *eqCalc = eqTree->m_eqCalc;
+    eqCalc->m_status = EqCalcOk;
+    eqTree->calculateVariable( varPtr, 0 );
+    if ( eqCalc->m_status != EqCalcOk )
+    {
+        // Leave the failing input dirty so the next request fails again
+        // instead of returning the stale results
+        eqCalc->m_statusVar->propagateDirty();
+        if ( eqCalc->m_status == EqCalcFuelModelNotFound )
+        {
+            return( BpEngineFuelModelNotFound );
+        }
+        if ( eqCalc->m_status == EqCalcMoisScenarioNotFound )
+        {
+            return( BpEngineMoisScenarioNotFound );
+        }
+        return( BpEngineTreeSpeciesNotFound );
+    }
+    if ( varPtr->isContinuous() )
+    {
+        *value = varPtr->m_nativeValue;
+    }
+    else if ( varPtr->isDiscrete() )
+    {
+        *value = (double) varPtr->activeItemDataIndex();
+    }
+    else
+    {
+        return( BpEngineNotContinuous );
+    }
+    return( BpEngineOk );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets input \a varPtr to \a value in native units, or to the item
+ *  with data index \a value if discrete.
+ *
+ *  Setting an input to its current value leaves its consumers clean.
+ *
+ *  \return BpEngineStatus code.
+ */
+
+static int bpEvaluatorSet( EqVar *varPtr, double value )
+{
+    if ( ! varPtr->m_isUserInput )
+    {
+        return( BpEngineNotInput );
+    }
+    if ( varPtr->isContinuous() )
+    {
+        if ( value != varPtr->m_nativeValue )
+        {
+            varPtr->setNativeValue( value );
+        }
+        return( BpEngineOk );
+    }
+    if ( varPtr->isDiscrete() )
+    {
+        EqVarItem *itemPtr = varPtr->m_itemList->itemWithIndex( (int) value );
+        if ( ! itemPtr )
+        {
+            return( BpEngineBadItem );
+        }
+        if ( itemPtr->m_name != varPtr->m_activeItemName )
+        {
+            varPtr->setItemName( itemPtr->m_name, false );
+        }
+        return( BpEngineOk );
+    }
+    return( BpEngineNotContinuous );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Loads the EqApp definitions from \a xmlFile, or adds a reference
+ *  to the already loaded engine.
+ *
+ *  \return Engine handle, or 0 if \a xmlFile cannot be read.
+ */
+
+BpEngine *bpEngineCreate( const char *xmlFile )
+{
+    QMutexLocker lock( &BpEngineMutex );
+    if ( BpEngineInstance )
+    {
+        BpEngineInstance->m_refs++;
+        return( BpEngineInstance );
+    }
+    if ( ! xmlFile )
+    {
+        return( 0 );
+    }
+    QFileInfo fi( xmlFile );
+    if ( ! fi.exists() || ! fi.isReadable() )
+    {
+        return( 0 );
+    }
+    BpEngine *engine = new BpEngine;
+    checkmem( __FILE__, __LINE__, engine, "BpEngine engine", 1 );
+    engine->m_eqApp = new EqApp( QString( xmlFile ) );
+    checkmem( __FILE__, __LINE__, engine->m_eqApp, "EqApp m_eqApp", 1 );
+    engine->m_refs = 1;
+    appTranslatorSetLanguage( "en_US" );
+    BpEngineInstance = engine;
+    return( engine );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Releases a reference to the engine, deleting it with the last.
+ *
+ *  All the engine's evaluators must be destroyed first.
+ */
+
+void bpEngineDestroy( BpEngine *engine )
+{
+    QMutexLocker lock( &BpEngineMutex );
+    if ( ! engine || engine != BpEngineInstance || --engine->m_refs > 0 )
+    {
+        return;
+    }
+    delete engine->m_eqApp;
+    delete engine;
+    BpEngineInstance = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Finds the data index of a discrete variable's item.
+ *
+ *  \return Item data index, or -1 if not found.
+ */
+
+int bpEngineItemIndex( BpEngine *engine, int var, const char *itemName )
+{
+    if ( ! engine || ! itemName || var < 0
+      || var >= engine->m_eqApp->m_variableCount )
+    {
+        return( -1 );
+    }
+    QMutexLocker lock( &BpEngineMutex );
+    EqVar *varPtr = engine->m_eqApp->m_var[var];
+    if ( ! varPtr->isDiscrete() || ! varPtr->m_itemList )
+    {
+        return( -1 );
+    }
+    EqVarItem *itemPtr = varPtr->m_itemList->itemWithName( itemName, false );
+    return( ( itemPtr ) ? itemPtr->m_index : -1 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the number of variables.
+ */
+
+int bpEngineVarCount( BpEngine *engine )
+{
+    return( ( engine ) ? engine->m_eqApp->m_variableCount : 0 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Finds a variable by name.
+ *
+ *  \return Variable index for all the engine's evaluators, or -1.
+ */
+
+int bpEngineVarIndex( BpEngine *engine, const char *name )
+{
+    if ( ! engine || ! name )
+    {
+        return( -1 );
+    }
+    QMutexLocker lock( &BpEngineMutex );
+    EqApp *eqApp = engine->m_eqApp;
+    EqVar *varPtr = eqApp->m_varDict->find( name );
+    for ( int vid = 0;
+          varPtr && vid < eqApp->m_variableCount;
+          vid++ )
+    {
+        if ( eqApp->m_var[vid] == varPtr )
+        {
+            return( vid );
+        }
+    }
+    return( -1 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines if the variable is discrete.
+ *
+ *  \return 1 if discrete, 0 if not or if \a var is invalid.
+ */
+
+int bpEngineVarIsDiscrete( BpEngine *engine, int var )
+{
+    if ( ! engine || var < 0 || var >= engine->m_eqApp->m_variableCount )
+    {
+        return( 0 );
+    }
+    return( engine->m_eqApp->m_var[var]->isDiscrete() ? 1 : 0 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the variable's native units.
+ *
+ *  \return Units string owned by the engine, empty for discrete variables,
+ *  or 0 if \a var is invalid.
+ */
+
+const char *bpEngineVarUnits( BpEngine *engine, int var )
+{
+    if ( ! engine || var < 0 || var >= engine->m_eqApp->m_variableCount )
+    {
+        return( 0 );
+    }
+    QMutexLocker lock( &BpEngineMutex );
+    return( engine->m_eqApp->m_var[var]->m_nativeUnits.latin1() );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Creates an evaluator configured with the default properties.
+ *
+ *  \return Evaluator handle, or 0 if \a engine is 0.
+ */
+
+BpEvaluator *bpEvaluatorCreate( BpEngine *engine )
+{
+    if ( ! engine )
+    {
+        return( 0 );
+    }
+    QMutexLocker lock( &BpEngineMutex );
+    EqApp *eqApp = engine->m_eqApp;
+    BpEvaluator *eval = new BpEvaluator;
+    checkmem( __FILE__, __LINE__, eval, "BpEvaluator eval", 1 );
+    eval->m_engine = engine;
+
+    // Private copies of the item lists
+    eval->m_itemListCount = eqApp->m_itemListCount;
+    eval->m_itemList = new EqVarItemList *[ eval->m_itemListCount ];
+    checkmem( __FILE__, __LINE__, eval->m_itemList, "EqVarItemList *m_itemList",
+        eval->m_itemListCount );
+    eval->m_itemListDict = new QDict<EqVarItemList>( eqApp->m_itemListPrime );
+    Q_CHECK_PTR( eval->m_itemListDict );
+    eval->m_itemListDict->setAutoDelete( true );
+    EqVarItemList *src, *dst;
+    EqVarItem *itemPtr, *newItem;
+    int id;
+    for ( id = 0;
+          id < eval->m_itemListCount;
+          id++ )
+    {
+        eval->m_itemList[id] = 0;
+        if ( ! ( src = eqApp->m_itemList[id] ) )
+        {
+            continue;
+        }
+        dst = new EqVarItemList( bpDeep( src->m_name ) );
+        checkmem( __FILE__, __LINE__, dst, "EqVarItemList dst", 1 );
+        for ( itemPtr = src->first();
+              itemPtr;
+              itemPtr = src->next() )
+        {
+            newItem = dst->addItem( bpDeep( itemPtr->m_name ),
+                bpDeep( itemPtr->m_sort ), itemPtr->m_index, itemPtr->m_perm,
+                false );
+            newItem->m_desc = itemPtr->m_desc;
+        }
+        dst->m_nameDefault = bpDeep( src->m_nameDefault );
+        eval->m_itemList[id] = dst;
+        eval->m_itemListDict->insert( dst->m_name, dst );
+    }
+
+    // Private copies of the fuel models and moisture scenarios
+    eval->m_fuelModelList = new FuelModelList();
+    checkmem( __FILE__, __LINE__, eval->m_fuelModelList,
+        "FuelModelList m_fuelModelList", 1 );
+    FuelModel *fm;
+    for ( fm = eqApp->m_fuelModelList->first();
+          fm;
+          fm = eqApp->m_fuelModelList->next() )
+    {
+        eval->m_fuelModelList->addFuelModel( bpDeep( fm->m_file ),
+            fm->m_number, bpDeep( fm->m_name ), bpDeep( fm->m_desc ),
+            fm->m_depth, fm->m_mext, fm->m_heatDead, fm->m_heatLive,
+            fm->m_load1, fm->m_load10, fm->m_load100, fm->m_loadHerb,
+            fm->m_loadWood, fm->m_savr1, fm->m_savrHerb, fm->m_savrWood,
+            bpDeep( fm->m_transfer ) );
+    }
+    eval->m_moisScenarioList = new MoisScenarioList();
+    checkmem( __FILE__, __LINE__, eval->m_moisScenarioList,
+        "MoisScenarioList m_moisScenarioList", 1 );
+    MoisScenario *ms;
+    for ( ms = eqApp->m_moisScenarioList->first();
+          ms;
+          ms = eqApp->m_moisScenarioList->next() )
+    {
+        eval->m_moisScenarioList->addMoisScenario( bpDeep( ms->m_file ),
+            bpDeep( ms->m_name ), bpDeep( ms->m_desc ),
+            ms->m_moisDead1, ms->m_moisDead10, ms->m_moisDead100,
+            ms->m_moisDead1000, ms->m_moisLiveHerb, ms->m_moisLiveWood );
+    }
+
+    // Create the EqTree over the private lists
+    EqTree *eqTree = new EqTree( eqApp, "bpEngine",
+        eqApp->m_functionCount, eqApp->m_functionPrime,
+        eqApp->m_variableCount, eqApp->m_variablePrime,
+        eqApp->m_propertyPrime, eval->m_itemList, eval->m_itemListCount,
+        eval->m_itemListDict, eval->m_fuelModelList,
+        eval->m_moisScenarioList );
+    checkmem( __FILE__, __LINE__, eqTree, "EqTree eqTree", 1 );
+    eqTree->setLanguage( eqApp->m_language );
+    eval->m_eqTree = eqTree;
+
+    // Return calculation failures as status codes instead of calling bomb(),
+    // which would display a message from the caller's thread
+    eqTree->m_eqCalc->m_reportErrors = false;
+
+    // Point the discrete variables at the private item lists
+    EqVar *varPtr;
+    for ( id = 0;
+          id < eqTree->m_varCount;
+          id++ )
+    {
+        varPtr = eqTree->m_var[id];
+        if ( varPtr->isDiscrete() && varPtr->m_itemList )
+        {
+            varPtr->m_itemList =
+                eval->m_itemListDict->find( varPtr->m_itemList->m_name );
+            if ( varPtr->m_itemList
+              && ! varPtr->m_itemList->m_nameDefault.isEmpty() )
+            {
+                varPtr->setItemNameToDefault();
+            }
+        }
+    }
+    // Unshare the property values copied from the application properties
+    QDictIterator<Property> it( *eqTree->m_propDict );
+    for ( ;
+          it.current();
+          ++it )
+    {
+        it.current()->m_value = bpDeep( it.current()->m_value );
+    }
+    eqTree->reconfigure( eqApp->m_release );
+    return( eval );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Deletes the evaluator and its private lists.
+ */
+
+void bpEvaluatorDestroy( BpEvaluator *eval )
+{
+    if ( ! eval )
+    {
+        return;
+    }
+    QMutexLocker lock( &BpEngineMutex );
+    delete   eval->m_eqTree;
+    delete   eval->m_itemListDict;
+    delete[] eval->m_itemList;
+    delete   eval->m_fuelModelList;
+    delete   eval->m_moisScenarioList;
+    delete   eval;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Times the per-call overhead of the evaluator.
+ *
+ *  First times \a calls bpEvaluatorGetValue() calls for the already
+ *  calculated \a outVar, then (if \a inVar is a continuous input) \a calls
+ *  cycles that alternately nudge \a inVar and recalculate \a outVar.
+ *  Both times are written to the log.
+ *
+ *  \return Mean nanoseconds per cached bpEvaluatorGetValue() call,
+ *  or -1 on error.
+ */
+
+double bpEvaluatorBenchmark( BpEvaluator *eval, int inVar, int outVar,
+        int calls )
+{
+    double value, base;
+    if ( calls <= 0
+      || bpEvaluatorGetValue( eval, outVar, &value ) != BpEngineOk )
+    {
+        return( -1. );
+    }
+    int i;
+    QTime timer;
+    timer.start();
+    for ( i = 0;
+          i < calls;
+          i++ )
+    {
+        bpEvaluatorGetValue( eval, outVar, &value );
+    }
+    double cachedNs = 1.e6 * (double) timer.elapsed() / (double) calls;
+
+    double cycleNs = -1.;
+    EqVar *inPtr = bpEvaluatorVar( eval, inVar );
+    if ( inPtr && inPtr->isContinuous() && inPtr->m_isUserInput )
+    {
+        base = inPtr->m_nativeValue;
+        timer.restart();
+        for ( i = 0;
+              i < calls;
+              i++ )
+        {
+            bpEvaluatorSetValue( eval, inVar, ( i & 1 ) ? base : 1.01 * base );
+            bpEvaluatorGetValue( eval, outVar, &value );
+        }
+        cycleNs = 1.e6 * (double) timer.elapsed() / (double) calls;
+        bpEvaluatorSetValue( eval, inVar, base );
+    }
+    log( QString( "bpEvaluatorBenchmark() %1 calls: %2 ns per cached get, "
+        "%3 ns per set and evaluate.\n" )
+        .arg( calls ).arg( cachedNs ).arg( cycleNs ) );
+    return( cachedNs );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Reconfigures the evaluator from its current properties, which
+ *  selects its current inputs and outputs.
+ *
+ *  \return BpEngineStatus code.
+ */
+
+int bpEvaluatorConfigure( BpEvaluator *eval )
+{
+    if ( ! eval )
+    {
+        return( BpEngineBadHandle );
+    }
+    QMutexLocker lock( &BpEngineMutex );
+    eval->m_eqTree->reconfigure( eval->m_engine->m_eqApp->m_release );
+    return( BpEngineOk );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Calculates a variable and returns its value in native units,
+ *  or its item data index if discrete.
+ *
+ *  \return BpEngineStatus code.
+ */
+
+int bpEvaluatorGetValue( BpEvaluator *eval, int var, double *value )
+{
+    if ( ! eval )
+    {
+        return( BpEngineBadHandle );
+    }
+    EqVar *varPtr = bpEvaluatorVar( eval, var );
+    if ( ! varPtr )
+    {
+        return( BpEngineBadVar );
+    }
+    return( bpEvaluatorGet( eval->m_eqTree, varPtr, value ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Calculates \a count variables and returns their values.
+ *
+ *  \return BpEngineStatus code of the first failure, or BpEngineOk.
+ */
+
+int bpEvaluatorGetValues( BpEvaluator *eval, int count, const int *var,
+        double *value )
+{
+    int status;
+    for ( int i = 0;
+          i < count;
+          i++ )
+    {
+        if ( ( status = bpEvaluatorGetValue( eval, var[i], &value[i] ) )
+            != BpEngineOk )
+        {
+            return( status );
+        }
+    }
+    return( BpEngineOk );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Evaluates a batch of \a cases.
+ *
+ *  For each case the \a inputs inputs \a inVar[] are set from the case's
+ *  row of \a inValue[] (\a cases by \a inputs), and the \a outputs outputs
+ *  \a outVar[] are calculated into its row of \a outValue[] (\a cases by
+ *  \a outputs).  Inputs that do not change between cases leave their
+ *  consumers clean, so ordering the cases to vary the fewest inputs
+ *  recalculates the least.
+ *
+ *  \return BpEngineStatus code of the first failure, or BpEngineOk.
+ */
+
+int bpEvaluatorRun( BpEvaluator *eval, int cases,
+        int inputs, const int *inVar, const double *inValue,
+        int outputs, const int *outVar, double *outValue )
+{
+    if ( ! eval )
+    {
+        return( BpEngineBadHandle );
+    }
+    // Resolve and check all the variables once
+    EqTree *eqTree = eval->m_eqTree;
+    EqVar **inPtr = new EqVar *[ inputs + outputs + 1 ];
+    checkmem( __FILE__, __LINE__, inPtr, "EqVar *inPtr", inputs + outputs + 1 );
+    EqVar **outPtr = inPtr + inputs;
+    int i, c;
+    int status = BpEngineOk;
+    for ( i = 0;
+          i < inputs && status == BpEngineOk;
+          i++ )
+    {
+        if ( ! ( inPtr[i] = bpEvaluatorVar( eval, inVar[i] ) ) )
+        {
+            status = BpEngineBadVar;
+        }
+        else if ( ! inPtr[i]->m_isUserInput )
+        {
+            status = BpEngineNotInput;
+        }
+    }
+    for ( i = 0;
+          i < outputs && status == BpEngineOk;
+          i++ )
+    {
+        if ( ! ( outPtr[i] = bpEvaluatorVar( eval, outVar[i] ) ) )
+        {
+            status = BpEngineBadVar;
+        }
+    }
+    // Evaluate each case
+    for ( c = 0;
+          c < cases && status == BpEngineOk;
+          c++ )
+    {
+        for ( i = 0;
+              i < inputs && status == BpEngineOk;
+              i++ )
+        {
+            status = bpEvaluatorSet( inPtr[i], inValue[ c * inputs + i ] );
+        }
+        for ( i = 0;
+              i < outputs && status == BpEngineOk;
+              i++ )
+        {
+            status = bpEvaluatorGet( eqTree, outPtr[i],
+                &outValue[ c * outputs + i ] );
+        }
+    }
+    delete[] inPtr;
+    return( status );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets a discrete input to the item named \a itemName.
+ *
+ *  \return BpEngineStatus code.
+ */
+
+int bpEvaluatorSetItemByName( BpEvaluator *eval, int var,
+        const char *itemName )
+{
+    if ( ! eval )
+    {
+        return( BpEngineBadHandle );
+    }
+    EqVar *varPtr = bpEvaluatorVar( eval, var );
+    if ( ! varPtr )
+    {
+        return( BpEngineBadVar );
+    }
+    if ( ! varPtr->isDiscrete() || ! itemName )
+    {
+        return( BpEngineBadItem );
+    }
+    EqVarItem *itemPtr = varPtr->m_itemList->itemWithName( itemName, false );
+    if ( ! itemPtr )
+    {
+        return( BpEngineBadItem );
+    }
+    return( bpEvaluatorSet( varPtr, (double) itemPtr->m_index ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets one of the evaluator's configuration properties.
+ *
+ *  Call bpEvaluatorConfigure() after setting all the properties.
+ *
+ *  \return BpEngineStatus code.
+ */
+
+int bpEvaluatorSetProperty( BpEvaluator *eval, const char *name,
+        const char *value )
+{
+    if ( ! eval )
+    {
+        return( BpEngineBadHandle );
+    }
+    PropertyDict *propDict = eval->m_eqTree->m_propDict;
+    if ( ! name || ! value || ! propDict->exists( name ) )
+    {
+        return( BpEngineBadProperty );
+    }
+    return( propDict->update( name, value )
+        ? BpEngineOk
+        : BpEngineBadProperty );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the entry text of a list input, such as the containment
+ *  resource names, arrival times, durations, and productivities.
+ *
+ *  \a store holds the input's values separated by blanks or commas, in
+ *  native units for continuous inputs and by item name for discrete ones,
+ *  just as they would be entered on a worksheet.
+ *
+ *  \return BpEngineStatus code.
+ */
+
+int bpEvaluatorSetStore( BpEvaluator *eval, int var, const char *store )
+{
+    if ( ! eval )
+    {
+        return( BpEngineBadHandle );
+    }
+    EqVar *varPtr = bpEvaluatorVar( eval, var );
+    if ( ! varPtr || ! store )
+    {
+        return( BpEngineBadVar );
+    }
+    if ( ! varPtr->m_isUserInput )
+    {
+        return( BpEngineNotInput );
+    }
+    // Invalid tokens are reported through the shared translator
+    QMutexLocker lock( &BpEngineMutex );
+    varPtr->setStore( bpDeep( QString( store ) ) );
+    int tokens, position, length;
+    if ( ! varPtr->isValidStore( &tokens, &position, &length ) )
+    {
+        return( BpEngineBadStore );
+    }
+    varPtr->propagateDirty();
+    return( BpEngineOk );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets an input's value in native units, or its item data index
+ *  if discrete.
+ *
+ *  \return BpEngineStatus code.
+ */
+
+int bpEvaluatorSetValue( BpEvaluator *eval, int var, double value )
+{
+    if ( ! eval )
+    {
+        return( BpEngineBadHandle );
+    }
+    EqVar *varPtr = bpEvaluatorVar( eval, var );
+    if ( ! varPtr )
+    {
+        return( BpEngineBadVar );
+    }
+    return( bpEvaluatorSet( varPtr, value ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets an input by name.  Slower than bpEvaluatorSetValue().
+ *
+ *  \return BpEngineStatus code.
+ */
+
+int bpEvaluatorSetValueByName( BpEvaluator *eval, const char *name,
+        double value )
+{
+    if ( ! eval )
+    {
+        return( BpEngineBadHandle );
+    }
+    EqVar *varPtr = ( name ) ? eval->m_eqTree->m_varDict->find( name ) : 0;
+    if ( ! varPtr )
+    {
+        return( BpEngineBadVar );
+    }
+    return( bpEvaluatorSet( varPtr, value ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets \a count inputs.
+ *
+ *  \return BpEngineStatus code of the first failure, or BpEngineOk.
+ */
+
+int bpEvaluatorSetValues( BpEvaluator *eval, int count, const int *var,
+        const double *value )
+{
+    int status;
+    for ( int i = 0;
+          i < count;
+          i++ )
+    {
+        if ( ( status = bpEvaluatorSetValue( eval, var[i], value[i] ) )
+            != BpEngineOk )
+        {
+            return( status );
+        }
+    }
+    return( BpEngineOk );
+}
+
+//------------------------------------------------------------------------------
+//  End of bpengine.cpp
+//------------------------------------------------------------------------------
+
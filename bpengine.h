@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------------
+/*! \file bpengine.h
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief C interface for embedding the BehavePlus equation engine.
+ *
+ *  The engine loads the EqApp definition (BehavePlus5.xml) once.  Each
+ *  evaluator is a private EqTree with its own copies of the item, fuel
+ *  model, and moisture scenario lists, so separate evaluators may be used
+ *  concurrently from separate threads.  A single evaluator must only be
+ *  used by one thread at a time.
+ *
+ *  Variables are identified by their index into the EqApp variable array,
+ *  which is the same for every evaluator.  Resolve names once with
+ *  bpEngineVarIndex() and then use the indexes; the by-name calls are for
+ *  convenience and are not intended for inner loops.
+ *
+ *  All values are in the variable's native units (see bpEngineVarUnits()).
+ *  Discrete variables are set and returned as their item data index.
+ *  Evaluators are configured by the same properties as a worksheet (for
+ *  example "surfaceModuleActive"); call bpEvaluatorConfigure() after
+ *  changing them to select the current inputs and outputs.
+ *
+ *  The engine and everything it uses build as the static library
+ *  bpengine.lib ("nmake engine"), which has no GUI dependencies; the
+ *  message functions only write to the log unless the application installs
+ *  a display hook with appGuiDisplay().  bpenginebench.cpp is a console
+ *  driver that runs evaluators on several threads.
+ *
+ *  Only one engine may exist in a process at a time because the EqApp
+ *  creates the application-wide translator, property dictionary, and
+ *  units converter.  Repeated calls to bpEngineCreate() return the same
+ *  engine, which is released by the matching number of bpEngineDestroy()
+ *  calls.
+ */
+
+#ifndef _BPENGINE_H_
+/*! \def _BPENGINE_H_
+ *  \brief Prevent redundant includes.
+ */
+#define _BPENGINE_H_ 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \typedef BpEngine
+ *  \brief Opaque handle to the loaded equation definitions.
+ */
+typedef struct BpEngine BpEngine;
+
+/*! \typedef BpEvaluator
+ *  \brief Opaque handle to a single-threaded evaluator.
+ */
+typedef struct BpEvaluator BpEvaluator;
+
+/*! \enum BpEngineStatus
+ *  \brief Status codes returned by the bpEvaluator*() functions.
+ */
+enum BpEngineStatus
+{
+    BpEngineOk=0,           //!< Success
+    BpEngineBadHandle=1,    //!< Null engine or evaluator handle
+    BpEngineBadVar=2,       //!< Variable index or name not found
+    BpEngineNotInput=3,     //!< Variable is not a current input
+    BpEngineNotContinuous=4,//!< Variable is not continuous
+    BpEngineBadItem=5,      //!< Item name or index not in the variable's list
+    BpEngineBadProperty=6,  //!< Property name not found
+    BpEngineFuelModelNotFound=7,    //!< Current fuel model is not defined
+    BpEngineMoisScenarioNotFound=8, //!< Current moisture scenario is not defined
+    BpEngineTreeSpeciesNotFound=9,  //!< Spotting tree species is out of range
+    BpEngineBadStore=10     //!< List input entry has an invalid value
+};
+
+// Engine functions
+BpEngine    *bpEngineCreate( const char *xmlFile ) ;
+void         bpEngineDestroy( BpEngine *engine ) ;
+int          bpEngineItemIndex( BpEngine *engine, int var,
+                const char *itemName ) ;
+int          bpEngineVarCount( BpEngine *engine ) ;
+int          bpEngineVarIndex( BpEngine *engine, const char *name ) ;
+int          bpEngineVarIsDiscrete( BpEngine *engine, int var ) ;
+const char  *bpEngineVarUnits( BpEngine *engine, int var ) ;
+
+// Evaluator functions
+BpEvaluator *bpEvaluatorCreate( BpEngine *engine ) ;
+void         bpEvaluatorDestroy( BpEvaluator *eval ) ;
+double       bpEvaluatorBenchmark( BpEvaluator *eval, int inVar,
+                int outVar, int calls ) ;
+int          bpEvaluatorConfigure( BpEvaluator *eval ) ;
+int          bpEvaluatorGetValue( BpEvaluator *eval, int var,
+                double *value ) ;
+int          bpEvaluatorGetValues( BpEvaluator *eval, int count,
+                const int *var, double *value ) ;
+int          bpEvaluatorRun( BpEvaluator *eval, int cases,
+                int inputs, const int *inVar, const double *inValue,
+                int outputs, const int *outVar, double *outValue ) ;
+int          bpEvaluatorSetItemByName( BpEvaluator *eval, int var,
+                const char *itemName ) ;
+int          bpEvaluatorSetProperty( BpEvaluator *eval, const char *name,
+                const char *value ) ;
+int          bpEvaluatorSetStore( BpEvaluator *eval, int var,
+                const char *store ) ;
+int          bpEvaluatorSetValue( BpEvaluator *eval, int var, double value ) ;
+int          bpEvaluatorSetValueByName( BpEvaluator *eval, const char *name,
+                double value ) ;
+int          bpEvaluatorSetValues( BpEvaluator *eval, int count,
+                const int *var, const double *value ) ;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of bpengine.h
+//------------------------------------------------------------------------------
+
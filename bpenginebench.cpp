@@ -0,0 +1,289 @@
+//------------------------------------------------------------------------------
+/*! \file bpenginebench.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Console driver that exercises the equation engine library
+ *  (bpengine.lib) from several threads at once.
+ *
+ *  Usage: bpenginebench xmlFile [threads [calls]]
+ *
+ *  The main thread evaluates a fixed batch of surface fire cases as the
+ *  reference.  Each case's outputs are the surface fire spread rate and
+ *  the contained fire size for a two resource initial attack, so the batch
+ *  also runs the Contain Module's multiple resource simulation (ContainFF).
+ *  Each worker thread then creates its own evaluator, runs the same batch
+ *  with bpEvaluatorRun(), compares every output with the reference, and
+ *  times the evaluator with bpEvaluatorBenchmark().  The benchmark timings
+ *  are also written to bpenginebench.log.
+ */
+
+// Custom include files
+#include "appmessage.h"
+#include "bpengine.h"
+
+// Qt include files
+#include <qthread.h>
+
+// Standard include files
+#include <stdio.h>
+#include <stdlib.h>
+
+/*! \var BenchCases
+ *  \brief Number of cases in the batch each evaluator runs.
+ */
+static const int BenchCases = 200;
+
+/*! \var BenchOutputs
+ *  \brief Number of outputs of each case.
+ */
+static const int BenchOutputs = 2;
+
+/*! \var BenchMaxThreads
+ *  \brief Maximum number of worker threads.
+ */
+static const int BenchMaxThreads = 64;
+
+//------------------------------------------------------------------------------
+/*! \class BenchThread bpenginebench.cpp
+ *
+ *  \brief Runs one evaluator through the batch and the benchmark.
+ */
+
+class BenchThread : public QThread
+{
+// Public methods
+public:
+    BenchThread( BpEngine *engine, int calls ) ;
+    ~BenchThread( void ) ;
+    void work( void ) ;
+
+// Protected methods
+protected:
+    virtual void run( void ) ;
+
+// Public data
+public:
+    BpEngine *m_engine;     //!< Shared engine
+    int       m_calls;      //!< Number of bpEvaluatorBenchmark() calls
+    int       m_status;     //!< BpEngineStatus of the first failure
+    double    m_ns;         //!< Nanoseconds per cached get, or -1
+    double   *m_out;        //!< BenchCases * BenchOutputs outputs
+};
+
+//------------------------------------------------------------------------------
+/*! \brief BenchThread constructor.
+ */
+
+BenchThread::BenchThread( BpEngine *engine, int calls ) :
+    QThread(),
+    m_engine( engine ),
+    m_calls( calls ),
+    m_status( BpEngineOk ),
+    m_ns( -1. ),
+    m_out( 0 )
+{
+    m_out = new double[ BenchCases * BenchOutputs ];
+    checkmem( __FILE__, __LINE__, m_out, "double m_out",
+        BenchCases * BenchOutputs );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief BenchThread destructor.
+ */
+
+BenchThread::~BenchThread( void )
+{
+    delete[] m_out;     m_out = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Thread entry point.
+ */
+
+void BenchThread::run( void )
+{
+    work();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Creates and configures an evaluator, runs the batch of cases
+ *  into m_out[], and then benchmarks the evaluator.
+ */
+
+void BenchThread::work( void )
+{
+    BpEvaluator *eval = bpEvaluatorCreate( m_engine );
+    if ( ! eval )
+    {
+        m_status = BpEngineBadHandle;
+        return;
+    }
+    int in[2];
+    in[0] = bpEngineVarIndex( m_engine, "vWindSpeedAtMidflame" );
+    in[1] = bpEngineVarIndex( m_engine, "vSurfaceFuelMoisDead1" );
+    int out[BenchOutputs];
+    out[0] = bpEngineVarIndex( m_engine, "vSurfaceFireSpreadAtHead" );
+    out[1] = bpEngineVarIndex( m_engine, "vContainSize" );
+    // Surface fire spread feeds a multiple resource containment simulation
+    static const char *Property[][2] =
+    {
+        { "surfaceModuleActive",          "true"  },
+        { "containModuleActive",          "true"  },
+        { "containConfResourcesMultiple", "true"  },
+        { "containConfResourcesSingle",   "false" }
+    };
+    int i;
+    for ( i = 0;
+          m_status == BpEngineOk && i < 4;
+          i++ )
+    {
+        m_status = bpEvaluatorSetProperty( eval, Property[i][0],
+            Property[i][1] );
+    }
+    if ( m_status == BpEngineOk )
+    {
+        m_status = bpEvaluatorConfigure( eval );
+    }
+    // Two resources: names, arrival (min), duration (min), and
+    // productivity (ch/h)
+    static const char *Store[][2] =
+    {
+        { "vContainResourceName",     "Engine Crew" },
+        { "vContainResourceArrival",  "30 90"       },
+        { "vContainResourceDuration", "480 480"     },
+        { "vContainResourceProd",     "8 20"        }
+    };
+    for ( i = 0;
+          m_status == BpEngineOk && i < 4;
+          i++ )
+    {
+        m_status = bpEvaluatorSetStore( eval,
+            bpEngineVarIndex( m_engine, Store[i][0] ), Store[i][1] );
+    }
+    if ( m_status == BpEngineOk )
+    {
+        m_status = bpEvaluatorSetValueByName( eval, "vContainReportSize",
+            1. );
+    }
+    // Vary wind speed fastest so most cases leave the moisture consumers clean
+    double *value = new double[ 2 * BenchCases ];
+    checkmem( __FILE__, __LINE__, value, "double value", 2 * BenchCases );
+    int c;
+    for ( c = 0;
+          c < BenchCases;
+          c++ )
+    {
+        value[ 2 * c ]     = 0.5 * (double) ( c % 20 );
+        value[ 2 * c + 1 ] = 3. + (double) ( c / 20 );
+    }
+    if ( m_status == BpEngineOk )
+    {
+        m_status = bpEvaluatorRun( eval, BenchCases, 2, in, value,
+            BenchOutputs, out, m_out );
+    }
+    if ( m_status == BpEngineOk )
+    {
+        m_ns = bpEvaluatorBenchmark( eval, in[0], out[0], m_calls );
+    }
+    delete[] value;
+    bpEvaluatorDestroy( eval );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Main driver.
+ */
+
+int main( int argc, char **argv )
+{
+    if ( argc < 2 )
+    {
+        fprintf( stderr, "Usage: %s xmlFile [threads [calls]]\n", argv[0] );
+        return( 1 );
+    }
+    int threads = ( argc > 2 ) ? atoi( argv[2] ) : 4;
+    int calls   = ( argc > 3 ) ? atoi( argv[3] ) : 100000;
+    if ( threads < 1 || threads > BenchMaxThreads || calls < 1 )
+    {
+        fprintf( stderr, "%s: threads must be 1-%d and calls positive.\n",
+            argv[0], BenchMaxThreads );
+        return( 1 );
+    }
+    logOpen( "bpenginebench.log" );
+    BpEngine *engine = bpEngineCreate( argv[1] );
+    if ( ! engine )
+    {
+        fprintf( stderr, "%s: unable to load \"%s\".\n", argv[0], argv[1] );
+        logClose();
+        return( 1 );
+    }
+    // Reference batch on this thread
+    BenchThread reference( engine, calls );
+    reference.work();
+    if ( reference.m_status != BpEngineOk )
+    {
+        fprintf( stderr, "%s: reference evaluator failed with status %d.\n",
+            argv[0], reference.m_status );
+        bpEngineDestroy( engine );
+        logClose();
+        return( 1 );
+    }
+    fprintf( stdout, "Reference: %.2f ns per cached get.\n", reference.m_ns );
+
+    // Same batch and benchmark on all the worker threads at once
+    BenchThread *worker[ BenchMaxThreads ];
+    int t, c;
+    for ( t = 0;
+          t < threads;
+          t++ )
+    {
+        worker[t] = new BenchThread( engine, calls );
+        checkmem( __FILE__, __LINE__, worker[t], "BenchThread worker", 1 );
+    }
+    for ( t = 0;
+          t < threads;
+          t++ )
+    {
+        worker[t]->start();
+    }
+    int failed = 0;
+    for ( t = 0;
+          t < threads;
+          t++ )
+    {
+        worker[t]->wait();
+        int diffs = 0;
+        if ( worker[t]->m_status == BpEngineOk )
+        {
+            for ( c = 0;
+                  c < BenchCases * BenchOutputs;
+                  c++ )
+            {
+                if ( worker[t]->m_out[c] != reference.m_out[c] )
+                {
+                    diffs++;
+                }
+            }
+        }
+        fprintf( stdout, "Thread %d: status %d, %d of %d outputs differ, "
+            "%.2f ns per cached get.\n",
+            t, worker[t]->m_status, diffs, BenchCases * BenchOutputs,
+            worker[t]->m_ns );
+        if ( worker[t]->m_status != BpEngineOk || diffs )
+        {
+            failed++;
+        }
+        delete worker[t];
+    }
+    bpEngineDestroy( engine );
+    logClose();
+    return( failed ? 1 : 0 );
+}
+
+//------------------------------------------------------------------------------
+//  End of bpenginebench.cpp
+//------------------------------------------------------------------------------
@@ -26,26 +26,45 @@
 #include "appdialog.h"
 #include "appfilesystem.h"
 #include "appmessage.h"
+#include "appsiunits.h"
 #include "apptranslator.h"
 #include "appwindow.h"
 #include "bpdocentry.h"
 #include "bpdocument.h"
 #include "docscrollview.h"
 #include "fileselector.h"
+#include "fuelcalib.h"
 #include "fuelexportdialog.h"
+#include "fuelinitdialog.h"
 #include "fuelmodel.h"
 #include "parser.h"
 #include "property.h"
+#include "requestdialog.h"
+#include "terraingrid.h"
 #include "xeqapp.h"
 #include "xeqcalc.h"
 #include "xeqtree.h"
 #include "xeqvar.h"
 
 // Qt include files
+#include <qapplication.h>
+#include <qdatetime.h>
 #include <qdir.h>
 #include <qfiledialog.h>
 #include <qfileinfo.h>
 #include <qimage.h>
+#include <qstringlist.h>
+#include <qtimer.h>
+
+// Standard include files
+#include <math.h>
+
+/*! \def M_PI
+ *  \brief Some compilers don't define this.
+ */
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
 
 //------------------------------------------------------------------------------
 /*! \brief Captures the current display page to an image file.
@@ -101,6 +120,12 @@ bool BpDocument::capture( void )
     // Save the file
     QImageIO iio;
     QImage   image;
+    if ( m_renderTimer->isActive() )
+    {
+        // Replace the stretched page left by rescale()
+        m_renderTimer->stop();
+        renderPage();
+    }
     image = m_scrollView->m_backingPixmap;
     iio.setImage( image );
     iio.setFileName( fileName );
@@ -117,6 +142,280 @@ bool BpDocument::capture( void )
     return( true );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Calibrates a fuel model to a file of observed spread rates and
+ *  flame lengths and saves it to a fuel model file.
+ *
+ *  The user selects the starting fuel model from a FuelInitDialog.
+ *  The fitted parameters and error are displayed, and if the user accepts
+ *  them a FileSaveAsDialog requests the new fuel model file name.
+ *  The new fuel model file is then written and attached.
+ *
+ *  The calibration is performed by FuelCalib, which does not use
+ *  this document's EqTree, so the worksheet is unchanged.
+ *
+ *  Called only by AppWindow::slotDocumentCalibrateFuelModel().
+ *
+ *  \param obsFile Name of the FuelCalib observation file.
+ */
+
+void BpDocument::calibrateFuelModel( const QString &obsFile )
+{
+    // Read the observations.
+    QString text("");
+    FuelCalib calib;
+    if ( ! calib.read( obsFile, text ) )
+    {
+        error( text );
+        return;
+    }
+    // Request the starting fuel model from the user.
+    FuelInitDialog dialog( this, "fuelInitDialog" );
+    if ( dialog.exec() != QDialog::Accepted )
+    {
+        return;
+    }
+    QString name("");
+    dialog.resultString( name );
+    FuelModel *fm = m_eqApp->m_fuelModelList->fuelModelByModelName( name );
+    if ( ! fm )
+    // This code block should never be executed!
+    {
+        translate( text, "BpDocument:FuelModelNotFound", name );
+        bomb( text );
+        return;
+    }
+    // Fit the fuel model.
+    calib.setFuelModel( *fm );
+    QApplication::setOverrideCursor( Qt::waitCursor );
+    int iterations = calib.calibrate();
+    QApplication::restoreOverrideCursor();
+
+    // Display the results and ask whether to save them.
+    FuelModel fitted( *fm );
+    calib.fuelModel( fitted );
+    QString caption(""), title(""), summary("");
+    translate( caption, "BpDocument:CalibrateFuelModel:Caption" );
+    translate( title, "BpDocument:CalibrateFuelModel:Title", fm->m_name );
+    fitted.formatHtmlTable( title, text );
+    translate( summary, "BpDocument:CalibrateFuelModel:Summary",
+        QString( "%1" ).arg( calib.m_obs ),
+        QString( "%1" ).arg( calib.m_resids ),
+        QString( "%1" ).arg( iterations ),
+        QString( "%1" ).arg( 100. * calib.m_rmse0, 0, 'f', 1 ),
+        QString( "%1" ).arg( 100. * calib.m_rmse, 0, 'f', 1 ) );
+    text += summary;
+    if ( ! yesno( caption, text, 400 ) )
+    {
+        return;
+    }
+    // Request the new fuel model file name.
+    QString fileName("");
+    QString desc("");
+    translate( desc, "BpDocument:CalibrateFuelModel:Desc", fm->m_name,
+        QFileInfo( obsFile ).fileName() );
+    FileSaveAsDialog saveDialog(
+        appWindow(),                            // ApplicationWindow
+        appFileSystem()->fuelModelPath(),       // subdirectory
+        "Fuel Model",                           // file type name
+        appFileSystem()->fuelModelExt(),        // file extension
+        "MyFuelModels",                         // default folder
+        "",                                     // default file name
+        desc,                                   // default description
+        "calibrateFuelModelDialog" );           // widget name
+    if ( saveDialog.exec() != QDialog::Accepted )
+    {
+        return;
+    }
+    saveDialog.getFileSelection( fileName );
+    saveDialog.getFileDescription( desc );
+
+    // Write and attach the new fuel model file.
+    if ( ! calib.writeBpf( fileName, desc, appWindow()->m_release ) )
+    {
+        translate( text, "EqTree:WriteXmlFile:NoOpen",
+            "BehavePlus", "Fuel Model", fileName );
+        warn( text );
+        return;
+    }
+    m_eqApp->attachFuelModel( fileName );
+    translate( text, "BpDocument:SaveFuelModel:Saved", fileName );
+    info( text );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the worksheet site terrain inputs from an elevation grid.
+ *
+ *  The user enters the map coordinates of the site and the grid's units
+ *  (m or ft) in a RequestDialog.  A TerrainGrid then derives the slope,
+ *  aspect, and ridge-to-valley rasters from the grid, and the values at the
+ *  site's cell are stored into whichever of the site slope, aspect,
+ *  elevation, and ridge-to-valley inputs currently appear on the worksheet.
+ *  The ridge-to-valley window extends about one mile from the site.
+ *
+ *  Called only by AppWindow::slotDocumentTerrainGrid().
+ *
+ *  \param gridFile Name of the ESRI ASCII elevation grid file.
+ */
+
+void BpDocument::applyTerrainGrid( const QString &gridFile )
+{
+    // Read the elevation grid.
+    QString text("");
+    TerrainGrid grid;
+    QApplication::setOverrideCursor( Qt::waitCursor );
+    bool ok = grid.read( gridFile, text );
+    QApplication::restoreOverrideCursor();
+    if ( ! ok )
+    {
+        error( text );
+        return;
+    }
+    // Request the site location and grid units.
+    double xMax = grid.m_xll + grid.m_cols * grid.m_cellSize;
+    double yMax = grid.m_yll + grid.m_rows * grid.m_cellSize;
+    QString prompt(""), initVal("");
+    translate( prompt, "BpDocument:TerrainGrid:Prompt",
+        QString( "%1" ).arg( grid.m_xll, 0, 'f', 0 ),
+        QString( "%1" ).arg( xMax, 0, 'f', 0 ),
+        QString( "%1" ).arg( grid.m_yll, 0, 'f', 0 ),
+        QString( "%1" ).arg( yMax, 0, 'f', 0 ) );
+    initVal = QString( "%1 %2 m" )
+        .arg( 0.5 * ( grid.m_xll + xMax ), 0, 'f', 0 )
+        .arg( 0.5 * ( grid.m_yll + yMax ), 0, 'f', 0 );
+    RequestDialog request( prompt, initVal, "slopeMapMeasurements.html",
+        this, "terrainGridRequest" );
+    if ( request.exec() != QDialog::Accepted )
+    {
+        return;
+    }
+    QString reply("");
+    request.text( reply );
+    QStringList tokens = QStringList::split( " ", reply.simplifyWhiteSpace() );
+    bool xOk = false;
+    bool yOk = false;
+    double x = 0.;
+    double y = 0.;
+    if ( tokens.count() == 3 )
+    {
+        x = tokens[0].toDouble( &xOk );
+        y = tokens[1].toDouble( &yOk );
+    }
+    if ( ! xOk || ! yOk || ( tokens[2] != "m" && tokens[2] != "ft" ) )
+    {
+        translate( text, "BpDocument:TerrainGrid:BadRequest", reply );
+        warn( text );
+        return;
+    }
+    int row, col;
+    if ( ! grid.cell( x, y, &row, &col ) || grid.isNoData( row, col ) )
+    {
+        translate( text, "BpDocument:TerrainGrid:OffGrid", tokens[0],
+            tokens[1], QFileInfo( gridFile ).fileName() );
+        warn( text );
+        return;
+    }
+    double ftPerUnit = ( tokens[2] == "m" ) ? 3.2808399 : 1.;
+
+    // Derive the terrain rasters.
+    QApplication::setOverrideCursor( Qt::waitCursor );
+    QTime timer;
+    timer.start();
+    grid.compute( (int) ceil( 5280. / ( ftPerUnit * grid.m_cellSize ) ) );
+    int elapsed = timer.elapsed();
+    double aspectDiff;
+    double slopeDiff = grid.check( &aspectDiff );
+    QApplication::restoreOverrideCursor();
+    log( QString( "Terrain grid \"%1\": %2 rows x %3 cols (%4 without data) "
+        "derived in %5 ms; edge and interior scalar check max slope diff %6, "
+        "aspect diff %7 deg.\n" )
+        .arg( gridFile )
+        .arg( grid.m_rows )
+        .arg( grid.m_cols )
+        .arg( grid.m_noDataCells )
+        .arg( elapsed )
+        .arg( slopeDiff )
+        .arg( aspectDiff ) );
+
+    // The site needs a slope and aspect, which a cell next to a missing
+    // elevation does not have.
+    int cell = row * grid.m_cols + col;
+    if ( grid.m_slope[cell] == grid.m_noData )
+    {
+        translate( text, "BpDocument:TerrainGrid:NoSlope", tokens[0],
+            tokens[1], QFileInfo( gridFile ).fileName() );
+        warn( text );
+        return;
+    }
+
+    // Site values in native units
+    EqCalc *eqCalc = m_eqTree->m_eqCalc;
+    double slope = grid.m_slope[cell];
+    const int Vars = 6;
+    EqVar *var[Vars] =
+    {
+        eqCalc->vSiteSlopeFraction,
+        eqCalc->vSiteSlopeDegrees,
+        eqCalc->vSiteAspectDirFromNorth,
+        eqCalc->vSiteElevation,
+        eqCalc->vSiteRidgeToValleyElev,
+        eqCalc->vSiteRidgeToValleyDist
+    };
+    double value[Vars] =
+    {
+        slope,
+        atan( slope ) * 180. / M_PI,
+        grid.m_aspect[cell],
+        ftPerUnit * grid.m_elev[cell],
+        ftPerUnit * grid.m_rvElev[cell],
+        ftPerUnit * grid.m_rvDist[cell] / 5280.
+    };
+    // Store them into the worksheet inputs.
+    QString qStr(""), list("");
+    double displayValue;
+    int lid, tokenCount, position, length;
+    for ( int id = 0;
+          id < Vars;
+          id++ )
+    {
+        for ( lid = 1;
+              lid < leafCount();
+              lid++ )
+        {
+            if ( leaf( lid ) == var[id] )
+            {
+                break;
+            }
+        }
+        if ( lid >= leafCount() )
+        {
+            continue;
+        }
+        displayValue = value[id];
+        appSiUnits()->convert( value[id], var[id]->m_nativeUnits.latin1(),
+            var[id]->m_displayUnits.latin1(), &displayValue );
+        qStr = QString( "%1" )
+            .arg( displayValue, 0, 'f', var[id]->m_displayDecimals );
+        m_entry[lid]->setText( qStr );
+        validateWorksheetEntry( lid, qStr, &tokenCount, &position, &length );
+        list += QString( "<tr><td>%1</td><td>%2 %3</td></tr>" )
+            .arg( *(var[id]->m_label) )
+            .arg( qStr )
+            .arg( var[id]->m_displayUnits );
+    }
+    if ( list.isEmpty() )
+    {
+        translate( text, "BpDocument:TerrainGrid:NoInputs" );
+        warn( text );
+        return;
+    }
+    translate( text, "BpDocument:TerrainGrid:Applied", tokens[0], tokens[1],
+        QFileInfo( gridFile ).fileName() );
+    info( text + "<table>" + list + "</table>" );
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Opens and displays a BpDocument file.
  *
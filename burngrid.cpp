@@ -0,0 +1,418 @@
+//------------------------------------------------------------------------------
+/*! \file burngrid.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief BurnGrid class methods.
+ */
+
+// Custom include files
+#include "appmessage.h"
+#include "apptranslator.h"
+#include "burngrid.h"
+
+// Standard include files
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+
+/*! \var BurnDegToRad
+ *  \brief Degrees to radians conversion factor.
+ */
+static const double BurnDegToRad = 0.017453292519943295;
+
+//------------------------------------------------------------------------------
+/*! \brief BurnGrid constructor.
+ */
+
+BurnGrid::BurnGrid( void ) :
+    m_rows(0),
+    m_cols(0),
+    m_xll(0.),
+    m_yll(0.),
+    m_cellSize(0.),
+    m_x(0.),
+    m_y(0.),
+    m_units("m"),
+    m_noData(-9999.),
+    m_shapes(0),
+    m_timed(0),
+    m_hits(0),
+    m_timeSum(0),
+    m_finished(false)
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief BurnGrid destructor.
+ */
+
+BurnGrid::~BurnGrid( void )
+{
+    freeRasters();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Adds one elliptical fire shape ignited at the grid's ignition
+ *  point.
+ *
+ *  Shapes with no length or width still count as ensemble members that
+ *  burn no cells.
+ *
+ *  \param head         Forward spread distance (map units).
+ *  \param back         Backing spread distance (map units).
+ *  \param width        Maximum fire width (map units).
+ *  \param dirFromNorth Direction of maximum spread (degrees clockwise from
+ *                      grid north).
+ *  \param elapsed      Elapsed time since ignition, or 0 if unknown.
+ */
+
+void BurnGrid::addEllipse( double head, double back, double width,
+        double dirFromNorth, double elapsed )
+{
+    if ( ! m_hits || m_finished )
+    {
+        return;
+    }
+    m_shapes++;
+    // Arrival times are only kept while every shape has an elapsed time
+    bool timed = ( elapsed > 0. && m_timed == m_shapes - 1 );
+    if ( timed )
+    {
+        m_timed++;
+        if ( ! m_timeSum )
+        {
+            int i;
+            int n = m_rows * m_cols;
+            m_timeSum = new double[ n ];
+            checkmem( __FILE__, __LINE__, m_timeSum, "double m_timeSum", n );
+            for ( i = 0;
+                  i < n;
+                  i++ )
+            {
+                m_timeSum[i] = 0.;
+            }
+        }
+    }
+    else if ( m_timeSum )
+    {
+        delete[] m_timeSum; m_timeSum = 0;
+    }
+    // Semi-axes and center offset along the direction of maximum spread
+    double a = 0.5 * ( head + back );
+    double b = 0.5 * width;
+    if ( a <= 0. || b <= 0. )
+    {
+        return;
+    }
+    double c   = 0.5 * ( head - back );
+    double sn  = sin( dirFromNorth * BurnDegToRad );
+    double co  = cos( dirFromNorth * BurnDegToRad );
+    double xc  = m_x + c * sn;
+    double yc  = m_y + c * co;
+    double ia2 = 1. / ( a * a );
+    double ib2 = 1. / ( b * b );
+
+    // Rows whose centers lie within the ellipse's north-south extent
+    double yTop = m_yll + m_rows * m_cellSize;
+    double half = sqrt( a * a * co * co + b * b * sn * sn );
+    double r0 = ceil( ( yTop - ( yc + half ) ) / m_cellSize - 0.5 );
+    double r1 = floor( ( yTop - ( yc - half ) ) / m_cellSize - 0.5 );
+    if ( r1 < 0. || r0 > m_rows - 1 )
+    {
+        return;
+    }
+    int rowBeg = ( r0 < 0. ) ? 0 : (int) r0;
+    int rowEnd = ( r1 > m_rows - 1 ) ? m_rows - 1 : (int) r1;
+
+    // The ellipse about its center is P dx^2 + 2 R dx + S <= 0 for each
+    // row, with R linear and S quadratic in the row's offset dy.
+    double p  = sn * sn * ia2 + co * co * ib2;
+    double rk = sn * co * ( ia2 - ib2 );
+    double sk = co * co * ia2 + sn * sn * ib2;
+
+    // Arrival fraction s solves A s^2 + 2 B s - Q = 0, where B = u c / a^2
+    // and Q = u^2 / a^2 + v^2 / b^2 for ignition-relative coordinates u
+    // along and v across the direction of maximum spread.
+    double aq = 1. - c * c * ia2;
+    double iA = ( aq > 0. ) ? 1. / aq : DBL_MAX;
+    double cb = c * ia2;
+    double du = m_cellSize * sn;
+    double dv = m_cellSize * co;
+
+    int row, col, colBeg, colEnd;
+    int *hits;
+    double *sum;
+    double y, dy, r, disc, root, c0, c1, x, u, v, q, bb, s;
+    for ( row = rowBeg;
+          row <= rowEnd;
+          row++ )
+    {
+        // Span of cell centers inside the ellipse on this row
+        y = yTop - ( row + 0.5 ) * m_cellSize;
+        dy = y - yc;
+        r = dy * rk;
+        disc = r * r - p * ( dy * dy * sk - 1. );
+        if ( disc < 0. )
+        {
+            continue;
+        }
+        root = sqrt( disc );
+        c0 = ceil( ( xc + ( -r - root ) / p - m_xll ) / m_cellSize - 0.5 );
+        c1 = floor( ( xc + ( -r + root ) / p - m_xll ) / m_cellSize - 0.5 );
+        if ( c1 < 0. || c0 > m_cols - 1 || c0 > c1 )
+        {
+            continue;
+        }
+        colBeg = ( c0 < 0. ) ? 0 : (int) c0;
+        colEnd = ( c1 > m_cols - 1 ) ? m_cols - 1 : (int) c1;
+        hits = m_hits + row * ( m_cols + 1 );
+        hits[colBeg]++;
+        hits[colEnd+1]--;
+        if ( ! timed )
+        {
+            continue;
+        }
+        // Step the ignition-relative coordinates across the span
+        x = m_xll + ( colBeg + 0.5 ) * m_cellSize - m_x;
+        u = x * sn + ( y - m_y ) * co;
+        v = x * co - ( y - m_y ) * sn;
+        sum = m_timeSum + row * m_cols;
+        for ( col = colBeg;
+              col <= colEnd;
+              col++ )
+        {
+            q = u * u * ia2 + v * v * ib2;
+            bb = u * cb;
+            root = sqrt( bb * bb + aq * q );
+            s = ( bb >= 0. ) ? q / ( bb + root + DBL_MIN ) : ( root - bb ) * iA;
+            sum[col] += elapsed * ( ( s < 1. ) ? s : 1. );
+            u += du;
+            v += dv;
+        }
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the mean fire arrival time at a cell.
+ *
+ *  finish() must have been called.
+ *
+ *  \param row Cell row.
+ *  \param col Cell column.
+ *
+ *  \return Mean arrival time over the shapes that reach the cell (elapsed
+ *  time units), or m_noData if no shape reaches it or any shape was added
+ *  without an elapsed time.
+ */
+
+double BurnGrid::arrival( int row, int col ) const
+{
+    if ( ! m_finished || ! m_timeSum || m_timed < m_shapes )
+    {
+        return( m_noData );
+    }
+    int hits = m_hits[ row * ( m_cols + 1 ) + col ];
+    if ( hits <= 0 )
+    {
+        return( m_noData );
+    }
+    return( m_timeSum[ row * m_cols + col ] / (double) hits );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Converts the per-row difference arrays into hit counts.
+ *
+ *  Must be called after the last addEllipse().  Repeated calls do nothing.
+ */
+
+void BurnGrid::finish( void )
+{
+    if ( ! m_hits || m_finished )
+    {
+        return;
+    }
+    int *hits;
+    int row, col;
+    for ( row = 0;
+          row < m_rows;
+          row++ )
+    {
+        hits = m_hits + row * ( m_cols + 1 );
+        for ( col = 1;
+              col < m_cols;
+              col++ )
+        {
+            hits[col] += hits[col-1];
+        }
+    }
+    m_finished = true;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Frees all the raster arrays.
+ */
+
+void BurnGrid::freeRasters( void )
+{
+    delete[] m_hits;    m_hits = 0;
+    delete[] m_timeSum; m_timeSum = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets up an empty grid centered on the ignition point.
+ *
+ *  Only the hit counts are allocated here; addEllipse() allocates the
+ *  arrival time sums when the first shape with an elapsed time is added.
+ *
+ *  \param x        Ignition point X coordinate (map units).
+ *  \param y        Ignition point Y coordinate (map units).
+ *  \param cellSize Cell size (map units).
+ *  \param rows     Number of grid rows.
+ *  \param cols     Number of grid columns.
+ */
+
+void BurnGrid::init( double x, double y, double cellSize, int rows, int cols )
+{
+    freeRasters();
+    m_rows     = rows;
+    m_cols     = cols;
+    m_cellSize = cellSize;
+    m_x        = x;
+    m_y        = y;
+    m_xll      = x - 0.5 * cols * cellSize;
+    m_yll      = y - 0.5 * rows * cellSize;
+    m_shapes   = 0;
+    m_timed    = 0;
+    m_finished = false;
+
+    int i;
+    int n = rows * ( cols + 1 );
+    m_hits = new int[ n ];
+    checkmem( __FILE__, __LINE__, m_hits, "int m_hits", n );
+    for ( i = 0;
+          i < n;
+          i++ )
+    {
+        m_hits[i] = 0;
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets the burn probability of a cell.
+ *
+ *  finish() must have been called.
+ *
+ *  \param row Cell row.
+ *  \param col Cell column.
+ *
+ *  \return Fraction of the shapes that contain the cell center.
+ */
+
+double BurnGrid::probability( int row, int col ) const
+{
+    if ( ! m_finished || m_shapes <= 0 )
+    {
+        return( 0. );
+    }
+    return( (double) m_hits[ row * ( m_cols + 1 ) + col ]
+          / (double) m_shapes );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Writes the burn probability grid and, if every shape had an
+ *  elapsed time, the mean arrival time grid as ESRI ASCII grid files.
+ *
+ *  \param probFile Name of the burn probability grid file.
+ *  \param timeFile Name of the mean arrival time grid file, or empty.
+ *  \param errMsg   Reference to a string to hold any error message.
+ *
+ *  \return TRUE on success, FALSE on error (and \a errMsg is set).
+ */
+
+bool BurnGrid::write( const QString &probFile, const QString &timeFile,
+        QString &errMsg )
+{
+    errMsg = "";
+    finish();
+    if ( ! writeGrid( probFile, false, errMsg ) )
+    {
+        return( false );
+    }
+    if ( ! timeFile.isEmpty()
+      && m_timed > 0
+      && m_timed == m_shapes )
+    {
+        return( writeGrid( timeFile, true, errMsg ) );
+    }
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Writes one of the grids as an ESRI ASCII grid file.
+ *
+ *  \param fileName Name of the grid file.
+ *  \param times    If TRUE, writes the mean arrival times, otherwise the
+ *                  burn probabilities.
+ *  \param errMsg   Reference to a string to hold any error message.
+ *
+ *  \return TRUE on success, FALSE on error (and \a errMsg is set).
+ */
+
+bool BurnGrid::writeGrid( const QString &fileName, bool times,
+        QString &errMsg ) const
+{
+    FILE *fptr = fopen( fileName.latin1(), "w" );
+    if ( ! fptr )
+    {
+        translate( errMsg, "BurnGrid:NoOpen", fileName );
+        return( false );
+    }
+    fprintf( fptr,
+        "ncols         %d\n"
+        "nrows         %d\n"
+        "xllcorner     %.6f\n"
+        "yllcorner     %.6f\n"
+        "cellsize      %.6f\n"
+        "NODATA_value  %.0f\n",
+        m_cols, m_rows, m_xll, m_yll, m_cellSize, m_noData );
+    int row, col;
+    for ( row = 0;
+          row < m_rows;
+          row++ )
+    {
+        for ( col = 0;
+              col < m_cols;
+              col++ )
+        {
+            if ( times )
+            {
+                fprintf( fptr, ( col ) ? " %.1f" : "%.1f",
+                    arrival( row, col ) );
+            }
+            else
+            {
+                fprintf( fptr, ( col ) ? " %.4g" : "%.4g",
+                    probability( row, col ) );
+            }
+        }
+        fprintf( fptr, "\n" );
+    }
+    bool ok = ( ! ferror( fptr ) );
+    if ( fclose( fptr ) != 0 || ! ok )
+    {
+        translate( errMsg, "BurnGrid:WriteError", fileName );
+        return( false );
+    }
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+//  End of burngrid.cpp
+//------------------------------------------------------------------------------
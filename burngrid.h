@@ -0,0 +1,106 @@
+//------------------------------------------------------------------------------
+/*! \file burngrid.h
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief BurnGrid class declaration.
+ *
+ *  A BurnGrid accumulates an ensemble of elliptical fire shapes, all
+ *  ignited at the same map location, into a map-unit grid centered on the
+ *  ignition point.  After all the shapes are added it yields
+ *      -# the burn probability of each cell, which is the fraction of the
+ *         shapes whose perimeter contains the cell center, and
+ *      -# the mean fire arrival time at each cell over the shapes that
+ *         reach it.
+ *
+ *  Each shape is the Size Module's ellipse: its head and back spread
+ *  distances lie along the direction of maximum spread, and it grows in
+ *  proportion to elapsed time about the ignition point.  A cell at fraction
+ *  s of the way from the ignition point to the perimeter is therefore
+ *  reached at s times the shape's elapsed time.
+ *
+ *  Shapes are rasterized one scanline (grid row) at a time.  The span of
+ *  cell centers inside the ellipse is found directly from the ellipse's
+ *  quadratic, and the hit is recorded by incrementing the span's first
+ *  cell and decrementing the cell just past its end in a per-row
+ *  difference array.  Adding a shape therefore costs one square root per
+ *  row however large the shape is, and finish() recovers the hit counts
+ *  with one running sum per row.  Arrival times must be accumulated cell
+ *  by cell; the inner loop steps the ignition-relative coordinates
+ *  incrementally across the span without branches on the cell position.
+ */
+
+#ifndef _BURNGRID_H_
+/*! \def _BURNGRID_H_
+ *  \brief Prevent redundant includes.
+ */
+#define _BURNGRID_H_ 1
+
+// Qt include files
+#include <qstring.h>
+
+/*! \var BurnGridMaxCells
+ *  \brief Maximum number of grid rows or columns.
+ */
+static const int BurnGridMaxCells = 5000;
+
+/*! \var BurnGridMaxTotal
+ *  \brief Maximum number of grid cells (rows times columns).
+ *
+ *  Each cell needs an int hit count and, if the elapsed time is an input,
+ *  a double arrival time sum, so the largest grid takes about 48 MB.
+ */
+static const int BurnGridMaxTotal = 4000000;
+
+//------------------------------------------------------------------------------
+/*! \class BurnGrid burngrid.h
+ *
+ *  \brief Burn probability and mean arrival time grids from an ensemble of
+ *  elliptical fire shapes.
+ */
+
+class BurnGrid
+{
+// Public methods
+public:
+    BurnGrid( void ) ;
+    ~BurnGrid( void ) ;
+    void   addEllipse( double head, double back, double width,
+                double dirFromNorth, double elapsed ) ;
+    double arrival( int row, int col ) const ;
+    void   finish( void ) ;
+    void   init( double x, double y, double cellSize, int rows, int cols ) ;
+    double probability( int row, int col ) const ;
+    bool   write( const QString &probFile, const QString &timeFile,
+                QString &errMsg ) ;
+
+// Private methods
+private:
+    void   freeRasters( void ) ;
+    bool   writeGrid( const QString &fileName, bool times,
+                QString &errMsg ) const ;
+
+// Public data
+public:
+    int     m_rows;         //!< Number of grid rows (row 0 is the north edge)
+    int     m_cols;         //!< Number of grid columns (column 0 is the west edge)
+    double  m_xll;          //!< X coordinate of the lower left grid corner
+    double  m_yll;          //!< Y coordinate of the lower left grid corner
+    double  m_cellSize;     //!< Cell size (map units)
+    double  m_x;            //!< Ignition point X coordinate (map units)
+    double  m_y;            //!< Ignition point Y coordinate (map units)
+    QString m_units;        //!< Map units (m or ft)
+    double  m_noData;       //!< Value flagging cells without an arrival time
+    int     m_shapes;       //!< Number of shapes added
+    int     m_timed;        //!< Number of shapes added with an elapsed time
+    int    *m_hits;         //!< Row difference arrays, then hit counts
+    double *m_timeSum;      //!< Sum of arrival times (elapsed time units),
+                            //!< allocated by the first timed shape
+    bool    m_finished;     //!< TRUE once finish() has summed m_hits[]
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of burngrid.h
+//------------------------------------------------------------------------------
@@ -7,7 +7,10 @@
  */
 
 // Custom include files
+#include "appmessage.h"
+#include "apptranslator.h"
 #include "composer.h"
+#include "composerwriter.h"
 #include "graph.h"
 #include "platform.h"
 
@@ -20,8 +23,54 @@
 #include <qpainter.h>
 #include <qpalette.h>
 #include <qpen.h>
+#include <qpicture.h>
 #include <qpixmap.h>
 #include <qprinter.h>
+#include <qstringlist.h>
+
+// Standard include files
+#include <math.h>
+#include <string.h>
+
+/*! \var ComposerMagic
+ *  \brief Composer file signature (and format version) written by begin().
+ */
+static const char ComposerMagic[4] = { 'B', 'P', 'C', '2' };
+
+/*! \var ComposerCoordScale
+ *  \brief Number of coordinate units per inch for integer encoded coordinates.
+ */
+static const double ComposerCoordScale = 10000.;
+
+/*! \enum ComposerOp
+ *  \brief Composer file drawing command opcodes.
+ */
+enum ComposerOp
+{
+    OpAlignText=1,
+    OpBrush,
+    OpEllipse,
+    OpFill,
+    OpFont,
+    OpGraph,
+    OpLine,
+    OpPen,
+    OpPie,
+    OpPixmap,
+    OpPrinterOn,
+    OpRect,
+    OpRestore,
+    OpRotate,
+    OpRotateEllipse,
+    OpRotateLine,
+    OpRotateText,
+    OpRoundRect,
+    OpSave,
+    OpScreenOn,
+    OpText,
+    OpTranslate,
+    OpWrapText
+};
 
 //------------------------------------------------------------------------------
 /*! \brief Composer default constructor.
@@ -29,10 +78,28 @@
 
 Composer::Composer() :
     m_file(""),
-    m_stream(),
     m_xppi(72.0),
-    m_yppi(72.0)
+    m_yppi(72.0),
+    m_buf(0),
+    m_bufLen(0),
+    m_bufSize(0),
+    m_composing(false),
+    m_writer(0),
+    m_brushes(),
+    m_fonts(),
+    m_graphs(),
+    m_graphCount(0),
+    m_pens(),
+    m_pixmaps(),
+    m_strings(),
+    m_stringMap(),
+    m_verify(false),
+    m_verifyFailures(0),
+    m_legacyData(),
+    m_legacyBuf(),
+    m_legacy()
 {
+    m_graphs.setAutoDelete( true );
     return;
 }
 
@@ -42,57 +109,162 @@ Composer::Composer() :
 
 Composer::~Composer( void )
 {
-    if ( m_file.isOpen() )
+    if ( m_composing )
     {
-        m_file.close();
+        end();
     }
+    delete   m_writer;  m_writer = 0;
+    delete[] m_buf;     m_buf = 0;
     return;
 }
 
 //------------------------------------------------------------------------------
-/*! \brief Opens a composer file for writing.
+/*! \brief Starts composing a new page for a composer file.
+ *
+ *  The commands are accumulated in memory and handed to the ComposerWriter
+ *  by end(), which creates and writes the file off the GUI thread.  Any
+ *  failure to create or write it is reported by paint() or flush().
  *
  *  \param fileName Full path name to the output composer file.
  *
- *  \retval TRUE if the file was successfully opened for writing.
- *  \retval FALSE if the file could not be opened for writing.
+ *  \retval TRUE since the file itself is not created until end().
  */
 
 bool Composer::begin( const QString &fileName )
 {
-    // Make sure the composer was previously closed.
-    if ( ! m_file.name().isEmpty() && m_file.isOpen() )
+    // Make sure the previous page was finished.
+    if ( m_composing )
     {
         end();
     }
     m_file.setName( fileName );
+    m_composing = true;
 
-    // Open the composition file in overwrite mode.
-    if ( ! m_file.open( IO_WriteOnly ) )
+    // Start a new page buffer with the file signature, and also record the
+    // page in the original composer file format if it is to be verified.
+    m_bufLen = 0;
+    if ( m_verify )
     {
-        return( false );
+        m_legacyData = QByteArray();
+        m_legacyBuf.setBuffer( m_legacyData );
+        m_legacyBuf.open( IO_WriteOnly );
+        m_legacy.setDevice( &m_legacyBuf );
+    }
+    for ( int i = 0;
+          i < 4;
+          i++ )
+    {
+        putOp( ComposerMagic[i] );
     }
-
-    // Set the text stream device to this file and clear total pages.
-    m_stream.setDevice( &m_file );
     return( true );
 }
 
 //------------------------------------------------------------------------------
-/*! \brief Closes a composer file when finished writing.
+/*! \brief Discards all the brush, font, graph, pen, pixmap, and string
+ *  resources shared by the composer files.
  *
- *  \retval TRUE if the file was open and then closed.
- *  \retval FALSE if the file was already closed.
+ *  Must only be called after all this Composer's composer files have been
+ *  removed, since those files refer to the resources by their table index.
+ */
+
+void Composer::clearResources( void )
+{
+    m_brushes.clear();
+    m_fonts.clear();
+    m_graphs.clear();
+    m_graphCount = 0;
+    m_pens.clear();
+    m_pixmaps.clear();
+    m_strings.clear();
+    m_stringMap.clear();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Finishes composing a page, and queues the page buffer to be
+ *  written to its composer file by the background ComposerWriter.
+ *
+ *  If the page was also recorded in the original composer file format,
+ *  its replay is first checked by verifyPage().
+ *
+ *  \retval TRUE if a page was being composed and is now queued.
+ *  \retval FALSE if no page was being composed.
  */
 
 bool Composer::end( void )
 {
-    if ( m_file.isOpen() )
+    if ( ! m_composing )
+    {
+        return( false );
+    }
+    m_composing = false;
+    if ( m_verify )
+    {
+        m_legacy.unsetDevice();
+        m_legacyBuf.close();
+        if ( ! verifyPage() )
+        {
+            m_verifyFailures++;
+        }
+        m_legacyData = QByteArray();
+    }
+    char *data = new char[ m_bufLen ];
+    checkmem( __FILE__, __LINE__, data, "char data", m_bufLen );
+    memcpy( data, m_buf, m_bufLen );
+    if ( ! m_writer )
+    {
+        m_writer = new ComposerWriter();
+        checkmem( __FILE__, __LINE__, m_writer,
+            "ComposerWriter m_writer", 1 );
+    }
+    m_writer->write( m_file.name(), data, m_bufLen );
+    m_bufLen = 0;
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Waits until every finished page has been written to its file,
+ *  and warns if any could not be.
+ *
+ *  \retval TRUE if all the pages were written successfully.
+ *  \retval FALSE if any page could not be written.
+ */
+
+bool Composer::flush( void )
+{
+    QStringList failedFiles;
+    if ( m_writer && ! m_writer->flush( &failedFiles ) )
     {
-        m_file.close();
-        return( true );
+        writeError( failedFiles.join( "\n" ) );
+        return( false );
     }
-    return( false );
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Turns replay verification of subsequently composed pages on or off.
+ *
+ *  While on, begin() also records each page in the original composer file
+ *  format, and end() checks that both formats paint the same output (see
+ *  verifyPage()).  Must only be called between pages.
+ *
+ *  \param on If TRUE, verify each page composed from now on.
+ */
+
+void Composer::setVerify( bool on )
+{
+    m_verify = on;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Returns the number of composed pages that failed replay
+ *  verification since this Composer was created.
+ */
+
+int Composer::verifyFailures( void ) const
+{
+    return( m_verifyFailures );
 }
 
 //------------------------------------------------------------------------------
@@ -116,14 +288,19 @@ void Composer::makeFileName( int docId, int pageNo, QString &composerFile )
 }
 
 //------------------------------------------------------------------------------
-/*! \brief Sets the Composer's QBrush by writing its attributes to the file.
+/*! \brief Sets the Composer's QBrush by writing its resource index to the file.
  *
  * \param brush Reference to a QBrush whose properties are to be applied.
  */
 
 void Composer::brush( const QBrush &brush )
 {
-    m_stream << QString("brush") << brush;
+    if ( m_verify )
+    {
+        m_legacy << QString("brush") << brush;
+    }
+    putOp( OpBrush );
+    putUInt( internBrush( brush ) );
 }
 
 //------------------------------------------------------------------------------
@@ -135,7 +312,15 @@ void Composer::brush( const QBrush &brush )
 
 void Composer::ellipse( double x, double y, double w, double h )
 {
-    m_stream << QString("ellipse") << x << y << w << h;
+    if ( m_verify )
+    {
+        m_legacy << QString("ellipse") << x << y << w << h;
+    }
+    putOp( OpEllipse );
+    putCoord( x );
+    putCoord( y );
+    putCoord( w );
+    putCoord( h );
 }
 
 //------------------------------------------------------------------------------
@@ -154,22 +339,39 @@ void Composer::ellipse( double x, double y, double w, double h )
 void Composer::fill( double x, double y, double w, double h,
     const QBrush &brush  )
 {
-    m_stream << QString("fill") << x <<  y << w << h << brush;
+    if ( m_verify )
+    {
+        m_legacy << QString("fill") << x << y << w << h << brush;
+    }
+    putOp( OpFill );
+    putCoord( x );
+    putCoord( y );
+    putCoord( w );
+    putCoord( h );
+    putUInt( internBrush( brush ) );
 }
 
 //------------------------------------------------------------------------------
-/*! \brief Sets the Composer's QFont by writing its attributes to the file.
+/*! \brief Sets the Composer's QFont by writing its resource index to the file.
  *
  * \param font Reference to a QFont whose properties are to be applied.
  */
 
 void Composer::font( const QFont &font )
 {
-    m_stream << QString("font") << font;
+    if ( m_verify )
+    {
+        m_legacy << QString("font") << font;
+    }
+    putOp( OpFont );
+    putUInt( internFont( font ) );
 }
 
 //------------------------------------------------------------------------------
-/*! \brief Draws a serialized graph into the composer file.
+/*! \brief Draws a graph into the composer file.
+ *
+ *  A copy of the Graph is kept in the graph resource table,
+ *  so paint() need not deserialize it every time the page is drawn.
  *
  *  \param graph Reference to the Graph instance to be drawn.
  *  \param x, y Graph's upper left corner on the page (inches).
@@ -179,7 +381,111 @@ void Composer::font( const QFont &font )
 void Composer::graph( const Graph &graph, double x, double y, double w,
     double h )
 {
-    m_stream << QString("graph") << x << y << w << h << graph;
+    if ( m_verify )
+    {
+        m_legacy << QString("graph") << x << y << w << h << graph;
+    }
+    // Graph has no copy constructor, so copy it via its stream operators.
+    QByteArray data;
+    QDataStream out( data, IO_WriteOnly );
+    out << graph;
+    Graph *copy = new Graph();
+    checkmem( __FILE__, __LINE__, copy, "Graph copy", 1 );
+    QDataStream in( data, IO_ReadOnly );
+    in >> *copy;
+    if ( m_graphCount >= (int) m_graphs.size() )
+    {
+        m_graphs.resize( 2 * m_graphs.size() + 4 );
+    }
+    m_graphs.insert( m_graphCount, copy );
+
+    putOp( OpGraph );
+    putUInt( m_graphCount++ );
+    putCoord( x );
+    putCoord( y );
+    putCoord( w );
+    putCoord( h );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Returns the brush resource table index of \a brush,
+ *  adding it to the table if necessary.
+ */
+
+int Composer::internBrush( const QBrush &brush )
+{
+    int id;
+    for ( id = 0;
+          id < (int) m_brushes.size();
+          id++ )
+    {
+        if ( m_brushes[id] == brush )
+        {
+            return( id );
+        }
+    }
+    m_brushes.push_back( brush );
+    return( id );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Returns the font resource table index of \a font,
+ *  adding it to the table if necessary.
+ */
+
+int Composer::internFont( const QFont &font )
+{
+    int id;
+    for ( id = 0;
+          id < (int) m_fonts.size();
+          id++ )
+    {
+        if ( m_fonts[id] == font )
+        {
+            return( id );
+        }
+    }
+    m_fonts.push_back( font );
+    return( id );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Returns the pen resource table index of \a pen,
+ *  adding it to the table if necessary.
+ */
+
+int Composer::internPen( const QPen &pen )
+{
+    int id;
+    for ( id = 0;
+          id < (int) m_pens.size();
+          id++ )
+    {
+        if ( m_pens[id] == pen )
+        {
+            return( id );
+        }
+    }
+    m_pens.push_back( pen );
+    return( id );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Returns the string resource table index of \a text,
+ *  adding it to the table if necessary.
+ */
+
+int Composer::internString( const QString &text )
+{
+    QMap<QString,int>::ConstIterator it = m_stringMap.find( text );
+    if ( it != m_stringMap.end() )
+    {
+        return( it.data() );
+    }
+    int id = m_strings.size();
+    m_strings.push_back( text );
+    m_stringMap.insert( text, id );
+    return( id );
 }
 
 //------------------------------------------------------------------------------
@@ -192,18 +498,31 @@ void Composer::graph( const Graph &graph, double x, double y, double w,
 
 void Composer::line( double x0, double y0, double x1, double y1 )
 {
-    m_stream << QString("line") << x0 << y0 << x1 << y1;
+    if ( m_verify )
+    {
+        m_legacy << QString("line") << x0 << y0 << x1 << y1;
+    }
+    putOp( OpLine );
+    putCoord( x0 );
+    putCoord( y0 );
+    putCoord( x1 );
+    putCoord( y1 );
 }
 
 //------------------------------------------------------------------------------
-/*! \brief Sets the Composer's QPen by writing its attributes to the file.
+/*! \brief Sets the Composer's QPen by writing its resource index to the file.
  *
  * \param pen Reference to a QPen whose properties are to be applied.
  */
 
 void Composer::pen ( const QPen &pen )
 {
-    m_stream << QString("pen") << pen;
+    if ( m_verify )
+    {
+        m_legacy << QString("pen") << pen;
+    }
+    putOp( OpPen );
+    putUInt( internPen( pen ) );
 }
 
 //------------------------------------------------------------------------------
@@ -223,7 +542,17 @@ void Composer::pen ( const QPen &pen )
 
 void Composer::pie( double x, double y, double w, double h, int a, int l )
 {
-    m_stream << QString("pie") << x << y << w << h << a << l;
+    if ( m_verify )
+    {
+        m_legacy << QString("pie") << x << y << w << h << a << l;
+    }
+    putOp( OpPie );
+    putCoord( x );
+    putCoord( y );
+    putCoord( w );
+    putCoord( h );
+    putInt( a );
+    putInt( l );
 }
 
 //------------------------------------------------------------------------------
@@ -237,7 +566,31 @@ void Composer::pie( double x, double y, double w, double h, int a, int l )
 void Composer::pixmap( const QPixmap &pixmap, double x, double y, double w,
     double h )
 {
-    m_stream << QString("pixmap") << pixmap << x << y << w << h;
+    if ( m_verify )
+    {
+        m_legacy << QString("pixmap") << pixmap << x << y << w << h;
+    }
+    // Pixmaps are implicitly shared, so compare their serial numbers.
+    int id;
+    for ( id = 0;
+          id < (int) m_pixmaps.size();
+          id++ )
+    {
+        if ( m_pixmaps[id].serialNumber() == pixmap.serialNumber() )
+        {
+            break;
+        }
+    }
+    if ( id == (int) m_pixmaps.size() )
+    {
+        m_pixmaps.push_back( pixmap );
+    }
+    putOp( OpPixmap );
+    putUInt( id );
+    putCoord( x );
+    putCoord( y );
+    putCoord( w );
+    putCoord( h );
 }
 
 //------------------------------------------------------------------------------
@@ -249,7 +602,98 @@ void Composer::pixmap( const QPixmap &pixmap, double x, double y, double w,
 
 void Composer::printerOn ( bool on )
 {
-    m_stream << QString("printerOn") << ( on ? 1 : 0 );
+    if ( m_verify )
+    {
+        m_legacy << QString("printerOn") << ( on ? 1 : 0 );
+    }
+    putOp( OpPrinterOn );
+    putUInt( on ? 1 : 0 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Appends a coordinate (inches) to the page buffer.
+ *
+ *  Coordinates that are an exact multiple of 1/ComposerCoordScale inches
+ *  are written as a zig-zag variable length integer shifted left one bit.
+ *  All others are written as a 1 followed by the raw double.
+ *
+ *  \param value Coordinate (inches).
+ */
+
+void Composer::putCoord( double value )
+{
+    double q = floor( value * ComposerCoordScale + 0.5 );
+    if ( q > -268435456. && q < 268435456.
+      && q / ComposerCoordScale == value )
+    {
+        long i = (long) q;
+        putUInt( ( (unsigned long) ( ( i << 1 ) ^ ( i >> 31 ) ) ) << 1 );
+        return;
+    }
+    putUInt( 1 );
+    char raw[sizeof(double)];
+    memcpy( raw, &value, sizeof(double) );
+    for ( unsigned i = 0;
+          i < sizeof(double);
+          i++ )
+    {
+        putOp( raw[i] );
+    }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Appends a signed integer to the page buffer as a zig-zag
+ *  variable length integer.
+ *
+ *  \param value Signed integer value.
+ */
+
+void Composer::putInt( int value )
+{
+    putUInt( (unsigned long) ( ( value << 1 ) ^ ( value >> 31 ) ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Appends a single byte (usually an opcode) to the page buffer,
+ *  enlarging the buffer if necessary.
+ *
+ *  \param op Byte value.
+ */
+
+void Composer::putOp( int op )
+{
+    if ( m_bufLen >= m_bufSize )
+    {
+        unsigned long size = ( m_bufSize ) ? 2 * m_bufSize : 16384;
+        char *buf = new char[size];
+        checkmem( __FILE__, __LINE__, buf, "char m_buf", size );
+        if ( m_buf )
+        {
+            memcpy( buf, m_buf, m_bufLen );
+            delete[] m_buf;
+        }
+        m_buf = buf;
+        m_bufSize = size;
+    }
+    m_buf[m_bufLen++] = (char) op;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Appends an unsigned integer to the page buffer as a variable length
+ *  integer of 7 bits per byte, least significant first, with the high bit
+ *  set on all but the last byte.
+ *
+ *  \param value Unsigned integer value.
+ */
+
+void Composer::putUInt( unsigned long value )
+{
+    while ( value >= 0x80 )
+    {
+        putOp( (int) ( ( value & 0x7f ) | 0x80 ) );
+        value >>= 7;
+    }
+    putOp( (int) value );
 }
 
 //------------------------------------------------------------------------------
@@ -265,13 +709,22 @@ void Composer::printerOn ( bool on )
 
 void Composer::rect( double x, double y, double w, double h, double r )
 {
-    if ( r < 0.01 )
+    if ( m_verify && r < 0.01 )
     {
-        m_stream << QString("rect") << x << y << w << h;
+        m_legacy << QString("rect") << x << y << w << h;
     }
-    else
+    else if ( m_verify )
+    {
+        m_legacy << QString("roundrect") << x << y << w << h << r;
+    }
+    putOp( ( r < 0.01 ) ? OpRect : OpRoundRect );
+    putCoord( x );
+    putCoord( y );
+    putCoord( w );
+    putCoord( h );
+    if ( r >= 0.01 )
     {
-        m_stream << QString("roundrect") << x << y << w << h << r;
+        putCoord( r );
     }
 }
 
@@ -282,7 +735,11 @@ void Composer::rect( double x, double y, double w, double h, double r )
 
 void Composer::restore( void )
 {
-    m_stream << QString("restore");
+    if ( m_verify )
+    {
+        m_legacy << QString("restore");
+    }
+    putOp( OpRestore );
 }
 
 //------------------------------------------------------------------------------
@@ -293,7 +750,12 @@ void Composer::restore( void )
 
 void Composer::rotate( double d )
 {
-    m_stream << QString("rotate") << d;
+    if ( m_verify )
+    {
+        m_legacy << QString("rotate") << d;
+    }
+    putOp( OpRotate );
+    putCoord( d );
 }
 
 //------------------------------------------------------------------------------
@@ -308,7 +770,19 @@ void Composer::rotate( double d )
 void Composer::rotateEllipse( double rx, double ry, double x, double y,
     double w, double h, double d )
 {
-    m_stream << QString("rotateEllipse") << rx << ry << x << y << w << h << d;
+    if ( m_verify )
+    {
+        m_legacy << QString("rotateEllipse") << rx << ry << x << y << w << h
+            << d;
+    }
+    putOp( OpRotateEllipse );
+    putCoord( rx );
+    putCoord( ry );
+    putCoord( x );
+    putCoord( y );
+    putCoord( w );
+    putCoord( h );
+    putCoord( d );
 }
 
 //------------------------------------------------------------------------------
@@ -323,7 +797,19 @@ void Composer::rotateEllipse( double rx, double ry, double x, double y,
 void Composer::rotateLine( double rx, double ry, double x1, double y1,
     double x2, double y2, double d )
 {
-    m_stream << QString("rotateLine") << rx << ry << x1 << y1 << x2 << y2 << d;
+    if ( m_verify )
+    {
+        m_legacy << QString("rotateLine") << rx << ry << x1 << y1 << x2 << y2
+            << d;
+    }
+    putOp( OpRotateLine );
+    putCoord( rx );
+    putCoord( ry );
+    putCoord( x1 );
+    putCoord( y1 );
+    putCoord( x2 );
+    putCoord( y2 );
+    putCoord( d );
 }
 
 //------------------------------------------------------------------------------
@@ -340,7 +826,17 @@ void Composer::rotateLine( double rx, double ry, double x1, double y1,
 void Composer::rotateText( double x, double y, double w, double h, double d,
     const QString &text )
 {
-    m_stream << QString("rotateText") << x << y << w << h << d << text;
+    if ( m_verify )
+    {
+        m_legacy << QString("rotateText") << x << y << w << h << d << text;
+    }
+    putOp( OpRotateText );
+    putCoord( x );
+    putCoord( y );
+    putCoord( w );
+    putCoord( h );
+    putCoord( d );
+    putUInt( internString( text ) );
 }
 
 //------------------------------------------------------------------------------
@@ -350,7 +846,11 @@ void Composer::rotateText( double x, double y, double w, double h, double d,
 
 void Composer::save( void )
 {
-    m_stream << QString("save");
+    if ( m_verify )
+    {
+        m_legacy << QString("save");
+    }
+    putOp( OpSave );
 }
 
 //------------------------------------------------------------------------------
@@ -362,7 +862,12 @@ void Composer::save( void )
 
 void Composer::screenOn ( bool on )
 {
-    m_stream << QString("screenOn") << ( on ? 1 : 0 );
+    if ( m_verify )
+    {
+        m_legacy << QString("screenOn") << ( on ? 1 : 0 );
+    }
+    putOp( OpScreenOn );
+    putUInt( on ? 1 : 0 );
 }
 
 //------------------------------------------------------------------------------
@@ -378,7 +883,17 @@ void Composer::screenOn ( bool on )
 void Composer::text( double x, double y, double w, double h, int f,
     const QString &text )
 {
-    m_stream << QString("atxt") << x << y << w << h << f << text;
+    if ( m_verify )
+    {
+        m_legacy << QString("atxt") << x << y << w << h << f << text;
+    }
+    putOp( OpAlignText );
+    putCoord( x );
+    putCoord( y );
+    putCoord( w );
+    putCoord( h );
+    putInt( f );
+    putUInt( internString( text ) );
 }
 
 //------------------------------------------------------------------------------
@@ -393,7 +908,14 @@ void Composer::text( double x, double y, double w, double h, int f,
 
 void Composer::text( double x, double y, const QString &text )
 {
-    m_stream << QString("text") << x << y << text;
+    if ( m_verify )
+    {
+        m_legacy << QString("text") << x << y << text;
+    }
+    putOp( OpText );
+    putCoord( x );
+    putCoord( y );
+    putUInt( internString( text ) );
 }
 
 //------------------------------------------------------------------------------
@@ -404,7 +926,13 @@ void Composer::text( double x, double y, const QString &text )
 
 void Composer::translate( double x, double y )
 {
-    m_stream << QString("translate") << x << y;
+    if ( m_verify )
+    {
+        m_legacy << QString("translate") << x << y;
+    }
+    putOp( OpTranslate );
+    putCoord( x );
+    putCoord( y );
 }
 
 //------------------------------------------------------------------------------
@@ -420,7 +948,85 @@ void Composer::translate( double x, double y )
 void Composer::wraptext( double x, double y, double w, double h,
         const QString &text )
 {
-    m_stream << QString( "wraptext" ) << x << y << w << h << text;
+    if ( m_verify )
+    {
+        m_legacy << QString("wraptext") << x << y << w << h << text;
+    }
+    putOp( OpWrapText );
+    putCoord( x );
+    putCoord( y );
+    putCoord( w );
+    putCoord( h );
+    putUInt( internString( text ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Reads an unsigned variable length integer written by putUInt().
+ *
+ *  \param p    Reference to the current read pointer, which is advanced.
+ *  \param end  Pointer just beyond the last byte.
+ *
+ *  \return The unsigned integer value.
+ */
+
+static unsigned long getUInt( const unsigned char *&p,
+        const unsigned char *end )
+{
+    unsigned long value = 0;
+    int shift = 0;
+    while ( p < end )
+    {
+        unsigned char c = *p++;
+        value |= ( (unsigned long) ( c & 0x7f ) ) << shift;
+        if ( ! ( c & 0x80 ) )
+        {
+            break;
+        }
+        shift += 7;
+    }
+    return( value );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Reads a signed variable length integer written by putInt().
+ *
+ *  \param p    Reference to the current read pointer, which is advanced.
+ *  \param end  Pointer just beyond the last byte.
+ *
+ *  \return The signed integer value.
+ */
+
+static int getInt( const unsigned char *&p, const unsigned char *end )
+{
+    unsigned long u = getUInt( p, end );
+    return( (int) ( u >> 1 ) ^ -( (int) ( u & 1 ) ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Reads a coordinate written by Composer::putCoord().
+ *
+ *  \param p    Reference to the current read pointer, which is advanced.
+ *  \param end  Pointer just beyond the last byte.
+ *
+ *  \return The coordinate (inches).
+ */
+
+static double getCoord( const unsigned char *&p, const unsigned char *end )
+{
+    unsigned long u = getUInt( p, end );
+    if ( u & 1 )
+    {
+        double value = 0.;
+        if ( p + sizeof(double) <= end )
+        {
+            memcpy( &value, p, sizeof(double) );
+        }
+        p += sizeof(double);
+        return( value );
+    }
+    u >>= 1;
+    long i = (long) ( u >> 1 ) ^ -( (long) ( u & 1 ) );
+    return( (double) i / ComposerCoordScale );
 }
 
 //------------------------------------------------------------------------------
@@ -440,19 +1046,398 @@ void Composer::wraptext( double x, double y, double w, double h,
 bool Composer::paint( const QString  &fileName, QPaintDevice *devicePtr,
     double xppi, double yppi, double fontScale, bool toPrinter )
 {
-    // Make sure the composition is finished,
-    if ( m_file.isOpen() )
+    // Make sure the composition is finished and this page is written,
+    // but don't wait for any pages queued after it.
+    if ( m_composing )
     {
         end();
     }
-    // Open the composition file in read mode.
+    if ( m_writer && ! m_writer->flush( fileName ) )
+    {
+        writeError( fileName );
+        return( false );
+    }
+    // Read the entire composition file into memory.
     m_file.setName( fileName );
     if ( ! m_file.open( IO_ReadOnly ) )
     {
         return( false );
     }
-    m_stream.setDevice( & m_file );
+    QByteArray data = m_file.readAll();
+    m_file.close();
+    if ( data.size() < 4
+      || memcmp( data.data(), ComposerMagic, 4 ) != 0 )
+    {
+        return( false );
+    }
+    paintBuffer( (const unsigned char *) data.data() + 4,
+        (const unsigned char *) data.data() + data.size(),
+        devicePtr, xppi, yppi, fontScale, toPrinter, fileName );
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Executes the composer commands from \a p up to \a pEnd onto the
+ *  \a devicePtr QPaintDevice using the specified resolution and scale.
+ *
+ *  \param p Pointer to the first command (just past the file signature).
+ *  \param pEnd Pointer just past the last command.
+ *  \param devicePtr Pointer to the QPaintDevice to be drawn on.
+ *  \param xppi, yppi Device pixels-per-inch resolution.
+ *  \param fontScale Font scaling factor.
+ *  \param toPrinter TRUE if output is to printer
+ *  \param source Name of the commands' source, for error messages.
+ *
+ *  This function is only called by paint() and verifyPage().
+ */
+
+void Composer::paintBuffer( const unsigned char *p,
+    const unsigned char *pEnd, QPaintDevice *devicePtr, double xppi,
+    double yppi, double fontScale, bool toPrinter, const QString &source )
+{
+    // Create a local painter.
+    QPainter painter;
+    painter.begin( devicePtr );
+
+    // Get the composition device resolution.
+    m_xppi = xppi;
+    m_yppi = yppi;
+
+    // Assume both screen and printer is on
+    int printerOn = 1;
+    int screenOn = 1;
+    bool toScreen = ! toPrinter;
+    bool scaleFonts = ( devicePtr->devType() != QInternal::Printer );
+
+    // Local input variables.
+    int     op;
+    double  x, y, w, h, x1, y1, r, rx, ry, deg;
+    int     align, angle, angleLength;
+    unsigned long id;
+    QFont   font;
+
+    // Execute each command from the composition.
+    while ( p < pEnd )
+    {
+        // Read the next command.
+        op = *p++;
+        bool on = ( ( toScreen && screenOn ) || (toPrinter && printerOn ) );
+
+        // Execute the command.
+        switch ( op )
+        {
+        case OpAlignText:
+            x = getCoord( p, pEnd );
+            y = getCoord( p, pEnd );
+            w = getCoord( p, pEnd );
+            h = getCoord( p, pEnd );
+            align = getInt( p, pEnd );
+            id = getUInt( p, pEnd );
+            painter.drawText( xPix(x), yPix(y), xPix(w), yPix(h), align,
+                m_strings[id] );
+            break;
+
+        case OpBrush:
+            id = getUInt( p, pEnd );
+            if ( on )
+            {
+                painter.setBrush( m_brushes[id] );
+            }
+            break;
+
+        case OpEllipse:
+            x = getCoord( p, pEnd );
+            y = getCoord( p, pEnd );
+            w = getCoord( p, pEnd );
+            h = getCoord( p, pEnd );
+            if ( on )
+            {
+                painter.drawEllipse( xPix(x), yPix(y), xPix(w), yPix(h) );
+            }
+            break;
+
+        case OpFill:
+            x = getCoord( p, pEnd );
+            y = getCoord( p, pEnd );
+            w = getCoord( p, pEnd );
+            h = getCoord( p, pEnd );
+            id = getUInt( p, pEnd );
+            if ( on )
+            {
+                painter.fillRect( xPix(x), yPix(y), xPix(w), yPix(h),
+                    m_brushes[id] );
+            }
+            break;
+
+        case OpFont:
+            id = getUInt( p, pEnd );
+            font = m_fonts[id];
+            // The passed xppi and yppi already account for drawing scale,
+            // but all screen fonts must still be rescaled!
+            if ( scaleFonts )
+            {
+                font.setPointSize( (int)
+                    ( 0.1 + fontScale * (double) font.pointSize() ) );
+            }
+            if ( on )
+            {
+                painter.setFont( font );
+            }
+            break;
+
+        case OpGraph:
+            id = getUInt( p, pEnd );
+            x = getCoord( p, pEnd );
+            y = getCoord( p, pEnd );
+            w = getCoord( p, pEnd );
+            h = getCoord( p, pEnd );
+            if ( on )
+            {
+                paintGraph( &painter, fontScale, m_graphs[id], x, y, w, h );
+            }
+            break;
+
+        case OpLine:
+            x = getCoord( p, pEnd );
+            y = getCoord( p, pEnd );
+            x1 = getCoord( p, pEnd );
+            y1 = getCoord( p, pEnd );
+            if ( on )
+            {
+                painter.drawLine( xPix(x), yPix(y), xPix(x1), yPix(y1) );
+            }
+            break;
+
+        case OpPen:
+            id = getUInt( p, pEnd );
+            if ( on )
+            {
+                painter.setPen( m_pens[id] );
+            }
+            break;
+
+        case OpPie:
+            x = getCoord( p, pEnd );
+            y = getCoord( p, pEnd );
+            w = getCoord( p, pEnd );
+            h = getCoord( p, pEnd );
+            angle = getInt( p, pEnd );
+            angleLength = getInt( p, pEnd );
+            if ( on )
+            {
+                painter.drawPie( xPix(x), yPix(y), xPix(w), yPix(h),
+                angle, angleLength );
+            }
+            break;
+
+        case OpPixmap:
+            id = getUInt( p, pEnd );
+            x = getCoord( p, pEnd );
+            y = getCoord( p, pEnd );
+            w = getCoord( p, pEnd );
+            h = getCoord( p, pEnd );
+            if ( on )
+            {
+                const QPixmap &pixmap = m_pixmaps[id];
+                double xscale = w * xppi / pixmap.width();
+                double yscale = h * yppi / pixmap.height();
+                QWMatrix matrix = painter.worldMatrix();
+                painter.scale( xscale, yscale );
+                painter.drawPixmap( (int) (xPix(x)/xscale), (int) (yPix(y)/yscale),
+                    pixmap );
+                painter.setWorldMatrix( matrix );
+            }
+            break;
+
+        case OpPrinterOn:
+            printerOn = (int) getUInt( p, pEnd );
+            break;
+
+        case OpRect:
+            x = getCoord( p, pEnd );
+            y = getCoord( p, pEnd );
+            w = getCoord( p, pEnd );
+            h = getCoord( p, pEnd );
+            if ( on )
+            {
+                painter.drawRect( xPix(x), yPix(y), xPix(w), yPix(h) );
+            }
+            break;
+
+        case OpRoundRect:
+            x = getCoord( p, pEnd );
+            y = getCoord( p, pEnd );
+            w = getCoord( p, pEnd );
+            h = getCoord( p, pEnd );
+            r = getCoord( p, pEnd );
+            if ( on )
+            {
+                int x1 = xPix(x);
+                int y1 = yPix(y);
+                int x2 = xPix(x+w);
+                int y2 = yPix(y+h);
+                int rx = xPix(r);
+                int ry = yPix(r);
+                int len = 16 * 90;
+                painter.drawLine( x1+rx, y1, x2-rx, y1 );   // top
+                painter.drawLine( x1+rx, y2, x2-rx, y2 );   // bottom
+                painter.drawLine( x1, y1+ry, x1, y2-ry );   // left
+                painter.drawLine( x2, y1+ry, x2, y2-ry );   // right
+                painter.drawArc( x2-2*rx, y1, 2*rx, 2*ry, 0, len );     // ur
+                painter.drawArc( x1, y1, 2*rx, 2*ry, 16*90, len );      // ul
+                painter.drawArc( x1, y2-2*ry, 2*rx, 2*ry, 16*180, len ); // ll
+                painter.drawArc( x2-2*rx, y2-2*ry, 2*rx, 2*ry, 16*270, len );
+            }
+            break;
+
+        case OpRestore:
+            painter.restore();
+            break;
+
+        case OpRotate:
+            deg = getCoord( p, pEnd );
+            if ( on )
+            {
+                painter.rotate( deg );
+            }
+            break;
+
+        case OpRotateEllipse:
+            rx = getCoord( p, pEnd );
+            ry = getCoord( p, pEnd );
+            x = getCoord( p, pEnd );
+            y = getCoord( p, pEnd );
+            w = getCoord( p, pEnd );
+            h = getCoord( p, pEnd );
+            deg = getCoord( p, pEnd );
+            if ( on )
+            {
+                painter.save();
+                painter.translate( xPix(rx), yPix(ry) );
+                painter.rotate( deg );
+                painter.drawEllipse( xPix((x-rx)), yPix((y-ry)),
+                    xPix(w), xPix(h) );
+                painter.restore();
+            }
+            break;
+
+        case OpRotateLine:
+            rx = getCoord( p, pEnd );
+            ry = getCoord( p, pEnd );
+            x = getCoord( p, pEnd );
+            y = getCoord( p, pEnd );
+            x1 = getCoord( p, pEnd );
+            y1 = getCoord( p, pEnd );
+            deg = getCoord( p, pEnd );
+            if ( on )
+            {
+                painter.save();
+                painter.translate( xPix(rx), yPix(ry) );
+                painter.rotate( deg );
+                painter.drawLine( xPix((x-rx)), yPix((y-ry)),
+                    xPix(x1-rx), xPix(y1-ry) );
+                painter.restore();
+            }
+            break;
+
+        case OpRotateText:
+            x = getCoord( p, pEnd );
+            y = getCoord( p, pEnd );
+            w = getCoord( p, pEnd );
+            h = getCoord( p, pEnd );
+            deg = getCoord( p, pEnd );
+            id = getUInt( p, pEnd );
+            if ( on )
+            {
+                painter.save();
+                painter.translate( xPix(x), yPix(y) );
+                painter.rotate( deg );
+                painter.drawText( 0, 0, xPix(w), xPix(h),
+                    Qt::AlignHCenter|Qt::AlignVCenter, m_strings[id] );
+                painter.restore();
+            }
+            break;
+
+        case OpSave:
+            painter.save();
+            break;
+
+        case OpScreenOn:
+            screenOn = (int) getUInt( p, pEnd );
+            break;
+
+        case OpText:
+            x = getCoord( p, pEnd );
+            y = getCoord( p, pEnd );
+            id = getUInt( p, pEnd );
+            if ( on )
+            {
+                painter.drawText( xPix(x), yPix(y), m_strings[id] );
+            }
+            break;
+
+        case OpTranslate:
+            x = getCoord( p, pEnd );
+            y = getCoord( p, pEnd );
+            if ( on )
+            {
+                painter.translate( xPix(x), yPix(y) );
+            }
+            break;
+
+        case OpWrapText:
+            x = getCoord( p, pEnd );
+            y = getCoord( p, pEnd );
+            w = getCoord( p, pEnd );
+            h = getCoord( p, pEnd );
+            id = getUInt( p, pEnd );
+            if ( on )
+            {
+                painter.drawText( xPix(x), yPix(y), xPix(w), yPix(h),
+                    Qt::WordBreak, m_strings[id] );
+            }
+            break;
+
+        // Any unknown command means the rest of the file is unreadable.
+        default:
+            qDebug( QString(
+                "Composer::paint() - unknown command %1 from %2." )
+                .arg( op ).arg( source ) );
+            p = pEnd;
+            break;
+        }
+    }
+
+    // Clean up and return.
+    painter.end();
+    return;
+}
 
+//------------------------------------------------------------------------------
+/*! \brief Executes composer commands recorded in the original composer file
+ *  format (a QDataStream of command names and their streamed arguments, with
+ *  every brush, font, pen, pixmap, string, and graph written in full) onto
+ *  the \a devicePtr QPaintDevice using the specified resolution and scale.
+ *
+ *  This is the original paint() command loop, kept so verifyPage() can
+ *  check that the compact format replays exactly as the original did.
+ *  Unlike the original, the "graph" arguments are read even when the
+ *  graph is not drawn, so the stream stays in step.
+ *
+ *  \param stream Reference to the QDataStream positioned at the first command.
+ *  \param devicePtr Pointer to the QPaintDevice to be drawn on.
+ *  \param xppi, yppi Device pixels-per-inch resolution.
+ *  \param fontScale Font scaling factor.
+ *  \param toPrinter TRUE if output is to printer
+ *  \param source Name of the commands' source, for error messages.
+ *
+ *  This function is only called by verifyPage().
+ */
+
+void Composer::paintLegacy( QDataStream &stream, QPaintDevice *devicePtr,
+    double xppi, double yppi, double fontScale, bool toPrinter,
+    const QString &source )
+{
     // Create a local painter.
     QPainter painter;
     painter.begin( devicePtr );
@@ -475,45 +1460,46 @@ bool Composer::paint( const QString  &fileName, QPaintDevice *devicePtr,
     QPen    pen;
     QString text;
 
-    // Read each command line from the composition file.
-    while ( ! m_stream.eof() )
+    // Read each command from the stream.
+    while ( ! stream.atEnd() )
     {
         // Read the next command.
-        m_stream >> cmd;
+        stream >> cmd;
+        bool on = ( ( toScreen && screenOn ) || (toPrinter && printerOn ) );
 
         // Execute the command.
         if ( cmd == "atxt" )
         {
-            m_stream >> x >> y >> w >> h >> align >> text;
+            stream >> x >> y >> w >> h >> align >> text;
             painter.drawText( xPix(x), yPix(y), xPix(w), yPix(h), align, text );
         }
         else if ( cmd == "brush" )
         {
-            m_stream >> brush;
-            if ( ( toScreen && screenOn ) || (toPrinter && printerOn ) )
+            stream >> brush;
+            if ( on )
             {
                 painter.setBrush( brush );
             }
         }
         else if ( cmd == "ellipse" )
         {
-            m_stream >> x >> y >> w >> h;
-            if ( ( toScreen && screenOn ) || (toPrinter && printerOn ) )
+            stream >> x >> y >> w >> h;
+            if ( on )
             {
                 painter.drawEllipse( xPix(x), yPix(y), xPix(w), yPix(h) );
             }
         }
         else if ( cmd == "fill" )
         {
-            m_stream >> x >> y >> w >> h >> brush;
-            if ( ( toScreen && screenOn ) || (toPrinter && printerOn ) )
+            stream >> x >> y >> w >> h >> brush;
+            if ( on )
             {
                 painter.fillRect( xPix(x), yPix(y), xPix(w), yPix(h), brush );
             }
         }
         else if ( cmd == "font" )
         {
-            m_stream >> font;
+            stream >> font;
             // The passed xppi and yppi already account for drawing scale,
             // but all screen fonts must still be rescaled!
             if ( devicePtr->devType() != QInternal::Printer )
@@ -521,38 +1507,40 @@ bool Composer::paint( const QString  &fileName, QPaintDevice *devicePtr,
                 font.setPointSize( (int)
                     ( 0.1 + fontScale * (double) font.pointSize() ) );
             }
-            if ( ( toScreen && screenOn ) || (toPrinter && printerOn ) )
+            if ( on )
             {
                 painter.setFont( font );
             }
         }
         else if ( cmd == "graph" )
         {
-            if ( ( toScreen && screenOn ) || (toPrinter && printerOn ) )
+            Graph graph;
+            stream >> x >> y >> w >> h >> graph;
+            if ( on )
             {
-                paintGraph( &painter, fontScale );
+                paintGraph( &painter, fontScale, &graph, x, y, w, h );
             }
         }
         else if ( cmd == "line" )
         {
-            m_stream >> x >> y >> x1 >> y1;
-            if ( ( toScreen && screenOn ) || (toPrinter && printerOn ) )
+            stream >> x >> y >> x1 >> y1;
+            if ( on )
             {
                 painter.drawLine( xPix(x), yPix(y), xPix(x1), yPix(y1) );
             }
         }
         else if ( cmd == "pen" )
         {
-            m_stream >> pen;
-            if ( ( toScreen && screenOn ) || (toPrinter && printerOn ) )
+            stream >> pen;
+            if ( on )
             {
                 painter.setPen( pen );
             }
         }
         else if ( cmd == "pie" )
         {
-            m_stream >> x >> y >> w >> h >> angle >> angleLength;
-            if ( ( toScreen && screenOn ) || (toPrinter && printerOn ) )
+            stream >> x >> y >> w >> h >> angle >> angleLength;
+            if ( on )
             {
                 painter.drawPie( xPix(x), yPix(y), xPix(w), yPix(h),
                 angle, angleLength );
@@ -561,8 +1549,8 @@ bool Composer::paint( const QString  &fileName, QPaintDevice *devicePtr,
         else if ( cmd == "pixmap" )
         {
             QPixmap pixmap;
-            m_stream >> pixmap >> x >> y >> w >> h;
-            if ( ( toScreen && screenOn ) || (toPrinter && printerOn ) )
+            stream >> pixmap >> x >> y >> w >> h;
+            if ( on )
             {
                 double xscale = w * xppi / pixmap.width();
                 double yscale = h * yppi / pixmap.height();
@@ -575,20 +1563,20 @@ bool Composer::paint( const QString  &fileName, QPaintDevice *devicePtr,
         }
         else if ( cmd == "printerOn" )
         {
-            m_stream >> printerOn;
+            stream >> printerOn;
         }
         else if ( cmd == "rect" )
         {
-            m_stream >> x >> y >> w >> h;
-            if ( ( toScreen && screenOn ) || (toPrinter && printerOn ) )
+            stream >> x >> y >> w >> h;
+            if ( on )
             {
                 painter.drawRect( xPix(x), yPix(y), xPix(w), yPix(h) );
             }
         }
         else if ( cmd == "roundrect" )
         {
-            m_stream >> x >> y >> w >> h >> r;
-            if ( ( toScreen && screenOn ) || (toPrinter && printerOn ) )
+            stream >> x >> y >> w >> h >> r;
+            if ( on )
             {
                 int x1 = xPix(x);
                 int y1 = yPix(y);
@@ -613,16 +1601,16 @@ bool Composer::paint( const QString  &fileName, QPaintDevice *devicePtr,
         }
         else if ( cmd == "rotate" )
         {
-            m_stream >> deg;
-            if ( ( toScreen && screenOn ) || (toPrinter && printerOn ) )
+            stream >> deg;
+            if ( on )
             {
                 painter.rotate( deg );
             }
         }
         else if ( cmd == "rotateEllipse" )
         {
-            m_stream >> rx >> ry >> x >> y >> w >> h >> deg;
-            if ( ( toScreen && screenOn ) || (toPrinter && printerOn ) )
+            stream >> rx >> ry >> x >> y >> w >> h >> deg;
+            if ( on )
             {
                 painter.save();
                 painter.translate( xPix(rx), yPix(ry) );
@@ -634,8 +1622,8 @@ bool Composer::paint( const QString  &fileName, QPaintDevice *devicePtr,
         }
         else if ( cmd == "rotateLine" )
         {
-            m_stream >> rx >> ry >> x >> y >> x1 >> y1 >> deg;
-            if ( ( toScreen && screenOn ) || (toPrinter && printerOn ) )
+            stream >> rx >> ry >> x >> y >> x1 >> y1 >> deg;
+            if ( on )
             {
                 painter.save();
                 painter.translate( xPix(rx), yPix(ry) );
@@ -647,8 +1635,8 @@ bool Composer::paint( const QString  &fileName, QPaintDevice *devicePtr,
         }
         else if ( cmd == "rotateText" )
         {
-            m_stream >> x >> y >> w >> h >> deg >> text;
-            if ( ( toScreen && screenOn ) || (toPrinter && printerOn ) )
+            stream >> x >> y >> w >> h >> deg >> text;
+            if ( on )
             {
                 painter.save();
                 painter.translate( xPix(x), yPix(y) );
@@ -664,28 +1652,28 @@ bool Composer::paint( const QString  &fileName, QPaintDevice *devicePtr,
         }
         else if ( cmd == "screenOn" )
         {
-            m_stream >> screenOn;
+            stream >> screenOn;
         }
         else if ( cmd == "text" )
         {
-            m_stream >> x >> y >> text;
-            if ( ( toScreen && screenOn ) || (toPrinter && printerOn ) )
+            stream >> x >> y >> text;
+            if ( on )
             {
                 painter.drawText( xPix(x), yPix(y), text );
             }
         }
         else if ( cmd == "translate" )
         {
-            m_stream >> x >> y;
-            if ( ( toScreen && screenOn ) || (toPrinter && printerOn ) )
+            stream >> x >> y;
+            if ( on )
             {
                 painter.translate( xPix(x), yPix(y) );
             }
         }
         else if ( cmd == "wraptext" )
         {
-            m_stream >> x >> y >> w >> h >> text;
-            if ( ( toScreen && screenOn ) || (toPrinter && printerOn ) )
+            stream >> x >> y >> w >> h >> text;
+            if ( on )
             {
                 painter.drawText( xPix(x), yPix(y), xPix(w), yPix(h),
                     Qt::WordBreak, text );
@@ -695,15 +1683,67 @@ bool Composer::paint( const QString  &fileName, QPaintDevice *devicePtr,
         else
         {
             qDebug( QString(
-                "Composer::paint() - unknown command %1 from %2." )
-                .arg( cmd ).arg( fileName ) );
+                "Composer::paintLegacy() - unknown command %1 from %2." )
+                .arg( cmd ).arg( source ) );
         }
     }
 
     // Clean up and return.
-    m_file.close();
     painter.end();
-    return( true );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Replays the current page from its compact page buffer and from its
+ *  original composer file format recording onto two QPictures, for both
+ *  screen and printer output, and checks that the recorded drawing is
+ *  identical.
+ *
+ *  This function is only called by end() when verification has been turned
+ *  on by setVerify().  Differences are written to the application log.
+ *
+ *  \retval TRUE if both formats paint the same output.
+ *  \retval FALSE if they differ.
+ */
+
+bool Composer::verifyPage( void )
+{
+    // Save the state that the replays change.
+    double xppi = m_xppi;
+    double yppi = m_yppi;
+    bool same = true;
+    int pass;
+    for ( pass = 0;
+          pass < 2 && same;
+          pass++ )
+    {
+        // Replay the compact page using the shared resource tables.
+        bool toPrinter = ( pass == 1 );
+        QPicture compact, original;
+        paintBuffer( (const unsigned char *) m_buf + 4,
+            (const unsigned char *) m_buf + m_bufLen, &compact,
+            100., 100., 1., toPrinter, m_file.name() );
+
+        // Replay the original format page with its resources read in full.
+        QDataStream in( m_legacyBuf.buffer(), IO_ReadOnly );
+        paintLegacy( in, &original, 100., 100., 1., toPrinter,
+            m_file.name() );
+
+        // The painted command streams must match byte for byte.
+        same = ( compact.size() == original.size()
+              && memcmp( compact.data(), original.data(),
+                         compact.size() ) == 0 );
+        if ( ! same )
+        {
+            log( QString( "Composer::end() page \"%1\" replays differently "
+                "to the %2 than its original format.\n" )
+                .arg( m_file.name() )
+                .arg( toPrinter ? "printer" : "screen" ) );
+        }
+    }
+    m_xppi = xppi;
+    m_yppi = yppi;
+    return( same );
 }
 
 //------------------------------------------------------------------------------
@@ -711,17 +1751,17 @@ bool Composer::paint( const QString  &fileName, QPaintDevice *devicePtr,
  *
  *  \param painterPtr Pointer to the QPainter in use.
  *  \param fontScale Font scale factor passed to paint().
+ *  \param graph Pointer to the Graph from the graph resource table.
+ *  \param marginLeft, marginTop Graph's upper left corner on the page (in).
+ *  \param bodyWd, bodyHt Graph body width and height (in).
  *
  *  This function is only called by paint().
  */
 
-void Composer::paintGraph( QPainter *painterPtr, double fontScale )
+void Composer::paintGraph( QPainter *painterPtr, double fontScale,
+    Graph *graph, double marginLeft, double marginTop,
+    double bodyWd, double bodyHt )
 {
-    // Read the rest of the Graph parameters from the composer file.
-    Graph graph;
-    double marginLeft, marginTop, bodyWd, bodyHt;
-    m_stream >> marginLeft >> marginTop >> bodyWd >> bodyHt >> graph;
-
     // Set graph area on page.
     int x0 = (int) (marginLeft * m_xppi );
     int y0 = (int) (marginTop * m_yppi );
@@ -733,17 +1773,33 @@ void Composer::paintGraph( QPainter *painterPtr, double fontScale )
     // Portrait graphs.
     if ( true )
     {
-        graph.setCanvas( x0, y0, wd, ht, 0 );
+        graph->setCanvas( x0, y0, wd, ht, 0 );
     }
     // Landscape graphs.
     else
     {
-        graph.setCanvas( x0, y0+ht, ht, wd, 0 );
-        graph.setCanvasRotation( 270. );
+        graph->setCanvas( x0, y0+ht, ht, wd, 0 );
+        graph->setCanvasRotation( 270. );
     }
 
     // Draw the graph and return.
-    graph.draw( painterPtr, fontScale );
+    graph->draw( painterPtr, fontScale );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Warns that the ComposerWriter could not create or write
+ *  \a fileName.
+ *
+ *  \param fileName Full path name of the composer file(s).
+ */
+
+void Composer::writeError( const QString &fileName ) const
+{
+    // Composer::translate() hides the global translate()
+    QString msg("");
+    ::translate( msg, "Composer:WriteError", fileName );
+    warn( msg );
     return;
 }
 
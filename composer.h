@@ -13,19 +13,24 @@
 #define _COMPOSER_H_ 1
 
 // Forward class references
+class ComposerWriter;
 class Graph;
 
 // Qt class references
+#include <qbrush.h>
+#include <qbuffer.h>
 #include <qdatastream.h>
 #include <qfile.h>
-class QBrush;
+#include <qfont.h>
+#include <qmap.h>
+#include <qpen.h>
+#include <qpixmap.h>
+#include <qptrvector.h>
+#include <qstring.h>
+#include <qvaluevector.h>
 class QColorGroup;
-class QFont;
 class QPaintDevice;
 class QPainter;
-class QPen;
-class QPixmap;
-class QString;
 
 //------------------------------------------------------------------------------
 /*! \class Composer composer.h
@@ -70,6 +75,33 @@ class QString;
  *  method with the name of the composer file to be executed and a pointer
  *  to the QPaintDevice, which can be a QPicture, QPixmap, QPrinter, or
  *  QWidget (e.g., screen).
+ *
+ *  Composer files are compact binary files.  Each drawing command is a
+ *  single opcode byte followed by its arguments encoded as variable length
+ *  integers.  Coordinates that are an exact multiple of 1/10000 inch are
+ *  stored as variable length integers, all others as raw doubles, so
+ *  paint() replays exactly the same coordinates that were composed.
+ *  Brushes, fonts, pens, pixmaps, strings, and graphs are not written to the
+ *  composer file at all; they are interned into resource tables shared by
+ *  all the pages composed by this Composer and only their table index is
+ *  written.  Since the composer files are therefore only meaningful to the
+ *  Composer that wrote them, the Document must call clearResources()
+ *  whenever it removes all its composer files.
+ *
+ *  begin() does not touch the file system.  end() hands the finished page
+ *  to a ComposerWriter thread, which creates and writes the file while the
+ *  next page is being composed.  paint() waits only for the page it is
+ *  painting, so the first page can be shown while later ones are still
+ *  being written, and warns if that page could not be written.  Anything
+ *  that removes composer files must call flush() first, which waits for
+ *  every page and warns about any other failed writes.
+ *
+ *  If setVerify() is on (the Document turns it on from the
+ *  "appComposerVerify" property, and the composercheck program always),
+ *  each page is also recorded in the original composer file format: a
+ *  QDataStream of command names with every resource streamed in full.
+ *  end() then replays both recordings onto QPictures (see verifyPage())
+ *  and logs and counts any page whose compact replay paints differently.
  */
 
 class Composer
@@ -81,8 +113,12 @@ public:
 
     // Functions that control the Composer recording state.
     bool begin( const QString &fileName ) ;
+    void clearResources( void ) ;
     bool end( void ) ;
+    bool flush( void ) ;
     void makeFileName( int docId, int pageNo, QString &composerFile ) ;
+    void setVerify( bool on ) ;
+    int  verifyFailures( void ) const ;
 
     // Functions that record Composer commands.
     void brush( const QBrush &brush ) ;
@@ -124,16 +160,55 @@ public:
 
 // Private methods
 private:
-    void paintGraph( QPainter *p, double fontScale ) ;
+    int  internBrush( const QBrush &brush ) ;
+    int  internFont( const QFont &font ) ;
+    int  internPen( const QPen &pen ) ;
+    int  internString( const QString &text ) ;
+    void paintBuffer( const unsigned char *p, const unsigned char *pEnd,
+            QPaintDevice *devicePtr, double xppi, double yppi,
+            double fontScale, bool toPrinter, const QString &source ) ;
+    void paintGraph( QPainter *p, double fontScale, Graph *graph,
+            double marginLeft, double marginTop, double bodyWd,
+            double bodyHt ) ;
+    void paintLegacy( QDataStream &stream, QPaintDevice *devicePtr,
+            double xppi, double yppi, double fontScale, bool toPrinter,
+            const QString &source ) ;
+    void putCoord( double value ) ;
+    void putInt( int value ) ;
+    void putOp( int op ) ;
+    void putUInt( unsigned long value ) ;
+    bool verifyPage( void ) ;
+    void writeError( const QString &fileName ) const ;
     int  xPix( double inches ) const ;
     int  yPix( double inches ) const ;
 
 // Public data members
 public:
     QFile       m_file;     //!< Current composition file full path name
-    QDataStream m_stream;   //!< Composer file input-output data stream
     double      m_xppi;     //!< Current paint() x pixels per inch
     double      m_yppi;     //!< Current paint() y pixels per inch
+
+// Private data members
+private:
+    char         *m_buf;        //!< Current page's encoded commands
+    unsigned long m_bufLen;     //!< Number of bytes used in m_buf
+    unsigned long m_bufSize;    //!< Number of bytes allocated to m_buf
+    bool          m_composing;  //!< TRUE between begin() and end()
+    ComposerWriter *m_writer;   //!< Background page file writer
+    QValueVector<QBrush>  m_brushes;    //!< Brush resource table
+    QValueVector<QFont>   m_fonts;      //!< Font resource table
+    QPtrVector<Graph>     m_graphs;     //!< Graph resource table
+    int                   m_graphCount; //!< Number of Graphs in m_graphs
+    QValueVector<QPen>    m_pens;       //!< Pen resource table
+    QValueVector<QPixmap> m_pixmaps;    //!< Pixmap resource table
+    QValueVector<QString> m_strings;    //!< String resource table
+    QMap<QString,int>     m_stringMap;  //!< String to m_strings index map
+    // Replay verification (see verifyPage())
+    bool          m_verify;         //!< TRUE if pages are also recorded in the original format
+    int           m_verifyFailures; //!< Number of pages that failed verifyPage()
+    QByteArray    m_legacyData;     //!< Current page in the original format
+    QBuffer       m_legacyBuf;      //!< Buffer device writing m_legacyData
+    QDataStream   m_legacy;         //!< Original format stream on m_legacyBuf
 };
 
 #endif
@@ -0,0 +1,182 @@
+//------------------------------------------------------------------------------
+/*! \file composercheck.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Console driver that checks the compact composer page format
+ *  replays exactly as the original composer file format did.
+ *
+ *  Usage: composercheck [pages]
+ *
+ *  Composes a number of pages that use every Composer drawing command,
+ *  with coordinates both on and off the 1/10000 inch grid, resources that
+ *  repeat within and across pages, and output toggled on and off for the
+ *  screen and printer.  Replay verification is on, so Composer::end()
+ *  paints every page from its compact buffer and from its original format
+ *  recording and compares the two pictures for screen and printer output.
+ *  The program exits with status 1 if any page replays differently.
+ */
+
+// Custom include files
+#include "appmessage.h"
+#include "composer.h"
+#include "graph.h"
+
+// Qt include files
+#include <qapplication.h>
+#include <qfile.h>
+#include <qimage.h>
+
+// Standard include files
+#include <stdio.h>
+#include <stdlib.h>
+
+/*! \var CheckMaxPages
+ *  \brief Maximum number of pages composed.
+ */
+static const int CheckMaxPages = 100;
+
+//------------------------------------------------------------------------------
+/*! \brief Composes one page using every Composer drawing command.
+ *
+ *  \param composer Reference to the Composer.
+ *  \param page     Page number, which varies the coordinates and text.
+ *  \param pixmap   Pixmap drawn (twice) on each page.
+ */
+
+static void composePage( Composer &composer, int page,
+        const QPixmap &pixmap )
+{
+    double d = 0.01 * (double) page;
+    // An offset that is not a multiple of 1/10000 inch
+    double odd = 1. / 3. + d;
+    QFont font( "Times New Roman", 12 );
+    QFont bold( "Arial", 10, QFont::Bold );
+    QPen  pen( QColor( 0, 0, 255 ), 2 );
+    QBrush brush( QColor( 255, 255, 224 ) );
+
+    composer.font( font );
+    composer.pen( pen );
+    composer.brush( brush );
+    composer.fill( 0.5, 0.5, 7.5, 1.0, brush );
+    composer.rect( 0.5, 0.5, 7.5, 1.0 );
+    composer.rect( 0.5 + odd, 2.0, 3.0, 1.0, 0.125 );
+    composer.text( 0.75, 0.75 + d, QString( "Page %1" ).arg( page ) );
+    composer.text( 0.5, 1.0, 7.5, 0.5, Qt::AlignHCenter|Qt::AlignVCenter,
+        "Centered heading" );
+    composer.font( bold );
+    composer.wraptext( 0.5, 3.5, 2.0, 1.0,
+        "Wrapped text that is long enough to need several lines." );
+    composer.line( 0.5, 4.5, 8.0 - odd, 4.5 + d );
+    composer.ellipse( 1.0, 5.0, 1.0 + odd, 0.5 );
+    composer.pie( 3.0, 5.0, 1.0, 1.0, 16 * 30, 16 * ( 60 + page ) );
+    composer.save();
+    composer.translate( 4.0, 6.0 );
+    composer.rotate( 15. + d );
+    composer.text( 0., 0., "Rotated" );
+    composer.restore();
+    composer.rotateEllipse( 5.0, 5.0, 5.0, 5.0, 1.0, 0.5, 30. );
+    composer.rotateLine( 5.0, 6.0, 5.0, 6.0, 6.5, 6.0 + odd, 45. );
+    composer.rotateText( 6.0, 7.0, 1.5, 0.25, 270., "Vertical" );
+    composer.pixmap( pixmap, 0.5, 7.0, 1.0, 1.0 );
+
+    // Output only to the printer, then only to the screen
+    composer.screenOn( false );
+    composer.font( font );
+    composer.text( 2.0, 8.0, "Printer only" );
+    composer.screenOn( true );
+    composer.printerOn( false );
+    composer.pen( QPen( QColor( 255, 0, 0 ), 1, Qt::DashLine ) );
+    composer.text( 2.0, 8.25, "Screen only" );
+    composer.pixmap( pixmap, 0.5 + odd, 8.0, 0.5, 0.5 );
+    composer.printerOn( true );
+
+    // A graph, composed once with and once without screen output
+    Graph graph;
+    double x[5], y[5];
+    for ( int i = 0;
+          i < 5;
+          i++ )
+    {
+        x[i] = (double) i;
+        y[i] = (double) ( i * i ) + d;
+    }
+    graph.setWorld( 0., 0., 4., 17. );
+    graph.setTitle( "Graph", font, QColor( 0, 0, 0 ) );
+    graph.addGraphLine( 5, x, y, pen );
+    composer.graph( graph, 0.5, 9.0, 3.0, 1.5 );
+    composer.screenOn( false );
+    composer.graph( graph, 4.5, 9.0, 3.0, 1.5 );
+    composer.screenOn( true );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Main driver.
+ */
+
+int main( int argc, char **argv )
+{
+    QApplication app( argc, argv );
+    int pages = ( argc > 1 ) ? atoi( argv[1] ) : 10;
+    if ( pages < 1 || pages > CheckMaxPages )
+    {
+        fprintf( stderr, "%s: pages must be 1-%d.\n", argv[0], CheckMaxPages );
+        return( 1 );
+    }
+    logOpen( "composercheck.log" );
+
+    // A small pixmap with a pattern that survives the original format's PNG
+    QImage image( 16, 16, 32 );
+    for ( int row = 0;
+          row < 16;
+          row++ )
+    {
+        for ( int col = 0;
+              col < 16;
+              col++ )
+        {
+            image.setPixel( col, row, qRgb( 16 * row, 16 * col, 128 ) );
+        }
+    }
+    QPixmap pixmap;
+    pixmap.convertFromImage( image );
+
+    // Compose every page with verification on
+    Composer composer;
+    composer.setVerify( true );
+    QString fileName;
+    int page;
+    for ( page = 1;
+          page <= pages;
+          page++ )
+    {
+        fileName = QString( "composercheck%1.tmp" ).arg( page );
+        if ( ! composer.begin( fileName ) )
+        {
+            fprintf( stderr, "%s: unable to open \"%s\".\n",
+                argv[0], fileName.latin1() );
+            logClose();
+            return( 1 );
+        }
+        composePage( composer, page, pixmap );
+        composer.end();
+    }
+    bool written = composer.flush();
+    for ( page = 1;
+          page <= pages;
+          page++ )
+    {
+        QFile::remove( QString( "composercheck%1.tmp" ).arg( page ) );
+    }
+    int failed = composer.verifyFailures();
+    fprintf( stdout, "%d of %d pages replay differently than their original "
+        "format%s.\n", failed, pages, written ? "" : " (and some pages "
+        "could not be written)" );
+    logClose();
+    return( ( failed || ! written ) ? 1 : 0 );
+}
+
+//------------------------------------------------------------------------------
+//  End of composercheck.cpp
+//------------------------------------------------------------------------------
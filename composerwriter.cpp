@@ -0,0 +1,237 @@
+//------------------------------------------------------------------------------
+/*! \file composerwriter.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief ComposerWriter class methods.
+ */
+
+// Custom include files
+#include "appmessage.h"
+#include "composerwriter.h"
+
+// Qt include files
+#include <qdeepcopy.h>
+#include <qfile.h>
+
+//------------------------------------------------------------------------------
+/*! \brief ComposerWriter constructor.
+ *
+ *  The thread is not started until the first page is queued by write().
+ */
+
+ComposerWriter::ComposerWriter( void ) :
+    QThread(),
+    m_mutex(),
+    m_queued(),
+    m_written(),
+    m_first(0),
+    m_last(0),
+    m_busy(0),
+    m_failed(),
+    m_stop(false)
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief ComposerWriter destructor.
+ *
+ *  Writes any queued pages and waits for the thread to finish.
+ */
+
+ComposerWriter::~ComposerWriter( void )
+{
+    m_mutex.lock();
+    m_stop = true;
+    m_queued.wakeAll();
+    m_mutex.unlock();
+    wait();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Waits until every queued page has been written.
+ *
+ *  \param failedFiles If not NULL, returns the names of the files that
+ *  could not be created or written.
+ *
+ *  \return TRUE if every page that failed to be written has already been
+ *  reported by flush( fileName ), FALSE if any others failed.
+ */
+
+bool ComposerWriter::flush( QStringList *failedFiles )
+{
+    m_mutex.lock();
+    while ( m_first || m_busy )
+    {
+        m_written.wait( &m_mutex );
+    }
+    bool ok = m_failed.isEmpty();
+    if ( failedFiles )
+    {
+        // The names must not share their data with this thread's copies
+        failedFiles->clear();
+        for ( QStringList::Iterator it = m_failed.begin();
+              it != m_failed.end();
+              ++it )
+        {
+            failedFiles->append( QDeepCopy<QString>( *it ) );
+        }
+    }
+    m_failed.clear();
+    m_mutex.unlock();
+    return( ok );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Waits until the page queued for \a fileName has been written.
+ *
+ *  Pages are written in order, so this also waits for any pages queued
+ *  before it, but not for those queued after it.
+ *
+ *  \param fileName Full path name of the composer file.
+ *
+ *  \return TRUE if the page was written successfully (or none was queued),
+ *  FALSE if it could not be created or written.
+ */
+
+bool ComposerWriter::flush( const QString &fileName )
+{
+    m_mutex.lock();
+    while ( pending( fileName ) )
+    {
+        m_written.wait( &m_mutex );
+    }
+    // Each failure is reported only once
+    bool ok = ( m_failed.remove( fileName ) == 0 );
+    m_mutex.unlock();
+    return( ok );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines if a page for \a fileName is queued or being written.
+ *
+ *  The caller must hold m_mutex.
+ *
+ *  \return TRUE if a page for \a fileName is still to be written.
+ */
+
+bool ComposerWriter::pending( const QString &fileName ) const
+{
+    if ( m_busy && m_busy->m_fileName == fileName )
+    {
+        return( true );
+    }
+    for ( ComposerWriterPage *page = m_first;
+          page;
+          page = page->m_next )
+    {
+        if ( page->m_fileName == fileName )
+        {
+            return( true );
+        }
+    }
+    return( false );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Thread body: writes queued pages until told to stop.
+ */
+
+void ComposerWriter::run( void )
+{
+    m_mutex.lock();
+    while ( true )
+    {
+        while ( ! m_first && ! m_stop )
+        {
+            m_queued.wait( &m_mutex );
+        }
+        // Only stop once the queue is drained
+        if ( ! m_first )
+        {
+            break;
+        }
+        ComposerWriterPage *page = m_first;
+        if ( ! ( m_first = page->m_next ) )
+        {
+            m_last = 0;
+        }
+        m_busy = page;
+        m_mutex.unlock();
+
+        // Create and write the page file without holding the lock
+        bool ok = false;
+        QFile file( page->m_fileName );
+        if ( file.open( IO_WriteOnly ) )
+        {
+            ok = ( file.writeBlock( page->m_data, page->m_length )
+                == (int) page->m_length );
+            file.close();
+        }
+        delete[] page->m_data;
+        page->m_data = 0;
+
+        m_mutex.lock();
+        m_busy = 0;
+        if ( ! ok && ! m_failed.contains( page->m_fileName ) )
+        {
+            m_failed.append( page->m_fileName );
+        }
+        else if ( ok )
+        {
+            // A later, successful composition supersedes an earlier failure
+            m_failed.remove( page->m_fileName );
+        }
+        delete page;
+        // Wake flush( fileName ) callers as each page is written
+        m_written.wakeAll();
+    }
+    m_mutex.unlock();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Queues a finished page to be written to \a fileName.
+ *
+ *  \param fileName Full path name of the composer file.
+ *  \param data     Page contents allocated with new[]; the ComposerWriter
+ *                  takes ownership and deletes it once written.
+ *  \param length   Number of bytes in \a data.
+ */
+
+void ComposerWriter::write( const QString &fileName, char *data,
+        unsigned long length )
+{
+    ComposerWriterPage *page = new ComposerWriterPage;
+    checkmem( __FILE__, __LINE__, page, "ComposerWriterPage page", 1 );
+    // The QString must not share its data with the GUI thread's copy
+    page->m_fileName = QDeepCopy<QString>( fileName );
+    page->m_data = data;
+    page->m_length = length;
+    page->m_next = 0;
+
+    m_mutex.lock();
+    if ( m_last )
+    {
+        m_last->m_next = page;
+    }
+    else
+    {
+        m_first = page;
+    }
+    m_last = page;
+    m_queued.wakeAll();
+    m_mutex.unlock();
+    if ( ! running() )
+    {
+        start();
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+//  End of composerwriter.cpp
+//------------------------------------------------------------------------------
+
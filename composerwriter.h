@@ -0,0 +1,87 @@
+//------------------------------------------------------------------------------
+/*! \file composerwriter.h
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief ComposerWriter class declaration.
+ *
+ *  A ComposerWriter is a worker thread that creates and writes finished
+ *  composer pages to their files, so the GUI thread can go straight on to
+ *  composing the next page instead of waiting on file creation and disk
+ *  writes.  Pages are written in the order they are queued, so a page that
+ *  is composed twice always ends up with its last composition.
+ *
+ *  Anything that reads a composer file must first call flush( fileName ),
+ *  which waits only for that page, as Composer::paint() does.  Anything
+ *  that removes composer files must call flush() first, which waits for
+ *  every page, as Document::removeComposerFiles() does.  Both report
+ *  whether the pages they waited for were written.
+ */
+
+#ifndef _COMPOSERWRITER_H_
+/*! \def _COMPOSERWRITER_H_
+ *  \brief Prevent redundant includes.
+ */
+#define _COMPOSERWRITER_H_ 1
+
+// Qt include files
+#include <qmutex.h>
+#include <qstring.h>
+#include <qstringlist.h>
+#include <qthread.h>
+#include <qwaitcondition.h>
+
+//------------------------------------------------------------------------------
+/*! \class ComposerWriterPage composerwriter.h
+ *
+ *  \brief A finished composer page waiting to be written.
+ */
+
+class ComposerWriterPage
+{
+public:
+    QString             m_fileName; //!< Composer file name (a deep copy)
+    char               *m_data;     //!< Page contents (owned)
+    unsigned long       m_length;   //!< Number of bytes in m_data
+    ComposerWriterPage *m_next;     //!< Next page in the queue
+};
+
+//------------------------------------------------------------------------------
+/*! \class ComposerWriter composerwriter.h
+ *
+ *  \brief Worker thread that writes composer page files in the background.
+ */
+
+class ComposerWriter : public QThread
+{
+// Public methods
+public:
+    ComposerWriter( void ) ;
+    ~ComposerWriter( void ) ;
+    bool flush( QStringList *failedFiles=0 ) ;
+    bool flush( const QString &fileName ) ;
+    void write( const QString &fileName, char *data, unsigned long length ) ;
+
+// Protected methods
+protected:
+    bool pending( const QString &fileName ) const ;
+    virtual void run( void ) ;
+
+// Private data
+private:
+    QMutex              m_mutex;    //!< Guards all the following members
+    QWaitCondition      m_queued;   //!< Signalled when a page is queued
+    QWaitCondition      m_written;  //!< Signalled as each page is written
+    ComposerWriterPage *m_first;    //!< First page in the queue
+    ComposerWriterPage *m_last;     //!< Last page in the queue
+    ComposerWriterPage *m_busy;     //!< Page being written, or NULL
+    QStringList         m_failed;   //!< Files whose writes failed and are not yet reported
+    bool                m_stop;     //!< TRUE when the thread should exit
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of composerwriter.h
+//------------------------------------------------------------------------------
+
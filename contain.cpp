@@ -34,6 +34,9 @@
 #define M_PI 3.141592654
 #endif
 
+// Set TRUE to log every Contain::calcUh() evaluation to contain.log
+static const bool ContainLogSteps = false;
+
 //------------------------------------------------------------------------------
 /*! \brief Contain constructor.
  *
@@ -70,6 +73,8 @@ Contain::Contain( double reportSize, double reportRate, double lwRatio,
     m_eps(1.),
     m_eps2(1.),
     m_a(1.),
+    m_a2(1.),
+    m_epsRoot(1.),
     m_reportHead(0.),
     m_reportTime(0.),
     m_backRate(0.),
@@ -87,7 +92,12 @@ Contain::Contain( double reportSize, double reportRate, double lwRatio,
     m_h0(0.),
     m_x(0.),
     m_y(0.),
-    m_status(Unreported)
+    m_status(Unreported),
+    m_trigU(-1.),
+    m_cosU(0.),
+    m_sinU(0.),
+    m_trigPow(0.),
+    m_lastUh(0.)
 {
     // Set all the input parameters.
     setReport( reportSize, reportRate, lwRatio, distStep );
@@ -179,27 +189,30 @@ void Contain::calcU( void )
 
 bool Contain::calcUh( double p, double h, double u, double *d )
 {
-    // lastUh is used to check sign change between previous and current step
-    static double lastUh = 0.0;
-    double cosU = cos(u);
-    double sinU = sin(u);
+    // m_lastUh is used to check sign change between previous and current step
+    trig( u );
+    double cosU = m_cosU;
+    double sinU = m_sinU;
     *d = 0;
 
     // If the expression under the radical sign is negative,
     // must change course to avoid a complex (number) result
     double x = 1. - m_eps * cosU;
-    double uh_radical = ( p * p * x / ( 1. + m_eps * cosU ) ) - m_a * m_a;
+    double uh_radical = ( p * p * x / ( 1. + m_eps * cosU ) ) - m_a2;
 
     // The gcc and VC6 compilers yield different results for uh_radical
     // as ros approaches the fireline production rate;
     // uh_radical approaches zero faster under VC6 than under gcc.
-    // Enable the following containLog() calls to demonstrate.
-    containLog( false,
-        "\nStep %04d: p=%15.13f, h=%15.13f, u=%15.13f, sinU=%15.12f, cosU=%15.13f\n",
-        m_step+1, p, h, u, sinU, cosU );
-    containLog( false,
-        "           x=%15.13f, m_eps=%15.13f, m_a=%15.13f, uh_radical=%15.13f\n",
-        x, m_eps, m_a, uh_radical );
+    // Enable ContainLogSteps to demonstrate.
+    if ( ContainLogSteps )
+    {
+        containLog( true,
+            "\nStep %04d: p=%15.13f, h=%15.13f, u=%15.13f, sinU=%15.12f, cosU=%15.13f\n",
+            m_step+1, p, h, u, sinU, cosU );
+        containLog( true,
+            "           x=%15.13f, m_eps=%15.13f, m_a=%15.13f, uh_radical=%15.13f\n",
+            x, m_eps, m_a, uh_radical );
+    }
 
     if ( uh_radical <= 1.0e-10 )
     {
@@ -211,8 +224,7 @@ bool Contain::calcUh( double p, double h, double u, double *d )
     if ( m_attackDist > 0.001 )
     {
         dh = x * ( h + ( 1. - m_eps ) *
-           ( m_attackDist * sqrt( 1. - m_eps2 )
-             / exp( 1.5 * log( 1. - ( m_eps2 * cosU * cosU ) ) ) ) );
+           ( m_attackDist * m_epsRoot / m_trigPow ) );
     }
     // du is the change in angle of attack point from fire origin
     double du;
@@ -225,15 +237,18 @@ bool Contain::calcUh( double p, double h, double u, double *d )
         du = m_eps * sinU + ( 1. + m_eps ) * sqrt( uh_radical );
     }
     double uh = du / dh;
-    containLog( false,
-        "           sqrt(uh_radical)=%15.13f, du=%12.10f, dh=%12.10f, uh(du/dh)=%12.10f\n",
-        sqrt(uh_radical), du, dh, uh );
+    if ( ContainLogSteps )
+    {
+        containLog( true,
+            "           sqrt(uh_radical)=%15.13f, du=%12.10f, dh=%12.10f, uh(du/dh)=%12.10f\n",
+            sqrt(uh_radical), du, dh, uh );
+    }
 
     // If "angular rotation" has reversed. firefighters may be overrun
     // and cannot even build line making NO rotational progress
 	/* THE FOLLOWING CODE WAS REMOVED AT DIRECTION OF M.A.Finney and Fried
-	if ( ( m_tactic == RearAttack && lastUh < 0. && uh >= 0. )
-       | ( m_tactic == HeadAttack && lastUh > 0. && uh <= 0. ) )
+	if ( ( m_tactic == RearAttack && m_lastUh < 0. && uh >= 0. )
+       | ( m_tactic == HeadAttack && m_lastUh > 0. && uh <= 0. ) )
     {
         if ( m_step )
         {
@@ -242,8 +257,8 @@ bool Contain::calcUh( double p, double h, double u, double *d )
         }
     }
 	*/
-    // Store uh in lastUh and returned value
-    lastUh = uh;
+    // Store uh in m_lastUh and returned value
+    m_lastUh = uh;
     *d = uh;
     return( true );
 }
@@ -256,11 +271,26 @@ bool Contain::calcUh( double p, double h, double u, double *d )
 void Contain::calcCoordinates( void )
 {
     // Determine the x and y coordinate.
-    m_y = sin( m_u ) * m_h * m_a;
-    m_x = ( cos( m_u ) + m_eps ) * m_h / ( 1. + m_eps );
+    trig( m_u );
+    m_y = m_sinU * m_h * m_a;
+    m_x = ( m_cosU + m_eps ) * m_h / ( 1. + m_eps );
     if ( m_attackDist > 0.001 )
     {
-        double psiVal = containPsi( m_u, m_eps2 );
+        // Same as containPsi(), but reusing sin and cos of m_u unless
+        // containPsi() must nudge m_u away from pi/2
+        double psiVal;
+        if ( fabs( m_u - ( M_PI / 2. ) ) < 0.00001 )
+        {
+            psiVal = containPsi( m_u, m_eps2 );
+        }
+        else
+        {
+            psiVal = atan( ( m_sinU / m_cosU ) / m_epsRoot );
+            if ( psiVal < 0. )
+            {
+                psiVal += M_PI;
+            }
+        }
         m_y += m_attackDist * sin( psiVal );
         m_x += m_attackDist * cos( psiVal );
     }
@@ -356,6 +386,9 @@ void Contain::reset( void )
     m_eps2 = 1. - (r * r);
     m_eps = ( m_eps2 > 0.00001 ) ? sqrt( m_eps2 ) : 0.0;
     m_a = sqrt( (1. - m_eps) / (1. + m_eps) );
+    m_a2 = m_a * m_a;
+    m_epsRoot = sqrt( 1. - m_eps2 );
+    m_trigU = -1.;
 
     // Fire head position at time of report (ch)
     double ch2 = 10. * m_reportSize;
@@ -400,6 +433,7 @@ void Contain::reset( void )
     // Initialization
     m_step = 0;
     m_time = 0.0;
+    m_lastUh = 0.;
     m_rkpr[0] = m_rkpr[1] = m_rkpr[2] = 0.;
     m_status = Reported;        // Also means that we're initialized
 
@@ -620,6 +654,32 @@ double Contain::timeSinceReport( double headPos ) const
     return( 0. );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Sets m_cosU, m_sinU, and (for parallel attack) m_trigPow for
+ *  angle \a u.
+ *
+ *  The first Runga-Kutta stage of each step starts at the angle just used
+ *  by calcCoordinates(), so they are only recalculated when \a u changes.
+ *
+ *  \param u Angle from the fire origin to the point of active fireline
+ *            construction.
+ */
+
+void Contain::trig( double u )
+{
+    if ( u != m_trigU )
+    {
+        m_trigU = u;
+        m_cosU  = cos( u );
+        m_sinU  = sin( u );
+        if ( m_attackDist > 0.001 )
+        {
+            m_trigPow = exp( 1.5 * log( 1. - ( m_eps2 * m_cosU * m_cosU ) ) );
+        }
+    }
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief ContainForce constructor.
  */
@@ -627,11 +687,26 @@ double Contain::timeSinceReport( double headPos ) const
 ContainForce::ContainForce( int maxResources ) :
     m_cr(0),
     m_size(maxResources),
-    m_count(0)
+    m_count(0),
+    m_pool(0),
+    m_schedArrival(0),
+    m_schedEnd(0),
+    m_schedRate(0),
+    m_schedArrivals(0),
+    m_schedEnds(0),
+    m_schedFlank(NeitherFlank)
 {
     // Allocate ContainResource pointer array.
     m_cr = new ContainResource *[m_size];
     checkmem( __FILE__, __LINE__, m_cr, "ContainResource *m_cr", m_size );
+    // Allocate the production schedule arrays.
+    m_schedArrival = new double[m_size];
+    checkmem( __FILE__, __LINE__, m_schedArrival, "double m_schedArrival", m_size );
+    m_schedEnd = new double[m_size];
+    checkmem( __FILE__, __LINE__, m_schedEnd, "double m_schedEnd", m_size );
+    m_schedRate = new double[ContainScheduleMaxRates];
+    checkmem( __FILE__, __LINE__, m_schedRate, "double m_schedRate",
+        ContainScheduleMaxRates );
     return;
 }
 
@@ -641,11 +716,29 @@ ContainForce::ContainForce( int maxResources ) :
 
 ContainForce::~ContainForce( void )
 {
-    for ( int i=0; i<m_count; i++ )
+    for ( int i=0; i<m_pool; i++ )
     {
         delete m_cr[i];  m_cr[i] = 0;
     }
     delete[] m_cr;      m_cr = 0;
+    delete[] m_schedArrival;    m_schedArrival = 0;
+    delete[] m_schedEnd;        m_schedEnd = 0;
+    delete[] m_schedRate;       m_schedRate = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Removes all the ContainResources from the ContainForce.
+ *
+ *  The ContainResource records are kept and reused by subsequent
+ *  addResource() calls, so a ContainForce rebuilt for every table cell
+ *  only allocates them once.
+ */
+
+void ContainForce::clear( void )
+{
+    m_count = 0;
+    m_schedFlank = NeitherFlank;
     return;
 }
 
@@ -757,18 +850,30 @@ ContainResource *ContainForce::addResource(
         ContainFlank flank, const QString &desc,
         double baseCost, double hourCost )
 {
-    // Create a new ContainResource record.
-    ContainResource *rec = new ContainResource( arrival, production,
-        duration, flank, desc, baseCost, hourCost );
-    checkmem( __FILE__, __LINE__, rec, "ContainResource rec", 1 );
     // Check for vector space
     if ( m_count == m_size )
     {
         bomb( QString( "ContainForce::addResource() -- "
             "ContainForce::m_cr[%d] is full.\n" ).arg( m_size ) );
     }
+    // Any production schedule is now out of date
+    m_schedFlank = NeitherFlank;
+    // Reuse a ContainResource record left by clear()
+    ContainResource *rec;
+    if ( m_count < m_pool )
+    {
+        rec = m_cr[m_count++];
+        *rec = ContainResource( arrival, production,
+            duration, flank, desc, baseCost, hourCost );
+        return( rec );
+    }
+    // Create a new ContainResource record.
+    rec = new ContainResource( arrival, production,
+        duration, flank, desc, baseCost, hourCost );
+    checkmem( __FILE__, __LINE__, rec, "ContainResource rec", 1 );
     // Add the new record to the vector and return.
     m_cr[m_count++] = rec;
+    m_pool++;
     return( rec );
 }
 
@@ -790,6 +895,22 @@ ContainResource *ContainForce::addResource(
 double ContainForce::productionRate( double minSinceReport,
     ContainFlank flank ) const
 {
+    // Use the production schedule if there is one for this flank
+    if ( flank == m_schedFlank )
+    {
+        double after = minSinceReport + 0.001;
+        int a = 0;
+        while ( a < m_schedArrivals && m_schedArrival[a] <= after )
+        {
+            a++;
+        }
+        int e = 0;
+        while ( e < m_schedEnds && m_schedEnd[e] < minSinceReport )
+        {
+            e++;
+        }
+        return( m_schedRate[ a * ( m_schedEnds + 1 ) + e ] );
+    }
     double fpm = 0.0;
     for ( int i=0; i<m_count; i++ )
     {
@@ -985,6 +1106,83 @@ double ContainForce::resourceProduction( int index ) const
     return( 0.0 );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Builds the production schedule used by productionRate() for the
+ *  specified flank.
+ *
+ *  The aggregate production rate only changes at resource arrival and end
+ *  times.  The schedule stores the distinct arrival and end times, and the
+ *  rate for every pair of arrival and end intervals, summed over the
+ *  resources in the same order as productionRate() so the results are
+ *  identical.  productionRate() then finds the rate by locating the time
+ *  among the few distinct times rather than checking every resource.
+ *
+ *  The schedule is discarded by clear() and addResource().
+ *
+ *  \param flank One of LeftFlank or RightFlank.
+ *
+ *  \return TRUE if the schedule was built, FALSE if the force has too many
+ *  distinct times, in which case productionRate() checks every resource.
+ */
+
+bool ContainForce::schedule( ContainFlank flank )
+{
+    m_schedFlank = NeitherFlank;
+    m_schedArrivals = m_schedEnds = 0;
+    // Collect the distinct arrival and end times in ascending order
+    int i;
+    for ( i = 0;
+          i < m_count;
+          i++ )
+    {
+        if ( m_cr[i]->m_flank == flank || m_cr[i]->m_flank == BothFlanks )
+        {
+            containInsertTime( m_schedArrival, &m_schedArrivals,
+                m_cr[i]->m_arrival );
+            containInsertTime( m_schedEnd, &m_schedEnds,
+                m_cr[i]->m_arrival + m_cr[i]->m_duration );
+        }
+    }
+    if ( ( m_schedArrivals + 1 ) * ( m_schedEnds + 1 )
+        > ContainScheduleMaxRates )
+    {
+        return( false );
+    }
+    // A resource is producing in interval (a,e) if it arrived at or before
+    // m_schedArrival[a-1] and ends after m_schedEnd[e-1].
+    int a, e;
+    double fpm, *rate = m_schedRate;
+    for ( a = 0;
+          a <= m_schedArrivals;
+          a++ )
+    {
+        for ( e = 0;
+              e <= m_schedEnds;
+              e++ )
+        {
+            fpm = 0.0;
+            for ( i = 0;
+                  i < m_count;
+                  i++ )
+            {
+                if ( ( m_cr[i]->m_flank == flank
+                    || m_cr[i]->m_flank == BothFlanks )
+                  && a > 0
+                  && m_cr[i]->m_arrival <= m_schedArrival[a-1]
+                  && ( e == 0
+                    || ( m_cr[i]->m_arrival + m_cr[i]->m_duration )
+                        > m_schedEnd[e-1] ) )
+                {
+                    fpm += ( 0.50 * m_cr[i]->m_production );
+                }
+            }
+            *rate++ = fpm;
+        }
+    }
+    m_schedFlank = flank;
+    return( true );
+}
+
 //------------------------------------------------------------------------------
 /*! \brief ContainResource constructor.
  *
@@ -1077,6 +1275,9 @@ ContainSim::ContainSim( double reportSize, double reportRate, double lwRatio,
     {
         m_maxSteps = 10;
     }
+    // Every simulation step looks up the production rate three times
+    m_force->schedule( LeftFlank );
+
     double distStep = force->exhausted( LeftFlank ) * ( reportRate / 60. )
                     / (double) ( m_maxSteps - 2. );
 
@@ -1453,6 +1654,38 @@ void containLog( bool dolog, char *fmt, ... )
     return;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Inserts \a value into the ascending array \a times unless it is
+ *  already there.
+ *
+ *  \param times Array of ascending times.
+ *  \param n     Address of the number of \a times, incremented if \a value
+ *               is inserted.
+ *  \param value Time to insert.
+ */
+
+void containInsertTime( double *times, int *n, double value )
+{
+    int i = *n;
+    while ( i > 0 && times[i-1] > value )
+    {
+        i--;
+    }
+    if ( i > 0 && times[i-1] == value )
+    {
+        return;
+    }
+    for ( int j = *n;
+          j > i;
+          j-- )
+    {
+        times[j] = times[j-1];
+    }
+    times[i] = value;
+    (*n)++;
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Used only in the case of parallel attack, this function supplies
  *  values of Psi when translating from u,h to x,y.
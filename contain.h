@@ -82,6 +82,11 @@ enum ContainFlank
     NeitherFlank=3  //!< Attack neither flank (inactive)
 };
 
+/*! \var ContainScheduleMaxRates
+ *  \brief Maximum number of production rates in a ContainForce schedule.
+ */
+static const int ContainScheduleMaxRates = 1024;
+
 // Tactic enumerations
 enum ContainTactic
 {
@@ -144,6 +149,7 @@ public:
 private:
     void    calcU( void ) ;
     bool    calcUh( double r, double h, double u, double *d ) ;
+    void    trig( double u ) ;
 
 // Public data
 public:
@@ -163,6 +169,8 @@ public:
     double  m_eps;          //!< Fire eccentricity
     double  m_eps2;         //!< Fire eccentricity squared
     double  m_a;            //!< sqrt( (1.-m_eps) / (1.+m_eps) )
+    double  m_a2;           //!< m_a * m_a
+    double  m_epsRoot;      //!< sqrt( 1. - m_eps2 )
     double  m_reportHead;   //!< Fire head position at report time (ch)
     double  m_reportTime;   //!< Elapsed time from fire start to fire report (min)
     double  m_backRate;     //!< Fire backing spread rate (ch/h)
@@ -185,6 +193,13 @@ public:
     double  m_y;            //!< Current attack point y-coordinate (ch)
     ContainStatus m_status; //!< Status code.
 
+    // Trigonometry of the most recent angle, set by trig()
+    double  m_trigU;        //!< Angle of m_cosU, m_sinU, and m_trigPow
+    double  m_cosU;         //!< cos( m_trigU )
+    double  m_sinU;         //!< sin( m_trigU )
+    double  m_trigPow;      //!< ( 1 - m_eps2 * m_cosU * m_cosU )^1.5 for parallel attack
+    double  m_lastUh;       //!< calcUh() result of the previous step
+
     friend class ContainSim;
 };
 
@@ -206,10 +221,12 @@ public:
         double duration=480., ContainFlank flank=LeftFlank,
         const QString &desc="", double baseCost=0.0, double hourCost=0.0 );
 
+    void    clear( void ) ;
     double  exhausted( ContainFlank flank ) const ;
     double  firstArrival( ContainFlank flank ) const ;
     double  nextArrival( double after, double until, ContainFlank flank ) const ;
     double  productionRate( double minutesSinceReport, ContainFlank flank ) const ;
+    bool    schedule( ContainFlank flank ) ;
 
     // Public access to individual ContainResources
     int     resources( void ) const ;
@@ -227,6 +244,13 @@ private:
     ContainResource **m_cr;     //!< Array of pointers to ContainResources
     int     m_size;             //!< Size of m_cr
     int     m_count;            //!< Items in m_cr
+    int     m_pool;             //!< ContainResources allocated in m_cr
+    double *m_schedArrival;     //!< Sorted distinct resource arrival times (min)
+    double *m_schedEnd;         //!< Sorted distinct resource end times (min)
+    double *m_schedRate;        //!< Production rate for each arrival and end time interval (ch/h)
+    int     m_schedArrivals;    //!< Number of m_schedArrival[] times
+    int     m_schedEnds;        //!< Number of m_schedEnd[] times
+    ContainFlank m_schedFlank;  //!< Flank scheduled, or NeitherFlank if none
 
 friend class Contain;
 };
@@ -321,6 +345,8 @@ public:
 
 void containLog( bool dolog, char *fmt, ... ) ;
 
+void containInsertTime( double *times, int *n, double value ) ;
+
 double containPsi( double u, double eps2 ) ;
 
 #endif
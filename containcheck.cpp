@@ -0,0 +1,505 @@
+//------------------------------------------------------------------------------
+/*! \file containcheck.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Console driver that checks the ContainForce production schedule
+ *  gives exactly the production rates it replaces, compares a grid of
+ *  containment simulations with reference results, and times them.
+ *
+ *  Usage: containcheck
+ *
+ *  -# ContainForce::productionRate() of a scheduled force is compared with
+ *     the same force unscheduled (which checks every resource) for a set
+ *     of random forces, at every arrival and end time, just either side of
+ *     them, and on a fine time grid.  Some forces have more distinct times
+ *     than ContainScheduleMaxRates allows and so are never scheduled.
+ *  -# The 7200 ContainSim runs of a grid of 2 tactics, 40 report sizes,
+ *     30 spread rates, and 3 length-to-width ratios against an 8 resource
+ *     force are timed, and every 50th run is compared with the results
+ *     produced by contain.cpp before the production schedule was added.
+ *     The reference results were produced by gcc on x86-64 Linux; another
+ *     compiler's math library may differ in the last bits, so differences
+ *     in the final size, line, and time within a relative 1e-9 are reported
+ *     but are not failures.
+ *  -# The scheduled and unscheduled productionRate() calls are timed.
+ *
+ *  The program exits with status 1 if anything differs.
+ */
+
+// Custom include files
+#include "contain.h"
+
+// Standard include files
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*! \var CheckForces
+ *  \brief Number of random forces whose production rates are compared.
+ */
+static const int CheckForces = 500;
+
+/*! \var CheckTolerance
+ *  \brief Relative difference from the reference results that is reported
+ *  but not counted as a failure.
+ */
+static const double CheckTolerance = 1.0e-9;
+
+/*! \struct CheckReference
+ *  \brief Reference results of one ContainSim run.
+ */
+struct CheckReference
+{
+    int    run;     //!< Run number (base 1) in the simulation grid
+    double size;    //!< ContainSim::m_finalSize (ac)
+    double line;    //!< ContainSim::m_finalLine (ch)
+    double time;    //!< ContainSim::m_finalTime (min)
+    int    step;    //!< Left flank Contain::m_step
+    int    status;  //!< Left flank Contain::m_status
+};
+
+/*! \var Reference
+ *  \brief Every 50th run of the simulation grid, as produced by contain.cpp
+ *  before the production schedule was added.
+ */
+static const CheckReference Reference[] =
+{
+    {    50, 186.13937554221485, 165.82919541623767, 182.41202404809619,  739, 3 },
+    {   100, 63.183704524947103, 91.62000962409121, 123.56040080160319,  742, 3 },
+    {   150, 233.81412847318572, 208.61053097956082, 221.29266533066135,  742, 3 },
+    {   200, 20.002638795172246, 53.760315579538407, 95.41394789579158,  733, 3 },
+    {   250, 0, 963.79444668925601, 599.33867735470938,  384, 5 },
+    {   300, 31.571478558322269, 75.163744308516812, 118.60681362725452,  740, 3 },
+    {   350, 864.73384590414355, 356.92417272084913, 284.03030060120238,  746, 3 },
+    {   400, 4299.2803609364437, 760.41316307686498, 385.13026052104209,  416, 3 },
+    {   450, 1194.0988016877789, 471.49230554567094, 354.67935871743487,  745, 3 },
+    {   500, 222.64859364444857, 181.72330956975, 190.14949899799595,  745, 3 },
+    {   550, 85.059762848257378, 105.97354719891456, 130.92585170340681,  745, 3 },
+    {   600, 266.19031515922978, 222.83191869393804, 228.10581162324647,  741, 3 },
+    {   650, 28.997149635427924, 65.157676740604018, 104.37795591182363,  740, 3 },
+    {   700, 0, 963.79445059335728, 599.33867735470938,  384, 5 },
+    {   750, 41.391336588110427, 86.557009476533793, 124.92705410821642,  733, 3 },
+    {   800, 920.85429133051082, 368.40754545329349, 288.69466933867739,  746, 3 },
+    {   850, 4479.4135643020045, 776.12047146055158, 389.81963927855713,  422, 3 },
+    {   900, 1249.7536572272891, 482.6060917294148, 358.02340681362722,  746, 3 },
+    {   950, 245.98792313528247, 191.21350475146181, 194.66693386773545,  744, 3 },
+    {  1000, 100.94720292520651, 115.29831882544823, 135.78925851703409,  741, 3 },
+    {  1050, 288.85836696003099, 232.2819719006288, 232.57114228456913,  745, 3 },
+    {  1100, 36.328944461973883, 73.203093546795699, 110.63567134268534,  741, 3 },
+    {  1150, 0, 963.79445332699242, 599.33867735470938,  384, 5 },
+    {  1200, 49.494141225803475, 94.986219720233535, 129.30901803607213,  739, 3 },
+    {  1250, 963.57583523341464, 376.92058370504867, 292.11895791583163,  744, 3 },
+    {  1300, 4619.0203708868712, 787.99628650263298, 392.94589178356716,  426, 3 },
+    {  1350, 1293.3131187156309, 491.13377655005149, 360.35559118236472,  746, 3 },
+    {  1400, 265.19580742573015, 198.68967602069139, 198.25170340681365,  742, 3 },
+    {  1450, 114.49456003945016, 122.65491598021265, 139.46573146292582,  745, 3 },
+    {  1500, 307.78057714426541, 239.89175584317334, 236.29659318637277,  744, 3 },
+    {  1550, 42.925758403636429, 79.780108402867, 115.75334669338676,  738, 3 },
+    {  1600, 0, 963.79445554751987, 599.33867735470938,  384, 5 },
+    {  1650, 56.765185767751248, 101.99598536248202, 132.86252505010023,  736, 3 },
+    {  1700, 999.84863416275482, 384.0029235168787, 294.91382765531057,  746, 3 },
+    {  1750, 4737.7550806481859, 798.046844025062, 396.07214428857708,  430, 3 },
+    {  1800, 1330.6219749351499, 498.32496791178437, 362.4428857715431,  745, 3 },
+    {  1850, 282.08306938074531, 205.05068532818709, 201.34460921843691,  742, 3 },
+    {  1900, 126.71793824856032, 128.94701134979815, 142.73891783567132,  741, 3 },
+    {  1950, 324.54797734770693, 246.44260292409362, 239.39783567134273,  744, 3 },
+    {  2000, 49.08745987668226, 85.482337911931708, 120.16344689378754,  736, 3 },
+    {  2050, 0, 963.79445746080103, 599.33867735470949,  384, 5 },
+    {  2100, 63.517404025077127, 108.12672440351655, 136.0335871743487,  737, 3 },
+    {  2150, 1032.1349357255269, 390.20044970794248, 297.24601202404813,  746, 3 },
+    {  2200, 4843.0587995331971, 806.78258337433249, 398.41683366733463,  433, 3 },
+    {  2250, 1363.8312993996312, 504.65462977027011, 364.24256513026052,  746, 3 },
+    {  2300, 297.50059966561969, 210.69094561052276, 203.9706613226453,  744, 3 },
+    {  2350, 138.02289227755099, 134.51748383003542, 145.6765531062124,  745, 3 },
+    {  2400, 339.8679804635118, 252.28096112976118, 241.88737474949897,  745, 3 },
+    {  2450, 54.943819329015973, 90.575362359570235, 122.78012024048095,  739, 3 },
+    {  2500, 0, 963.79445916354894, 599.33867735470938,  384, 5 },
+    {  2550, 69.904730210130225, 113.64322583285845, 138.8690981963928,  742, 3 },
+    {  2600, 1061.5714966601925, 395.77271216036507, 299.57819639278563,  746, 3 },
+    {  2650, 4938.8910064787142, 814.6934806398001, 400.76152304609212,  436, 3 },
+    {  2700, 1394.2414565977642, 510.37951654413808, 365.79735470941887,  746, 3 },
+    {  2750, 311.82371108445807, 215.80465955468338, 206.45290581162325,  745, 3 },
+    {  2800, 148.64702487980139, 139.51173139728087, 148.16400801603206,  746, 3 },
+    {  2850, 354.1252948614536, 257.59575551661999, 244.04969939879766,  744, 3 },
+    {  2900, 60.548471217032059, 95.201919935468254, 125.09042084168334,  739, 3 },
+    {  2950, 0, 963.79446071041332, 599.33867735470938,  384, 5 },
+    {  3000, 76.021831647056388, 118.70110284419367, 141.52016032064128,  738, 3 },
+    {  3050, 1088.9611560822, 400.88490522018787, 301.13298597194387,  746, 3 },
+    {  3100, 5027.5403516032966, 822.00001276273724, 403.10621242484967,  439, 3 },
+    {  3150, 1422.4820781166666, 515.64330307054718, 367.35214428857711,  746, 3 },
+    {  3200, 325.33509002859358, 220.52070839763999, 208.78196392785571,  745, 3 },
+    {  3250, 158.86097483442501, 144.1677069236363, 150.62332665330661,  742, 3 },
+    {  3300, 367.56222283144018, 262.50640711280084, 245.86605210420845,  741, 3 },
+    {  3350, 65.994298397365498, 99.49060802746726, 127.4007214428858,  739, 3 },
+    {  3400, 0, 963.7944621358572, 599.33867735470938,  384, 5 },
+    {  3450, 81.921350485848961, 123.3972002763784, 143.82733466933865,  738, 3 },
+    {  3500, 1114.690394490352, 405.62788051119833, 302.44288577154305,  745, 3 },
+    {  3550, 5110.4316551067641, 828.62140208809797, 404.66933867735469,  441, 3 },
+    {  3600, 1449.001887039235, 520.54154205004181, 368.65370741482968,  745, 3 },
+    {  3650, 300.70201452714394, 263.03427099721728, 209.57819639278557,  746, 3 },
+    {  3700, 50.396424126687634, 82.054000328269083, 118.02901803607215,  741, 3 },
+    {  3750, 370.00558192647588, 365.20184767725777, 255.87174348697394,  289, 3 },
+    {  3800, 26.029410651944637, 72.007421264299538, 110.09042084168334,  739, 3 },
+    {  3850, 0, 963.79444383151224, 599.33867735470938,  384, 5 },
+    {  3900, 45.421676857776767, 115.83196972632663, 135.9320240480962,  742, 3 },
+    {  3950, 2295.4306136963191, 733.69421783725375, 373.88777555110221,  440, 3 },
+    {  4000, 4146.8698283942067, 746.95182685658153, 381.22244488977952,  411, 3 },
+    {  4050, 2103.9001642111921, 869.92792264065667, 412.96593186372746,  490, 3 },
+    {  4100, 376.63842067244116, 293.30048209823048, 224.0881763527054,  745, 3 },
+    {  4150, 70.725786977315508, 96.810839598995727, 126.2677354709419,  745, 3 },
+    {  4200, 441.74432116585672, 394.47908756077913, 267.59519038076149,  304, 3 },
+    {  4250, 39.118764687620569, 87.864584243792066, 121.6419238476954,  739, 3 },
+    {  4300, 0, 963.79444777635786, 599.33867735470938,  384, 5 },
+    {  4350, 60.593385393018252, 132.4843578318596, 144.59174348697394,  743, 3 },
+    {  4400, 2437.9694560358071, 753.71153848680331, 379.35871743486979,  447, 3 },
+    {  4450, 4325.17356066911, 762.73801635557277, 385.91182364729457,  417, 3 },
+    {  4500, 2231.9906684286893, 893.76302729938811, 419.21843687374752,  498, 3 },
+    {  4550, 425.49049441895335, 311.29574729576927, 233.20641282565128,  260, 3 },
+    {  4600, 85.571147087307338, 106.28523252852079, 131.15615230460921,  741, 3 },
+    {  4650, 491.67708327219009, 413.83172369881072, 275.41082164328657,  314, 3 },
+    {  4700, 49.409523615748917, 97.806878114828166, 126.78356713426854,  743, 3 },
+    {  4750, 0, 963.7944505384088, 599.33867735470938,  384, 5 },
+    {  4800, 73.00547808534175, 144.77680833992486, 150.94845691382767,  744, 3 },
+    {  4850, 2545.4976933933794, 768.52109355809625, 384.04809619238478,  453, 3 },
+    {  4900, 4463.4201381359953, 774.75523390007504, 389.81963927855713,  422, 3 },
+    {  4950, 2332.3108892813793, 912.03836504168225, 424.68937875751504,  505, 3 },
+    {  5000, 466.08391946901685, 325.51436431405483, 239.45891783567137,  268, 3 },
+    {  5050, 98.29380710403457, 113.77948672896817, 135.01707414829662,  741, 3 },
+    {  5100, 533.29352609897614, 429.38224317986317, 281.66332665330663,  322, 3 },
+    {  5150, 58.403921014670054, 105.73541878886105, 130.79038076152304,  744, 3 },
+    {  5200, 0, 963.79445278194703, 599.33867735470938,  384, 5 },
+    {  5250, 84.103043691469068, 154.98194228182552, 156.03591182364727,  742, 3 },
+    {  5300, 2636.18841650798, 780.82141710388555, 387.17434869739481,  457, 3 },
+    {  5350, 4580.9386194094322, 784.82502313763121, 392.16432865731457,  425, 3 },
+    {  5400, 2418.2660055076703, 927.44218091936364, 429.37875751503009,  511, 3 },
+    {  5450, 501.7445497391775, 336.78572409646188, 244.14829659318644,  274, 3 },
+    {  5500, 109.79633278684342, 120.15031840856942, 138.25170340681359,  742, 3 },
+    {  5550, 570.15471367873249, 442.75328072847782, 287.13426853707409,  329, 3 },
+    {  5600, 66.697689660714246, 112.58807338384506, 134.38557114228456,  742, 3 },
+    {  5650, 0, 963.79445471500685, 599.33867735470949,  384, 5 },
+    {  5700, 94.411637629081099, 163.92052006871421, 160.67527054108214,  742, 3 },
+    {  5750, 2716.4478011986707, 791.57031938073771, 390.30060120240483,  461, 3 },
+    {  5800, 4685.2143686174413, 793.65219793990548, 394.50901803607212,  428, 3 },
+    {  5850, 2495.0474767897745, 941.00536845655165, 433.2865731462926,  516, 3 },
+    {  5900, 533.79051341929005, 346.3459217337986, 248.0561122244489,  279, 3 },
+    {  5950, 120.45367285190297, 125.76280577571497, 141.16745490981964,  746, 3 },
+    {  6000, 603.83791897819617, 454.65879962236392, 291.82364729458919,  335, 3 },
+    {  6050, 74.504291990169449, 118.69513264231243, 137.47847695390786,  742, 3 },
+    {  6100, 0, 963.79445643531324, 599.33867735470938,  384, 5 },
+    {  6150, 104.14185236293125, 171.93946777705358, 164.72272545090181,  743, 3 },
+    {  6200, 2789.4283664080317, 801.2368668563704, 392.64529058116233,  464, 3 },
+    {  6250, 4780.0861293246508, 801.59811437098438, 396.85370741482967,  431, 3 },
+    {  6300, 2565.3166155365298, 953.25868738731913, 436.41282565130263,  520, 3 },
+    {  6350, 563.26716419644072, 354.85605058311586, 251.9639278557114,  284, 3 },
+    {  6400, 130.53976912178879, 130.84693822405413, 143.66428857715431,  742, 3 },
+    {  6450, 635.20491596991781, 465.49587209414113, 295.7314629258517,  340, 3 },
+    {  6500, 81.950087144321884, 124.26148309442944, 140.27334669338674,  740, 3 },
+    {  6550, 0, 963.79445799810082, 599.33867735470938,  384, 5 },
+    {  6600, 113.48817167593225, 179.31510079862744, 168.59406813627254,  743, 3 },
+    {  6650, 2856.9586662577467, 810.08889472395765, 395.77154308617224,  468, 3 },
+    {  6700, 4867.8337282513739, 808.8771738314548, 399.19839679358711,  434, 3 },
+    {  6750, 2630.6527309729254, 964.52749853699004, 439.53907815631266,  524, 3 },
+    {  6800, 590.81437367131002, 362.61336214320659, 255.09018036072143,  288, 3 },
+    {  6850, 140.12938431228795, 135.50364030498611, 146.14028056112224,  743, 3 },
+    {  6900, 664.78740805684947, 475.51188007926322, 299.63927855711421,  345, 3 },
+    {  6950, 89.150174259034983, 129.42952346614075, 143.04320641282561,  743, 3 },
+    {  7000, 0, 963.79445943819076, 599.33867735470938,  384, 5 },
+    {  7050, 122.52813806474151, 186.18159223941666, 172.07254509018034,  745, 3 },
+    {  7100, 2920.2096803227441, 818.30445146623799, 398.11623246492991,  471, 3 },
+    {  7150, 4949.9423252853567, 815.62891042182434, 401.54308617234472,  437, 3 },
+    {  7200, 2692.0857790988871, 975.01227808249803, 442.66533066132263,  528, 3 }
+};
+
+/*! \var References
+ *  \brief Number of Reference[] runs.
+ */
+static const int References = sizeof(Reference) / sizeof(Reference[0]);
+
+/*! \var Seed
+ *  \brief Random number generator state, so every platform checks the same
+ *  forces.
+ */
+static unsigned long Seed = 12345;
+
+//------------------------------------------------------------------------------
+/*! \brief Simple linear congruential random number generator.
+ *
+ *  \return Random number in the range [0,1).
+ */
+
+static double uniform( void )
+{
+    Seed = ( Seed * 1103515245UL + 12345UL ) & 0x7fffffffUL;
+    return( (double) Seed / 2147483648.0 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Adds the same random resources to both \a scheduled and
+ *  \a unscheduled.
+ *
+ *  Arrival times and durations are drawn from a few coarse values so that
+ *  many resources share arrival and end times, as in real forces.
+ *
+ *  \param resources Number of resources to add.
+ */
+
+static void randomForce( ContainForce *scheduled, ContainForce *unscheduled,
+        int resources )
+{
+    static const ContainFlank Flank[4] =
+        { LeftFlank, RightFlank, BothFlanks, LeftFlank };
+    scheduled->clear();
+    unscheduled->clear();
+    for ( int i = 0;
+          i < resources;
+          i++ )
+    {
+        double arrival = 15. * (int) ( 40. * uniform() );
+        double production = 1. + (int) ( 60. * uniform() ) + uniform();
+        double duration = 30. * ( 1 + (int) ( 16. * uniform() ) );
+        ContainFlank flank = Flank[ (int) ( 4. * uniform() ) ];
+        scheduled->addResource( arrival, production, duration, flank );
+        unscheduled->addResource( arrival, production, duration, flank );
+    }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Compares the scheduled and unscheduled production rates of
+ *  \a scheduled and \a unscheduled at time \a minutes.
+ *
+ *  \return 1 if they differ, 0 if they are identical.
+ */
+
+static int compareRate( const ContainForce &scheduled,
+        const ContainForce &unscheduled, double minutes )
+{
+    double a = scheduled.productionRate( minutes, LeftFlank );
+    double b = unscheduled.productionRate( minutes, LeftFlank );
+    if ( a != b )
+    {
+        fprintf( stderr, "productionRate(%.17g): scheduled %.17g,"
+            " unscheduled %.17g\n", minutes, a, b );
+        return( 1 );
+    }
+    return( 0 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Compares the scheduled and unscheduled production rates of
+ *  CheckForces random forces.
+ *
+ *  \return Number of differences.
+ */
+
+static int checkSchedule( void )
+{
+    ContainForce scheduled( 600 );
+    ContainForce unscheduled( 600 );
+    int diffs = 0;
+    int forces = 0;
+    int fallbacks = 0;
+    long checks = 0;
+    for ( int f = 0;
+          f < CheckForces;
+          f++ )
+    {
+        // Every 10th force is too large to schedule
+        int resources = ( f % 10 == 9 )
+                      ? 400 + (int) ( 100. * uniform() )
+                      : 1 + (int) ( 40. * uniform() );
+        randomForce( &scheduled, &unscheduled, resources );
+        if ( scheduled.schedule( LeftFlank ) )
+        {
+            forces++;
+        }
+        else
+        {
+            fallbacks++;
+        }
+        // At, and either side of, every arrival and end time
+        static const double Offset[7] =
+            { 0., 0.001, -0.001, 0.0011, 0.0009, 1.0e-9, -1.0e-9 };
+        for ( int i = 0;
+              i < scheduled.resources();
+              i++ )
+        {
+            double arrival = scheduled.resourceArrival( i );
+            double end = arrival + scheduled.resourceDuration( i );
+            for ( int o = 0;
+                  o < 7;
+                  o++ )
+            {
+                diffs += compareRate( scheduled, unscheduled,
+                    arrival + Offset[o] );
+                diffs += compareRate( scheduled, unscheduled,
+                    end + Offset[o] );
+                checks += 2;
+            }
+        }
+        // On a fine time grid
+        for ( double minutes = 0.;
+              minutes <= 1200.;
+              minutes += 0.125 )
+        {
+            diffs += compareRate( scheduled, unscheduled, minutes );
+            checks++;
+        }
+    }
+    fprintf( stdout, "productionRate: %d scheduled forces, %d too large to"
+        " schedule, %ld rates, %d differences\n",
+        forces, fallbacks, checks, diffs );
+    return( diffs );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Runs the simulation grid, compares it with the Reference[]
+ *  results, and times it.
+ *
+ *  \return Number of failures.
+ */
+
+static int checkSimulations( void )
+{
+    static const double Arrival[8] =
+        { 30., 45., 60., 90., 120., 180., 240., 300. };
+    static const double Production[8] =
+        { 20., 15., 30., 12., 40., 8., 25., 60. };
+    ContainForce force;
+    int run = 0;
+    int ref = 0;
+    int same = 0;
+    int close = 0;
+    int fails = 0;
+    clock_t t0 = clock();
+    for ( int tactic = 0;
+          tactic < 2;
+          tactic++ )
+    {
+        for ( int s = 1;
+              s <= 40;
+              s++ )
+        {
+            for ( int r = 1;
+                  r <= 30;
+                  r++ )
+            {
+                for ( int l = 0;
+                      l < 3;
+                      l++ )
+                {
+                    force.clear();
+                    for ( int i = 0;
+                          i < 8;
+                          i++ )
+                    {
+                        force.addResource( Arrival[i], Production[i], 480.,
+                            LeftFlank, "r", 100., 10. );
+                    }
+                    ContainSim sim( 0.5 * s, 2. * r, 1. + 1.5 * l, &force,
+                        (ContainTactic) tactic, tactic ? 0. : 1.,
+                        1000000., true, 250, 1000 );
+                    sim.run();
+                    run++;
+                    if ( ref >= References || Reference[ref].run != run )
+                    {
+                        continue;
+                    }
+                    const CheckReference &x = Reference[ref++];
+                    if ( sim.m_finalSize == x.size
+                      && sim.m_finalLine == x.line
+                      && sim.m_finalTime == x.time
+                      && sim.m_left->m_step == x.step
+                      && (int) sim.m_left->m_status == x.status )
+                    {
+                        same++;
+                        continue;
+                    }
+                    bool near = sim.m_left->m_step == x.step
+                        && (int) sim.m_left->m_status == x.status
+                        && fabs( sim.m_finalSize - x.size )
+                            <= CheckTolerance * fabs( x.size )
+                        && fabs( sim.m_finalLine - x.line )
+                            <= CheckTolerance * fabs( x.line )
+                        && fabs( sim.m_finalTime - x.time )
+                            <= CheckTolerance * fabs( x.time );
+                    if ( near )
+                    {
+                        close++;
+                    }
+                    else
+                    {
+                        fails++;
+                    }
+                    fprintf( stderr, "run %d: size %.17g line %.17g time"
+                        " %.17g step %d status %d, reference %.17g %.17g"
+                        " %.17g %d %d\n", run, sim.m_finalSize,
+                        sim.m_finalLine, sim.m_finalTime, sim.m_left->m_step,
+                        (int) sim.m_left->m_status, x.size, x.line, x.time,
+                        x.step, x.status );
+                }
+            }
+        }
+    }
+    double secs = (double) ( clock() - t0 ) / CLOCKS_PER_SEC;
+    fprintf( stdout, "ContainSim: %d runs in %.2f s (%.1f us/run)\n",
+        run, secs, 1.0e6 * secs / run );
+    fprintf( stdout, "ContainSim: %d reference runs, %d identical,"
+        " %d within %g, %d different\n",
+        References, same, close, CheckTolerance, fails );
+    return( fails );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Times productionRate() with and without a schedule for a typical
+ *  force.
+ */
+
+static void timeSchedule( void )
+{
+    ContainForce scheduled;
+    ContainForce unscheduled;
+    randomForce( &scheduled, &unscheduled, 12 );
+    scheduled.schedule( LeftFlank );
+    const ContainForce *force[2] = { &unscheduled, &scheduled };
+    double secs[2], sum[2];
+    for ( int k = 0;
+          k < 2;
+          k++ )
+    {
+        sum[k] = 0.;
+        clock_t t0 = clock();
+        for ( int pass = 0;
+              pass < 200;
+              pass++ )
+        {
+            for ( double minutes = 0.;
+                  minutes < 1000.;
+                  minutes += 0.1 )
+            {
+                sum[k] += force[k]->productionRate( minutes, LeftFlank );
+            }
+        }
+        secs[k] = (double) ( clock() - t0 ) / CLOCKS_PER_SEC;
+    }
+    fprintf( stdout, "productionRate: 2000000 calls, %.3f s unscheduled,"
+        " %.3f s scheduled (sums %.17g %.17g)\n",
+        secs[0], secs[1], sum[0], sum[1] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Main entry point.
+ */
+
+int main( int, char ** )
+{
+    int diffs = checkSchedule();
+    diffs += checkSimulations();
+    timeSchedule();
+    return( diffs ? 1 : 0 );
+}
+
+//------------------------------------------------------------------------------
+//  End of containcheck.cpp
+//------------------------------------------------------------------------------
@@ -18,6 +18,7 @@
 #include <qpaintdevice.h>
 #include <qpaintdevicemetrics.h>
 #include <qpainter.h>
+#include <qwmatrix.h>
 
 // Standard include files
 #include <stdio.h>
@@ -181,23 +182,71 @@ void DocScrollView::keyPressEvent( QKeyEvent *e )
     return;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Paints the composer file onto the backing pixmap and updates the
+ *  viewport, leaving the scroll position alone.
+ *
+ *  Called by showPage() and by Document::renderPage() to replace the quick
+ *  scaled copy left by rescale().
+ *
+ *  \return TRUE on success, FALSE if unable to open the composer file.
+ */
+
+bool DocScrollView::paintPage( Composer *composer, const QString &composerFile )
+{
+    if ( ! composer->paint( composerFile,
+        &m_backingPixmap,
+        m_screenSize->m_xppi,
+        m_screenSize->m_yppi,
+        m_screenSize->m_scale,
+        false ) )
+    {
+        return( false );
+    }
+    viewport()->update();
+    return( true );
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Rescales the backing pixmap to the view scale.
+ *
+ *  Rather than repainting the page, the current page image is stretched or
+ *  shrunk to the new size so the user sees the zoom at once.  The Document
+ *  then repaints the page at full quality via paintPage() once the zooming
+ *  stops.  The same part of the page is kept in view.
  *
  *  Called only by Document::rescale() via DocScrollView::rescale().
  */
 
 void DocScrollView::rescale( void )
 {
-    // Reset viewport to background color in case the pixmap is shrinking,
+    // The screenDevice has already been scaled before this was called,
+    // so simply match the pixmap to it.
+    int oldWd = m_backingPixmap.width();
+    int oldHt = m_backingPixmap.height();
+    int newWd = m_screenSize->m_pageWd;
+    int newHt = m_screenSize->m_pageHt;
+    if ( oldWd == newWd && oldHt == newHt )
+    {
+        return;
+    }
+    double sx = (double) newWd / (double) oldWd;
+    double sy = (double) newHt / (double) oldHt;
+    QWMatrix matrix;
+    matrix.scale( sx, sy );
+    QPixmap scaled = m_backingPixmap.xForm( matrix );
+    m_backingPixmap.resize( newWd, newHt );
     m_backingPixmap.fill( backgroundColor() );
+    bitBlt( &m_backingPixmap, 0, 0, &scaled, 0, 0,
+        ( scaled.width() < newWd ) ? scaled.width() : newWd,
+        ( scaled.height() < newHt ) ? scaled.height() : newHt );
+
+    // Keep the same part of the page in view
+    int x = (int) ( sx * (double) contentsX() );
+    int y = (int) ( sy * (double) contentsY() );
+    resizeContents( newWd, newHt );
+    setContentsPos( x, y );
     viewport()->update();
-    qApp->processEvents();
-    // The screenDevice has already been scaled before this was called,
-    // so simply reset the pixmap size to match it.
-    m_backingPixmap.resize( m_screenSize->m_pageWd, m_screenSize->m_pageHt );
-    // Repaint the viewport's background
-    viewport()->repaint();
     return;
 }
 
@@ -228,18 +277,11 @@ void DocScrollView::resizeEvent( QResizeEvent* e )
 bool DocScrollView::showPage( Composer *composer, const QString &composerFile )
 {
     // Paint the composer file on the backing pixmap
-    if ( ! composer->paint( composerFile,
-        &m_backingPixmap,
-        m_screenSize->m_xppi,
-        m_screenSize->m_yppi,
-        m_screenSize->m_scale,
-        false ) )
+    // (which also updates the viewport to get rid of previous contents)
+    if ( ! paintPage( composer, composerFile ) )
     {
         return( false );
     }
-    // Must call this to get rid of previous contents
-    viewport()->update();
-
     // Force a scrollbar update
     document()->show();
     resizeContents( m_backingPixmap.width(), m_backingPixmap.height() );
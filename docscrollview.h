@@ -33,6 +33,7 @@ class DocScrollView : public QScrollView
 public:
     DocScrollView( QWidget *qMainWindow, DocDeviceSize *docDeviceSize,
         const char *name=0 ) ;
+    bool paintPage( Composer *composer, const QString &composerFile ) ;
     void rescale( void ) ;
     bool showPage( Composer *composer, const QString &composerFile ) ;
 
@@ -9,6 +9,7 @@
 // Custom include files
 #include "appfilesystem.h"
 #include "appmessage.h"
+#include "appproperty.h"
 #include "apptranslator.h"
 #include "composer.h"
 #include "docdevicesize.h"
@@ -37,6 +38,7 @@
 #include <qprinter.h>
 #include <qprogressdialog.h>
 #include <qtextstream.h>
+#include <qtimer.h>
 #include <qworkspace.h>
 
 // Standard include files
@@ -62,6 +64,7 @@ Document::Document( QWorkspace *workspace, const QString &docType, int docId,
     m_maintenanceMenu(0),
     m_composer(0),
     m_tabs(0),
+    m_renderTimer(0),
     m_docType(docType),
     m_absPathName(""),
     m_baseName(""),
@@ -103,6 +106,13 @@ Document::Document( QWorkspace *workspace, const QString &docType, int docId,
     m_tabs = new DocTabs( 0, 4, "Tab 1" );
     Q_CHECK_PTR( m_tabs );
 
+    // Single-shot timer that repaints the page once rescaling stops.
+    // Note that QTimer objects are destroyed when their parent is destroyed.
+    m_renderTimer = new QTimer( this, "m_renderTimer" );
+    Q_CHECK_PTR( m_renderTimer );
+    connect( m_renderTimer, SIGNAL( timeout() ),
+             this,          SLOT( renderPage() ) );
+
     // Note that the contextMenu must be created in the derived class's
     // constructor since it is a virtual function call.
     return;
@@ -205,6 +215,12 @@ bool Document::capture( void )
     // Save the file.
     QImageIO iio;
     QImage   image;
+    if ( m_renderTimer->isActive() )
+    {
+        // Replace the stretched page left by rescale()
+        m_renderTimer->stop();
+        renderPage();
+    }
     image = m_scrollView->m_backingPixmap;
     iio.setImage( image );
     iio.setFileName( fileName );
@@ -977,17 +993,25 @@ bool Document::printPS( int fromPage, int thruPage )
  *  function removeComposerFiles().
  *
  *  \param fromPageNumber Number of the first page to be removed (the first
- *  page is page 1, NOT PAGE 0).
+ *  page is page 1, NOT PAGE 0).  If all pages are removed, the Composer's
+ *  shared resource tables are also cleared.
  */
 
 void Document::removeComposerFiles( int fromPageNumber )
 {
+    // Pages still queued for writing must not be written after removal.
+    m_composer->flush();
     for ( int i = fromPageNumber;
           i <= m_pages;
           i++ )
     {
         QFile::remove( appFileSystem()->composerFilePath( m_docId, i ) );
     }
+    // The shared composer resources are no longer referenced by any page.
+    if ( fromPageNumber <= 1 )
+    {
+        m_composer->clearResources();
+    }
     return;
 }
 
@@ -1017,11 +1041,40 @@ void Document::rescale( int points )
     m_fixedFont.setPointSize( m_fontScaleSize );
     m_propFont.setPointSize( m_fontScaleSize );
 
-    // Rescale the backing QPixmap in the scrollView
+    // Stretch the backing QPixmap in the scrollView for immediate feedback,
+    // and repaint it at the new scale once the user stops rescaling.
     m_scrollView->rescale();
+    m_renderTimer->start( DocumentRenderDelay, true );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Repaints the current page at the current scale, replacing the
+ *  stretched page image left by DocScrollView::rescale().
+ *
+ *  Invoked by m_renderTimer DocumentRenderDelay ms after the last
+ *  rescale(), so a run of quick zooms renders the page only once.
+ *
+ *  The repaint runs on the GUI thread rather than in the background:
+ *  Qt 3 only allows QPixmap, QFont, and QPainter to be used from the GUI
+ *  thread, and the composer replay needs all three.  Deferring it until
+ *  the user stops zooming is the closest this toolkit allows, while the
+ *  ComposerWriter keeps the page file I/O off the GUI thread.
+ */
 
-    // Re-display the current page in the new scale
-    showPage( m_page );
+void Document::renderPage( void )
+{
+    if ( m_page < 1 || m_page > m_pages )
+    {
+        return;
+    }
+    QString composerFile = appFileSystem()->composerFilePath( m_docId, m_page );
+    if ( ! m_scrollView->paintPage( m_composer, composerFile ) )
+    {
+        QString msg("");
+        translate( msg, "Document:ShowPage:NoComposerFile", composerFile );
+        bomb( msg );
+    }
     return;
 }
 
@@ -1152,6 +1205,9 @@ void Document::showPage( int pageNumber )
     // Find the name of the file for this page.
     QString composerFile = appFileSystem()->composerFilePath( m_docId, m_page );
 
+    // The page is painted at the current scale, so no repaint is pending
+    m_renderTimer->stop();
+
     // Display the page file in the DocScrollView
     if ( ! m_scrollView->showPage( m_composer, composerFile ) )
     {
@@ -1190,7 +1246,8 @@ void Document::startNewPage( const QString &tocName, TocType tocType )
     // Get the new page's composer file name
     QString composerFile = appFileSystem()->composerFilePath( m_docId, m_pages );
 
-    // Open the new composer file
+    // Open the new composer file, checking its replay if requested
+    m_composer->setVerify( appProperty()->boolean( "appComposerVerify" ) );
     if ( ! m_composer->begin( composerFile ) )
     {
         QString msg("");
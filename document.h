@@ -27,8 +27,16 @@ class QEvent;
 class QObject;
 class QPopupMenu;
 class QString;
+class QTimer;
 class QWorkspace;
 
+/*! \var DocumentRenderDelay
+ *  \brief Milliseconds after the last rescale() before the page is
+ *  repainted at full quality on the GUI thread (see
+ *  Document::renderPage()).
+ */
+static const int DocumentRenderDelay = 200;
+
 //------------------------------------------------------------------------------
 /*! \class Document document.h
  *
@@ -138,6 +146,7 @@ signals:
 // Protected slots
 protected slots:
     virtual void contextMenuActivated( int id ) = 0;
+    void renderPage( void ) ;
     virtual void rescale( int points ) = 0;
 
 // Protected methods
@@ -156,6 +165,7 @@ public:
     QPopupMenu     *m_maintenanceMenu;  //!< Maintenance menu
     Composer       *m_composer;     //!< Composer for drawing to composer files
     DocTabs        *m_tabs;         //!< Pointer to Document tabs
+    QTimer         *m_renderTimer;  //!< Repaints the page after a rescale()
     QString         m_docType;      //!< Document type ("BehavePlus", "Text", etc. )
     QString         m_absPathName;  //!< Document file's full absolute path name
     QString         m_baseName;     //!< Document file's base name (no extension)
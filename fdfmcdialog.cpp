@@ -13,6 +13,7 @@
 #include "appproperty.h"
 #include "apptranslator.h"
 #include "fdfmcdialog.h"
+#include "xfblib.h"
 
 // Qt include files
 #include <qcombobox.h>
@@ -138,62 +139,6 @@ static const char *TodValue[TodValues] =
     "18:00 - Sunset"
 };
 
-static const int Reference[DbValues][RhValues] =
-{
-    { 1, 2, 2, 3, 4, 5, 5, 6, 7, 8, 8, 8, 9, 9, 10, 11, 12, 12, 13, 13, 14 },
-    { 1, 2, 2, 3, 4, 5, 5, 6, 7, 7, 7, 8, 9, 9, 10, 10, 11, 12, 13, 13, 13 },
-    { 1, 2, 2, 3, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9,  9, 10, 11, 12, 12, 12, 13 },
-    { 1, 1, 2, 2, 3, 4, 5, 5, 6, 7, 7, 8, 8, 8,  9, 10, 10, 11, 12, 12, 13 },
-    { 1, 1, 2, 2, 3, 4, 4, 5, 6, 7, 7, 8, 8, 8,  9, 10, 10, 11, 12, 12, 13 },
-    { 1, 1, 2, 2, 3, 4, 4, 5, 6, 7, 7, 8, 8, 8,  9, 10, 10, 11, 12, 12, 12 }
-};
-
-static const int Correction[36][18] =
-{
-    // May-Jun-Jul Exposed
-    { 2, 3, 4, 1, 1, 1, 0, 0, 1, 0, 0, 1, 1, 1, 1, 2, 3, 4 },
-    { 3, 4, 4, 1, 2, 2, 1, 1, 2, 1, 1, 2, 1, 2, 2, 3, 4, 4 },
-    { 2, 2, 3, 1, 1, 1, 0, 0, 1, 0, 0, 1, 1, 1, 2, 3, 4, 4 },
-    { 1, 2, 2, 0, 0, 1, 0, 0, 1, 1, 1, 2, 2, 3, 4, 4, 5, 6 },
-    { 2, 3, 3, 1, 1, 1, 0, 0, 1, 0, 0, 1, 1, 1, 1, 2, 3, 3 },
-    { 2, 3, 3, 1, 1, 2, 0, 1, 1, 0, 1, 1, 1, 1, 2, 2, 3, 3 },
-    { 2, 3, 4, 1, 1, 2, 0, 0, 1, 0, 0, 1, 0, 1, 1, 2, 3, 3 },
-    { 4, 5, 6, 2, 3, 4, 1, 1, 2, 0, 0, 1, 0, 0, 1, 1, 2, 2 },
-    // May-Jun-Jul Shaded
-    { 4, 5, 5, 3, 4, 5, 3, 3, 4, 3, 3, 4, 3, 4, 5, 4, 5, 5 },
-    { 4, 4, 5, 3, 4, 5, 3, 3, 4, 3, 4, 4, 3, 4, 5, 4, 5, 6 },
-    { 4, 4, 5, 3, 4, 5, 3, 3, 4, 3, 3, 4, 3, 4, 5, 4, 5, 5 },
-    { 4, 5, 6, 3, 4, 5, 3, 3, 4, 3, 3, 4, 3, 4, 5, 4, 4, 5 },
-    // Feb-Mar-Apr/Aug-Sep-Oct Exposed
-    { 3, 4, 5, 1, 2, 3, 1, 1, 2, 1, 1, 2, 1, 2, 3, 3, 4, 5 },
-    { 3, 4, 5, 3, 3, 4, 2, 3, 4, 2, 3, 4, 3, 3, 4, 3, 4, 5 },
-    { 3, 4, 5, 1, 2, 3, 1, 1, 1, 1, 1, 2, 1, 2, 3, 3, 4, 5 },
-    { 3, 3, 4, 1, 1, 1, 1, 1, 1, 1, 2, 3, 3, 4, 5, 3, 4, 6 },
-    { 3, 4, 5, 1, 2, 2, 1, 1, 1, 1, 1, 1, 1, 2, 3, 3, 4, 5 },
-    { 3, 4, 5, 1, 2, 2, 0, 1, 1, 0, 1, 1, 1, 2, 2, 3, 4, 5 },
-    { 3, 4, 5, 1, 2, 3, 1, 1, 1, 1, 1, 1, 1, 2, 3, 3, 4, 5 },
-    { 4, 5, 6, 3, 4, 5, 1, 2, 3, 1, 1, 1, 1, 1, 1, 3, 3, 4 },
-    // Feb-Mar-Apr/Aug-Sep-Oct Shaded
-    { 4, 5, 6, 4, 5, 5, 3, 4, 5, 3, 4, 5, 4, 5, 5, 4, 5, 6 },
-    { 4, 5, 6, 3, 4, 5, 3, 4, 5, 3, 4, 5, 4, 5, 6, 4, 5, 6 },
-    { 4, 5, 6, 3, 4, 5, 3, 4, 5, 3, 4, 5, 3, 4, 5, 4, 5, 6 },
-    { 4, 5, 6, 4, 5, 6, 3, 4, 5, 3, 4, 5, 3, 4, 5, 4, 5, 6 },
-    // Nov-Dec-Jan Exposed
-    { 4, 5, 6, 3, 4, 5, 2, 3, 4, 2, 3, 4, 3, 4, 5, 4, 5, 6 },
-    { 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6 },
-    { 4, 5, 6, 3, 4, 4, 2, 3, 3, 2, 3, 3, 3, 4, 5, 4, 5, 6 },
-    { 4, 5, 6, 2, 3, 4, 2, 2, 3, 3, 4, 4, 4, 5, 6, 4, 5, 6 },
-    { 4, 5, 6, 3, 4, 5, 2, 3, 3, 2, 2, 3, 3, 4, 4, 4, 5, 6 },
-    { 4, 5, 6, 2, 3, 3, 1, 1, 2, 1, 1, 2, 2, 3, 3, 4, 5, 6 },
-    { 4, 5, 6, 3, 4, 5, 2, 3, 3, 2, 3, 3, 3, 4, 4, 4, 5, 6 },
-    { 4, 5, 6, 4, 5, 6, 3, 4, 4, 2, 2, 3, 2, 3, 4, 4, 5, 6 },
-    // Nov-Dec-Jan Shaded
-    { 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6 },
-    { 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6 },
-    { 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6 },
-    { 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6 }
-};
-
 //------------------------------------------------------------------------------
 /*! \brief FdfmcDialog constructor.
  */
@@ -548,17 +493,11 @@ void FdfmcDialog::update( int )
     m_tod  = m_todComboBox->currentItem();
 
     // Determine reference fuel moisture
-    m_ref = Reference[ m_db ][ m_rh ];
+    m_ref = FBL_FineDeadFuelMoistureReference( m_db, m_rh );
 
     // Determine fuel moisture correction
-    // Correction table row
-    int row = ( m_shd == 0 )
-            ? ( m_slp + 2 * m_asp )
-            : ( 8 + m_asp );
-    row += 12 * m_mon;
-    // Correction table column
-    int col = m_elev + 3 * m_tod;
-    m_cor = Correction[row][col];
+    m_cor = FBL_FineDeadFuelMoistureCorrection( m_mon, m_tod, m_elev, m_slp,
+        m_asp, m_shd );
 
     // Corrected fuel moisture
     m_res = m_ref + m_cor;
@@ -80,6 +80,7 @@ FileSystem::FileSystem( void ) :
     m_worksheetPath(""),
     m_fuelModelExt("bpf"),
     m_moisScenarioExt("bpm"),
+    m_resultSetExt("bprs"),
     m_runExt("bpr"),
     m_unitsSetExt("bpu"),
     m_worksheetExt("bpw"),
@@ -1179,6 +1180,20 @@ QString FileSystem::propertyFilePath( void )
     return( m_propertyFilePath );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Gets the standard result set file extension.
+ *
+ *  Result sets must not share the Run file extension, or saving one could
+ *  overwrite a Run file and the Run file selectors would list them.
+ *
+ *  \return Copy of the standard result set file extension.
+ */
+
+QString FileSystem::resultSetExt( void ) const
+{
+    return( m_resultSetExt );
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Gets the standard Run file extension.
  *
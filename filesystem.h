@@ -77,6 +77,7 @@ public:
     // The following methods get standard file extensions
     QString fuelModelExt( void ) const ;
     QString moisScenarioExt( void ) const ;
+    QString resultSetExt( void ) const ;
     QString runExt( void ) const ;
     QString unitsSetExt( void ) const ;
     QString worksheetExt( void ) const ;
@@ -170,6 +171,7 @@ private:
     QString m_worksheetPath;        //!< Worksheet directory full path name
     QString m_fuelModelExt;         //!< Fuel model file extension ("bpf")
     QString m_moisScenarioExt;      //!< Moisture scenario file extensions ("bpm")
+    QString m_resultSetExt;         //!< Result set file extension ("bprs")
     QString m_runExt;               //!< Run file extensions ("bpr")
     QString m_unitsSetExt;          //!< Units set file extension ("bpu")
     QString m_worksheetExt;         //!< Worksheet file extension ("bpw")
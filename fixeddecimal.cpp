@@ -0,0 +1,246 @@
+//------------------------------------------------------------------------------
+/*! \file fixeddecimal.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Fast fixed decimal number formatting.
+ */
+
+// Custom include files
+#include "fixeddecimal.h"
+
+// Standard include files
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/*! \var FixedDecimalMaxDecimals
+ *  \brief Largest number of decimals formatted without sprintf().
+ */
+static const int FixedDecimalMaxDecimals = 9;
+
+/*! \var FixedDecimalMaxScaled
+ *  \brief Largest scaled value formatted without sprintf() (2^40).
+ *
+ *  Below 2^40 a double's spacing is at most 2^-13, so the error in
+ *  value * 10^decimals cannot move it across a rounding boundary unless
+ *  its fraction is within FixedDecimalTieMargin of one half.
+ */
+static const double FixedDecimalMaxScaled = 1099511627776.;
+
+/*! \var FixedDecimalTieMargin
+ *  \brief Scaled fractions this close to one half are passed to sprintf().
+ */
+static const double FixedDecimalTieMargin = 0.001;
+
+/*! \var Pow10
+ *  \brief Powers of 10 from 10^0 through 10^9, all exact in a double.
+ */
+static const double Pow10[] =
+{
+    1., 10., 100., 1000., 10000., 100000., 1000000., 10000000.,
+    100000000., 1000000000.
+};
+
+/*! \var DigitPairs
+ *  \brief The two digit text of every number from 00 through 99.
+ */
+static const char DigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+//------------------------------------------------------------------------------
+/*! \brief Writes the decimal digits of \a value, zero padded to \a digits.
+ *
+ *  \param buffer Where to write the digits.
+ *  \param value  Value to write.
+ *  \param digits Minimum number of digits (0 for no padding).
+ *
+ *  \return Pointer just beyond the last digit written.
+ */
+
+static char *putDigits( char *buffer, unsigned int value, int digits )
+{
+    // Fill a scratch area from the right, two digits at a time
+    char tmp[16];
+    char *p = tmp + sizeof(tmp);
+    while ( value >= 100 )
+    {
+        unsigned int pair = value % 100;
+        value /= 100;
+        p -= 2;
+        p[0] = DigitPairs[ 2 * pair ];
+        p[1] = DigitPairs[ 2 * pair + 1 ];
+    }
+    if ( value >= 10 )
+    {
+        p -= 2;
+        p[0] = DigitPairs[ 2 * value ];
+        p[1] = DigitPairs[ 2 * value + 1 ];
+    }
+    else
+    {
+        *(--p) = (char) ( '0' + value );
+    }
+    int len = tmp + sizeof(tmp) - p;
+    while ( len < digits )
+    {
+        *buffer++ = '0';
+        digits--;
+    }
+    memcpy( buffer, p, len );
+    return( buffer + len );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Formats \a value with \a decimals digits after the decimal point,
+ *  exactly as sprintf( buffer, "%*.*f", width, decimals, value ) would.
+ *
+ *  \param buffer   Buffer of at least FixedDecimalBufferSize characters.
+ *  \param value    Value to format.
+ *  \param decimals Number of decimals (negative means 6, as for sprintf()).
+ *  \param width    Minimum field width; shorter text is right justified.
+ *
+ *  \return Number of characters written, not counting the terminating NUL.
+ */
+
+int fixedDecimal( char *buffer, double value, int decimals, int width )
+{
+    if ( decimals < 0 )
+    {
+        decimals = 6;
+    }
+    if ( width > FixedDecimalBufferSize - 32 )
+    {
+        width = FixedDecimalBufferSize - 32;
+    }
+    // Scale the magnitude to an integer count of the last decimal place
+    bool negative = value < 0.;
+    double scaled = ( negative ? -value : value );
+    bool fast = false;
+    if ( decimals <= FixedDecimalMaxDecimals )
+    {
+        scaled *= Pow10[ decimals ];
+        fast = ( scaled < FixedDecimalMaxScaled );  // also FALSE for NaN
+    }
+    double n = 0.;
+    if ( fast )
+    {
+        n = floor( scaled );
+        double fraction = scaled - n;
+        if ( fabs( fraction - 0.5 ) < FixedDecimalTieMargin )
+        {
+            fast = false;
+        }
+        else if ( fraction > 0.5 )
+        {
+            n += 1.;
+        }
+    }
+    if ( ! fast )
+    {
+        if ( decimals > 100 )
+        {
+            decimals = 100;
+        }
+        return( sprintf( buffer, "%*.*f", width, decimals, value ) );
+    }
+    // Negative zero prints with its sign
+    if ( value == 0. )
+    {
+        negative = ( atan2( value, -1. ) < 0. );
+    }
+    // Split into integer and fractional digits, each small enough for an int
+    double whole = floor( n / Pow10[ decimals ] );
+    double part = n - whole * Pow10[ decimals ];
+    double wholeHi = floor( whole / 100000000. );
+    double wholeLo = whole - wholeHi * 100000000.;
+    char text[64];
+    char *p = text;
+    if ( negative )
+    {
+        *p++ = '-';
+    }
+    if ( wholeHi > 0. )
+    {
+        p = putDigits( p, (unsigned int) wholeHi, 0 );
+        p = putDigits( p, (unsigned int) wholeLo, 8 );
+    }
+    else
+    {
+        p = putDigits( p, (unsigned int) wholeLo, 0 );
+    }
+    if ( decimals > 0 )
+    {
+        *p++ = '.';
+        p = putDigits( p, (unsigned int) part, decimals );
+    }
+    // Right justify within the field width
+    int len = p - text;
+    int pad = ( width > len ) ? width - len : 0;
+    if ( pad )
+    {
+        memset( buffer, ' ', pad );
+    }
+    memcpy( buffer + pad, text, len );
+    buffer[ pad + len ] = '\0';
+    return( pad + len );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets \a str to \a value formatted with \a decimals digits after
+ *  the decimal point, exactly as str.sprintf( "%s%1.*f%s", prefix,
+ *  decimals, value, suffix ) would.
+ *
+ *  The string's existing storage is reused where possible.
+ *
+ *  \param str      Reference to the string to set.
+ *  \param value    Value to format.
+ *  \param decimals Number of decimals.
+ *  \param prefix   Optional text to precede the number.
+ *  \param suffix   Optional text to follow the number.
+ *
+ *  \return Reference to \a str.
+ */
+
+QString &fixedDecimal( QString &str, double value, int decimals,
+        const char *prefix, const char *suffix )
+{
+    char buffer[ FixedDecimalBufferSize + 64 ];
+    int len = 0;
+    if ( prefix )
+    {
+        for ( ;
+              *prefix && len < 32;
+              len++ )
+        {
+            buffer[len] = *prefix++;
+        }
+    }
+    len += fixedDecimal( buffer + len, value, decimals );
+    if ( suffix )
+    {
+        for ( ;
+              *suffix && len < FixedDecimalBufferSize + 63;
+              len++ )
+        {
+            buffer[len] = *suffix++;
+        }
+    }
+    buffer[len] = '\0';
+    str.setLatin1( buffer, len );
+    return( str );
+}
+
+//------------------------------------------------------------------------------
+//  End of fixeddecimal.cpp
+//------------------------------------------------------------------------------
+
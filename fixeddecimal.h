@@ -0,0 +1,41 @@
+//------------------------------------------------------------------------------
+/*! \file fixeddecimal.h
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Fast fixed decimal number formatting.
+ *
+ *  fixedDecimal() produces exactly the text of sprintf( "%*.*f" ) for the
+ *  display decimals and magnitudes used by tables and exports, but with
+ *  integer arithmetic and a digit pair table instead of the C library's
+ *  general purpose conversion.  Values whose rounding cannot be decided
+ *  exactly from their scaled double (near-ties, huge magnitudes, more
+ *  than 9 decimals, NaN and infinity) are handed to sprintf() itself, so
+ *  the output always matches it.
+ */
+
+#ifndef _FIXEDDECIMAL_H_
+/*! \def _FIXEDDECIMAL_H_
+ *  \brief Prevent redundant includes.
+ */
+#define _FIXEDDECIMAL_H_ 1
+
+// Qt include files
+#include <qstring.h>
+
+/*! \var FixedDecimalBufferSize
+ *  \brief Minimum size of a buffer passed to fixedDecimal().
+ */
+static const int FixedDecimalBufferSize = 512;
+
+int      fixedDecimal( char *buffer, double value, int decimals,
+            int width=0 ) ;
+QString &fixedDecimal( QString &str, double value, int decimals,
+            const char *prefix=0, const char *suffix=0 ) ;
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of fixeddecimal.h
+//------------------------------------------------------------------------------
+
@@ -0,0 +1,354 @@
+//------------------------------------------------------------------------------
+/*! \file fixeddecimalcheck.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Console driver that checks fixedDecimal() produces exactly the
+ *  text of sprintf(), and times both.
+ *
+ *  Usage: fixeddecimalcheck [values]
+ *
+ *  -# fixedDecimal( buffer, value, decimals, width ) is compared with
+ *     sprintf( "%*.*f" ) for special values (signed zeros, ties, values
+ *     near the fast path limits, huge values, NaN and infinity) and for
+ *     \a values random values from each of four distributions, at every
+ *     number of decimals from -1 (the default 6) through 12 and at field
+ *     widths 0, 6, and 12.
+ *  -# The QString fixedDecimal() is compared with QString::sprintf(
+ *     "%s%1.*f%s" ) with and without a prefix and suffix.
+ *  -# Text formatted with 0 through 9 decimals from values of up to 15
+ *     significant digits is read back with strtod() and formatted again,
+ *     which must reproduce the same text.
+ *  -# fixedDecimal() and sprintf() are timed formatting table values.
+ *
+ *  Text is compared with strcmp(), so any difference is a failure.  The
+ *  program exits with status 1 if anything differs.
+ */
+
+// Custom include files
+#include "fixeddecimal.h"
+
+// Standard include files
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*! \var Seed
+ *  \brief Random number generator state, so every platform checks the same
+ *  values.
+ */
+static unsigned int Seed = 2463534242u;
+
+/*! \var Diffs
+ *  \brief Number of differences found so far.
+ */
+static long Diffs = 0;
+
+//------------------------------------------------------------------------------
+/*! \brief Simple 32-bit xorshift random number generator.
+ *
+ *  \return Random 32-bit word.
+ */
+
+static unsigned int random32( void )
+{
+    Seed ^= Seed << 13;
+    Seed ^= Seed >> 17;
+    Seed ^= Seed << 5;
+    return( Seed );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Reports a difference between two texts, listing only the first
+ *  few.
+ */
+
+static void difference( const char *what, int decimals, int width,
+        double value, const char *text, const char *expect )
+{
+    if ( ++Diffs <= 20 )
+    {
+        fprintf( stderr, "%s: decimals %d width %d value %.17g: \"%s\","
+            " expected \"%s\"\n", what, decimals, width, value, text,
+            expect );
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Compares fixedDecimal() with sprintf() for one value.
+ *
+ *  \return 1 if they differ, 0 if they are identical.
+ */
+
+static int compareText( double value, int decimals, int width )
+{
+    char text[FixedDecimalBufferSize], expect[FixedDecimalBufferSize];
+    int len = fixedDecimal( text, value, decimals, width );
+    int explen = sprintf( expect, "%*.*f", width,
+        ( decimals < 0 ) ? 6 : decimals, value );
+    if ( len != explen || strcmp( text, expect ) )
+    {
+        difference( "fixedDecimal()", decimals, width, value, text, expect );
+        return( 1 );
+    }
+    return( 0 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Draws a random value from one of four distributions.
+ *
+ *  \param kind     Distribution 0-3.
+ *  \param decimals Number of decimals the value will be formatted with.
+ *
+ *  \return Random value.
+ */
+
+static double randomValue( int kind, int decimals )
+{
+    unsigned int r = random32();
+    unsigned int s = random32();
+    double value;
+    if ( kind == 0 )
+    {
+        // Table-like values with a few decimals
+        value = (double) ( r % 2000000 ) / pow( 10., (double) ( s % 8 ) )
+              - 1000.;
+    }
+    else if ( kind == 1 )
+    {
+        // Random mantissas over a wide range of magnitudes
+        value = ldexp( (double) r * 4294967296. + (double) s,
+            -(int) ( s % 90 ) - 11 );
+        value = ( r & 1 ) ? -value : value;
+    }
+    else if ( kind == 2 )
+    {
+        // Exact decimal ties at the last decimal place
+        double digits = (double) ( r % 100000000 );
+        value = ( digits + 0.5 )
+              / pow( 10., (double) ( ( decimals < 0 ) ? 6 : decimals ) );
+    }
+    else
+    {
+        // Any bit pattern at all, including NaNs and infinities
+        unsigned int word[2];
+        word[0] = r;
+        word[1] = s;
+        memcpy( &value, word, sizeof(value) );
+    }
+    return( value );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Compares fixedDecimal() with sprintf() for the special and
+ *  random values.
+ *
+ *  \param values Number of random values from each distribution.
+ *
+ *  \return Number of differences.
+ */
+
+static long checkText( int values )
+{
+    double inf = strtod( "1e999", 0 );
+    double special[] =
+    {
+        0., -0., 0.5, 1.5, 2.5, -0.5, 0.125, 0.375, -0.001, 1e300, -1e300,
+        1e12, 1099511627776., 9.995, 0.045, 1.005, 2.675, 4294967296.,
+        99999999.999, 123456789012.5, 0.0005, 0.00049999999999999, 1e-300,
+        inf, -inf, inf - inf
+    };
+    int specials = sizeof(special) / sizeof(special[0]);
+    long diffs = 0;
+    long checks = 0;
+    for ( int decimals = -1;
+          decimals <= 12;
+          decimals++ )
+    {
+        for ( int width = 0;
+              width <= 12;
+              width += 6 )
+        {
+            int i;
+            for ( i = 0;
+                  i < specials;
+                  i++ )
+            {
+                diffs += compareText( special[i], decimals, width );
+                checks++;
+            }
+            for ( i = 0;
+                  i < 4 * values;
+                  i++ )
+            {
+                diffs += compareText( randomValue( i % 4, decimals ),
+                    decimals, width );
+                checks++;
+            }
+        }
+    }
+    fprintf( stdout, "fixedDecimal(): %ld values, %ld differ from"
+        " sprintf()\n", checks, diffs );
+    return( diffs );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Compares the QString fixedDecimal() with QString::sprintf().
+ *
+ *  \param values Number of random values from each distribution.
+ *
+ *  \return Number of differences.
+ */
+
+static long checkQString( int values )
+{
+    QString str, expect;
+    long diffs = 0;
+    long checks = 0;
+    for ( int decimals = 0;
+          decimals <= 9;
+          decimals++ )
+    {
+        for ( int i = 0;
+              i < 4 * values;
+              i++ )
+        {
+            double value = randomValue( i % 4, decimals );
+            const char *prefix = ( i & 4 ) ? " " : 0;
+            const char *suffix = ( i & 8 ) ? "WM" : 0;
+            fixedDecimal( str, value, decimals, prefix, suffix );
+            expect.sprintf( "%s%1.*f%s", prefix ? prefix : "", decimals,
+                value, suffix ? suffix : "" );
+            if ( str != expect )
+            {
+                difference( "QString fixedDecimal()", decimals, 0, value,
+                    str.latin1(), expect.latin1() );
+                diffs++;
+            }
+            checks++;
+        }
+    }
+    fprintf( stdout, "QString fixedDecimal(): %ld values, %ld differ from"
+        " QString::sprintf()\n", checks, diffs );
+    return( diffs );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Checks that fixedDecimal() text read back by strtod() formats to
+ *  the same text.
+ *
+ *  \param values Number of random values for each number of decimals.
+ *
+ *  \return Number of differences.
+ */
+
+static long checkRoundTrip( int values )
+{
+    char text[FixedDecimalBufferSize], again[FixedDecimalBufferSize];
+    long diffs = 0;
+    long checks = 0;
+    for ( int decimals = 0;
+          decimals <= 9;
+          decimals++ )
+    {
+        // Values of up to 15 significant digits read back exactly
+        double limit = pow( 10., (double) ( 15 - decimals ) );
+        for ( int i = 0;
+              i < values;
+              i++ )
+        {
+            double value = ( (double) random32() / 4294967296. - 0.5 )
+                         * 2. * limit / pow( 10., (double) ( i % 10 ) );
+            fixedDecimal( text, value, decimals );
+            fixedDecimal( again, strtod( text, 0 ), decimals );
+            if ( strcmp( text, again ) )
+            {
+                difference( "round trip", decimals, 0, value, again, text );
+                diffs++;
+            }
+            checks++;
+        }
+    }
+    fprintf( stdout, "round trip: %ld values, %ld differ after strtod()\n",
+        checks, diffs );
+    return( diffs );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Times fixedDecimal() and sprintf() formatting table values.
+ */
+
+static void timeText( void )
+{
+    static const int Values = 4096;
+    static const int Passes = 500;
+    double *value = new double[ Values ];
+    int i, pass;
+    for ( i = 0;
+          i < Values;
+          i++ )
+    {
+        value[i] = 1000. * (double) random32() / 4294967296.;
+    }
+    char text[FixedDecimalBufferSize];
+    long length[2] = { 0, 0 };
+    clock_t t0 = clock();
+    for ( pass = 0;
+          pass < Passes;
+          pass++ )
+    {
+        for ( i = 0;
+              i < Values;
+              i++ )
+        {
+            length[0] += fixedDecimal( text, value[i], 2 );
+        }
+    }
+    clock_t t1 = clock();
+    for ( pass = 0;
+          pass < Passes;
+          pass++ )
+    {
+        for ( i = 0;
+              i < Values;
+              i++ )
+        {
+            length[1] += sprintf( text, "%1.*f", 2, value[i] );
+        }
+    }
+    clock_t t2 = clock();
+    double calls = (double) Values * Passes;
+    fprintf( stdout, "timing: fixedDecimal() %.1f ns, sprintf() %.1f ns"
+        " per value (%ld %ld characters)\n",
+        1.0e9 * (double) ( t1 - t0 ) / CLOCKS_PER_SEC / calls,
+        1.0e9 * (double) ( t2 - t1 ) / CLOCKS_PER_SEC / calls,
+        length[0], length[1] );
+    delete[] value;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Main entry point.
+ */
+
+int main( int argc, char **argv )
+{
+    int values = ( argc > 1 ) ? atoi( argv[1] ) : 10000;
+    if ( values < 1 )
+    {
+        fprintf( stderr, "%s: values must be positive.\n", argv[0] );
+        return( 1 );
+    }
+    long diffs = checkText( values );
+    diffs += checkQString( values );
+    diffs += checkRoundTrip( values );
+    timeText();
+    return( diffs ? 1 : 0 );
+}
+
+//------------------------------------------------------------------------------
+//  End of fixeddecimalcheck.cpp
+//------------------------------------------------------------------------------
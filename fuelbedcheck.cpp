@@ -0,0 +1,502 @@
+//------------------------------------------------------------------------------
+/*! \file fuelbedcheck.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Console driver that checks the fused special fuel bed builders
+ *  and the remembered fuel bed intermediates give exactly the results they
+ *  replace.
+ *
+ *  Usage: fuelbedcheck [cells]
+ *
+ *  -# FBL_AspenFuelBed() is compared with the individual FBL_Aspen*()
+ *     functions over every aspen fuel type and a fine sweep of curing
+ *     levels, and FBL_AspenInterpolate() with the original linear search
+ *     of the curing table.
+ *  -# FBL_PalmettoGallberyFuelBed() is compared with the eight individual
+ *     FBL_PalmettoGallbery*() functions over a grid of generator inputs.
+ *  -# A sequence of table cells that revisits a set of fuel beds (some of
+ *     them empty) is calculated twice through the surface fire functions:
+ *     once calling FBL_SurfaceFuelBedIntermediates() at every cell, and
+ *     once looking the fuel bed up in an EqCalcCache and restoring its
+ *     saved FBL_SurfaceFuelBedState() as EqCalc::FuelBedIntermediates()
+ *     does.  Every result must be identical, and both passes are timed.
+ *
+ *  Values are compared with ==, so any difference is a failure.  The
+ *  program exits with status 1 if anything differs.
+ */
+
+// Custom include files
+#include "xeqcalc.h"
+#include "xfblib.h"
+
+// Standard include files
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*! \var CheckParts
+ *  \brief Number of fuel particles, as in EqCalc.
+ */
+static const int CheckParts = 8;
+
+/*! \var CheckBeds
+ *  \brief Number of distinct fuel beds revisited by the table cells.
+ */
+static const int CheckBeds = 40;
+
+/*! \var CheckOutputs
+ *  \brief Number of results compared at each table cell.
+ */
+static const int CheckOutputs = 12;
+
+/*! \var CheckKeys
+ *  \brief Number of fuel bed key values, as in EqCalc.
+ */
+static const int CheckKeys = 1 + 7 * CheckParts;
+
+/*! \var CheckValues
+ *  \brief Number of remembered values per fuel bed, as in EqCalc.
+ */
+static const int CheckValues = 4 + FBL_SurfaceFuelBedStateSize;
+
+//------------------------------------------------------------------------------
+/*! \class CheckBed fuelbedcheck.cpp
+ *
+ *  \brief Inputs of one fuel bed.
+ */
+
+class CheckBed
+{
+public:
+    double m_depth;
+    int    m_life[CheckParts];
+    double m_load[CheckParts];
+    double m_savr[CheckParts];
+    double m_heat[CheckParts];
+    double m_dens[CheckParts];
+    double m_stot[CheckParts];
+    double m_seff[CheckParts];
+};
+
+//------------------------------------------------------------------------------
+/*! \brief The original FBL_AspenInterpolate() linear search.
+ *
+ *  \param curing       Curing level (fraction).
+ *  \param valueArray   Array of 6 boundary values.
+ *
+ *  \return Interpolated value.
+ */
+
+static double originalAspenInterpolate( double curing, double *valueArray )
+{
+    static double Curing[] = { 0.0, 0.3, 0.5, 0.7, 0.9, 1.000000001 };
+    curing = ( curing < 0.0 ) ? 0.0 : curing;
+    curing = ( curing > 1.0 ) ? 1.0 : curing;
+    double fraction = 0.0;
+    int i;
+    for ( i = 1;
+          i < 6;
+          i++ )
+    {
+        if ( curing < Curing[i] )
+        {
+            fraction = 1. - ( Curing[i] - curing ) / ( Curing[i] - Curing[i-1] );
+            break;
+        }
+    }
+    return( valueArray[i-1] + fraction * ( valueArray[i] - valueArray[i-1] ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Compares the aspen fuel bed builder and interpolation.
+ *
+ *  \return Number of differences.
+ */
+
+static int checkAspen( void )
+{
+    static double Table[6] = { 0.25, 1.75, 0.5, 3.125, 2.0, 7.0 };
+    static double Boundary[8] =
+        { 0.0, 0.3, 0.5, 0.7, 0.9, 1.0, 0.29999999999999999, 0.70000000000001 };
+    double curing, depth, mextDead, load[4], savr[4];
+    int type, step, diffs = 0, checks = 0;
+    for ( step = -20;
+          step <= 1020 + 8;
+          step++ )
+    {
+        // A fine sweep past both ends, then the table boundaries
+        curing = ( step <= 1020 )
+               ? ( 0.001 * (double) step )
+               : Boundary[ step - 1021 ];
+        if ( FBL_AspenInterpolate( curing, Table )
+          != originalAspenInterpolate( curing, Table ) )
+        {
+            fprintf( stdout, "FBL_AspenInterpolate( %.17g ) differs.\n",
+                curing );
+            diffs++;
+        }
+        for ( type = 0;
+              type < 5;
+              type++ )
+        {
+            FBL_AspenFuelBed( type, curing, &depth, &mextDead, load, savr );
+            if ( depth    != FBL_AspenFuelBedDepth( type, curing )
+              || mextDead != FBL_AspenFuelMextDead( type, curing )
+              || load[0]  != FBL_AspenLoadDead1( type, curing )
+              || load[1]  != FBL_AspenLoadDead10( type, curing )
+              || load[2]  != FBL_AspenLoadLiveHerb( type, curing )
+              || load[3]  != FBL_AspenLoadLiveWoody( type, curing )
+              || savr[0]  != FBL_AspenSavrDead1( type, curing )
+              || savr[1]  != FBL_AspenSavrDead10( type, curing )
+              || savr[2]  != FBL_AspenSavrLiveHerb( type, curing )
+              || savr[3]  != FBL_AspenSavrLiveWoody( type, curing ) )
+            {
+                fprintf( stdout, "FBL_AspenFuelBed( %d, %.17g ) differs.\n",
+                    type, curing );
+                diffs++;
+            }
+            checks++;
+        }
+    }
+    fprintf( stdout, "Aspen: %d of %d fuel beds differ.\n", diffs, checks );
+    return( diffs );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Compares the palmetto-gallberry fuel bed builder.
+ *
+ *  \return Number of differences.
+ */
+
+static int checkPalmetto( void )
+{
+    double age, cover, height, ba, depth, load[7];
+    int a, c, h, b, diffs = 0, checks = 0;
+    for ( a = 0;
+          a <= 25;
+          a++ )
+    {
+        age = 0.5 + (double) a;
+        for ( c = 0;
+              c <= 10;
+              c++ )
+        {
+            cover = 9.5 * (double) c;
+            for ( h = 0;
+                  h <= 12;
+                  h++ )
+            {
+                height = 0.25 * (double) h + 0.1;
+                for ( b = 0;
+                      b <= 6;
+                      b++ )
+                {
+                    ba = 25. * (double) b;
+                    FBL_PalmettoGallberyFuelBed( age, cover, height, ba,
+                        &depth, load );
+                    if ( depth != FBL_PalmettoGallberyFuelBedDepth( height )
+                      || load[0] != FBL_PalmettoGallberyDead1HrLoad( age, height )
+                      || load[1] != FBL_PalmettoGallberyDead10HrLoad( age, cover )
+                      || load[2] != FBL_PalmettoGallberyDeadFoliageLoad( age, cover )
+                      || load[3] != FBL_PalmettoGallberyLive1HrLoad( age, height )
+                      || load[4] != FBL_PalmettoGallberyLive10HrLoad( age, height )
+                      || load[5] != FBL_PalmettoGallberyLiveFoliageLoad( age, cover, height )
+                      || load[6] != FBL_PalmettoGallberyLitterLoad( age, ba ) )
+                    {
+                        fprintf( stdout, "FBL_PalmettoGallberyFuelBed( %g, %g, "
+                            "%g, %g ) differs.\n", age, cover, height, ba );
+                        diffs++;
+                    }
+                    checks++;
+                }
+            }
+        }
+    }
+    fprintf( stdout, "Palmetto-gallberry: %d of %d fuel beds differ.\n",
+        diffs, checks );
+    return( diffs );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Returns a pseudo-random number in [0,1) from a fixed sequence.
+ */
+
+static double checkRandom( unsigned int *seed )
+{
+    *seed = *seed * 1103515245u + 12345u;
+    return( (double) ( ( *seed >> 8 ) & 0xffffff ) / 16777216. );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Fills \a bed with a standard fuel model style fuel bed.
+ *
+ *  Every eighth fuel bed has no depth and every ninth has no fuel, so the
+ *  library's early exits are also exercised.
+ */
+
+static void makeBed( CheckBed *bed, int id, unsigned int *seed )
+{
+    // Dead 1, 10, 100 h, live herb, live wood, dead herb, and two unused
+    static int    Life[CheckParts] = { 0, 0, 0, 1, 2, 0, 0, 0 };
+    static double Savr[CheckParts] = { 0., 109., 30., 0., 0., 0., 0., 0. };
+    bed->m_depth = ( id % 8 == 7 ) ? 0. : 0.2 + 3. * checkRandom( seed );
+    for ( int p = 0;
+          p < CheckParts;
+          p++ )
+    {
+        bed->m_life[p] = Life[p];
+        bed->m_load[p] = ( p < 6 && id % 9 != 8 )
+                       ? ( 0.2 * checkRandom( seed ) ) : 0.;
+        bed->m_savr[p] = Savr[p];
+        bed->m_heat[p] = 8000.;
+        bed->m_dens[p] = 32.;
+        bed->m_stot[p] = 0.0555;
+        bed->m_seff[p] = 0.01;
+    }
+    // Some fuel beds without live herbs
+    if ( id % 5 == 4 )
+    {
+        bed->m_load[3] = 0.;
+    }
+    bed->m_savr[0] = 1500. + 2000. * checkRandom( seed );
+    bed->m_savr[3] = 1400. + 1000. * checkRandom( seed );
+    bed->m_savr[4] = 1200. + 800. * checkRandom( seed );
+    bed->m_savr[5] = bed->m_savr[3];
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Calculates the fire behavior of one table cell from the current
+ *  fuel bed intermediates.
+ *
+ *  \param cell     Table cell, which sets the moisture, wind, and slope.
+ *  \param sigma    Fuel bed intermediates.
+ *  \param bulkDensity
+ *  \param packingRatio
+ *  \param betaRatio
+ *  \param out      Array of CheckOutputs where the results are returned.
+ */
+
+static void calcCell( int cell, double sigma, double bulkDensity,
+        double packingRatio, double betaRatio, double *out )
+{
+    double mois[CheckParts];
+    mois[0] = 0.03 + 0.01 * (double) ( cell % 7 );
+    mois[1] = mois[0] + 0.01;
+    mois[2] = mois[0] + 0.02;
+    mois[3] = 0.6 + 0.1 * (double) ( cell % 5 );
+    mois[4] = 1.0 + 0.2 * (double) ( cell % 3 );
+    mois[5] = mois[0];
+    mois[6] = mois[7] = 0.;
+    double deadMext = 0.25;
+    double deadMois, liveMois, liveMext;
+    double heatSink = FBL_SurfaceFuelBedHeatSink( bulkDensity, deadMext,
+        mois, &deadMois, &liveMois, &liveMext );
+    double rxInt = FBL_SurfaceFireReactionIntensity( deadMois, deadMext,
+        liveMois, liveMext );
+    double flux = FBL_SurfaceFirePropagatingFlux( packingRatio, sigma );
+    double ros0 = FBL_SurfaceFireNoWindNoSlopeSpreadRate( rxInt, flux,
+        heatSink );
+    double maxDir, effWind, windLimit, windFactor, slopeFactor;
+    int windLimitExceeded;
+    double ros = FBL_SurfaceFireForwardSpreadRate( ros0, rxInt,
+        0.1 * (double) ( cell % 6 ), 88. * (double) ( cell % 11 ),
+        30. * (double) ( cell % 12 ), &maxDir, &effWind, &windLimit,
+        &windLimitExceeded, &windFactor, &slopeFactor );
+    out[0]  = sigma;
+    out[1]  = bulkDensity;
+    out[2]  = packingRatio;
+    out[3]  = betaRatio;
+    out[4]  = heatSink;
+    out[5]  = rxInt;
+    out[6]  = ros0;
+    out[7]  = ros;
+    out[8]  = maxDir;
+    out[9]  = effWind;
+    out[10] = windLimit;
+    out[11] = windFactor + slopeFactor + (double) windLimitExceeded;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Calculates every table cell, with or without the cache.
+ *
+ *  \param bed      Array of CheckBeds fuel beds.
+ *  \param cellBed  Array of \a cells fuel bed indices.
+ *  \param cells    Number of table cells.
+ *  \param cache    Fuel bed cache, or 0 to call
+ *                  FBL_SurfaceFuelBedIntermediates() at every cell.
+ *  \param saved    Array of FuelBedCacheSize * CheckValues remembered values.
+ *  \param out      Array of \a cells * CheckOutputs results.
+ *
+ *  \return Elapsed seconds.
+ */
+
+static double runCells( CheckBed *bed, const int *cellBed, int cells,
+        EqCalcCache *cache, double *saved, double *out )
+{
+    double key[CheckKeys];
+    double sigma, bulkDensity, packingRatio, betaRatio;
+    // Start from the same library state, as an empty fuel bed keeps part
+    // of the state left by the fuel bed before it
+    FBL_SurfaceFuelBedIntermediates( bed[0].m_depth, 0.25, CheckParts,
+        bed[0].m_life, bed[0].m_load, bed[0].m_savr, bed[0].m_heat,
+        bed[0].m_dens, bed[0].m_stot, bed[0].m_seff,
+        &bulkDensity, &packingRatio, &betaRatio );
+    clock_t start = clock();
+    for ( int cell = 0;
+          cell < cells;
+          cell++ )
+    {
+        CheckBed *b = &bed[ cellBed[cell] ];
+        bool found = false;
+        double *v = 0;
+        int slot = 0;
+        if ( cache )
+        {
+            int k = 0;
+            key[k++] = b->m_depth;
+            for ( int q = 0;
+                  q < CheckParts;
+                  q++ )
+            {
+                key[k++] = (double) b->m_life[q];
+                key[k++] = b->m_load[q];
+                key[k++] = b->m_savr[q];
+                key[k++] = b->m_heat[q];
+                key[k++] = b->m_dens[q];
+                key[k++] = b->m_stot[q];
+                key[k++] = b->m_seff[q];
+            }
+            slot = cache->find( key, &found );
+            v = saved + slot * CheckValues;
+        }
+        if ( found )
+        {
+            sigma        = v[0];
+            bulkDensity  = v[1];
+            packingRatio = v[2];
+            betaRatio    = v[3];
+            FBL_SurfaceFuelBedSetState( v + 4 );
+        }
+        else
+        {
+            sigma = FBL_SurfaceFuelBedIntermediates( b->m_depth, 0.25,
+                CheckParts, b->m_life, b->m_load, b->m_savr, b->m_heat,
+                b->m_dens, b->m_stot, b->m_seff,
+                &bulkDensity, &packingRatio, &betaRatio );
+            if ( cache && sigma < SMIDGEN )
+            {
+                cache->clear( slot );
+            }
+            else if ( cache )
+            {
+                v[0] = sigma;
+                v[1] = bulkDensity;
+                v[2] = packingRatio;
+                v[3] = betaRatio;
+                FBL_SurfaceFuelBedState( v + 4 );
+            }
+        }
+        calcCell( cell, sigma, bulkDensity, packingRatio, betaRatio,
+            out + cell * CheckOutputs );
+    }
+    return( (double) ( clock() - start ) / (double) CLOCKS_PER_SEC );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Compares table cells calculated with and without the fuel bed
+ *  cache.
+ *
+ *  \param cells Number of table cells.
+ *
+ *  \return Number of differences.
+ */
+
+static int checkIntermediates( int cells )
+{
+    unsigned int seed = 20110601u;
+    CheckBed bed[CheckBeds];
+    int i;
+    for ( i = 0;
+          i < CheckBeds;
+          i++ )
+    {
+        makeBed( &bed[i], i, &seed );
+    }
+    // Runs of repeated fuel beds, as along a table row, in random order
+    int *cellBed = new int[ cells ];
+    double *exact = new double[ cells * CheckOutputs ];
+    double *cached = new double[ cells * CheckOutputs ];
+    double *saved = new double[ FuelBedCacheSize * CheckValues ];
+    if ( ! cellBed || ! exact || ! cached || ! saved )
+    {
+        fprintf( stderr, "fuelbedcheck: out of memory.\n" );
+        exit( 1 );
+    }
+    int id = 0;
+    for ( i = 0;
+          i < cells;
+          i++ )
+    {
+        if ( i % 10 == 0 || checkRandom( &seed ) < 0.2 )
+        {
+            id = (int) ( checkRandom( &seed ) * CheckBeds );
+        }
+        cellBed[i] = id;
+    }
+    EqCalcCache cache( CheckKeys, FuelBedCacheSize );
+    double tExact  = runCells( bed, cellBed, cells, 0, saved, exact );
+    double tCached = runCells( bed, cellBed, cells, &cache, saved, cached );
+    int diffs = 0;
+    for ( i = 0;
+          i < cells * CheckOutputs;
+          i++ )
+    {
+        if ( exact[i] != cached[i] )
+        {
+            if ( diffs < 10 )
+            {
+                fprintf( stdout, "Cell %d (fuel bed %d) output %d: "
+                    "%.17g != %.17g\n", i / CheckOutputs,
+                    cellBed[ i / CheckOutputs ], i % CheckOutputs,
+                    exact[i], cached[i] );
+            }
+            diffs++;
+        }
+    }
+    fprintf( stdout, "Fuel bed intermediates: %d of %d results differ; "
+        "%d hits, %d misses.\n", diffs, cells * CheckOutputs,
+        cache.m_hits, cache.m_misses );
+    fprintf( stdout, "    calculated %.1f ns per cell, remembered %.1f ns "
+        "per cell.\n", 1.e9 * tExact / (double) cells,
+        1.e9 * tCached / (double) cells );
+    delete[] cellBed;
+    delete[] exact;
+    delete[] cached;
+    delete[] saved;
+    return( diffs );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Main driver.
+ */
+
+int main( int argc, char **argv )
+{
+    int cells = ( argc > 1 ) ? atoi( argv[1] ) : 200000;
+    if ( cells < 1 )
+    {
+        fprintf( stderr, "%s: cells must be positive.\n", argv[0] );
+        return( 1 );
+    }
+    int diffs = checkAspen();
+    diffs += checkPalmetto();
+    diffs += checkIntermediates( cells );
+    return( diffs ? 1 : 0 );
+}
+
+//------------------------------------------------------------------------------
+//  End of fuelbedcheck.cpp
+//------------------------------------------------------------------------------
@@ -0,0 +1,756 @@
+//------------------------------------------------------------------------------
+/*! \file fuelcalib.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief FuelCalib class methods.
+ *
+ *  The fit is a bounded Levenberg-Marquardt search over the free parameters,
+ *  each scaled onto [0..1] by its bounds.  The residuals are the relative
+ *  errors (predicted/observed - 1) of every observed spread rate and flame
+ *  length.
+ *
+ *  The xfblib fuel bed functions keep the fuel bed state in file static
+ *  variables, so the observations are evaluated sequentially.  However, the
+ *  fuel bed intermediates depend only upon the fuel parameters (and the
+ *  herbaceous load transfer), not the observation, so
+ *  FBL_SurfaceFuelBedIntermediates() is only called once per trial parameter
+ *  set (once per distinct transfer fraction for dynamic models) and each
+ *  observation only evaluates the moisture, wind, and slope dependent terms.
+ */
+
+// Custom include files
+#include "appmessage.h"
+#include "apptranslator.h"
+#include "fuelcalib.h"
+#include "fuelmodel.h"
+#include "xfblib.h"
+#include "xmlparser.h"
+
+// Standard include files
+#include <math.h>
+#include <stdio.h>
+
+/*! \var FuelCalibParticles
+ *  \brief Number of fuel particles in a standard fuel model fuel bed:
+ *  dead 1-h, 10-h, 100-h, live herb, live wood, and (cured) dead herb.
+ */
+static const int FuelCalibParticles = 6;
+
+//------------------------------------------------------------------------------
+/*! \brief Solves the linear system a x = b by Gaussian elimination with
+ *  partial pivoting.
+ *
+ *  \param n    Number of equations.
+ *  \param a    n x n row-major coefficient matrix (destroyed).
+ *  \param b    Right hand side vector (replaced by the solution).
+ *
+ *  \return TRUE on success, FALSE if the matrix is singular.
+ */
+
+static bool FuelCalibSolve( int n, double *a, double *b )
+{
+    int i, j, k, p;
+    double t;
+    for ( k = 0;
+          k < n;
+          k++ )
+    {
+        // Find the pivot row
+        p = k;
+        for ( i = k+1;
+              i < n;
+              i++ )
+        {
+            if ( fabs( a[i*n+k] ) > fabs( a[p*n+k] ) )
+            {
+                p = i;
+            }
+        }
+        if ( fabs( a[p*n+k] ) < 1.e-300 )
+        {
+            return( false );
+        }
+        // Swap the pivot row into place
+        if ( p != k )
+        {
+            for ( j = 0;
+                  j < n;
+                  j++ )
+            {
+                t = a[k*n+j];  a[k*n+j] = a[p*n+j];  a[p*n+j] = t;
+            }
+            t = b[k];  b[k] = b[p];  b[p] = t;
+        }
+        // Eliminate below the pivot
+        for ( i = k+1;
+              i < n;
+              i++ )
+        {
+            t = a[i*n+k] / a[k*n+k];
+            for ( j = k;
+                  j < n;
+                  j++ )
+            {
+                a[i*n+j] -= t * a[k*n+j];
+            }
+            b[i] -= t * b[k];
+        }
+    }
+    // Back substitution
+    for ( i = n-1;
+          i >= 0;
+          i-- )
+    {
+        t = b[i];
+        for ( j = i+1;
+              j < n;
+              j++ )
+        {
+            t -= a[i*n+j] * b[j];
+        }
+        b[i] = t / a[i*n+i];
+    }
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief FuelCalib constructor.
+ *
+ *  Sets the default parameter bounds.  By default the fuel bed depth,
+ *  dead extinction moisture, all five fuel loads, and the 1-h surface
+ *  area-to-volume ratio are fitted.
+ */
+
+FuelCalib::FuelCalib( void ) :
+    m_obs(0),
+    m_resids(0),
+    m_rmse0(0.),
+    m_rmse(0.),
+    m_mois(0),
+    m_wind(0),
+    m_windDir(0),
+    m_slope(0),
+    m_ros(0),
+    m_fl(0),
+    m_resid(0),
+    m_name(""),
+    m_transfer("S")
+{
+    static const double Init[FuelCalibParms] =
+        { 1.0, 0.25, 0.1, 0.0, 0.0, 0.0, 0.0, 2000., 1500., 1500., 8000., 8000. };
+    static const double Min[FuelCalibParms] =
+        { 0.1, 0.10, 0.0, 0.0, 0.0, 0.0, 0.0,  500.,  500.,  500., 6000., 6000. };
+    static const double Max[FuelCalibParms] =
+        { 10., 0.60, 1.0, 1.0, 1.0, 1.0, 1.0, 4000., 4000., 4000., 12000., 12000. };
+    for ( int i = 0;
+          i < FuelCalibParms;
+          i++ )
+    {
+        m_parm[i] = Init[i];
+        m_min[i]  = Min[i];
+        m_max[i]  = Max[i];
+        m_free[i] = ( i <= FuelCalibSavr1 );
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief FuelCalib destructor.
+ */
+
+FuelCalib::~FuelCalib( void )
+{
+    freeObs();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Fits the free parameters to the observations.
+ *
+ *  \param maxIterations Maximum number of Levenberg-Marquardt iterations.
+ *
+ *  \return Number of iterations performed.
+ */
+
+int FuelCalib::calibrate( int maxIterations )
+{
+    // Map the free parameters
+    int idx[FuelCalibParms];
+    int n = 0;
+    int i, j, k;
+    for ( i = 0;
+          i < FuelCalibParms;
+          i++ )
+    {
+        if ( m_free[i] && m_max[i] > m_min[i] )
+        {
+            idx[n++] = i;
+        }
+    }
+    double ssq = sumSquares( m_parm );
+    m_rmse0 = m_rmse = ( m_resids ) ? sqrt( ssq / m_resids ) : 0.;
+    if ( n == 0 || m_resids == 0 )
+    {
+        return( 0 );
+    }
+    // Allocate the Jacobian and work arrays
+    int m = m_resids;
+    double *jac = new double[ m * n ];
+    checkmem( __FILE__, __LINE__, jac, "double jac", m * n );
+    double *r0 = new double[ m ];
+    checkmem( __FILE__, __LINE__, r0, "double r0", m );
+    double a[FuelCalibParms*FuelCalibParms], aa[FuelCalibParms*FuelCalibParms];
+    double g[FuelCalibParms], delta[FuelCalibParms];
+    double trial[FuelCalibParms];
+
+    const double step = 1.e-5;
+    double lambda = 1.e-3;
+    int iter;
+    for ( iter = 0;
+          iter < maxIterations;
+          iter++ )
+    {
+        // Residuals at the current parameters
+        residuals( m_parm, r0 );
+        // Forward difference Jacobian in scaled parameter units
+        for ( j = 0;
+              j < n;
+              j++ )
+        {
+            int p = idx[j];
+            double range = m_max[p] - m_min[p];
+            double h = ( m_parm[p] + step * range <= m_max[p] ) ? step : -step;
+            for ( k = 0;
+                  k < FuelCalibParms;
+                  k++ )
+            {
+                trial[k] = m_parm[k];
+            }
+            trial[p] += h * range;
+            residuals( trial, m_resid );
+            for ( i = 0;
+                  i < m;
+                  i++ )
+            {
+                jac[i*n+j] = ( m_resid[i] - r0[i] ) / h;
+            }
+        }
+        // Normal equations
+        for ( j = 0;
+              j < n;
+              j++ )
+        {
+            g[j] = 0.;
+            for ( i = 0;
+                  i < m;
+                  i++ )
+            {
+                g[j] += jac[i*n+j] * r0[i];
+            }
+            for ( k = 0;
+                  k <= j;
+                  k++ )
+            {
+                double sum = 0.;
+                for ( i = 0;
+                      i < m;
+                      i++ )
+                {
+                    sum += jac[i*n+j] * jac[i*n+k];
+                }
+                a[j*n+k] = a[k*n+j] = sum;
+            }
+        }
+        // Increase the damping until a step reduces the sum of squares.
+        bool improved = false;
+        double ssqNew = ssq;
+        while ( lambda < 1.e12 )
+        {
+            for ( j = 0;
+                  j < n*n;
+                  j++ )
+            {
+                aa[j] = a[j];
+            }
+            for ( j = 0;
+                  j < n;
+                  j++ )
+            {
+                aa[j*n+j] += lambda * ( a[j*n+j] + 1.e-12 );
+                delta[j] = -g[j];
+            }
+            if ( FuelCalibSolve( n, aa, delta ) )
+            {
+                // Project the step onto the parameter bounds
+                for ( k = 0;
+                      k < FuelCalibParms;
+                      k++ )
+                {
+                    trial[k] = m_parm[k];
+                }
+                for ( j = 0;
+                      j < n;
+                      j++ )
+                {
+                    int p = idx[j];
+                    trial[p] += delta[j] * ( m_max[p] - m_min[p] );
+                    trial[p] = ( trial[p] < m_min[p] ) ? m_min[p] : trial[p];
+                    trial[p] = ( trial[p] > m_max[p] ) ? m_max[p] : trial[p];
+                }
+                ssqNew = sumSquares( trial );
+                if ( ssqNew < ssq )
+                {
+                    improved = true;
+                    break;
+                }
+            }
+            lambda *= 10.;
+        }
+        if ( ! improved )
+        {
+            break;
+        }
+        for ( k = 0;
+              k < FuelCalibParms;
+              k++ )
+        {
+            m_parm[k] = trial[k];
+        }
+        lambda = ( lambda * 0.1 < 1.e-12 ) ? 1.e-12 : lambda * 0.1;
+        // Converged when the relative improvement becomes negligible
+        bool done = ( ssq - ssqNew <= 1.e-10 * ssq );
+        ssq = ssqNew;
+        if ( done )
+        {
+            iter++;
+            break;
+        }
+    }
+    m_rmse = sqrt( ssq / m_resids );
+    delete[] jac;
+    delete[] r0;
+    return( iter );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Deletes all the observation arrays.
+ */
+
+void FuelCalib::freeObs( void )
+{
+    delete[] m_mois;        m_mois = 0;
+    delete[] m_wind;        m_wind = 0;
+    delete[] m_windDir;     m_windDir = 0;
+    delete[] m_slope;       m_slope = 0;
+    delete[] m_ros;         m_ros = 0;
+    delete[] m_fl;          m_fl = 0;
+    delete[] m_resid;       m_resid = 0;
+    m_obs = m_resids = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Stores the current parameters into the passed FuelModel.
+ *
+ *  The FuelModel's file, name, number, and description are not changed.
+ *
+ *  \param fm Reference to the FuelModel to receive the parameters.
+ */
+
+void FuelCalib::fuelModel( FuelModel &fm ) const
+{
+    fm.m_depth    = m_parm[FuelCalibDepth];
+    fm.m_mext     = m_parm[FuelCalibMext];
+    fm.m_load1    = m_parm[FuelCalibLoad1];
+    fm.m_load10   = m_parm[FuelCalibLoad10];
+    fm.m_load100  = m_parm[FuelCalibLoad100];
+    fm.m_loadHerb = m_parm[FuelCalibLoadHerb];
+    fm.m_loadWood = m_parm[FuelCalibLoadWood];
+    fm.m_savr1    = m_parm[FuelCalibSavr1];
+    fm.m_savrHerb = m_parm[FuelCalibSavrHerb];
+    fm.m_savrWood = m_parm[FuelCalibSavrWood];
+    fm.m_heatDead = m_parm[FuelCalibHeatDead];
+    fm.m_heatLive = m_parm[FuelCalibHeatLive];
+    fm.m_transfer = m_transfer;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the current value of a parameter.
+ *
+ *  \param parm FuelCalibParm enum value.
+ *
+ *  \return Current parameter value in native units.
+ */
+
+double FuelCalib::parm( int parm ) const
+{
+    return( m_parm[parm] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Reads the observations from an observation file.
+ *
+ *  \param fileName Name of the observation file.
+ *  \param errMsg   Reference to a string to hold any error message.
+ *
+ *  \return TRUE on success, FALSE on error (and \a errMsg is set).
+ */
+
+bool FuelCalib::read( const QString &fileName, QString &errMsg )
+{
+    errMsg = "";
+    freeObs();
+    FILE *fptr = fopen( fileName.latin1(), "r" );
+    if ( ! fptr )
+    {
+        translate( errMsg, "FuelCalib:NoOpen", fileName );
+        return( false );
+    }
+    // First pass counts the observations
+    char buffer[1024], *ptr;
+    int pass, line, obs = 0;
+    double v[10];
+    for ( pass = 0;
+          pass < 2;
+          pass++ )
+    {
+        if ( pass == 1 )
+        {
+            if ( obs == 0 )
+            {
+                break;
+            }
+            m_mois    = new double[ 5 * obs ];
+            checkmem( __FILE__, __LINE__, m_mois, "double m_mois", 5 * obs );
+            m_wind    = new double[ obs ];
+            checkmem( __FILE__, __LINE__, m_wind, "double m_wind", obs );
+            m_windDir = new double[ obs ];
+            checkmem( __FILE__, __LINE__, m_windDir, "double m_windDir", obs );
+            m_slope   = new double[ obs ];
+            checkmem( __FILE__, __LINE__, m_slope, "double m_slope", obs );
+            m_ros     = new double[ obs ];
+            checkmem( __FILE__, __LINE__, m_ros, "double m_ros", obs );
+            m_fl      = new double[ obs ];
+            checkmem( __FILE__, __LINE__, m_fl, "double m_fl", obs );
+            m_resid   = new double[ 2 * obs ];
+            checkmem( __FILE__, __LINE__, m_resid, "double m_resid", 2 * obs );
+            rewind( fptr );
+            obs = 0;
+        }
+        line = 0;
+        while ( fgets( buffer, sizeof(buffer), fptr ) )
+        {
+            line++;
+            // Skip leading white space, blank lines, and comment lines
+            for ( ptr = buffer; *ptr == ' ' || *ptr == '\t'; ptr++ )
+            {
+                /* NOTHING */ ;
+            }
+            if ( *ptr == '#' || *ptr == '\n' || *ptr == '\r' || *ptr == '\0' )
+            {
+                continue;
+            }
+            if ( sscanf( ptr, "%lf %lf %lf %lf %lf %lf %lf %lf %lf %lf",
+                    &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6], &v[7],
+                    &v[8], &v[9] ) != 10
+              || v[0] <= 0. || v[1] <= 0. || v[2] <= 0.
+              || v[3] <= 0. || v[4] <= 0.
+              || v[5] < 0. || v[7] < 0.
+              || ( v[8] <= 0. && v[9] <= 0. ) )
+            {
+                translate( errMsg, "FuelCalib:BadLine", fileName,
+                    QString( "%1" ).arg( line ) );
+                fclose( fptr );
+                freeObs();
+                return( false );
+            }
+            if ( pass == 1 )
+            {
+                // Convert to native units
+                for ( int i = 0;
+                      i < 5;
+                      i++ )
+                {
+                    m_mois[5*obs+i] = 0.01 * v[i];
+                }
+                m_wind[obs]    = v[5];
+                m_windDir[obs] = v[6];
+                m_slope[obs]   = 0.01 * v[7];
+                m_ros[obs]     = ( v[8] > 0. ) ? ( 1.1 * v[8] ) : 0.;
+                m_fl[obs]      = ( v[9] > 0. ) ? v[9] : 0.;
+                m_resids += ( v[8] > 0. ) ? 1 : 0;
+                m_resids += ( v[9] > 0. ) ? 1 : 0;
+            }
+            obs++;
+        }
+    }
+    fclose( fptr );
+    if ( obs == 0 )
+    {
+        translate( errMsg, "FuelCalib:Empty", fileName );
+        return( false );
+    }
+    m_obs = obs;
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Evaluates the relative residuals for a set of parameters.
+ *
+ *  \param parm     Array of FuelCalibParms parameter values.
+ *  \param resid    Array to receive the m_resids residuals.
+ *
+ *  \return Number of residuals stored.
+ */
+
+int FuelCalib::residuals( const double *parm, double *resid )
+{
+    // Fuel bed particles in the same order as EqCalc::FuelBedParms()
+    int    life[FuelCalibParticles] = { 0, 0, 0, 1, 2, 0 };
+    double load[FuelCalibParticles], savr[FuelCalibParticles];
+    double heat[FuelCalibParticles], dens[FuelCalibParticles];
+    double stot[FuelCalibParticles], seff[FuelCalibParticles];
+    double mois[FuelCalibParticles];
+    int p;
+    for ( p = 0;
+          p < FuelCalibParticles;
+          p++ )
+    {
+        dens[p] = 32.;
+        stot[p] = 0.0555;
+        seff[p] = 0.0100;
+        heat[p] = ( life[p] == 0 )
+                ? parm[FuelCalibHeatDead]
+                : parm[FuelCalibHeatLive];
+    }
+    savr[0] = parm[FuelCalibSavr1];
+    savr[1] = 109.;
+    savr[2] = 30.;
+    savr[3] = parm[FuelCalibSavrHerb];
+    savr[4] = parm[FuelCalibSavrWood];
+    savr[5] = parm[FuelCalibSavrHerb];
+
+    bool dynamic = ( m_transfer == "D" || m_transfer == "d" );
+    double depth = parm[FuelCalibDepth];
+    double deadMext = parm[FuelCalibMext];
+    double fraction = -1.;
+    double sigma = 0., bulkDensity = 0., packingRatio = 0., betaRatio = 0.;
+    double propFlux = 0., tau = 0.;
+    double deadMois, liveMois, liveMext, rbQig, rxi, ros0, ros, fli, fl;
+    double dirMax, effWind, maxWind, windFactor, slopeFactor;
+    int windLimit;
+    int n = 0;
+    for ( int obs = 0;
+          obs < m_obs;
+          obs++ )
+    {
+        const double *m = &m_mois[5*obs];
+        // The fuel bed only changes if the herb load transfer changes.
+        double f = ( dynamic )
+                 ? FBL_HerbaceousFuelLoadCuredFraction( m[3] )
+                 : 0.;
+        if ( f != fraction )
+        {
+            fraction = f;
+            load[0] = parm[FuelCalibLoad1];
+            load[1] = parm[FuelCalibLoad10];
+            load[2] = parm[FuelCalibLoad100];
+            load[5] = fraction * parm[FuelCalibLoadHerb];
+            load[3] = parm[FuelCalibLoadHerb] - load[5];
+            load[4] = parm[FuelCalibLoadWood];
+            sigma = FBL_SurfaceFuelBedIntermediates( depth, deadMext,
+                FuelCalibParticles, life, load, savr, heat, dens, stot, seff,
+                &bulkDensity, &packingRatio, &betaRatio );
+            propFlux = FBL_SurfaceFirePropagatingFlux( packingRatio, sigma );
+            tau = FBL_SurfaceFireResidenceTime( sigma );
+        }
+        // Dead herb uses the 1-h moisture as in EqCalc::FuelMoisTimeLag().
+        mois[0] = m[0];
+        mois[1] = m[1];
+        mois[2] = m[2];
+        mois[3] = m[3];
+        mois[4] = m[4];
+        mois[5] = m[0];
+        rbQig = FBL_SurfaceFuelBedHeatSink( bulkDensity, deadMext, mois,
+            &deadMois, &liveMois, &liveMext );
+        rxi = FBL_SurfaceFireReactionIntensity( deadMois, deadMext,
+            liveMois, liveMext );
+        ros0 = FBL_SurfaceFireNoWindNoSlopeSpreadRate( rxi, propFlux, rbQig );
+        ros = FBL_SurfaceFireForwardSpreadRate( ros0, rxi, m_slope[obs],
+            m_wind[obs], m_windDir[obs], &dirMax, &effWind, &maxWind,
+            &windLimit, &windFactor, &slopeFactor );
+        if ( m_ros[obs] > 0. )
+        {
+            resid[n++] = ros / m_ros[obs] - 1.;
+        }
+        if ( m_fl[obs] > 0. )
+        {
+            fli = FBL_SurfaceFireFirelineIntensity( ros, rxi, tau );
+            fl = FBL_SurfaceFireFlameLength( fli );
+            resid[n++] = fl / m_fl[obs] - 1.;
+        }
+    }
+    return( n );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the relative root mean square error of the current
+ *  parameters, as of the last call to calibrate().
+ */
+
+double FuelCalib::rmse( void ) const
+{
+    return( m_rmse );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the bounds of a parameter.
+ *
+ *  \param parm     FuelCalibParm enum value.
+ *  \param minimum  Lower bound in native units.
+ *  \param maximum  Upper bound in native units.
+ */
+
+void FuelCalib::setBounds( int parm, double minimum, double maximum )
+{
+    m_min[parm] = minimum;
+    m_max[parm] = maximum;
+    m_parm[parm] = ( m_parm[parm] < minimum ) ? minimum : m_parm[parm];
+    m_parm[parm] = ( m_parm[parm] > maximum ) ? maximum : m_parm[parm];
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines whether a parameter is fitted or held constant.
+ *
+ *  \param parm     FuelCalibParm enum value.
+ *  \param isFree   If TRUE, the parameter is fitted.
+ */
+
+void FuelCalib::setFree( int parm, bool isFree )
+{
+    m_free[parm] = isFree;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the starting parameters from a FuelModel.
+ *
+ *  Fuel loads that are zero in the starting fuel model are held at zero,
+ *  and the bounds are widened if necessary to include the starting values.
+ *
+ *  \param fm Reference to the starting FuelModel.
+ */
+
+void FuelCalib::setFuelModel( const FuelModel &fm )
+{
+    m_name = fm.m_name;
+    m_transfer = fm.m_transfer;
+    m_parm[FuelCalibDepth]    = fm.m_depth;
+    m_parm[FuelCalibMext]     = fm.m_mext;
+    m_parm[FuelCalibLoad1]    = fm.m_load1;
+    m_parm[FuelCalibLoad10]   = fm.m_load10;
+    m_parm[FuelCalibLoad100]  = fm.m_load100;
+    m_parm[FuelCalibLoadHerb] = fm.m_loadHerb;
+    m_parm[FuelCalibLoadWood] = fm.m_loadWood;
+    m_parm[FuelCalibSavr1]    = fm.m_savr1;
+    m_parm[FuelCalibSavrHerb] = fm.m_savrHerb;
+    m_parm[FuelCalibSavrWood] = fm.m_savrWood;
+    m_parm[FuelCalibHeatDead] = fm.m_heatDead;
+    m_parm[FuelCalibHeatLive] = fm.m_heatLive;
+    for ( int i = 0;
+          i < FuelCalibParms;
+          i++ )
+    {
+        m_min[i] = ( m_parm[i] < m_min[i] ) ? m_parm[i] : m_min[i];
+        m_max[i] = ( m_parm[i] > m_max[i] ) ? m_parm[i] : m_max[i];
+        if ( i >= FuelCalibLoad1 && i <= FuelCalibLoadWood
+          && m_parm[i] <= 0. )
+        {
+            m_free[i] = false;
+        }
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the sum of squared residuals for a set of parameters.
+ *
+ *  \param parm Array of FuelCalibParms parameter values.
+ *
+ *  \return Sum of squared relative residuals.
+ */
+
+double FuelCalib::sumSquares( const double *parm )
+{
+    int n = residuals( parm, m_resid );
+    double ssq = 0.;
+    for ( int i = 0;
+          i < n;
+          i++ )
+    {
+        ssq += m_resid[i] * m_resid[i];
+    }
+    return( ssq );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Writes the current parameters to a BehavePlus fuel model file
+ *  that can be read by FuelModel::loadBpf() and EqApp::attachFuelModel().
+ *
+ *  \param fileName Name of the fuel model file to write.
+ *  \param desc     Fuel model description.
+ *  \param release  Current program release number.
+ *
+ *  \return TRUE on success, FALSE if the file could not be opened.
+ */
+
+bool FuelCalib::writeBpf( const QString &fileName, const QString &desc,
+        int release ) const
+{
+    FILE *fptr = fopen( fileName.latin1(), "w" );
+    if ( ! fptr )
+    {
+        return( false );
+    }
+    QString xml( desc );
+    xmlEscape( xml );
+    xmlWriteHeader( fptr, "BehavePlus", "Fuel Model", release );
+    fprintf( fptr, "  <property name=\"appDescription\" value=\"%s\" />\n",
+        xml.latin1() );
+    fprintf( fptr, "  <variable name=\"vSurfaceFuelBedDepth\" decimals=\"2\" units=\"ft\" value=\"%.4f\" />\n",
+        m_parm[FuelCalibDepth] );
+    fprintf( fptr, "  <variable name=\"vSurfaceFuelBedMextDead\" decimals=\"2\" units=\"fraction\" value=\"%.4f\" />\n",
+        m_parm[FuelCalibMext] );
+    fprintf( fptr, "  <variable name=\"vSurfaceFuelHeatDead\" decimals=\"0\" units=\"Btu/lb\" value=\"%.1f\" />\n",
+        m_parm[FuelCalibHeatDead] );
+    fprintf( fptr, "  <variable name=\"vSurfaceFuelHeatLive\" decimals=\"0\" units=\"Btu/lb\" value=\"%.1f\" />\n",
+        m_parm[FuelCalibHeatLive] );
+    fprintf( fptr, "  <variable name=\"vSurfaceFuelLoadDead1\" decimals=\"4\" units=\"lb/ft2\" value=\"%.6f\" />\n",
+        m_parm[FuelCalibLoad1] );
+    fprintf( fptr, "  <variable name=\"vSurfaceFuelLoadDead10\" decimals=\"4\" units=\"lb/ft2\" value=\"%.6f\" />\n",
+        m_parm[FuelCalibLoad10] );
+    fprintf( fptr, "  <variable name=\"vSurfaceFuelLoadDead100\" decimals=\"4\" units=\"lb/ft2\" value=\"%.6f\" />\n",
+        m_parm[FuelCalibLoad100] );
+    fprintf( fptr, "  <variable name=\"vSurfaceFuelLoadLiveHerb\" decimals=\"4\" units=\"lb/ft2\" value=\"%.6f\" />\n",
+        m_parm[FuelCalibLoadHerb] );
+    fprintf( fptr, "  <variable name=\"vSurfaceFuelLoadLiveWood\" decimals=\"4\" units=\"lb/ft2\" value=\"%.6f\" />\n",
+        m_parm[FuelCalibLoadWood] );
+    fprintf( fptr, "  <variable name=\"vSurfaceFuelLoadTransferEq\" code=\"%s\" />\n",
+        m_transfer.latin1() );
+    fprintf( fptr, "  <variable name=\"vSurfaceFuelSavrDead1\" decimals=\"0\" units=\"ft2/ft3\" value=\"%.1f\" />\n",
+        m_parm[FuelCalibSavr1] );
+    fprintf( fptr, "  <variable name=\"vSurfaceFuelSavrLiveHerb\" decimals=\"0\" units=\"ft2/ft3\" value=\"%.1f\" />\n",
+        m_parm[FuelCalibSavrHerb] );
+    fprintf( fptr, "  <variable name=\"vSurfaceFuelSavrLiveWood\" decimals=\"0\" units=\"ft2/ft3\" value=\"%.1f\" />\n",
+        m_parm[FuelCalibSavrWood] );
+    xmlWriteFooter( fptr, "BehavePlus" );
+    fclose( fptr );
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+//  End of fuelcalib.cpp
+//------------------------------------------------------------------------------
@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------------
+/*! \file fuelcalib.h
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief FuelCalib class declaration.
+ *
+ *  A FuelCalib fits the parameters of a surface fuel model to a set of
+ *  observed spread rates and/or flame lengths by bounded nonlinear least
+ *  squares.  It calls the xfblib surface fire functions directly and has no
+ *  user interface, so it may be run without a worksheet.
+ *
+ *  An observation file is a plain text file with one observation per line.
+ *  Blank lines and lines beginning with '#' are ignored.  Each observation
+ *  has 10 white space delimited fields:
+ *      -# dead 1-h fuel moisture (%),
+ *      -# dead 10-h fuel moisture (%),
+ *      -# dead 100-h fuel moisture (%),
+ *      -# live herbaceous fuel moisture (%),
+ *      -# live woody fuel moisture (%),
+ *      -# midflame wind speed (mi/h),
+ *      -# wind direction (degrees clockwise from upslope),
+ *      -# slope steepness (%),
+ *      -# observed spread rate (ch/h), and
+ *      -# observed flame length (ft).
+ *
+ *  An observed spread rate or flame length of zero or less is treated as
+ *  missing, but every observation must have at least one of them.
+ */
+
+#ifndef _FUELCALIB_H_
+/*! \def _FUELCALIB_H_
+ *  \brief Prevent redundant includes.
+ */
+#define _FUELCALIB_H_ 1
+
+// Custom class references
+class FuelModel;
+
+// Qt include files
+#include <qstring.h>
+
+/*! \enum FuelCalibParm
+ *  \brief Identifies the fuel model parameters that may be calibrated.
+ */
+enum FuelCalibParm
+{
+    FuelCalibDepth=0,       //!< Fuel bed depth (ft)
+    FuelCalibMext=1,        //!< Dead fuel extinction moisture (fraction)
+    FuelCalibLoad1=2,       //!< Dead 1-h fuel load (lb/ft2)
+    FuelCalibLoad10=3,      //!< Dead 10-h fuel load (lb/ft2)
+    FuelCalibLoad100=4,     //!< Dead 100-h fuel load (lb/ft2)
+    FuelCalibLoadHerb=5,    //!< Live herbaceous fuel load (lb/ft2)
+    FuelCalibLoadWood=6,    //!< Live woody fuel load (lb/ft2)
+    FuelCalibSavr1=7,       //!< Dead 1-h surface area-to-volume ratio (ft2/ft3)
+    FuelCalibSavrHerb=8,    //!< Live herb surface area-to-volume ratio (ft2/ft3)
+    FuelCalibSavrWood=9,    //!< Live wood surface area-to-volume ratio (ft2/ft3)
+    FuelCalibHeatDead=10,   //!< Dead fuel heat of combustion (Btu/lb)
+    FuelCalibHeatLive=11,   //!< Live fuel heat of combustion (Btu/lb)
+    FuelCalibParms=12       //!< Number of fuel model parameters
+};
+
+//------------------------------------------------------------------------------
+/*! \class FuelCalib fuelcalib.h
+ *
+ *  \brief Fits fuel model parameters to observed fire behavior.
+ */
+
+class FuelCalib
+{
+// Public methods
+public:
+    FuelCalib( void ) ;
+    ~FuelCalib( void ) ;
+    int    calibrate( int maxIterations=200 ) ;
+    void   fuelModel( FuelModel &fm ) const ;
+    double parm( int parm ) const ;
+    bool   read( const QString &fileName, QString &errMsg ) ;
+    double rmse( void ) const ;
+    void   setBounds( int parm, double minimum, double maximum ) ;
+    void   setFree( int parm, bool isFree ) ;
+    void   setFuelModel( const FuelModel &fm ) ;
+    bool   writeBpf( const QString &fileName, const QString &desc,
+                int release ) const ;
+
+// Private methods
+private:
+    void   freeObs( void ) ;
+    int    residuals( const double *parm, double *resid ) ;
+    double sumSquares( const double *parm ) ;
+
+// Public data
+public:
+    int     m_obs;          //!< Number of observations
+    int     m_resids;       //!< Number of residuals (observed ROS and FL)
+    double  m_rmse0;        //!< Relative RMS error of the initial parameters
+    double  m_rmse;         //!< Relative RMS error of the fitted parameters
+
+// Private data
+private:
+    double *m_mois;         //!< 5 fuel moistures per observation (fraction)
+    double *m_wind;         //!< Midflame wind speed (mi/h)
+    double *m_windDir;      //!< Wind direction from upslope (degrees)
+    double *m_slope;        //!< Slope steepness (fraction)
+    double *m_ros;          //!< Observed spread rate (ft/min, 0 if missing)
+    double *m_fl;           //!< Observed flame length (ft, 0 if missing)
+    double *m_resid;        //!< Residual work array
+    double  m_parm[FuelCalibParms]; //!< Current parameter values
+    double  m_min[FuelCalibParms];  //!< Parameter lower bounds
+    double  m_max[FuelCalibParms];  //!< Parameter upper bounds
+    bool    m_free[FuelCalibParms]; //!< TRUE if the parameter is fitted
+    QString m_name;         //!< Name of the starting fuel model
+    QString m_transfer;     //!< Herb fuel load transfer ("S" or "D")
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of fuelcalib.h
+//------------------------------------------------------------------------------
@@ -7,22 +7,45 @@
  */
 
 // Custom include files
+#include "appfilesystem.h"
 #include "appmessage.h"
 #include "apptranslator.h"
 #include "helpbrowser.h"
+#include "helpindex.h"
 #include "platform.h"
 #include "textview.h"
 
 // Qt include files
+#include <qapplication.h>
+#include <qdatetime.h>
 #include <qdir.h>           // Moved from helpbrowser.h
+#include <qfile.h>
 #include <qfileinfo.h>
 #include <qhbox.h>
 #include <qlabel.h>
+#include <qlineedit.h>
 #include <qevent.h>         // Moved from helpbrowser.h
 #include <qmap.h>           // Moved from helpbrowser.h
 #include <qpixmapcache.h>
 #include <qpushbutton.h>
 #include <qstringlist.h>
+#include <qstylesheet.h>
+#include <qtooltip.h>
+
+/*! \var HelpBrowserMaxHits
+ *  \brief Maximum number of search results displayed.
+ */
+static const int HelpBrowserMaxHits = 25;
+
+/*! \var HelpIndexFile
+ *  \brief Name of the search index file kept in the workspace's Composer
+ *  folder.
+ */
+static const QString HelpIndexFile( "helpIndex.dat" );
+
+// The search index shared by all HelpBrowsers, and its HTML directory
+static HelpIndex *HelpSearchIndex = 0;
+static QString HelpSearchDir( "" );
 
 // Local XPMs
 static const char *back_xpm[] =
@@ -135,6 +158,88 @@ static const char *index_xpm[] =
     "bbbbbbbbbbb..bbbbbbbbb",
 };
 
+//------------------------------------------------------------------------------
+/*! \brief Access to the search index over the HTML pages in \a htmlDir.
+ *
+ *  The index is read from the index file in the current workspace's
+ *  Composer folder if it was built from the current set of pages and passes
+ *  HelpIndex::load()'s checks.  Otherwise (e.g., on first run, after the
+ *  pages are updated, or if the file is damaged) it is rebuilt from the
+ *  pages and saved for next time.  The installation's HTML directory is
+ *  never written, since it is often read-only and may be shared by several
+ *  users.  If the folder is not writable, the rebuilt index is kept in
+ *  memory for the rest of the session.
+ *
+ *  \param htmlDir Full path name of the HTML file source directory
+ *                 (with terminating separator).
+ *
+ *  \return Pointer to the shared HelpIndex, or NULL if there are no pages.
+ */
+
+static HelpIndex *helpBrowserIndex( const QString &htmlDir )
+{
+    if ( HelpSearchIndex && HelpSearchDir == htmlDir )
+    {
+        return( HelpSearchIndex );
+    }
+    delete HelpSearchIndex;
+    HelpSearchIndex = 0;
+    HelpSearchDir = htmlDir;
+
+    // Stamp the current set of pages by their names, sizes, and dates
+    QDir dir( htmlDir, "*.html", QDir::Name, QDir::Files | QDir::Readable );
+    QStringList pages = dir.entryList();
+    if ( pages.isEmpty() )
+    {
+        return( 0 );
+    }
+    unsigned int stamp = pages.count();
+    QStringList::Iterator it;
+    for ( it = pages.begin();
+          it != pages.end();
+          ++it )
+    {
+        QFileInfo fi( htmlDir + *it );
+        stamp = 31 * stamp + fi.size() + fi.lastModified().toTime_t();
+        for ( unsigned int i = 0;
+              i < (*it).length();
+              i++ )
+        {
+            stamp = 31 * stamp + (*it).at( i ).unicode();
+        }
+    }
+    HelpSearchIndex = new HelpIndex();
+    checkmem( __FILE__, __LINE__, HelpSearchIndex, "HelpIndex HelpSearchIndex", 1 );
+    QString indexPath( appFileSystem()->composerPath( HelpIndexFile ) );
+    if ( HelpSearchIndex->load( indexPath, stamp ) )
+    {
+        return( HelpSearchIndex );
+    }
+
+    // Rebuild the index
+    QApplication::setOverrideCursor( Qt::waitCursor );
+    for ( it = pages.begin();
+          it != pages.end();
+          ++it )
+    {
+        QFile file( htmlDir + *it );
+        if ( file.open( IO_ReadOnly ) )
+        {
+            QByteArray html = file.readAll();
+            HelpSearchIndex->addPage( *it, html.data(), html.size() );
+            file.close();
+        }
+    }
+    HelpSearchIndex->finish( stamp );
+    QApplication::restoreOverrideCursor();
+    log( QString( "Help search index of %1 pages rebuilt; %2 \"%3\".\n" )
+        .arg( HelpSearchIndex->pages() )
+        .arg( HelpSearchIndex->save( indexPath )
+            ? "saved to" : "unable to save to" )
+        .arg( indexPath ) );
+    return( HelpSearchIndex );
+}
+
 //------------------------------------------------------------------------------
 /*! \brief HelpBrowser default constructor.
  *
@@ -145,6 +250,7 @@ static const char *index_xpm[] =
 HelpBrowser::HelpBrowser( QWidget *parent, const char *name ) :
     QVBox( parent, name ),
     m_navFrame(0),
+    m_search(0),
     m_browser(0),
     m_htmlDir(""),
     m_topicFile(""),
@@ -173,6 +279,7 @@ HelpBrowser::HelpBrowser( QWidget *parent, const QString &htmlDir,
         const QString &helpFile,  const char *name ) :
     QVBox( parent, name ),
     m_navFrame(0),
+    m_search(0),
     m_browser(0),
     m_htmlDir(""),
     m_topicFile(""),
@@ -196,6 +303,7 @@ HelpBrowser::HelpBrowser( QWidget *parent, const QString &htmlDir,
 HelpBrowser::~HelpBrowser( void )
 {
     delete m_browser;       m_browser = 0;
+    delete m_search;        m_search = 0;
     for ( int btn = 0;
           btn < 4;
           btn++ )
@@ -206,6 +314,37 @@ HelpBrowser::~HelpBrowser( void )
     return;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Finds the HTML file to display for a topic.
+ *
+ *  If the topic file does not exist (as with variables whose help page was
+ *  never written), the search index resolves it to the best matching page.
+ *
+ *  \param topicFile Topic's HTML document file name; returns the name of the
+ *                   file to display.
+ *
+ *  \return TRUE if there is a file to display, FALSE if not.
+ */
+
+bool HelpBrowser::findTopic( QString &topicFile )
+{
+    QFileInfo fi( m_htmlDir + topicFile );
+    if ( fi.exists() && fi.isReadable() && fi.isFile() )
+    {
+        return( true );
+    }
+    HelpIndex *index = helpBrowserIndex( m_htmlDir );
+    QString page( index ? index->resolve( topicFile ) : QString( "" ) );
+    if ( page.isEmpty() )
+    {
+        return( false );
+    }
+    log( QString( "Help topic \"%1\" resolved to \"%2\".\n" )
+        .arg( topicFile ).arg( page ) );
+    topicFile = page;
+    return( true );
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Private function that assembles the HelpBrowser dialog.
  *
@@ -250,6 +389,12 @@ void HelpBrowser::init( void )
         m_btn[btn]->setMinimumSize( m_btn[btn]->sizeHint() );
     }
 
+    // Search words entry field
+    m_search = new QLineEdit( m_navFrame, "m_search" );
+    Q_CHECK_PTR( m_search );
+    translate( text, "HelpBrowser:Search:Tip" );
+    QToolTip::add( m_search, text );
+
     // Browser
     m_browser = new TextBrowser( this, "m_browser" );
     Q_CHECK_PTR( m_browser );
@@ -270,6 +415,9 @@ void HelpBrowser::init( void )
     // Connect the Index button
     connect( m_btn[3],  SIGNAL( clicked() ),
              this,      SLOT( showIndex() ) );
+    // Connect the search field
+    connect( m_search,  SIGNAL( returnPressed() ),
+             this,      SLOT( search() ) );
 
     // Disable the Back and Frwd buttons to start with and set the minimum size
     m_btn[0]->setEnabled( false );
@@ -284,6 +432,40 @@ void HelpBrowser::init( void )
     return;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Searches the help pages for the words in the search entry field
+ *  and displays the ranked results, each linked to its page.
+ */
+
+void HelpBrowser::search( void )
+{
+    QString query( m_search->text().stripWhiteSpace() );
+    if ( query.isEmpty() )
+    {
+        return;
+    }
+    HelpIndex *index = helpBrowserIndex( m_htmlDir );
+    HelpIndexHit hits[HelpBrowserMaxHits];
+    int n = ( index ) ? index->search( query, hits, HelpBrowserMaxHits ) : 0;
+    QString text("");
+    translate( text, ( n > 0 )
+        ? "HelpBrowser:Search:Results"
+        : "HelpBrowser:Search:NoResults",
+        QStyleSheet::escape( query ), QString::number( n ) );
+    QString html( "<h3>" + text + "</h3>\n" );
+    for ( int hit = 0;
+          hit < n;
+          hit++ )
+    {
+        html += "<p><a href=\"" + index->pageName( hits[hit].m_page ) + "\">"
+              + QStyleSheet::escape( index->pageTitle( hits[hit].m_page ) )
+              + "</a><br>"
+              + index->snippet( hits[hit] ) + "</p>\n";
+    }
+    m_browser->setText( html );
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Sets/resets the HTML directory, topic file, and index file.
  *
@@ -323,17 +505,16 @@ bool HelpBrowser::setFiles( const QString &htmlDir, const QString &topicFile,
     m_htmlDir = htmlDir;
 
     // Check if the topic file exists and is readable
-    QString topicPath( m_htmlDir + topicFile );
-    fi.setFile( topicPath );
-    if ( ! fi.exists() || ! fi.isReadable() || ! fi.isFile() )
+    QString topic( topicFile );
+    if ( ! findTopic( topic ) )
     {
         QString msg("");
-        translate( msg, "HelpBrowser:MissingFile", topicPath );
+        translate( msg, "HelpBrowser:MissingFile", m_htmlDir + topicFile );
         error( msg );
         m_topicFile = indexFile;
         return( false );
     }
-    m_topicFile = topicFile;
+    m_topicFile = topic;
 
     // Check if the index file exists and is readable
     QString indexPath( m_htmlDir + indexFile );
@@ -379,17 +560,16 @@ bool HelpBrowser::setFiles( const QString &htmlDir, const QString &topicFile,
 bool HelpBrowser::setSourceFile( const QString &topicFile )
 {
     // Check if the topic file exists and is readable
-    QString topicPath( m_htmlDir + topicFile );
-    QFileInfo fi( topicPath );
-    if ( ! fi.exists() || ! fi.isReadable() || ! fi.isFile() )
+    QString topic( topicFile );
+    if ( ! findTopic( topic ) )
     {
         QString msg("");
-        translate( msg, "HelpBrowser:MissingFile", topicPath );
+        translate( msg, "HelpBrowser:MissingFile", m_htmlDir + topicFile );
         error( msg );
         m_topicFile = m_indexFile;
         return( false );
     }
-    m_topicFile = topicFile;
+    m_topicFile = topic;
 
     // Set the source file and return.
     m_browser->setSourceFile( m_topicFile );
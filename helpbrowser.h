@@ -14,15 +14,17 @@
 
 // Class references
 #include <qvbox.h>
+class HelpIndex;
 class TextBrowser;
 class QHBox;
+class QLineEdit;
 class QPushButton;
 
 //------------------------------------------------------------------------------
 /*! \class HelpBrowser helpbrowser.h
  *
  *  \brief Embeddable help HTML browser with Back, Forward, Home, and Index
- *  buttons.
+ *  buttons and a full-text search entry field.
  */
 
 class HelpBrowser : public QVBox
@@ -45,16 +47,19 @@ public:
 
 // Private methods
 private:
+    bool findTopic( QString &topicFile ) ;
     void init( void ) ;
 
 // Protected slots
 protected slots:
+    void search( void ) ;
     void showIndex( void ) ;
 
 // Protect data elements
 protected:
     QHBox        *m_navFrame;   //!< Frame for navigation buttons
     QPushButton  *m_btn[4];     //!< Navigation buttons
+    QLineEdit    *m_search;     //!< Search words entry field
     TextBrowser  *m_browser;    //!< Pointer to help's TextBrowser
     QString       m_htmlDir;    //!< HTML directory full path name
     QString       m_topicFile;  //!< Name of current topic file in m_htmlDir
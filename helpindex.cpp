@@ -0,0 +1,1426 @@
+//------------------------------------------------------------------------------
+/*! \file helpindex.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief HelpIndex class methods.
+ */
+
+// Custom include files
+#include "appmessage.h"
+#include "helpindex.h"
+
+// Standard include files
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*! \var HelpIndexMagic
+ *  \brief First int of every index image ("BPHI").
+ */
+static const int HelpIndexMagic = 0x42504849;
+
+/*! \var HelpIndexVersion
+ *  \brief Index image layout version; bump whenever the layout, the word
+ *  splitter, or the stemmer changes so that old files are rebuilt.
+ */
+static const int HelpIndexVersion = 1;
+
+// Index image header, page, term, and posting record layouts (ints)
+static const int HeadMagic    = 0;
+static const int HeadVersion  = 1;
+static const int HeadStamp    = 2;
+static const int HeadPages    = 3;
+static const int HeadTerms    = 4;
+static const int HeadPostings = 5;
+static const int HeadPool     = 6;
+static const int HeadWords    = 7;
+static const int HeadInts     = 8;
+
+static const int PageName     = 0;
+static const int PageTitle    = 1;
+static const int PageText     = 2;
+static const int PageTextLen  = 3;
+static const int PageWords    = 4;
+static const int PageInts     = 5;
+
+static const int TermStr      = 0;
+static const int TermPost     = 1;
+static const int TermPosts    = 2;
+static const int TermInts     = 3;
+
+static const int PostPage     = 0;
+static const int PostFreq     = 1;
+static const int PostPos      = 2;
+static const int PostInts     = 3;
+
+// Build word occurrence layout (ints)
+static const int WordTerm     = 0;
+static const int WordPage     = 1;
+static const int WordPos      = 2;
+static const int WordWeight   = 3;
+static const int WordInts     = 4;
+
+/*! \var TitleWeight
+ *  \brief Each title word counts as this many body words.
+ */
+static const int TitleWeight = 4;
+
+/*! \var NameWeight
+ *  \brief Each file name word counts as this many body words.
+ */
+static const int NameWeight = 2;
+
+/*! \var RankK1
+ *  \brief Okapi BM25 term frequency saturation.
+ */
+static const double RankK1 = 1.2;
+
+/*! \var RankB
+ *  \brief Okapi BM25 page length normalization.
+ */
+static const double RankB = 0.75;
+
+/*! \var StopWords
+ *  \brief Common words that are neither indexed nor searched.
+ */
+static const char *StopWords[] =
+{
+    "a", "an", "and", "are", "as", "at", "be", "by", "for", "from", "if",
+    "in", "is", "it", "of", "on", "or", "that", "the", "this", "to", "with",
+    0
+};
+
+// Term sort context for helpCompareTerms()
+static const char *SortTerms = 0;
+static const int  *SortTermOff = 0;
+
+//------------------------------------------------------------------------------
+/*! \brief Appends \a length characters of \a str plus a terminating null to
+ *  the character \a pool, growing it as necessary.
+ *
+ *  \return Offset of the string in the pool.
+ */
+
+static int helpAppend( char **pool, int *used, int *size, const char *str,
+        int length )
+{
+    if ( *used + length + 1 > *size )
+    {
+        int newSize = ( *size < 4096 ) ? 4096 : 2 * *size;
+        if ( newSize < *used + length + 1 )
+        {
+            newSize = *used + length + 1;
+        }
+        char *newPool = new char[ newSize ];
+        checkmem( __FILE__, __LINE__, newPool, "char newPool", newSize );
+        if ( *pool )
+        {
+            memcpy( newPool, *pool, *used );
+            delete[] *pool;
+        }
+        *pool = newPool;
+        *size = newSize;
+    }
+    int offset = *used;
+    memcpy( *pool + offset, str, length );
+    (*pool)[ offset + length ] = '\0';
+    *used += length + 1;
+    return( offset );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Returns the int \a array grown so that it can hold \a need more
+ *  ints beyond the \a used ints.
+ */
+
+static int *helpGrow( int *array, int used, int *size, int need )
+{
+    if ( used + need <= *size )
+    {
+        return( array );
+    }
+    int newSize = ( *size < 1024 ) ? 1024 : 2 * *size;
+    if ( newSize < used + need )
+    {
+        newSize = used + need;
+    }
+    int *newArray = new int[ newSize ];
+    checkmem( __FILE__, __LINE__, newArray, "int newArray", newSize );
+    if ( array )
+    {
+        memcpy( newArray, array, used * sizeof(int) );
+        delete[] array;
+    }
+    *size = newSize;
+    return( newArray );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Checks that every count and offset in an index image read from
+ *  a file lies within the image, so that a truncated, damaged, or foreign
+ *  file is rebuilt rather than searched.
+ *
+ *  \param block Index image.
+ *  \param bytes Index image size (bytes), at least HeadInts ints.
+ *
+ *  \return TRUE if the image is consistent.
+ */
+
+static bool helpCheckImage( const char *block, int bytes )
+{
+    const int *head = (const int *) block;
+    int ints = bytes / sizeof(int);
+    int pages = head[HeadPages];
+    int terms = head[HeadTerms];
+    int postings = head[HeadPostings];
+    int poolBytes = head[HeadPool];
+    // Check the section counts before multiplying them
+    if ( pages < 1 || pages > ints / PageInts
+      || terms < 0 || terms > ints / TermInts
+      || postings < 0 || postings > ints / PostInts
+      || poolBytes < 1 || poolBytes > bytes
+      || HeadInts + pages * PageInts + terms * TermInts
+            + postings * PostInts > ints
+      || bytes != (int) ( ( HeadInts + pages * PageInts + terms * TermInts
+            + postings * PostInts ) * sizeof(int) ) + poolBytes )
+    {
+        return( false );
+    }
+    const int *page = head + HeadInts;
+    const int *term = page + pages * PageInts;
+    const int *post = term + terms * TermInts;
+    const char *pool = (const char *) ( post + postings * PostInts );
+    // Every pool string must be terminated within the pool
+    if ( pool[ poolBytes - 1 ] != '\0' )
+    {
+        return( false );
+    }
+    int i;
+    const int *r;
+    for ( i = 0;
+          i < pages;
+          i++ )
+    {
+        r = page + i * PageInts;
+        if ( r[PageName] < 0 || r[PageName] >= poolBytes
+          || r[PageTitle] < 0 || r[PageTitle] >= poolBytes
+          || r[PageText] < 0 || r[PageText] >= poolBytes
+          || r[PageTextLen] < 0
+          || r[PageTextLen] >= poolBytes - r[PageText]
+          || r[PageWords] < 0 )
+        {
+            return( false );
+        }
+    }
+    for ( i = 0;
+          i < terms;
+          i++ )
+    {
+        r = term + i * TermInts;
+        if ( r[TermStr] < 0 || r[TermStr] >= poolBytes
+          || r[TermPost] < 0 || r[TermPosts] < 0
+          || r[TermPosts] > postings - r[TermPost] )
+        {
+            return( false );
+        }
+    }
+    for ( i = 0;
+          i < postings;
+          i++ )
+    {
+        r = post + i * PostInts;
+        if ( r[PostPage] < 0 || r[PostPage] >= pages
+          || r[PostFreq] < 0 || r[PostPos] < -1 )
+        {
+            return( false );
+        }
+    }
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief qsort() comparison function ordering term ids alphabetically.
+ */
+
+static int helpCompareTerms( const void *a, const void *b )
+{
+    return( strcmp( SortTerms + SortTermOff[ *(const int *) a ],
+                    SortTerms + SortTermOff[ *(const int *) b ] ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief qsort() comparison function ordering word occurrences by term,
+ *  page, and position.
+ */
+
+static int helpCompareWords( const void *a, const void *b )
+{
+    const int *wa = (const int *) a;
+    const int *wb = (const int *) b;
+    if ( wa[WordTerm] != wb[WordTerm] )
+    {
+        return( wa[WordTerm] - wb[WordTerm] );
+    }
+    if ( wa[WordPage] != wb[WordPage] )
+    {
+        return( wa[WordPage] - wb[WordPage] );
+    }
+    return( wa[WordPos] - wb[WordPos] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Decodes an HTML character entity.
+ *
+ *  \param html   Text beginning with the entity's '&'.
+ *  \param length Number of characters available.
+ *  \param used   Returns the number of characters in the entity.
+ *
+ *  \return The decoded character, or a blank if it is not a Latin-1
+ *  character.
+ */
+
+static char helpEntity( const char *html, int length, int *used )
+{
+    int semi;
+    for ( semi = 1;
+          semi < length && semi < 10 && html[semi] != ';';
+          semi++ )
+    {
+        ;
+    }
+    if ( semi >= length || html[semi] != ';' )
+    {
+        *used = 1;
+        return( '&' );
+    }
+    *used = semi + 1;
+    if ( html[1] == '#' )
+    {
+        int code = atoi( html + 2 );
+        return( ( code > 32 && code < 256 ) ? (char) code : ' ' );
+    }
+    static const char *Name[] = { "amp;", "lt;", "gt;", "quot;", 0 };
+    static const char  Char[] = { '&', '<', '>', '"' };
+    for ( int i = 0;
+          Name[i];
+          i++ )
+    {
+        if ( strncmp( html + 1, Name[i], strlen( Name[i] ) ) == 0 )
+        {
+            return( Char[i] );
+        }
+    }
+    return( ' ' );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Converts HTML to plain text.
+ *
+ *  Tags and comments are removed, script and style elements are skipped,
+ *  entities are decoded, and all white space is collapsed to single blanks.
+ *
+ *  \param html     HTML text.
+ *  \param length   Number of HTML characters.
+ *  \param text     Buffer of at least \a length characters to hold the text.
+ *  \param titleAt  If not NULL, returns the offset of the title element's
+ *                  contents in \a html.
+ *  \param titleLen If not NULL, returns the length of the title element's
+ *                  contents (0 if there is no title).
+ *
+ *  \return Number of characters placed in \a text.
+ */
+
+static int helpHtmlText( const char *html, int length, char *text,
+        int *titleAt, int *titleLen )
+{
+    int n = 0;
+    int i = 0;
+    bool blank = true;
+    if ( titleLen )
+    {
+        *titleAt = *titleLen = 0;
+    }
+    while ( i < length )
+    {
+        char c = html[i];
+        if ( c == '<' )
+        {
+            int j = i + 1;
+            if ( length - i >= 4 && strncmp( html + i, "<!--", 4 ) == 0 )
+            {
+                for ( j = i + 4;
+                      j < length - 2 && strncmp( html + j, "-->", 3 ) != 0;
+                      j++ )
+                {
+                    ;
+                }
+                i = j + 3;
+                continue;
+            }
+            bool closing = ( j < length && html[j] == '/' );
+            if ( closing )
+            {
+                j++;
+            }
+            char tag[16];
+            int t = 0;
+            while ( j < length && t < 15 && isalpha( (unsigned char) html[j] ) )
+            {
+                tag[t++] = (char) tolower( (unsigned char) html[j++] );
+            }
+            tag[t] = '\0';
+            while ( j < length && html[j] != '>' )
+            {
+                j++;
+            }
+            i = j + 1;
+            // Skip to the closing tag of elements whose contents aren't text
+            if ( ! closing
+              && ( strcmp( tag, "title" ) == 0
+                || strcmp( tag, "script" ) == 0
+                || strcmp( tag, "style" ) == 0 ) )
+            {
+                int k;
+                for ( k = i;
+                      k < length - t - 1;
+                      k++ )
+                {
+                    if ( html[k] == '<' && html[k+1] == '/' )
+                    {
+                        int m;
+                        for ( m = 0;
+                              m < t && tolower( (unsigned char) html[k+2+m] ) == tag[m];
+                              m++ )
+                        {
+                            ;
+                        }
+                        if ( m == t )
+                        {
+                            break;
+                        }
+                    }
+                }
+                if ( k >= length - t - 1 )
+                {
+                    k = length;
+                }
+                if ( tag[0] == 't' && titleLen )
+                {
+                    *titleAt  = i;
+                    *titleLen = k - i;
+                }
+                i = k;
+            }
+            if ( ! blank )
+            {
+                text[n++] = ' ';
+                blank = true;
+            }
+            continue;
+        }
+        if ( c == '&' )
+        {
+            int used;
+            c = helpEntity( html + i, length - i, &used );
+            i += used;
+        }
+        else
+        {
+            i++;
+        }
+        if ( isspace( (unsigned char) c ) )
+        {
+            if ( ! blank )
+            {
+                text[n++] = ' ';
+                blank = true;
+            }
+        }
+        else
+        {
+            text[n++] = c;
+            blank = false;
+        }
+    }
+    while ( n > 0 && text[n-1] == ' ' )
+    {
+        n--;
+    }
+    text[n] = '\0';
+    return( n );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Reduces a lower case word to its stem in place.
+ *
+ *  This is a light suffix stripper in the spirit of the first step of
+ *  Porter's algorithm: plurals and -ed, -ing, and -ly endings are removed
+ *  and a doubled final consonant left behind is undoubled.
+ *
+ *  \return Length of the stem.
+ */
+
+static int helpStem( char *w, int n )
+{
+    if ( n > 4 && strcmp( w + n - 4, "sses" ) == 0 )
+    {
+        n -= 2;
+    }
+    else if ( n > 4 && strcmp( w + n - 3, "ies" ) == 0 )
+    {
+        n -= 2;
+        w[n-1] = 'y';
+    }
+    else if ( n > 3 && w[n-1] == 's'
+        && w[n-2] != 's' && w[n-2] != 'u' && w[n-2] != 'i' )
+    {
+        n--;
+    }
+    w[n] = '\0';
+    int stripped = 0;
+    if ( n > 5 && strcmp( w + n - 3, "ing" ) == 0 )
+    {
+        stripped = 3;
+    }
+    else if ( n > 4 && strcmp( w + n - 2, "ed" ) == 0 )
+    {
+        stripped = 2;
+    }
+    else if ( n > 4 && strcmp( w + n - 2, "ly" ) == 0 )
+    {
+        stripped = 2;
+    }
+    if ( stripped )
+    {
+        n -= stripped;
+        if ( n > 2 && w[n-1] == w[n-2] && isalpha( (unsigned char) w[n-1] )
+          && ! strchr( "aeioulsz", w[n-1] ) )
+        {
+            n--;
+        }
+    }
+    w[n] = '\0';
+    return( n );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Finds the next indexable word in \a text.
+ *
+ *  Words are runs of ASCII letters and digits.  Each is lower cased,
+ *  truncated to HelpIndexMaxWord characters, and stemmed; stems shorter
+ *  than 2 characters and stop words are skipped.
+ *
+ *  \param text   Text to scan.
+ *  \param length Number of characters in \a text.
+ *  \param at     Scan position; updated to just past the word.
+ *  \param word   Buffer of HelpIndexMaxWord+1 characters for the stem.
+ *  \param start  Returns the offset of the word in \a text.
+ *
+ *  \return Length of the stem, or 0 if there are no more words.
+ */
+
+static int helpWord( const char *text, int length, int *at, char *word,
+        int *start )
+{
+    int i = *at;
+    while ( i < length )
+    {
+        while ( i < length && ! isalnum( (unsigned char) text[i] ) )
+        {
+            i++;
+        }
+        if ( i >= length )
+        {
+            break;
+        }
+        int n = 0;
+        *start = i;
+        while ( i < length && isalnum( (unsigned char) text[i] ) )
+        {
+            if ( n < HelpIndexMaxWord )
+            {
+                word[n++] = (char) tolower( (unsigned char) text[i] );
+            }
+            i++;
+        }
+        word[n] = '\0';
+        n = helpStem( word, n );
+        bool stop = ( n < 2 );
+        for ( int s = 0;
+              ! stop && StopWords[s];
+              s++ )
+        {
+            stop = ( strcmp( word, StopWords[s] ) == 0 );
+        }
+        if ( ! stop )
+        {
+            *at = i;
+            return( n );
+        }
+    }
+    *at = i;
+    return( 0 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief HelpIndex constructor.
+ *
+ *  The index is empty until pages are added and finish() is called, or
+ *  until an index file is load()ed.
+ */
+
+HelpIndex::HelpIndex( void ) :
+    m_block(0),
+    m_blockBytes(0),
+    m_head(0),
+    m_page(0),
+    m_term(0),
+    m_post(0),
+    m_pool(0),
+    m_bPool(0),
+    m_bPoolBytes(0),
+    m_bPoolSize(0),
+    m_bTerms(0),
+    m_bTermsBytes(0),
+    m_bTermsSize(0),
+    m_bTermOff(0),
+    m_bTermCount(0),
+    m_bTermSize(0),
+    m_bHash(0),
+    m_bHashSize(0),
+    m_bPages(0),
+    m_bPageCount(0),
+    m_bPageSize(0),
+    m_bWords(0),
+    m_bWordCount(0),
+    m_bWordSize(0)
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief HelpIndex destructor.
+ */
+
+HelpIndex::~HelpIndex( void )
+{
+    clear();
+    delete[] m_block;   m_block = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Adds a help page to the index being built.
+ *
+ *  Words in the page title and in the file name (split at case changes)
+ *  are weighted more heavily than words in the body.
+ *
+ *  \param fileName Page file name relative to the HTML directory.
+ *  \param html     Page HTML text.
+ *  \param length   Number of characters in \a html.
+ *
+ *  \return TRUE if the page was added, FALSE if finish() was already called.
+ */
+
+bool HelpIndex::addPage( const QString &fileName, const char *html,
+        int length )
+{
+    if ( m_block )
+    {
+        return( false );
+    }
+    // Extract the plain text and title
+    char *text = new char[ length + 1 ];
+    checkmem( __FILE__, __LINE__, text, "char text", length + 1 );
+    int titleAt, titleLen;
+    int textLen = helpHtmlText( html, length, text, &titleAt, &titleLen );
+    char *title = new char[ titleLen + 1 ];
+    checkmem( __FILE__, __LINE__, title, "char title", titleLen + 1 );
+    int titleChars = helpHtmlText( html + titleAt, titleLen, title, 0, 0 );
+    // Every title reads "BehavePlus <topic> Page", so keep just the topic
+    char *topic = title;
+    if ( strncmp( topic, "BehavePlus ", 11 ) == 0 && titleChars > 11 )
+    {
+        topic += 11;
+        titleChars -= 11;
+    }
+    if ( titleChars > 5 && strcmp( topic + titleChars - 5, " Page" ) == 0 )
+    {
+        titleChars -= 5;
+    }
+    // Split the file name into words at case changes
+    const char *name = fileName.latin1();
+    int nameLen = strlen( name );
+    char *nameWords = new char[ 2 * nameLen + 1 ];
+    checkmem( __FILE__, __LINE__, nameWords, "char nameWords", 2 * nameLen + 1 );
+    int nameChars = 0;
+    for ( int i = 0;
+          i < nameLen && name[i] != '.';
+          i++ )
+    {
+        if ( i > 0 && isupper( (unsigned char) name[i] )
+          && ! isupper( (unsigned char) name[i-1] ) )
+        {
+            nameWords[nameChars++] = ' ';
+        }
+        nameWords[nameChars++] = name[i];
+    }
+
+    // Add the page record and its words
+    int page = m_bPageCount;
+    m_bPages = helpGrow( m_bPages, page * PageInts, &m_bPageSize, PageInts );
+    int *rec = m_bPages + page * PageInts;
+    rec[PageName] = helpAppend( &m_bPool, &m_bPoolBytes, &m_bPoolSize,
+        name, nameLen );
+    rec[PageTitle] = ( titleChars > 0 )
+        ? helpAppend( &m_bPool, &m_bPoolBytes, &m_bPoolSize, topic, titleChars )
+        : rec[PageName];
+    rec[PageText] = helpAppend( &m_bPool, &m_bPoolBytes, &m_bPoolSize,
+        text, textLen );
+    rec[PageTextLen] = textLen;
+    m_bPageCount++;
+    addWords( topic, titleChars, page, TitleWeight, true );
+    addWords( nameWords, nameChars, page, NameWeight, true );
+    rec = m_bPages + page * PageInts;
+    rec[PageWords] = addWords( text, textLen, page, 1, false );
+
+    delete[] nameWords;
+    delete[] title;
+    delete[] text;
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Returns the build id of \a term, adding it if it is new.
+ */
+
+int HelpIndex::addTerm( const char *term )
+{
+    // Keep the hash table no more than half full
+    if ( 2 * ( m_bTermCount + 1 ) > m_bHashSize )
+    {
+        int newSize = ( m_bHashSize < 4096 ) ? 4096 : 2 * m_bHashSize;
+        int *newHash = new int[ newSize ];
+        checkmem( __FILE__, __LINE__, newHash, "int newHash", newSize );
+        memset( newHash, 0, newSize * sizeof(int) );
+        for ( int i = 0;
+              i < m_bHashSize;
+              i++ )
+        {
+            if ( m_bHash[i] )
+            {
+                unsigned int h = 2166136261u;
+                for ( const char *c = m_bTerms + m_bTermOff[ m_bHash[i] - 1 ];
+                      *c;
+                      c++ )
+                {
+                    h = ( h ^ (unsigned char) *c ) * 16777619u;
+                }
+                int slot = (int) ( h & ( newSize - 1 ) );
+                while ( newHash[slot] )
+                {
+                    slot = ( slot + 1 ) & ( newSize - 1 );
+                }
+                newHash[slot] = m_bHash[i];
+            }
+        }
+        delete[] m_bHash;
+        m_bHash = newHash;
+        m_bHashSize = newSize;
+    }
+    // Look for the term
+    unsigned int h = 2166136261u;
+    for ( const char *c = term;
+          *c;
+          c++ )
+    {
+        h = ( h ^ (unsigned char) *c ) * 16777619u;
+    }
+    int slot = (int) ( h & ( m_bHashSize - 1 ) );
+    while ( m_bHash[slot] )
+    {
+        if ( strcmp( m_bTerms + m_bTermOff[ m_bHash[slot] - 1 ], term ) == 0 )
+        {
+            return( m_bHash[slot] - 1 );
+        }
+        slot = ( slot + 1 ) & ( m_bHashSize - 1 );
+    }
+    // Add it
+    m_bTermOff = helpGrow( m_bTermOff, m_bTermCount, &m_bTermSize, 1 );
+    m_bTermOff[m_bTermCount] = helpAppend( &m_bTerms, &m_bTermsBytes,
+        &m_bTermsSize, term, strlen( term ) );
+    m_bHash[slot] = ++m_bTermCount;
+    return( m_bTermCount - 1 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Adds every word in \a text to the build word occurrences.
+ *
+ *  \param text   Text to index.
+ *  \param length Number of characters in \a text.
+ *  \param page   Page index.
+ *  \param weight Number of body words each occurrence counts as.
+ *  \param title  If TRUE, the text is a title or name and the occurrences
+ *                have no body position.
+ *
+ *  \return Number of words added.
+ */
+
+int HelpIndex::addWords( const char *text, int length, int page, int weight,
+        bool title )
+{
+    char word[HelpIndexMaxWord+1];
+    int at = 0;
+    int start = 0;
+    int words = 0;
+    while ( helpWord( text, length, &at, word, &start ) > 0 )
+    {
+        int term = addTerm( word );
+        m_bWords = helpGrow( m_bWords, m_bWordCount * WordInts, &m_bWordSize,
+            WordInts );
+        int *rec = m_bWords + m_bWordCount * WordInts;
+        rec[WordTerm]   = term;
+        rec[WordPage]   = page;
+        rec[WordPos]    = title ? -1 : start;
+        rec[WordWeight] = weight;
+        m_bWordCount++;
+        words++;
+    }
+    return( words );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Releases the build work areas.
+ */
+
+void HelpIndex::clear( void )
+{
+    delete[] m_bPool;       m_bPool = 0;
+    delete[] m_bTerms;      m_bTerms = 0;
+    delete[] m_bTermOff;    m_bTermOff = 0;
+    delete[] m_bHash;       m_bHash = 0;
+    delete[] m_bPages;      m_bPages = 0;
+    delete[] m_bWords;      m_bWords = 0;
+    m_bPoolBytes = m_bPoolSize = 0;
+    m_bTermsBytes = m_bTermsSize = 0;
+    m_bTermCount = m_bTermSize = m_bHashSize = 0;
+    m_bPageCount = m_bPageSize = 0;
+    m_bWordCount = m_bWordSize = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Finds a term, or the range of terms beginning with a prefix.
+ *
+ *  \param term   Stemmed term.
+ *  \param prefix If TRUE, find all terms that begin with \a term.
+ *  \param last   Returns the index of the last matching term.
+ *
+ *  \return Index of the first matching term, or -1 if there is none.
+ */
+
+int HelpIndex::findTerm( const char *term, bool prefix, int *last ) const
+{
+    int terms = m_head[HeadTerms];
+    int lo = 0;
+    int hi = terms;
+    while ( lo < hi )
+    {
+        int mid = ( lo + hi ) / 2;
+        if ( strcmp( m_pool + m_term[ mid * TermInts + TermStr ], term ) < 0 )
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    if ( ! prefix )
+    {
+        if ( lo < terms
+          && strcmp( m_pool + m_term[ lo * TermInts + TermStr ], term ) == 0 )
+        {
+            *last = lo;
+            return( lo );
+        }
+        return( -1 );
+    }
+    int n = strlen( term );
+    int end = lo;
+    while ( end < terms
+        && strncmp( m_pool + m_term[ end * TermInts + TermStr ], term, n ) == 0 )
+    {
+        end++;
+    }
+    *last = end - 1;
+    return( ( end > lo ) ? lo : -1 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Packs the added pages into the finished index image and releases
+ *  the build work areas.
+ *
+ *  \param stamp Value identifying the set of source pages, checked by load().
+ *
+ *  \return TRUE on success, FALSE if no pages were added.
+ */
+
+bool HelpIndex::finish( unsigned int stamp )
+{
+    if ( m_block || m_bPageCount == 0 )
+    {
+        return( false );
+    }
+    int i, r;
+    // Order the terms alphabetically and renumber the occurrences by rank
+    int *order = new int[ m_bTermCount ];
+    checkmem( __FILE__, __LINE__, order, "int order", m_bTermCount );
+    int *rank = new int[ m_bTermCount ];
+    checkmem( __FILE__, __LINE__, rank, "int rank", m_bTermCount );
+    for ( i = 0;
+          i < m_bTermCount;
+          i++ )
+    {
+        order[i] = i;
+    }
+    SortTerms = m_bTerms;
+    SortTermOff = m_bTermOff;
+    qsort( order, m_bTermCount, sizeof(int), helpCompareTerms );
+    for ( r = 0;
+          r < m_bTermCount;
+          r++ )
+    {
+        rank[ order[r] ] = r;
+    }
+    for ( i = 0;
+          i < m_bWordCount;
+          i++ )
+    {
+        m_bWords[ i * WordInts + WordTerm ] =
+            rank[ m_bWords[ i * WordInts + WordTerm ] ];
+    }
+    qsort( m_bWords, m_bWordCount, WordInts * sizeof(int), helpCompareWords );
+
+    // Count the postings (distinct term-page pairs)
+    int postings = 0;
+    for ( i = 0;
+          i < m_bWordCount;
+          i++ )
+    {
+        const int *w = m_bWords + i * WordInts;
+        if ( i == 0 || w[WordTerm] != w[WordTerm-WordInts]
+          || w[WordPage] != w[WordPage-WordInts] )
+        {
+            postings++;
+        }
+    }
+
+    // Allocate and lay out the image
+    int ints = HeadInts + m_bPageCount * PageInts + m_bTermCount * TermInts
+             + postings * PostInts;
+    int bytes = ints * sizeof(int) + m_bPoolBytes + m_bTermsBytes;
+    char *block = new char[ bytes ];
+    checkmem( __FILE__, __LINE__, block, "char block", bytes );
+    int *head = (int *) block;
+    int *page = head + HeadInts;
+    int *term = page + m_bPageCount * PageInts;
+    int *post = term + m_bTermCount * TermInts;
+    char *pool = block + ints * sizeof(int);
+    memset( head, 0, HeadInts * sizeof(int) );
+    head[HeadMagic]    = HelpIndexMagic;
+    head[HeadVersion]  = HelpIndexVersion;
+    head[HeadStamp]    = (int) stamp;
+    head[HeadPages]    = m_bPageCount;
+    head[HeadTerms]    = m_bTermCount;
+    head[HeadPostings] = postings;
+    head[HeadPool]     = m_bPoolBytes + m_bTermsBytes;
+    for ( i = 0;
+          i < m_bPageCount;
+          i++ )
+    {
+        head[HeadWords] += m_bPages[ i * PageInts + PageWords ];
+    }
+    memcpy( page, m_bPages, m_bPageCount * PageInts * sizeof(int) );
+    memcpy( pool, m_bPool, m_bPoolBytes );
+    memcpy( pool + m_bPoolBytes, m_bTerms, m_bTermsBytes );
+    for ( r = 0;
+          r < m_bTermCount;
+          r++ )
+    {
+        term[ r * TermInts + TermStr ] = m_bPoolBytes + m_bTermOff[ order[r] ];
+        term[ r * TermInts + TermPost ] = 0;
+        term[ r * TermInts + TermPosts ] = 0;
+    }
+    // Collapse the occurrences into postings; since the title and name
+    // occurrences (position -1) sort first, the first body occurrence
+    // on each page is its earliest.
+    int *p = post - PostInts;
+    for ( i = 0;
+          i < m_bWordCount;
+          i++ )
+    {
+        const int *w = m_bWords + i * WordInts;
+        if ( i == 0 || w[WordTerm] != w[WordTerm-WordInts]
+          || w[WordPage] != w[WordPage-WordInts] )
+        {
+            p += PostInts;
+            p[PostPage] = w[WordPage];
+            p[PostFreq] = 0;
+            p[PostPos]  = -1;
+            int *t = term + w[WordTerm] * TermInts;
+            if ( t[TermPosts] == 0 )
+            {
+                t[TermPost] = ( p - post ) / PostInts;
+            }
+            t[TermPosts]++;
+        }
+        p[PostFreq] += w[WordWeight];
+        if ( p[PostPos] < 0 )
+        {
+            p[PostPos] = w[WordPos];
+        }
+    }
+    delete[] rank;
+    delete[] order;
+    clear();
+    setBlock( block, bytes );
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Reads an index image saved by save().
+ *
+ *  \param indexPath Index file full path name.
+ *  \param stamp     Value identifying the current set of source pages.
+ *
+ *  \return TRUE on success, FALSE if the file is missing, unreadable, of
+ *  another layout version, was built from a different set of pages, or has
+ *  any count or offset outside the file (see helpCheckImage()).
+ */
+
+bool HelpIndex::load( const QString &indexPath, unsigned int stamp )
+{
+    FILE *fptr = fopen( indexPath.latin1(), "rb" );
+    if ( ! fptr )
+    {
+        return( false );
+    }
+    long size = -1L;
+    if ( fseek( fptr, 0L, SEEK_END ) == 0 )
+    {
+        size = ftell( fptr );
+    }
+    if ( size < (long) ( HeadInts * sizeof(int) )
+      || size > 0x7fffffffL
+      || fseek( fptr, 0L, SEEK_SET ) != 0 )
+    {
+        fclose( fptr );
+        return( false );
+    }
+    int bytes = (int) size;
+    char *block = new char[ bytes ];
+    checkmem( __FILE__, __LINE__, block, "char block", bytes );
+    bool ok = ( (int) fread( block, 1, bytes, fptr ) == bytes );
+    fclose( fptr );
+    const int *head = (const int *) block;
+    if ( ok )
+    {
+        ok = head[HeadMagic] == HelpIndexMagic
+          && head[HeadVersion] == HelpIndexVersion
+          && head[HeadStamp] == (int) stamp
+          && helpCheckImage( block, bytes );
+    }
+    if ( ! ok )
+    {
+        delete[] block;
+        return( false );
+    }
+    clear();
+    setBlock( block, bytes );
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to a page's file name.
+ *
+ *  \param page Page index in the range [0..pages()-1].
+ *
+ *  \return Page file name relative to the HTML directory.
+ */
+
+QString HelpIndex::pageName( int page ) const
+{
+    return( QString( m_pool + m_page[ page * PageInts + PageName ] ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the number of indexed pages.
+ *
+ *  \return Number of indexed pages, or 0 if the index is not finished.
+ */
+
+int HelpIndex::pages( void ) const
+{
+    return( m_head ? m_head[HeadPages] : 0 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to a page's title.
+ *
+ *  \param page Page index in the range [0..pages()-1].
+ *
+ *  \return Page title, or its file name if it has no title.
+ */
+
+QString HelpIndex::pageTitle( int page ) const
+{
+    return( QString( m_pool + m_page[ page * PageInts + PageTitle ] ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Resolves a help file name to an indexed page.
+ *
+ *  If the file is not one of the indexed pages (as with variables whose
+ *  help page was never written), its name is split into words at case
+ *  changes and the best matching page for those words is returned.
+ *
+ *  \param fileName Help file name, e.g. "vSurfaceFireFlameAngle.html".
+ *
+ *  \return Name of the page to display, or an empty string if none matches.
+ */
+
+QString HelpIndex::resolve( const QString &fileName ) const
+{
+    if ( ! m_block )
+    {
+        return( QString( "" ) );
+    }
+    const char *name = fileName.latin1();
+    int page;
+    for ( page = 0;
+          page < m_head[HeadPages];
+          page++ )
+    {
+        if ( strcmp( m_pool + m_page[ page * PageInts + PageName ], name ) == 0 )
+        {
+            return( fileName );
+        }
+    }
+    // Split the base name into words, dropping a variable's "v" prefix
+    char words[256];
+    int n = 0;
+    int i = ( name[0] == 'v' && isupper( (unsigned char) name[1] ) ) ? 1 : 0;
+    for ( ;
+          name[i] && name[i] != '.' && n < 254;
+          i++ )
+    {
+        if ( n > 0 && isupper( (unsigned char) name[i] )
+          && ! isupper( (unsigned char) name[i-1] ) )
+        {
+            words[n++] = ' ';
+        }
+        words[n++] = name[i];
+    }
+    words[n] = '\0';
+    HelpIndexHit hit;
+    if ( search( QString( words ), &hit, 1 ) > 0 )
+    {
+        return( pageName( hit.m_page ) );
+    }
+    return( QString( "" ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Writes the finished index image to a file.
+ *
+ *  \param indexPath Index file full path name.
+ *
+ *  \return TRUE on success, FALSE if the index is unfinished or the file
+ *  cannot be written.
+ */
+
+bool HelpIndex::save( const QString &indexPath ) const
+{
+    if ( ! m_block )
+    {
+        return( false );
+    }
+    FILE *fptr = fopen( indexPath.latin1(), "wb" );
+    if ( ! fptr )
+    {
+        return( false );
+    }
+    bool ok = ( (int) fwrite( m_block, 1, m_blockBytes, fptr ) == m_blockBytes );
+    if ( fclose( fptr ) != 0 )
+    {
+        ok = false;
+    }
+    if ( ! ok )
+    {
+        remove( indexPath.latin1() );
+    }
+    return( ok );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Searches the index.
+ *
+ *  Each query word is stemmed and looked up; the last word also matches
+ *  every term it begins if it is not itself a term, so partially typed
+ *  words still find pages.  Pages are ranked by Okapi BM25, which keeps
+ *  long index pages that mention everything from crowding out the topic
+ *  pages.  Only pages containing every query
+ *  word are returned, unless there are none, in which case pages
+ *  containing any query word are returned.
+ *
+ *  \param query   Query words.
+ *  \param hits    Array of at least \a maxHits hits to receive the results.
+ *  \param maxHits Maximum number of results.
+ *
+ *  \return Number of hits, in decreasing order of score.
+ */
+
+int HelpIndex::search( const QString &query, HelpIndexHit *hits,
+        int maxHits ) const
+{
+    if ( ! m_block || maxHits < 1 )
+    {
+        return( 0 );
+    }
+    int pages = m_head[HeadPages];
+    double avgWords = (double) m_head[HeadWords] / (double) pages + 1.;
+    double *score = new double[ 2 * pages ];
+    checkmem( __FILE__, __LINE__, score, "double score", 2 * pages );
+    double *best = score + pages;
+    int *matched = new int[ 3 * pages ];
+    checkmem( __FILE__, __LINE__, matched, "int matched", 3 * pages );
+    int *seen = matched + pages;
+    int *pos = seen + pages;
+    int pg;
+    for ( pg = 0;
+          pg < pages;
+          pg++ )
+    {
+        score[pg] = best[pg] = 0.;
+        matched[pg] = seen[pg] = 0;
+        pos[pg] = -1;
+    }
+
+    const char *q = query.latin1();
+    int length = strlen( q );
+    char word[HelpIndexMaxWord+1];
+    int at = 0;
+    int start = 0;
+    int words = 0;
+    while ( helpWord( q, length, &at, word, &start ) > 0 )
+    {
+        words++;
+        int last;
+        int first = findTerm( word, false, &last );
+        if ( first < 0 )
+        {
+            int rest = at;
+            while ( rest < length && ! isalnum( (unsigned char) q[rest] ) )
+            {
+                rest++;
+            }
+            if ( rest >= length )
+            {
+                first = findTerm( word, true, &last );
+            }
+        }
+        for ( int t = first;
+              first >= 0 && t <= last;
+              t++ )
+        {
+            const int *trec = m_term + t * TermInts;
+            double df = (double) trec[TermPosts];
+            double idf = log( 1. + ( pages - df + 0.5 ) / ( df + 0.5 ) );
+            const int *p = m_post + trec[TermPost] * PostInts;
+            for ( int k = 0;
+                  k < trec[TermPosts];
+                  k++, p += PostInts )
+            {
+                pg = p[PostPage];
+                double tf = (double) p[PostFreq];
+                double norm = 1. - RankB + RankB
+                    * m_page[ pg * PageInts + PageWords ] / avgWords;
+                double w = idf * tf * ( RankK1 + 1. ) / ( tf + RankK1 * norm );
+                score[pg] += w;
+                if ( seen[pg] != words )
+                {
+                    seen[pg] = words;
+                    matched[pg]++;
+                }
+                if ( p[PostPos] >= 0 && w > best[pg] )
+                {
+                    best[pg] = w;
+                    pos[pg] = p[PostPos];
+                }
+            }
+        }
+    }
+
+    // Require every query word if any page has them all
+    int need = words;
+    for ( pg = 0;
+          pg < pages && need > 1;
+          pg++ )
+    {
+        if ( matched[pg] == words )
+        {
+            break;
+        }
+    }
+    if ( pg == pages )
+    {
+        need = 1;
+    }
+    // Keep the best maxHits pages by insertion
+    int n = 0;
+    for ( pg = 0;
+          words > 0 && pg < pages;
+          pg++ )
+    {
+        if ( matched[pg] < need
+          || ( n == maxHits && score[pg] <= hits[n-1].m_score ) )
+        {
+            continue;
+        }
+        int i = ( n < maxHits ) ? n++ : n - 1;
+        while ( i > 0 && hits[i-1].m_score < score[pg] )
+        {
+            hits[i] = hits[i-1];
+            i--;
+        }
+        hits[i].m_page  = pg;
+        hits[i].m_pos   = pos[pg];
+        hits[i].m_score = score[pg];
+    }
+    delete[] matched;
+    delete[] score;
+    return( n );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the finished index image and the pointers into it.
+ */
+
+void HelpIndex::setBlock( char *block, int bytes )
+{
+    delete[] m_block;
+    m_block = block;
+    m_blockBytes = bytes;
+    m_head = (int *) m_block;
+    m_page = m_head + HeadInts;
+    m_term = m_page + m_head[HeadPages] * PageInts;
+    m_post = m_term + m_head[HeadTerms] * TermInts;
+    m_pool = (char *) ( m_post + m_head[HeadPostings] * PostInts );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Composes an HTML snippet of the page text around a hit's best
+ *  matching word, which is shown in bold.
+ *
+ *  \param hit   Search hit.
+ *  \param width Approximate snippet length (characters).
+ *
+ *  \return HTML snippet.
+ */
+
+QString HelpIndex::snippet( const HelpIndexHit &hit, int width ) const
+{
+    const int *rec = m_page + hit.m_page * PageInts;
+    const char *text = m_pool + rec[PageText];
+    int length = rec[PageTextLen];
+    int pos = ( hit.m_pos < 0 || hit.m_pos >= length ) ? 0 : hit.m_pos;
+    // Start and end on word boundaries
+    int beg = pos - width / 3;
+    if ( beg <= 0 )
+    {
+        beg = 0;
+    }
+    else
+    {
+        while ( beg < pos && text[beg-1] != ' ' )
+        {
+            beg++;
+        }
+    }
+    int end = beg + width;
+    if ( end >= length )
+    {
+        end = length;
+    }
+    else
+    {
+        while ( end > pos && text[end] != ' ' )
+        {
+            end--;
+        }
+    }
+    // Find the end of the matching word
+    int wordEnd = pos;
+    if ( hit.m_pos >= 0 )
+    {
+        while ( wordEnd < end && isalnum( (unsigned char) text[wordEnd] ) )
+        {
+            wordEnd++;
+        }
+    }
+    // Copy with HTML escapes
+    char *buffer = new char[ 6 * ( end - beg ) + 16 ];
+    checkmem( __FILE__, __LINE__, buffer, "char buffer", 6 * ( end - beg ) + 16 );
+    int n = 0;
+    if ( beg > 0 )
+    {
+        n += sprintf( buffer + n, "..." );
+    }
+    for ( int i = beg;
+          i < end;
+          i++ )
+    {
+        if ( i == pos && wordEnd > pos )
+        {
+            n += sprintf( buffer + n, "<b>" );
+        }
+        if ( text[i] == '<' )
+        {
+            n += sprintf( buffer + n, "&lt;" );
+        }
+        else if ( text[i] == '>' )
+        {
+            n += sprintf( buffer + n, "&gt;" );
+        }
+        else if ( text[i] == '&' )
+        {
+            n += sprintf( buffer + n, "&amp;" );
+        }
+        else
+        {
+            buffer[n++] = text[i];
+        }
+        if ( i + 1 == wordEnd && wordEnd > pos )
+        {
+            n += sprintf( buffer + n, "</b>" );
+        }
+    }
+    if ( end < length )
+    {
+        n += sprintf( buffer + n, "..." );
+    }
+    buffer[n] = '\0';
+    QString str( buffer );
+    delete[] buffer;
+    return( str );
+}
+
+//------------------------------------------------------------------------------
+//  End of helpindex.cpp
+//------------------------------------------------------------------------------
+
@@ -0,0 +1,118 @@
+//------------------------------------------------------------------------------
+/*! \file helpindex.h
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief HelpIndex class declaration.
+ *
+ *  A HelpIndex is an inverted index over the bundled help HTML pages.
+ *  Page text is stripped of markup, split into lower case words, and each
+ *  word is reduced to its stem by a light suffix-stripping stemmer so that
+ *  "spotting", "spots", and "spotted" all find the same pages.
+ *
+ *  The finished index is a single block of ints and characters: a header,
+ *  a page table, an alphabetical term table, the postings of every term,
+ *  and a character pool holding the terms, page names, titles, and plain
+ *  text.  save() writes the block as is and load() reads it back with one
+ *  read, so searches run directly against the file image and never parse
+ *  or allocate per term.  A search is a binary search per query word plus
+ *  a pass over that word's postings.
+ */
+
+#ifndef _HELPINDEX_H_
+/*! \def _HELPINDEX_H_
+ *  \brief Prevent redundant includes.
+ */
+#define _HELPINDEX_H_ 1
+
+// Qt include files
+#include <qstring.h>
+
+/*! \var HelpIndexMaxWord
+ *  \brief Maximum number of characters indexed per word.
+ */
+static const int HelpIndexMaxWord = 32;
+
+//------------------------------------------------------------------------------
+/*! \class HelpIndexHit helpindex.h
+ *
+ *  \brief A single ranked search result.
+ */
+
+class HelpIndexHit
+{
+public:
+    int     m_page;         //!< Page index
+    int     m_pos;          //!< Offset of the best matching word in the page text
+    double  m_score;        //!< Relevance score (larger is better)
+};
+
+//------------------------------------------------------------------------------
+/*! \class HelpIndex helpindex.h
+ *
+ *  \brief Full-text inverted index over the help HTML pages.
+ */
+
+class HelpIndex
+{
+// Public methods
+public:
+    HelpIndex( void ) ;
+    ~HelpIndex( void ) ;
+    bool    addPage( const QString &fileName, const char *html, int length ) ;
+    bool    finish( unsigned int stamp ) ;
+    bool    load( const QString &indexPath, unsigned int stamp ) ;
+    QString pageName( int page ) const ;
+    int     pages( void ) const ;
+    QString pageTitle( int page ) const ;
+    QString resolve( const QString &fileName ) const ;
+    bool    save( const QString &indexPath ) const ;
+    int     search( const QString &query, HelpIndexHit *hits,
+                int maxHits ) const ;
+    QString snippet( const HelpIndexHit &hit, int width=160 ) const ;
+
+// Private methods
+private:
+    int     addTerm( const char *term ) ;
+    int     addWords( const char *text, int length, int page, int weight,
+                bool title ) ;
+    void    clear( void ) ;
+    int     findTerm( const char *term, bool prefix, int *last ) const ;
+    void    setBlock( char *block, int bytes ) ;
+
+// Private data
+private:
+    // The finished index
+    char   *m_block;        //!< Index image as built, loaded, or saved
+    int     m_blockBytes;   //!< Index image size (bytes)
+    int    *m_head;         //!< Header within m_block
+    int    *m_page;         //!< Page table within m_block
+    int    *m_term;         //!< Term table within m_block
+    int    *m_post;         //!< Postings within m_block
+    char   *m_pool;         //!< Character pool within m_block
+    // Build work areas released by finish()
+    char   *m_bPool;        //!< Page names, titles, and text
+    int     m_bPoolBytes;   //!< Bytes used in m_bPool
+    int     m_bPoolSize;    //!< Bytes allocated for m_bPool
+    char   *m_bTerms;       //!< Distinct term strings
+    int     m_bTermsBytes;  //!< Bytes used in m_bTerms
+    int     m_bTermsSize;   //!< Bytes allocated for m_bTerms
+    int    *m_bTermOff;     //!< Offset of each distinct term in m_bTerms
+    int     m_bTermCount;   //!< Number of distinct terms
+    int     m_bTermSize;    //!< Terms allocated for m_bTermOff
+    int    *m_bHash;        //!< Open-addressed term hash (term + 1, or 0)
+    int     m_bHashSize;    //!< Hash table size (a power of 2)
+    int    *m_bPages;       //!< Page table being built
+    int     m_bPageCount;   //!< Number of pages added
+    int     m_bPageSize;    //!< Ints allocated for m_bPages
+    int    *m_bWords;       //!< Word occurrences (term, page, pos, weight)
+    int     m_bWordCount;   //!< Number of word occurrences
+    int     m_bWordSize;    //!< Ints allocated for m_bWords
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of helpindex.h
+//------------------------------------------------------------------------------
+
@@ -0,0 +1,404 @@
+//------------------------------------------------------------------------------
+/*! \file resultcompare.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief ResultCompare class methods.
+ */
+
+// Custom include files
+#include "appmessage.h"
+#include "apptranslator.h"
+#include "fixeddecimal.h"
+#include "resultcompare.h"
+#include "resultset.h"
+
+// Standard include files
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*! \struct ResultCompareKey
+ *  \brief A range variable value and its row or column, for alignment.
+ */
+struct ResultCompareKey
+{
+    double m_value;     //!< Range variable value
+    int    m_index;     //!< Row or column index
+};
+
+//------------------------------------------------------------------------------
+/*! \brief qsort() comparison function for ResultCompareKeys.
+ */
+
+static int compareKeys( const void *p1, const void *p2 )
+{
+    const ResultCompareKey *k1 = (const ResultCompareKey *) p1;
+    const ResultCompareKey *k2 = (const ResultCompareKey *) p2;
+    if ( k1->m_value < k2->m_value )
+    {
+        return( -1 );
+    }
+    return( ( k1->m_value > k2->m_value ) ? 1 : 0 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines if two range variable values are the same value.
+ */
+
+static bool sameKey( double a, double b )
+{
+    double scale = ( fabs( a ) > 1. ) ? fabs( a ) : 1.;
+    return( fabs( a - b ) <= 1.0e-09 * scale );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief ResultCompare constructor.
+ */
+
+ResultCompare::ResultCompare( void ) :
+    m_rows(0),
+    m_cols(0),
+    m_rowA(0),
+    m_rowB(0),
+    m_colA(0),
+    m_colB(0),
+    m_vars(0),
+    m_varA(0),
+    m_varB(0),
+    m_decimals(0),
+    m_diffCells(0),
+    m_maxAbs(0),
+    m_maxRel(0),
+    m_maxCell(0),
+    m_totalDiffs(0),
+    m_boundary(0),
+    m_diffs(0),
+    m_diffCell(0),
+    m_diffVar(0),
+    m_diffA(0),
+    m_diffB(0),
+    m_onlyA(),
+    m_onlyB(),
+    m_units()
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief ResultCompare destructor.
+ */
+
+ResultCompare::~ResultCompare( void )
+{
+    clear();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Aligns two sets of range variable values.
+ *
+ *  \param aVal     Array of first file values.
+ *  \param aCount   Number of first file values.
+ *  \param bVal     Array of second file values.
+ *  \param bCount   Number of second file values.
+ *  \param aIdx     Array to hold the first file index of each aligned value.
+ *  \param bIdx     Array to hold the second file index of each aligned value.
+ *
+ *  \return Number of aligned values (in first file order).
+ */
+
+int ResultCompare::align( const double *aVal, int aCount,
+        const double *bVal, int bCount, int *aIdx, int *bIdx )
+{
+    ResultCompareKey *key = new ResultCompareKey[ bCount ];
+    checkmem( __FILE__, __LINE__, key, "ResultCompareKey key", bCount );
+    int i;
+    for ( i = 0;
+          i < bCount;
+          i++ )
+    {
+        key[i].m_value = bVal[i];
+        key[i].m_index = i;
+    }
+    qsort( key, bCount, sizeof(ResultCompareKey), compareKeys );
+
+    int n = 0;
+    int lo, hi, mid;
+    for ( i = 0;
+          i < aCount;
+          i++ )
+    {
+        // Find the first second file value not less than this one
+        lo = 0;
+        hi = bCount;
+        while ( lo < hi )
+        {
+            mid = ( lo + hi ) / 2;
+            if ( key[mid].m_value < aVal[i] )
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        // Either it or its predecessor may be the same value
+        if ( lo < bCount && sameKey( aVal[i], key[lo].m_value ) )
+        {
+            aIdx[n] = i;
+            bIdx[n++] = key[lo].m_index;
+        }
+        else if ( lo > 0 && sameKey( aVal[i], key[lo-1].m_value ) )
+        {
+            aIdx[n] = i;
+            bIdx[n++] = key[lo-1].m_index;
+        }
+    }
+    delete[] key;
+    return( n );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Releases the results of the last comparison.
+ */
+
+void ResultCompare::clear( void )
+{
+    delete[] m_rowA;        m_rowA = 0;
+    delete[] m_rowB;        m_rowB = 0;
+    delete[] m_colA;        m_colA = 0;
+    delete[] m_colB;        m_colB = 0;
+    delete[] m_varA;        m_varA = 0;
+    delete[] m_varB;        m_varB = 0;
+    delete[] m_decimals;    m_decimals = 0;
+    delete[] m_diffCells;   m_diffCells = 0;
+    delete[] m_maxAbs;      m_maxAbs = 0;
+    delete[] m_maxRel;      m_maxRel = 0;
+    delete[] m_maxCell;     m_maxCell = 0;
+    delete[] m_diffCell;    m_diffCell = 0;
+    delete[] m_diffVar;     m_diffVar = 0;
+    delete[] m_diffA;       m_diffA = 0;
+    delete[] m_diffB;       m_diffB = 0;
+    m_rows = m_cols = m_vars = m_totalDiffs = m_boundary = m_diffs = 0;
+    m_onlyA.clear();
+    m_onlyB.clear();
+    m_units.clear();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Compares two result sets.
+ *
+ *  \param a        Pointer to the first (reference) result set.
+ *  \param b        Pointer to the second result set.
+ *  \param errMsg   Reference to a string to hold any error message.
+ *
+ *  \return TRUE on success, FALSE on error (and \a errMsg is set).
+ */
+
+bool ResultCompare::compare( ResultSet *a, ResultSet *b, QString &errMsg )
+{
+    clear();
+    errMsg = "";
+    // Both tables must be ranged over the same variables
+    if ( a->m_rowVar != b->m_rowVar )
+    {
+        translate( errMsg, "ResultCompare:RowVar", a->m_rowVar, b->m_rowVar );
+        return( false );
+    }
+    if ( a->m_colVar != b->m_colVar )
+    {
+        translate( errMsg, "ResultCompare:ColVar", a->m_colVar, b->m_colVar );
+        return( false );
+    }
+    // ... and in the same units, or their values cannot be aligned
+    if ( a->m_rowUnits != b->m_rowUnits )
+    {
+        translate( errMsg, "ResultCompare:RowUnits", a->m_rowVar,
+            a->m_rowUnits, b->m_rowUnits );
+        return( false );
+    }
+    if ( a->m_colUnits != b->m_colUnits )
+    {
+        translate( errMsg, "ResultCompare:ColUnits", a->m_colVar,
+            a->m_colUnits, b->m_colUnits );
+        return( false );
+    }
+    // Align the rows and columns
+    m_rowA = new int[ a->m_rows ];
+    checkmem( __FILE__, __LINE__, m_rowA, "int m_rowA", a->m_rows );
+    m_rowB = new int[ a->m_rows ];
+    checkmem( __FILE__, __LINE__, m_rowB, "int m_rowB", a->m_rows );
+    m_colA = new int[ a->m_cols ];
+    checkmem( __FILE__, __LINE__, m_colA, "int m_colA", a->m_cols );
+    m_colB = new int[ a->m_cols ];
+    checkmem( __FILE__, __LINE__, m_colB, "int m_colB", a->m_cols );
+    m_rows = align( a->m_row, a->m_rows, b->m_row, b->m_rows, m_rowA, m_rowB );
+    m_cols = align( a->m_col, a->m_cols, b->m_col, b->m_cols, m_colA, m_colB );
+    if ( m_rows == 0 || m_cols == 0 )
+    {
+        translate( errMsg, "ResultCompare:NoCells" );
+        return( false );
+    }
+    // Match the outputs by name
+    m_varA = new int[ a->m_vars ];
+    checkmem( __FILE__, __LINE__, m_varA, "int m_varA", a->m_vars );
+    m_varB = new int[ a->m_vars ];
+    checkmem( __FILE__, __LINE__, m_varB, "int m_varB", a->m_vars );
+    int vid, bid;
+    for ( vid = 0;
+          vid < a->m_vars;
+          vid++ )
+    {
+        if ( ( bid = b->findVar( a->m_varName[vid] ) ) < 0 )
+        {
+            m_onlyA.append( a->m_varName[vid] );
+        }
+        else if ( a->m_varUnits[vid] != b->m_varUnits[bid]
+               || a->m_varDiscrete[vid] != b->m_varDiscrete[bid] )
+        {
+            m_units.append( a->m_varName[vid] );
+        }
+        else
+        {
+            m_varA[m_vars] = vid;
+            m_varB[m_vars++] = bid;
+        }
+    }
+    for ( bid = 0;
+          bid < b->m_vars;
+          bid++ )
+    {
+        if ( a->findVar( b->m_varName[bid] ) < 0 )
+        {
+            m_onlyB.append( b->m_varName[bid] );
+        }
+    }
+    // Per-output display decimals and statistics
+    int n = ( m_vars > 0 ) ? m_vars : 1;
+    m_decimals = new int[ n ];
+    checkmem( __FILE__, __LINE__, m_decimals, "int m_decimals", n );
+    m_diffCells = new int[ n ];
+    checkmem( __FILE__, __LINE__, m_diffCells, "int m_diffCells", n );
+    m_maxAbs = new double[ n ];
+    checkmem( __FILE__, __LINE__, m_maxAbs, "double m_maxAbs", n );
+    m_maxRel = new double[ n ];
+    checkmem( __FILE__, __LINE__, m_maxRel, "double m_maxRel", n );
+    m_maxCell = new int[ n ];
+    checkmem( __FILE__, __LINE__, m_maxCell, "int m_maxCell", n );
+    int v;
+    for ( v = 0;
+          v < m_vars;
+          v++ )
+    {
+        m_decimals[v] = a->m_varDecimals[ m_varA[v] ];
+        m_diffCells[v] = 0;
+        m_maxAbs[v] = 0.;
+        m_maxRel[v] = 0.;
+        m_maxCell[v] = -1;
+    }
+    m_diffCell = new int[ ResultCompareMaxDiffs ];
+    checkmem( __FILE__, __LINE__, m_diffCell, "int m_diffCell",
+        ResultCompareMaxDiffs );
+    m_diffVar = new int[ ResultCompareMaxDiffs ];
+    checkmem( __FILE__, __LINE__, m_diffVar, "int m_diffVar",
+        ResultCompareMaxDiffs );
+    m_diffA = new double[ ResultCompareMaxDiffs ];
+    checkmem( __FILE__, __LINE__, m_diffA, "double m_diffA",
+        ResultCompareMaxDiffs );
+    m_diffB = new double[ ResultCompareMaxDiffs ];
+    checkmem( __FILE__, __LINE__, m_diffB, "double m_diffB",
+        ResultCompareMaxDiffs );
+
+    // Stream the aligned cells in first file order
+    int row, col, cell, cellA, cellB;
+    double va, vb, dev, rel, scale;
+    bool differs;
+    char textA[FixedDecimalBufferSize], textB[FixedDecimalBufferSize];
+    for ( row = 0;
+          row < m_rows;
+          row++ )
+    {
+        for ( col = 0;
+              col < m_cols;
+              col++ )
+        {
+            cell  = row * m_cols + col;
+            cellA = m_rowA[row] * a->m_cols + m_colA[col];
+            cellB = m_rowB[row] * b->m_cols + m_colB[col];
+            for ( v = 0;
+                  v < m_vars;
+                  v++ )
+            {
+                va = a->value( (Q_LLONG) cellA * a->m_vars + m_varA[v] );
+                vb = b->value( (Q_LLONG) cellB * b->m_vars + m_varB[v] );
+                dev = rel = 0.;
+                // NaN is the only value not equal to itself
+                if ( va != va || vb != vb )
+                {
+                    differs = ( va == va || vb == vb );
+                }
+                else if ( a->m_varDiscrete[ m_varA[v] ] )
+                {
+                    differs = ( (int) va != (int) vb );
+                }
+                else
+                {
+                    dev = fabs( va - vb );
+                    rel = ( va != 0. ) ? dev / fabs( va ) : 0.;
+                    // Compare the values as they are displayed
+                    differs = ( dev > 0.
+                        && ( fixedDecimal( textA, va, m_decimals[v] )
+                          != fixedDecimal( textB, vb, m_decimals[v] )
+                          || strcmp( textA, textB ) != 0 ) );
+                    // A last place wobble across a rounding boundary
+                    // isn't a difference
+                    scale = ( fabs( va ) > fabs( vb ) ) ? fabs( va )
+                                                        : fabs( vb );
+                    if ( differs && dev <= ResultCompareRelEpsilon * scale )
+                    {
+                        m_boundary++;
+                        differs = false;
+                    }
+                }
+                if ( ! differs )
+                {
+                    continue;
+                }
+                m_diffCells[v]++;
+                m_totalDiffs++;
+                if ( m_maxCell[v] < 0 || dev > m_maxAbs[v] )
+                {
+                    m_maxAbs[v] = dev;
+                    m_maxCell[v] = cell;
+                }
+                if ( rel > m_maxRel[v] )
+                {
+                    m_maxRel[v] = rel;
+                }
+                if ( m_diffs < ResultCompareMaxDiffs )
+                {
+                    m_diffCell[m_diffs] = cell;
+                    m_diffVar[m_diffs] = v;
+                    m_diffA[m_diffs] = va;
+                    m_diffB[m_diffs] = vb;
+                    m_diffs++;
+                }
+            }
+        }
+    }
+    if ( a->m_readError || b->m_readError )
+    {
+        translate( errMsg, "ResultSet:ReadError",
+            ( a->m_readError ) ? a->m_fileName : b->m_fileName );
+        return( false );
+    }
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+//  End of resultcompare.cpp
+//------------------------------------------------------------------------------
+
@@ -0,0 +1,107 @@
+//------------------------------------------------------------------------------
+/*! \file resultcompare.h
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief ResultCompare class declaration.
+ *
+ *  A ResultCompare compares two ResultSet files output by output.  The
+ *  tables need not have the same shape: rows and columns are aligned by
+ *  their range variable values, and only the rows and columns present in
+ *  both tables are compared.  Outputs are matched by name; outputs found
+ *  in only one file, or with different display units, are listed but not
+ *  compared.  Tables whose row or column variables have different display
+ *  units are not compared at all, since their values cannot be aligned.
+ *
+ *  Two continuous values differ if their text, rounded by fixedDecimal()
+ *  to the output's display decimals in the first file, differs and their
+ *  relative deviation exceeds ResultCompareRelEpsilon.  Values that display
+ *  identically therefore never differ.  Values that display differently
+ *  only because they straddle a rounding boundary by a few units in the
+ *  last place are counted separately as boundary values.  Discrete values
+ *  differ if their items differ.
+ *
+ *  Values are streamed from both files in cell order, so the comparison
+ *  holds only one chunk of each file, the per-output statistics, and the
+ *  first ResultCompareMaxDiffs differences in memory.
+ */
+
+#ifndef _RESULTCOMPARE_H_
+/*! \def _RESULTCOMPARE_H_
+ *  \brief Prevent redundant includes.
+ */
+#define _RESULTCOMPARE_H_ 1
+
+// Class references
+class ResultSet;
+
+// Qt include files
+#include <qstring.h>
+#include <qstringlist.h>
+
+/*! \var ResultCompareMaxDiffs
+ *  \brief Maximum number of differences kept for the differences table.
+ */
+static const int ResultCompareMaxDiffs = 1000;
+
+/*! \var ResultCompareRelEpsilon
+ *  \brief Relative deviation a value must exceed to be counted as a
+ *  difference, rather than as a boundary value, when its displayed text
+ *  differs.
+ */
+static const double ResultCompareRelEpsilon = 1.0e-09;
+
+//------------------------------------------------------------------------------
+/*! \class ResultCompare resultcompare.h
+ *
+ *  \brief Display-precision comparison of two result sets.
+ */
+
+class ResultCompare
+{
+// Public methods
+public:
+    ResultCompare( void ) ;
+    ~ResultCompare( void ) ;
+    void clear( void ) ;
+    bool compare( ResultSet *a, ResultSet *b, QString &errMsg ) ;
+
+// Private methods
+private:
+    int  align( const double *aVal, int aCount, const double *bVal,
+                int bCount, int *aIdx, int *bIdx ) ;
+
+// Public data
+public:
+    int     m_rows;         //!< Number of aligned rows
+    int     m_cols;         //!< Number of aligned columns
+    int    *m_rowA;         //!< First file row of each aligned row
+    int    *m_rowB;         //!< Second file row of each aligned row
+    int    *m_colA;         //!< First file column of each aligned column
+    int    *m_colB;         //!< Second file column of each aligned column
+    int     m_vars;         //!< Number of outputs compared
+    int    *m_varA;         //!< First file output index of each compared output
+    int    *m_varB;         //!< Second file output index of each compared output
+    int    *m_decimals;     //!< Display decimals of each compared output
+    int    *m_diffCells;    //!< Number of differing cells of each output
+    double *m_maxAbs;       //!< Maximum absolute deviation of each output
+    double *m_maxRel;       //!< Maximum relative deviation of each output
+    int    *m_maxCell;      //!< Aligned cell of each output's maximum, or -1
+    int     m_totalDiffs;   //!< Total number of differing values
+    int     m_boundary;     //!< Number of values displayed differently only at a rounding boundary
+    int     m_diffs;        //!< Number of differences kept
+    int    *m_diffCell;     //!< Aligned cell of each kept difference
+    int    *m_diffVar;      //!< Compared output of each kept difference
+    double *m_diffA;        //!< First file value of each kept difference
+    double *m_diffB;        //!< Second file value of each kept difference
+    QStringList m_onlyA;    //!< Outputs found only in the first file
+    QStringList m_onlyB;    //!< Outputs found only in the second file
+    QStringList m_units;    //!< Outputs not compared because units differ
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of resultcompare.h
+//------------------------------------------------------------------------------
+
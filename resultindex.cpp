@@ -0,0 +1,440 @@
+//------------------------------------------------------------------------------
+/*! \file resultindex.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief ResultIndex class methods.
+ */
+
+// Custom include files
+#include "appmessage.h"
+#include "resultindex.h"
+#include "resultstore.h"
+#include "xeqtree.h"
+
+// Standard include files
+#include <stdlib.h>
+#include <string.h>
+
+//------------------------------------------------------------------------------
+/*! \struct ResultIndexEntry
+ *
+ *  \brief A table cell and its output value, as sorted by ResultIndex::sort().
+ */
+
+struct ResultIndexEntry
+{
+    double m_value;     //!< Output value (display units)
+    int    m_cell;      //!< Table cell index
+};
+
+//------------------------------------------------------------------------------
+/*! \brief qsort() comparison function used to sort ResultIndexEntry's by
+ *  value, and equal values by cell, so the order is reproducible.
+ *
+ *  \return  -1, 0, or 1 as required by qsort().
+ */
+
+static int ResultIndex_EntryCompare( const void *s1, const void *s2 )
+{
+    const ResultIndexEntry *e1 = (const ResultIndexEntry *) s1;
+    const ResultIndexEntry *e2 = (const ResultIndexEntry *) s2;
+    if ( e1->m_value < e2->m_value )
+    {
+        return( -1 );
+    }
+    if ( e1->m_value > e2->m_value )
+    {
+        return( 1 );
+    }
+    return( ( e1->m_cell < e2->m_cell ) ? -1 : ( e1->m_cell > e2->m_cell ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief ResultIndex constructor.
+ *
+ *  \param eqTree Pointer to the EqTree whose table results are indexed.
+ */
+
+ResultIndex::ResultIndex( EqTree *eqTree ) :
+    m_sorts(0),
+    m_eqTree(eqTree),
+    m_cells(0),
+    m_vars(0),
+    m_words(0),
+    m_order(0),
+    m_value(0)
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief ResultIndex destructor.
+ *
+ *  All the index storage belongs to the EqTree's RunArena.
+ */
+
+ResultIndex::~ResultIndex( void )
+{
+    clear();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the table cell at a position in an output variable's
+ *  ascending value order.
+ *
+ *  \param vid  Table output variable index.
+ *  \param pos  Sorted position [0..cells()-1].
+ *
+ *  \return Table cell index.
+ */
+
+int ResultIndex::cellAt( int vid, int pos )
+{
+    sort( vid );
+    return( m_order[vid][pos] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the number of cells in the current run's table.
+ *
+ *  \return Number of table cells.
+ */
+
+int ResultIndex::cells( void )
+{
+    init();
+    return( m_cells );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Forgets the indexes.
+ *
+ *  Called by EqTree::runClean() just before the RunArena storage is reset,
+ *  and by EqTree::runOutputs() after it fills in skipped outputs.
+ */
+
+void ResultIndex::clear( void )
+{
+    m_cells = m_vars = m_words = m_sorts = 0;
+    m_order = 0;
+    m_value = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Counts the cells in a bitmap.
+ *
+ *  \param bits Pointer to the bitmap.
+ *
+ *  \return Number of cells in the bitmap.
+ */
+
+int ResultIndex::count( const unsigned int *bits ) const
+{
+    int n = 0;
+    unsigned int word;
+    for ( int w = 0;
+          w < m_words;
+          w++ )
+    {
+        for ( word = bits[w];
+              word;
+              word &= word - 1 )
+        {
+            n++;
+        }
+    }
+    return( n );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Removes from a bitmap all cells whose position in an output
+ *  variable's ascending value order is outside [\a from, \a end).
+ *
+ *  \param bits Pointer to the bitmap.
+ *  \param vid  Table output variable index.
+ *  \param from First sorted position to keep.
+ *  \param end  One past the last sorted position to keep.
+ */
+
+void ResultIndex::filterPos( unsigned int *bits, int vid, int from, int end )
+{
+    if ( ! sort( vid ) )
+    {
+        return;
+    }
+    int w, pos, cell;
+    // Cheaper to mark the cells to keep?
+    if ( end - from <= m_cells / 2 )
+    {
+        unsigned int *keep = new unsigned int[ m_words ];
+        checkmem( __FILE__, __LINE__, keep, "unsigned int keep", m_words );
+        memset( keep, 0, m_words * sizeof(unsigned int) );
+        for ( pos = from;
+              pos < end;
+              pos++ )
+        {
+            cell = m_order[vid][pos];
+            keep[cell >> 5] |= ( 1u << ( cell & 31 ) );
+        }
+        for ( w = 0;
+              w < m_words;
+              w++ )
+        {
+            bits[w] &= keep[w];
+        }
+        delete[] keep;
+        return;
+    }
+    // Otherwise clear the cells outside the range.
+    for ( pos = 0;
+          pos < m_cells;
+          pos++ )
+    {
+        if ( pos == from )
+        {
+            pos = end - 1;
+            continue;
+        }
+        cell = m_order[vid][pos];
+        bits[cell >> 5] &= ~( 1u << ( cell & 31 ) );
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Removes from a bitmap all cells whose results are not within the
+ *  prescription.
+ *
+ *  \param bits Pointer to the bitmap.
+ */
+
+void ResultIndex::filterRx( unsigned int *bits )
+{
+    if ( ! init() || ! m_eqTree->m_tableInRx )
+    {
+        return;
+    }
+    // Both bitmaps have the same cell-major layout, so combine them a word
+    // at a time.
+    for ( int w = 0;
+          w < m_words;
+          w++ )
+    {
+        bits[w] &= m_eqTree->m_tableInRx[w];
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Prepares the index for the current run's table.
+ *
+ *  \return TRUE if the table has any cells.
+ */
+
+bool ResultIndex::init( void )
+{
+    if ( m_cells )
+    {
+        return( true );
+    }
+    m_cells = m_eqTree->m_tableRows * m_eqTree->m_tableCols;
+    m_vars  = m_eqTree->m_tableVars;
+    if ( m_cells <= 0 || m_vars <= 0 || ! m_eqTree->m_tableVal )
+    {
+        m_cells = 0;
+        return( false );
+    }
+    m_words = ( m_cells + 31 ) / 32;
+    m_order = (int **) m_eqTree->runAlloc( m_vars * sizeof(int *) );
+    m_value = (double **) m_eqTree->runAlloc( m_vars * sizeof(double *) );
+    for ( int vid = 0;
+          vid < m_vars;
+          vid++ )
+    {
+        m_order[vid] = 0;
+        m_value[vid] = 0;
+    }
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines if a cell is in a bitmap.
+ *
+ *  \param bits Pointer to the bitmap.
+ *  \param cell Table cell index.
+ *
+ *  \return TRUE if the cell is in the bitmap.
+ */
+
+bool ResultIndex::isSet( const unsigned int *bits, int cell )
+{
+    return( ( bits[cell >> 5] & ( 1u << ( cell & 31 ) ) ) != 0 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Finds the first position in an output variable's ascending value
+ *  order whose value is not less than \a value.
+ *
+ *  \param vid      Table output variable index.
+ *  \param value    Value (display units).
+ *
+ *  \return Sorted position [0..cells()].
+ */
+
+int ResultIndex::lowerBound( int vid, double value )
+{
+    if ( ! sort( vid ) )
+    {
+        return( 0 );
+    }
+    int lo = 0;
+    int hi = m_cells;
+    int mid;
+    while ( lo < hi )
+    {
+        mid = ( lo + hi ) / 2;
+        if ( m_value[vid][mid] < value )
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return( lo );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Creates a new bitmap holding either all or none of the cells.
+ *
+ *  The bitmap belongs to the EqTree's RunArena.
+ *
+ *  \param set  If TRUE, the bitmap holds every cell.
+ *
+ *  \return Pointer to the bitmap, or 0 if there are no table results.
+ */
+
+unsigned int *ResultIndex::newBits( bool set )
+{
+    if ( ! init() )
+    {
+        return( 0 );
+    }
+    unsigned int *bits = (unsigned int *)
+        m_eqTree->runAlloc( m_words * sizeof(unsigned int) );
+    memset( bits, ( set ) ? 0xff : 0, m_words * sizeof(unsigned int) );
+    // Unused bits of the last word are never set.
+    if ( set && ( m_cells & 31 ) )
+    {
+        bits[m_words-1] = ( 1u << ( m_cells & 31 ) ) - 1;
+    }
+    return( bits );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sorts an output variable's cells by value, unless it is already
+ *  sorted for this run.
+ *
+ *  Discrete outputs are sorted by their item index.
+ *
+ *  \param vid  Table output variable index.
+ *
+ *  \return TRUE if the output is sorted.
+ */
+
+bool ResultIndex::sort( int vid )
+{
+    if ( ! init() || vid < 0 || vid >= m_vars )
+    {
+        return( false );
+    }
+    if ( m_order[vid] )
+    {
+        return( true );
+    }
+    ResultIndexEntry *entry = new ResultIndexEntry[ m_cells ];
+    checkmem( __FILE__, __LINE__, entry, "ResultIndexEntry entry", m_cells );
+    int cell;
+    Q_LLONG id;
+    for ( cell = 0, id = vid;
+          cell < m_cells;
+          cell++, id += m_vars )
+    {
+        entry[cell].m_value = m_eqTree->m_tableVal->get( id );
+        entry[cell].m_cell = cell;
+    }
+    qsort( entry, m_cells, sizeof(ResultIndexEntry), ResultIndex_EntryCompare );
+    m_order[vid] = (int *)
+        m_eqTree->runAlloc( (Q_LLONG) m_cells * sizeof(int) );
+    m_value[vid] = (double *)
+        m_eqTree->runAlloc( (Q_LLONG) m_cells * sizeof(double) );
+    for ( cell = 0;
+          cell < m_cells;
+          cell++ )
+    {
+        m_order[vid][cell] = entry[cell].m_cell;
+        m_value[vid][cell] = entry[cell].m_value;
+    }
+    delete[] entry;
+    m_sorts++;
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Finds the first position in an output variable's ascending value
+ *  order whose value is greater than \a value.
+ *
+ *  \param vid      Table output variable index.
+ *  \param value    Value (display units).
+ *
+ *  \return Sorted position [0..cells()].
+ */
+
+int ResultIndex::upperBound( int vid, double value )
+{
+    if ( ! sort( vid ) )
+    {
+        return( 0 );
+    }
+    int lo = 0;
+    int hi = m_cells;
+    int mid;
+    while ( lo < hi )
+    {
+        mid = ( lo + hi ) / 2;
+        if ( m_value[vid][mid] <= value )
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return( lo );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the value at a position in an output variable's
+ *  ascending value order.
+ *
+ *  \param vid  Table output variable index.
+ *  \param pos  Sorted position [0..cells()-1].
+ *
+ *  \return Output value (display units).
+ */
+
+double ResultIndex::valueAt( int vid, int pos )
+{
+    sort( vid );
+    return( m_value[vid][pos] );
+}
+
+//------------------------------------------------------------------------------
+//  End of resultindex.cpp
+//------------------------------------------------------------------------------
+
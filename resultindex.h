@@ -0,0 +1,83 @@
+//------------------------------------------------------------------------------
+/*! \file resultindex.h
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief ResultIndex class declaration.
+ *
+ *  A ResultIndex answers questions about the current run's table results
+ *  (which cells have the highest flame length, which cells have a spread
+ *  rate within some range, which cells are nearest some fireline intensity)
+ *  without sweeping the ResultStore for each question.
+ *
+ *  Each output variable's cells are sorted by value the first time a query
+ *  needs them, and the sorted index is shared by every later query until
+ *  the run is cleaned up, so range limits and nearest values are found by
+ *  binary search and highest and lowest values are read off either end.
+ *  Cell sets are kept as bitmaps (one bit per table cell), so combining
+ *  several conditions and the prescription shading costs a few machine
+ *  words per thousand cells.
+ *
+ *  All the index storage comes from the EqTree's RunArena, so it lives
+ *  exactly as long as the results it indexes.
+ */
+
+#ifndef _RESULTINDEX_H_
+/*! \def _RESULTINDEX_H_
+ *  \brief Prevent redundant includes.
+ */
+#define _RESULTINDEX_H_ 1
+
+// Class references
+class EqTree;
+
+//------------------------------------------------------------------------------
+/*! \class ResultIndex resultindex.h
+ *
+ *  \brief Lazily sorted per-output indexes and cell bitmaps over the
+ *  current run's table results.
+ */
+
+class ResultIndex
+{
+// Public methods
+public:
+    ResultIndex( EqTree *eqTree ) ;
+    ~ResultIndex( void ) ;
+    void    clear( void ) ;
+    int     cellAt( int vid, int pos ) ;
+    int     cells( void ) ;
+    int     count( const unsigned int *bits ) const ;
+    void    filterPos( unsigned int *bits, int vid, int from, int end ) ;
+    void    filterRx( unsigned int *bits ) ;
+    int     lowerBound( int vid, double value ) ;
+    unsigned int *newBits( bool set ) ;
+    int     upperBound( int vid, double value ) ;
+    double  valueAt( int vid, int pos ) ;
+    static bool isSet( const unsigned int *bits, int cell ) ;
+
+// Private methods
+private:
+    bool    init( void ) ;
+    bool    sort( int vid ) ;
+
+// Public data
+public:
+    int     m_sorts;        //!< Output indexes sorted this run
+
+// Private data
+private:
+    EqTree  *m_eqTree;      //!< Pointer to the EqTree whose results are indexed
+    int      m_cells;       //!< Number of table cells, or 0 if uninitialized
+    int      m_vars;        //!< Number of table output variables
+    int      m_words;       //!< Number of words in each cell bitmap
+    int    **m_order;       //!< Each output's cells in ascending value order
+    double **m_value;       //!< Each output's values in ascending order
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of resultindex.h
+//------------------------------------------------------------------------------
+
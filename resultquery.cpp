@@ -0,0 +1,427 @@
+//------------------------------------------------------------------------------
+/*! \file resultquery.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief ResultQuery class methods.
+ */
+
+// Custom include files
+#include "appmessage.h"
+#include "apptranslator.h"
+#include "resultindex.h"
+#include "resultquery.h"
+#include "xeqtree.h"
+#include "xeqvar.h"
+#include "xeqvaritem.h"
+
+// Qt include files
+#include <qstringlist.h>
+
+// Standard include files
+#include <math.h>
+
+//------------------------------------------------------------------------------
+/*! \brief Splits query text into white space delimited tokens, keeping
+ *  double quoted text (without its quotes) as a single token.
+ *
+ *  \param text     Query text.
+ *  \param tokens   Reference to the list to hold the tokens.
+ */
+
+static void queryTokens( const QString &text, QStringList &tokens )
+{
+    tokens.clear();
+    QString token("");
+    bool quoted = false;
+    bool inToken = false;
+    for ( unsigned int i = 0;
+          i <= text.length();
+          i++ )
+    {
+        QChar ch = ( i < text.length() ) ? text[i] : QChar( ' ' );
+        if ( ch == '"' )
+        {
+            quoted = ! quoted;
+            inToken = true;
+        }
+        else if ( quoted || ! ch.isSpace() )
+        {
+            token += ch;
+            inToken = true;
+        }
+        else if ( inToken )
+        {
+            tokens.append( token );
+            token = "";
+            inToken = false;
+        }
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief ResultQuery constructor.
+ */
+
+ResultQuery::ResultQuery( void ) :
+    m_text(""),
+    m_rx(false),
+    m_terms(0),
+    m_order(QueryCellOrder),
+    m_orderVid(-1),
+    m_target(0.),
+    m_limit(0),
+    m_matches(0),
+    m_cells(0),
+    m_cell(0),
+    m_eqTree(0)
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief ResultQuery destructor.
+ */
+
+ResultQuery::~ResultQuery( void )
+{
+    delete[] m_cell;    m_cell = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Finds the table output variable with the name or label \a token
+ *  (without regard to case).
+ *
+ *  \return Table output variable index, or -1 if not found.
+ */
+
+int ResultQuery::findVar( const QString &token ) const
+{
+    QString name = token.lower();
+    EqVar *varPtr;
+    for ( int vid = 0;
+          vid < m_eqTree->m_tableVars;
+          vid++ )
+    {
+        varPtr = m_eqTree->m_tableVar[vid];
+        if ( varPtr->m_name.lower() == name
+          || varPtr->m_label->lower() == name )
+        {
+            return( vid );
+        }
+    }
+    return( -1 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Parses the query text.
+ *
+ *  \param text     Query text.
+ *  \param eqTree   Pointer to the EqTree whose table outputs are queried
+ *                  (its table output variables must already be set).
+ *  \param errMsg   Reference to a string to hold any error message.
+ *
+ *  \return TRUE on success, FALSE on error (and \a errMsg is set).
+ */
+
+bool ResultQuery::parse( const QString &text, EqTree *eqTree,
+        QString &errMsg )
+{
+    m_text = text.simplifyWhiteSpace();
+    m_eqTree = eqTree;
+    m_rx = false;
+    m_terms = 0;
+    m_order = QueryCellOrder;
+    m_orderVid = -1;
+    m_target = 0.;
+    m_limit = 0;
+    errMsg = "";
+
+    QStringList tokens;
+    queryTokens( m_text, tokens );
+    QStringList::Iterator it = tokens.begin();
+    QString token(""), key(""), bad("");
+    int vid;
+    bool ok;
+    while ( it != tokens.end() && bad.isEmpty() )
+    {
+        token = *it;
+        key = token.lower();
+        ++it;
+        if ( key == "and" )
+        {
+            continue;
+        }
+        else if ( key == "rx" )
+        {
+            m_rx = true;
+        }
+        // Ordering terms
+        else if ( key == "highest" || key == "lowest" || key == "nearest" )
+        {
+            if ( m_orderVid >= 0 || it == tokens.end() )
+            {
+                bad = token;
+                continue;
+            }
+            if ( ( m_orderVid = findVar( *it ) ) < 0 )
+            {
+                translate( errMsg, "ResultQuery:NoVar", *it, m_text );
+                return( false );
+            }
+            ++it;
+            if ( key == "highest" )
+            {
+                m_order = QueryHighest;
+            }
+            else if ( key == "lowest" )
+            {
+                m_order = QueryLowest;
+            }
+            else
+            {
+                m_order = QueryNearest;
+                if ( it == tokens.end()
+                  || ! parseValue( m_orderVid, *it, &m_target ) )
+                {
+                    bad = token;
+                    continue;
+                }
+                ++it;
+            }
+            // Optional cell count
+            if ( it != tokens.end() )
+            {
+                int n = (*it).toInt( &ok );
+                if ( ok )
+                {
+                    if ( n <= 0 )
+                    {
+                        bad = *it;
+                        continue;
+                    }
+                    m_limit = n;
+                    ++it;
+                }
+            }
+        }
+        // Comparison terms
+        else
+        {
+            if ( ( vid = findVar( token ) ) < 0 )
+            {
+                translate( errMsg, "ResultQuery:NoVar", token, m_text );
+                return( false );
+            }
+            if ( m_terms >= ResultQueryMaxTerms )
+            {
+                translate( errMsg, "ResultQuery:TooManyTerms", m_text,
+                    QString( "%1" ).arg( ResultQueryMaxTerms ) );
+                return( false );
+            }
+            if ( it == tokens.end() )
+            {
+                bad = token;
+                continue;
+            }
+            key = *it;
+            ++it;
+            if ( ( key != "<" && key != "<=" && key != ">" && key != ">="
+                && key != "=" )
+              || it == tokens.end()
+              || ! parseValue( vid, *it, &m_termValue[m_terms] ) )
+            {
+                bad = key;
+                continue;
+            }
+            ++it;
+            m_termVid[m_terms] = vid;
+            m_termOp[m_terms] = key;
+            m_terms++;
+        }
+    }
+    if ( ! bad.isEmpty() )
+    {
+        translate( errMsg, "ResultQuery:Syntax", bad, m_text );
+        return( false );
+    }
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Parses a value for a table output variable.
+ *
+ *  Continuous values are numbers in display units.  Discrete values are
+ *  item names, and are stored as the item index plus one half, just as the
+ *  table results are.
+ *
+ *  \return TRUE on success, FALSE if \a token is not a valid value.
+ */
+
+bool ResultQuery::parseValue( int vid, const QString &token,
+        double *value ) const
+{
+    EqVar *varPtr = m_eqTree->m_tableVar[vid];
+    if ( varPtr->isDiscrete() )
+    {
+        int iid = varPtr->m_itemList->itemIdWithName( token, false );
+        *value = 0.5 + (double) iid;
+        return( iid >= 0 );
+    }
+    bool ok;
+    *value = token.toDouble( &ok );
+    return( ok );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Selects and orders the cells of the current run's table.
+ *
+ *  The selected cells (no more than m_limit, if it is set, and never more
+ *  than ResultQueryMaxCells) are stored in m_cell[], and the total number
+ *  of cells selected by the query is stored in m_matches.
+ *
+ *  \param index Pointer to the ResultIndex over the current run's table.
+ *
+ *  \return Number of cells stored in m_cell[].
+ */
+
+int ResultQuery::run( ResultIndex *index )
+{
+    delete[] m_cell;    m_cell = 0;
+    m_matches = m_cells = 0;
+    unsigned int *bits = index->newBits( true );
+    if ( ! bits )
+    {
+        return( 0 );
+    }
+    int cells = index->cells();
+
+    // Apply each selection term to the bitmap.
+    if ( m_rx )
+    {
+        index->filterRx( bits );
+    }
+    int term, vid, from, end;
+    double value, half;
+    for ( term = 0;
+          term < m_terms;
+          term++ )
+    {
+        vid = m_termVid[term];
+        value = m_termValue[term];
+        from = 0;
+        end = cells;
+        if ( m_termOp[term] == "<" )
+        {
+            end = index->lowerBound( vid, value );
+        }
+        else if ( m_termOp[term] == "<=" )
+        {
+            end = index->upperBound( vid, value );
+        }
+        else if ( m_termOp[term] == ">" )
+        {
+            from = index->upperBound( vid, value );
+        }
+        else if ( m_termOp[term] == ">=" )
+        {
+            from = index->lowerBound( vid, value );
+        }
+        else
+        {
+            // Values that display as value (or discrete item index matches)
+            EqVar *varPtr = m_eqTree->m_tableVar[vid];
+            half = ( varPtr->isDiscrete() )
+                 ? 0.5
+                 : 0.5 * pow( 10., -varPtr->m_displayDecimals );
+            from = index->lowerBound( vid, value - half );
+            end = index->lowerBound( vid, value + half );
+        }
+        index->filterPos( bits, vid, from, end );
+    }
+    m_matches = index->count( bits );
+
+    // Collect the selected cells in the requested order.
+    int max = m_matches;
+    if ( m_limit > 0 && m_limit < max )
+    {
+        max = m_limit;
+    }
+    if ( max > ResultQueryMaxCells )
+    {
+        max = ResultQueryMaxCells;
+    }
+    m_cell = new int[ max + 1 ];
+    checkmem( __FILE__, __LINE__, m_cell, "int m_cell", max + 1 );
+    int pos, cell;
+    if ( m_order == QueryHighest )
+    {
+        for ( pos = cells - 1;
+              pos >= 0 && m_cells < max;
+              pos-- )
+        {
+            if ( ResultIndex::isSet( bits,
+                    ( cell = index->cellAt( m_orderVid, pos ) ) ) )
+            {
+                m_cell[m_cells++] = cell;
+            }
+        }
+    }
+    else if ( m_order == QueryLowest )
+    {
+        for ( pos = 0;
+              pos < cells && m_cells < max;
+              pos++ )
+        {
+            if ( ResultIndex::isSet( bits,
+                    ( cell = index->cellAt( m_orderVid, pos ) ) ) )
+            {
+                m_cell[m_cells++] = cell;
+            }
+        }
+    }
+    else if ( m_order == QueryNearest )
+    {
+        // Walk outwards from the target, taking the closer side first.
+        int hi = index->lowerBound( m_orderVid, m_target );
+        int lo = hi - 1;
+        while ( m_cells < max && ( lo >= 0 || hi < cells ) )
+        {
+            if ( hi >= cells
+              || ( lo >= 0 && m_target - index->valueAt( m_orderVid, lo )
+                    <= index->valueAt( m_orderVid, hi ) - m_target ) )
+            {
+                pos = lo--;
+            }
+            else
+            {
+                pos = hi++;
+            }
+            if ( ResultIndex::isSet( bits,
+                    ( cell = index->cellAt( m_orderVid, pos ) ) ) )
+            {
+                m_cell[m_cells++] = cell;
+            }
+        }
+    }
+    else
+    {
+        for ( cell = 0;
+              cell < cells && m_cells < max;
+              cell++ )
+        {
+            if ( ResultIndex::isSet( bits, cell ) )
+            {
+                m_cell[m_cells++] = cell;
+            }
+        }
+    }
+    return( m_cells );
+}
+
+//------------------------------------------------------------------------------
+//  End of resultquery.cpp
+//------------------------------------------------------------------------------
+
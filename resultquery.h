@@ -0,0 +1,110 @@
+//------------------------------------------------------------------------------
+/*! \file resultquery.h
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief ResultQuery class declaration.
+ *
+ *  A ResultQuery selects and orders the cells of the current run's table
+ *  using a ResultIndex.  Queries are written as white space delimited
+ *  terms, optionally joined by \c and:
+ *  - \c rx selects only cells within the prescription,
+ *  - <tt>var op value</tt> selects cells whose output \c var compares
+ *    to \c value (display units) by \c op, one of \c <, \c <=, \c >,
+ *    \c >=, or \c =, where \c = selects values that display as \c value
+ *    (or a discrete output's item name),
+ *  - <tt>highest var [n]</tt> or <tt>lowest var [n]</tt> orders the
+ *    selected cells by output \c var and keeps the first \c n, and
+ *  - <tt>nearest var value [n]</tt> orders the selected cells by the
+ *    distance of output \c var from \c value and keeps the first \c n.
+ *
+ *  Each \c var is a table output variable name or its label (which may be
+ *  enclosed in double quotes).  For example,
+ *  \code
+ *  highest vSurfaceFireFlameLengAtHead 20
+ *  vSurfaceFireSpreadAtHead > 30 and rx
+ *  nearest "Fireline Intensity" 500 10
+ *  \endcode
+ */
+
+#ifndef _RESULTQUERY_H_
+/*! \def _RESULTQUERY_H_
+ *  \brief Prevent redundant includes.
+ */
+#define _RESULTQUERY_H_ 1
+
+// Class references
+class EqTree;
+class ResultIndex;
+
+// Qt include files
+#include <qstring.h>
+
+/*! \enum ResultQueryOrder
+ *  \brief Order in which a ResultQuery returns the selected cells.
+ */
+enum ResultQueryOrder
+{
+    QueryCellOrder=0,   //!< Table order
+    QueryHighest=1,     //!< Descending value of the order variable
+    QueryLowest=2,      //!< Ascending value of the order variable
+    QueryNearest=3      //!< Ascending distance from the target value
+};
+
+/*! \var ResultQueryMaxTerms
+ *  \brief Maximum number of comparison terms in a query.
+ */
+static const int ResultQueryMaxTerms = 16;
+
+/*! \var ResultQueryMaxCells
+ *  \brief Maximum number of cells returned by a query.
+ */
+static const int ResultQueryMaxCells = 5000;
+
+//------------------------------------------------------------------------------
+/*! \class ResultQuery resultquery.h
+ *
+ *  \brief Selects and orders the current run's table cells.
+ */
+
+class ResultQuery
+{
+// Public methods
+public:
+    ResultQuery( void ) ;
+    ~ResultQuery( void ) ;
+    bool parse( const QString &text, EqTree *eqTree, QString &errMsg ) ;
+    int  run( ResultIndex *index ) ;
+
+// Private methods
+private:
+    int  findVar( const QString &token ) const ;
+    bool parseValue( int vid, const QString &token, double *value ) const ;
+
+// Public data
+public:
+    QString m_text;         //!< Query text
+    bool    m_rx;           //!< TRUE if only cells in prescription are selected
+    int     m_terms;        //!< Number of comparison terms
+    int     m_termVid[ResultQueryMaxTerms];     //!< Term output variable
+    QString m_termOp[ResultQueryMaxTerms];      //!< Term comparison operator
+    double  m_termValue[ResultQueryMaxTerms];   //!< Term value (display units)
+    ResultQueryOrder m_order;   //!< Order of the returned cells
+    int     m_orderVid;     //!< Order output variable, or -1
+    double  m_target;       //!< Target value of a QueryNearest order
+    int     m_limit;        //!< Number of cells requested, or 0 for all
+    int     m_matches;      //!< Number of cells selected by the last run()
+    int     m_cells;        //!< Number of cells returned by the last run()
+    int    *m_cell;         //!< Cells returned by the last run(), in order
+
+// Private data
+private:
+    EqTree *m_eqTree;       //!< EqTree whose table outputs are queried
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of resultquery.h
+//------------------------------------------------------------------------------
+
@@ -0,0 +1,422 @@
+//------------------------------------------------------------------------------
+/*! \file resultset.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief ResultSet class methods.
+ */
+
+// Result sets may exceed 2 GB, so 32-bit POSIX builds need 64-bit offsets.
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+
+// Custom include files
+#include "appmessage.h"
+#include "apptranslator.h"
+#include "resultset.h"
+#include "resultstore.h"
+#include "xeqtree.h"
+#include "xeqvar.h"
+
+// Qt include files
+#include <qstringlist.h>
+
+/*! \var ResultSetMagic
+ *  \brief First line of every result set file.
+ */
+static const char ResultSetMagic[] = "BehavePlus5 Result Set 1";
+
+//------------------------------------------------------------------------------
+/*! \brief Positions a result set file using a 64-bit offset.
+ *
+ *  \param fptr   Result set file.
+ *  \param offset File offset (bytes from \a whence).
+ *  \param whence SEEK_SET or SEEK_END.
+ *
+ *  \return TRUE on success, FALSE if the seek failed.
+ */
+
+static bool resultSetSeek( FILE *fptr, Q_LLONG offset, int whence )
+{
+#if defined(_MSC_VER)
+    return( _fseeki64( fptr, offset, whence ) == 0 );
+#elif defined(__MINGW32__)
+    return( fseeko64( fptr, offset, whence ) == 0 );
+#else
+    return( fseeko( fptr, (off_t) offset, whence ) == 0 );
+#endif
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gets a result set file's current 64-bit position.
+ *
+ *  \param fptr Result set file.
+ *
+ *  \return File offset, or -1 on error.
+ */
+
+static Q_LLONG resultSetTell( FILE *fptr )
+{
+#if defined(_MSC_VER)
+    return( (Q_LLONG) _ftelli64( fptr ) );
+#elif defined(__MINGW32__)
+    return( (Q_LLONG) ftello64( fptr ) );
+#else
+    return( (Q_LLONG) ftello( fptr ) );
+#endif
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines a variable's units as written to a result set header.
+ *
+ *  \return The display units, or "-" if there are none.
+ */
+
+static QString resultSetUnits( EqVar *varPtr )
+{
+    if ( ! varPtr
+      || ! varPtr->isContinuous()
+      || varPtr->m_displayUnits.isEmpty() )
+    {
+        return( QString( "-" ) );
+    }
+    return( varPtr->m_displayUnits );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief ResultSet constructor.
+ */
+
+ResultSet::ResultSet( void ) :
+    m_fileName(""),
+    m_rows(0),
+    m_cols(0),
+    m_vars(0),
+    m_rowVar(""),
+    m_colVar(""),
+    m_rowUnits(""),
+    m_colUnits(""),
+    m_row(0),
+    m_col(0),
+    m_varName(0),
+    m_varUnits(0),
+    m_varDecimals(0),
+    m_varDiscrete(0),
+    m_readError(false),
+    m_fptr(0),
+    m_dataOffset(0),
+    m_values(0),
+    m_chunk(0),
+    m_chunkId(-1)
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief ResultSet destructor.
+ */
+
+ResultSet::~ResultSet( void )
+{
+    close();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Closes the result set file and releases its header data.
+ */
+
+void ResultSet::close( void )
+{
+    if ( m_fptr )
+    {
+        fclose( m_fptr );
+        m_fptr = 0;
+    }
+    delete[] m_row;         m_row = 0;
+    delete[] m_col;         m_col = 0;
+    delete[] m_varName;     m_varName = 0;
+    delete[] m_varUnits;    m_varUnits = 0;
+    delete[] m_varDecimals; m_varDecimals = 0;
+    delete[] m_varDiscrete; m_varDiscrete = 0;
+    delete[] m_chunk;       m_chunk = 0;
+    m_rows = m_cols = m_vars = m_values = 0;
+    m_rowVar = m_colVar = m_rowUnits = m_colUnits = "";
+    m_chunkId = -1;
+    m_readError = false;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Finds an output variable by name.
+ *
+ *  \return Output variable index, or -1 if not found.
+ */
+
+int ResultSet::findVar( const QString &name ) const
+{
+    for ( int vid = 0;
+          vid < m_vars;
+          vid++ )
+    {
+        if ( m_varName[vid] == name )
+        {
+            return( vid );
+        }
+    }
+    return( -1 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Opens a result set file and reads its header, row values, and
+ *  column values.  The output values are read on demand by value().
+ *
+ *  \param fileName Name of the result set file.
+ *  \param errMsg   Reference to a string to hold any error message.
+ *
+ *  \return TRUE on success, FALSE on error (and \a errMsg is set).
+ */
+
+bool ResultSet::open( const QString &fileName, QString &errMsg )
+{
+    close();
+    errMsg = "";
+    m_fileName = fileName;
+    if ( ! ( m_fptr = fopen( fileName.latin1(), "rb" ) ) )
+    {
+        translate( errMsg, "ResultSet:NoOpen", fileName );
+        return( false );
+    }
+    // Read the text header
+    char buffer[1024];
+    QString line("");
+    QStringList tokens;
+    bool ok = ( fgets( buffer, sizeof(buffer), m_fptr ) != 0 )
+           && QString( buffer ).stripWhiteSpace() == ResultSetMagic
+           && fgets( buffer, sizeof(buffer), m_fptr ) != 0
+           && sscanf( buffer, "%d %d %d", &m_rows, &m_cols, &m_vars ) == 3
+           && m_rows > 0 && m_cols > 0 && m_vars > 0;
+    if ( ok )
+    {
+        m_row = new double[ m_rows ];
+        checkmem( __FILE__, __LINE__, m_row, "double m_row", m_rows );
+        m_col = new double[ m_cols ];
+        checkmem( __FILE__, __LINE__, m_col, "double m_col", m_cols );
+        m_varName = new QString[ m_vars ];
+        checkmem( __FILE__, __LINE__, m_varName, "QString m_varName", m_vars );
+        m_varUnits = new QString[ m_vars ];
+        checkmem( __FILE__, __LINE__, m_varUnits, "QString m_varUnits",
+            m_vars );
+        m_varDecimals = new int[ m_vars ];
+        checkmem( __FILE__, __LINE__, m_varDecimals, "int m_varDecimals",
+            m_vars );
+        m_varDiscrete = new bool[ m_vars ];
+        checkmem( __FILE__, __LINE__, m_varDiscrete, "bool m_varDiscrete",
+            m_vars );
+    }
+    // The row, column, and output variable lines
+    int vid;
+    for ( vid = -2;
+          ok && vid < m_vars;
+          vid++ )
+    {
+        ok = ( fgets( buffer, sizeof(buffer), m_fptr ) != 0 );
+        line = QString( buffer ).simplifyWhiteSpace();
+        tokens = QStringList::split( ' ', line );
+        if ( ! ok )
+        {
+            break;
+        }
+        if ( vid == -2 )
+        {
+            ok = ( tokens.count() >= 3 && tokens[0] == "row" );
+            m_rowVar = ok ? tokens[1] : QString( "" );
+            m_rowUnits = ok ? line.section( ' ', 2 ) : QString( "" );
+        }
+        else if ( vid == -1 )
+        {
+            ok = ( tokens.count() >= 3 && tokens[0] == "col" );
+            m_colVar = ok ? tokens[1] : QString( "" );
+            m_colUnits = ok ? line.section( ' ', 2 ) : QString( "" );
+        }
+        else
+        {
+            ok = ( tokens.count() >= 5 && tokens[0] == "var" );
+            if ( ok )
+            {
+                m_varName[vid] = tokens[1];
+                m_varDiscrete[vid] = ( tokens[2] == "disc" );
+                m_varDecimals[vid] = tokens[3].toInt( &ok );
+                m_varUnits[vid] = line.section( ' ', 4 );
+            }
+        }
+    }
+    ok = ok
+      && fgets( buffer, sizeof(buffer), m_fptr ) != 0
+      && QString( buffer ).stripWhiteSpace() == "data"
+      && (int) fread( m_row, sizeof(double), m_rows, m_fptr ) == m_rows
+      && (int) fread( m_col, sizeof(double), m_cols, m_fptr ) == m_cols;
+    // Make sure all the output values are there
+    if ( ok )
+    {
+        m_dataOffset = resultSetTell( m_fptr );
+        m_values = (Q_LLONG) m_rows * m_cols * m_vars;
+        ok = ( m_dataOffset >= 0
+            && resultSetSeek( m_fptr, 0, SEEK_END )
+            && resultSetTell( m_fptr ) - m_dataOffset
+               >= m_values * (Q_LLONG) sizeof(double) );
+    }
+    if ( ! ok )
+    {
+        translate( errMsg, "ResultSet:BadFile", fileName );
+        close();
+        return( false );
+    }
+    m_chunk = new double[ ResultStoreChunkValues ];
+    checkmem( __FILE__, __LINE__, m_chunk, "double m_chunk",
+        ResultStoreChunkValues );
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to an output value.
+ *
+ *  Values are read a chunk at a time, so reading them in order costs one
+ *  sequential read per ResultStoreChunkValues values.
+ *
+ *  \param id   Value index (cell * m_vars + variable).
+ *
+ *  \return Output value (display units, or item index plus one half for
+ *  discrete variables).
+ */
+
+double ResultSet::value( Q_LLONG id )
+{
+    int chunkId = (int) ( id >> ResultStoreChunkShift );
+    if ( chunkId != m_chunkId )
+    {
+        Q_LLONG first = (Q_LLONG) chunkId << ResultStoreChunkShift;
+        int n = ( m_values - first < ResultStoreChunkValues )
+              ? (int) ( m_values - first )
+              : ResultStoreChunkValues;
+        if ( ! resultSetSeek( m_fptr,
+                m_dataOffset + first * (Q_LLONG) sizeof(double), SEEK_SET )
+          || (int) fread( m_chunk, sizeof(double), n, m_fptr ) != n )
+        {
+            m_readError = true;
+            for ( int i = 0;
+                  i < n;
+                  i++ )
+            {
+                m_chunk[i] = 0.;
+            }
+        }
+        m_chunkId = chunkId;
+    }
+    return( m_chunk[ (int) id & ( ResultStoreChunkValues - 1 ) ] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Writes the EqTree's current table results to a result set file.
+ *
+ *  \param eqTree   Pointer to the EqTree whose results are written.
+ *  \param fileName Name of the result set file.
+ *  \param errMsg   Reference to a string to hold any error message.
+ *
+ *  \return TRUE on success, FALSE on error (and \a errMsg is set).
+ */
+
+bool ResultSet::write( EqTree *eqTree, const QString &fileName,
+        QString &errMsg )
+{
+    errMsg = "";
+    int rows = eqTree->m_tableRows;
+    int cols = eqTree->m_tableCols;
+    int vars = eqTree->m_tableVars;
+    if ( rows <= 0 || cols <= 0 || vars <= 0 || ! eqTree->m_tableVal )
+    {
+        translate( errMsg, "ResultSet:NoResults", fileName );
+        return( false );
+    }
+    FILE *fptr = fopen( fileName.latin1(), "wb" );
+    if ( ! fptr )
+    {
+        translate( errMsg, "ResultSet:NoOpen", fileName );
+        return( false );
+    }
+    // Write the text header
+    EqVar *rowVar = ( eqTree->m_rangeVars > 0 ) ? eqTree->m_rangeVar[0] : 0;
+    EqVar *colVar = ( eqTree->m_rangeVars > 1 && cols > 1 )
+                  ? eqTree->m_rangeVar[1]
+                  : 0;
+    fprintf( fptr, "%s\n%d %d %d\n", ResultSetMagic, rows, cols, vars );
+    fprintf( fptr, "row %s %s\n",
+        ( rowVar ) ? rowVar->m_name.latin1() : "-",
+        resultSetUnits( rowVar ).latin1() );
+    fprintf( fptr, "col %s %s\n",
+        ( colVar ) ? colVar->m_name.latin1() : "-",
+        resultSetUnits( colVar ).latin1() );
+    EqVar *varPtr;
+    int vid;
+    for ( vid = 0;
+          vid < vars;
+          vid++ )
+    {
+        varPtr = eqTree->m_tableVar[vid];
+        fprintf( fptr, "var %s %s %d %s\n",
+            varPtr->m_name.latin1(),
+            ( varPtr->isDiscrete() ) ? "disc" : "cont",
+            varPtr->m_displayDecimals,
+            resultSetUnits( varPtr ).latin1() );
+    }
+    fprintf( fptr, "data\n" );
+
+    // Write the row and column values
+    double *buffer = new double[ ResultStoreChunkValues ];
+    checkmem( __FILE__, __LINE__, buffer, "double buffer",
+        ResultStoreChunkValues );
+    bool ok = true;
+    int i;
+    for ( i = 0;
+          i < rows;
+          i++ )
+    {
+        buffer[0] = ( eqTree->m_tableRow ) ? eqTree->m_tableRow[i] : 0.;
+        ok = ok && fwrite( buffer, sizeof(double), 1, fptr ) == 1;
+    }
+    for ( i = 0;
+          i < cols;
+          i++ )
+    {
+        buffer[0] = ( eqTree->m_tableCol ) ? eqTree->m_tableCol[i] : 0.;
+        ok = ok && fwrite( buffer, sizeof(double), 1, fptr ) == 1;
+    }
+    // Stream the output values a chunk at a time
+    Q_LLONG values = (Q_LLONG) rows * cols * vars;
+    Q_LLONG id;
+    int n = 0;
+    for ( id = 0;
+          id < values && ok;
+          id++ )
+    {
+        buffer[n++] = eqTree->m_tableVal->get( id );
+        if ( n == ResultStoreChunkValues || id == values - 1 )
+        {
+            ok = ( (int) fwrite( buffer, sizeof(double), n, fptr ) == n );
+            n = 0;
+        }
+    }
+    delete[] buffer;
+    if ( fclose( fptr ) != 0 || ! ok )
+    {
+        translate( errMsg, "ResultSet:WriteError", fileName );
+        return( false );
+    }
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+//  End of resultset.cpp
+//------------------------------------------------------------------------------
+
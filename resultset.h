@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------------
+/*! \file resultset.h
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief ResultSet class declaration.
+ *
+ *  A result set file holds a table run's results exactly (as binary doubles)
+ *  so two runs, perhaps made by different releases or with different custom
+ *  fuel models, may later be compared by ResultCompare.  The file starts
+ *  with a short text header:
+ *  \code
+ *  BehavePlus5 Result Set 1
+ *  rows cols vars
+ *  row name units
+ *  col name units
+ *  var name cont|disc decimals units
+ *  ...
+ *  data
+ *  \endcode
+ *  where a missing column variable is named "-" and empty units are
+ *  written as "-".  The header is followed by the row values, the column
+ *  values, and then every cell's output values in the same cell-major order
+ *  as the EqTree's ResultStore, all in display units.
+ *
+ *  Both writing and reading stream the values a ResultStore chunk at a time,
+ *  so result sets of any size are handled in a few hundred kilobytes.
+ */
+
+#ifndef _RESULTSET_H_
+/*! \def _RESULTSET_H_
+ *  \brief Prevent redundant includes.
+ */
+#define _RESULTSET_H_ 1
+
+// Class references
+class EqTree;
+
+// Qt include files
+#include <qstring.h>
+
+// Standard include files
+#include <stdio.h>
+
+//------------------------------------------------------------------------------
+/*! \class ResultSet resultset.h
+ *
+ *  \brief Reads and writes table run result set files.
+ */
+
+class ResultSet
+{
+// Public methods
+public:
+    ResultSet( void ) ;
+    ~ResultSet( void ) ;
+    void    close( void ) ;
+    int     findVar( const QString &name ) const ;
+    bool    open( const QString &fileName, QString &errMsg ) ;
+    double  value( Q_LLONG id ) ;
+    static bool write( EqTree *eqTree, const QString &fileName,
+                QString &errMsg ) ;
+
+// Public data
+public:
+    QString  m_fileName;    //!< Name of the result set file
+    int      m_rows;        //!< Number of table rows
+    int      m_cols;        //!< Number of table columns
+    int      m_vars;        //!< Number of output variables
+    QString  m_rowVar;      //!< Row variable name
+    QString  m_colVar;      //!< Column variable name, or "-"
+    QString  m_rowUnits;    //!< Row variable display units, or "-"
+    QString  m_colUnits;    //!< Column variable display units, or "-"
+    double  *m_row;         //!< Row values (display units)
+    double  *m_col;         //!< Column values (display units)
+    QString *m_varName;     //!< Output variable names
+    QString *m_varUnits;    //!< Output variable display units
+    int     *m_varDecimals; //!< Output variable display decimals
+    bool    *m_varDiscrete; //!< TRUE if the output variable is discrete
+    bool     m_readError;   //!< TRUE if value() could not read the file
+
+// Private data
+private:
+    FILE    *m_fptr;        //!< Result set file stream
+    Q_LLONG  m_dataOffset;  //!< File offset of the first output value
+    Q_LLONG  m_values;      //!< Number of output values
+    double  *m_chunk;       //!< Most recently read chunk of output values
+    int      m_chunkId;     //!< Index of the chunk in m_chunk[], or -1
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of resultset.h
+//------------------------------------------------------------------------------
+
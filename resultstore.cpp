@@ -0,0 +1,351 @@
+//------------------------------------------------------------------------------
+/*! \file resultstore.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief ResultStore class methods.
+ */
+
+// Spill files may exceed 2 GB, so 32-bit POSIX builds need 64-bit offsets.
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+
+// Custom include files
+#include "appmessage.h"
+#include "resultstore.h"
+
+// Standard include files
+#include <string.h>
+
+/*! \var ResultStoreChunkBytes
+ *  \brief Number of bytes per chunk.
+ */
+static const int ResultStoreChunkBytes =
+    ResultStoreChunkValues * sizeof(double);
+
+//------------------------------------------------------------------------------
+/*! \brief Positions the spill file at the start of a chunk.
+ *
+ *  Chunk offsets pass 2 GB long before a spill file fills the disk, and
+ *  \c long is only 32 bits on every Windows build, so the offset is a
+ *  64-bit integer and the seek uses the platform's 64-bit call.
+ *
+ *  \param fptr    Spill file.
+ *  \param chunkId Chunk index.
+ *
+ *  \return TRUE on success, FALSE if the seek failed.
+ */
+
+static bool resultStoreSeek( FILE *fptr, int chunkId )
+{
+    Q_LLONG offset = (Q_LLONG) chunkId * (Q_LLONG) ResultStoreChunkBytes;
+#if defined(_MSC_VER)
+    return( _fseeki64( fptr, offset, SEEK_SET ) == 0 );
+#elif defined(__MINGW32__)
+    return( fseeko64( fptr, offset, SEEK_SET ) == 0 );
+#else
+    return( fseeko( fptr, (off_t) offset, SEEK_SET ) == 0 );
+#endif
+}
+
+//------------------------------------------------------------------------------
+/*! \brief ResultStore constructor.
+ *
+ *  No storage is allocated until the first call to alloc().
+ */
+
+ResultStore::ResultStore( void ) :
+    m_loads(0),
+    m_spills(0),
+    m_values(0),
+    m_chunks(0),
+    m_slots(0),
+    m_slotSize(0),
+    m_data(0),
+    m_slotChunk(0),
+    m_slotUsed(0),
+    m_slotDirty(0),
+    m_chunkSlot(0),
+    m_chunkSaved(0),
+    m_chunkSize(0),
+    m_clock(0),
+    m_fptr(0),
+    m_lastChunk(-1),
+    m_last(0),
+    m_lastDirty(false)
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief ResultStore destructor.
+ */
+
+ResultStore::~ResultStore( void )
+{
+    clear();
+    delete[] m_data;        m_data = 0;
+    delete[] m_slotChunk;   m_slotChunk = 0;
+    delete[] m_slotUsed;    m_slotUsed = 0;
+    delete[] m_slotDirty;   m_slotDirty = 0;
+    delete[] m_chunkSlot;   m_chunkSlot = 0;
+    delete[] m_chunkSaved;  m_chunkSaved = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sizes the store for a new run, discarding any previous results.
+ *
+ *  Every value reads as zero until it is set().  The resident storage is
+ *  kept from run to run, so repeated runs of the same size make no heap
+ *  allocations.
+ *
+ *  \param values      Number of values to store.
+ *  \param budgetBytes Maximum bytes of resident values.  At least two
+ *                     chunks are always resident.
+ *
+ *  \return TRUE if all the values are resident, FALSE if the store will
+ *  page chunks to and from a spill file.
+ */
+
+bool ResultStore::alloc( Q_LLONG values, int budgetBytes )
+{
+    clear();
+    m_values = ( values > 0 ) ? values : 0;
+    m_chunks = (int) ( ( m_values + ResultStoreChunkValues - 1 )
+             >> ResultStoreChunkShift );
+    m_slots = budgetBytes / ResultStoreChunkBytes;
+    if ( m_slots < 2 )
+    {
+        m_slots = 2;
+    }
+    if ( m_slots >= m_chunks )
+    {
+        m_slots = m_chunks;
+    }
+    // If the spill file cannot be created, keep everything resident
+    // (which may exhaust memory), but tell the user first
+    else if ( ! ( m_fptr = tmpfile() ) )
+    {
+        m_slots = m_chunks;
+        QString msg("");
+        translate( msg, "ResultStore:NoSpillFile",
+            QString( "%1" ).arg( (double) m_chunks * ResultStoreChunkBytes
+                / ( 1024. * 1024. ), 0, 'f', 0 ) );
+        warn( msg );
+    }
+    // Chunk tables
+    if ( m_chunks > m_chunkSize )
+    {
+        delete[] m_chunkSlot;
+        delete[] m_chunkSaved;
+        m_chunkSize = m_chunks;
+        m_chunkSlot = new int[ m_chunkSize ];
+        checkmem( __FILE__, __LINE__, m_chunkSlot, "int m_chunkSlot",
+            m_chunkSize );
+        m_chunkSaved = new bool[ m_chunkSize ];
+        checkmem( __FILE__, __LINE__, m_chunkSaved, "bool m_chunkSaved",
+            m_chunkSize );
+    }
+    int i;
+    for ( i = 0;
+          i < m_chunks;
+          i++ )
+    {
+        m_chunkSlot[i] = -1;
+        m_chunkSaved[i] = false;
+    }
+    // Resident slots
+    if ( m_slots > m_slotSize )
+    {
+        delete[] m_data;
+        delete[] m_slotChunk;
+        delete[] m_slotUsed;
+        delete[] m_slotDirty;
+        m_slotSize = m_slots;
+        m_data = new double[ m_slotSize * ResultStoreChunkValues ];
+        checkmem( __FILE__, __LINE__, m_data, "double m_data",
+            m_slotSize * ResultStoreChunkValues );
+        m_slotChunk = new int[ m_slotSize ];
+        checkmem( __FILE__, __LINE__, m_slotChunk, "int m_slotChunk",
+            m_slotSize );
+        m_slotUsed = new unsigned int[ m_slotSize ];
+        checkmem( __FILE__, __LINE__, m_slotUsed, "unsigned int m_slotUsed",
+            m_slotSize );
+        m_slotDirty = new bool[ m_slotSize ];
+        checkmem( __FILE__, __LINE__, m_slotDirty, "bool m_slotDirty",
+            m_slotSize );
+    }
+    for ( i = 0;
+          i < m_slots;
+          i++ )
+    {
+        m_slotChunk[i] = -1;
+        m_slotUsed[i] = 0;
+        m_slotDirty[i] = false;
+    }
+    return( m_fptr == 0 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Returns the storage of a chunk, making it resident if necessary.
+ *
+ *  If the chunk is not resident, it replaces the least recently used chunk,
+ *  which is first written to the spill file if it has changed.
+ *
+ *  \param chunkId Chunk index.
+ *  \param write   If TRUE, the caller will change the chunk.
+ *
+ *  \return Pointer to the chunk's first value.
+ */
+
+double *ResultStore::chunk( int chunkId, bool write )
+{
+    int slot = m_chunkSlot[chunkId];
+    if ( slot < 0 )
+    {
+        // Use an empty slot, else the least recently used slot
+        int s;
+        for ( slot = 0, s = 1;
+              m_slotChunk[slot] >= 0 && s < m_slots;
+              s++ )
+        {
+            if ( m_slotChunk[s] < 0 || m_slotUsed[s] < m_slotUsed[slot] )
+            {
+                slot = s;
+            }
+        }
+        double *data = m_data + slot * ResultStoreChunkValues;
+        int old = m_slotChunk[slot];
+        if ( old >= 0 )
+        {
+            if ( m_slotDirty[slot] )
+            {
+                if ( ! resultStoreSeek( m_fptr, old )
+                  || fwrite( data, ResultStoreChunkBytes, 1, m_fptr ) != 1 )
+                {
+                    QString msg("");
+                    translate( msg, "ResultStore:WriteError" );
+                    bomb( msg );
+                }
+                m_chunkSaved[old] = true;
+                m_spills++;
+            }
+            m_chunkSlot[old] = -1;
+        }
+        if ( m_chunkSaved[chunkId] )
+        {
+            if ( ! resultStoreSeek( m_fptr, chunkId )
+              || fread( data, ResultStoreChunkBytes, 1, m_fptr ) != 1 )
+            {
+                QString msg("");
+                translate( msg, "ResultStore:ReadError" );
+                bomb( msg );
+            }
+            m_loads++;
+        }
+        else
+        {
+            memset( data, 0, ResultStoreChunkBytes );
+        }
+        m_slotChunk[slot] = chunkId;
+        m_chunkSlot[chunkId] = slot;
+        m_slotDirty[slot] = false;
+    }
+    m_slotUsed[slot] = ++m_clock;
+    if ( write )
+    {
+        m_slotDirty[slot] = true;
+    }
+    m_lastChunk = chunkId;
+    m_last = m_data + slot * ResultStoreChunkValues;
+    m_lastDirty = m_slotDirty[slot];
+    return( m_last );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Discards the results and closes (and so deletes) the spill file.
+ *
+ *  The resident storage is kept for the next alloc().
+ */
+
+void ResultStore::clear( void )
+{
+    if ( m_fptr )
+    {
+        fclose( m_fptr );
+        m_fptr = 0;
+    }
+    m_values = m_chunks = m_slots = 0;
+    m_loads = m_spills = 0;
+    m_clock = 0;
+    m_lastChunk = -1;
+    m_last = 0;
+    m_lastDirty = false;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to a single value.
+ *
+ *  \param id Value index in the range [0..values()-1].
+ *
+ *  \return The value, or 0 if it was never set().
+ */
+
+double ResultStore::get( Q_LLONG id )
+{
+    int c = (int) ( id >> ResultStoreChunkShift );
+    double *data = ( c == m_lastChunk ) ? m_last : chunk( c, false );
+    return( data[ (int) id & ( ResultStoreChunkValues - 1 ) ] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Composes a one line summary of the store's size and paging.
+ *
+ *  \param msg Reference to the string to hold the summary.
+ */
+
+void ResultStore::report( QString &msg ) const
+{
+    msg = QString( "Result store: %1 values in %2 chunks, %3 resident; "
+        "%4 chunks spilled, %5 chunks reloaded.\n" )
+        .arg( m_values )
+        .arg( m_chunks )
+        .arg( m_slots )
+        .arg( m_spills )
+        .arg( m_loads );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Stores a single value.
+ *
+ *  \param id    Value index in the range [0..values()-1].
+ *  \param value Value to store.
+ */
+
+void ResultStore::set( Q_LLONG id, double value )
+{
+    int c = (int) ( id >> ResultStoreChunkShift );
+    double *data = ( c == m_lastChunk && m_lastDirty ) ? m_last : chunk( c, true );
+    data[ (int) id & ( ResultStoreChunkValues - 1 ) ] = value;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the number of values in the store.
+ *
+ *  \return Number of values in the store.
+ */
+
+Q_LLONG ResultStore::values( void ) const
+{
+    return( m_values );
+}
+
+//------------------------------------------------------------------------------
+//  End of resultstore.cpp
+//------------------------------------------------------------------------------
+
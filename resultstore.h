@@ -0,0 +1,100 @@
+//------------------------------------------------------------------------------
+/*! \file resultstore.h
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief ResultStore class declaration.
+ *
+ *  A ResultStore holds a run's table results in fixed size chunks, of which
+ *  only as many as fit in a memory budget are resident at once.  When a run
+ *  has more results than the budget, the least recently used chunk is
+ *  written to an anonymous spill file to make room, and is read back the
+ *  next time it is needed.  Runs that fit the budget (nearly all of them)
+ *  never touch the file.
+ *
+ *  Results are kept in the same cell-major order in which runTable() writes
+ *  them and the table pages read them, so both sweep the chunks in order
+ *  and the spill file is read and written sequentially, a chunk at a time.
+ *  get() and set() go straight to the most recently used chunk, so the
+ *  per-value cost is an index comparison.
+ *
+ *  Value counts and indexes are 64-bit, so a store may hold more than 2^31
+ *  values (tens of GB of results) as long as the spill file fits on disk.
+ */
+
+#ifndef _RESULTSTORE_H_
+/*! \def _RESULTSTORE_H_
+ *  \brief Prevent redundant includes.
+ */
+#define _RESULTSTORE_H_ 1
+
+// Qt include files
+#include <qstring.h>
+
+// Standard include files
+#include <stdio.h>
+
+/*! \var ResultStoreChunkShift
+ *  \brief Log2 of the number of values per chunk (8192 values, 64 kB).
+ */
+static const int ResultStoreChunkShift = 13;
+
+/*! \var ResultStoreChunkValues
+ *  \brief Number of values per chunk.
+ */
+static const int ResultStoreChunkValues = 1 << ResultStoreChunkShift;
+
+//------------------------------------------------------------------------------
+/*! \class ResultStore resultstore.h
+ *
+ *  \brief Chunked run result storage with a bounded resident set.
+ */
+
+class ResultStore
+{
+// Public methods
+public:
+    ResultStore( void ) ;
+    ~ResultStore( void ) ;
+    bool    alloc( Q_LLONG values, int budgetBytes ) ;
+    void    clear( void ) ;
+    double  get( Q_LLONG id ) ;
+    void    report( QString &msg ) const ;
+    void    set( Q_LLONG id, double value ) ;
+    Q_LLONG values( void ) const ;
+
+// Private methods
+private:
+    double *chunk( int chunkId, bool write ) ;
+
+// Public data
+public:
+    int     m_loads;        //!< Chunks read from the spill file this run
+    int     m_spills;       //!< Chunks written to the spill file this run
+
+// Private data
+private:
+    Q_LLONG m_values;       //!< Number of values in the store
+    int     m_chunks;       //!< Number of chunks in the store
+    int     m_slots;        //!< Number of resident chunk slots in use
+    int     m_slotSize;     //!< Number of resident chunk slots allocated
+    double *m_data;         //!< Resident chunk slot storage
+    int    *m_slotChunk;    //!< Chunk in each slot, or -1
+    unsigned int *m_slotUsed;   //!< Clock time each slot was last used
+    bool   *m_slotDirty;    //!< TRUE if the slot was changed since loaded
+    int    *m_chunkSlot;    //!< Slot holding each chunk, or -1
+    bool   *m_chunkSaved;   //!< TRUE if the chunk is in the spill file
+    int     m_chunkSize;    //!< Number of chunks allocated for m_chunk*[]
+    unsigned int m_clock;   //!< LRU clock
+    FILE   *m_fptr;         //!< Spill file, or NULL if all chunks are resident
+    int     m_lastChunk;    //!< Most recently used chunk, or -1
+    double *m_last;         //!< Most recently used chunk's storage
+    bool    m_lastDirty;    //!< TRUE if m_lastChunk's slot is already dirty
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of resultstore.h
+//------------------------------------------------------------------------------
+
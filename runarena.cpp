@@ -0,0 +1,192 @@
+//------------------------------------------------------------------------------
+/*! \file runarena.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief RunArena class methods.
+ */
+
+// Custom include files
+#include "appmessage.h"
+#include "runarena.h"
+
+//------------------------------------------------------------------------------
+/*! \brief RunArena constructor.
+ *
+ *  No storage is allocated until the first call to alloc().
+ *
+ *  \param blockSize Minimum block size (bytes).
+ */
+
+RunArena::RunArena( int blockSize ) :
+    m_runs(0),
+    m_runAllocs(0),
+    m_runBlocks(0),
+    m_runBytes(0),
+    m_peakBytes(0),
+    m_totalAllocs(0),
+    m_totalBlocks(0),
+    m_first(0),
+    m_curr(0),
+    m_blockSize(blockSize),
+    m_allocs(0),
+    m_blocks(0),
+    m_bytes(0)
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief RunArena destructor.
+ *
+ *  Frees all the blocks, invalidating every array handed out by alloc().
+ */
+
+RunArena::~RunArena( void )
+{
+    freeBlocks();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Hands out storage for an array that lives until the next reset().
+ *
+ *  The storage is aligned for doubles and pointers, and is not initialized.
+ *
+ *  \param bytes Number of bytes required.
+ *
+ *  \return Pointer to the storage.
+ */
+
+void *RunArena::alloc( Q_LLONG bytes )
+{
+    // Round up to keep every array aligned for doubles
+    bytes = ( bytes < 1 ) ? 8 : ( ( bytes + 7 ) & ~7 );
+    if ( ! m_curr )
+    {
+        m_first = m_curr = newBlock( bytes );
+    }
+    else if ( m_curr->m_used + bytes > m_curr->m_size )
+    {
+        m_curr->m_next = newBlock( bytes );
+        m_curr = m_curr->m_next;
+    }
+    void *ptr = (void *) ( m_curr->m_data + m_curr->m_used );
+    m_curr->m_used += bytes;
+    m_bytes += bytes;
+    m_allocs++;
+    return( ptr );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Frees all the blocks in the chain.
+ */
+
+void RunArena::freeBlocks( void )
+{
+    RunArenaBlock *next;
+    while ( m_first )
+    {
+        next = m_first->m_next;
+        delete[] m_first->m_data;
+        delete m_first;
+        m_first = next;
+    }
+    m_curr = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Allocates a new block at least \a bytes long.
+ *
+ *  \param bytes Minimum block size (bytes).
+ *
+ *  \return Pointer to the new block.
+ */
+
+RunArenaBlock *RunArena::newBlock( Q_LLONG bytes )
+{
+    Q_LLONG size = ( bytes > m_blockSize ) ? bytes : m_blockSize;
+    RunArenaBlock *block = new RunArenaBlock;
+    checkmem( __FILE__, __LINE__, block, "RunArenaBlock block", 1 );
+    // A size the address space cannot hold fails like any other allocation
+    block->m_data = ( (Q_LLONG) (size_t) size == size )
+                  ? new char[ (size_t) size ]
+                  : 0;
+    checkmem( __FILE__, __LINE__, block->m_data, "char m_data (kB)",
+        (int) ( size >> 10 ) );
+    block->m_next = 0;
+    block->m_size = size;
+    block->m_used = 0;
+    m_blocks++;
+    m_totalBlocks++;
+    return( block );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Composes a one line summary of the last run's allocations.
+ *
+ *  \param msg Reference to the string to hold the summary.
+ */
+
+void RunArena::report( QString &msg ) const
+{
+    msg = QString( "Run %1 arena: %2 arrays in %3 new blocks, "
+        "%4 bytes (peak %5 bytes); %6 arrays in %7 blocks for all runs.\n" )
+        .arg( m_runs )
+        .arg( m_runAllocs )
+        .arg( m_runBlocks )
+        .arg( m_runBytes )
+        .arg( m_peakBytes )
+        .arg( m_totalAllocs )
+        .arg( m_totalBlocks );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Releases every array handed out since the last reset() and
+ *  records the run statistics.
+ *
+ *  If the run spilled over into more than one block, the blocks are
+ *  replaced by a single block big enough for the largest run, but no
+ *  larger than RunArenaKeepSize; a block above that size is released.
+ *
+ *  \return TRUE if any arrays were handed out since the last reset().
+ */
+
+bool RunArena::reset( void )
+{
+    if ( m_allocs == 0 )
+    {
+        return( false );
+    }
+    // Record the run statistics
+    m_runs++;
+    m_runAllocs = m_allocs;
+    m_runBlocks = m_blocks;
+    m_runBytes  = m_bytes;
+    m_totalAllocs += m_allocs;
+    if ( m_bytes > m_peakBytes )
+    {
+        m_peakBytes = m_bytes;
+    }
+    // Coalesce a multi-block chain into one block of bounded size
+    if ( m_first
+      && ( m_first->m_next || m_first->m_size > RunArenaKeepSize ) )
+    {
+        freeBlocks();
+        m_first = newBlock( ( m_peakBytes < RunArenaKeepSize )
+                          ? m_peakBytes : RunArenaKeepSize );
+    }
+    if ( m_first )
+    {
+        m_first->m_used = 0;
+    }
+    m_curr = m_first;
+    m_allocs = m_blocks = m_bytes = 0;
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+//  End of runarena.cpp
+//------------------------------------------------------------------------------
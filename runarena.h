@@ -0,0 +1,101 @@
+//------------------------------------------------------------------------------
+/*! \file runarena.h
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief RunArena class declaration.
+ *
+ *  A RunArena hands out the per-run arrays (table row and column values,
+ *  results, shading toggles, and output variable pointers) from a few large
+ *  blocks instead of one heap allocation per array.  Nothing is freed
+ *  individually; reset() releases everything at once at the end of a run
+ *  but keeps the storage for the next run.  If a run needed more than one
+ *  block, reset() replaces them with a single block large enough for the
+ *  whole run, so repeated runs of the same size make no heap allocations.
+ *  The block kept between runs is never larger than RunArenaKeepSize, so
+ *  the arrays of one very large run are released when it ends rather than
+ *  held for the life of the EqTree.
+ *  Sizes are 64-bit so that the arrays of very large runs are not
+ *  truncated; a block too large for the address space fails in checkmem().
+ */
+
+#ifndef _RUNARENA_H_
+/*! \def _RUNARENA_H_
+ *  \brief Prevent redundant includes.
+ */
+#define _RUNARENA_H_ 1
+
+// Qt include files
+#include <qstring.h>
+
+/*! \var RunArenaBlockSize
+ *  \brief Minimum RunArena block size (bytes).
+ */
+static const int RunArenaBlockSize = 65536;
+
+/*! \var RunArenaKeepSize
+ *  \brief Maximum RunArena block size kept between runs (bytes).
+ */
+static const int RunArenaKeepSize = 16777216;
+
+//------------------------------------------------------------------------------
+/*! \class RunArenaBlock runarena.h
+ *
+ *  \brief A single block of RunArena storage.
+ */
+
+class RunArenaBlock
+{
+public:
+    RunArenaBlock  *m_next;     //!< Next block in the chain
+    char           *m_data;     //!< Block storage
+    Q_LLONG         m_size;     //!< Block size (bytes)
+    Q_LLONG         m_used;     //!< Bytes handed out from this block
+};
+
+//------------------------------------------------------------------------------
+/*! \class RunArena runarena.h
+ *
+ *  \brief Run-scoped block allocator with allocation statistics.
+ */
+
+class RunArena
+{
+// Public methods
+public:
+    RunArena( int blockSize=RunArenaBlockSize ) ;
+    ~RunArena( void ) ;
+    void *alloc( Q_LLONG bytes ) ;
+    void  report( QString &msg ) const ;
+    bool  reset( void ) ;
+
+// Private methods
+private:
+    RunArenaBlock *newBlock( Q_LLONG bytes ) ;
+    void  freeBlocks( void ) ;
+
+// Public data
+public:
+    int     m_runs;         //!< Number of completed runs
+    int     m_runAllocs;    //!< Arrays handed out during the last run
+    int     m_runBlocks;    //!< Heap blocks allocated during the last run
+    Q_LLONG m_runBytes;     //!< Bytes handed out during the last run
+    Q_LLONG m_peakBytes;    //!< Largest m_runBytes of any run
+    int     m_totalAllocs;  //!< Arrays handed out during all runs
+    int     m_totalBlocks;  //!< Heap blocks allocated during all runs
+
+// Private data
+private:
+    RunArenaBlock *m_first; //!< First block in the chain
+    RunArenaBlock *m_curr;  //!< Block currently handing out storage
+    int     m_blockSize;    //!< Minimum block size (bytes)
+    int     m_allocs;       //!< Arrays handed out during the current run
+    int     m_blocks;       //!< Heap blocks allocated during the current run
+    Q_LLONG m_bytes;        //!< Bytes handed out during the current run
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of runarena.h
+//------------------------------------------------------------------------------
@@ -22,6 +22,7 @@
 #include <qframe.h>
 #include <qlabel.h>
 #include <qlayout.h>
+#include <qlineedit.h>
 #include <qradiobutton.h>
 #include <qtextedit.h>
 #include <qvbuttongroup.h>
@@ -49,7 +50,9 @@ RunDialog::RunDialog( BpDocument *bp, const char *name ) :
     m_tablesCheckBox(0),
     m_tablesVar1(0),
     m_tablesVar2(0),
-    m_graphLimitsCheckBox(0)
+    m_graphLimitsCheckBox(0),
+    m_queryCheckBox(0),
+    m_queryEntry(0)
 {
     // Add a text view to the main area
     m_textView = new TextView( m_page, "m_textView" );
@@ -109,6 +112,21 @@ RunDialog::RunDialog( BpDocument *bp, const char *name ) :
             m_tableButtonGroup->sizeHint().height() );
     }
 
+    // Create the query table checkbox and entry
+    translate( text, "RunDialog:Query:Checkbox" );
+    m_queryCheckBox = new QCheckBox( text, contentFrame(), "m_queryCheckBox" );
+    Q_CHECK_PTR( m_queryCheckBox );
+    m_queryCheckBox->setChecked(
+        m_bp->property()->boolean( "tableQueryActive" ) );
+    m_queryEntry = new QLineEdit( m_bp->property()->string( "tableQuery" ),
+        contentFrame(), "m_queryEntry" );
+    Q_CHECK_PTR( m_queryEntry );
+
+    translate( text, "RunDialog:Query:Caption" );
+    html += "<P><H3><FONT COLOR=\"#ff5500\">" + text + "</FONT></H3><HR>";
+    translate( text, "RunDialog:Query:Text" );
+    html += text;
+
     // Create the graphs checkbox
     translate( text, "RunDialog:Graphs:Checkbox" );
     m_graphsCheckBox = new QCheckBox( text, contentFrame(), "m_graphsCheckBox" );
@@ -225,6 +243,9 @@ RunDialog::~RunDialog( void )
 {
     delete m_textView;              m_textView = 0;
 
+    delete m_queryCheckBox;         m_queryCheckBox = 0;
+    delete m_queryEntry;            m_queryEntry = 0;
+
     delete m_graphLimitsCheckBox;   m_graphLimitsCheckBox = 0;
     delete m_graphsVar1;            m_graphsVar1 = 0;
     delete m_graphsVar2;            m_graphsVar2 = 0;
@@ -250,6 +271,10 @@ void RunDialog::store( void )
     m_bp->property()->boolean( "graphActive", m_graphsCheckBox->isChecked() );
     m_bp->property()->boolean( "graphYUserRange",
         m_graphLimitsCheckBox->isChecked() );
+    m_bp->property()->boolean( "tableQueryActive",
+        m_queryCheckBox->isChecked() );
+    m_bp->property()->string( "tableQuery",
+        m_queryEntry->text().simplifyWhiteSpace() );
 
     if ( m_bp->m_eqTree->m_rangeCase > 3 )
     {
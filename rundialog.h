@@ -18,6 +18,7 @@ class BpDocument;
 class EqTree;
 class QCheckBox;
 class QComboBox;
+class QLineEdit;
 class QRadioButton;
 class QSpinBox;
 class QVButtonGroup;
@@ -52,6 +53,8 @@ private:
     QRadioButton  *m_tablesVar1;        //!< Pointer to table range var 0 radio button
     QRadioButton  *m_tablesVar2;        //!< Pointer to table range var 1 radio button
     QCheckBox     *m_graphLimitsCheckBox;  //!< Pointer to graph limits on/off checkbox
+    QCheckBox     *m_queryCheckBox;     //!< Pointer to query table on/off checkbox
+    QLineEdit     *m_queryEntry;        //!< Pointer to query text entry
 };
 
 #endif
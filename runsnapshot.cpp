@@ -0,0 +1,597 @@
+//------------------------------------------------------------------------------
+/*! \file runsnapshot.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief RunSnapshot class methods.
+ */
+
+// Custom include files
+#include "appmessage.h"
+#include "appproperty.h"
+#include "fuelmodel.h"
+#include "moisscenario.h"
+#include "property.h"
+#include "resultstore.h"
+#include "runsnapshot.h"
+#include "rxvar.h"
+#include "xeqtree.h"
+#include "xeqvar.h"
+#include "xeqvaritem.h"
+
+// Qt include files
+#include <qptrdict.h>
+
+/*! \var HashSeed
+ *  \brief FNV-1a 32-bit offset basis.
+ */
+static const unsigned int HashSeed = 2166136261u;
+
+//------------------------------------------------------------------------------
+/*! \brief Folds \a bytes bytes at \a data into the FNV-1a hash \a hash.
+ *
+ *  \return The updated hash.
+ */
+
+static unsigned int hashBytes( unsigned int hash, const void *data, int bytes )
+{
+    const unsigned char *p = (const unsigned char *) data;
+    for ( int i = 0;
+          i < bytes;
+          i++ )
+    {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return( hash );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Folds \a value into the FNV-1a hash \a hash.
+ *
+ *  \return The updated hash.
+ */
+
+static unsigned int hashDouble( unsigned int hash, double value )
+{
+    return( hashBytes( hash, &value, sizeof(value) ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Folds \a text and a separator into the FNV-1a hash \a hash.
+ *
+ *  \return The updated hash.
+ */
+
+static unsigned int hashText( unsigned int hash, const QString &text )
+{
+    if ( ! text.isEmpty() )
+    {
+        hash = hashBytes( hash, text.latin1(), text.length() );
+    }
+    return( hashBytes( hash, "\t", 1 ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief RunSnapshot constructor.
+ *
+ *  The snapshot is empty until the first save().
+ */
+
+RunSnapshot::RunSnapshot( void ) :
+    m_valid(false),
+    m_rows(0),
+    m_cols(0),
+    m_vars(0),
+    m_cells(0),
+    m_row(0),
+    m_col(0),
+    m_rowVar(0),
+    m_colVar(0),
+    m_var(0),
+    m_calc(0),
+    m_slot(0),
+    m_keep(0),
+    m_units(0),
+    m_leafs(0),
+    m_leaf(0),
+    m_leafSig(0),
+    m_context(0),
+    m_nextLeafs(0),
+    m_nextLeaf(0),
+    m_nextLeafSig(0),
+    m_nextContext(0),
+    m_values(0)
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief RunSnapshot destructor.
+ */
+
+RunSnapshot::~RunSnapshot( void )
+{
+    clear();
+    delete[] m_nextLeaf;    m_nextLeaf = 0;
+    delete[] m_nextLeafSig; m_nextLeafSig = 0;
+    delete   m_values;      m_values = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Records the input signatures and context of the run that is about
+ *  to start, for use by reusable() and save().
+ *
+ *  Must be called after EqTree::runInit() but before any table cell is
+ *  calculated, while the input variables still hold their worksheet values.
+ *
+ *  \param eqTree Pointer to the EqTree being run.
+ */
+
+void RunSnapshot::begin( EqTree *eqTree )
+{
+    delete[] m_nextLeaf;    m_nextLeaf = 0;
+    delete[] m_nextLeafSig; m_nextLeafSig = 0;
+    m_nextLeafs = eqTree->m_leafCount;
+    if ( m_nextLeafs > 0 )
+    {
+        m_nextLeaf = new EqVar *[ m_nextLeafs ];
+        checkmem( __FILE__, __LINE__, m_nextLeaf, "EqVar *m_nextLeaf",
+            m_nextLeafs );
+        m_nextLeafSig = new QString[ m_nextLeafs ];
+        checkmem( __FILE__, __LINE__, m_nextLeafSig, "QString m_nextLeafSig",
+            m_nextLeafs );
+    }
+    for ( int lid = 0;
+          lid < m_nextLeafs;
+          lid++ )
+    {
+        m_nextLeaf[lid] = eqTree->m_leaf[lid];
+        leafSignature( eqTree, m_nextLeaf[lid], m_nextLeafSig[lid] );
+    }
+    m_nextContext = context( eqTree );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Empties the snapshot so nothing can be reused from it.
+ */
+
+void RunSnapshot::clear( void )
+{
+    m_valid = false;
+    delete[] m_row;         m_row = 0;
+    delete[] m_col;         m_col = 0;
+    delete[] m_var;         m_var = 0;
+    delete[] m_calc;        m_calc = 0;
+    delete[] m_slot;        m_slot = 0;
+    delete[] m_units;       m_units = 0;
+    delete[] m_leaf;        m_leaf = 0;
+    delete[] m_leafSig;     m_leafSig = 0;
+    m_rows = m_cols = m_vars = m_cells = m_leafs = m_keep = 0;
+    m_rowVar = m_colVar = 0;
+    if ( m_values )
+    {
+        m_values->clear();
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Hashes everything other than the input variables that a run's
+ *  results depend upon.
+ *
+ *  This is the set of active functions, every tree property (the module
+ *  configuration options are all properties), the application properties
+ *  that select how the table is calculated, and the contents of the fuel
+ *  model and moisture scenario lists, which inputs refer to by name.
+ *
+ *  The tree copies the application properties when it is created, so the
+ *  calculation mode properties are read from appProperty() here, where a
+ *  change made since then is seen.  A table interpolated by
+ *  EqTree::runSurrogate() must not be reused by a calculated one, or vice
+ *  versa.
+ *
+ *  \param eqTree Pointer to the EqTree being run.
+ *
+ *  \return The context hash.
+ */
+
+unsigned int RunSnapshot::context( EqTree *eqTree )
+{
+    unsigned int hash = HashSeed;
+    for ( int fid = 0;
+          fid < eqTree->m_funCount;
+          fid++ )
+    {
+        hash = hashBytes( hash, eqTree->m_fun[fid]->m_active ? "1" : "0", 1 );
+    }
+    QDictIterator<Property> propIt( *eqTree->m_propDict );
+    for ( ;
+          propIt.current();
+          ++propIt )
+    {
+        hash = hashText( hash, propIt.currentKey() );
+        hash = hashText( hash, propIt.current()->m_value );
+    }
+    hash = hashBytes( hash,
+        appProperty()->boolean( "appSurrogateRun" ) ? "1" : "0", 1 );
+    hash = hashDouble( hash, appProperty()->real( "appSurrogateTolerance" ) );
+    QPtrListIterator<FuelModel> fmIt( *eqTree->m_fuelModelList );
+    FuelModel *fm;
+    while ( ( fm = fmIt.current() ) != 0 )
+    {
+        ++fmIt;
+        hash = hashText( hash, fm->m_name );
+        hash = hashText( hash, fm->m_transfer );
+        hash = hashDouble( hash, fm->m_depth );
+        hash = hashDouble( hash, fm->m_mext );
+        hash = hashDouble( hash, fm->m_heatDead );
+        hash = hashDouble( hash, fm->m_heatLive );
+        hash = hashDouble( hash, fm->m_load1 );
+        hash = hashDouble( hash, fm->m_load10 );
+        hash = hashDouble( hash, fm->m_load100 );
+        hash = hashDouble( hash, fm->m_loadHerb );
+        hash = hashDouble( hash, fm->m_loadWood );
+        hash = hashDouble( hash, fm->m_savr1 );
+        hash = hashDouble( hash, fm->m_savrHerb );
+        hash = hashDouble( hash, fm->m_savrWood );
+    }
+    QPtrListIterator<MoisScenario> msIt( *eqTree->m_moisScenarioList );
+    MoisScenario *ms;
+    while ( ( ms = msIt.current() ) != 0 )
+    {
+        ++msIt;
+        hash = hashText( hash, ms->m_name );
+        hash = hashDouble( hash, ms->m_moisDead1 );
+        hash = hashDouble( hash, ms->m_moisDead10 );
+        hash = hashDouble( hash, ms->m_moisDead100 );
+        hash = hashDouble( hash, ms->m_moisDead1000 );
+        hash = hashDouble( hash, ms->m_moisLiveHerb );
+        hash = hashDouble( hash, ms->m_moisLiveWood );
+    }
+    return( hash );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Builds the signature of an input variable's current value.
+ *
+ *  The signature holds the worksheet entry, the display units, and the
+ *  current value.  The range variables' current values are left out, since
+ *  they are set for each table cell and compared through the row and column
+ *  values instead.
+ *
+ *  \param eqTree Pointer to the EqTree being run.
+ *  \param varPtr Pointer to the input variable.
+ *  \param sig    Reference to the string to hold the signature.
+ */
+
+void RunSnapshot::leafSignature( EqTree *eqTree, EqVar *varPtr, QString &sig )
+{
+    sig = varPtr->m_store + "\t";
+    if ( varPtr == eqTree->m_rangeVar[0] || varPtr == eqTree->m_rangeVar[1] )
+    {
+        return;
+    }
+    if ( varPtr->isContinuous() )
+    {
+        sig += varPtr->m_displayUnits + "\t"
+            + QString::number( varPtr->m_nativeValue, 'g', 17 );
+    }
+    else if ( varPtr->isDiscrete() )
+    {
+        sig += varPtr->activeItemName() + "\t"
+            + QString::number( varPtr->m_itemList->m_serial );
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Builds the signature of the way an output variable's results are
+ *  stored, which is in its display units.
+ *
+ *  \param varPtr Pointer to the output variable.
+ *  \param sig    Reference to the string to hold the signature.
+ */
+
+void RunSnapshot::outputSignature( EqVar *varPtr, QString &sig )
+{
+    if ( varPtr->isContinuous() )
+    {
+        sig = varPtr->m_displayUnits + "\t"
+            + QString::number( varPtr->m_displayDecimals );
+    }
+    else if ( varPtr->isDiscrete() )
+    {
+        sig = QString::number( varPtr->m_itemList->m_serial );
+    }
+    else
+    {
+        sig = "";
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines which of the current run's output columns can be
+ *  copied from the snapshot.
+ *
+ *  Nothing is reusable unless the snapshot holds a completed run of a table
+ *  with the same row and column variables and values, the same output
+ *  variables and input variables, and the same context().  Any input whose
+ *  signature changed is followed forward through every active function
+ *  that consumes it; an output column is reusable if none of the changed
+ *  inputs reach it, it was calculated (not approximated) by the previous run
+ *  and is needed by
+ *  this one, its units are unchanged, and it is not an active prescription
+ *  variable (whose current value each cell's shading depends upon).
+ *
+ *  Must be called after begin().
+ *
+ *  \param eqTree Pointer to the EqTree being run.
+ *  \param reuse  Array of EqTree::m_tableVars flags, set TRUE for each
+ *                output column that can be copied.
+ *
+ *  \return Number of reusable output columns.
+ */
+
+int RunSnapshot::reusable( EqTree *eqTree, bool *reuse )
+{
+    int vid, lid, i;
+    for ( vid = 0;
+          vid < eqTree->m_tableVars;
+          vid++ )
+    {
+        reuse[vid] = false;
+    }
+    // The table must have the same shape and context
+    if ( ! m_valid
+      || m_rows != eqTree->m_tableRows
+      || m_cols != eqTree->m_tableCols
+      || m_vars != eqTree->m_tableVars
+      || m_cells != eqTree->m_tableCells
+      || m_rowVar != eqTree->m_rangeVar[0]
+      || m_colVar != eqTree->m_rangeVar[1]
+      || m_leafs != m_nextLeafs
+      || m_context != m_nextContext )
+    {
+        return( 0 );
+    }
+    for ( i = 0;
+          i < m_rows;
+          i++ )
+    {
+        if ( m_rowVar && m_row[i] != eqTree->m_tableRow[i] )
+        {
+            return( 0 );
+        }
+    }
+    for ( i = 0;
+          i < m_cols;
+          i++ )
+    {
+        if ( m_colVar && m_col[i] != eqTree->m_tableCol[i] )
+        {
+            return( 0 );
+        }
+    }
+    for ( lid = 0;
+          lid < m_leafs;
+          lid++ )
+    {
+        if ( m_leaf[lid] != m_nextLeaf[lid] )
+        {
+            return( 0 );
+        }
+    }
+    // Mark everything downstream of the changed inputs
+    QPtrDict<EqVar> affected( 1021 );
+    EqVar **stack = new EqVar *[ eqTree->m_varCount ];
+    checkmem( __FILE__, __LINE__, stack, "EqVar *stack", eqTree->m_varCount );
+    int top = 0;
+    for ( lid = 0;
+          lid < m_leafs;
+          lid++ )
+    {
+        if ( m_leafSig[lid] != m_nextLeafSig[lid]
+          && ! affected.find( m_leaf[lid] ) )
+        {
+            affected.insert( m_leaf[lid], m_leaf[lid] );
+            stack[top++] = m_leaf[lid];
+        }
+    }
+    EqVar *varPtr, *outPtr;
+    EqFun *funPtr;
+    int cid, oid;
+    while ( top > 0 )
+    {
+        varPtr = stack[--top];
+        for ( cid = 0;
+              cid < varPtr->m_consumers;
+              cid++ )
+        {
+            funPtr = varPtr->m_consumer[cid];
+            if ( ! funPtr->m_active )
+            {
+                continue;
+            }
+            for ( oid = 0;
+                  oid < funPtr->m_outputs;
+                  oid++ )
+            {
+                outPtr = funPtr->m_output[oid];
+                if ( ! affected.find( outPtr ) )
+                {
+                    affected.insert( outPtr, outPtr );
+                    stack[top++] = outPtr;
+                }
+            }
+        }
+    }
+    delete[] stack;
+
+    // Determine which output columns can be copied
+    QString sig("");
+    RxVar *rxVar;
+    int reused = 0;
+    for ( vid = 0;
+          vid < m_vars;
+          vid++ )
+    {
+        varPtr = eqTree->m_tableVar[vid];
+        if ( varPtr != m_var[vid]
+          || ! m_calc[vid]
+          || ! eqTree->m_tableCalc[vid]
+          || affected.find( varPtr ) )
+        {
+            continue;
+        }
+        outputSignature( varPtr, sig );
+        if ( sig != m_units[vid] )
+        {
+            continue;
+        }
+        reuse[vid] = true;
+        for ( rxVar = eqTree->m_rxVarList->first();
+              rxVar && reuse[vid];
+              rxVar = eqTree->m_rxVarList->next() )
+        {
+            reuse[vid] = ! ( rxVar->m_isActive && rxVar->m_varPtr == varPtr );
+        }
+        if ( reuse[vid] )
+        {
+            reused++;
+        }
+    }
+    return( reused );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Saves the table and results of the run started by begin(), which
+ *  must have completed every cell.
+ *
+ *  Only the output columns that reusable() could ever hand back, those the
+ *  run calculated exactly, are copied.  They are packed together in
+ *  m_values in the same cell-major order, so skipped and approximated
+ *  columns cost neither memory nor spill file space.
+ *
+ *  \param eqTree Pointer to the EqTree that was run.
+ */
+
+void RunSnapshot::save( EqTree *eqTree )
+{
+    clear();
+    m_rows   = eqTree->m_tableRows;
+    m_cols   = eqTree->m_tableCols;
+    m_vars   = eqTree->m_tableVars;
+    m_cells  = eqTree->m_tableCells;
+    m_rowVar = eqTree->m_rangeVar[0];
+    m_colVar = eqTree->m_rangeVar[1];
+    int i;
+    if ( m_rowVar )
+    {
+        m_row = new double[ m_rows ];
+        checkmem( __FILE__, __LINE__, m_row, "double m_row", m_rows );
+        for ( i = 0;
+              i < m_rows;
+              i++ )
+        {
+            m_row[i] = eqTree->m_tableRow[i];
+        }
+    }
+    if ( m_colVar )
+    {
+        m_col = new double[ m_cols ];
+        checkmem( __FILE__, __LINE__, m_col, "double m_col", m_cols );
+        for ( i = 0;
+              i < m_cols;
+              i++ )
+        {
+            m_col[i] = eqTree->m_tableCol[i];
+        }
+    }
+    m_var = new EqVar *[ m_vars ];
+    checkmem( __FILE__, __LINE__, m_var, "EqVar *m_var", m_vars );
+    m_calc = new bool[ m_vars ];
+    checkmem( __FILE__, __LINE__, m_calc, "bool m_calc", m_vars );
+    m_slot = new int[ m_vars ];
+    checkmem( __FILE__, __LINE__, m_slot, "int m_slot", m_vars );
+    m_units = new QString[ m_vars ];
+    checkmem( __FILE__, __LINE__, m_units, "QString m_units", m_vars );
+    for ( i = 0;
+          i < m_vars;
+          i++ )
+    {
+        m_var[i]  = eqTree->m_tableVar[i];
+        m_calc[i] = eqTree->m_tableCalc[i]
+            && ! ( eqTree->m_tableApprox && eqTree->m_tableApprox[i] );
+        m_slot[i] = m_calc[i] ? m_keep++ : -1;
+        outputSignature( m_var[i], m_units[i] );
+    }
+    // Take over the inputs recorded by begin()
+    m_leafs       = m_nextLeafs;
+    m_leaf        = m_nextLeaf;
+    m_leafSig     = m_nextLeafSig;
+    m_context     = m_nextContext;
+    m_nextLeafs   = 0;
+    m_nextLeaf    = 0;
+    m_nextLeafSig = 0;
+
+    // Copy the results of the kept columns
+    m_valid = true;
+    if ( m_keep == 0 )
+    {
+        return;
+    }
+    if ( ! m_values )
+    {
+        m_values = new ResultStore();
+        checkmem( __FILE__, __LINE__, m_values, "ResultStore m_values", 1 );
+    }
+    int kBytes = appProperty()->integer( "appResultCacheKSize" );
+    if ( kBytes > 2097151 )
+    {
+        kBytes = 2097151;
+    }
+    Q_LLONG cells = ( m_vars > 0 ) ? m_cells / m_vars : 0;
+    m_values->alloc( cells * m_keep, 1024 * kBytes );
+    Q_LLONG cell, id;
+    for ( cell = 0, id = 0;
+          cell < cells;
+          cell++ )
+    {
+        for ( i = 0;
+              i < m_vars;
+              i++, id++ )
+        {
+            if ( m_slot[i] >= 0 )
+            {
+                m_values->set( cell * m_keep + m_slot[i],
+                    eqTree->m_tableVal->get( id ) );
+            }
+        }
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the snapshot's copy of result \a id, which has the same
+ *  cell-major order as EqTree::m_tableVal.
+ *
+ *  Only results of the output columns that reusable() flags are kept.
+ *
+ *  \return The result value.
+ */
+
+double RunSnapshot::value( Q_LLONG id )
+{
+    Q_LLONG cell = id / m_vars;
+    int vid = (int) ( id - cell * m_vars );
+    return( m_values->get( cell * m_keep + m_slot[vid] ) );
+}
+
+//------------------------------------------------------------------------------
+//  End of runsnapshot.cpp
+//------------------------------------------------------------------------------
+
@@ -0,0 +1,92 @@
+//------------------------------------------------------------------------------
+/*! \file runsnapshot.h
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief RunSnapshot class declaration.
+ *
+ *  A RunSnapshot remembers enough about an EqTree's last table run to let
+ *  the next run of the same table reuse it.  It keeps a copy of the results
+ *  of the output columns a later run could reuse (those the run calculated
+ *  exactly), the table's shape (row and column values and output
+ *  variables), a signature of every input variable, and a hash of
+ *  everything else the calculations read (the active functions, the tree
+ *  properties, and the fuel model and moisture scenario lists).
+ *
+ *  When the next run has the same shape and context, the inputs whose
+ *  signatures changed are followed forward through the active functions to
+ *  find every output they can affect.  The remaining output columns are
+ *  copied from the snapshot instead of being calculated again.
+ */
+
+#ifndef _RUNSNAPSHOT_H_
+/*! \def _RUNSNAPSHOT_H_
+ *  \brief Prevent redundant includes.
+ */
+#define _RUNSNAPSHOT_H_ 1
+
+// Class references
+class EqTree;
+class EqVar;
+class ResultStore;
+
+// Qt include files
+#include <qstring.h>
+
+//------------------------------------------------------------------------------
+/*! \class RunSnapshot runsnapshot.h
+ *
+ *  \brief Results and inputs of an EqTree's previous table run.
+ */
+
+class RunSnapshot
+{
+// Public methods
+public:
+    RunSnapshot( void ) ;
+    ~RunSnapshot( void ) ;
+    void    begin( EqTree *eqTree ) ;
+    void    clear( void ) ;
+    int     reusable( EqTree *eqTree, bool *reuse ) ;
+    void    save( EqTree *eqTree ) ;
+    double  value( Q_LLONG id ) ;
+
+// Private methods
+private:
+    static unsigned int context( EqTree *eqTree ) ;
+    static void leafSignature( EqTree *eqTree, EqVar *varPtr, QString &sig ) ;
+    static void outputSignature( EqVar *varPtr, QString &sig ) ;
+
+// Private data
+private:
+    bool     m_valid;       //!< TRUE if the snapshot holds a completed run
+    int      m_rows;        //!< Number of table rows
+    int      m_cols;        //!< Number of table columns
+    int      m_vars;        //!< Number of table output variables
+    Q_LLONG  m_cells;       //!< Number of table results
+    double  *m_row;         //!< Table row values
+    double  *m_col;         //!< Table column values
+    EqVar   *m_rowVar;      //!< Row range variable, or NULL
+    EqVar   *m_colVar;      //!< Column range variable, or NULL
+    EqVar  **m_var;         //!< Table output variables
+    bool    *m_calc;        //!< TRUE if the output variable was calculated
+    int     *m_slot;        //!< Column of each output variable in m_values, or -1
+    int      m_keep;        //!< Number of output columns kept in m_values
+    QString *m_units;       //!< Output variable display units and decimals
+    int      m_leafs;       //!< Number of input variables
+    EqVar  **m_leaf;        //!< Input variables
+    QString *m_leafSig;     //!< Input variable signatures
+    unsigned int m_context; //!< Hash of everything else the run depended upon
+    int      m_nextLeafs;   //!< Number of input variables of the current run
+    EqVar  **m_nextLeaf;    //!< Input variables of the current run
+    QString *m_nextLeafSig; //!< Input variable signatures of the current run
+    unsigned int m_nextContext; //!< Context hash of the current run
+    ResultStore *m_values;  //!< Copy of the kept output columns' results
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of runsnapshot.h
+//------------------------------------------------------------------------------
+
@@ -0,0 +1,784 @@
+//------------------------------------------------------------------------------
+/*! \file terraingrid.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief TerrainGrid class methods.
+ */
+
+// Custom include files
+#include "appmessage.h"
+#include "apptranslator.h"
+#include "terraingrid.h"
+
+// Standard include files
+#include <ctype.h>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*! \var TerrainGridBufferSize
+ *  \brief Size of the file read buffer (bytes).
+ */
+static const int TerrainGridBufferSize = 262144;
+
+/*! \var TerrainRadToDeg
+ *  \brief Radians to degrees conversion factor.
+ */
+static const double TerrainRadToDeg = 57.29577951308232;
+
+//------------------------------------------------------------------------------
+/*! \brief Reads the next white space delimited token from a file through
+ *  a caller supplied buffer.
+ *
+ *  Used instead of fscanf() since elevation grids may have tens of millions
+ *  of values.
+ *
+ *  \param fptr   Open file pointer.
+ *  \param buffer File read buffer of TerrainGridBufferSize bytes.
+ *  \param pos    Address of the next unread buffer position.
+ *  \param len    Address of the number of bytes in the buffer.
+ *  \param token  Returned token.
+ *  \param maxLen Size of the \a token array.
+ *
+ *  \return TRUE if a token was read, FALSE at end-of-file.
+ */
+
+static bool readToken( FILE *fptr, char *buffer, int *pos, int *len,
+        char *token, int maxLen )
+{
+    int n = 0;
+    while ( true )
+    {
+        if ( *pos >= *len )
+        {
+            *len = fread( buffer, 1, TerrainGridBufferSize, fptr );
+            *pos = 0;
+            if ( *len <= 0 )
+            {
+                break;
+            }
+        }
+        char c = buffer[*pos];
+        if ( isspace( (unsigned char) c ) )
+        {
+            if ( n > 0 )
+            {
+                break;
+            }
+        }
+        else if ( n < maxLen - 1 )
+        {
+            token[n++] = c;
+        }
+        (*pos)++;
+    }
+    token[n] = '\0';
+    return( n > 0 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Horn's slope gradients for a single cell.
+ *
+ *  \param up Elevation row north of the cell.
+ *  \param md Elevation row containing the cell.
+ *  \param dn Elevation row south of the cell.
+ *  \param w  Column west of the cell.
+ *  \param c  Cell column.
+ *  \param e  Column east of the cell.
+ *  \param kx 1 / (4 * east-west reach), where the reach is two cells, or
+ *            one cell if \a w or \a e is the cell itself.
+ *  \param ky 1 / (4 * north-south reach), as for \a kx.
+ *  \param zx Returned eastward rise per unit reach.
+ *  \param zy Returned northward rise per unit reach.
+ */
+
+static void hornCell( const float *up, const float *md, const float *dn,
+        int w, int c, int e, double kx, double ky, double *zx, double *zy )
+{
+    *zx = ( ( up[e] + 2. * md[e] + dn[e] )
+          - ( up[w] + 2. * md[w] + dn[w] ) ) * kx;
+    *zy = ( ( up[w] + 2. * up[c] + up[e] )
+          - ( dn[w] + 2. * dn[c] + dn[e] ) ) * ky;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief TerrainGrid constructor.
+ */
+
+TerrainGrid::TerrainGrid( void ) :
+    m_rows(0),
+    m_cols(0),
+    m_noDataCells(0),
+    m_xll(0.),
+    m_yll(0.),
+    m_cellSize(0.),
+    m_noData(-9999.),
+    m_elev(0),
+    m_slope(0),
+    m_aspect(0),
+    m_rvElev(0),
+    m_rvDist(0)
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief TerrainGrid destructor.
+ */
+
+TerrainGrid::~TerrainGrid( void )
+{
+    freeRasters();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the grid cell containing a map location.
+ *
+ *  \param x   Map X coordinate (grid units).
+ *  \param y   Map Y coordinate (grid units).
+ *  \param row Returned cell row.
+ *  \param col Returned cell column.
+ *
+ *  \return TRUE if the location is on the grid.
+ */
+
+bool TerrainGrid::cell( double x, double y, int *row, int *col ) const
+{
+    if ( ! m_elev || m_cellSize <= 0. )
+    {
+        return( false );
+    }
+    int c = (int) floor( ( x - m_xll ) / m_cellSize );
+    int r = m_rows - 1 - (int) floor( ( y - m_yll ) / m_cellSize );
+    if ( c < 0 || c >= m_cols || r < 0 || r >= m_rows )
+    {
+        return( false );
+    }
+    *row = r;
+    *col = c;
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Compares the slope and aspect rasters against a scalar, double
+ *  precision evaluation of sample edge and interior cells.
+ *
+ *  Up to \a samples cells are taken from the grid edges, where the kernels
+ *  use one-sided differences, and up to \a samples more from the interior.
+ *  The reference slope is converted to degrees and back with the same
+ *  tangent as EqCalc::SiteSlopeFraction(), and the reference aspect uses the
+ *  same clockwise-from-north azimuth as vSiteAspectDirFromNorth.
+ *
+ *  \param aspectDiff Returned largest aspect difference (degrees).
+ *  \param samples    Maximum number of edge cells, and of interior cells,
+ *                    to sample.
+ *
+ *  \return Largest slope fraction difference.
+ */
+
+double TerrainGrid::check( double *aspectDiff, int samples ) const
+{
+    double slopeDiff = 0.;
+    *aspectDiff = 0.;
+    if ( ! m_slope || samples < 1 )
+    {
+        return( slopeDiff );
+    }
+    // Edge cells, clockwise from the north-west corner (all the cells of a
+    // grid less than 3 cells wide)
+    bool thin = ( m_rows < 3 || m_cols < 3 );
+    int cells = thin ? ( m_rows * m_cols ) : ( 2 * ( m_rows + m_cols ) - 4 );
+    int step = ( cells > samples ) ? ( cells / samples ) : 1;
+    int i, j, row, col;
+    for ( i = 0;
+          i < cells;
+          i += step )
+    {
+        if ( thin )
+        {
+            row = i / m_cols;
+            col = i % m_cols;
+        }
+        else if ( i < m_cols )
+        {
+            row = 0;
+            col = i;
+        }
+        else if ( i < 2 * m_cols )
+        {
+            row = m_rows - 1;
+            col = i - m_cols;
+        }
+        else
+        {
+            j = i - 2 * m_cols;
+            row = 1 + j / 2;
+            col = ( j % 2 ) ? ( m_cols - 1 ) : 0;
+        }
+        checkCell( row, col, &slopeDiff, aspectDiff );
+    }
+    // Interior cells
+    if ( thin )
+    {
+        return( slopeDiff );
+    }
+    cells = ( m_rows - 2 ) * ( m_cols - 2 );
+    step = ( cells > samples ) ? ( cells / samples ) : 1;
+    for ( i = 0;
+          i < cells;
+          i += step )
+    {
+        row = 1 + i / ( m_cols - 2 );
+        col = 1 + i % ( m_cols - 2 );
+        checkCell( row, col, &slopeDiff, aspectDiff );
+    }
+    return( slopeDiff );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Compares one cell's slope and aspect against a scalar, double
+ *  precision evaluation.
+ *
+ *  The reference divides each Horn difference by the distance it actually
+ *  spans, which is one cell rather than two across a grid edge, so it
+ *  does not share the kernels' edge scaling.
+ *
+ *  \param row        Cell row.
+ *  \param col        Cell column.
+ *  \param slopeDiff  Largest slope fraction difference, updated.
+ *  \param aspectDiff Largest aspect difference (degrees), updated.
+ */
+
+void TerrainGrid::checkCell( int row, int col, double *slopeDiff,
+        double *aspectDiff ) const
+{
+    int cell = row * m_cols + col;
+    if ( m_slope[cell] == m_noData )
+    {
+        return;
+    }
+    int n = ( row > 0 ) ? ( row - 1 ) : row;
+    int s = ( row < m_rows - 1 ) ? ( row + 1 ) : row;
+    int w = ( col > 0 ) ? ( col - 1 ) : col;
+    int e = ( col < m_cols - 1 ) ? ( col + 1 ) : col;
+    const float *up = m_elev + n * m_cols;
+    const float *md = m_elev + row * m_cols;
+    const float *dn = m_elev + s * m_cols;
+    double zx = 0.;
+    double zy = 0.;
+    if ( e > w )
+    {
+        zx = ( ( up[e] + 2. * md[e] + dn[e] )
+             - ( up[w] + 2. * md[w] + dn[w] ) )
+           / ( 4. * m_cellSize * (double) ( e - w ) );
+    }
+    if ( s > n )
+    {
+        zy = ( ( up[w] + 2. * up[col] + up[e] )
+             - ( dn[w] + 2. * dn[col] + dn[e] ) )
+           / ( 4. * m_cellSize * (double) ( s - n ) );
+    }
+    double deg = atan( sqrt( zx * zx + zy * zy ) ) * TerrainRadToDeg;
+    double slope = tan( deg / TerrainRadToDeg );
+    double diff = fabs( slope - m_slope[cell] );
+    if ( diff > *slopeDiff )
+    {
+        *slopeDiff = diff;
+    }
+    // Aspect is undefined on flat ground
+    if ( slope > 0.001 )
+    {
+        double aspect = atan2( -zx, -zy ) * TerrainRadToDeg;
+        if ( aspect < 0. )
+        {
+            aspect += 360.;
+        }
+        diff = fabs( aspect - m_aspect[cell] );
+        if ( diff > 180. )
+        {
+            diff = 360. - diff;
+        }
+        if ( diff > *aspectDiff )
+        {
+            *aspectDiff = diff;
+        }
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Computes all the derived rasters from the elevation grid.
+ *
+ *  \param radius Ridge-to-valley window radius (cells), limited to
+ *  [1..TerrainGridMaxRadius].
+ */
+
+void TerrainGrid::compute( int radius )
+{
+    if ( ! m_elev )
+    {
+        return;
+    }
+    if ( radius < 1 )
+    {
+        radius = 1;
+    }
+    if ( radius > TerrainGridMaxRadius )
+    {
+        radius = TerrainGridMaxRadius;
+    }
+    // Discard the rasters of any previous call
+    delete[] m_slope;   m_slope = 0;
+    delete[] m_aspect;  m_aspect = 0;
+    delete[] m_rvElev;  m_rvElev = 0;
+    delete[] m_rvDist;  m_rvDist = 0;
+    computeSlopeAspect();
+    computeRidgeToValley( radius );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Computes the ridge-to-valley rasters.
+ *
+ *  Each cell's ridge and valley are the highest and lowest cells within the
+ *  (2*radius+1) square window centered on the cell.  The window maximum and
+ *  minimum are separable, so each row is first reduced across columns into
+ *  a ring of 2*radius+1 rows, and each output row then reduces that ring
+ *  down the columns.  Both passes keep the location of the extreme cell so
+ *  the ridge-to-valley horizontal distance can be determined.
+ *
+ *  \param radius Window radius (cells).
+ */
+
+void TerrainGrid::computeRidgeToValley( int radius )
+{
+    int cells = m_rows * m_cols;
+    m_rvElev = new float[ cells ];
+    checkmem( __FILE__, __LINE__, m_rvElev, "float m_rvElev", cells );
+    m_rvDist = new float[ cells ];
+    checkmem( __FILE__, __LINE__, m_rvDist, "float m_rvDist", cells );
+
+    // Padded row buffers and the ring of row-reduced values
+    int w = 2 * radius + 1;
+    int pad = m_cols + 2 * radius;
+    float *pmax = new float[ pad ];
+    checkmem( __FILE__, __LINE__, pmax, "float pmax", pad );
+    float *pmin = new float[ pad ];
+    checkmem( __FILE__, __LINE__, pmin, "float pmin", pad );
+    float *rmaxV = new float[ w * m_cols ];
+    checkmem( __FILE__, __LINE__, rmaxV, "float rmaxV", w * m_cols );
+    float *rminV = new float[ w * m_cols ];
+    checkmem( __FILE__, __LINE__, rminV, "float rminV", w * m_cols );
+    int *rmaxC = new int[ w * m_cols ];
+    checkmem( __FILE__, __LINE__, rmaxC, "int rmaxC", w * m_cols );
+    int *rminC = new int[ w * m_cols ];
+    checkmem( __FILE__, __LINE__, rminC, "int rminC", w * m_cols );
+    // Column reduction accumulators
+    float *cmaxV = new float[ m_cols ];
+    checkmem( __FILE__, __LINE__, cmaxV, "float cmaxV", m_cols );
+    float *cminV = new float[ m_cols ];
+    checkmem( __FILE__, __LINE__, cminV, "float cminV", m_cols );
+    int *cmaxR = new int[ 4 * m_cols ];
+    checkmem( __FILE__, __LINE__, cmaxR, "int cmaxR", 4 * m_cols );
+    int *cmaxC = cmaxR + m_cols;
+    int *cminR = cmaxC + m_cols;
+    int *cminC = cminR + m_cols;
+
+    int i, k, c, row, rr, first, last, slot;
+    int filled = 0;
+    bool take;
+    float v;
+    double dr, dc;
+    for ( row = 0;
+          row < m_rows;
+          row++ )
+    {
+        // Reduce across columns every row that enters the window
+        last = ( row + radius < m_rows ) ? ( row + radius ) : ( m_rows - 1 );
+        for ( ;
+              filled <= last;
+              filled++ )
+        {
+            const float *z = m_elev + filled * m_cols;
+            for ( i = 0;
+                  i < pad;
+                  i++ )
+            {
+                pmax[i] = -FLT_MAX;
+                pmin[i] = FLT_MAX;
+            }
+            for ( c = 0;
+                  c < m_cols;
+                  c++ )
+            {
+                if ( z[c] != m_noData )
+                {
+                    pmax[c+radius] = pmin[c+radius] = z[c];
+                }
+            }
+            slot = ( filled % w ) * m_cols;
+            float *maxV = rmaxV + slot;
+            float *minV = rminV + slot;
+            int   *maxC = rmaxC + slot;
+            int   *minC = rminC + slot;
+            for ( c = 0;
+                  c < m_cols;
+                  c++ )
+            {
+                maxV[c] = pmax[c];
+                minV[c] = pmin[c];
+                maxC[c] = minC[c] = c - radius;
+            }
+            for ( k = 1;
+                  k < w;
+                  k++ )
+            {
+                for ( c = 0;
+                      c < m_cols;
+                      c++ )
+                {
+                    v = pmax[c+k];
+                    take = v > maxV[c];
+                    maxV[c] = take ? v : maxV[c];
+                    maxC[c] = take ? ( c + k - radius ) : maxC[c];
+                    v = pmin[c+k];
+                    take = v < minV[c];
+                    minV[c] = take ? v : minV[c];
+                    minC[c] = take ? ( c + k - radius ) : minC[c];
+                }
+            }
+        }
+        // Reduce the ring down the columns
+        first = ( row - radius > 0 ) ? ( row - radius ) : 0;
+        for ( c = 0;
+              c < m_cols;
+              c++ )
+        {
+            cmaxV[c] = -FLT_MAX;
+            cminV[c] = FLT_MAX;
+            cmaxR[c] = cmaxC[c] = cminR[c] = cminC[c] = 0;
+        }
+        for ( rr = first;
+              rr <= last;
+              rr++ )
+        {
+            slot = ( rr % w ) * m_cols;
+            const float *maxV = rmaxV + slot;
+            const float *minV = rminV + slot;
+            const int   *maxC = rmaxC + slot;
+            const int   *minC = rminC + slot;
+            for ( c = 0;
+                  c < m_cols;
+                  c++ )
+            {
+                take = maxV[c] > cmaxV[c];
+                cmaxV[c] = take ? maxV[c] : cmaxV[c];
+                cmaxR[c] = take ? rr : cmaxR[c];
+                cmaxC[c] = take ? maxC[c] : cmaxC[c];
+                take = minV[c] < cminV[c];
+                cminV[c] = take ? minV[c] : cminV[c];
+                cminR[c] = take ? rr : cminR[c];
+                cminC[c] = take ? minC[c] : cminC[c];
+            }
+        }
+        // Store the ridge-to-valley elevation and distance
+        const float *z = m_elev + row * m_cols;
+        float *rvElev = m_rvElev + row * m_cols;
+        float *rvDist = m_rvDist + row * m_cols;
+        for ( c = 0;
+              c < m_cols;
+              c++ )
+        {
+            if ( z[c] == m_noData )
+            {
+                rvElev[c] = rvDist[c] = m_noData;
+                continue;
+            }
+            dr = (double) ( cmaxR[c] - cminR[c] );
+            dc = (double) ( cmaxC[c] - cminC[c] );
+            rvElev[c] = cmaxV[c] - cminV[c];
+            rvDist[c] = (float) ( m_cellSize * sqrt( dr * dr + dc * dc ) );
+        }
+    }
+    delete[] pmax;
+    delete[] pmin;
+    delete[] rmaxV;
+    delete[] rminV;
+    delete[] rmaxC;
+    delete[] rminC;
+    delete[] cmaxV;
+    delete[] cminV;
+    delete[] cmaxR;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Computes the slope and aspect rasters by Horn's method.
+ *
+ *  Grid edge cells use their own elevation in place of the missing
+ *  neighbors, so their differences across the edge span one cell rather
+ *  than two and are scaled by twice the interior factor.  Cells with any
+ *  missing elevation in their 3x3 neighborhood are flagged as m_noData.
+ */
+
+void TerrainGrid::computeSlopeAspect( void )
+{
+    int cells = m_rows * m_cols;
+    m_slope = new float[ cells ];
+    checkmem( __FILE__, __LINE__, m_slope, "float m_slope", cells );
+    m_aspect = new float[ cells ];
+    checkmem( __FILE__, __LINE__, m_aspect, "float m_aspect", cells );
+    float *zx = new float[ 2 * m_cols ];
+    checkmem( __FILE__, __LINE__, zx, "float zx", 2 * m_cols );
+    float *zy = zx + m_cols;
+
+    float k = (float) ( 1. / ( 8. * m_cellSize ) );
+    // One-sided differences across the grid edges
+    float kx = ( m_cols > 1 ) ? 2.f * k : k;
+    float ky;
+    double dx, dy, a;
+    int row, c;
+    for ( row = 0;
+          row < m_rows;
+          row++ )
+    {
+        const float *up = m_elev + ( ( row > 0 ) ? ( row - 1 ) : row ) * m_cols;
+        const float *md = m_elev + row * m_cols;
+        const float *dn = m_elev
+            + ( ( row < m_rows - 1 ) ? ( row + 1 ) : row ) * m_cols;
+        ky = ( m_rows > 1 && ( row == 0 || row == m_rows - 1 ) ) ? 2.f * k : k;
+        // Gradients of the interior columns
+        for ( c = 1;
+              c < m_cols - 1;
+              c++ )
+        {
+            zx[c] = ( ( up[c+1] + 2.f * md[c+1] + dn[c+1] )
+                    - ( up[c-1] + 2.f * md[c-1] + dn[c-1] ) ) * k;
+            zy[c] = ( ( up[c-1] + 2.f * up[c] + up[c+1] )
+                    - ( dn[c-1] + 2.f * dn[c] + dn[c+1] ) ) * ky;
+        }
+        // Gradients of the edge columns
+        hornCell( up, md, dn, 0, 0, ( m_cols > 1 ) ? 1 : 0, kx, ky, &dx, &dy );
+        zx[0] = (float) dx;
+        zy[0] = (float) dy;
+        c = m_cols - 1;
+        hornCell( up, md, dn, ( c > 0 ) ? ( c - 1 ) : 0, c, c, kx, ky,
+            &dx, &dy );
+        zx[c] = (float) dx;
+        zy[c] = (float) dy;
+        // Slope and aspect
+        float *slope = m_slope + row * m_cols;
+        float *aspect = m_aspect + row * m_cols;
+        for ( c = 0;
+              c < m_cols;
+              c++ )
+        {
+            slope[c] = (float) sqrt( zx[c] * zx[c] + zy[c] * zy[c] );
+            a = atan2( -zx[c], -zy[c] ) * TerrainRadToDeg;
+            aspect[c] = (float) ( ( a < 0. ) ? ( a + 360. ) : a );
+        }
+    }
+    delete[] zx;
+
+    // Flag cells whose neighborhood is missing an elevation
+    if ( m_noDataCells == 0 )
+    {
+        return;
+    }
+    int r, rr, cc;
+    for ( row = 0;
+          row < m_rows;
+          row++ )
+    {
+        for ( c = 0;
+              c < m_cols;
+              c++ )
+        {
+            for ( r = row - 1;
+                  r <= row + 1;
+                  r++ )
+            {
+                rr = ( r < 0 ) ? 0 : ( ( r >= m_rows ) ? m_rows - 1 : r );
+                for ( cc = c - 1;
+                      cc <= c + 1;
+                      cc++ )
+                {
+                    if ( cc >= 0 && cc < m_cols
+                      && m_elev[rr * m_cols + cc] == m_noData )
+                    {
+                        m_slope[row * m_cols + c] = m_noData;
+                        m_aspect[row * m_cols + c] = m_noData;
+                    }
+                }
+            }
+        }
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Frees all the raster arrays.
+ */
+
+void TerrainGrid::freeRasters( void )
+{
+    delete[] m_elev;    m_elev = 0;
+    delete[] m_slope;   m_slope = 0;
+    delete[] m_aspect;  m_aspect = 0;
+    delete[] m_rvElev;  m_rvElev = 0;
+    delete[] m_rvDist;  m_rvDist = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines if a grid cell has no elevation.
+ *
+ *  \param row Cell row.
+ *  \param col Cell column.
+ *
+ *  \return TRUE if the cell has no elevation.
+ */
+
+bool TerrainGrid::isNoData( int row, int col ) const
+{
+    return( m_elev[row * m_cols + col] == m_noData );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Reads an ESRI ASCII elevation grid file.
+ *
+ *  The header must specify \a ncols, \a nrows, \a xllcorner or \a xllcenter,
+ *  \a yllcorner or \a yllcenter, and \a cellsize; \a nodata_value is
+ *  optional and defaults to -9999.
+ *
+ *  \param fileName Name of the grid file.
+ *  \param errMsg   Returned error message.
+ *
+ *  \return TRUE if the grid was successfully read.
+ */
+
+bool TerrainGrid::read( const QString &fileName, QString &errMsg )
+{
+    errMsg = "";
+    freeRasters();
+    m_rows = m_cols = m_noDataCells = 0;
+    m_noData = -9999.;
+    FILE *fptr = fopen( fileName.latin1(), "rb" );
+    if ( ! fptr )
+    {
+        translate( errMsg, "TerrainGrid:NoOpen", fileName );
+        return( false );
+    }
+    char *buffer = new char[ TerrainGridBufferSize ];
+    checkmem( __FILE__, __LINE__, buffer, "char buffer",
+        TerrainGridBufferSize );
+    char token[64];
+    int pos = 0;
+    int len = 0;
+
+    // Read the header keyword-value pairs
+    bool xCenter = false;
+    bool yCenter = false;
+    bool ok = true;
+    bool more;
+    QString key;
+    while ( ( more = readToken( fptr, buffer, &pos, &len, token,
+                sizeof(token) ) ) && isalpha( (unsigned char) token[0] ) )
+    {
+        key = QString( token ).lower();
+        if ( ! readToken( fptr, buffer, &pos, &len, token, sizeof(token) ) )
+        {
+            ok = false;
+            break;
+        }
+        if ( key == "ncols" )
+        {
+            m_cols = atoi( token );
+        }
+        else if ( key == "nrows" )
+        {
+            m_rows = atoi( token );
+        }
+        else if ( key == "xllcorner" || key == "xllcenter" )
+        {
+            m_xll = atof( token );
+            xCenter = ( key == "xllcenter" );
+        }
+        else if ( key == "yllcorner" || key == "yllcenter" )
+        {
+            m_yll = atof( token );
+            yCenter = ( key == "yllcenter" );
+        }
+        else if ( key == "cellsize" )
+        {
+            m_cellSize = atof( token );
+        }
+        else if ( key == "nodata_value" )
+        {
+            m_noData = (float) atof( token );
+        }
+    }
+    if ( ! ok || ! more || m_rows < 1 || m_cols < 1 || m_cellSize <= 0. )
+    {
+        translate( errMsg, "TerrainGrid:BadHeader", fileName );
+        delete[] buffer;
+        fclose( fptr );
+        return( false );
+    }
+    // Store the lower left corner rather than the lower left cell center
+    if ( xCenter )
+    {
+        m_xll -= 0.5 * m_cellSize;
+    }
+    if ( yCenter )
+    {
+        m_yll -= 0.5 * m_cellSize;
+    }
+
+    // Read the elevations; the first one is already in the token
+    int cells = m_rows * m_cols;
+    m_elev = new float[ cells ];
+    checkmem( __FILE__, __LINE__, m_elev, "float m_elev", cells );
+    char *end;
+    int i;
+    for ( i = 0;
+          i < cells;
+          i++ )
+    {
+        if ( i > 0
+          && ! readToken( fptr, buffer, &pos, &len, token, sizeof(token) ) )
+        {
+            translate( errMsg, "TerrainGrid:Short", fileName,
+                QString( "%1" ).arg( i ), QString( "%1" ).arg( cells ) );
+            break;
+        }
+        m_elev[i] = (float) strtod( token, &end );
+        if ( *end != '\0' )
+        {
+            translate( errMsg, "TerrainGrid:BadValue", fileName,
+                QString( "%1" ).arg( i / m_cols + 1 ),
+                QString( "%1" ).arg( i % m_cols + 1 ), token );
+            break;
+        }
+        if ( m_elev[i] == m_noData )
+        {
+            m_noDataCells++;
+        }
+    }
+    delete[] buffer;
+    fclose( fptr );
+    if ( i < cells )
+    {
+        freeRasters();
+        return( false );
+    }
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+//  End of terraingrid.cpp
+//------------------------------------------------------------------------------
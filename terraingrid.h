@@ -0,0 +1,88 @@
+//------------------------------------------------------------------------------
+/*! \file terraingrid.h
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief TerrainGrid class declaration.
+ *
+ *  A TerrainGrid reads an ESRI ASCII elevation grid and derives the site
+ *  terrain rasters used as worksheet inputs:
+ *      -# slope steepness (rise/reach fraction) and aspect (degrees clockwise
+ *         from north) by Horn's 3x3 finite difference method, and
+ *      -# ridge-to-valley elevation difference and horizontal distance, from
+ *         the highest and lowest cells within a square window about each
+ *         cell.
+ *
+ *  The grid must be in a projected coordinate system whose horizontal units
+ *  are the same as its elevation units.  All rasters are stored as floats
+ *  so that grids of tens of millions of cells fit comfortably in memory.
+ *
+ *  The kernels sweep the grid one row at a time so that only a few rows are
+ *  ever in cache, and their inner loops run across the interior columns
+ *  without branches so the compiler can vectorize them.  check() recomputes
+ *  sample edge and interior cells with the plain scalar formulae for
+ *  comparison.
+ */
+
+#ifndef _TERRAINGRID_H_
+/*! \def _TERRAINGRID_H_
+ *  \brief Prevent redundant includes.
+ */
+#define _TERRAINGRID_H_ 1
+
+// Qt include files
+#include <qstring.h>
+
+/*! \var TerrainGridMaxRadius
+ *  \brief Maximum ridge-to-valley window radius (cells).
+ */
+static const int TerrainGridMaxRadius = 50;
+
+//------------------------------------------------------------------------------
+/*! \class TerrainGrid terraingrid.h
+ *
+ *  \brief Elevation grid with derived slope, aspect, and ridge-to-valley
+ *  rasters.
+ */
+
+class TerrainGrid
+{
+// Public methods
+public:
+    TerrainGrid( void ) ;
+    ~TerrainGrid( void ) ;
+    bool   cell( double x, double y, int *row, int *col ) const ;
+    double check( double *aspectDiff, int samples=1000 ) const ;
+    void   compute( int radius ) ;
+    bool   isNoData( int row, int col ) const ;
+    bool   read( const QString &fileName, QString &errMsg ) ;
+
+// Private methods
+private:
+    void   checkCell( int row, int col, double *slopeDiff,
+                double *aspectDiff ) const ;
+    void   computeRidgeToValley( int radius ) ;
+    void   computeSlopeAspect( void ) ;
+    void   freeRasters( void ) ;
+
+// Public data
+public:
+    int     m_rows;         //!< Number of grid rows (row 0 is the north edge)
+    int     m_cols;         //!< Number of grid columns (column 0 is the west edge)
+    int     m_noDataCells;  //!< Number of cells without an elevation
+    double  m_xll;          //!< X coordinate of the lower left grid corner
+    double  m_yll;          //!< Y coordinate of the lower left grid corner
+    double  m_cellSize;     //!< Cell size (grid units)
+    float   m_noData;       //!< Value flagging cells without data
+    float  *m_elev;         //!< Elevation (grid units)
+    float  *m_slope;        //!< Slope steepness (rise/reach fraction)
+    float  *m_aspect;       //!< Aspect (degrees clockwise from north)
+    float  *m_rvElev;       //!< Ridge-to-valley elevation difference (grid units)
+    float  *m_rvDist;       //!< Ridge-to-valley horizontal distance (grid units)
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of terraingrid.h
+//------------------------------------------------------------------------------
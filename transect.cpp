@@ -0,0 +1,281 @@
+//------------------------------------------------------------------------------
+/*! \file transect.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Fire transect segments used by the transect run.
+ */
+
+// Custom include files
+#include "appmessage.h"
+#include "apptranslator.h"
+#include "transect.h"
+
+// Qt include files
+#include <qmap.h>
+#include <qstringlist.h>
+
+// Standard include files
+#include <stdio.h>
+
+//------------------------------------------------------------------------------
+/*! \brief Transect constructor.
+ */
+
+Transect::Transect( void ) :
+    m_fileName(""),
+    m_segments(0),
+    m_length(0),
+    m_state(0),
+    m_line(0),
+    m_inputs(0),
+    m_states(0),
+    m_stateSegment(0),
+    m_value(0),
+    m_stateSize(0)
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Transect destructor.
+ */
+
+Transect::~Transect( void )
+{
+    clear();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Deletes all the segments and input states.
+ */
+
+void Transect::clear( void )
+{
+    delete[] m_length;          m_length = 0;
+    delete[] m_state;           m_state = 0;
+    delete[] m_line;            m_line = 0;
+    delete[] m_stateSegment;    m_stateSegment = 0;
+    delete[] m_value;           m_value = 0;
+    m_segments = m_inputs = m_states = m_stateSize = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Splits a transect file line into its length and assignment tokens.
+ *
+ *  \param buffer   Line read from the file.
+ *  \param tokens   Reference to the list to hold the tokens.
+ *
+ *  \return FALSE if the line is blank or a comment.
+ */
+
+static bool transectTokens( const char *buffer, QStringList &tokens )
+{
+    QString line = QString( buffer ).simplifyWhiteSpace();
+    if ( line.isEmpty() || line[0] == '#' )
+    {
+        return( false );
+    }
+    tokens = QStringList::split( ' ', line );
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Reads the segments from a transect file.
+ *
+ *  The file is read twice; first to find the segment count and the input
+ *  variable names, then to build the segments' input states.
+ *
+ *  \param fileName Name of the transect file.
+ *  \param errMsg   Reference to a string to hold any error message.
+ *
+ *  \return TRUE on success, FALSE on error (and \a errMsg is set).
+ */
+
+bool Transect::read( const QString &fileName, QString &errMsg )
+{
+    clear();
+    errMsg = "";
+    m_fileName = fileName;
+    FILE *fptr = fopen( fileName.latin1(), "r" );
+    if ( ! fptr )
+    {
+        translate( errMsg, "Transect:NoOpen", fileName );
+        return( false );
+    }
+    // First pass validates each line and collects the input names
+    char buffer[8192];
+    QStringList tokens;
+    QStringList::Iterator it;
+    int line = 0;
+    int pos, i;
+    bool ok;
+    double length;
+    QString name("");
+    while ( fgets( buffer, sizeof(buffer), fptr ) )
+    {
+        line++;
+        if ( ! transectTokens( buffer, tokens ) )
+        {
+            continue;
+        }
+        if ( m_segments >= TransectMaxSegments )
+        {
+            translate( errMsg, "Transect:TooManySegments", fileName,
+                QString( "%1" ).arg( TransectMaxSegments ) );
+            fclose( fptr );
+            return( false );
+        }
+        it = tokens.begin();
+        length = (*it).toDouble( &ok );
+        ok = ok && length > 0.;
+        for ( ++it;
+              ok && it != tokens.end();
+              ++it )
+        {
+            pos = (*it).find( '=' );
+            ok = ( pos > 0 && pos < (int) (*it).length() - 1 );
+            name = (*it).left( pos );
+            for ( i = 0;
+                  ok && i < m_inputs && m_input[i] != name;
+                  i++ )
+            {
+                /* NOTHING */ ;
+            }
+            if ( ok && i == m_inputs )
+            {
+                if ( m_inputs >= TransectMaxInputs )
+                {
+                    translate( errMsg, "Transect:TooManyInputs", fileName,
+                        QString( "%1" ).arg( TransectMaxInputs ) );
+                    fclose( fptr );
+                    return( false );
+                }
+                m_input[m_inputs++] = name;
+            }
+        }
+        if ( ! ok )
+        {
+            translate( errMsg, "Transect:BadLine", fileName,
+                QString( "%1" ).arg( line ) );
+            fclose( fptr );
+            return( false );
+        }
+        m_segments++;
+    }
+    if ( m_segments == 0 )
+    {
+        translate( errMsg, "Transect:Empty", fileName );
+        fclose( fptr );
+        return( false );
+    }
+    // Allocate the segment arrays
+    m_length = new double[ m_segments ];
+    checkmem( __FILE__, __LINE__, m_length, "double m_length", m_segments );
+    m_state = new int[ m_segments ];
+    checkmem( __FILE__, __LINE__, m_state, "int m_state", m_segments );
+    m_line = new int[ m_segments ];
+    checkmem( __FILE__, __LINE__, m_line, "int m_line", m_segments );
+    m_stateSegment = new int[ m_segments ];
+    checkmem( __FILE__, __LINE__, m_stateSegment, "int m_stateSegment",
+        m_segments );
+
+    // Second pass builds each segment's input state
+    QString current[TransectMaxInputs];
+    QMap<QString,int> stateMap;
+    QMap<QString,int>::Iterator found;
+    QString key("");
+    int seg = 0;
+    rewind( fptr );
+    line = 0;
+    while ( fgets( buffer, sizeof(buffer), fptr ) && seg < m_segments )
+    {
+        line++;
+        if ( ! transectTokens( buffer, tokens ) )
+        {
+            continue;
+        }
+        it = tokens.begin();
+        m_length[seg] = (*it).toDouble();
+        m_line[seg] = line;
+        for ( ++it;
+              it != tokens.end();
+              ++it )
+        {
+            pos = (*it).find( '=' );
+            name = (*it).left( pos );
+            for ( i = 0;
+                  m_input[i] != name;
+                  i++ )
+            {
+                /* NOTHING */ ;
+            }
+            current[i] = (*it).mid( pos + 1 );
+        }
+        // Find or add this segment's input state
+        key = "";
+        for ( i = 0;
+              i < m_inputs;
+              i++ )
+        {
+            key += current[i] + "\t";
+        }
+        if ( ( found = stateMap.find( key ) ) != stateMap.end() )
+        {
+            m_state[seg] = found.data();
+        }
+        else
+        {
+            if ( m_states == m_stateSize )
+            {
+                m_stateSize = ( m_stateSize ) ? 2 * m_stateSize : 64;
+                QString *value = new QString[ m_stateSize * m_inputs + 1 ];
+                checkmem( __FILE__, __LINE__, value, "QString value",
+                    m_stateSize * m_inputs + 1 );
+                for ( i = 0;
+                      i < m_states * m_inputs;
+                      i++ )
+                {
+                    value[i] = m_value[i];
+                }
+                delete[] m_value;
+                m_value = value;
+            }
+            for ( i = 0;
+                  i < m_inputs;
+                  i++ )
+            {
+                m_value[ m_states * m_inputs + i ] = current[i];
+            }
+            m_stateSegment[m_states] = seg;
+            stateMap.insert( key, m_states );
+            m_state[seg] = m_states++;
+        }
+        seg++;
+    }
+    fclose( fptr );
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the value assigned to an input variable by an input
+ *  state.
+ *
+ *  \param state    Input state index [0..m_states-1].
+ *  \param input    Input variable index [0..m_inputs-1].
+ *
+ *  \return The assigned value, or an empty string if the input keeps its
+ *  worksheet value.
+ */
+
+const QString &Transect::value( int state, int input ) const
+{
+    return( m_value[ state * m_inputs + input ] );
+}
+
+//------------------------------------------------------------------------------
+//  End of transect.cpp
+//------------------------------------------------------------------------------
+
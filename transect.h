@@ -0,0 +1,92 @@
+//------------------------------------------------------------------------------
+/*! \file transect.h
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Fire transect segments used by the transect run.
+ *
+ *  A transect file is a plain text file describing an ordered sequence of
+ *  segments along a fire's path (from a road to a ridge top, for example),
+ *  one segment per line.  Blank lines and lines beginning with '#' are
+ *  ignored.  Each segment line has the segment length (ft) followed by
+ *  any number of white space delimited input assignments of the form
+ *  \c name=value, such as
+ *  \code
+ *  # length vars...
+ *  300 vSurfaceFuelBedModel=gr2 vSiteSlopeFraction=10
+ *  450 vSurfaceFuelBedModel=tu5
+ *  120 vSiteSlopeFraction=45 vWindSpeedAtMidflame=6
+ *  \endcode
+ *  Each name is a worksheet input variable, and each value is in its
+ *  current worksheet display units (or is an item name for discrete
+ *  variables).  A segment keeps every assignment of the segments before it
+ *  that it does not override; inputs never assigned keep their worksheet
+ *  values.
+ *
+ *  Segments whose resulting inputs are identical share a single input
+ *  state, so each distinct state need only be evaluated once.
+ */
+
+#ifndef _TRANSECT_H_
+/*! \def _TRANSECT_H_
+ *  \brief Prevent redundant includes.
+ */
+#define _TRANSECT_H_ 1
+
+// Qt include files
+#include <qstring.h>
+
+/*! \var TransectMaxSegments
+ *  \brief Maximum number of segments in a transect.
+ */
+static const int TransectMaxSegments = 100000;
+
+/*! \var TransectMaxInputs
+ *  \brief Maximum number of distinct input variables assigned by a transect.
+ */
+static const int TransectMaxInputs = 32;
+
+//------------------------------------------------------------------------------
+/*! \class Transect transect.h
+ *
+ *  \brief Fire transect segments read from a transect file.
+ */
+
+class Transect
+{
+// Public methods
+public:
+    Transect( void ) ;
+    ~Transect( void ) ;
+    bool read( const QString &fileName, QString &errMsg ) ;
+    const QString &value( int state, int input ) const ;
+
+// Private methods
+private:
+    void clear( void ) ;
+
+// Public data
+public:
+    QString  m_fileName;    //!< Name of the transect file
+    int      m_segments;    //!< Number of segments
+    double  *m_length;      //!< Length of each segment (ft)
+    int     *m_state;       //!< Input state of each segment
+    int     *m_line;        //!< File line number of each segment
+    int      m_inputs;      //!< Number of input variables assigned
+    QString  m_input[TransectMaxInputs];    //!< Input variable names
+    int      m_states;      //!< Number of distinct input states
+    int     *m_stateSegment;//!< First segment with each input state
+
+// Private data
+private:
+    QString *m_value;       //!< m_states by m_inputs assigned values
+                            //!< (empty if the worksheet value is used)
+    int      m_stateSize;   //!< Number of states allocated in m_value[]
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of transect.h
+//------------------------------------------------------------------------------
+
@@ -0,0 +1,206 @@
+//------------------------------------------------------------------------------
+/*! \file wthrseries.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Hourly weather series used by the hourly scenario run.
+ */
+
+// Custom include files
+#include "apptranslator.h"
+#include "wthrseries.h"
+#include "xfblib.h"
+
+// Standard include files
+#include <stdio.h>
+
+//------------------------------------------------------------------------------
+/*! \brief Determines if one observation time is exactly one hour after
+ *  another.
+ *
+ *  \param month0, day0, hour0 Earlier observation time.
+ *  \param month1, day1, hour1 Later observation time.
+ *
+ *  \return TRUE if the later time is the hour after the earlier time.
+ */
+
+static bool nextHour( int month0, int day0, int hour0,
+        int month1, int day1, int hour1 )
+{
+    // Days per month (February may also have 29)
+    static const int Days[13] =
+        { 0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    if ( hour0 < 23 )
+    {
+        return( month1 == month0 && day1 == day0 && hour1 == hour0 + 1 );
+    }
+    if ( hour1 != 0 )
+    {
+        return( false );
+    }
+    if ( month1 == month0 && day1 == day0 + 1 )
+    {
+        return( true );
+    }
+    bool lastDay = ( day0 == Days[month0] || ( month0 == 2 && day0 == 29 ) );
+    return( lastDay && day1 == 1 && month1 == ( month0 % 12 ) + 1 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief WthrSeries constructor.
+ */
+
+WthrSeries::WthrSeries( void ) :
+    m_fileName(""),
+    m_hours(0)
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief WthrSeries destructor.
+ */
+
+WthrSeries::~WthrSeries( void )
+{
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Derives the fine dead fuel moisture for every observation
+ *  that did not supply its own value.
+ *
+ *  \param elevation Site elevation relative to the weather observations
+ *                   (-1=below, 0=level, 1=above).
+ *  \param slope     Site slope steepness (rise/reach).
+ *  \param aspect    Site aspect (degrees clockwise from north).
+ *  \param shaded    TRUE if fuels are 50% or more shaded from the sun.
+ */
+
+void WthrSeries::deriveFdfmc( int elevation, double slope, double aspect,
+        bool shaded )
+{
+    for ( int hr = 0;
+          hr < m_hours;
+          hr++ )
+    {
+        if ( ! m_fdfmcRead[hr] )
+        {
+            m_fdfmc[hr] = FBL_FineDeadFuelMoisture( m_dryBulb[hr], m_rh[hr],
+                m_month[hr], m_hour[hr], elevation, slope, aspect, shaded );
+        }
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the elapsed hour of an observation.
+ *
+ *  Elapsed hours are counted from midnight of the first observation's day,
+ *  so a series starting at 06:00 yields 6, 7, 8, ... 29, 30, ...
+ *  This relies on read() accepting only consecutive hours.
+ *
+ *  \param hour Observation index [0..m_hours-1].
+ *
+ *  \return Elapsed hours since midnight of the first observation's day.
+ */
+
+double WthrSeries::elapsedHour( int hour ) const
+{
+    return( (double) ( m_hour[0] + hour ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Reads the hourly observations from a weather series file.
+ *
+ *  Each observation must be the hour after the previous one, so gaps,
+ *  repeated hours and out-of-order hours are rejected.
+ *
+ *  \param fileName Name of the weather series file.
+ *  \param errMsg   Reference to a string to hold any error message.
+ *
+ *  \return TRUE on success, FALSE on error (and \a errMsg is set).
+ */
+
+bool WthrSeries::read( const QString &fileName, QString &errMsg )
+{
+    errMsg = "";
+    m_fileName = fileName;
+    m_hours = 0;
+    FILE *fptr = fopen( fileName.latin1(), "r" );
+    if ( ! fptr )
+    {
+        translate( errMsg, "WthrSeries:NoOpen", fileName );
+        return( false );
+    }
+    char buffer[1024], *ptr;
+    int line = 0;
+    int fields, month, day, hour;
+    double db, rh, ws, wd, fm;
+    while ( fgets( buffer, sizeof(buffer), fptr ) )
+    {
+        line++;
+        // Skip leading white space, blank lines, and comment lines
+        for ( ptr = buffer; *ptr == ' ' || *ptr == '\t'; ptr++ )
+        {
+            /* NOTHING */ ;
+        }
+        if ( *ptr == '#' || *ptr == '\n' || *ptr == '\r' || *ptr == '\0' )
+        {
+            continue;
+        }
+        if ( m_hours >= WthrSeriesMaxHours )
+        {
+            translate( errMsg, "WthrSeries:TooManyHours", fileName,
+                QString( "%1" ).arg( WthrSeriesMaxHours ) );
+            fclose( fptr );
+            return( false );
+        }
+        fields = sscanf( ptr, "%d %d %d %lf %lf %lf %lf %lf",
+            &month, &day, &hour, &db, &rh, &ws, &wd, &fm );
+        if ( fields < 7
+          || month < 1 || month > 12
+          || day < 1 || day > 31
+          || hour < 0 || hour > 23
+          || rh < 0. || rh > 100.
+          || ws < 0.
+          || wd < 0. || wd > 360.
+          || ( fields == 8 && fm <= 0. ) )
+        {
+            translate( errMsg, "WthrSeries:BadLine", fileName,
+                QString( "%1" ).arg( line ) );
+            fclose( fptr );
+            return( false );
+        }
+        if ( m_hours > 0
+          && ! nextHour( m_month[m_hours-1], m_day[m_hours-1],
+                         m_hour[m_hours-1], month, day, hour ) )
+        {
+            translate( errMsg, "WthrSeries:NotConsecutive", fileName,
+                QString( "%1" ).arg( line ) );
+            fclose( fptr );
+            return( false );
+        }
+        m_month[m_hours]     = month;
+        m_day[m_hours]       = day;
+        m_hour[m_hours]      = hour;
+        m_dryBulb[m_hours]   = db;
+        m_rh[m_hours]        = rh;
+        m_wind[m_hours]      = ws;
+        m_windDir[m_hours]   = wd;
+        m_fdfmc[m_hours]     = ( fields == 8 ) ? ( 0.01 * fm ) : 0.;
+        m_fdfmcRead[m_hours] = ( fields == 8 );
+        m_hours++;
+    }
+    fclose( fptr );
+    if ( m_hours == 0 )
+    {
+        translate( errMsg, "WthrSeries:Empty", fileName );
+        return( false );
+    }
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+//  End of wthrseries.cpp
+//------------------------------------------------------------------------------
@@ -0,0 +1,79 @@
+//------------------------------------------------------------------------------
+/*! \file wthrseries.h
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Hourly weather series used by the hourly scenario run.
+ *
+ *  A weather series file is a plain text file with one hourly observation
+ *  per line.  Blank lines and lines beginning with '#' are ignored.
+ *  Each observation has 7 or 8 white space delimited fields:
+ *      -# month of the year (1-12),
+ *      -# day of the month (1-31),
+ *      -# hour of the day (0-23),
+ *      -# dry bulb air temperature (oF),
+ *      -# relative humidity (%),
+ *      -# wind speed (mi/h) at the worksheet's wind speed input height,
+ *      -# wind direction (degrees clockwise) in the worksheet's wind
+ *         direction convention (from north or from upslope), and optionally
+ *      -# fine dead fuel moisture (%).
+ *
+ *  If the fine dead fuel moisture field is omitted, it is derived from the
+ *  temperature and humidity by FBL_FineDeadFuelMoisture().
+ *
+ *  Observations must be consecutive hours in time order; each one must be
+ *  exactly one hour after the previous one (a month's last day may be
+ *  followed by the first day of the next month).
+ */
+
+#ifndef _WTHRSERIES_H_
+/*! \def _WTHRSERIES_H_
+ *  \brief Prevent redundant includes.
+ */
+#define _WTHRSERIES_H_ 1
+
+// Qt include files
+#include <qstring.h>
+
+/*! \var WthrSeriesMaxHours
+ *  \brief Maximum number of hourly observations in a weather series.
+ */
+static const int WthrSeriesMaxHours = 240;
+
+//------------------------------------------------------------------------------
+/*! \class WthrSeries wthrseries.h
+ *
+ *  \brief Hourly weather observations read from a weather series file.
+ */
+
+class WthrSeries
+{
+// Public methods
+public:
+    WthrSeries( void ) ;
+    ~WthrSeries( void ) ;
+    void   deriveFdfmc( int elevation, double slope, double aspect,
+                bool shaded ) ;
+    double elapsedHour( int hour ) const ;
+    bool   read( const QString &fileName, QString &errMsg ) ;
+
+// Public data
+public:
+    QString m_fileName;     //!< Name of the weather series file
+    int     m_hours;        //!< Number of hourly observations
+    int     m_month[WthrSeriesMaxHours];    //!< Month of the year (1-12)
+    int     m_day[WthrSeriesMaxHours];      //!< Day of the month (1-31)
+    int     m_hour[WthrSeriesMaxHours];     //!< Hour of the day (0-23)
+    double  m_dryBulb[WthrSeriesMaxHours];  //!< Dry bulb temperature (oF)
+    double  m_rh[WthrSeriesMaxHours];       //!< Relative humidity (%)
+    double  m_wind[WthrSeriesMaxHours];     //!< Wind speed (mi/h)
+    double  m_windDir[WthrSeriesMaxHours];  //!< Wind direction from north (deg)
+    double  m_fdfmc[WthrSeriesMaxHours];    //!< Fine dead fuel moisture (fraction)
+    bool    m_fdfmcRead[WthrSeriesMaxHours];//!< TRUE if m_fdfmc[] was read
+};
+
+#endif
+
+//------------------------------------------------------------------------------
+//  End of wthrseries.h
+//------------------------------------------------------------------------------
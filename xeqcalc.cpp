@@ -30,9 +30,7 @@
 
 // Custom include files
 #include "appmessage.h"
-#include "appsiunits.h"
 #include "apptranslator.h"
-#include "bpdocument.h"
 #include "cdtlib.h"
 #include "contain.h"
 #include "fuelmodel.h"
@@ -53,8 +51,67 @@
 #include <math.h>
 
 static const int MaxParts = 8;
+static const int FuelBedKeys = 1 + 7 * MaxParts;
+static const int FuelBedValues = 4 + FBL_SurfaceFuelBedStateSize;
 static char Margin[] = { "        " };
 
+//------------------------------------------------------------------------------
+/*! \brief Gets the aspen fuel bed for the fuel type and curing level,
+ *  building it only if it is not among the recently used fuel beds.
+ *
+ *  \param typeIndex Index of the aspen fuel type.
+ *  \param curing    Curing level (fraction).
+ *
+ *  \return Pointer to the aspen fuel bed.
+ */
+
+SpecialFuelBed *EqCalc::aspenFuelBed( int typeIndex, double curing )
+{
+    double key[2];
+    key[0] = (double) typeIndex;
+    key[1] = curing;
+    bool found;
+    SpecialFuelBed *bed = &m_aspenBed[ m_aspenCache.find( key, &found ) ];
+    if ( ! found )
+    {
+        FBL_AspenFuelBed( typeIndex, curing, &bed->m_depth,
+            &bed->m_mextDead, bed->m_load, bed->m_savr );
+    }
+    return( bed );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Records a calculation failure.
+ *
+ *  If m_reportErrors is TRUE (as it is for the application's own EqTrees)
+ *  the failure is translated and passed to bomb().  Otherwise, as for
+ *  bpengine evaluators that may run on worker threads, only the first
+ *  failure's EqCalcStatus and input are kept in m_status and m_statusVar
+ *  for the caller to return.
+ *
+ *  \param status  EqCalcStatus code.
+ *  \param key     Translator key of the failure message.
+ *  \param arg     Message argument.
+ *  \param varPtr  Input variable whose value caused the failure.
+ */
+
+void EqCalc::calcFailed( int status, const char *key, const QString &arg,
+        EqVar *varPtr )
+{
+    if ( m_reportErrors )
+    {
+        QString text("");
+        translate( text, key, arg );
+        bomb( text );
+    }
+    if ( m_status == EqCalcOk )
+    {
+        m_status    = status;
+        m_statusVar = varPtr;
+    }
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Convenience routine to get a pointer to the FuelModel
  *  of the current vSurfaceFuelBedModel (if not doing two fuel model weighting)
@@ -66,7 +123,7 @@ static char Margin[] = { "        " };
  *      - 1 fetches a pointer to the current vSurfaceFuelBedModel1 FuelModel
  *      - 2 fetches a pointer to the current vSurfaceFuelBedModel2 FuelModel
  *
- *  \return Pointer to the current items FuelModel.
+ *  \return Pointer to the current items FuelModel, or 0 if it is not found.
  */
 
 FuelModel *EqCalc::currentFuelModel( int id )
@@ -91,13 +148,43 @@ FuelModel *EqCalc::currentFuelModel( int id )
     if ( ! fm )
     // This code block should never be executed!
     {
-        QString text("");
-        translate( text, "EqCalc:FuelModelNotFound", varPtr->activeItemName() );
-        bomb( text );
+        calcFailed( EqCalcFuelModelNotFound, "EqCalc:FuelModelNotFound",
+            name, varPtr );
     }
     return( fm );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Gets the palmetto-gallberry fuel bed for the generator inputs,
+ *  building it only if it is not among the recently used fuel beds.
+ *
+ *  \param age      Age of rough (years).
+ *  \param cover    Coverage of area by palmetto (percent).
+ *  \param height   Height of the understory (ft).
+ *  \param ba       Overstory basal area (ft2/ac).
+ *
+ *  \return Pointer to the palmetto-gallberry fuel bed.
+ */
+
+SpecialFuelBed *EqCalc::palmettoFuelBed( double age, double cover,
+        double height, double ba )
+{
+    double key[4];
+    key[0] = age;
+    key[1] = cover;
+    key[2] = height;
+    key[3] = ba;
+    bool found;
+    SpecialFuelBed *bed = &m_palmettoBed[ m_palmettoCache.find( key, &found ) ];
+    if ( ! found )
+    {
+        FBL_PalmettoGallberyFuelBed( age, cover, height, ba, &bed->m_depth,
+            bed->m_load );
+        bed->m_mextDead = 0.40;
+    }
+    return( bed );
+}
+
 //------------------------------------------------------------------------------
 /*! \brief ContainFF is Contain a'la Fried & Fried for multiple resources.
  *
@@ -167,67 +254,40 @@ void EqCalc::ContainFF( void )
     }
 
     // Build the containment resources array
-    ContainForce *force = new ContainForce();
-    checkmem( __FILE__, __LINE__, force, "ContainForce force", 1 );
-    Parser parserArr( " \t,\"", "", "" );
-    parserArr.parse( vContainResourceArrival->m_store );
-    Parser parserDur( " \t,\"", "", "" );
-    parserDur.parse( vContainResourceDuration->m_store );
+    // The ContainForce and its ContainResource records are reused by every
+    // cell, so they are only allocated once per EqCalc.
+    if ( ! m_containForce )
+    {
+        m_containForce = new ContainForce();
+        checkmem( __FILE__, __LINE__, m_containForce, "ContainForce m_containForce", 1 );
+    }
+    ContainForce *force = m_containForce;
+    force->clear();
+    // Resource names are text; all other resource values are parsed stores
     Parser parserName( " \t,\"", "", "" );
     parserName.parse( vContainResourceName->m_store );
-    Parser parserProd( " \t,\"", "", "" );
-    parserProd.parse( vContainResourceProd->m_store );
-
-    Parser parserBase( " \t,\"", "", "" );
-    Parser parserHour( " \t,\"", "", "" );
     bool doCost = vContainCost->m_isUserOutput;
-    if ( doCost )
-    {
-        parserBase.parse( vContainResourceBaseCost->m_store );
-        parserHour.parse( vContainResourceHourCost->m_store );
-    }
-    double arr, dur, prod, tmp;
+    double arr, dur, prod;
     double base = 0.;
     double hour = 0.;
     QString name;
     // Loop for each resource
     for ( int i=0; i<vContainResourceName->m_tokens; i++ )
     {
-        // Resource arrival time
-        tmp = parserArr.token( i ).toDouble();
-        appSiUnits()->convert( tmp,
-            vContainResourceArrival->m_displayUnits.latin1(),
-            vContainResourceArrival->m_nativeUnits.latin1(), &arr );
-        //fprintf( stderr, "Resource Arrival %f %s --> %f %s\n",
-        //  tmp, vContainResourceArrival->m_displayUnits.latin1(),
-        //    arr, vContainResourceArrival->m_nativeUnits.latin1() );
-
-        // Resource duration
-        tmp = parserDur.token( i ).toDouble();
-        appSiUnits()->convert( tmp,
-            vContainResourceDuration->m_displayUnits.latin1(),
-            vContainResourceDuration->m_nativeUnits.latin1(), &dur );
-        //fprintf( stderr, "Resource Duration %f %s --> %f %s\n",
-        //  tmp, vContainResourceDuration->m_displayUnits.latin1(),
-        //    dur, vContainResourceDuration->m_nativeUnits.latin1() );
+        // Resource arrival time, duration, and productivity in native units
+        // (appSiUnits() is shared by every EqTree, so it isn't used here)
+        arr  = vContainResourceArrival->storeNativeValue( i );
+        dur  = vContainResourceDuration->storeNativeValue( i );
+        prod = vContainResourceProd->storeNativeValue( i );
 
         // Resource name
         name = parserName.token( i );
 
-        // Resource productivity
-        tmp = parserProd.token( i ).toDouble();
-        appSiUnits()->convert( tmp,
-            vContainResourceProd->m_displayUnits.latin1(),
-            vContainResourceProd->m_nativeUnits.latin1(), &prod );
-        //fprintf( stderr, "Resource Productivity %f %s --> %f %s\n",
-        //  tmp, vContainResourceProd->m_displayUnits.latin1(),
-        //    prod, vContainResourceProd->m_nativeUnits.latin1() );
-
         // Resource cost
         if ( doCost )
         {
-            base = parserBase.token( i ).toDouble();
-            hour = parserHour.token( i ).toDouble();
+            base = vContainResourceBaseCost->storeValue( i );
+            hour = vContainResourceHourCost->storeValue( i );
         }
         // Add the resource to the resource array
         force->addResource( arr, prod, dur, LeftFlank, name.latin1(),
@@ -382,9 +442,8 @@ void EqCalc::ContainFF( void )
             vContainPoints->m_displayValue,
             vContainPoints->m_displayDecimals );
         // The coordinates need to be converted from chains to display units
-        double factor, offset;
-        appSiUnits()->conversionFactorOffset( vContainXMax->m_nativeUnits,
-            vContainXMax->m_displayUnits, &factor, &offset );
+        double factor = vContainXMax->m_factor;
+        double offset = vContainXMax->m_offset;
         for ( int pt = 0;
               pt <= sim->m_left->m_step;
               pt++ )
@@ -395,7 +454,6 @@ void EqCalc::ContainFF( void )
         }
     }
     // Free resources
-    delete force;   force = 0;
     delete sim;     sim = 0;
     return;
 }
@@ -573,9 +631,14 @@ void EqCalc::ContainFFSingle( void )
         hourCost   = vContainResourceHourCost->m_nativeValue;
     }
 
-    // Build the containment resources array
-    ContainForce *force = new ContainForce();
-    checkmem( __FILE__, __LINE__, force, "ContainForce force", 1 );
+    // Build the containment resources array, reusing the ContainForce
+    if ( ! m_containForce )
+    {
+        m_containForce = new ContainForce();
+        checkmem( __FILE__, __LINE__, m_containForce, "ContainForce m_containForce", 1 );
+    }
+    ContainForce *force = m_containForce;
+    force->clear();
     force->addResource( arrival, prod, duration, LeftFlank, name.latin1(),
             baseCost, hourCost );
 
@@ -713,9 +776,8 @@ void EqCalc::ContainFFSingle( void )
             vContainPoints->m_displayValue,
             vContainPoints->m_displayDecimals );
         // The coordinates need to be converted from chains to display units
-        double factor, offset;
-        appSiUnits()->conversionFactorOffset( vContainXMax->m_nativeUnits,
-            vContainXMax->m_displayUnits, &factor, &offset );
+        double factor = vContainXMax->m_factor;
+        double offset = vContainXMax->m_offset;
         for ( int pt = 0;
               pt <= sim->m_left->m_step;
               pt++ )
@@ -726,7 +788,6 @@ void EqCalc::ContainFFSingle( void )
         }
     }
     // Free resources
-    delete force;   force = 0;
     delete sim;     sim = 0;
     return;
 }
@@ -3194,28 +3255,19 @@ void EqCalc::FuelAspenModel( void )
     // Access current input values
     double curing    = vSurfaceFuelAspenCuring->m_nativeValue;
     int    typeIndex = vSurfaceFuelAspenType->activeItemDataIndex();
-    // Calculate
-    double depth         = FBL_AspenFuelBedDepth( typeIndex, curing );
-    double mextDead      = FBL_AspenFuelMextDead( typeIndex, curing );
-    double loadDead1     = FBL_AspenLoadDead1( typeIndex, curing );
-    double loadDead10    = FBL_AspenLoadDead10( typeIndex, curing );
-    double loadLiveHerb  = FBL_AspenLoadLiveHerb( typeIndex, curing );
-    double loadLiveWoody = FBL_AspenLoadLiveWoody( typeIndex, curing );
-    double savrDead1     = FBL_AspenSavrDead1( typeIndex, curing );
-    double savrDead10    = FBL_AspenSavrDead10( typeIndex, curing );
-    double savrLiveHerb  = FBL_AspenSavrLiveHerb( typeIndex, curing );
-    double savrLiveWoody = FBL_AspenSavrLiveWoody( typeIndex, curing );
+    // Calculate (or recall) the entire fuel bed
+    SpecialFuelBed *bed = aspenFuelBed( typeIndex, curing );
     // Update
-    vSurfaceFuelBedDepth->update( depth );
-    vSurfaceFuelBedMextDead->update( mextDead );
-    vSurfaceFuelAspenLoadDead1->update( loadDead1 );
-    vSurfaceFuelAspenLoadDead10->update( loadDead10 );
-    vSurfaceFuelAspenLoadLiveHerb->update( loadLiveHerb );
-    vSurfaceFuelAspenLoadLiveWoody->update( loadLiveWoody );
-    vSurfaceFuelAspenSavrDead1->update( savrDead1 );
-    vSurfaceFuelAspenSavrDead10->update( savrDead10 );
-    vSurfaceFuelAspenSavrLiveHerb->update( savrLiveHerb );
-    vSurfaceFuelAspenSavrLiveWoody->update( savrLiveWoody );
+    vSurfaceFuelBedDepth->update( bed->m_depth );
+    vSurfaceFuelBedMextDead->update( bed->m_mextDead );
+    vSurfaceFuelAspenLoadDead1->update( bed->m_load[0] );
+    vSurfaceFuelAspenLoadDead10->update( bed->m_load[1] );
+    vSurfaceFuelAspenLoadLiveHerb->update( bed->m_load[2] );
+    vSurfaceFuelAspenLoadLiveWoody->update( bed->m_load[3] );
+    vSurfaceFuelAspenSavrDead1->update( bed->m_savr[0] );
+    vSurfaceFuelAspenSavrDead10->update( bed->m_savr[1] );
+    vSurfaceFuelAspenSavrLiveHerb->update( bed->m_savr[2] );
+    vSurfaceFuelAspenSavrLiveWoody->update( bed->m_savr[3] );
 
     // Log results
     if( m_log )
@@ -3475,13 +3527,56 @@ void EqCalc::FuelBedIntermediates ( void )
     double deadFraction = ( totalLoad < SMIDGEN )
                         ? ( 0. )
                         : ( deadLoad / totalLoad );
-    // Fuel bed intermediates
+    // Fuel bed intermediates, reused if this fuel bed was seen recently
+    // (the dead extinction moisture is not used by the library function)
     double depth    = vSurfaceFuelBedDepth->m_nativeValue;
     double deadMext = vSurfaceFuelBedMextDead->m_nativeValue;
-    double bulkDensity, packingRatio, betaRatio;
-    double sigma = FBL_SurfaceFuelBedIntermediates( depth, deadMext, MaxParts,
-        life, load, savr, heat, dens, stot, seff,
-        &bulkDensity, &packingRatio, &betaRatio );
+    double bulkDensity, packingRatio, betaRatio, sigma;
+    double key[FuelBedKeys];
+    int k = 0;
+    key[k++] = depth;
+    for ( int q = 0;
+          q < MaxParts;
+          q++ )
+    {
+        key[k++] = (double) life[q];
+        key[k++] = load[q];
+        key[k++] = savr[q];
+        key[k++] = heat[q];
+        key[k++] = dens[q];
+        key[k++] = stot[q];
+        key[k++] = seff[q];
+    }
+    bool found;
+    int slot = m_fuelBedCache.find( key, &found );
+    double *bed = m_fuelBed + slot * FuelBedValues;
+    if ( found )
+    {
+        sigma        = bed[0];
+        bulkDensity  = bed[1];
+        packingRatio = bed[2];
+        betaRatio    = bed[3];
+        FBL_SurfaceFuelBedSetState( bed + 4 );
+    }
+    else
+    {
+        sigma = FBL_SurfaceFuelBedIntermediates( depth, deadMext, MaxParts,
+            life, load, savr, heat, dens, stot, seff,
+            &bulkDensity, &packingRatio, &betaRatio );
+        // An empty fuel bed leaves part of the library state unset
+        if ( sigma < SMIDGEN )
+        {
+            m_fuelBedCache.clear( slot );
+        }
+        else
+        {
+            bed[0] = sigma;
+            bed[1] = bulkDensity;
+            bed[2] = packingRatio;
+            bed[3] = betaRatio;
+            FBL_SurfaceFuelBedState( bed + 4 );
+        }
+    }
     //double betaOpt = packingRatio / betaRatio;
 
 //printf( "%-4.4s %6.1f %6.4f %6.4f %6.4f %6.4f\n",
@@ -3575,6 +3670,10 @@ void EqCalc::FuelBedModel( void )
 {
     // Access current input values
     FuelModel *fm = currentFuelModel( 0 );
+    if ( ! fm )
+    {
+        return;
+    }
 
     // Copy values from the FuelModel into the EqTree
     vSurfaceFuelLoadTransferEq->updateItem( fm->m_transfer );
@@ -3801,6 +3900,10 @@ void EqCalc::FuelBedWeighted( void )
     FuelModel *fm[2];
     fm[0] = currentFuelModel( 1 );
     fm[1] = currentFuelModel( 2 );
+    if ( ! fm[0] || ! fm[1] )
+    {
+        return;
+    }
 
     // Get the primary and secondary fuel model coverages
     double cov[2];
@@ -4297,10 +4400,9 @@ void EqCalc::FuelMoisScenarioModel( void )
     if ( ! ms )
     // This code block should never be executed!
     {
-        QString text("");
-        translate( text, "EqCalc:MoisScenarioNotFound",
-            vSurfaceFuelMoisScenario->activeItemName() );
-        bomb( text );
+        calcFailed( EqCalcMoisScenarioNotFound, "EqCalc:MoisScenarioNotFound",
+            name, vSurfaceFuelMoisScenario );
+        return;
     }
     // Copy values from the MoisScenario into the EqTree
     vSurfaceFuelMoisDead1->update( ms->m_moisDead1 );
@@ -4496,25 +4598,18 @@ void EqCalc::FuelPalmettoModel( void )
     double cover = vSurfaceFuelPalmettoCover->m_nativeValue;
     double ht    = vSurfaceFuelPalmettoHeight->m_nativeValue;
     double ba    = vSurfaceFuelPalmettoOverstoryBasalArea->m_nativeValue;
-    // Calculate
-    double dead1  = FBL_PalmettoGallberyDead1HrLoad( age, ht );
-    double dead10 = FBL_PalmettoGallberyDead10HrLoad( age, cover );
-    double deadf  = FBL_PalmettoGallberyDeadFoliageLoad( age, cover );
-    double depth  = FBL_PalmettoGallberyFuelBedDepth( ht );
-    double live1  = FBL_PalmettoGallberyLive1HrLoad( age, ht );
-    double live10 = FBL_PalmettoGallberyLive10HrLoad( age, ht );
-    double livef  = FBL_PalmettoGallberyLiveFoliageLoad( age, cover, ht );
-    double litter = FBL_PalmettoGallberyLitterLoad( age, ba ) ;
+    // Calculate (or recall) the entire fuel bed
+    SpecialFuelBed *bed = palmettoFuelBed( age, cover, ht, ba );
     // Update
-    vSurfaceFuelBedDepth->update( depth );
-    vSurfaceFuelBedMextDead->update( 0.40 );
-    vSurfaceFuelPalmettoLoadDead1->update( dead1 );
-    vSurfaceFuelPalmettoLoadDead10->update( dead10 );
-    vSurfaceFuelPalmettoLoadDeadFoliage->update( deadf );
-    vSurfaceFuelPalmettoLoadLitter->update( litter );
-    vSurfaceFuelPalmettoLoadLive1->update( live1 );
-    vSurfaceFuelPalmettoLoadLive10->update( live10 );
-    vSurfaceFuelPalmettoLoadLiveFoliage->update( livef );
+    vSurfaceFuelBedDepth->update( bed->m_depth );
+    vSurfaceFuelBedMextDead->update( bed->m_mextDead );
+    vSurfaceFuelPalmettoLoadDead1->update( bed->m_load[0] );
+    vSurfaceFuelPalmettoLoadDead10->update( bed->m_load[1] );
+    vSurfaceFuelPalmettoLoadDeadFoliage->update( bed->m_load[2] );
+    vSurfaceFuelPalmettoLoadLive1->update( bed->m_load[3] );
+    vSurfaceFuelPalmettoLoadLive10->update( bed->m_load[4] );
+    vSurfaceFuelPalmettoLoadLiveFoliage->update( bed->m_load[5] );
+    vSurfaceFuelPalmettoLoadLitter->update( bed->m_load[6] );
 
     // Log results
     if( m_log )
@@ -5346,10 +5441,9 @@ void EqCalc::SpotDistTorchingTrees( void )
     if ( spp < 0 || spp >= 14 )
     // This code block should never be executed!
     {
-        QString text("");
-        translate( text, "EqCalc:TreeSpeciesNotFound",
-            QString( "%1" ).arg( spp ) );
-        bomb( text );
+        calcFailed( EqCalcTreeSpeciesNotFound, "EqCalc:TreeSpeciesNotFound",
+            QString( "%1" ).arg( spp ), vTreeSpeciesSpot );
+        return;
     }
     // Calculate results
     double htUsed, firebrandHt, flatDist, flameHt, flameDur, flameRatio;
@@ -6114,13 +6208,11 @@ void EqCalc::WindAdjFactor( void )
     double cr = vTreeCrownRatio->m_nativeValue;
     double fd = vSurfaceFuelBedDepth->m_nativeValue;
     // Calculate results
-    int method = 0;
-    double fraction = 0.0;
-    double waf = FBL_WindAdjustmentFactor( cc, ch, cr, fd, &fraction, &method );
+    WindAdj *adj = windAdj( cc, ch, cr, fd );
     // Store results
-    vWindAdjFactor->update( waf );
-    vWindAdjMethod->updateItem( method );
-    vTreeCanopyCrownFraction->update( fraction );
+    vWindAdjFactor->update( adj->m_waf );
+    vWindAdjMethod->updateItem( adj->m_method );
+    vTreeCanopyCrownFraction->update( adj->m_fraction );
     // Log results
     if( m_log )
     {
@@ -6150,6 +6242,39 @@ void EqCalc::WindAdjFactor( void )
     return;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Looks up the wind adjustment factor for the canopy and fuel bed
+ *  inputs, calculating and remembering it if it is not in m_windAdj[].
+ *
+ *  A run's canopy and fuel bed inputs usually take only a few distinct
+ *  combinations, so after the first row of a table every cell's factor
+ *  is a table read (see EqCalcCache).
+ *
+ *  \param cc Canopy cover (fraction).
+ *  \param ch Canopy height (ft).
+ *  \param cr Crown ratio (fraction).
+ *  \param fd Fuel bed depth (ft).
+ *
+ *  \return Pointer to the wind adjustment entry.
+ */
+
+WindAdj *EqCalc::windAdj( double cc, double ch, double cr, double fd )
+{
+    double key[4];
+    key[0] = cc;
+    key[1] = ch;
+    key[2] = cr;
+    key[3] = fd;
+    bool found;
+    WindAdj *adj = &m_windAdj[ m_windAdjCache.find( key, &found ) ];
+    if ( ! found )
+    {
+        adj->m_waf = FBL_WindAdjustmentFactor( cc, ch, cr, fd,
+            &adj->m_fraction, &adj->m_method );
+    }
+    return( adj );
+}
+
 //------------------------------------------------------------------------------
 /*! \brief WindDirFromNorth
  *
@@ -6542,8 +6667,21 @@ void EqCalc::WthrWindChillTemp( void )
 
 EqCalc::EqCalc( EqTree *eqTree ) :
     m_eqTree(eqTree),
-    m_log(0)
+    m_log(0),
+    m_containForce(0),
+    m_aspenCache( 2, SpecialFuelBedCacheSize ),
+    m_palmettoCache( 4, SpecialFuelBedCacheSize ),
+    m_fuelBedCache( FuelBedKeys, FuelBedCacheSize ),
+    m_fuelBed(0),
+    m_windAdjCache( 4, WindAdjTableSize ),
+    m_status(EqCalcOk),
+    m_statusVar(0),
+    m_reportErrors(true)
 {
+    m_fuelBed = new double[ FuelBedCacheSize * FuelBedValues ];
+    checkmem( __FILE__, __LINE__, m_fuelBed, "double m_fuelBed",
+        FuelBedCacheSize * FuelBedValues );
+
     vContainAttackBack       = m_eqTree->getVarPtr( "vContainAttackBack" );
     vContainAttackDist       = m_eqTree->getVarPtr( "vContainAttackDist" );
     vContainAttackHead       = m_eqTree->getVarPtr( "vContainAttackHead" );
@@ -7038,6 +7176,133 @@ EqCalc::EqCalc( EqTree *eqTree ) :
     return;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief EqCalc destructor.
+ */
+
+EqCalc::~EqCalc( void )
+{
+    delete m_containForce;  m_containForce = 0;
+    delete[] m_fuelBed;     m_fuelBed = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief EqCalcCache constructor.
+ *
+ *  \param keys  Number of values in each key.
+ *  \param slots Number of slots, which must be a power of 2.
+ */
+
+EqCalcCache::EqCalcCache( int keys, int slots ) :
+    m_keys(keys),
+    m_slots(slots),
+    m_key(0),
+    m_used(0),
+    m_hits(0),
+    m_misses(0)
+{
+    m_key = new double[ m_keys * m_slots ];
+    checkmem( __FILE__, __LINE__, m_key, "double m_key", m_keys * m_slots );
+    m_used = new bool[ m_slots ];
+    checkmem( __FILE__, __LINE__, m_used, "bool m_used", m_slots );
+    for ( int slot = 0;
+          slot < m_slots;
+          slot++ )
+    {
+        m_used[slot] = false;
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief EqCalcCache destructor.
+ */
+
+EqCalcCache::~EqCalcCache( void )
+{
+    delete[] m_key;     m_key = 0;
+    delete[] m_used;    m_used = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Empties a slot claimed by find() whose result the caller decided
+ *  not to keep.
+ *
+ *  \param slot Index of the slot.
+ */
+
+void EqCalcCache::clear( int slot )
+{
+    m_used[slot] = false;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Finds the slot that holds \a key, or claims its slot for it.
+ *
+ *  The key values are hashed 32 bits at a time (FNV-1a, then the MurmurHash3
+ *  finalizer so that keys differing only in their high bits still spread
+ *  over the low bits used as the slot index).  A zero is always hashed as
+ *  +0. so that keys which compare equal hash alike.
+ *
+ *  \param key   Array of m_keys values.
+ *  \param found Address set TRUE if \a key was found, or FALSE if its slot
+ *               was claimed and the caller must store a new result in it.
+ *
+ *  \return Index of the slot.
+ */
+
+int EqCalcCache::find( const double *key, bool *found )
+{
+    unsigned int hash = 2166136261u;
+    unsigned int word[2];
+    double value;
+    int i;
+    for ( i = 0;
+          i < m_keys;
+          i++ )
+    {
+        value = ( key[i] == 0. ) ? 0. : key[i];
+        memcpy( word, &value, sizeof(value) );
+        hash = ( hash ^ word[0] ) * 16777619u;
+        hash = ( hash ^ word[1] ) * 16777619u;
+    }
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    int slot = (int) ( hash & (unsigned int) ( m_slots - 1 ) );
+    double *stored = m_key + slot * m_keys;
+    if ( m_used[slot] )
+    {
+        for ( i = 0;
+              i < m_keys && stored[i] == key[i];
+              i++ )
+        {
+            ; // NOTHING
+        }
+        if ( i == m_keys )
+        {
+            m_hits++;
+            *found = true;
+            return( slot );
+        }
+    }
+    for ( i = 0;
+          i < m_keys;
+          i++ )
+    {
+        stored[i] = key[i];
+    }
+    m_used[slot] = true;
+    m_misses++;
+    *found = false;
+    return( slot );
+}
+
 //------------------------------------------------------------------------------
 //  End of xeqcalc.cpp
 //------------------------------------------------------------------------------
@@ -14,6 +14,7 @@
 
 // Custom class references
 class BpDocument;
+class ContainForce;
 class EqFun;
 class EqTree;
 class EqVar;
@@ -26,6 +27,99 @@ class PropertyDict;
 // Standard include files
 #include <stdio.h>
 
+/*! \var FuelBedCacheSize
+ *  \brief Number of surface fuel bed intermediates remembered by EqCalc.
+ */
+static const int FuelBedCacheSize = 64;
+
+/*! \var SpecialFuelBedCacheSize
+ *  \brief Number of special fuel beds remembered for each fuel type.
+ */
+static const int SpecialFuelBedCacheSize = 16;
+
+//------------------------------------------------------------------------------
+/*! \class EqCalcCache xeqcalc.h
+ *
+ *  \brief Direct-mapped index of the inputs of an expensive EqCalc
+ *  calculation, so that table runs which revisit the same inputs can reuse
+ *  its results.
+ *
+ *  The cache holds only the keys; the caller keeps the results in its own
+ *  array with one entry per slot.  Each key hashes to exactly one slot, so
+ *  a lookup costs one hash and one key comparison whether it hits or not.
+ *  Keys are compared exactly, so a result is reused only when it would be
+ *  recalculated identically.
+ */
+
+class EqCalcCache
+{
+// Public methods
+public:
+    EqCalcCache( int keys, int slots ) ;
+    ~EqCalcCache( void ) ;
+    void clear( int slot ) ;
+    int  find( const double *key, bool *found ) ;
+
+// Public data
+public:
+    int     m_keys;     //!< Number of values in each key
+    int     m_slots;    //!< Number of slots (a power of 2)
+    double *m_key;      //!< Array of m_slots keys of m_keys values each
+    bool   *m_used;     //!< Array of m_slots flags, TRUE if slot holds a key
+    int     m_hits;     //!< Number of find() calls that found their key
+    int     m_misses;   //!< Number of find() calls that claimed a slot
+};
+
+//------------------------------------------------------------------------------
+/*! \class SpecialFuelBed xeqcalc.h
+ *
+ *  \brief A palmetto-gallberry or aspen fuel bed built from its generator
+ *  inputs, remembered by EqCalc so that table runs which revisit the same
+ *  inputs need not rebuild it.
+ */
+
+class SpecialFuelBed
+{
+public:
+    double  m_depth;        //!< Fuel bed depth (ft)
+    double  m_mextDead;     //!< Dead fuel extinction moisture (lb/lb)
+    double  m_load[7];      //!< Fuel particle loads (lb/ft2)
+    double  m_savr[4];      //!< Fuel particle savr (ft2/ft3)
+};
+
+/*! \enum EqCalcStatus
+ *  \brief Calculation failures recorded in EqCalc::m_status.
+ */
+enum EqCalcStatus
+{
+    EqCalcOk=0,                     //!< No failure
+    EqCalcFuelModelNotFound=1,      //!< Fuel model item not in the list
+    EqCalcMoisScenarioNotFound=2,   //!< Moisture scenario item not in the list
+    EqCalcTreeSpeciesNotFound=3     //!< Spot tree species index out of range
+};
+
+/*! \var WindAdjTableSize
+ *  \brief Number of wind adjustment factors remembered by EqCalc
+ *  (a power of 2; see EqCalcCache).
+ */
+static const int WindAdjTableSize = 64;
+
+//------------------------------------------------------------------------------
+/*! \class WindAdj xeqcalc.h
+ *
+ *  \brief A wind adjustment factor for a set of canopy and fuel bed inputs,
+ *  remembered by EqCalc so that table runs which revisit the same inputs
+ *  need not recalculate it.
+ */
+
+class WindAdj
+{
+public:
+    double  m_waf;          //!< Wind adjustment factor (dl)
+    double  m_fraction;     //!< Crown fill fraction (ft3/ft3)
+    int     m_method;       //!< 0=unsheltered, 1=sheltered
+};
+
 //------------------------------------------------------------------------------
 /*! \class EqCalc xeqcalc.h
  *
@@ -39,6 +133,7 @@ class EqCalc
 // Public methods
 public:
     EqCalc( EqTree *eqTree ) ;
+    ~EqCalc( void ) ;
     bool conflict1( void ) const ;
     bool conflict2( void ) const ;
     FuelModel *currentFuelModel( int id ) ;
@@ -72,10 +167,31 @@ public:
     void unmaskWafInputs( void ) ;
     bool validateInputs( void ) const ;
 
+// Private methods
+private:
+    SpecialFuelBed *aspenFuelBed( int typeIndex, double curing ) ;
+    void calcFailed( int status, const char *key, const QString &arg,
+                        EqVar *varPtr ) ;
+    SpecialFuelBed *palmettoFuelBed( double age, double cover, double height,
+                        double ba ) ;
+    WindAdj *windAdj( double cc, double ch, double cr, double fd ) ;
+
 // Public data
 public:
     EqTree *m_eqTree;   //!< Pointer to the parent EqTree
     FILE   *m_log;      //!< Log file stream pointer
+    ContainForce *m_containForce;   //!< ContainForce reused by every table cell
+    EqCalcCache    m_aspenCache;    //!< Index of m_aspenBed[] by type and curing
+    SpecialFuelBed m_aspenBed[SpecialFuelBedCacheSize];     //!< Recent aspen fuel beds
+    EqCalcCache    m_palmettoCache; //!< Index of m_palmettoBed[] by generator inputs
+    SpecialFuelBed m_palmettoBed[SpecialFuelBedCacheSize];  //!< Recent palmetto-gallberry fuel beds
+    EqCalcCache    m_fuelBedCache;  //!< Index of m_fuelBed[] by fuel particle inputs
+    double *m_fuelBed;          //!< Recent fuel bed intermediates and FBL states
+    EqCalcCache    m_windAdjCache;  //!< Index of m_windAdj[] by canopy and fuel bed depth
+    WindAdj        m_windAdj[WindAdjTableSize];    //!< Recent wind adjustment factors
+    int     m_status;           //!< First EqCalcStatus failure since last cleared
+    EqVar  *m_statusVar;        //!< Input that caused the m_status failure
+    bool    m_reportErrors;     //!< If TRUE, failures are also reported by bomb()
 
 // Declare all EqVar pointers here.
     EqVar *vContainAttackBack;
@@ -11,12 +11,14 @@
 #include "appproperty.h"
 #include "appsiunits.h"
 #include "apptranslator.h"
-#include "appwindow.h"
-#include "filesystem.h"
 #include "fuelmodel.h"
 #include "moisscenario.h"
 #include "parser.h"
 #include "property.h"
+#include "resultindex.h"
+#include "resultstore.h"
+#include "runarena.h"
+#include "runsnapshot.h"
 #include "rxvar.h"
 #include "xeqapp.h"
 #include "xeqcalc.h"
@@ -29,6 +31,8 @@
 #include <qapplication.h>
 #include <qprogressdialog.h>
 #include <qdatetime.h>
+#include <qfile.h>
+#include <qstringlist.h>
 
 // Standard include files
 #include <stdlib.h>
@@ -65,6 +69,8 @@ EqTree::EqTree( EqApp *eqApp, const QString &name, int funCount, int funPrime,
     m_leafCount(0),
     m_root(0),
     m_rootCount(0),
+    m_runNeed(0),
+    m_runNeeds(-1),
     m_itemList(itemList),
     m_itemListCount(itemListCount),
     m_funDict(0),
@@ -89,6 +95,14 @@ EqTree::EqTree( EqApp *eqApp, const QString &name, int funCount, int funPrime,
     m_tableVal(0),
     m_tableInRx(0),
     m_tableVar(0),
+    m_tableCalc(0),
+    m_tableApprox(0),
+    m_tableApproxCell(0),
+    m_tableApproxCells(0),
+    m_tableApproxError(0),
+    m_tableIndex(0),
+    m_runArena(0),
+    m_runReused(0),
     m_resultFile(""),
     m_traceFile(""),
     m_resultFptr(0),
@@ -108,10 +122,18 @@ EqTree::EqTree( EqApp *eqApp, const QString &name, int funCount, int funPrime,
     m_root = new EqVar *[ m_varCount ];
     checkmem( __FILE__, __LINE__, m_root, "EqVar *m_root", m_varCount );
 
+    m_runNeed = new EqVar *[ m_varCount ];
+    checkmem( __FILE__, __LINE__, m_runNeed, "EqVar *m_runNeed", m_varCount );
+
     m_rangeVar = new EqVar *[ m_maxRangeVars ];
     checkmem( __FILE__, __LINE__, m_rangeVar, "EqVar *m_rangeVar",
         m_maxRangeVars );
 
+    m_runSnapshot[0] = m_runSnapshot[1] = 0;
+
+    m_tableIndex = new ResultIndex( this );
+    checkmem( __FILE__, __LINE__, m_tableIndex, "ResultIndex m_tableIndex", 1 );
+
     // Create local dictionaries
     m_funDict = new QDict<EqFun>( funPrime, true );
     Q_CHECK_PTR( m_funDict );
@@ -282,9 +304,15 @@ EqTree::~EqTree( void )
     //runClean();
     delete   m_rxVarList;   m_rxVarList = 0;
     delete   m_eqCalc;      m_eqCalc = 0;
+    delete   m_runArena;    m_runArena = 0;
+    delete   m_tableVal;    m_tableVal = 0;
+    delete   m_tableIndex;  m_tableIndex = 0;
+    delete   m_runSnapshot[0];  m_runSnapshot[0] = 0;
+    delete   m_runSnapshot[1];  m_runSnapshot[1] = 0;
     delete[] m_fun;         m_fun = 0;
     delete[] m_leaf;        m_leaf = 0;
     delete[] m_root;        m_root = 0;
+    delete[] m_runNeed;     m_runNeed = 0;
     delete[] m_var;         m_var = 0;
     delete[] m_rangeVar;    m_rangeVar = 0;
     delete   m_funDict;     m_funDict = 0;
@@ -689,7 +717,9 @@ int EqTree::generateRootList( int release )
  *  \param col Column index (base 0).
  *  \param var Variable index (base 0).
  *
- *  \return Value from the m_tableVal[] array.
+ *  \return Value from the m_tableVal result store, which is EqTreeNoResult
+ *  if the output was skipped by the last run and has not yet been
+ *  calculated by runOutputs() (see m_tableCalc[]).
  */
 
 double EqTree::getResult( int row, int col, int var ) const
@@ -700,8 +730,9 @@ double EqTree::getResult( int row, int col, int var ) const
       && col >= 0 && col < m_tableCols
       && var >= 0 && var < m_tableVars )
     {
-        int id = var + col * m_tableVars + row * m_tableCols * m_tableVars;
-        value = m_tableVal[ id ];
+        Q_LLONG id = var
+            + ( (Q_LLONG) row * m_tableCols + col ) * m_tableVars;
+        value = m_tableVal->get( id );
     }
     return( value );
 }
@@ -1151,7 +1182,7 @@ void EqTree::resultFileRemove( void )
 
 //------------------------------------------------------------------------------
 /*! \brief Validates the EqTree values and runs the current configuration,
- *  storing values in the m_tableVal[] array.
+ *  storing values in the m_tableVal result store.
  *
  *  \return TRUE on success, FALSE on failure.
  */
@@ -1180,22 +1211,168 @@ bool EqTree::run( const QString &traceFile, const QString &resultFile )
     return( true );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Hands out storage for one of the m_table*[] arrays from the
+ *  m_runArena, creating the arena on first use.
+ *
+ *  The storage lives until the next runClean().
+ *
+ *  \param bytes Number of bytes required.
+ *
+ *  \return Pointer to the (uninitialized) storage.
+ */
+
+void *EqTree::runAlloc( Q_LLONG bytes )
+{
+    if ( ! m_runArena )
+    {
+        m_runArena = new RunArena();
+        checkmem( __FILE__, __LINE__, m_runArena, "RunArena m_runArena", 1 );
+    }
+    return( m_runArena->alloc( bytes ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines if the current table cell results are within
+ *  all the active prescription ranges.
+ *
+ *  Called only by EqTree::runTable() and EqTree::runHourly().
+ *
+ *  \return TRUE if the current results are within prescription.
+ */
+
+bool EqTree::runCellInRx( void )
+{
+    RxVar *rxVar;
+    for ( rxVar = m_rxVarList->first();
+          rxVar;
+          rxVar = m_rxVarList->next() )
+    {
+        if ( rxVar->m_isActive
+          && rxVar->m_varPtr->m_isUserOutput )
+        {
+            if ( ! rxVar->inRange() )
+            {
+                return( false );
+            }
+        }
+    }
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Dumps the current value of every variable to the result file
+ *  for the table cell at \a row and \a col.
+ *
+ *  Called only by EqTree::runTable() and EqTree::runHourly().
+ */
+
+void EqTree::runCellResults( int row, int col )
+{
+    if ( ! m_resultFptr )
+    {
+        return;
+    }
+    EqVar *outVar;
+    int iid;
+    for ( int vid = 0;
+          vid < m_varCount;
+          vid++ )
+    {
+        // Set the output variable pointer.
+        outVar = m_var[ vid ];
+        // Dump the variable's current value
+        if ( outVar->isDiscrete() )
+        {
+            iid = outVar->m_itemList->itemIdWithName(
+                outVar->activeItemName() );
+            fprintf( m_resultFptr,
+                "CELL %d %d %s disc %s\n",
+                row+1,
+                col+1,
+                outVar->m_name.latin1(),
+                outVar->getItemName( iid ).latin1() );
+        }
+        else if ( outVar->isContinuous() )
+        {
+            fprintf( m_resultFptr,
+                "CELL %d %d %s cont %g %s\n",
+                row+1,
+                col+1,
+                outVar->m_name.latin1(),
+                outVar->m_displayValue,
+                outVar->m_displayUnits.latin1() );
+        }
+        else if ( outVar->isText() )
+        {
+            fprintf( m_resultFptr,
+                "CELL %d %d %s text %s\n",
+                row+1,
+                col+1,
+                outVar->m_name.latin1(),
+                outVar->m_store.latin1() );
+        }
+        else
+        {
+            fprintf( m_resultFptr,
+                "CELL %d %d %s othr\n",
+                row+1,
+                col+1,
+                outVar->m_name.latin1() );
+        }
+    }
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Frees all the memory allocated for a specific run.
  *
- *  The deleted memory is set in
+ *  The freed memory is handed out by m_runArena in
+ *  \arg EqTree::runInit()
  *  \arg EqTree::runInitColsFromStore()
+ *  \arg EqTree::runInitRowsFromRange()
  *  \arg EqTree::runInitRowsFromStore()
+ *  \arg EqTree::runInitTableVars()
+ *  \arg EqTree::runHourly()
+ *
+ *  The arena keeps its storage for the next run, and its allocation
+ *  statistics for the run are written to the log file.  The m_tableVal
+ *  result store is emptied, and its paging is logged if the run spilled.
  */
 
 void EqTree::runClean( void )
 {
-    delete[] m_tableRow;    m_tableRow = 0;
-    delete[] m_tableCol;    m_tableCol = 0;
-    delete[] m_tableVal;    m_tableVal = 0;
-    delete[] m_tableInRx;   m_tableInRx = 0;
-    delete[] m_tableVar;    m_tableVar = 0;
+    m_tableRow = 0;
+    m_tableCol = 0;
+    m_tableInRx = 0;
+    m_tableVar = 0;
+    m_tableCalc = 0;
+    m_tableApprox = 0;
+    m_tableApproxCell = 0;
+    m_tableApproxCells = 0;
+    m_tableApproxError = 0;
     m_tableVars = m_tableCols = m_tableRows = m_tableCells = 0;
+    // The table indexes live in the arena
+    if ( m_tableIndex )
+    {
+        m_tableIndex->clear();
+    }
+    if ( m_runArena && m_runArena->reset() )
+    {
+        QString msg("");
+        m_runArena->report( msg );
+        log( msg );
+    }
+    if ( m_tableVal )
+    {
+        if ( m_tableVal->m_spills )
+        {
+            QString msg("");
+            m_tableVal->report( msg );
+            log( msg );
+        }
+        m_tableVal->clear();
+    }
     return;
 }
 
@@ -1236,24 +1413,18 @@ bool EqTree::runInit( bool graphTable )
         runClean();
         return( false );
     }
-    // Create a single array to hold all the table's result values
-    m_tableCells = m_tableRows * m_tableCols * m_tableVars;
-    m_tableVal = new double[ m_tableCells ];
-    checkmem( __FILE__, __LINE__, m_tableVal, "double m_tableVal", m_tableCells );
+    // Size the result store to hold all the table's result values
+    m_tableCells = (Q_LLONG) m_tableRows * m_tableCols * m_tableVars;
+    runInitResults();
 
-    // Create a single array to hold all the table's shading results
-    m_tableInRx = new bool[ m_tableCells ];
-    checkmem( __FILE__, __LINE__, m_tableInRx, "bool m_tableInRx", m_tableCells );
-    for ( int i=0; i<m_tableCells; i++ )
-    {
-        m_tableInRx[i] = false;
-    }
+    // Create a single bitmap to hold all the table's shading results
+    runInitInRx( m_tableRows * m_tableCols );
     return( true );
 }
 
 //------------------------------------------------------------------------------
-/*! \brief Sets up the m_tableCol[] array with all the column values parsed
- *  from the column variable's store.
+/*! \brief Sets up the m_tableCol[] array with all the column values
+ *  from the column variable's parsed store.
  *
  *  The column variable is pointed to by m_rangeVar[1],
  *  which is set by the most recent call to EqTree::rangeCase()
@@ -1265,7 +1436,7 @@ bool EqTree::runInit( bool graphTable )
 void EqTree::runInitColsFromStore( void )
 {
     // Remove any existing row value array
-    delete[] m_tableCol;    m_tableCol = 0;
+    m_tableCol = 0;
     m_tableCols = 1;
 
     // If there is no column variable then we're done here
@@ -1277,32 +1448,77 @@ void EqTree::runInitColsFromStore( void )
     // or the graph's z-axis values
     EqVar *colVar = m_rangeVar[1];
     m_tableCols = colVar->m_tokens;
-    m_tableCol = new double[ m_tableCols ];
-    checkmem( __FILE__, __LINE__, m_tableCol, "double m_tableCol", m_tableCols );
+    m_tableCol = (double *) runAlloc( m_tableCols * sizeof(double) );
 
-    // Determine and store all the table's column values from its store
-    Parser parser( " \t,\"", "", "" );
-    parser.parse( colVar->m_store );
-    QString token;
+    // Determine and store all the table's column values from its parsed store
+    int n = colVar->parseStore();
     int col = 0;
     for ( int i = 0;
-          i < parser.tokens();
+          i < n && col < m_tableCols;
           i++ )
     {
-        token = parser.token( i );
         if ( colVar->isDiscrete() )
         {
-            m_tableCol[col++] = 0.5 +
-                (double) colVar->m_itemList->itemIdWithName( token );
+            m_tableCol[col++] = 0.5 + colVar->m_storeValue[i];
         }
         else if ( colVar->isContinuous() )
         {
-            m_tableCol[col++] = token.toDouble();
+            m_tableCol[col++] = colVar->m_storeValue[i];
         }
     }
     return;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Creates the m_tableInRx[] bitmap with one cleared bit per
+ *  table cell.
+ *
+ *  Called by EqTree::runInit(), EqTree::runHourly(), and
+ *  EqTree::runTransect().
+ *
+ *  \param cells Number of table cells (rows times columns).
+ */
+
+void EqTree::runInitInRx( int cells )
+{
+    int words = ( cells + 31 ) >> 5;
+    m_tableInRx = (unsigned int *)
+        runAlloc( (Q_LLONG) words * sizeof(unsigned int) );
+    for ( int w = 0;
+          w < words;
+          w++ )
+    {
+        m_tableInRx[w] = 0;
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sizes the m_tableVal result store for m_tableCells results,
+ *  creating the store on first use.
+ *
+ *  At most "appResultCacheKSize" kB of results are held in memory; larger
+ *  runs page the rest to a temporary spill file.
+ *
+ *  Called only by EqTree::runInit() and EqTree::runHourly().
+ */
+
+void EqTree::runInitResults( void )
+{
+    if ( ! m_tableVal )
+    {
+        m_tableVal = new ResultStore();
+        checkmem( __FILE__, __LINE__, m_tableVal, "ResultStore m_tableVal", 1 );
+    }
+    int kBytes = appProperty()->integer( "appResultCacheKSize" );
+    if ( kBytes > 2097151 )
+    {
+        kBytes = 2097151;
+    }
+    m_tableVal->alloc( m_tableCells, 1024 * kBytes );
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Sets up the m_tableRow[] array with all the row values calculated
  *  from the row variable's m_store minimum and maximum value and from the
@@ -1318,19 +1534,18 @@ void EqTree::runInitColsFromStore( void )
 void EqTree::runInitRowsFromRange( void )
 {
     // Remove any existing row value array
-    delete[] m_tableRow;    m_tableRow = 0;
+    m_tableRow = 0;
 
     // Get a pointer to the row variable and number of graph line points
     EqVar *rowVar = m_rangeVar[0];
     m_tableRows = m_propDict->integer( "graphLinePoints" );
 
     // Create an array to hold the graph's x-axis values
-    m_tableRow = new double[ m_tableRows ];
-    checkmem( __FILE__, __LINE__, m_tableRow, "double m_tableRow", m_tableRows );
+    m_tableRow = (double *) runAlloc( m_tableRows * sizeof(double) );
 
     // Determine the x-axis value step size
     double xMin, xMax, xStep;
-    strMinMax( rowVar->m_store, &xMin, &xMax );
+    rowVar->storeMinMax( &xMin, &xMax );
     xStep = (xMax - xMin) / ( m_tableRows - 1 );
 
     // Fill the row array
@@ -1344,8 +1559,8 @@ void EqTree::runInitRowsFromRange( void )
 }
 
 //------------------------------------------------------------------------------
-/*! \brief Sets up the m_tableRow[] array with all the row values parsed
- *  from the row variable's store.
+/*! \brief Sets up the m_tableRow[] array with all the row values
+ *  from the row variable's parsed store.
  *
  *  The row variable is pointed to by m_rangeVar[0],
  *  which is set by the most recent call to EqTree::rangeCase()
@@ -1357,7 +1572,7 @@ void EqTree::runInitRowsFromRange( void )
 void EqTree::runInitRowsFromStore( void )
 {
     // Remove any existing row value array
-    delete[] m_tableRow;  m_tableRow = 0;
+    m_tableRow = 0;
     m_tableRows = 1;
 
     // If there is no row variable, then we're done here
@@ -1369,27 +1584,22 @@ void EqTree::runInitRowsFromStore( void )
     // or the graph's x-axis values
     EqVar *rowVar = m_rangeVar[0];
     m_tableRows = rowVar->m_tokens;
-    m_tableRow = new double[ m_tableRows ];
-    checkmem( __FILE__, __LINE__, m_tableRow, "double m_tableRow", m_tableRows );
+    m_tableRow = (double *) runAlloc( m_tableRows * sizeof(double) );
 
-    // Determine and store all the table's row values from its store
-    Parser parser( " \t,\"", "", "" );
-    parser.parse( rowVar->m_store );
-    QString token;
+    // Determine and store all the table's row values from its parsed store
+    int n = rowVar->parseStore();
     int row = 0;
     for ( int i = 0;
-          i < parser.tokens();
+          i < n && row < m_tableRows;
           i++ )
     {
-        token = parser.token( i );
         if ( rowVar->isDiscrete() )
         {
-            m_tableRow[row++] = 0.5 +
-                (double) rowVar->m_itemList->itemIdWithName( token );
+            m_tableRow[row++] = 0.5 + rowVar->m_storeValue[i];
         }
         else if ( rowVar->isContinuous() )
         {
-            m_tableRow[row++] = token.toDouble();
+            m_tableRow[row++] = rowVar->m_storeValue[i];
         }
     }
     return;
@@ -1403,7 +1613,12 @@ void EqTree::runInitRowsFromStore( void )
  *  of root variables, since text root and diagram variables are not output
  *  variables.
  *
- *  Called only by EqTree::runInit().
+ *  Also sets up the m_tableCalc[] array flagging which outputs runTable()
+ *  will calculate.  These are all of them, unless setRunOutputs() named
+ *  just the outputs its consumer needs; outputs with active prescription
+ *  ranges are always calculated so m_tableInRx[] remains valid.
+ *
+ *  Called only by EqTree::runInit() and EqTree::runHourly().
  *
  *   \return TRUE on success, FALSE if no input variables.
  */
@@ -1411,7 +1626,7 @@ void EqTree::runInitRowsFromStore( void )
 bool EqTree::runInitTableVars( void )
 {
     // Remove any existing row value array
-    delete[] m_tableVar;    m_tableVar = 0;
+    m_tableVar = 0;
     m_tableVars = 0;
 
     // Determine number of root variables to be displayed
@@ -1435,8 +1650,7 @@ bool EqTree::runInitTableVars( void )
         return( false );
     }
     // Create an array to hold the table's output variable pointers
-    m_tableVar = new EqVar *[ m_tableVars ];
-    checkmem( __FILE__, __LINE__, m_tableVar, "EqVar *m_tableVars", m_tableVars );
+    m_tableVar = (EqVar **) runAlloc( m_tableVars * sizeof(EqVar *) );
 
     // Determine and store all the output variable pointers
     int vid = 0;
@@ -1450,13 +1664,192 @@ bool EqTree::runInitTableVars( void )
             m_tableVar[vid++] = m_root[rid];
         }
     }
+    // Determine which output variables must be calculated
+    m_tableCalc = (bool *) runAlloc( m_tableVars * sizeof(bool) );
+    RxVar *rxVar;
+    int nid;
+    for ( vid = 0;
+          vid < m_tableVars;
+          vid++ )
+    {
+        m_tableCalc[vid] = ( m_runNeeds < 0 );
+        for ( nid = 0;
+              nid < m_runNeeds && ! m_tableCalc[vid];
+              nid++ )
+        {
+            m_tableCalc[vid] = ( m_runNeed[nid] == m_tableVar[vid] );
+        }
+        for ( rxVar = m_rxVarList->first();
+              rxVar && ! m_tableCalc[vid];
+              rxVar = m_rxVarList->next() )
+        {
+            m_tableCalc[vid] = ( rxVar->m_isActive
+                && rxVar->m_varPtr == m_tableVar[vid] );
+        }
+    }
     return( true );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Calculates the output variables that a pruned runTable() skipped
+ *  (see setRunOutputs()), for every cell of the current table.
+ *
+ *  Consumers that read outputs beyond those their run named call this
+ *  first, so the outputs are calculated only when a consumer needs them.
+ *  Each cell's row and column inputs are set again and only the missing
+ *  outputs (and their producers) are calculated, ending with the last cell
+ *  so the input variables are left just as runTable() left them.
+ *
+ *  \param vars  Array of output variables required.
+ *                If NULL, every output variable is required.
+ *  \param count Number of variables in \a vars.
+ *
+ *  \return Number of output variables calculated.
+ */
+
+int EqTree::runOutputs( EqVar **vars, int count )
+{
+    if ( ! m_tableCalc || ! m_tableVal || m_tableCells <= 0 )
+    {
+        return( 0 );
+    }
+    // Determine which required outputs are missing
+    bool *missing = (bool *) runAlloc( m_tableVars * sizeof(bool) );
+    int vid, nid;
+    int missed = 0;
+    for ( vid = 0;
+          vid < m_tableVars;
+          vid++ )
+    {
+        missing[vid] = ! m_tableCalc[vid] && ! vars;
+        for ( nid = 0;
+              vars && nid < count && ! m_tableCalc[vid] && ! missing[vid];
+              nid++ )
+        {
+            missing[vid] = ( vars[nid] == m_tableVar[vid] );
+        }
+        if ( missing[vid] )
+        {
+            missed++;
+        }
+    }
+    if ( ! missed )
+    {
+        return( 0 );
+    }
+    // Calculate them for every cell
+    EqVar *outVar;
+    int row, col, cell;
+    for ( row = 0, cell = 0;
+          row < m_tableRows;
+          row++ )
+    {
+        for ( col = 0;
+              col < m_tableCols;
+              col++, cell++ )
+        {
+            runSetCell( row, col );
+            for ( vid = 0;
+                  vid < m_tableVars;
+                  vid++ )
+            {
+                if ( ! missing[vid] )
+                {
+                    continue;
+                }
+                outVar = m_tableVar[ vid ];
+                calculateVariable( outVar, 0 );
+                if ( outVar->isDiscrete() )
+                {
+                    m_tableVal->set( (Q_LLONG) cell * m_tableVars + vid,
+                        0.5 + (double) outVar->m_itemList->itemIdWithName(
+                            outVar->activeItemName() ) );
+                }
+                else if ( outVar->isContinuous() )
+                {
+                    m_tableVal->set( (Q_LLONG) cell * m_tableVars + vid,
+                        outVar->m_displayValue );
+                }
+            }
+        }
+    }
+    for ( vid = 0;
+          vid < m_tableVars;
+          vid++ )
+    {
+        if ( missing[vid] )
+        {
+            m_tableCalc[vid] = true;
+        }
+    }
+    // Any sorted indexes were built from the missing values
+    if ( m_tableIndex )
+    {
+        m_tableIndex->clear();
+    }
+    log( QString( "EqTree::runOutputs() calculated %1 skipped outputs"
+        " for %2 cells.\n" ).arg( missed ).arg( m_tableCells ) );
+    return( missed );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the row and column range variables to their values for the
+ *  table cell at \a row and \a col.
+ *
+ *  Called by EqTree::runOutputs() and the surrogate table functions (see
+ *  runSurrogate()).
+ */
+
+void EqTree::runSetCell( int row, int col )
+{
+    EqVar *rowVar = m_rangeVar[0];
+    EqVar *colVar = m_rangeVar[1];
+    if ( rowVar )
+    {
+        if ( rowVar->isDiscrete() )
+        {
+            rowVar->setItemName(
+                rowVar->getItemName( (int) m_tableRow[ row ] ) );
+        }
+        else if ( rowVar->isContinuous() )
+        {
+            rowVar->setDisplayValue( m_tableRow[ row ] );
+        }
+    }
+    if ( colVar )
+    {
+        if ( colVar->isDiscrete() )
+        {
+            colVar->setItemName(
+                colVar->getItemName( (int) m_tableCol[ col ] ) );
+        }
+        else if ( colVar->isContinuous() )
+        {
+            colVar->setDisplayValue( m_tableCol[ col ] );
+        }
+    }
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Creates a table of results from the current input values and range
  *  variables.
  *
+ *  If setRunOutputs() was called, only the outputs it named are calculated
+ *  (see runInitTableVars()); the rest are stored as EqTreeNoResult and
+ *  flagged by m_tableCalc[] until runOutputs() calculates them.  The output
+ *  list applies to this run only.
+ *
+ *  If the "appIncrementalRun" property is set, output columns that are not
+ *  affected by any input changed since the previous run of the same table
+ *  are copied from that run (see RunSnapshot).  If "appIncrementalVerify"
+ *  is also set, such a run is checked against a full run by
+ *  runTableVerify().
+ *
+ *  If the "appSurrogateRun" property is set, outputs that depend upon a
+ *  few very costly functions may be interpolated between a subset of the
+ *  cells instead of calculated at every cell (see runSurrogate()).
+ *
  *  \param traceFile    Name of the EqCalc processing log file.
  *                      If NULL or empty, no log file is written.
  *  \param graphTable   If FALSE, only results for the requested row and
@@ -1473,16 +1866,60 @@ bool EqTree::runInitTableVars( void )
 bool EqTree::runTable( const QString &traceFile, const QString &resultFile,
         bool graphTable )
 {
+    bool incremental = appProperty()->boolean( "appIncrementalRun" );
+    bool result = runTableCells( traceFile, resultFile, graphTable,
+        incremental );
+    if ( result && m_runReused
+      && appProperty()->boolean( "appIncrementalVerify" ) )
+    {
+        result = runTableVerify( traceFile, resultFile, graphTable );
+    }
+    m_runNeeds = -1;
+    return( result );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Calculates every cell of the table set up by runInit().
+ *
+ *  \param traceFile    Name of the EqCalc processing log file.
+ *                      If NULL or empty, no log file is written.
+ *  \param resultFile   Name of the results file.
+ *                      If NULL or empty, no results file is written.
+ *  \param graphTable   See runTable().
+ *  \param incremental  If TRUE, output columns the previous run of this
+ *                      table can supply are copied instead of calculated.
+ *                      Runs that write a trace or results file always
+ *                      calculate every output.
+ *
+ *  Called only by EqTree::runTable() and EqTree::runTableVerify().
+ *
+ *  \return TRUE on success, FALSE on failure.
+ */
+
+bool EqTree::runTableCells( const QString &traceFile,
+        const QString &resultFile, bool graphTable, bool incremental )
+{
+    int row, col, cell, vid, iid;
+    Q_LLONG var;
     // Set up the supporting dynamic memory
     if ( ! runInit( graphTable ) )
     {
         return( false );
     }
+    // The result file dumps every variable, so every output is needed
+    if ( ! graphTable && ! resultFile.isEmpty() )
+    {
+        for ( vid = 0;
+              vid < m_tableVars;
+              vid++ )
+        {
+            m_tableCalc[vid] = true;
+        }
+    }
     // We're gonna need these!
     EqVar *rowVar = m_rangeVar[0];
     EqVar *colVar = m_rangeVar[1];
     EqVar *outVar = 0;
-    int row, col, cell, vid, iid, var, step;
 
     // Attempt to open a new copy of the trace file.
     if ( ! traceFile.isNull()
@@ -1528,6 +1965,37 @@ bool EqTree::runTable( const QString &traceFile, const QString &resultFile,
             m_varCount );
     }
 
+    // Determine which output columns the previous run of this table supplies
+    int snap = ( graphTable ? 1 : 0 );
+    if ( ! m_runSnapshot[snap] )
+    {
+        m_runSnapshot[snap] = new RunSnapshot();
+        checkmem( __FILE__, __LINE__, m_runSnapshot[snap],
+            "RunSnapshot m_runSnapshot", 1 );
+    }
+    RunSnapshot *snapshot = m_runSnapshot[snap];
+    snapshot->begin( this );
+    bool *reuse = (bool *) runAlloc( m_tableVars * sizeof(bool) );
+    m_runReused = 0;
+    if ( incremental
+      && ! m_traceFptr
+      && ! m_resultFptr )
+    {
+        m_runReused = snapshot->reusable( this, reuse );
+    }
+    else
+    {
+        for ( vid = 0;
+              vid < m_tableVars;
+              vid++ )
+        {
+            reuse[vid] = false;
+        }
+    }
+    // Determine which costly output columns are approximated
+    int approximated = runSurrogateInit( ! m_traceFptr && ! m_resultFptr,
+        reuse );
+
     // Set up the progress dialog.
     QString caption(""), button("");
     translate( caption, "EqTree:RunTable:Progress:Caption",
@@ -1536,16 +2004,16 @@ bool EqTree::runTable( const QString &traceFile, const QString &resultFile,
         QString( "%1" ).arg( m_tableCols ),
         QString( "%1" ).arg( m_tableVars ) );
     translate( button, "EqTree:RunTable:Progress:Button" );
+    // Progress is counted in cells, which fit in an int, not in results.
     QProgressDialog *progress = new QProgressDialog( caption, button,
-        m_tableCells );
+        m_tableRows * m_tableCols );
     Q_CHECK_PTR( progress );
     progress->setMinimumDuration( 0 );
     progress->setProgress( 0 );
 
     // Make an Equation Tree run for every table cell
     // Loop for each table row or graph x-axis variable.
-    RxVar *rxVar;
-    for ( step = 0, var = 0, row = 0, cell = 0;
+    for ( var = 0, row = 0, cell = 0;
           row < m_tableRows;
           row++ )
     {
@@ -1701,6 +2169,25 @@ bool EqTree::runTable( const QString &traceFile, const QString &resultFile,
                   vid < m_tableVars;
                   vid++ )
             {
+                // Skip outputs no consumer of this run needs.
+                if ( ! m_tableCalc[ vid ] )
+                {
+                    m_tableVal->set( var++, EqTreeNoResult );
+                    continue;
+                }
+                // Skip approximated outputs (see runSurrogate()).
+                if ( m_tableApprox[ vid ] )
+                {
+                    m_tableVal->set( var++, 0. );
+                    continue;
+                }
+                // Copy outputs no changed input affects.
+                if ( reuse[ vid ] )
+                {
+                    m_tableVal->set( var, snapshot->value( var ) );
+                    var++;
+                    continue;
+                }
                 // Set the output variable pointer.
                 outVar = m_tableVar[ vid ];
 
@@ -1720,13 +2207,13 @@ bool EqTree::runTable( const QString &traceFile, const QString &resultFile,
                 // Store the output value.
                 if ( outVar->isDiscrete() )
                 {
-                    m_tableVal[ var++ ] = 0.5 + (double)
+                    m_tableVal->set( var++, 0.5 + (double)
                         outVar->m_itemList->itemIdWithName(
-                            outVar->activeItemName() );
+                            outVar->activeItemName() ) );
                 }
                 else if ( outVar->isContinuous() )
                 {
-                    m_tableVal[ var++ ] = outVar->m_displayValue;
+                    m_tableVal->set( var++, outVar->m_displayValue );
                 }
 
                 // Log end of this loop.
@@ -1736,7 +2223,7 @@ bool EqTree::runTable( const QString &traceFile, const QString &resultFile,
                         vid, outVar->m_name.latin1() );
                 }
                 // Update progress dialog.
-                progress->setProgress( ++step );
+                progress->setProgress( cell );
                 qApp->processEvents();
                 if ( progress->wasCancelled() )
                 {
@@ -1748,74 +2235,14 @@ bool EqTree::runTable( const QString &traceFile, const QString &resultFile,
             } // Next table output or graph y-axis variable.
 
             // Determine if results are within prescription
-            m_tableInRx[cell] = true;
-            for ( rxVar = m_rxVarList->first();
-                  rxVar;
-                  rxVar = m_rxVarList->next() )
-            {
-                if ( rxVar->m_isActive
-                  && rxVar->m_varPtr->m_isUserOutput )
-                {
-                    if ( ! rxVar->inRange() )
-                    {
-                        m_tableInRx[ cell ] = false;
-                        break;
-                    }
-                }
-            }
+            setTableInRx( cell, runCellInRx() );
 //fprintf( stderr, "Cell %d is %s\n",
-//cell, m_tableInRx[cell] ? "INSIDE" : "OUTSIDE" );
+//cell, tableInRx( cell ) ? "INSIDE" : "OUTSIDE" );
 
             // Dump all variables
-            if ( ! graphTable
-              && m_resultFptr )
+            if ( ! graphTable )
             {
-                for ( vid = 0;
-                      vid < m_varCount;
-                      vid++ )
-                {
-                    // Set the output variable pointer.
-                    outVar = m_var[ vid ];
-                    // Dump the variable's current value
-                    if ( outVar->isDiscrete() )
-                    {
-                        iid = outVar->m_itemList->itemIdWithName(
-                            outVar->activeItemName() );
-                        fprintf( m_resultFptr,
-                            "CELL %d %d %s disc %s\n",
-                            row+1,
-                            col+1,
-                            outVar->m_name.latin1(),
-                            outVar->getItemName( iid ).latin1() );
-                    }
-                    else if ( outVar->isContinuous() )
-                    {
-                        fprintf( m_resultFptr,
-                            "CELL %d %d %s cont %g %s\n",
-                            row+1,
-                            col+1,
-                            outVar->m_name.latin1(),
-                            outVar->m_displayValue,
-                            outVar->m_displayUnits.latin1() );
-                    }
-                    else if ( outVar->isText() )
-                    {
-                        fprintf( m_resultFptr,
-                            "CELL %d %d %s text %s\n",
-                            row+1,
-                            col+1,
-                            outVar->m_name.latin1(),
-                            outVar->m_store.latin1() );
-                    }
-                    else
-                    {
-                        fprintf( m_resultFptr,
-                            "CELL %d %d %s othr\n",
-                            row+1,
-                            col+1,
-                            outVar->m_name.latin1() );
-                    }
-                }
+                runCellResults( row, col );
             }
 
             // Log end of this loop.
@@ -1852,6 +2279,22 @@ bool EqTree::runTable( const QString &traceFile, const QString &resultFile,
             }
         }
     } // Next table row or graph x-axis variable.
+    // Fill in the approximated outputs
+    if ( approximated )
+    {
+        runSurrogate();
+    }
+    // Calculate the copied outputs for the last cell,
+    // so they are left just as a full run would leave them
+    for ( vid = 0;
+          vid < m_tableVars;
+          vid++ )
+    {
+        if ( reuse[ vid ] )
+        {
+            calculateVariable( m_tableVar[ vid ], 0 );
+        }
+    }
     // Log the table footer
     if ( m_traceFptr )
     {
@@ -1864,6 +2307,72 @@ bool EqTree::runTable( const QString &traceFile, const QString &resultFile,
 
     // Clean up and return.
     delete progress;    progress = 0;
+    snapshot->save( this );
+    if ( m_runReused )
+    {
+        log( QString( "EqTree::runTable() copied %1 of %2 output columns "
+            "from the previous run.\n" ).arg( m_runReused ).arg( m_tableVars ) );
+    }
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Checks an incremental table run by running the whole table again.
+ *
+ *  The full run's results replace the incremental run's, and the number of
+ *  results that differ (which should always be zero) is written to the log
+ *  file.
+ *
+ *  \param traceFile    See runTableCells().
+ *  \param resultFile   See runTableCells().
+ *  \param graphTable   See runTable().
+ *
+ *  Called only by EqTree::runTable().
+ *
+ *  \return TRUE on success, FALSE on failure.
+ */
+
+bool EqTree::runTableVerify( const QString &traceFile,
+        const QString &resultFile, bool graphTable )
+{
+    // Set aside the incremental run's results and run the whole table
+    int reused = m_runReused;
+    ResultStore *incremental = m_tableVal;
+    m_tableVal = 0;
+    bool result = runTableCells( traceFile, resultFile, graphTable, false );
+    if ( ! result )
+    {
+        delete incremental;
+        return( false );
+    }
+    // Compare every calculated result
+    Q_LLONG id;
+    Q_LLONG diffs = 0;
+    int vid;
+    EqVar *first = 0;
+    for ( id = 0;
+          id < m_tableCells;
+          id++ )
+    {
+        vid = (int) ( id % m_tableVars );
+        if ( m_tableCalc[vid]
+          && incremental->get( id ) != m_tableVal->get( id ) )
+        {
+            if ( ! diffs++ )
+            {
+                first = m_tableVar[vid];
+            }
+        }
+    }
+    delete incremental;
+    QString msg = QString( "EqTree::runTableVerify() incremental run copied "
+        "%1 of %2 output columns; %3 of %4 results differ from a full run" )
+        .arg( reused ).arg( m_tableVars ).arg( diffs ).arg( m_tableCells );
+    if ( first )
+    {
+        msg += QString( " (first is %1)" ).arg( first->m_name );
+    }
+    log( msg + ".\n" );
     return( true );
 }
 
@@ -1989,7 +2498,7 @@ void EqTree::setLabel( EqVar *varPtr, const QString &stuff )
  *  \param var      Variable index (base 0).
  *  \param value    Value to insert into the table.
  *
- *  \return Value from the m_tableVal[] array.
+ *  \return The \a value.
  */
 
 double EqTree::setResult( int row, int col, int var, double value )
@@ -1999,12 +2508,102 @@ double EqTree::setResult( int row, int col, int var, double value )
       && col >= 0 && col < m_tableCols
       && var >= 0 && var < m_tableVars )
     {
-        int id = var + col * m_tableVars + row * m_tableCols * m_tableVars;
-        m_tableVal[ id ] = value;
+        Q_LLONG id = var
+            + ( (Q_LLONG) row * m_tableCols + col ) * m_tableVars;
+        m_tableVal->set( id, value );
     }
     return( value );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Names the only output variables the next runTable() must
+ *  calculate.
+ *
+ *  Consumers that use just some of the selected outputs (such as graphs,
+ *  which plot only continuous outputs) call this so that the other outputs
+ *  and their producer chains are skipped.  Skipped outputs are flagged by
+ *  m_tableCalc[] and their results are EqTreeNoResult until a consumer that
+ *  needs them calls runOutputs().  The list applies to the next runTable()
+ *  only.
+ *
+ *  \param vars  Array of required output variables; copied.
+ *                If NULL, every output variable is required.
+ *  \param count Number of variables in \a vars.
+ */
+
+void EqTree::setRunOutputs( EqVar **vars, int count )
+{
+    m_runNeeds = -1;
+    if ( vars )
+    {
+        for ( m_runNeeds = 0;
+              m_runNeeds < count && m_runNeeds < m_varCount;
+              m_runNeeds++ )
+        {
+            m_runNeed[m_runNeeds] = vars[m_runNeeds];
+        }
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets or clears a table cell's bit in the m_tableInRx[] bitmap.
+ *
+ *  \param cell Table cell index (row times m_tableCols plus column).
+ *  \param inRx TRUE if the cell's results are within prescription.
+ */
+
+void EqTree::setTableInRx( int cell, bool inRx )
+{
+    unsigned int bit = 1u << ( cell & 31 );
+    if ( inRx )
+    {
+        m_tableInRx[ cell >> 5 ] |= bit;
+    }
+    else
+    {
+        m_tableInRx[ cell >> 5 ] &= ~bit;
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines if a table output was interpolated at a cell by
+ *  runSurrogate() rather than calculated.
+ *
+ *  \param cell Table cell index (row times m_tableCols plus column).
+ *  \param var  Output variable index (base 0).
+ *
+ *  \return TRUE if the output is approximated and the cell's bit is set in
+ *  the m_tableApproxCell[] bitmap.
+ */
+
+bool EqTree::tableApprox( int cell, int var ) const
+{
+    if ( ! m_tableApproxCell || ! m_tableApprox[var] )
+    {
+        return( false );
+    }
+    return( ( m_tableApproxCell[ cell >> 5 ] & ( 1u << ( cell & 31 ) ) ) != 0 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines if a table cell's results are within prescription.
+ *
+ *  \param cell Table cell index (row times m_tableCols plus column).
+ *
+ *  \return TRUE if the cell's bit is set in the m_tableInRx[] bitmap.
+ */
+
+bool EqTree::tableInRx( int cell ) const
+{
+    if ( ! m_tableInRx )
+    {
+        return( false );
+    }
+    return( ( m_tableInRx[ cell >> 5 ] & ( 1u << ( cell & 31 ) ) ) != 0 );
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Validates all worksheet entry values and checks the number of
  *  range variables.
@@ -2256,7 +2855,7 @@ bool EqTree::writeXmlFile( const QString &fileName,
         return( false );
     }
     // Write the header, properties, variables, and footer.
-    xmlWriteHeader( fptr, elementName, elementType, appWindow()->m_release );
+    xmlWriteHeader( fptr, elementName, elementType, m_eqApp->m_release );
     m_propDict->writeXmlFile( fptr, release );
     m_rxVarList->writeXmlFile( fptr );
     writeXmlFile( fptr, release, writeValues );
@@ -22,15 +22,29 @@ class EqVarItemList;
 class FuelModelList;
 class MoisScenarioList;
 class PropertyDict;
+class ResultIndex;
+class ResultStore;
+class RunArena;
+class RunSnapshot;
 class RxVarList;
+class Transect;
+class WthrSeries;
 
 // Qt class references
 #include <qdict.h>
 #include <qstring.h>
 
 // Standard include files
+#include <float.h>
 #include <stdio.h>
 
+/*! \var EqTreeNoResult
+ *  \brief Result stored for an output that the run did not calculate
+ *  (see EqTree::m_tableCalc[]), or that has no value in a cell (such as a
+ *  transect arrival time beyond where the fire stops).
+ */
+static const double EqTreeNoResult = -DBL_MAX;
+
 //------------------------------------------------------------------------------
 /*! \class EqTree xeqtree.h
  *
@@ -90,18 +104,41 @@ public:
     void   reconfigure( int release ) ;
     int    rangeCase( void );
     bool   run( const QString &traceFile, const QString &resultFile ) ;
+    bool   runCellInRx( void ) ;
+    void   runCellResults( int row, int col ) ;
+    void  *runAlloc( Q_LLONG bytes ) ;
     void   runClean( void ) ;
+    // The runHourly() function is in xeqtreehourly.cpp
+    bool   runHourly( WthrSeries *wx, const QString &traceFile="",
+                const QString &resultFile="" ) ;
     bool   runInit( bool graphTable ) ;
     void   runInitColsFromStore( void ) ;
     void   runInitRowsFromRange( void ) ;
     void   runInitRowsFromStore( void ) ;
+    void   runInitInRx( int cells ) ;
+    void   runInitResults( void ) ;
     bool   runInitTableVars( void ) ;
+    int    runOutputs( EqVar **vars=0, int count=0 ) ;
+    void   runSetCell( int row, int col ) ;
+    // The runSurrogate*() functions are in xeqtreesurrogate.cpp
+    void   runSurrogate( void ) ;
+    int    runSurrogateInit( bool enabled, const bool *reuse ) ;
     bool   runTable( const QString &traceFile="", const QString &resultFile="",
                 bool graphTable=false ) ;
+    bool   runTableCells( const QString &traceFile, const QString &resultFile,
+                bool graphTable, bool incremental ) ;
+    bool   runTableVerify( const QString &traceFile, const QString &resultFile,
+                bool graphTable ) ;
+    // The runTransect() function is in xeqtreetransect.cpp
+    bool   runTransect( Transect *tr ) ;
     EqFun *setEqFunAddress( const QString &name, PFV address ) ;
+    void   setRunOutputs( EqVar **vars, int count ) ;
     void   setLabel( EqVar *varPtr, const QString &stuff ) ;
     void   setLanguage( const QString &lang ) ;
     double setResult( int row, int col, int var, double value ) ;
+    void   setTableInRx( int cell, bool inRx ) ;
+    bool   tableApprox( int cell, int var ) const ;
+    bool   tableInRx( int cell ) const ;
     int    validateInputs( int *badLid, int *badPosition, int *badLength ) ;
 	int    validateRxInputs( int *badRx ) ;
     void   variableModuleList( EqVar *varPtr, QString &str ) const ;
@@ -124,6 +161,8 @@ public:
     int             m_leafCount;    //!< Number of inputs in the leaf[] array
     EqVar         **m_root;         //!< Array of ptrs to current output EqVars
     int             m_rootCount;    //!< Number of outputs in the root[] array
+    EqVar         **m_runNeed;      //!< Outputs required by the next runTable()
+    int             m_runNeeds;     //!< Number of m_runNeed[] outputs, or -1 if all
     EqVarItemList **m_itemList;     //!< SHARED ptr to array of EqVarItemList ptrs
     int             m_itemListCount;//!< SHARED number of entries in m_itemList[] array
     QDict<EqFun>   *m_funDict;      //!< Name lookup access to local EqFun ptrs
@@ -143,12 +182,21 @@ public:
     int             m_tableRows;    //!< Results table rows
     int             m_tableCols;    //!< Results table columns
     int             m_tableVars;    //!< Results table variables
-    int             m_tableCells;   //!< Results table cells
+    Q_LLONG         m_tableCells;   //!< Results table values (cells times variables)
     double         *m_tableCol;     //!< Dynamic array of table column values
     double         *m_tableRow;     //!< Dynamic array of table row values
-    double         *m_tableVal;     //!< Dynamic array of table results
-    bool           *m_tableInRx;   	//!< Dynamic array of table shade toggles
+    ResultStore    *m_tableVal;     //!< Table results store
+    unsigned int   *m_tableInRx;    //!< Bitmap of table cells within prescription
     EqVar         **m_tableVar;     //!< Dynamic array of table EqVar ptrs
+    bool           *m_tableCalc;    //!< Dynamic array of m_tableVar[] calculated toggles (others are EqTreeNoResult)
+    bool           *m_tableApprox;  //!< Dynamic array of m_tableVar[] approximated toggles
+    unsigned int   *m_tableApproxCell;  //!< Bitmap of table cells with interpolated outputs, or 0
+    int             m_tableApproxCells; //!< Number of m_tableApproxCell[] bits set
+    double         *m_tableApproxError; //!< Dynamic array of m_tableVar[] largest approximation errors, or 0
+    ResultIndex    *m_tableIndex;   //!< Sorted indexes over the table results
+    RunArena       *m_runArena;     //!< Allocator for all the m_table*[] arrays
+    RunSnapshot    *m_runSnapshot[2];   //!< Previous table and graph runs
+    int             m_runReused;    //!< Output columns copied by the last run
     QString         m_resultFile;   //!< Run time result file name
     QString         m_traceFile;    //!< Run time trace file name
     FILE           *m_resultFptr;   //!< Run time result file stream ptr
@@ -0,0 +1,272 @@
+//------------------------------------------------------------------------------
+/*! \file xeqtreehourly.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Hourly scenario run for the Experimental Equation Tree.
+ *
+ *  An hourly run evaluates a single-valued worksheet once for every hour
+ *  of a WthrSeries.  Only the weather dependent inputs (fine dead fuel
+ *  moisture, wind speed and direction, air temperature and relative
+ *  humidity) are changed between hours.  Since EqVar::propagateDirty()
+ *  only marks their consumers as dirty, everything that does not depend
+ *  on the weather (fuel bed model and intermediates, live moisture, slope,
+ *  canopy, etc) is calculated for the first hour and reused thereafter.
+ */
+
+// Custom include files
+#include "appmessage.h"
+#include "apptranslator.h"
+#include "resultstore.h"
+#include "xeqcalc.h"
+#include "xeqtree.h"
+#include "xeqvar.h"
+#include "xeqvaritem.h"
+#include "wthrseries.h"
+
+// Qt include files
+#include <qapplication.h>
+#include <qprogressdialog.h>
+
+//------------------------------------------------------------------------------
+/*! \brief Sets a weather dependent input variable for the next hour.
+ *
+ *  The variable is only changed (and its consumers marked dirty)
+ *  if it is a current input and its value actually changes.
+ *
+ *  \param varPtr   Pointer to the input EqVar.
+ *  \param value    New value in native units.
+ */
+
+static void setHourlyInput( EqVar *varPtr, double value )
+{
+    if ( varPtr->m_isUserInput
+      && varPtr->m_nativeValue != value )
+    {
+        varPtr->setNativeValue( value );
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Creates a table of results for every hour of a weather series
+ *  using the current (single-valued) input values.
+ *
+ *  The resulting table has one row per hour (the row variable is
+ *  vWthrSeriesHour) and one column, so it may be displayed by
+ *  BpDocument::composeTable2() and BpDocument::composeGraphs().
+ *  The m_tableInRx[] bitmap holds the hourly prescription window.
+ *
+ *  Wind speed is applied to whichever wind speed input (20-ft, 10-m, or
+ *  midflame) the worksheet uses, and wind direction to whichever wind
+ *  direction input (from north or from upslope) the worksheet uses.
+ *  Fine dead fuel moisture that is not supplied by the series is derived
+ *  using the worksheet's slope, aspect, and canopy cover inputs (if any).
+ *
+ *  \param wx           Pointer to the hourly weather series.
+ *  \param traceFile    Name of the EqCalc processing log file.
+ *                      If NULL or empty, no log file is written.
+ *  \param resultFile   Name of the result file.
+ *                      If NULL or empty, no result file is written.
+ *
+ *  Called only by BpDocument::runHourly().
+ *
+ *  \return TRUE on success, FALSE on failure.
+ */
+
+bool EqTree::runHourly( WthrSeries *wx, const QString &traceFile,
+        const QString &resultFile )
+{
+    QString text("");
+    // Hourly runs require single-valued inputs.
+    if ( m_rangeVars > 0 )
+    {
+        translate( text, "EqTree:RunHourly:RangeVars" );
+        error( text );
+        return( false );
+    }
+    // The 1-h dead fuel moisture must be an input.
+    EqCalc *c = m_eqCalc;
+    if ( ! c->vSurfaceFuelMoisDead1->m_isUserInput )
+    {
+        translate( text, "EqTree:RunHourly:NoMoisDead1",
+            *(c->vSurfaceFuelMoisDead1->m_label) );
+        error( text );
+        return( false );
+    }
+    // Derive fine dead fuel moisture from the worksheet terrain and canopy.
+    double slope = ( c->vSiteSlopeFraction->m_isUserInput )
+                 ? c->vSiteSlopeFraction->m_nativeValue
+                 : 0.;
+    double aspect = ( c->vSiteAspectDirFromNorth->m_isUserInput )
+                  ? c->vSiteAspectDirFromNorth->m_nativeValue
+                  : 0.;
+    bool shaded = ( c->vTreeCanopyCover->m_isUserInput
+                 && c->vTreeCanopyCover->m_nativeValue >= 0.5 );
+    wx->deriveFdfmc( 0, slope, aspect, shaded );
+
+    // Set up the table with one row per hour and a single column.
+    runClean();
+    EqVar *hourVar = getVarPtr( "vWthrSeriesHour" );
+    m_rangeVar[0] = hourVar;
+    m_rangeVar[1] = 0;
+    m_rangeVars = 1;
+    m_rangeCase = 2;
+    m_tableRows = wx->m_hours;
+    m_tableRow = (double *) runAlloc( m_tableRows * sizeof(double) );
+    int row;
+    for ( row = 0;
+          row < m_tableRows;
+          row++ )
+    {
+        m_tableRow[row] = wx->elapsedHour( row );
+    }
+    m_tableCols = 1;
+    if ( ! runInitTableVars() )
+    {
+        runClean();
+        return( false );
+    }
+    m_tableCells = (Q_LLONG) m_tableRows * m_tableCols * m_tableVars;
+    runInitResults();
+    runInitInRx( m_tableRows );
+
+    // Attempt to open a new copy of the trace file.
+    EqVar *outVar = 0;
+    int vid;
+    if ( ! traceFile.isNull()
+     && ! traceFile.isEmpty() )
+    {
+        if ( ! traceFileInit( traceFile ) )
+        {
+            runClean();
+            return( false );
+        }
+        fprintf( m_traceFptr, "begin table %d %s %d %s %d\n",
+            m_tableRows, hourVar->m_name.latin1(), m_tableCols, "none",
+            m_tableVars );
+        for ( vid = 0;
+              vid < m_tableVars;
+              vid++ )
+        {
+            fprintf( m_traceFptr, "  output %d %s\n",
+                vid, m_tableVar[vid]->m_name.latin1() );
+        }
+    }
+    // Attempt to open a new copy of the result file
+    if ( ! resultFile.isNull()
+      && ! resultFile.isEmpty() )
+    {
+        if ( ! resultFileInit( resultFile ) )
+        {
+            traceFileClose();
+            return( false );
+        }
+        fprintf( m_resultFptr, "ROWS %d COLS %d VARS %d\n",
+            m_tableRows, m_tableCols, m_varCount );
+    }
+
+    // Set up the progress dialog.
+    QString caption(""), button("");
+    translate( caption, "EqTree:RunHourly:Progress:Caption",
+        QString( "%1" ).arg( m_tableRows ),
+        QString( "%1" ).arg( m_tableVars ),
+        wx->m_fileName );
+    translate( button, "EqTree:RunTable:Progress:Button" );
+    QProgressDialog *progress = new QProgressDialog( caption, button,
+        m_tableRows );
+    Q_CHECK_PTR( progress );
+    progress->setMinimumDuration( 0 );
+    progress->setProgress( 0 );
+
+    // Make an Equation Tree run for every hour.
+    EqVar *windVar = c->vWindSpeedAt20Ft;
+    if ( c->vWindSpeedAt10M->m_isUserInput )
+    {
+        windVar = c->vWindSpeedAt10M;
+    }
+    else if ( c->vWindSpeedAtMidflame->m_isUserInput )
+    {
+        windVar = c->vWindSpeedAtMidflame;
+    }
+    EqVar *dirVar = ( c->vWindDirFromUpslope->m_isUserInput )
+                  ? c->vWindDirFromUpslope
+                  : c->vWindDirFromNorth;
+    Q_LLONG var = 0;
+    for ( row = 0;
+          row < m_tableRows;
+          row++ )
+    {
+        // Only the weather dependent inputs change from hour to hour.
+        hourVar->setDisplayValue( m_tableRow[row] );
+        setHourlyInput( c->vSurfaceFuelMoisDead1, wx->m_fdfmc[row] );
+        setHourlyInput( windVar, wx->m_wind[row] );
+        setHourlyInput( dirVar, wx->m_windDir[row] );
+        setHourlyInput( c->vWthrAirTemp, wx->m_dryBulb[row] );
+        setHourlyInput( c->vWthrRelativeHumidity, wx->m_rh[row] );
+        if ( m_traceFptr )
+        {
+            fprintf( m_traceFptr,
+                "  begin row %d continuous %s \"%s\" %g \"%s\"\n",
+                row, hourVar->m_name.latin1(), hourVar->m_label->latin1(),
+                hourVar->m_nativeValue, hourVar->m_nativeUnits.latin1() );
+        }
+        if ( m_resultFptr )
+        {
+            fprintf( m_resultFptr, "ROW %d %s cont %g %s\n",
+                row+1, hourVar->m_name.latin1(), hourVar->m_displayValue,
+                hourVar->m_displayUnits.latin1() );
+        }
+        // Loop for each output variable.
+        for ( vid = 0;
+              vid < m_tableVars;
+              vid++ )
+        {
+            outVar = m_tableVar[ vid ];
+            calculateVariable( outVar, 0 );
+            if ( outVar->isDiscrete() )
+            {
+                m_tableVal->set( var++, 0.5 + (double)
+                    outVar->m_itemList->itemIdWithName(
+                        outVar->activeItemName() ) );
+            }
+            else if ( outVar->isContinuous() )
+            {
+                m_tableVal->set( var++, outVar->m_displayValue );
+            }
+        }
+        // Determine if this hour is within prescription.
+        setTableInRx( row, runCellInRx() );
+        runCellResults( row, 0 );
+        if ( m_traceFptr )
+        {
+            fprintf( m_traceFptr, "    end row %d %s\n",
+                row, hourVar->m_name.latin1() );
+        }
+        // Update progress dialog.
+        progress->setProgress( row+1 );
+        qApp->processEvents();
+        if ( progress->wasCancelled() )
+        {
+            delete progress;    progress = 0;
+            resultFileClose();
+            traceFileClose();
+            return( false );
+        }
+    }
+    // Log the table footer
+    if ( m_traceFptr )
+    {
+        fprintf( m_traceFptr, "end table %d %d %d\n",
+            m_tableRows, m_tableCols, m_tableVars );
+    }
+    // Clean up and return.
+    resultFileClose();
+    traceFileClose();
+    delete progress;    progress = 0;
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+//  End of xeqtreehourly.cpp
+//------------------------------------------------------------------------------
@@ -13,7 +13,7 @@
 // Custom include files
 #include "appmessage.h"
 #include "apptranslator.h"
-#include "appwindow.h"
+#include "fixeddecimal.h"
 #include "module.h"
 #include "property.h"
 #include "xeqapp.h"
@@ -1125,6 +1125,7 @@ void EqTree::printResults1( FILE *fptr ) const
     fprintf( fptr, "\n" );
 
     // Print results
+    char buffer[FixedDecimalBufferSize];
     double value;
     QString name("");
     int iid;
@@ -1136,7 +1137,8 @@ void EqTree::printResults1( FILE *fptr ) const
         value = m_tableRow[row];
         if ( rowPtr->isContinuous() )
         {
-            fprintf( fptr, "%10.*f", rowPtr->m_displayDecimals, value );
+            fixedDecimal( buffer, value, rowPtr->m_displayDecimals, 10 );
+            fputs( buffer, fptr );
         }
         else if ( rowPtr->isDiscrete() )
         {
@@ -1153,7 +1155,8 @@ void EqTree::printResults1( FILE *fptr ) const
             value = getResult( row, 0, var );
             if ( varPtr->isContinuous() )
             {
-                fprintf( fptr, "%10.*f", varPtr->m_displayDecimals, value );
+                fixedDecimal( buffer, value, varPtr->m_displayDecimals, 10 );
+                fputs( buffer, fptr );
             }
             else if ( varPtr->isDiscrete() )
             {
@@ -1177,6 +1180,7 @@ void EqTree::printResults2( FILE *fptr ) const
     EqVar *colPtr = m_rangeVar[1];
     EqVar *varPtr;
     int    row, col, var, iid;
+    char buffer[FixedDecimalBufferSize];
     double value;
     QString name("");
     // Separate table for each output variable
@@ -1208,7 +1212,8 @@ void EqTree::printResults2( FILE *fptr ) const
             value = m_tableCol[col];
             if ( colPtr->isContinuous() )
             {
-                fprintf( fptr, "%10.*f", colPtr->m_displayDecimals, value );
+                fixedDecimal( buffer, value, colPtr->m_displayDecimals, 10 );
+                fputs( buffer, fptr );
             }
             else if ( colPtr->isDiscrete() )
             {
@@ -1234,7 +1239,8 @@ void EqTree::printResults2( FILE *fptr ) const
             value = m_tableRow[row];
             if ( rowPtr->isContinuous() )
             {
-                fprintf( fptr, "%10.*f", rowPtr->m_displayDecimals, value );
+                fixedDecimal( buffer, value, rowPtr->m_displayDecimals, 10 );
+                fputs( buffer, fptr );
             }
             else if ( rowPtr->isDiscrete() )
             {
@@ -1250,7 +1256,8 @@ void EqTree::printResults2( FILE *fptr ) const
                 value = getResult( row, col, var );
                 if ( varPtr->isContinuous() )
                 {
-                    fprintf( fptr, "%10.*f", varPtr->m_displayDecimals, value );
+                    fixedDecimal( buffer, value, varPtr->m_displayDecimals, 10 );
+                    fputs( buffer, fptr );
                 }
                 else if ( varPtr->isDiscrete() )
                 {
@@ -1291,7 +1298,7 @@ void EqTree::printSummary( FILE *fptr ) const
           id < m_varCount;
           id++ )
     {
-        if ( m_var[id]->isCurrent( appWindow()->m_release ) )
+        if ( m_var[id]->isCurrent( m_eqApp->m_release ) )
         {
             varCount++;
         }
@@ -1302,7 +1309,7 @@ void EqTree::printSummary( FILE *fptr ) const
           id < m_funCount;
           id++ )
     {
-        if ( m_fun[id]->isCurrent( appWindow()->m_release ) )
+        if ( m_fun[id]->isCurrent( m_eqApp->m_release ) )
         {
             funCount++;
         }
@@ -1314,7 +1321,7 @@ void EqTree::printSummary( FILE *fptr ) const
     while( it.current() )
     {
         prop = (Property *) it.current();
-        if ( prop->isCurrent( appWindow()->m_release ) )
+        if ( prop->isCurrent( m_eqApp->m_release ) )
         {
             propCount++;
         }
@@ -1323,7 +1330,7 @@ void EqTree::printSummary( FILE *fptr ) const
     // Display counts
     fprintf( fptr, "\nRelease Usage\n" );
     fprintf( fptr, "%-12s   %05d   Total\n",
-        "Array", appWindow()->m_release );
+        "Array", m_eqApp->m_release );
     fprintf( fptr, "%-12s %7d %7d\n",
         "Function", funCount, m_funCount );
     fprintf( fptr, "%-12s %7d %7d\n",
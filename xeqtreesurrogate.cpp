@@ -0,0 +1,605 @@
+//------------------------------------------------------------------------------
+/*! \file xeqtreesurrogate.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Surrogate (interpolated) table columns for costly outputs.
+ *
+ *  A few functions cost far more than the rest of the tree: the
+ *  containment simulations (ContainFF() and ContainFFSingle()), the
+ *  two-dimensional expected spread rate of a two fuel model bed
+ *  (FuelBedWeighted() with "surfaceConfFuel2Dimensional"), and the crown
+ *  fire spread rate (CrownFireSpreadRate(), a complete fuel model 10 run).
+ *  When the "appSurrogateRun" property is set, the continuous table outputs
+ *  that depend upon them are not calculated at every cell.  Instead
+ *  runSurrogate() calculates them at the corners of blocks of cells and
+ *  interpolates them (bilinearly in the row and column values) over each
+ *  block.  A block is only accepted after its center cell and the midpoint
+ *  of each of its edges are also calculated and found to agree with the
+ *  interpolation to within the "appSurrogateTolerance" (a fraction of the
+ *  value, but never less than half of the output's last display decimal);
+ *  otherwise it is split and its parts are tested in turn.  Checking the
+ *  edges as well as the center catches most steps and thresholds that
+ *  cross a block between its corners.  The largest difference found at
+ *  any checked cell of an accepted block is the column's error estimate,
+ *  which is kept in m_tableApproxError[] for the results page, and the
+ *  interpolated cells are flagged in m_tableApproxCell[].
+ *
+ *  Only continuous row and column variables are interpolated over; each
+ *  value of a discrete range variable is treated separately.
+ */
+
+// Custom include files
+#include "appmessage.h"
+#include "appproperty.h"
+#include "property.h"
+#include "resultstore.h"
+#include "rxvar.h"
+#include "xeqcalc.h"
+#include "xeqtree.h"
+#include "xeqvar.h"
+
+// Qt include files
+#include <qptrdict.h>
+
+// Standard include files
+#include <math.h>
+
+/*! \var SurrogateMaxSpan
+ *  \brief Largest block (in table intervals along each axis) that is tested
+ *  as a whole.
+ */
+static const int SurrogateMaxSpan = 8;
+
+/*! \var SurrogateMinCells
+ *  \brief Smallest table (in cells) for which outputs are approximated.
+ */
+static const int SurrogateMinCells = 16;
+
+/*! \var SurrogateMaxCostly
+ *  \brief Size of the costly function array.
+ */
+static const int SurrogateMaxCostly = 8;
+
+//------------------------------------------------------------------------------
+/*! \class SurrogateRun xeqtreesurrogate.cpp
+ *
+ *  \brief Working data for a single EqTree::runSurrogate().
+ */
+
+class SurrogateRun
+{
+public:
+    EqTree *m_tree;         //!< Tree being run
+    int     m_outputs;      //!< Number of approximated output columns
+    int    *m_vid;          //!< m_tableVar[] index of each approximated output
+    double *m_absTol;       //!< Half of each output's last display decimal
+    double *m_error;        //!< Largest accepted error estimate of each output
+    double *m_blockError;   //!< Error estimates for the current block
+    char   *m_state;        //!< Each cell is 0=pending, 1=calculated, 2=interpolated
+    double  m_relTol;       //!< Acceptable relative error
+    int     m_evals;        //!< Number of cells calculated
+};
+
+//------------------------------------------------------------------------------
+/*! \brief Determines which of the \a costly functions lie upstream of
+ *  \a varPtr through the currently active producers.
+ *
+ *  \param varPtr   Pointer to the variable.
+ *  \param costly   Array of costly function pointers.
+ *  \param costlys  Number of functions in \a costly.
+ *  \param seen     Variables already visited.
+ *
+ *  \return Bit mask of the costly functions found.
+ */
+
+static int costlyMask( EqVar *varPtr, EqFun **costly, int costlys,
+        QPtrDict<EqVar> &seen )
+{
+    if ( seen.find( varPtr ) )
+    {
+        return( 0 );
+    }
+    seen.insert( varPtr, varPtr );
+    EqFun *funPtr = varPtr->activeProducerFunPtr();
+    if ( ! funPtr )
+    {
+        return( 0 );
+    }
+    int mask = 0;
+    int i;
+    for ( i = 0;
+          i < costlys;
+          i++ )
+    {
+        if ( funPtr == costly[i] )
+        {
+            mask |= ( 1 << i );
+        }
+    }
+    for ( i = 0;
+          i < funPtr->m_inputs;
+          i++ )
+    {
+        mask |= costlyMask( funPtr->m_input[i], costly, costlys, seen );
+    }
+    return( mask );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Calculates all the approximated outputs for the cell at \a row
+ *  and \a col (if not already done) and stores them in the result store.
+ */
+
+static void surrogateEval( SurrogateRun *s, int row, int col )
+{
+    EqTree *t = s->m_tree;
+    int cell = row * t->m_tableCols + col;
+    if ( s->m_state[cell] == 1 )
+    {
+        return;
+    }
+    t->runSetCell( row, col );
+    EqVar *outVar;
+    for ( int i = 0;
+          i < s->m_outputs;
+          i++ )
+    {
+        outVar = t->m_tableVar[ s->m_vid[i] ];
+        t->calculateVariable( outVar, 0 );
+        t->m_tableVal->set( (Q_LLONG) cell * t->m_tableVars + s->m_vid[i],
+            outVar->m_displayValue );
+    }
+    s->m_state[cell] = 1;
+    s->m_evals++;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the stored result of approximated output \a i at
+ *  \a row and \a col.
+ */
+
+static double surrogateValue( SurrogateRun *s, int row, int col, int i )
+{
+    EqTree *t = s->m_tree;
+    return( t->m_tableVal->get(
+        ( (Q_LLONG) row * t->m_tableCols + col ) * t->m_tableVars
+        + s->m_vid[i] ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Interpolates approximated output \a i at \a row and \a col from
+ *  the corners of the block \a r0 - \a r1 by \a c0 - \a c1.
+ */
+
+static double surrogateInterp( SurrogateRun *s, int r0, int r1, int c0,
+        int c1, int row, int col, int i )
+{
+    EqTree *t = s->m_tree;
+    double tr = 0.;
+    double tc = 0.;
+    if ( r1 > r0 && t->m_tableRow[r1] != t->m_tableRow[r0] )
+    {
+        tr = ( t->m_tableRow[row] - t->m_tableRow[r0] )
+           / ( t->m_tableRow[r1] - t->m_tableRow[r0] );
+    }
+    if ( c1 > c0 && t->m_tableCol[c1] != t->m_tableCol[c0] )
+    {
+        tc = ( t->m_tableCol[col] - t->m_tableCol[c0] )
+           / ( t->m_tableCol[c1] - t->m_tableCol[c0] );
+    }
+    return( ( 1. - tr ) * ( ( 1. - tc ) * surrogateValue( s, r0, c0, i )
+                                 + tc   * surrogateValue( s, r0, c1, i ) )
+                 + tr   * ( ( 1. - tc ) * surrogateValue( s, r1, c0, i )
+                                 + tc   * surrogateValue( s, r1, c1, i ) ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Fills the block of cells \a r0 - \a r1 by \a c0 - \a c1,
+ *  either by interpolation from its corners if its center and edge
+ *  midpoint cells agree, or else by splitting it and filling each part.
+ */
+
+static void surrogateBlock( SurrogateRun *s, int r0, int r1, int c0, int c1 )
+{
+    // Every block's corners are calculated
+    surrogateEval( s, r0, c0 );
+    surrogateEval( s, r0, c1 );
+    surrogateEval( s, r1, c0 );
+    surrogateEval( s, r1, c1 );
+    if ( r1 - r0 < 2 && c1 - c0 < 2 )
+    {
+        return;
+    }
+    // Test the block's center and edge midpoint cells against the
+    // interpolation
+    int rm = ( r0 + r1 ) / 2;
+    int cm = ( c0 + c1 ) / 2;
+    int testRow[5], testCol[5];
+    int tests = 0;
+    testRow[tests] = rm;    testCol[tests++] = cm;
+    if ( r1 - r0 >= 2 )
+    {
+        testRow[tests] = rm;    testCol[tests++] = c0;
+        testRow[tests] = rm;    testCol[tests++] = c1;
+    }
+    if ( c1 - c0 >= 2 )
+    {
+        testRow[tests] = r0;    testCol[tests++] = cm;
+        testRow[tests] = r1;    testCol[tests++] = cm;
+    }
+    int i, j, row, col;
+    double value, error, tol;
+    bool accept = false;
+    if ( r1 - r0 <= SurrogateMaxSpan
+      && c1 - c0 <= SurrogateMaxSpan )
+    {
+        accept = true;
+        for ( i = 0;
+              i < s->m_outputs;
+              i++ )
+        {
+            s->m_blockError[i] = 0.;
+        }
+        for ( j = 0;
+              j < tests && accept;
+              j++ )
+        {
+            row = testRow[j];
+            col = testCol[j];
+            surrogateEval( s, row, col );
+            for ( i = 0;
+                  i < s->m_outputs && accept;
+                  i++ )
+            {
+                value = surrogateValue( s, row, col, i );
+                error = fabs( value
+                    - surrogateInterp( s, r0, r1, c0, c1, row, col, i ) );
+                if ( error > s->m_blockError[i] )
+                {
+                    s->m_blockError[i] = error;
+                }
+                tol = s->m_relTol * fabs( value );
+                if ( tol < s->m_absTol[i] )
+                {
+                    tol = s->m_absTol[i];
+                }
+                accept = ( error <= tol );
+            }
+        }
+    }
+    // Interpolate the rest of an accepted block
+    EqTree *t = s->m_tree;
+    if ( accept )
+    {
+        for ( row = r0;
+              row <= r1;
+              row++ )
+        {
+            for ( col = c0;
+                  col <= c1;
+                  col++ )
+            {
+                int cell = row * t->m_tableCols + col;
+                if ( s->m_state[cell] )
+                {
+                    continue;
+                }
+                for ( i = 0;
+                      i < s->m_outputs;
+                      i++ )
+                {
+                    t->m_tableVal->set(
+                        (Q_LLONG) cell * t->m_tableVars + s->m_vid[i],
+                        surrogateInterp( s, r0, r1, c0, c1, row, col, i ) );
+                }
+                s->m_state[cell] = 2;
+            }
+        }
+        for ( i = 0;
+              i < s->m_outputs;
+              i++ )
+        {
+            if ( s->m_blockError[i] > s->m_error[i] )
+            {
+                s->m_error[i] = s->m_blockError[i];
+            }
+        }
+        return;
+    }
+    // Otherwise split the block along every axis that can be split
+    if ( r1 - r0 >= 2 && c1 - c0 >= 2 )
+    {
+        surrogateBlock( s, r0, rm, c0, cm );
+        surrogateBlock( s, r0, rm, cm, c1 );
+        surrogateBlock( s, rm, r1, c0, cm );
+        surrogateBlock( s, rm, r1, cm, c1 );
+    }
+    else if ( r1 - r0 >= 2 )
+    {
+        surrogateBlock( s, r0, rm, c0, c1 );
+        surrogateBlock( s, rm, r1, c0, c1 );
+    }
+    else
+    {
+        surrogateBlock( s, r0, r1, c0, cm );
+        surrogateBlock( s, r0, r1, cm, c1 );
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines the next initial block along a table axis.
+ *
+ *  \param start    Index of the block's first value.
+ *  \param values   Number of values along the axis.
+ *  \param interp   TRUE if the axis may be interpolated over.
+ *
+ *  \return Index of the block's last value.
+ */
+
+static int surrogateBlockEnd( int start, int values, bool interp )
+{
+    if ( ! interp )
+    {
+        return( start );
+    }
+    int end = start + SurrogateMaxSpan;
+    return( ( end < values ) ? end : values - 1 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Fills the approximated output columns selected by
+ *  runSurrogateInit() for every cell of the table.
+ *
+ *  The last table cell is always calculated, and is set last so the input
+ *  and output variables are left just as a full run would leave them.
+ *  Each output's error estimate is stored in m_tableApproxError[] and the
+ *  interpolated cells are flagged in the m_tableApproxCell[] bitmap.  The
+ *  number of cells calculated and the error estimates are also written to
+ *  the log file.
+ *
+ *  Called only by EqTree::runTableCells().
+ */
+
+void EqTree::runSurrogate( void )
+{
+    SurrogateRun s;
+    s.m_tree = this;
+    s.m_outputs = 0;
+    s.m_evals = 0;
+    s.m_relTol = appProperty()->real( "appSurrogateTolerance" );
+    s.m_vid = new int[ m_tableVars ];
+    checkmem( __FILE__, __LINE__, s.m_vid, "int m_vid", m_tableVars );
+    s.m_absTol = new double[ 3 * m_tableVars ];
+    checkmem( __FILE__, __LINE__, s.m_absTol, "double m_absTol",
+        3 * m_tableVars );
+    s.m_error = s.m_absTol + m_tableVars;
+    s.m_blockError = s.m_error + m_tableVars;
+    int vid, i;
+    for ( vid = 0;
+          vid < m_tableVars;
+          vid++ )
+    {
+        if ( m_tableApprox[vid] )
+        {
+            s.m_vid[s.m_outputs] = vid;
+            s.m_absTol[s.m_outputs] =
+                0.5 * pow( 10., -m_tableVar[vid]->m_displayDecimals );
+            s.m_error[s.m_outputs] = 0.;
+            s.m_outputs++;
+        }
+    }
+    int cells = m_tableRows * m_tableCols;
+    s.m_state = new char[ cells ];
+    checkmem( __FILE__, __LINE__, s.m_state, "char m_state", cells );
+    int cell;
+    for ( cell = 0;
+          cell < cells;
+          cell++ )
+    {
+        s.m_state[cell] = 0;
+    }
+    // Fill each initial block
+    bool rowInterp = m_rangeVar[0] && m_rangeVar[0]->isContinuous();
+    bool colInterp = m_rangeVar[1] && m_rangeVar[1]->isContinuous();
+    int r0, r1, c0, c1;
+    r0 = 0;
+    while ( true )
+    {
+        r1 = surrogateBlockEnd( r0, m_tableRows, rowInterp );
+        c0 = 0;
+        while ( true )
+        {
+            c1 = surrogateBlockEnd( c0, m_tableCols, colInterp );
+            surrogateBlock( &s, r0, r1, c0, c1 );
+            if ( c1 >= m_tableCols - 1 )
+            {
+                break;
+            }
+            // Interpolated blocks share their edges
+            c0 = ( colInterp ) ? c1 : c1 + 1;
+        }
+        if ( r1 >= m_tableRows - 1 )
+        {
+            break;
+        }
+        r0 = ( rowInterp ) ? r1 : r1 + 1;
+    }
+    // Keep the interpolated cells and error estimates for the results
+    int words = ( cells + 31 ) >> 5;
+    m_tableApproxCell = (unsigned int *)
+        runAlloc( (Q_LLONG) words * sizeof(unsigned int) );
+    for ( i = 0;
+          i < words;
+          i++ )
+    {
+        m_tableApproxCell[i] = 0;
+    }
+    m_tableApproxCells = 0;
+    for ( cell = 0;
+          cell < cells;
+          cell++ )
+    {
+        if ( s.m_state[cell] == 2 )
+        {
+            m_tableApproxCell[ cell >> 5 ] |= 1u << ( cell & 31 );
+            m_tableApproxCells++;
+        }
+    }
+    m_tableApproxError = (double *) runAlloc( m_tableVars * sizeof(double) );
+    for ( vid = 0;
+          vid < m_tableVars;
+          vid++ )
+    {
+        m_tableApproxError[vid] = 0.;
+    }
+    for ( i = 0;
+          i < s.m_outputs;
+          i++ )
+    {
+        m_tableApproxError[ s.m_vid[i] ] = s.m_error[i];
+    }
+    // Leave the variables just as a full run would
+    runSetCell( m_tableRows - 1, m_tableCols - 1 );
+    for ( vid = 0;
+          vid < m_tableVars;
+          vid++ )
+    {
+        if ( m_tableApprox[vid] )
+        {
+            calculateVariable( m_tableVar[vid], 0 );
+        }
+    }
+
+    // Log the savings and error estimates
+    QString msg = QString( "EqTree::runSurrogate() calculated %1 of %2 cells "
+        "(%3 times fewer) for %4 outputs; estimated errors" )
+        .arg( s.m_evals ).arg( cells )
+        .arg( (double) cells / (double) s.m_evals, 0, 'f', 1 )
+        .arg( s.m_outputs );
+    for ( i = 0;
+          i < s.m_outputs;
+          i++ )
+    {
+        msg += QString( " %1 %2" )
+            .arg( m_tableVar[ s.m_vid[i] ]->m_name )
+            .arg( s.m_error[i], 0, 'g', 3 );
+    }
+    log( msg + ".\n" );
+    delete[] s.m_state;
+    delete[] s.m_absTol;
+    delete[] s.m_vid;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Determines which output columns of the table set up by runInit()
+ *  are approximated by runSurrogate() instead of calculated at every cell.
+ *
+ *  Outputs are approximated only if the "appSurrogateRun" property is set,
+ *  the table has at least SurrogateMinCells cells and a continuous range
+ *  variable, and the output is a continuous, calculated, non-prescription
+ *  output that depends upon a costly function.  A costly function that is
+ *  also needed by some output that is calculated at every cell saves
+ *  nothing, so it doesn't count.
+ *
+ *  \param enabled  FALSE if the run must calculate every output at every
+ *                  cell (e.g., because it writes a trace or result file).
+ *  \param reuse    Array of output columns copied from the previous run,
+ *                  which are neither calculated nor approximated.
+ *
+ *  Called only by EqTree::runTableCells().
+ *
+ *  \return Number of approximated output columns.
+ */
+
+int EqTree::runSurrogateInit( bool enabled, const bool *reuse )
+{
+    int vid;
+    m_tableApprox = (bool *) runAlloc( m_tableVars * sizeof(bool) );
+    m_tableApproxCell = 0;
+    m_tableApproxCells = 0;
+    m_tableApproxError = 0;
+    for ( vid = 0;
+          vid < m_tableVars;
+          vid++ )
+    {
+        m_tableApprox[vid] = false;
+    }
+    if ( ! enabled
+      || ! appProperty()->boolean( "appSurrogateRun" )
+      || m_tableRows * m_tableCols < SurrogateMinCells
+      || ! ( ( m_rangeVar[0] && m_rangeVar[0]->isContinuous() )
+          || ( m_rangeVar[1] && m_rangeVar[1]->isContinuous() ) ) )
+    {
+        return( 0 );
+    }
+    // The costly functions
+    EqFun *costly[SurrogateMaxCostly];
+    int costlys = 0;
+    costly[costlys++] = m_eqCalc->fContainFF;
+    costly[costlys++] = m_eqCalc->fContainFFSingle;
+    costly[costlys++] = m_eqCalc->fCrownFireSpreadRate;
+    if ( m_propDict->boolean( "surfaceConfFuel2Dimensional" ) )
+    {
+        costly[costlys++] = m_eqCalc->fSurfaceFuelBedWeighted;
+    }
+    // Determine the costly functions each calculated output depends upon
+    int *mask = new int[ m_tableVars ];
+    checkmem( __FILE__, __LINE__, mask, "int mask", m_tableVars );
+    int needed = 0;
+    RxVar *rxVar;
+    EqVar *outVar;
+    for ( vid = 0;
+          vid < m_tableVars;
+          vid++ )
+    {
+        mask[vid] = 0;
+        if ( ! m_tableCalc[vid] || reuse[vid] )
+        {
+            continue;
+        }
+        outVar = m_tableVar[vid];
+        QPtrDict<EqVar> seen( 257 );
+        mask[vid] = costlyMask( outVar, costly, costlys, seen );
+        bool approx = ( mask[vid] && outVar->isContinuous() );
+        for ( rxVar = m_rxVarList->first();
+              rxVar && approx;
+              rxVar = m_rxVarList->next() )
+        {
+            approx = ! ( rxVar->m_isActive && rxVar->m_varPtr == outVar );
+        }
+        if ( approx )
+        {
+            m_tableApprox[vid] = true;
+        }
+        else
+        {
+            needed |= mask[vid];
+        }
+    }
+    // Approximate only outputs that save at least one costly function
+    int approximated = 0;
+    for ( vid = 0;
+          vid < m_tableVars;
+          vid++ )
+    {
+        if ( m_tableApprox[vid] )
+        {
+            m_tableApprox[vid] = ( ( mask[vid] & ~needed ) != 0 );
+            if ( m_tableApprox[vid] )
+            {
+                approximated++;
+            }
+        }
+    }
+    delete[] mask;
+    return( approximated );
+}
+
+//------------------------------------------------------------------------------
+//  End of xeqtreesurrogate.cpp
+//------------------------------------------------------------------------------
+
@@ -0,0 +1,358 @@
+//------------------------------------------------------------------------------
+/*! \file xeqtreetransect.cpp
+ *  \version BehavePlus5
+ *  \author Copyright (C) 2002-2011 by Collin D. Bevins.  All rights reserved.
+ *
+ *  \brief Fire transect run for the Experimental Equation Tree.
+ *
+ *  A transect run carries a head fire across an ordered sequence of
+ *  segments (see Transect), each with its own length and inputs.  The
+ *  worksheet outputs are calculated once for each distinct segment input
+ *  state, and only the inputs that differ from the previously calculated
+ *  state are reset, so EqVar::propagateDirty() limits recalculation to
+ *  what those inputs affect.  The segments are then filled in from their
+ *  states and the head fire arrival time is accumulated along the
+ *  transect, so even very long transects take little more time than their
+ *  distinct states.
+ */
+
+// Custom include files
+#include "appmessage.h"
+#include "apptranslator.h"
+#include "resultstore.h"
+#include "transect.h"
+#include "xeqcalc.h"
+#include "xeqtree.h"
+#include "xeqvar.h"
+#include "xeqvaritem.h"
+
+// Qt include files
+#include <qapplication.h>
+#include <qprogressdialog.h>
+
+//------------------------------------------------------------------------------
+/*! \brief Sets a transect input variable from its worksheet text value.
+ *
+ *  \param varPtr   Pointer to the input EqVar.
+ *  \param value    Value in display units, or item name.
+ *
+ *  \return TRUE on success, FALSE if the value is invalid.
+ */
+
+static bool setTransectInput( EqVar *varPtr, const QString &value )
+{
+    if ( varPtr->isContinuous() )
+    {
+        bool ok;
+        double d = value.toDouble( &ok );
+        if ( ! ok || ! varPtr->isValidRange( d ) )
+        {
+            return( false );
+        }
+        varPtr->setDisplayValue( d );
+    }
+    else if ( varPtr->isDiscrete() )
+    {
+        EqVarItem *item = varPtr->m_itemList->itemWithName( value, false );
+        if ( ! item )
+        {
+            return( false );
+        }
+        varPtr->setItemName( item->m_name );
+    }
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Creates a table of results for every segment of a fire transect
+ *  using the current (single-valued) input values as modified by each
+ *  segment.
+ *
+ *  The resulting table has one row per segment (the row variable is
+ *  vTransectDistance, the distance to the segment's far end) and one
+ *  column, so it may be displayed by BpDocument::composeTable2() and
+ *  BpDocument::composeGraphs().  The worksheet outputs are followed by an
+ *  additional vTransectArrivalTime output, the time for the head fire to
+ *  reach the segment's far end from the start of the transect, or
+ *  EqTreeNoResult for segments at and beyond where the fire stops.  The head
+ *  fire spread rate is the surface fire spread rate, or the crown fire
+ *  spread rate wherever the crown module finds an active crown fire.
+ *
+ *  \param tr   Pointer to the transect.
+ *
+ *  Called only by BpDocument::runTransect().
+ *
+ *  \return TRUE on success, FALSE on failure.
+ */
+
+bool EqTree::runTransect( Transect *tr )
+{
+    QString text("");
+    // Transect runs require single-valued inputs.
+    if ( m_rangeVars > 0 )
+    {
+        translate( text, "EqTree:RunTransect:RangeVars" );
+        error( text );
+        return( false );
+    }
+    // The head fire spread rate must be calculated.
+    EqCalc *c = m_eqCalc;
+    if ( ! c->vSurfaceFireSpreadAtHead->activeProducerFunPtr() )
+    {
+        translate( text, "EqTree:RunTransect:NoSpreadRate",
+            *(c->vSurfaceFireSpreadAtHead->m_label) );
+        error( text );
+        return( false );
+    }
+    bool crown = ( c->vCrownFireActiveCrown->activeProducerFunPtr()
+                && c->vCrownFireSpreadRate->activeProducerFunPtr() );
+
+    // Every transect variable must be a worksheet input.
+    EqVar *input[TransectMaxInputs];
+    double inputValue[TransectMaxInputs];
+    QString inputItem[TransectMaxInputs];
+    QString inputLast[TransectMaxInputs];
+    int i;
+    for ( i = 0;
+          i < tr->m_inputs;
+          i++ )
+    {
+        input[i] = m_varDict->find( tr->m_input[i] );
+        if ( ! input[i] || ! input[i]->m_isUserInput )
+        {
+            translate( text, "EqTree:RunTransect:NotInput", tr->m_input[i],
+                tr->m_fileName );
+            error( text );
+            return( false );
+        }
+        // Remember the worksheet value
+        inputValue[i] = input[i]->m_displayValue;
+        inputItem[i] = input[i]->activeItemName();
+        inputLast[i] = "";
+    }
+
+    // Set up the table with one row per segment and a single column.
+    runClean();
+    EqVar *distVar = getVarPtr( "vTransectDistance" );
+    EqVar *timeVar = getVarPtr( "vTransectArrivalTime" );
+    m_rangeVar[0] = distVar;
+    m_rangeVar[1] = 0;
+    m_rangeVars = 1;
+    m_rangeCase = 2;
+    m_tableRows = tr->m_segments;
+    m_tableRow = (double *) runAlloc( m_tableRows * sizeof(double) );
+    m_tableCols = 1;
+    if ( ! runInitTableVars() )
+    {
+        runClean();
+        return( false );
+    }
+    // Append the arrival time to the output variables
+    int outputs = m_tableVars;
+    EqVar **tableVar = (EqVar **) runAlloc( ( outputs + 1 ) * sizeof(EqVar *) );
+    bool *tableCalc = (bool *) runAlloc( ( outputs + 1 ) * sizeof(bool) );
+    int vid;
+    for ( vid = 0;
+          vid < outputs;
+          vid++ )
+    {
+        tableVar[vid] = m_tableVar[vid];
+        tableCalc[vid] = m_tableCalc[vid];
+    }
+    tableVar[outputs] = timeVar;
+    tableCalc[outputs] = true;
+    m_tableVar = tableVar;
+    m_tableCalc = tableCalc;
+    m_tableVars = outputs + 1;
+    m_tableCells = (Q_LLONG) m_tableRows * m_tableCols * m_tableVars;
+    runInitResults();
+    runInitInRx( m_tableRows );
+
+    // Set up the progress dialog.
+    QString caption(""), button("");
+    translate( caption, "EqTree:RunTransect:Progress:Caption",
+        QString( "%1" ).arg( tr->m_states ),
+        QString( "%1" ).arg( tr->m_segments ),
+        tr->m_fileName );
+    translate( button, "EqTree:RunTable:Progress:Button" );
+    QProgressDialog *progress = new QProgressDialog( caption, button,
+        tr->m_states );
+    Q_CHECK_PTR( progress );
+    progress->setMinimumDuration( 0 );
+    progress->setProgress( 0 );
+
+    // Calculate the outputs and head fire spread rate of each input state.
+    double *stateVal = new double[ tr->m_states * outputs + 1 ];
+    checkmem( __FILE__, __LINE__, stateVal, "double stateVal",
+        tr->m_states * outputs + 1 );
+    double *stateRos = new double[ tr->m_states ];
+    checkmem( __FILE__, __LINE__, stateRos, "double stateRos", tr->m_states );
+    bool *stateRx = new bool[ tr->m_states ];
+    checkmem( __FILE__, __LINE__, stateRx, "bool stateRx", tr->m_states );
+    EqVar *outVar;
+    int state;
+    bool ok = true;
+    for ( state = 0;
+          state < tr->m_states && ok;
+          state++ )
+    {
+        // Only reset the inputs that differ from the previous state.
+        for ( i = 0;
+              i < tr->m_inputs && ok;
+              i++ )
+        {
+            const QString &value = tr->value( state, i );
+            if ( state > 0 && value == inputLast[i] )
+            {
+                continue;
+            }
+            inputLast[i] = value;
+            if ( ! value.isEmpty() )
+            {
+                ok = setTransectInput( input[i], value );
+            }
+            else if ( input[i]->isContinuous() )
+            {
+                input[i]->setDisplayValue( inputValue[i] );
+            }
+            else if ( input[i]->isDiscrete() )
+            {
+                input[i]->setItemName( inputItem[i] );
+            }
+            if ( ! ok )
+            {
+                translate( text, "EqTree:RunTransect:BadValue",
+                    tr->m_input[i] + "=" + value, tr->m_fileName,
+                    QString( "%1" ).arg(
+                        tr->m_line[ tr->m_stateSegment[state] ] ) );
+            }
+        }
+        if ( ! ok )
+        {
+            break;
+        }
+        for ( vid = 0;
+              vid < outputs;
+              vid++ )
+        {
+            outVar = m_tableVar[ vid ];
+            calculateVariable( outVar, 0 );
+            if ( outVar->isDiscrete() )
+            {
+                stateVal[ state * outputs + vid ] = 0.5 + (double)
+                    outVar->m_itemList->itemIdWithName(
+                        outVar->activeItemName() );
+            }
+            else
+            {
+                stateVal[ state * outputs + vid ] = outVar->m_displayValue;
+            }
+        }
+        calculateVariable( c->vSurfaceFireSpreadAtHead, 0 );
+        stateRos[state] = c->vSurfaceFireSpreadAtHead->m_nativeValue;
+        if ( crown )
+        {
+            calculateVariable( c->vCrownFireActiveCrown, 0 );
+            if ( c->vCrownFireActiveCrown->activeItemDataIndex() == 1 )
+            {
+                calculateVariable( c->vCrownFireSpreadRate, 0 );
+                stateRos[state] = c->vCrownFireSpreadRate->m_nativeValue;
+            }
+        }
+        stateRx[state] = runCellInRx();
+
+        // Update progress dialog.
+        progress->setProgress( state+1 );
+        qApp->processEvents();
+        if ( progress->wasCancelled() )
+        {
+            text = "";
+            ok = false;
+        }
+    }
+    delete progress;    progress = 0;
+
+    // Restore the worksheet input values.
+    for ( i = 0;
+          i < tr->m_inputs;
+          i++ )
+    {
+        if ( input[i]->isContinuous() )
+        {
+            input[i]->setDisplayValue( inputValue[i] );
+        }
+        else if ( input[i]->isDiscrete() )
+        {
+            input[i]->setItemName( inputItem[i] );
+        }
+    }
+    if ( ! ok )
+    {
+        delete[] stateVal;
+        delete[] stateRos;
+        delete[] stateRx;
+        if ( ! text.isEmpty() )
+        {
+            error( text );
+        }
+        return( false );
+    }
+
+    // Accumulate distance and arrival time along the transect.
+    // Both are converted from native to display units by a single factor.
+    distVar->setNativeValue( 1. );
+    double distFactor = distVar->m_displayValue;
+    timeVar->setNativeValue( 1. );
+    double timeFactor = timeVar->m_displayValue;
+    double dist = 0.;
+    double time = 0.;
+    int stopped = -1;
+    int row;
+    Q_LLONG var;
+    for ( row = 0, var = 0;
+          row < m_tableRows;
+          row++ )
+    {
+        state = tr->m_state[row];
+        dist += tr->m_length[row];
+        m_tableRow[row] = dist * distFactor;
+        if ( stopped < 0 && stateRos[state] > 0. )
+        {
+            time += tr->m_length[row] / stateRos[state];
+        }
+        else if ( stopped < 0 )
+        {
+            stopped = row;
+        }
+        for ( vid = 0;
+              vid < outputs;
+              vid++ )
+        {
+            m_tableVal->set( var++, stateVal[ state * outputs + vid ] );
+        }
+        // The fire never arrives beyond the segment where it stops
+        m_tableVal->set( var++,
+            ( stopped < 0 ) ? time * timeFactor : EqTreeNoResult );
+        setTableInRx( row, stateRx[state] );
+    }
+    distVar->setNativeValue( dist );
+    timeVar->setNativeValue( time );
+    log( QString( "EqTree::runTransect() calculated %1 input states for %2 "
+        "segments of \"%3\".\n" )
+        .arg( tr->m_states ).arg( tr->m_segments ).arg( tr->m_fileName ) );
+    if ( stopped >= 0 )
+    {
+        translate( text, "EqTree:RunTransect:NoArrival",
+            QString( "%1" ).arg( tr->m_line[stopped] ), tr->m_fileName );
+        warn( text );
+    }
+    delete[] stateVal;
+    delete[] stateRos;
+    delete[] stateRx;
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+//  End of xeqtreetransect.cpp
+//------------------------------------------------------------------------------
+
@@ -173,6 +173,11 @@ EqVar::EqVar( const QString &name, const QString &help,
     m_producers(0),
     m_tokens(0),
     m_store(""),
+    m_storeParsed(),
+    m_storeValue(0),
+    m_storeValues(0),
+    m_storeValueSize(0),
+    m_storeSerial(0),
     m_isUserOutput(false),
     m_isUserInput(false),
     m_isConstant(false),
@@ -234,6 +239,11 @@ EqVar::EqVar( const QString &name, const QString &help,
     m_producers(0),
     m_tokens(0),
     m_store(""),
+    m_storeParsed(),
+    m_storeValue(0),
+    m_storeValues(0),
+    m_storeValueSize(0),
+    m_storeSerial(0),
     m_isUserOutput(false),
     m_isUserInput(false),
     m_isConstant(false),
@@ -295,6 +305,11 @@ EqVar::EqVar( const QString &name, const QString &help,
     m_producers(0),
     m_tokens(0),
     m_store(""),
+    m_storeParsed(),
+    m_storeValue(0),
+    m_storeValues(0),
+    m_storeValueSize(0),
+    m_storeSerial(0),
     m_isUserOutput(false),
     m_isUserInput(false),
     m_isConstant(false),
@@ -338,6 +353,7 @@ EqVar::~EqVar( void )
 {
     delete[] m_consumer;    m_consumer = 0;
     delete[] m_producer;    m_producer = 0;
+    delete[] m_storeValue;  m_storeValue = 0;
     return;
 }
 
@@ -662,6 +678,31 @@ bool EqVar::isDiscrete( void ) const
     return( m_varType == VarType_Discrete );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Determines if the m_storeValue[] array is current with the m_store.
+ *
+ *  The array is current only if it was filled from the same m_store text
+ *  (and, for discrete variables, the same EqVarItemList ordering),
+ *  and only if every token in that text was valid.
+ *
+ *  \return TRUE if m_storeValue[] may be used in place of parsing m_store.
+ */
+
+bool EqVar::isParsedStore( void ) const
+{
+    if ( m_storeParsed.isNull()
+      || m_storeParsed != m_store )
+    {
+        return( false );
+    }
+    if ( m_itemList
+      && m_itemList->m_serial != m_storeSerial )
+    {
+        return( false );
+    }
+    return( true );
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Determines if EqVar is a text variable.
  *
@@ -737,6 +778,27 @@ bool EqVar::isValidRange( double value ) const
 
 bool EqVar::isValidStore( int *tokens, int *position, int *length )
 {
+    // If the store text hasn't changed, its values are already validated.
+    if ( isParsedStore() )
+    {
+        *tokens   = m_tokens = m_storeValues;
+        *position = -1;
+        *length   = 0;
+        // Same side effect as isValidString() for the first token
+        if ( m_storeValues > 0 )
+        {
+            if ( isDiscrete() )
+            {
+                setItemName(
+                    m_itemList->itemName( (int) m_storeValue[0] ), false );
+            }
+            else if ( isContinuous() )
+            {
+                setDisplayValue( m_storeValue[0] );
+            }
+        }
+        return( true );
+    }
     bool result = isValidString( m_store, tokens, position, length );
     if ( result )
     {
@@ -753,6 +815,9 @@ bool EqVar::isValidStore( int *tokens, int *position, int *length )
  *
  *  \par Side Effects
  *  Calls setItemName() or setDisplayValue() for the first token validated.
+ *  Continuous values and discrete item ids are stored in m_storeValue[],
+ *  and on success \a str is remembered in m_storeParsed so that
+ *  isValidStore() and parseStore() need not parse it again.
  *
  *  \retval Returns TRUE on success with \a tokens containing the number of tokens.
  *  \retval Returns FALSE on error with:
@@ -769,6 +834,8 @@ bool EqVar::isValidString( const QString &str,
     *tokens = parser.parse( str );
     *position = -1;
     *length = 0;
+    m_storeParsed = QString::null;
+    m_storeValues = 0;
     QString token, caption(""), msg("");
     for ( int i = 0;
           i < parser.tokens();
@@ -777,7 +844,8 @@ bool EqVar::isValidString( const QString &str,
         token = parser.token( i );
         if ( isDiscrete() )
         {
-            if ( ! isValidItemName( token, false ) )
+            int iid = m_itemList->itemIdWithName( token, false );
+            if ( iid < 0 )
             {
                 *position = parser.position(i);
                 *length = parser.length(i);
@@ -786,6 +854,7 @@ bool EqVar::isValidString( const QString &str,
                 error( caption, msg );
                 return( false );
             }
+            storeValueAppend( (double) iid );
             // Store this only if its the first token
             if ( i == 0 )
             {
@@ -817,6 +886,7 @@ bool EqVar::isValidString( const QString &str,
                 error( caption, msg );
                 return( false );
             }
+            storeValueAppend( d );
             // Store this only if its the first token
             if ( i == 0 )
             {
@@ -829,6 +899,12 @@ bool EqVar::isValidString( const QString &str,
             // Nothing
         }
     }
+    // Text variables have no values, so they are always re-parsed.
+    if ( ! isText() )
+    {
+        m_storeParsed = str;
+        m_storeSerial = ( m_itemList ) ? m_itemList->m_serial : 0;
+    }
     return ( true );
 }
 
@@ -859,6 +935,70 @@ double EqVar::nativeValue( double value )
     return( value );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Parses the m_store into the m_storeValue[] array
+ *  if it has changed since it was last parsed.
+ *
+ *  Continuous variable values are in the current display units.
+ *  Discrete variable values are EqVarItemList position ids
+ *  (as returned by EqVarItemList::itemIdWithName()).
+ *
+ *  Unlike isValidString(), no error messages are displayed.
+ *  Invalid tokens are stored as 0 (continuous) or -1 (discrete) and
+ *  prevent the array from being marked as current.
+ *
+ *  \return Number of values in the m_storeValue[] array.
+ */
+
+int EqVar::parseStore( void )
+{
+    if ( isParsedStore() )
+    {
+        return( m_storeValues );
+    }
+    Parser parser( " \t,\"", "", "" );
+    parser.parse( m_store );
+    m_storeParsed = QString::null;
+    m_storeValues = 0;
+    bool valid = true;
+    QString token;
+    for ( int i = 0;
+          i < parser.tokens();
+          i++ )
+    {
+        token = parser.token( i );
+        if ( isDiscrete() )
+        {
+            int iid = m_itemList->itemIdWithName( token, false );
+            if ( iid < 0 )
+            {
+                valid = false;
+            }
+            storeValueAppend( (double) iid );
+        }
+        else if ( isContinuous() )
+        {
+            double d;
+            if ( ! isValidDouble( token, &d ) )
+            {
+                d = 0.;
+                valid = false;
+            }
+            else if ( ! isValidRange( d ) )
+            {
+                valid = false;
+            }
+            storeValueAppend( d );
+        }
+    }
+    if ( valid && ! isText() )
+    {
+        m_storeParsed = m_store;
+        m_storeSerial = ( m_itemList ) ? m_itemList->m_serial : 0;
+    }
+    return( m_storeValues );
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Propagates an EqVar's dirty flags to EqVars further up the EqTree
  *  until another dirty EqVar is found.
@@ -926,6 +1066,9 @@ bool EqVar::setDisplayUnits( const QString &units, int decimals )
     {
         return( false );
     }
+    // Parsed store values and ranges are in the old display units
+    m_storeParsed = QString::null;
+
     // Ok to convert, so first convert the m_store to native values
     // (only needed if the m_store is not already in native units)
     if ( m_displayUnits != m_nativeUnits )
@@ -1042,6 +1185,104 @@ QString &EqVar::setStore( const QString &value )
     return( m_store = value );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Determines the minimum and maximum values in the m_store
+ *  from its parsed m_storeValue[] array.
+ *
+ *  \param minval  Where to store the minimum value.
+ *  \param maxval  Where to store the maximum value.
+ *
+ *  \return The number of values.
+ */
+
+int EqVar::storeMinMax( double *minval, double *maxval )
+{
+    int n = parseStore();
+    if ( n > 0 )
+    {
+        *minval = *maxval = m_storeValue[0];
+        for ( int i = 1;
+              i < n;
+              i++ )
+        {
+            if ( m_storeValue[i] < *minval )
+            {
+                *minval = m_storeValue[i];
+            }
+            if ( m_storeValue[i] > *maxval )
+            {
+                *maxval = m_storeValue[i];
+            }
+        }
+    }
+    return( n );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to an individual parsed m_store value in native units.
+ *
+ *  Uses the conversion factor and offset derived by setDisplayUnits(), so
+ *  unlike appSiUnits()->convert() it touches nothing shared with other
+ *  EqTrees and may be called while calculating on any thread.
+ *
+ *  \param id Token index (base 0).
+ *
+ *  \return The continuous native value of the token, or 0 if there is no
+ *  such token.
+ */
+
+double EqVar::storeNativeValue( int id )
+{
+    double value = storeValue( id );
+    return( ( m_convert==1 )
+            ? (value-m_offset)/m_factor
+            : value );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to an individual parsed m_store value.
+ *
+ *  \param id Token index (base 0).
+ *
+ *  \return The continuous display value or discrete item id of the token,
+ *  or 0 if there is no such token.
+ */
+
+double EqVar::storeValue( int id )
+{
+    parseStore();
+    return( ( id >= 0 && id < m_storeValues )
+            ? m_storeValue[id]
+            : 0. );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Appends a value to the m_storeValue[] array, enlarging it as needed.
+ *
+ *  Called only by EqVar::isValidString() and EqVar::parseStore().
+ */
+
+void EqVar::storeValueAppend( double value )
+{
+    if ( m_storeValues >= m_storeValueSize )
+    {
+        int size = ( m_storeValueSize < 8 ) ? 8 : 2 * m_storeValueSize;
+        double *newValue = new double[ size ];
+        checkmem( __FILE__, __LINE__, newValue, "double m_storeValue", size );
+        for ( int i = 0;
+              i < m_storeValues;
+              i++ )
+        {
+            newValue[i] = m_storeValue[i];
+        }
+        delete[] m_storeValue;
+        m_storeValue = newValue;
+        m_storeValueSize = size;
+    }
+    m_storeValue[ m_storeValues++ ] = value;
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Updates continuous EqVar's nativeValue with the passed value
  *  WITHOUT setting or propagating any dirty flags.
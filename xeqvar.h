@@ -121,6 +121,7 @@ public:
     bool     isCurrent( int release ) const ;
     bool     isDiagram( void ) const ;
     bool     isDiscrete( void ) const ;
+    bool     isParsedStore( void ) const ;
     bool     isText( void ) const ;
     bool     isValidItemName( const QString &itemName, bool caseSens ) const ;
     bool     isValidItemSort( const QString &itemSort, bool caseSens ) const ;
@@ -130,6 +131,7 @@ public:
                  int *position, int *length ) ;
     double   nativeStore( double value ) ;
     double   nativeValue( double value ) ;
+    int      parseStore( void ) ;
     // The print*() functions are all in xeqtreeprint.cpp
     void     print( FILE *fptr ) const ;
     void     propagateDirty( int level=0 ) ;
@@ -140,6 +142,10 @@ public:
     void     setItemNameToDefault( void ) ;
     double   setNativeValue( double value ) ;
     QString &setStore( const QString &value ) ;
+    int      storeMinMax( double *minval, double *maxval ) ;
+    double   storeNativeValue( int id ) ;
+    double   storeValue( int id ) ;
+    void     storeValueAppend( double value ) ;
     void     update( double value ) ;
     void     updateItem( const QString &itemName ) ;
     void     updateItem( int itemDataIndex ) ;
@@ -164,6 +170,11 @@ public:
     int      m_producers;       //!< Size of m_producer array
     int      m_tokens;          //!< Number of tokens in the store()
     QString  m_store;           //!< Input worksheet entry text backing store
+    QString  m_storeParsed;     //!< m_store text held in m_storeValue[]
+    double  *m_storeValue;      //!< Parsed m_store display values or item ids
+    int      m_storeValues;     //!< Number of values in m_storeValue[]
+    int      m_storeValueSize;  //!< Allocated size of m_storeValue[]
+    int      m_storeSerial;     //!< EqVarItemList::m_serial when parsed
     bool     m_isUserOutput;    //!< True if var is a requested output
     bool     m_isUserInput;     //!< True if this is a leaf (user input) variable
     bool     m_isConstant;      //!< True if var is a leaf constant (NOT user input)
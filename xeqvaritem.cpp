@@ -42,7 +42,8 @@ EqVarItem::EqVarItem( const QString &name, const QString &sort, int index,
 
 EqVarItemList::EqVarItemList( const QString &name ) :
     m_name(name),
-    m_nameDefault("")
+    m_nameDefault(""),
+    m_serial(0)
 {
     setAutoDelete( true );
     return;
@@ -75,6 +76,8 @@ EqVarItem *EqVarItemList::addItem( const QString &name, const QString &sort,
     }
     // Insert it into the list
     inSort( itemPtr );
+    // Item positions may have shifted, so EqVar parsed stores are stale
+    m_serial++;
     return( itemPtr );
 }
 
@@ -341,6 +344,8 @@ bool EqVarItemList::removeItemByName( const QString &name, bool caseSens )
         if ( itemName == findName )
         {
             remove( itemPtr );
+            // Item positions have shifted, so EqVar parsed stores are stale
+            m_serial++;
             return( true );
         }
     }
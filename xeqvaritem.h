@@ -73,6 +73,7 @@ private:
 public:
     QString m_name;             //!< Name used for language dictionary keys.
     QString m_nameDefault;      //!< Name of the default item
+    int     m_serial;           //!< Incremented whenever item positions change
 };
 
 #endif
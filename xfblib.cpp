@@ -26,8 +26,19 @@
 //  This bunch of fuel bed intermediate variables are derived in
 //  FBL_FuelBedIntermediates() but used in FBL_FuelBedHeatSink(),
 //  FBL_SurfaceFireReactionIntensity(), or FBL_SurfaceFireSpreadAtHead().
+//  They are thread local so that separate EqTrees may be evaluated
+//  concurrently by the bpengine library.
 //------------------------------------------------------------------------------
 
+#if defined(_MSC_VER)
+/*! \def FBL_THREAD
+ *  \brief Storage class of the per-thread fuel bed intermediates.
+ */
+#define FBL_THREAD __declspec(thread)
+#else
+#define FBL_THREAD __thread
+#endif
+
 const int MAX_PARTS    = 8;         //!< Maximum number of fuel particles.
 const int MAX_CATS     = 2;         //!< Life categories
 const int MAX_SIZES    = 6;         //!< Fuel moisture time lag classes.
@@ -35,23 +46,23 @@ const int DEAD_CAT     = 0;         //!< Dead life category index
 const int LIVE_CAT     = 1;         //!< Live life category index
 
 // Set in FBL_FuelBedIntermediates(), used in FBL_SurfaceFuelBedHeatSink()
-static int    m_particles;          //!< Number of fuel particles
-static int    m_life[MAX_PARTS];    //!< Fuel particle life category
-static double m_aWtg[MAX_PARTS];    //!< Fuel particle area weighting factor
-static double m_load[MAX_PARTS];    //!< Fuel particle fuel load (lb/ft2)
-static double m_sigK[MAX_PARTS];    //!< Fuel particle surface area-to-volume ratio (ft2/ft3)
-static double m_lifeAwtg[MAX_CATS]; //!< Life category weighting factor
-static double m_lifeFine[MAX_CATS]; //!< Fine fuel ratio by life category
-static double m_liveMextK;          //!< Live moisture of extinction constant
+static FBL_THREAD int    m_particles;          //!< Number of fuel particles
+static FBL_THREAD int    m_life[MAX_PARTS];    //!< Fuel particle life category
+static FBL_THREAD double m_aWtg[MAX_PARTS];    //!< Fuel particle area weighting factor
+static FBL_THREAD double m_load[MAX_PARTS];    //!< Fuel particle fuel load (lb/ft2)
+static FBL_THREAD double m_sigK[MAX_PARTS];    //!< Fuel particle surface area-to-volume ratio (ft2/ft3)
+static FBL_THREAD double m_lifeAwtg[MAX_CATS]; //!< Life category weighting factor
+static FBL_THREAD double m_lifeFine[MAX_CATS]; //!< Fine fuel ratio by life category
+static FBL_THREAD double m_liveMextK;          //!< Live moisture of extinction constant
 
 // Set in FBL_FuelBedIntermediates(), used in FBL_SurfaceFireReactionIntensity().
-static double m_lifeRxK[MAX_CATS];  //!< Reaction intensity constant by life category
+static FBL_THREAD double m_lifeRxK[MAX_CATS];  //!< Reaction intensity constant by life category
 
 // Set in FBL_SurfaceFuelBedIntermediates(), used in FBL_SurfaceFireSpreadAtHead().
-static double m_slopeK;             //!< Slope constant K (see Rothermel 1972)
-static double m_windB;              //!< Wind constant B (see Rothermel 1972)
-static double m_windE;              //!< Wind constant E (see Rothermel 1972)
-static double m_windK;              //!< Wind constant K (see Rothermel 1972)
+static FBL_THREAD double m_slopeK;             //!< Slope constant K (see Rothermel 1972)
+static FBL_THREAD double m_windB;              //!< Wind constant B (see Rothermel 1972)
+static FBL_THREAD double m_windE;              //!< Wind constant E (see Rothermel 1972)
+static FBL_THREAD double m_windK;              //!< Wind constant K (see Rothermel 1972)
 
 //------------------------------------------------------------------------------
 //  FOFEM tree species and equations
@@ -282,32 +293,227 @@ static FofemSpeciesStruct FofemSpecies[] =
 };
 
 //------------------------------------------------------------------------------
-/*! \brief Returns the interpolated/extrapolated value based upon curing.
+//  Fosberg fine dead fuel moisture reference and correction tables
+//  (Rothermel 1983, Tables 1 and 2).
+//  Reference rows are dry bulb classes 10-29, 30-49, 50-69, 70-89, 90-109,
+//  and >109 oF; columns are relative humidity classes 0-4, 5-9, ..., 100 %.
+//  Correction rows are grouped by month class (May-Jul, Feb-Apr/Aug-Oct,
+//  Nov-Jan), each holding 8 exposed rows (aspect N,E,S,W by slope 0-30%,
+//  31+%) and 4 shaded rows (aspect N,E,S,W); columns are the 6 time of day
+//  classes (08:00 to sunset) by elevation (below, level, above).
+//------------------------------------------------------------------------------
+
+static const int FdfmcReference[6][21] =
+{
+    { 1, 2, 2, 3, 4, 5, 5, 6, 7, 8, 8, 8, 9, 9, 10, 11, 12, 12, 13, 13, 14 },
+    { 1, 2, 2, 3, 4, 5, 5, 6, 7, 7, 7, 8, 9, 9, 10, 10, 11, 12, 13, 13, 13 },
+    { 1, 2, 2, 3, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9,  9, 10, 11, 12, 12, 12, 13 },
+    { 1, 1, 2, 2, 3, 4, 5, 5, 6, 7, 7, 8, 8, 8,  9, 10, 10, 11, 12, 12, 13 },
+    { 1, 1, 2, 2, 3, 4, 4, 5, 6, 7, 7, 8, 8, 8,  9, 10, 10, 11, 12, 12, 13 },
+    { 1, 1, 2, 2, 3, 4, 4, 5, 6, 7, 7, 8, 8, 8,  9, 10, 10, 11, 12, 12, 12 }
+};
+
+static const int FdfmcCorrection[36][18] =
+{
+    // May-Jun-Jul Exposed
+    { 2, 3, 4, 1, 1, 1, 0, 0, 1, 0, 0, 1, 1, 1, 1, 2, 3, 4 },
+    { 3, 4, 4, 1, 2, 2, 1, 1, 2, 1, 1, 2, 1, 2, 2, 3, 4, 4 },
+    { 2, 2, 3, 1, 1, 1, 0, 0, 1, 0, 0, 1, 1, 1, 2, 3, 4, 4 },
+    { 1, 2, 2, 0, 0, 1, 0, 0, 1, 1, 1, 2, 2, 3, 4, 4, 5, 6 },
+    { 2, 3, 3, 1, 1, 1, 0, 0, 1, 0, 0, 1, 1, 1, 1, 2, 3, 3 },
+    { 2, 3, 3, 1, 1, 2, 0, 1, 1, 0, 1, 1, 1, 1, 2, 2, 3, 3 },
+    { 2, 3, 4, 1, 1, 2, 0, 0, 1, 0, 0, 1, 0, 1, 1, 2, 3, 3 },
+    { 4, 5, 6, 2, 3, 4, 1, 1, 2, 0, 0, 1, 0, 0, 1, 1, 2, 2 },
+    // May-Jun-Jul Shaded
+    { 4, 5, 5, 3, 4, 5, 3, 3, 4, 3, 3, 4, 3, 4, 5, 4, 5, 5 },
+    { 4, 4, 5, 3, 4, 5, 3, 3, 4, 3, 4, 4, 3, 4, 5, 4, 5, 6 },
+    { 4, 4, 5, 3, 4, 5, 3, 3, 4, 3, 3, 4, 3, 4, 5, 4, 5, 5 },
+    { 4, 5, 6, 3, 4, 5, 3, 3, 4, 3, 3, 4, 3, 4, 5, 4, 4, 5 },
+    // Feb-Mar-Apr/Aug-Sep-Oct Exposed
+    { 3, 4, 5, 1, 2, 3, 1, 1, 2, 1, 1, 2, 1, 2, 3, 3, 4, 5 },
+    { 3, 4, 5, 3, 3, 4, 2, 3, 4, 2, 3, 4, 3, 3, 4, 3, 4, 5 },
+    { 3, 4, 5, 1, 2, 3, 1, 1, 1, 1, 1, 2, 1, 2, 3, 3, 4, 5 },
+    { 3, 3, 4, 1, 1, 1, 1, 1, 1, 1, 2, 3, 3, 4, 5, 3, 4, 6 },
+    { 3, 4, 5, 1, 2, 2, 1, 1, 1, 1, 1, 1, 1, 2, 3, 3, 4, 5 },
+    { 3, 4, 5, 1, 2, 2, 0, 1, 1, 0, 1, 1, 1, 2, 2, 3, 4, 5 },
+    { 3, 4, 5, 1, 2, 3, 1, 1, 1, 1, 1, 1, 1, 2, 3, 3, 4, 5 },
+    { 4, 5, 6, 3, 4, 5, 1, 2, 3, 1, 1, 1, 1, 1, 1, 3, 3, 4 },
+    // Feb-Mar-Apr/Aug-Sep-Oct Shaded
+    { 4, 5, 6, 4, 5, 5, 3, 4, 5, 3, 4, 5, 4, 5, 5, 4, 5, 6 },
+    { 4, 5, 6, 3, 4, 5, 3, 4, 5, 3, 4, 5, 4, 5, 6, 4, 5, 6 },
+    { 4, 5, 6, 3, 4, 5, 3, 4, 5, 3, 4, 5, 3, 4, 5, 4, 5, 6 },
+    { 4, 5, 6, 4, 5, 6, 3, 4, 5, 3, 4, 5, 3, 4, 5, 4, 5, 6 },
+    // Nov-Dec-Jan Exposed
+    { 4, 5, 6, 3, 4, 5, 2, 3, 4, 2, 3, 4, 3, 4, 5, 4, 5, 6 },
+    { 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6 },
+    { 4, 5, 6, 3, 4, 4, 2, 3, 3, 2, 3, 3, 3, 4, 5, 4, 5, 6 },
+    { 4, 5, 6, 2, 3, 4, 2, 2, 3, 3, 4, 4, 4, 5, 6, 4, 5, 6 },
+    { 4, 5, 6, 3, 4, 5, 2, 3, 3, 2, 2, 3, 3, 4, 4, 4, 5, 6 },
+    { 4, 5, 6, 2, 3, 3, 1, 1, 2, 1, 1, 2, 2, 3, 3, 4, 5, 6 },
+    { 4, 5, 6, 3, 4, 5, 2, 3, 3, 2, 3, 3, 3, 4, 4, 4, 5, 6 },
+    { 4, 5, 6, 4, 5, 6, 3, 4, 4, 2, 2, 3, 2, 3, 4, 4, 5, 6 },
+    // Nov-Dec-Jan Shaded
+    { 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6 },
+    { 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6 },
+    { 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6 },
+    { 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6, 4, 5, 6 }
+};
+
+//------------------------------------------------------------------------------
+//  Aspen fuel type tables, indexed by fuel type and curing level.
+//  Fuel types are 0 = Aspen/shrub, 1 = Aspen/tall forb, 2 = Aspen/low forb,
+//  3 = Mixed/forb, and 4 = Mixed/shrub.
+//------------------------------------------------------------------------------
+
+static double AspenCuring[] = { 0.0, 0.3, 0.5, 0.7, 0.9, 1.000000001 };
+
+//! Index of the first AspenCuring[] value above each 0.1 curing step
+static int AspenCuringSegment[11] = { 1, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5 };
+
+static double AspenDepth[5] = { 0.65, 0.30, 0.18, 0.50, 0.18 };
+
+static double AspenLoadDead1[5][6] = {
+    { 0.800, 0.893, 1.056, 1.218, 1.379, 1.4595 },
+    { 0.738, 0.930, 1.056, 1.183, 1.309, 1.3720 },
+    { 0.601, 0.645, 0.671, 0.699, 0.730, 0.7455 },
+    { 0.880, 0.906, 1.037, 1.167, 1.300, 1.3665 },
+    { 0.754, 0.797, 0.825, 0.854, 0.884, 0.8990 }
+};
+
+static double AspenLoadDead10[5] = { 0.975, 0.475, 1.035, 1.340, 1.115 };
+
+static double AspenLoadLiveHerb[5][6] = {
+    { 0.335, 0.234, 0.167, 0.100, 0.033, 0.000 },
+    { 0.665, 0.465, 0.332, 0.199, 0.067, 0.000 },
+    { 0.150, 0.105, 0.075, 0.045, 0.015, 0.000 },
+    { 0.100, 0.070, 0.050, 0.030, 0.010, 0.000 },
+    { 0.150, 0.105, 0.075, 0.045, 0.015, 0.000 }
+};
+
+static double AspenLoadLiveWoody[5][6] = {
+    { 0.403, 0.403, 0.333, 0.283, 0.277, 0.274 },
+    { 0.000, 0.000, 0.000, 0.000, 0.000, 0.000 },
+    { 0.000, 0.000, 0.000, 0.000, 0.000, 0.000 },
+    { 0.455, 0.455, 0.364, 0.290, 0.261, 0.2465 },
+    { 0.000, 0.000, 0.000, 0.000, 0.000, 0.000 }
+};
+
+static double AspenSavrDead1[5][6] = {
+    { 1440., 1620., 1910., 2090., 2220., 2285. },
+    { 1480., 1890., 2050., 2160., 2240., 2280. },
+    { 1400., 1540., 1620., 1690., 1750., 1780. },
+    { 1350., 1420., 1710., 1910., 2060., 2135. },
+    { 1420., 1540., 1610., 1670., 1720., 1745. }
+};
+
+static double AspenSavrLiveWoody[5][6] = {
+    { 2440., 2440., 2310., 2090., 1670., 1670. },
+    { 2440., 2440., 2440., 2440., 2440., 2440. },
+    { 2440., 2440., 2440., 2440., 2440., 2440. },
+    { 2530., 2530., 2410., 2210., 1800., 1800. },
+    { 2440., 2440., 2440., 2440., 2440., 2440. }
+};
+
+//------------------------------------------------------------------------------
+/*! \brief Locates the curing level within the aspen curing table.
  *
  *  \param curing   Curing level (fraction)
- *  \param valueArray Array of 6 boundary values.
+ *  \param fraction Address where the fractional distance of \a curing
+ *                  between AspenCuring[i-1] and AspenCuring[i] is returned.
  *
- *  \return Interpolated value.
+ *  \return Index \a i of the first AspenCuring[] value above \a curing.
  */
-double FBL_AspenInterpolate( double curing, double *valueArray )
+
+static int aspenCuringIndex( double curing, double *fraction )
 {
-    static double Curing[] = { 0.0, 0.3, 0.5, 0.7, 0.9, 1.000000001 };
     curing = ( curing < 0.0 ) ? 0.0 : curing;
     curing = ( curing > 1.0 ) ? 1.0 : curing;
-    double fraction = 0.0;
-    unsigned i = 1;
-    for ( i=1; i<sizeof( Curing )-1; i++ )
+    // Start from the 0.1 step, then settle on the exact segment
+    int i = AspenCuringSegment[ (int) ( 10. * curing ) ];
+    while ( curing >= AspenCuring[i] )
     {
-        if ( curing < Curing[i] )
-        {
-            fraction = 1. - ( Curing[i] - curing ) / ( Curing[i] - Curing[i-1] );
-            break;
-        }
+        i++;
     }
+    while ( i > 1 && curing < AspenCuring[i-1] )
+    {
+        i--;
+    }
+    *fraction = 1. - ( AspenCuring[i] - curing )
+                   / ( AspenCuring[i] - AspenCuring[i-1] );
+    return( i );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Returns the interpolated/extrapolated value based upon curing.
+ *
+ *  \param curing   Curing level (fraction)
+ *  \param valueArray Array of 6 boundary values.
+ *
+ *  \return Interpolated value.
+ */
+double FBL_AspenInterpolate( double curing, double *valueArray )
+{
+    double fraction;
+    int i = aspenCuringIndex( curing, &fraction );
     double value = valueArray[i-1] + fraction * ( valueArray[i] - valueArray[i-1] );
     return( value );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Builds the entire aspen fuel bed for one fuel type and curing level.
+ *
+ *  Returns the same values as the individual FBL_AspenFuelBedDepth(),
+ *  FBL_AspenFuelMextDead(), FBL_AspenLoad*(), and FBL_AspenSavr*()
+ *  functions, but locates the curing level in the tables only once.
+ *
+ *  \param typeIndex Index of the aspen fuel type:
+ *                      0 = Aspen/shrub
+ *                      1 = Aspen/tall forb
+ *                      2 = Aspen/low forb
+ *                      3 = Mixed/forb
+ *                      4 = Mixed/shrub
+ *  \param curing   Curing level (fraction)
+ *  \param depth    Address where the fuel bed depth (ft) is returned.
+ *  \param mextDead Address where the dead fuel extinction moisture (lb/lb)
+ *                  is returned.
+ *  \param load     Array of 4 where the dead 0.0 - 0.25", dead 0.25 - 1.0",
+ *                  live herbaceous, and live woody loads (lb/ft2) are returned.
+ *  \param savr     Array of 4 where the savr (ft2/ft3) of the same fuel
+ *                  particles are returned.
+ */
+
+void FBL_AspenFuelBed( int typeIndex, double curing, double *depth,
+        double *mextDead, double *load, double *savr )
+{
+    *mextDead = 0.25;
+    savr[1] = 109.0;
+    savr[2] = 2800.0;
+    if ( typeIndex < 0 || typeIndex >= 5 )
+    {
+        *depth = 0.;
+        load[0] = load[1] = load[2] = load[3] = 0.;
+        savr[0] = 1440.;
+        savr[3] = 2440.;
+        return;
+    }
+    double f;
+    int i = aspenCuringIndex( curing, &f );
+    double *v;
+    *depth  = AspenDepth[typeIndex];
+    v = AspenLoadDead1[typeIndex];
+    load[0] = ( v[i-1] + f * ( v[i] - v[i-1] ) ) * 2000. / 43560.;
+    load[1] = AspenLoadDead10[typeIndex] * 2000. / 43560.;
+    v = AspenLoadLiveHerb[typeIndex];
+    load[2] = ( v[i-1] + f * ( v[i] - v[i-1] ) ) * 2000. / 43560.;
+    v = AspenLoadLiveWoody[typeIndex];
+    load[3] = ( v[i-1] + f * ( v[i] - v[i-1] ) ) * 2000. / 43560.;
+    v = AspenSavrDead1[typeIndex];
+    savr[0] = v[i-1] + f * ( v[i] - v[i-1] );
+    v = AspenSavrLiveWoody[typeIndex];
+    savr[3] = v[i-1] + f * ( v[i] - v[i-1] );
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Calculates the aspen fuel bed depth.
  *
@@ -324,8 +530,7 @@ double FBL_AspenInterpolate( double curing, double *valueArray )
 
 double FBL_AspenFuelBedDepth( int typeIndex, double /* curing */ )
 {
-    double Depth[] = { 0.65, 0.30, 0.18, 0.50, 0.18 };
-    return( Depth[typeIndex] );
+    return( AspenDepth[typeIndex] );
 }
 
 //------------------------------------------------------------------------------
@@ -363,17 +568,10 @@ double FBL_AspenFuelMextDead( int /* typeIndex */, double /* curing */ )
 
 double FBL_AspenLoadDead1( int typeIndex, double curing )
 {
-    static double Load[5][6] = {
-        { 0.800, 0.893, 1.056, 1.218, 1.379, 1.4595 },
-        { 0.738, 0.930, 1.056, 1.183, 1.309, 1.3720 },
-        { 0.601, 0.645, 0.671, 0.699, 0.730, 0.7455 },
-        { 0.880, 0.906, 1.037, 1.167, 1.300, 1.3665 },
-        { 0.754, 0.797, 0.825, 0.854, 0.884, 0.8990 }
-    };
     double load = 0.0;
     if ( typeIndex >= 0 && typeIndex < 5 )
     {
-        load = FBL_AspenInterpolate( curing, Load[typeIndex] );
+        load = FBL_AspenInterpolate( curing, AspenLoadDead1[typeIndex] );
     }
     return( load * 2000. / 43560. );
 }
@@ -394,11 +592,10 @@ double FBL_AspenLoadDead1( int typeIndex, double curing )
 
 double FBL_AspenLoadDead10( int typeIndex, double /* curing */ )
 {
-    static double Load[] = { 0.975, 0.475, 1.035, 1.340, 1.115 };
     double load = 0.0;
     if ( typeIndex >= 0 && typeIndex < 5 )
     {
-        load = Load[typeIndex];
+        load = AspenLoadDead10[typeIndex];
     }
     return( load * 2000. / 43560. );
 }
@@ -419,17 +616,10 @@ double FBL_AspenLoadDead10( int typeIndex, double /* curing */ )
 
 double FBL_AspenLoadLiveHerb( int typeIndex, double curing )
 {
-    static double Load[5][6] = {
-        { 0.335, 0.234, 0.167, 0.100, 0.033, 0.000 },
-        { 0.665, 0.465, 0.332, 0.199, 0.067, 0.000 },
-        { 0.150, 0.105, 0.075, 0.045, 0.015, 0.000 },
-        { 0.100, 0.070, 0.050, 0.030, 0.010, 0.000 },
-        { 0.150, 0.105, 0.075, 0.045, 0.015, 0.000 }
-    };
     double load = 0.0;
     if ( typeIndex >= 0 && typeIndex < 5 )
     {
-        load = FBL_AspenInterpolate( curing, Load[typeIndex] );
+        load = FBL_AspenInterpolate( curing, AspenLoadLiveHerb[typeIndex] );
     }
     return( load * 2000. / 43560. );
 }
@@ -450,17 +640,10 @@ double FBL_AspenLoadLiveHerb( int typeIndex, double curing )
 
 double FBL_AspenLoadLiveWoody( int typeIndex, double curing )
 {
-    static double Load[5][6] = {
-        { 0.403, 0.403, 0.333, 0.283, 0.277, 0.274 },
-        { 0.000, 0.000, 0.000, 0.000, 0.000, 0.000 },
-        { 0.000, 0.000, 0.000, 0.000, 0.000, 0.000 },
-        { 0.455, 0.455, 0.364, 0.290, 0.261, 0.2465 },
-        { 0.000, 0.000, 0.000, 0.000, 0.000, 0.000 }
-    };
     double load = 0.0;
     if ( typeIndex >= 0 && typeIndex < 5 )
     {
-        load = FBL_AspenInterpolate( curing, Load[typeIndex] );
+        load = FBL_AspenInterpolate( curing, AspenLoadLiveWoody[typeIndex] );
     }
     return( load * 2000. / 43560. );
 }
@@ -508,17 +691,10 @@ double FBL_AspenMortality( int severity, double flameLength, double dbh )
 
 double FBL_AspenSavrDead1( int typeIndex, double curing )
 {
-    static double Savr[5][6] = {
-        { 1440., 1620., 1910., 2090., 2220., 2285. },
-        { 1480., 1890., 2050., 2160., 2240., 2280. },
-        { 1400., 1540., 1620., 1690., 1750., 1780. },
-        { 1350., 1420., 1710., 1910., 2060., 2135. },
-        { 1420., 1540., 1610., 1670., 1720., 1745. }
-    };
     double savr = 1440.;
     if ( typeIndex >= 0 && typeIndex < 5 )
     {
-        savr = FBL_AspenInterpolate( curing, Savr[typeIndex] );
+        savr = FBL_AspenInterpolate( curing, AspenSavrDead1[typeIndex] );
     }
     return( savr );
 }
@@ -576,17 +752,10 @@ double FBL_AspenSavrLiveHerb( int /*typeIndex*/, double /*curing*/ )
  */
 double FBL_AspenSavrLiveWoody( int typeIndex, double curing )
 {
-    double Savr[5][6] = {
-        { 2440., 2440., 2310., 2090., 1670., 1670. },
-        { 2440., 2440., 2440., 2440., 2440., 2440. },
-        { 2440., 2440., 2440., 2440., 2440., 2440. },
-        { 2530., 2530., 2410., 2210., 1800., 1800. },
-        { 2440., 2440., 2440., 2440., 2440., 2440. }
-    };
     double savr = 2440.;
     if ( typeIndex >= 0 && typeIndex < 5 )
     {
-        savr = FBL_AspenInterpolate( curing, Savr[typeIndex] );
+        savr = FBL_AspenInterpolate( curing, AspenSavrLiveWoody[typeIndex] );
     }
     return( savr );
 }
@@ -1105,6 +1274,102 @@ double FBL_DewPointTemperature( double dryBulb, double wetBulb, double elev )
     return( dewpoint );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Calculates the fine dead fuel moisture content from the Fosberg
+ *  reference and correction tables for an hourly weather observation.
+ *
+ *  Hours before 08:00 and after 18:00 use the nearest (08:00 - 09:59 or
+ *  18:00 - sunset) daytime correction column, since the night time tables
+ *  are not implemented.
+ *
+ *  \param dryBulb   Dry bulb air temperature (oF).
+ *  \param rh        Relative humidity (%).
+ *  \param month     Month of the year (1=January - 12=December).
+ *  \param hour      Hour of the day (0-23).
+ *  \param elevation Site elevation relative to the weather observation
+ *                   (-1=below, 0=level, 1=above).
+ *  \param slope     Site slope steepness (rise/reach).
+ *  \param aspect    Site aspect (degrees clockwise from north).
+ *  \param shaded    TRUE if fuels are 50% or more shaded from the sun.
+ *
+ *  \return Fine dead fuel moisture content (fraction).
+ */
+
+double FBL_FineDeadFuelMoisture( double dryBulb, double rh, int month,
+        int hour, int elevation, double slope, double aspect, bool shaded )
+{
+    // Reference table indices
+    int db = (int) ( ( dryBulb - 10. ) / 20. );
+    db = ( db < 0 ) ? 0 : db;
+    db = ( db > 5 ) ? 5 : db;
+    int rhIndex = (int) ( rh / 5. );
+    rhIndex = ( rhIndex < 0 ) ? 0 : rhIndex;
+    rhIndex = ( rhIndex > 20 ) ? 20 : rhIndex;
+
+    // Correction table indices
+    int mon = 1;
+    if ( month >= 5 && month <= 7 )
+    {
+        mon = 0;
+    }
+    else if ( month == 11 || month == 12 || month == 1 )
+    {
+        mon = 2;
+    }
+    int tod = ( hour - 8 ) / 2;
+    tod = ( hour < 8 ) ? 0 : tod;
+    tod = ( tod > 5 ) ? 5 : tod;
+    int elev = elevation + 1;
+    elev = ( elev < 0 ) ? 0 : elev;
+    elev = ( elev > 2 ) ? 2 : elev;
+    int slp = ( slope > 0.305 ) ? 1 : 0;
+    int asp = (int) ( ( aspect + 45. ) / 90. );
+    asp = ( asp < 0 ) ? 0 : ( asp % 4 );
+
+    int ref = FBL_FineDeadFuelMoistureReference( db, rhIndex );
+    int cor = FBL_FineDeadFuelMoistureCorrection( mon, tod, elev, slp, asp,
+        ( shaded ? 1 : 0 ) );
+    return( 0.01 * (double) ( ref + cor ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Looks up the Fosberg fine dead fuel moisture correction.
+ *
+ *  \param mon   Month class (0=May-Jul, 1=Feb-Apr/Aug-Oct, 2=Nov-Jan).
+ *  \param tod   Time of day class (0=08:00-09:59, ..., 5=18:00-sunset).
+ *  \param elev  Elevation class (0=below, 1=level, 2=above).
+ *  \param slp   Slope class (0=0-30%, 1=31+%).
+ *  \param asp   Aspect class (0=north, 1=east, 2=south, 3=west).
+ *  \param shd   Shading class (0=exposed, 1=shaded).
+ *
+ *  \return Fine dead fuel moisture correction (%).
+ */
+
+int FBL_FineDeadFuelMoistureCorrection( int mon, int tod, int elev, int slp,
+        int asp, int shd )
+{
+    int row = ( shd == 0 )
+            ? ( slp + 2 * asp )
+            : ( 8 + asp );
+    row += 12 * mon;
+    int col = elev + 3 * tod;
+    return( FdfmcCorrection[row][col] );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Looks up the Fosberg reference fine dead fuel moisture.
+ *
+ *  \param db    Dry bulb temperature class (0=10-29 oF, ..., 5=>109 oF).
+ *  \param rh    Relative humidity class (0=0-4%, ..., 20=100%).
+ *
+ *  \return Reference fine dead fuel moisture (%).
+ */
+
+int FBL_FineDeadFuelMoistureReference( int db, int rh )
+{
+    return( FdfmcReference[db][rh] );
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Calculates the fire type; surface, passive, or active.
  *
@@ -1275,6 +1540,36 @@ double FBL_PalmettoGallberyDeadFoliageLoad( double age, double cover )
     return( 0.00221 * pow( age, 0.51263  ) * exp( 0.02482 * cover ) );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Builds the entire palmetto-gallberry fuel bed.
+ *
+ *  Calls the individual FBL_PalmettoGallbery*() load and depth functions,
+ *  so it always returns the same values they do.
+ *
+ *  \param age      Age of rough (years).
+ *  \param cover    Coverage of area by palmetto (percent).
+ *  \param height   Height of the understory (ft).
+ *  \param ba       Overstory basal aea (ft2/ac)
+ *  \param depth    Address where the fuel bed depth (ft) is returned.
+ *  \param load     Array of 7 where the dead 0.0 - 0.25", dead 0.25 - 1.0",
+ *                  dead foliage, live 0.0 - 0.25", live 0.25 - 1.0",
+ *                  live foliage, and litter loads (lb/ft2) are returned.
+ */
+
+void FBL_PalmettoGallberyFuelBed( double age, double cover, double height,
+        double ba, double *depth, double *load )
+{
+    *depth  = FBL_PalmettoGallberyFuelBedDepth( height );
+    load[0] = FBL_PalmettoGallberyDead1HrLoad( age, height );
+    load[1] = FBL_PalmettoGallberyDead10HrLoad( age, cover );
+    load[2] = FBL_PalmettoGallberyDeadFoliageLoad( age, cover );
+    load[3] = FBL_PalmettoGallberyLive1HrLoad( age, height );
+    load[4] = FBL_PalmettoGallberyLive10HrLoad( age, height );
+    load[5] = FBL_PalmettoGallberyLiveFoliageLoad( age, cover, height );
+    load[6] = FBL_PalmettoGallberyLitterLoad( age, ba );
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Calculates the palmetto-gallberry fuel bed depth.
  *
@@ -3292,6 +3587,91 @@ double FBL_SurfaceFuelBedIntermediates(
     return( sigma );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Restores the fuel bed intermediates saved by
+ *  FBL_SurfaceFuelBedState().
+ *
+ *  Restoring the state of an earlier FBL_SurfaceFuelBedIntermediates() call
+ *  lets a caller that remembers its results skip the call when the same
+ *  fuel bed recurs, and still get identical results from
+ *  FBL_SurfaceFuelBedHeatSink(), FBL_SurfaceFireReactionIntensity(), and
+ *  FBL_SurfaceFireForwardSpreadRate().
+ *
+ *  \param state Array of FBL_SurfaceFuelBedStateSize values.
+ */
+
+void FBL_SurfaceFuelBedSetState( const double *state )
+{
+    int i;
+    int j = 0;
+    m_particles = (int) state[j++];
+    for ( i = 0;
+          i < MAX_PARTS;
+          i++ )
+    {
+        m_life[i] = (int) state[j++];
+        m_aWtg[i] = state[j++];
+        m_load[i] = state[j++];
+        m_sigK[i] = state[j++];
+    }
+    for ( i = 0;
+          i < MAX_CATS;
+          i++ )
+    {
+        m_lifeAwtg[i] = state[j++];
+        m_lifeFine[i] = state[j++];
+        m_lifeRxK[i]  = state[j++];
+    }
+    m_liveMextK = state[j++];
+    m_slopeK    = state[j++];
+    m_windB     = state[j++];
+    m_windE     = state[j++];
+    m_windK     = state[j++];
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Saves the fuel bed intermediates derived by the last call to
+ *  FBL_SurfaceFuelBedIntermediates() on this thread.
+ *
+ *  The state is only complete if that call had a fuel bed depth and a
+ *  fuel surface area; otherwise some of its values are left over from the
+ *  call before it.
+ *
+ *  \param state Array of FBL_SurfaceFuelBedStateSize values where the
+ *                state is returned.
+ */
+
+void FBL_SurfaceFuelBedState( double *state )
+{
+    int i;
+    int j = 0;
+    state[j++] = (double) m_particles;
+    for ( i = 0;
+          i < MAX_PARTS;
+          i++ )
+    {
+        state[j++] = (double) m_life[i];
+        state[j++] = m_aWtg[i];
+        state[j++] = m_load[i];
+        state[j++] = m_sigK[i];
+    }
+    for ( i = 0;
+          i < MAX_CATS;
+          i++ )
+    {
+        state[j++] = m_lifeAwtg[i];
+        state[j++] = m_lifeFine[i];
+        state[j++] = m_lifeRxK[i];
+    }
+    state[j++] = m_liveMextK;
+    state[j++] = m_slopeK;
+    state[j++] = m_windB;
+    state[j++] = m_windE;
+    state[j++] = m_windK;
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Calculates the fuel temperature using the BEHAVE FIRE2 subroutine
  *  CAIGN() algorithm.
@@ -51,6 +51,12 @@
  */
 const double SMIDGEN = 1.0e-07;
 
+/*! \var FBL_SurfaceFuelBedStateSize
+ *  \brief Number of values in the fuel bed state array returned by
+ *  FBL_SurfaceFuelBedState().
+ */
+const int FBL_SurfaceFuelBedStateSize = 44;
+
 /*! \enum LifeType
  *  \brief A code used to determine both the fuel life category (dead or live)
  *  and how moisture is assigned to it.
@@ -67,6 +73,14 @@ double FBL_AspenInterpolate(
             double curing,
             double *valueArray ) ;
 
+void   FBL_AspenFuelBed(
+            int typeIndex,
+            double curing,
+            double *depth,
+            double *mextDead,
+            double *load,
+            double *savr ) ;
+
 double FBL_AspenFuelBedDepth(
             int typeIndex,
             double curing ) ;
@@ -200,6 +214,28 @@ double FBL_DewPointTemperature(
             double wetBulb,
             double elev ) ;
 
+double FBL_FineDeadFuelMoisture(
+            double dryBulb,
+            double rh,
+            int    month,
+            int    hour,
+            int    elevation,
+            double slope,
+            double aspect,
+            bool   shaded ) ;
+
+int    FBL_FineDeadFuelMoistureCorrection(
+            int mon,
+            int tod,
+            int elev,
+            int slp,
+            int asp,
+            int shd ) ;
+
+int    FBL_FineDeadFuelMoistureReference(
+            int db,
+            int rh ) ;
+
 int    FBL_FireType(
             double transitionRatio,
             double activeRatio ) ;
@@ -228,6 +264,14 @@ double FBL_PalmettoGallberyDeadFoliageLoad(
             double age,
             double cover ) ;
 
+void   FBL_PalmettoGallberyFuelBed(
+            double age,
+            double cover,
+            double height,
+            double ba,
+            double *depth,
+            double *load ) ;
+
 double FBL_PalmettoGallberyFuelBedDepth(
             double height ) ;
 
@@ -516,6 +560,12 @@ double FBL_SurfaceFuelBedIntermediates(
             double *fuelBedPackingRatio,
             double *fuelBedBetaRatio ) ;
 
+void   FBL_SurfaceFuelBedSetState(
+            const double *state ) ;
+
+void   FBL_SurfaceFuelBedState(
+            double *state ) ;
+
 double FBL_SurfaceFuelTemperature(
             double airTemperature,
             double sunShading ) ;